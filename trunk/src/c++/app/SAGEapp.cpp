@@ -15,6 +15,7 @@
 #include "app/SAGEapp.h"
 #include "app/SAGEapp_version_bank.h"
 #include "app/VersionNumber.h"
+#include "util/ThreadPool.h"
 
 using namespace std;
 
@@ -56,6 +57,11 @@ std::string SAGEapp::release_string;
 
 std::string SAGEapp::getReleaseString() { return release_string; }
 
+std::string SAGEapp::snapshot_filename;
+
+const std::string& SAGEapp::snapshot_file()                                { return snapshot_filename;     }
+void               SAGEapp::set_snapshot_file(const std::string& filename) { snapshot_filename = filename; }
+
 //======================================
 //
 //  checkExpirationStatus()
@@ -262,6 +268,22 @@ int SAGEapp::parse_params(const char *opts)
     
          if(arg == "-h" || arg == "-?") { help_found    = true; }
     else if(arg == "-@")                { debug_found   = true; }
+    else if(arg.substr(0, 10) == "--threads=")
+    {
+      parse_thread_count(arg.substr(10));
+    }
+    else if(arg == "--threads" && first_nonflag_index + 1 < (size_t)argc)
+    {
+      parse_thread_count(argv[++first_nonflag_index]);
+    }
+    else if(arg.substr(0, 11) == "--snapshot=")
+    {
+      set_snapshot_file(arg.substr(11));
+    }
+    else if(arg == "--snapshot" && first_nonflag_index + 1 < (size_t)argc)
+    {
+      set_snapshot_file(argv[++first_nonflag_index]);
+    }
     else                                { break;                }
   }
 
@@ -272,6 +294,32 @@ int SAGEapp::parse_params(const char *opts)
   return first_nonflag_index;
 }    
 
+//=========================================
+//
+//  parse_thread_count(...)
+//
+//=========================================
+void SAGEapp::parse_thread_count(const std::string& value)
+{
+  // 0 (or "auto") means one thread per processor.
+
+  char* end   = NULL;
+  long  count = strtol(value.c_str(), &end, 10);
+
+  if(toUpper(value) == "AUTO")
+  {
+    count = 0;
+  }
+  else if(value.empty() || *end || count < 0)
+  {
+    cerr << "Invalid thread count '" << value << "', using 1 thread." << endl;
+
+    count = 1;
+  }
+
+  UTIL::ThreadPool::set_default_thread_count((size_t) count);
+}
+
 //==================================
 //
 //  print_inf_banner(...)
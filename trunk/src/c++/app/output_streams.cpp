@@ -12,7 +12,7 @@ void Output_Streams::init_output_streams()
 
   // Create output streams (Screen, Information)
 
-  cerrorstream Screen = cerrorstream(std::cout);
+  cerrorstream Screen = cerrorstream(my_screen);
 
   if(!inf_file)
   {
@@ -34,11 +34,13 @@ MemberCovariateCalculator::MemberCovariateCalculator(const Configuration& config
 
   //cout << "\nmain trait" << endl;
   my_phenotypes.resize((size_t)my_sampledata.getTotalIndividualCount());
+  my_valid.resize((size_t)my_sampledata.getTotalIndividualCount());
   
   //double  max = my_main_phenotype_field.getSummaryInfo().max;
   for(size_t i = 0; i < my_phenotypes.size(); ++i)
   {
     my_phenotypes[i] = my_main_phenotype_field.getAdjValue(i);
+    my_valid[i]      = my_sampledata.isValid(i);
     //cout << my_phenotypes[i] << endl;
   }
 }
@@ -127,6 +129,8 @@ MccContinuousBoth::MccContinuousBoth(const Configuration& config,
   my_transformed_phenotypes.resize((size_t)my_sampledata.getTotalIndividualCount(), QNAN);
   my_transformed_phenotypic_means.resize((size_t)my_sampledata.getTotalIndividualCount(), QNAN);
   my_diffs.resize((size_t)my_sampledata.getTotalIndividualCount(), QNAN);
+
+  my_phenotype_column.set_traits(my_phenotypes, my_valid);
 }
  
 int
@@ -165,20 +169,16 @@ MccContinuousBoth::doTransformations()
  
   if(my_config.getTransConfig().get_type() != MFSUBMODELS::Transformation::NONE)
   {
-    if(! my_transf_facade.calculate_geometric_mean(my_phenotypes))
+    if(! my_transf_facade.calculate_geometric_mean(my_phenotype_column))
       return  false;
 
-    for(size_t i = 0; i < my_transformed_phenotypes.size(); ++i)
-    {
-      if(my_sampledata.isValid(i))
-      {
-        if(! my_transf_facade.transform(my_transformed_phenotypes[i]))
-          return false;
+    if(! my_transf_facade.transform(my_phenotype_column, my_transformed_phenotypes))
+      return false;
 
-        if(! my_transf_facade.transform(my_transformed_phenotypic_means[i]))
-          return false;
-      }
-    }
+    my_mean_column.set_traits(my_phenotypic_means, my_valid);
+
+    if(! my_transf_facade.transform(my_mean_column, my_transformed_phenotypic_means))
+      return false;
   }
 
   return true;
@@ -268,21 +268,16 @@ MccContinuousDiff::doTransformations()
     */
     //else
     //{
-      if(! my_transf_facade.calculate_geometric_mean(my_diffs))
+      my_diff_column.set_traits(my_diffs, my_valid);
+
+      if(! my_transf_facade.calculate_geometric_mean(my_diff_column))
       {
         return  false;
       }
     //}
     
-    for(size_t i = 0; i < my_transformed_diffs.size(); ++i)
-    {
-      if(my_sampledata.isValid(i))
-      {
-        if(! my_transf_facade.transform(my_transformed_diffs[i]))
-          return  false;
-        //cout << "transformed diff " << my_transformed_diffs[i] << endl;
-      }
-    }    
+    if(! my_transf_facade.transform(my_diff_column, my_transformed_diffs))
+      return  false;
   }
 
   return true;
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <cassert>
+#include "containers/assoc_cache.h"
+
+using namespace std;
+using namespace SAGE;
+
+struct identity_hash
+{
+  size_t operator()(size_t x) const { return x; }
+};
+
+int main()
+{
+  // 4 sets of 2 ways.  With the identity hash, keys congruent mod 4 share a
+  // set.
+
+  typedef assoc_cache<size_t, size_t, identity_hash> cache_type;
+
+  cache_type c(3, 2);
+
+  assert(c.set_count() == 4 && c.ways() == 2 && c.capacity() == 8);
+
+  for(size_t i = 0; i < 8; ++i)
+    c.insert(i, 10 * i);
+
+  assert(c.size() == 8 && c.evictions() == 0);
+
+  for(size_t i = 0; i < 8; ++i)
+    assert(c.find(i) && *c.find(i) == 10 * i);
+
+  // Key 0 was used after key 4, so 8 evicts 4.
+
+  c.find(0);
+  c.insert(8, 80);
+
+  assert(c.evictions() == 1);
+  assert(c.find(4) == NULL);
+  assert(*c.find(0) == 0 && *c.find(8) == 80);
+
+  // Replacing a value doesn't evict.  A new key in a full set does.
+
+  c.insert(8, 81);
+
+  assert(c.evictions() == 1);
+
+  c[9] += 1;
+
+  assert(c.evictions() == 2);
+  assert(*c.find(8) == 81 && *c.find(9) == 1);
+
+  cout << "size "       << c.size()
+       << ", hits "      << c.hits()
+       << ", misses "    << c.misses()
+       << ", evictions " << c.evictions() << endl;
+
+  c.clear();
+
+  assert(c.size() == 0 && c.find(0) == NULL);
+
+  c.resize(1, 1);
+  c[1] = 1;
+  c[2] = 2;
+
+  assert(c.find(1) == NULL && *c.find(2) == 2 && c.evictions() == 3);
+
+  cout << "OK" << endl;
+
+  return 0;
+}
@@ -5,6 +5,9 @@
 #include "error/errormanip.h"
 #include "error/errorbuf.h"
 #include "func/evalfunc.h"
+#include "util/BinaryImage.h"
+#include "rped/snapshot.h"
+#include "app/SAGEapp.h"
 #include "data/SAGEdata.h"
 
 namespace SAGE {
@@ -40,7 +43,19 @@ link_model_to_pedigree(RPED::RefMultiPedigree& mped, size_t m, Output_Streams& o
 }
 
 void
-check_marker_data(RPED::RefMultiPedigree& mped, Output_Streams& out)
+warn_unusable_marker(const std::string& name, Output_Streams& out)
+{
+  out.errors() << priority(warning) << "No usable data found for "
+               << "marker '" << name << "'.  This marker will "
+               << "be considered unknown for all analyses." << std::endl;
+}
+
+/// Gives each marker without data a single allele, warning about it, and
+/// links type probability models.  The markers without data are added to
+/// unusable_markers.
+void
+check_marker_data(RPED::RefMultiPedigree& mped, Output_Streams& out,
+                  std::vector<std::string>& unusable_markers)
 {
   for(size_t i = 0; i < mped.info().marker_count(); ++i)
   {
@@ -48,9 +63,9 @@ check_marker_data(RPED::RefMultiPedigree& mped, Output_Streams& out)
 
     if(model.allele_count() == 0)
     {
-      out.errors() << priority(warning) << "No usable data found for "
-                   << "marker '" << model.name() << "'.  This marker will "
-                   << "be considered unknown for all analyses." << std::endl;
+      warn_unusable_marker(model.name(), out);
+
+      unusable_markers.push_back(model.name());
 
       model.add_allele("A", 1.0, true, true);
     }
@@ -257,6 +272,8 @@ SAGE_Data::read_parameter_file(const std::string& fname)
   LSF_input load_state(in_state, std::cout);
   assert(load_state.good());
 
+  my_parameter_file = fname;
+
   my_params = new LSFBase("Parameters");
   load_state.input_to(my_params, false);
 
@@ -371,14 +388,28 @@ SAGE_Data::read_family_data_file(const std::string& fname,
   bool   dump_pairs     = false;
   bool   pedigree_exist = false;
 
+  std::vector<std::string> pedigree_files;
+
   for(LSFList::const_iterator i = my_params->List()->begin(); i != my_params->List()->end(); ++i )
   {
     if( !*i ) continue;
 
+    if( toUpper((*i)->name()) == "DUMP_PAIRS" )
+      dump_pairs = true;
+
     if( toUpper((*i)->name()) == "PEDIGREE" )
     {
       pedigree_exist = true;
-      break;
+
+      std::string pedigree_file;
+
+      if( (*i)->attrs() )
+        pedigree_file = (*i)->attrs()->StringAttr("file");
+
+      if( !pedigree_file.size() )
+        pedigree_file = fname;
+
+      pedigree_files.push_back(pedigree_file);
     }
   }
 
@@ -391,6 +422,69 @@ SAGE_Data::read_family_data_file(const std::string& fname,
     exit(EXIT_FAILURE);
   }
 
+  // If there is a snapshot file, and it holds this data, built with these
+  // options, from these files as they are now, load that instead.
+
+  std::ostringstream options;
+
+  options << dump_trait << dump_marker << skip_traits << skip_markers << dynamic_markers;
+
+  uint64_t snapshot_key   = 0,
+           snapshot_hash  = 0;
+  bool     use_snapshot   = SAGEapp::snapshot_file().size() && !my_pedigrees.pedigree_count() &&
+                            snapshot_hashes(pedigree_files, options.str(), snapshot_key, snapshot_hash);
+
+  std::string              pedigree_listing;
+  size_t                   error_count = 0;
+  std::vector<std::string> unusable_markers;
+
+  if( use_snapshot && load_snapshot(snapshot_key, snapshot_hash, pedigree_listing, error_count, unusable_markers) )
+  {
+    info() << pedigree_listing << std::flush;
+
+    if( error_count )
+    {
+      errors() << priority(error) << "Errors appear in pedigree data. Results may be incomplete." << std::endl;
+    }
+
+    check_family_data(my_pedigrees);
+
+    // The markers were checked before they were stored, so give the
+    // warnings of check_marker_data() again.
+
+    for( size_t m = 0; m < unusable_markers.size(); ++m )
+      warn_unusable_marker(unusable_markers[m], my_output);
+  }
+  else
+  {
+    read_pedigree_files(pedigree_files, dump_trait, dump_marker, skip_traits, skip_markers,
+                        dynamic_markers, pedigree_listing, error_count, unusable_markers);
+
+    if( use_snapshot )
+      store_snapshot(snapshot_key, snapshot_hash, pedigree_listing, error_count, unusable_markers);
+  }
+
+  if( !skip_markers && dump_marker && marker_count )
+    print_genome_info_file(markers());
+
+  // - Remember original marker order.
+  //
+  my_marker_order = marker_order(&(my_pedigrees.info().markers()));
+
+  return dump_pairs;
+}
+
+void
+SAGE_Data::read_pedigree_files(const std::vector<std::string>& pedigree_files,
+                               bool dump_trait,
+                               bool dump_marker,
+                               bool skip_traits,
+                               bool skip_markers,
+                               bool dynamic_markers,
+                               std::string& pedigree_listing,
+                               size_t& error_count,
+                               std::vector<std::string>& unusable_markers)
+{
   bufferederrorstream<char>                   err_buffer        (errors());
   boost::scoped_ptr<RPED::RefLSFPedigreeFile> ped_reader;
   bool                                        pedigree_loaded =  false;
@@ -398,18 +492,11 @@ SAGE_Data::read_family_data_file(const std::string& fname,
 
   for(LSFList::const_iterator i = my_params->List()->begin(); i != my_params->List()->end(); ++i )
   {
-    if( toUpper( (*i)->name() ) == "DUMP_PAIRS" )
-      dump_pairs = true;
+    if( !*i ) continue;
 
     if( toUpper((*i)->name()) == "PEDIGREE" )
     {
-      std::string pedigree_file;
-
-      if( (*i)->attrs() )
-        pedigree_file = (*i)->attrs()->StringAttr("file");
-
-      if( !pedigree_file.size() )
-        pedigree_file = fname;
+      const std::string& pedigree_file = pedigree_files[f];
 
       if( (*i)->attrs() && (*i)->attrs()->has_attr("column") )
       {
@@ -437,18 +524,7 @@ SAGE_Data::read_family_data_file(const std::string& fname,
         exit(EXIT_FAILURE);
       }
 
-      // Print out a number of .'s equal to 23 - the filename size to line up the
-      // columns
-      char old_fill = std::cout.fill('.');
-
-      if(pedigree_file.size() < 23)
-      {
-        std::cout << setw(23-pedigree_file.size()) << '.';
-      }
-
-      std::cout << "done." << std::endl;
-
-      std::cout.fill(old_fill);
+      print_dots(pedigree_file);
 
       err_buffer.flush_buffer();
 
@@ -462,7 +538,14 @@ SAGE_Data::read_family_data_file(const std::string& fname,
           my_first_ten_ind[ind] = ped_reader->get_ind_list()[ind];
       }
 
-      ped_reader->print_mped(my_pedigrees, pedigree_file, info(), dump_trait, dump_marker);
+      // The listing is kept for the snapshot.
+
+      std::ostringstream listing;
+
+      ped_reader->print_mped(my_pedigrees, pedigree_file, listing, dump_trait, dump_marker);
+
+      info()           << listing.str() << std::flush;
+      pedigree_listing += listing.str();
 
       ++f;
     }
@@ -484,7 +567,7 @@ SAGE_Data::read_family_data_file(const std::string& fname,
     exit(EXIT_FAILURE);
   }
 
-  size_t error_count = 0;
+  error_count = 0;
 
   for(RPED::RefMultiPedigree::pedigree_const_iterator p = my_pedigrees.pedigree_begin(); p != my_pedigrees.pedigree_end(); ++p )
     error_count += p->error_count();
@@ -505,16 +588,183 @@ SAGE_Data::read_family_data_file(const std::string& fname,
   // Check for basic structural errors
   check_family_data(my_pedigrees);
 
-  check_marker_data(my_pedigrees, my_output);
+  check_marker_data(my_pedigrees, my_output, unusable_markers);
+}
 
-  if( !skip_markers && dump_marker && marker_count )
-    print_genome_info_file(markers());
+void
+SAGE_Data::print_dots(const std::string& name) const
+{
+  // Print out a number of .'s equal to 23 - the filename size to line up the
+  // columns
+  char old_fill = std::cout.fill('.');
 
-  // - Remember original marker order.
-  //
-  my_marker_order = marker_order(&(my_pedigrees.info().markers()));
+  if(name.size() < 23)
+  {
+    std::cout << setw(23-name.size()) << '.';
+  }
 
-  return dump_pairs;
+  std::cout << "done." << std::endl;
+
+  std::cout.fill(old_fill);
+}
+
+//==================================================================
+//
+//  Pedigree snapshots
+//
+//==================================================================
+//
+// A snapshot entry is keyed by everything the read depends on besides the
+// contents of the files: the file names, the read options, and the state of
+// the pedigree info beforehand (the markers read from locus files, the
+// MARKER block options), so that programs reading the same data the same
+// way share an entry.  The entry holds the first individuals read, the
+// family structure listing written to the information file, the pedigree
+// error count, the markers found without data and the sorted, checked
+// multipedigree.  The layout of the entry is part of the key.
+
+const uint64_t SNAPSHOT_ENTRY_VERSION = 2;
+
+bool
+SAGE_Data::snapshot_hashes(const std::vector<std::string>& pedigree_files,
+                           const std::string&              options,
+                           uint64_t&                       key,
+                           uint64_t&                       content_hash) const
+{
+  std::string              info_image;
+  UTIL::BinaryImageWriter  out(info_image);
+
+  RPED::write_image(out, my_pedigrees.info());
+
+  UTIL::ContentHash k;
+
+  k.add_uint64(SNAPSHOT_ENTRY_VERSION);
+  k.add_string(my_parameter_file);
+  k.add_string(options);
+  k.add_string(info_image);
+
+  for(size_t f = 0; f < pedigree_files.size(); ++f)
+    k.add_string(pedigree_files[f]);
+
+  UTIL::ContentHash c;
+
+  c.add_uint64(k.value());
+
+  bool files_read = c.add_file(my_parameter_file);
+
+  for(size_t f = 0; f < pedigree_files.size(); ++f)
+    files_read = c.add_file(pedigree_files[f]) && files_read;
+
+  key          = k.value();
+  content_hash = c.value();
+
+  return files_read;
+}
+
+bool
+SAGE_Data::load_snapshot(uint64_t                  key,
+                         uint64_t                  content_hash,
+                         std::string&              pedigree_listing,
+                         size_t&                   error_count,
+                         std::vector<std::string>& unusable_markers)
+{
+  RPED::snapshot_file snapshot;
+
+  const char* first = NULL;
+  const char* last  = NULL;
+
+  if( !snapshot.open(SAGEapp::snapshot_file()) || !snapshot.find(key, content_hash, first, last) )
+    return false;
+
+  UTIL::BinaryImageReader in(first, last);
+
+  vector<pair<string, string> > first_ten_ind;
+
+  uint64_t ind_count = in.get_uint64();
+
+  for( uint64_t ind = 0; ind < ind_count && in.good(); ++ind )
+  {
+    std::string ped_name = in.get_string();
+    std::string ind_name = in.get_string();
+
+    first_ten_ind.push_back(make_pair(ped_name, ind_name));
+  }
+
+  in.get_string(pedigree_listing);
+
+  error_count = in.get_uint64();
+
+  vector<string> unusable;
+
+  uint64_t unusable_count = in.get_uint64();
+
+  for( uint64_t m = 0; m < unusable_count && in.good(); ++m )
+    unusable.push_back(in.get_string());
+
+  if( !in.good() || !RPED::read_image(in, my_pedigrees) )
+  {
+    // The image is checked before the pedigrees are changed; if they were,
+    // they cannot be read again into the same object.
+
+    if( my_pedigrees.pedigree_count() )
+    {
+      errors() << priority(fatal) << "Unable to rebuild the pedigree data from snapshot file '"
+               << SAGEapp::snapshot_file() << "'.  Remove the file and rerun." << std::endl;
+
+      exit(EXIT_FAILURE);
+    }
+
+    errors() << priority(warning) << "Snapshot file '" << SAGEapp::snapshot_file()
+             << "' is damaged.  Reading the pedigree data instead." << std::endl;
+
+    return false;
+  }
+
+  my_first_ten_ind.swap(first_ten_ind);
+  unusable_markers.swap(unusable);
+
+  std::cout << "              from snapshot " << SAGEapp::snapshot_file() << flush;
+
+  print_dots("snapshot " + SAGEapp::snapshot_file());
+
+  return true;
+}
+
+void
+SAGE_Data::store_snapshot(uint64_t                        key,
+                          uint64_t                        content_hash,
+                          const std::string&              pedigree_listing,
+                          size_t                          error_count,
+                          const std::vector<std::string>& unusable_markers) const
+{
+  std::string             image;
+  UTIL::BinaryImageWriter out(image);
+
+  out.put_uint64(my_first_ten_ind.size());
+
+  for( size_t ind = 0; ind < my_first_ten_ind.size(); ++ind )
+  {
+    out.put_string(my_first_ten_ind[ind].first);
+    out.put_string(my_first_ten_ind[ind].second);
+  }
+
+  out.put_string(pedigree_listing);
+  out.put_uint64(error_count);
+
+  out.put_uint64(unusable_markers.size());
+
+  for( size_t m = 0; m < unusable_markers.size(); ++m )
+    out.put_string(unusable_markers[m]);
+
+  RPED::write_image(out, my_pedigrees);
+
+  RPED::snapshot_file snapshot;
+
+  if( !snapshot.store(SAGEapp::snapshot_file(), key, content_hash, image) )
+  {
+    errors() << priority(warning) << "Unable to write snapshot file '"
+             << SAGEapp::snapshot_file() << "'." << std::endl;
+  }
 }
 
 bool
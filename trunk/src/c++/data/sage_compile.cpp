@@ -0,0 +1,79 @@
+//
+//  File:     sage_compile.cpp
+//
+//  Purpose:  Builds the pedigree data snapshots used by the SAGE programs
+//            (see SAGEapp::snapshot_file()) ahead of an analysis pipeline,
+//            so that no program in it has to read the pedigree files.
+//
+//  History:  Initial implementation.  Oct. 2026
+//
+//  Copyright (c) 2026 R. C. Elston
+
+#include <cstdlib>
+#include <iostream>
+#include "app/SAGEapp.h"
+#include "data/SAGEdata.h"
+
+using namespace std;
+using namespace SAGE;
+
+class sage_compile_data : public APP::SAGE_Data
+{
+  public:
+
+    sage_compile_data() : APP::SAGE_Data("sage_compile", false) { }
+
+    /// Reads the data as programs which read it with the given options do,
+    /// storing the snapshot entry for them.
+    void compile(const string& param_file, const string& ped_file, const string& locus_file,
+                 bool dump_trait, bool dump_marker, bool skip_traits, bool skip_markers,
+                 bool dynamic_markers)
+    {
+      read_parameter_file(param_file);
+
+      if( locus_file.size() )
+        read_locus_description_file(locus_file);
+
+      read_family_data_file(ped_file, dump_trait, dump_marker, skip_traits, skip_markers, dynamic_markers);
+    }
+
+    virtual bool read_analysis() { return true; }
+};
+
+int main(int argc, char* argv[])
+{
+  if( argc < 4 )
+  {
+    cerr << "usage: " << argv[0] << " snapshot_file parameter_file pedigree_file [locus_file]" << endl
+         << endl
+         << "Builds the pedigree data snapshots read by SAGE programs run with" << endl
+         << "--snapshot=snapshot_file on the same files." << endl;
+
+    exit(EXIT_FAILURE);
+  }
+
+  APP::SAGEapp::set_snapshot_file(argv[1]);
+
+  string locus_file = argc > 4 ? argv[4] : "";
+
+  // The ways the programs read their pedigree data (dump_trait, dump_marker,
+  // skip_traits, skip_markers, dynamic_markers).  Each has its own entry.
+
+  static const bool options[][5] =
+  {
+    { true,  true,  false, false, true  },   // FREQ, SIBPAL, RELPAL, DECIPHER, FCOR
+    { false, true,  true,  false, false },   // GENIBD, LODLINK, RELTEST, MLOD
+    { true,  false, false, false, true  },   // PEDINFO, SEGREG
+    { true,  false, false, true,  false }    // LODPAL
+  };
+
+  for( size_t i = 0; i < sizeof(options) / sizeof(options[0]); ++i )
+  {
+    sage_compile_data data;
+
+    data.compile(argv[2], argv[3], locus_file,
+                 options[i][0], options[i][1], options[i][2], options[i][3], options[i][4]);
+  }
+
+  return EXIT_SUCCESS;
+}
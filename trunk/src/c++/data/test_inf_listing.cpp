@@ -0,0 +1,120 @@
+//
+//  File:     test_inf_listing.cpp
+//
+//  Purpose:  Reads the same pedigree data twice with a snapshot file, first
+//            from the pedigree file and then from the snapshot, and checks
+//            that the information file gets the family structure and
+//            phenotype listings both times.
+//
+//  History:  Initial implementation.  Oct. 2026
+//
+//  Copyright (c) 2026 R. C. Elston
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "LSF/LSFinit.h"
+#include "app/SAGEapp.h"
+#include "data/SAGEdata.h"
+
+using namespace std;
+using namespace SAGE;
+
+int failures = 0;
+
+void check(const string& name, bool ok)
+{
+  if( !ok )
+    ++failures;
+
+  cout << (ok ? "ok    " : "FAILED") << "  " << name << endl;
+}
+
+class listing_data : public APP::SAGE_Data
+{
+  public:
+
+    listing_data(const string& program_name) : APP::SAGE_Data(program_name, false) { }
+
+    /// Reads the data as PEDINFO and SEGREG do.
+    void read(const string& param_file, const string& ped_file)
+    {
+      read_parameter_file(param_file);
+
+      read_family_data_file(ped_file, true, false, false, false, true);
+    }
+
+    virtual bool read_analysis() { return true; }
+};
+
+string file_contents(const string& file_name)
+{
+  ifstream f(file_name.c_str());
+
+  ostringstream s;
+
+  s << f.rdbuf();
+
+  return s.str();
+}
+
+/// The listing of the information file, from the family structure on.
+string listing(const string& information)
+{
+  string::size_type start = information.find("Family structure information");
+
+  return start == string::npos ? string() : information.substr(start);
+}
+
+void check_listing(const string& name, const string& information)
+{
+  check(name + " lists the family structure",
+        information.find("Family structure information on the first 10 individuals") != string::npos);
+  check(name + " lists the phenotypes",
+        information.find("Phenotypes for the first 10 individuals") != string::npos);
+}
+
+int main(int argc, char* argv[])
+{
+  if( argc < 3 )
+  {
+    cerr << "usage: " << argv[0] << " parameter_file pedigree_file" << endl;
+
+    exit(EXIT_FAILURE);
+  }
+
+  LSFInit();
+
+  remove("listing.snp");
+
+  APP::SAGEapp::set_snapshot_file("listing.snp");
+
+  // The first read stores the snapshot entry, and the second loads it.
+
+  {
+    listing_data data("fresh");
+
+    data.read(argv[1], argv[2]);
+  }
+
+  {
+    listing_data data("snapshot");
+
+    data.read(argv[1], argv[2]);
+  }
+
+  string fresh    = file_contents("fresh.inf"),
+         snapshot = file_contents("snapshot.inf");
+
+  cout << endl;
+
+  check_listing("read from the pedigree file:",  fresh);
+  check_listing("loaded from the snapshot:",     snapshot);
+
+  check("the listings are the same", listing(fresh).size() && listing(fresh) == listing(snapshot));
+
+  cout << endl << failures << " failures." << endl;
+
+  return failures ? 1 : 0;
+}
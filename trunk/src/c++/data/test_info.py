@@ -29,3 +29,16 @@ class data_tests(sagetest.SAGE_Test):
     self.file_names = ['screen']
     self.execute()
     
+  def test_inf_listing(self):
+    """
+    Purpose:  test that the information file lists the pedigree data, both
+              when it is read from the pedigree file and when it is loaded
+              from a snapshot.
+    
+    Basis:    hand inspection. 
+    """
+    
+    self.cmd = 'test_inf_listing par ped > out 2>/dev/null'
+    self.file_names = ['out']
+    self.execute()
+    
@@ -12,6 +12,7 @@
 // All Rights Reserved
 //============================================================================
 
+#include "util/ThreadPool.h"
 #include "decipher/analysis.h"
 
 namespace SAGE
@@ -23,6 +24,11 @@ namespace DECIPHER
 const double  LD_ERROR_TOLERANCE = .05;
 const double  ALLELE_FREQUENCY_TOLERANCE = .20;
 
+// - Permutations evaluated per thread between checks of the stopping rule
+//   when permutations are run concurrently.
+//
+const size_t  PERMUTATIONS_PER_THREAD = 4;
+
 void
 write_blocks(ostream& out, const block_vector& bv)
 {
@@ -658,6 +664,16 @@ analysis::do_permutation_test(double test_statistic,
   suf.dump(cout);
 #endif
 
+  size_t  thread_count = my_instructions.threads ? my_instructions.threads
+                                                 : UTIL::ThreadPool::default_thread_count();
+
+  if( thread_count > 1 )
+  {
+    return  do_concurrent_permutation_test(test_statistic, whole_ln_likelihood, suf, phenotype_maps, loci,
+                                           min_permutations, max_permutations, precision,
+                                           thread_count, total_permutations);
+  }
+
   double emp_p = 1.0;
 
   size_t significant_permutations = 1;
@@ -727,6 +743,203 @@ analysis::do_permutation_test(double test_statistic,
   return emp_p;
 }
 
+//----------------------------------------------------------------------------
+//  Class:    permutation_replicates
+//
+//  Purpose:  Evaluates the test statistic of a round of permutations as a
+//            UTIL::ThreadPool task.
+//
+//  Notes:    Each permutation has its own random source, seeded from the
+//            base seed and the permutation's number, which is used both to
+//            shuffle the members and to choose the EM starting points.  The
+//            statistic of a permutation therefore depends only on the base
+//            seed and its number, and not on the number of threads or the
+//            order in which the permutations are run.
+//----------------------------------------------------------------------------
+//
+class permutation_replicates
+{
+  public:
+    permutation_replicates(output_state& ostate, APP::Output_Streams& streams,
+                           const instructions& instr, ostream& dump_file,
+                           const sub_pop_shuffler& suf,
+                           const vector<const member_em_phenotype_map*>& phenotype_maps,
+                           const locus_group& loci, double whole_ln_likelihood,
+                           unsigned long base_seed);
+
+    void  start_round(size_t first_permutation, size_t count);
+    void  run(size_t item, size_t worker);
+
+    bool    completed(size_t item) const;
+    double  statistic(size_t item) const;
+
+  private:
+    unsigned long  permutation_seed(size_t permutation) const;
+
+    output_state&  my_output_state;
+    APP::Output_Streams&  my_streams;
+    const instructions&  my_instructions;
+    ostream&  my_dump_file;
+    const sub_pop_shuffler&  my_shuffler;
+    const vector<const member_em_phenotype_map*>&  my_phenotype_maps;
+    const locus_group&  my_loci;
+    double  my_whole_ln_likelihood;
+    unsigned long  my_base_seed;
+
+    size_t  my_first_permutation;
+    vector<double>  my_statistics;
+    vector<char>  my_completed;     // Not vector<bool>;  written by several threads.
+};
+
+permutation_replicates::permutation_replicates(output_state& ostate, APP::Output_Streams& streams,
+                                               const instructions& instr, ostream& dump_file,
+                                               const sub_pop_shuffler& suf,
+                                               const vector<const member_em_phenotype_map*>& phenotype_maps,
+                                               const locus_group& loci, double whole_ln_likelihood,
+                                               unsigned long base_seed)
+      : my_output_state(ostate), my_streams(streams), my_instructions(instr), my_dump_file(dump_file),
+        my_shuffler(suf), my_phenotype_maps(phenotype_maps), my_loci(loci),
+        my_whole_ln_likelihood(whole_ln_likelihood), my_base_seed(base_seed), my_first_permutation(0)
+{}
+
+void
+permutation_replicates::start_round(size_t first_permutation, size_t count)
+{
+  my_first_permutation = first_permutation;
+
+  my_statistics.assign(count, QNAN);
+  my_completed.assign(count, false);
+}
+
+// - Mixes the permutation number into the base seed so that neighboring
+//   permutations get unrelated streams.  The Mersenne Twister may not be
+//   seeded with 0.
+//
+unsigned long
+permutation_replicates::permutation_seed(size_t permutation) const
+{
+  unsigned long  s = (my_base_seed + 0x9E3779B9UL * (permutation + 1)) & 0xFFFFFFFFUL;
+
+  s ^= s >> 16;  s = (s * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+  s ^= s >> 13;  s = (s * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+  s ^= s >> 16;
+
+  return  s ? s : 1;
+}
+
+void
+permutation_replicates::run(size_t item, size_t)
+{
+  MersenneTwister  random_source(permutation_seed(my_first_permutation + item));
+
+  sub_pop_shuffler::sub_pops  new_sub_pops;
+
+  if( !my_shuffler.shuffle(random_source, new_sub_pops) )
+    return;
+
+  // - Calculate numerator of likelihood ratio.
+  //
+  double  composite_ln_likelihood = 0.;
+
+  for( size_t s = 0; s < new_sub_pops.size(); ++s )
+  {
+    rebuilt_em_phenotype_map a_new_sub_map(my_output_state, my_streams, my_loci, new_sub_pops[s],
+                                           my_phenotype_maps, random_source);
+
+    a_new_sub_map.maximize(my_instructions.epsilon, my_instructions.starting_points, my_dump_file);
+
+    composite_ln_likelihood += a_new_sub_map.max_ln_likelihood();
+  }
+
+  my_statistics[item] = 2 * (composite_ln_likelihood - my_whole_ln_likelihood);
+  my_completed[item]  = true;
+}
+
+inline bool
+permutation_replicates::completed(size_t item) const
+{
+  return  my_completed[item];
+}
+
+inline double
+permutation_replicates::statistic(size_t item) const
+{
+  return  my_statistics[item];
+}
+
+// - The permutations are run in rounds of PERMUTATIONS_PER_THREAD per
+//   thread.  After each round, the stopping rule of do_permutation_test()
+//   is applied to the completed permutations in order, exactly as if they
+//   had been run one at a time; permutations of the round after the one at
+//   which it stops are discarded.  The result depends on the test seed (the
+//   base seed is drawn from rand_src), but not on the number of threads.
+//
+double
+analysis::do_concurrent_permutation_test(double test_statistic,
+                                         double whole_ln_likelihood, const sub_pop_shuffler& suf,
+                                         const vector<const member_em_phenotype_map *>& phenotype_maps,
+                                         const locus_group& loci, double min_permutations,
+                                         double max_permutations, double precision,
+                                         size_t thread_count, size_t& total_permutations)
+{
+  UTIL::ThreadPool  pool(thread_count);
+
+  permutation_replicates  replicates(my_output_state, my_streams, my_instructions, my_dump_file,
+                                     suf, phenotype_maps, loci, whole_ln_likelihood,
+                                     rand_src.uniform_integer());
+
+  UTIL::MemberTask<permutation_replicates>  task(replicates, &permutation_replicates::run);
+
+  double emp_p = 1.0;
+
+  size_t significant_permutations = 1;
+  total_permutations       = 1;
+
+  size_t  permutation_count = static_cast<size_t>(ceil(max_permutations));
+  size_t  round_size        = thread_count * PERMUTATIONS_PER_THREAD;
+
+  bool  stop = false;
+
+  for( size_t first = 0; first < permutation_count && !stop; first += round_size )
+  {
+    size_t  count = min(round_size, permutation_count - first);
+
+    replicates.start_round(first, count);
+
+    pool.run(count, task);
+
+    for( size_t r = 0; r < count; ++r )
+    {
+      size_t  i = first + r;
+
+      // - Invalid shuffles, and any permutation which failed, are skipped
+      //   as in do_permutation_test().
+      //
+      if( !replicates.completed(r) )
+        continue;
+
+      if( replicates.statistic(r) > test_statistic )
+        ++significant_permutations;
+
+      ++total_permutations;
+
+      emp_p = double(significant_permutations) / double(total_permutations);
+
+      double m = i * emp_p / (1.0 - emp_p);
+
+      if( i > min_permutations && m > precision )
+      {
+        stop = true;
+        break;
+      }
+    }
+  }
+
+  --total_permutations;    // Since this starts with a value of 1.
+
+  return emp_p;
+}
+
 
 //============================================================================
 // IMPLEMENTATION:  blocks
@@ -1047,7 +1260,7 @@ linkage_disequilibrium_blocks::lewontins_ld(const base_em_phenotype_map* em_map)
 
   const em_haplotype_map&  final_haplotype_map = em_map->final_haplotypes();
 
-  assert(! final_haplotype_map.haplotypes().empty());
+  assert(! final_haplotype_map.empty());
 
   hap_seq  seq_00;
   seq_00.push_back(0);
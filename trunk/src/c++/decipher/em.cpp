@@ -99,6 +99,213 @@ dump_locus(ostream& out, const inheritance_model* locus)
 // IMPLEMENTATION:  em_haplotype_map
 //============================================================================
 //
+em_haplotype_map::em_haplotype_map(const locus_group& loci)
+      : my_keys_packed(true), my_sequence_begin(1, 0), counts_initialized(false)
+{
+  // - Allele ids at a locus run from 0 to allele_count - 1.  The largest
+  //   value of each field is MLOCUS::NPOS.
+  //
+  size_t  total_bits = 0;
+  
+  size_t  locus_count = loci.size();
+  for(size_t l = 0; l < locus_count; ++l)
+  {
+    size_t  allele_count = loci[l].second->allele_count();
+    
+    size_t  bits = 1;
+    while(bits < 64 && ((packed_key)(1) << bits) <= allele_count)
+    {
+      ++bits;
+    }
+    
+    my_allele_bits.push_back(bits);
+    total_bits += bits;
+  }
+  
+  if(total_bits > 64)
+  {
+    unpack_keys();
+  }
+}
+
+// - If haplotype doesn't exist, create it.  Return haplotype index.
+//
+size_t 
+em_haplotype_map::add_haplotype(const hap_seq& key)
+{
+  const size_t*  alleles = key.empty() ? 0 : &key[0];
+  
+  size_t  index = find_index(alleles, key.size());
+  if(index != (size_t)(-1))
+  {
+    return  index;
+  }
+  
+  packed_key  packed = 0;
+  if(my_keys_packed && ! pack(alleles, key.size(), packed))
+  {
+    unpack_keys();
+  }
+  
+  index = my_haplotypes.size();
+  
+  my_alleles.insert(my_alleles.end(), key.begin(), key.end());
+  my_sequence_begin.push_back(my_alleles.size());
+  my_haplotypes.push_back(em_haplotype());
+  
+  if(my_keys_packed)
+  {
+    my_keys.push_back(packed);
+  }
+  
+  // - Keep the table at most half full.
+  //
+  if(2 * my_haplotypes.size() > my_slots.size())
+  {
+    rebuild_index();
+  }
+  else
+  {
+    insert_index(index);
+  }
+  
+  return  index;
+}
+
+bool
+em_haplotype_map::pack(const size_t* alleles, size_t allele_count, packed_key& key) const
+{
+  if(! my_keys_packed || allele_count != my_allele_bits.size())
+  {
+    return  false;
+  }
+  
+  key = 0;
+  
+  size_t  shift = 0;
+  for(size_t l = 0; l < allele_count; ++l)
+  {
+    packed_key  field_max = ((packed_key)(-1)) >> (64 - my_allele_bits[l]);
+    packed_key  field     = field_max;
+    
+    if(alleles[l] != MLOCUS::NPOS)
+    {
+      if(alleles[l] >= field_max)
+      {
+        return  false;
+      }
+      
+      field = alleles[l];
+    }
+    
+    key   |= field << shift;
+    shift += my_allele_bits[l];
+  }
+  
+  return  true;
+}
+
+size_t
+em_haplotype_map::hash(const size_t* alleles, size_t allele_count, packed_key key, bool packed) const
+{
+  if(! packed)
+  {
+    key = 14695981039346656037ULL;
+    for(size_t l = 0; l < allele_count; ++l)
+    {
+      key = (key ^ alleles[l]) * 1099511628211ULL;
+    }
+  }
+  
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  
+  return  (size_t)(key);
+}
+
+// - Return haplotype index, or (size_t)(-1) if not present.
+//
+size_t
+em_haplotype_map::find_index(const size_t* alleles, size_t allele_count) const
+{
+  if(my_slots.empty())
+  {
+    return  (size_t)(-1);
+  }
+  
+  packed_key  key = 0;
+  bool  packed = pack(alleles, allele_count, key);
+  
+  // - Every sequence in a packed map could be packed.
+  //
+  if(my_keys_packed && ! packed)
+  {
+    return  (size_t)(-1);
+  }
+  
+  size_t  mask = my_slots.size() - 1;
+  for(size_t slot = hash(alleles, allele_count, key, packed) & mask; my_slots[slot]; slot = (slot + 1) & mask)
+  {
+    size_t  index = my_slots[slot] - 1;
+    
+    if(packed ? my_keys[index] == key : same_sequence(index, alleles, allele_count))
+    {
+      return  index;
+    }
+  }
+  
+  return  (size_t)(-1);
+}
+
+void
+em_haplotype_map::insert_index(size_t index)
+{
+  size_t  slot = my_keys_packed ? hash(0, 0, my_keys[index], true)
+                                : hash(sequence(index), sequence_size(index), 0, false);
+  
+  size_t  mask = my_slots.size() - 1;
+  for(slot &= mask; my_slots[slot]; slot = (slot + 1) & mask)
+  { }
+  
+  my_slots[slot] = index + 1;
+}
+
+void
+em_haplotype_map::rebuild_index()
+{
+  size_t  slot_count = 16;
+  while(slot_count < 4 * my_haplotypes.size())
+  {
+    slot_count *= 2;
+  }
+  
+  my_slots.assign(slot_count, 0);
+  
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
+  {
+    insert_index(index);
+  }
+}
+
+// - Key by sequence from now on.
+//
+void
+em_haplotype_map::unpack_keys()
+{
+  my_keys_packed = false;
+  my_allele_bits.clear();
+  my_keys.clear();
+  
+  if(! my_slots.empty())
+  {
+    rebuild_index();
+  }
+}
+
 // - Revise haplotype counts to reflect new weights for haplotype 
 //   combinations.  This is the 'maximization' step.
 //
@@ -113,16 +320,15 @@ em_haplotype_map::update_counts(const base_em_phenotype_map& pm)
   {
     if((! counts_initialized) || p_iter->is_ambiguous())
     {
-      const vector<pair<em_phenotype::combination, double> >&  combs = p_iter->combinations();
-      size_t  comb_count = combs.size();      
+      size_t  comb_count = p_iter->comb_count();
       for(size_t c = 0; c < comb_count; c++)
       {
-        double  amount = p_iter->count() * combs[c].second;
+        double  amount = p_iter->count() * p_iter->comb_weight(c);
         
-        size_t  hap_count = combs[c].first.size();
+        size_t  hap_count = p_iter->comb_haplotype_count(c);
         for(size_t h = 0; h < hap_count; h++)
         {
-          (*this)[combs[c].first[h]].incr(amount);
+          my_haplotypes[p_iter->comb_haplotype(c, h)].incr(amount);
         }
       }        
     }
@@ -132,12 +338,11 @@ em_haplotype_map::update_counts(const base_em_phenotype_map& pm)
 void
 em_haplotype_map::dump(ostream& out, size_t total_hap_count, const locus_group& loci) const
 {
-  map<size_t, em_haplotype>::const_iterator  h_iter = my_haplotypes.begin();
-  map<size_t, em_haplotype>::const_iterator  h_end_iter = my_haplotypes.end();
-  for(; h_iter != h_end_iter; ++h_iter)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    write_hap_seq(out, h_iter->second.sequence(), loci);
-    out << "   " << h_iter->second.new_freq(total_hap_count) << endl;
+    write_hap_seq(out, index_to_hap_seq(index), loci);
+    out << "   " << my_haplotypes[index].new_freq(total_hap_count) << endl;
   }
 }
 
@@ -146,8 +351,9 @@ em_haplotype_map::dump(ostream& out, size_t total_hap_count, const locus_group&
 //============================================================================
 //
 em_phenotype::em_phenotype(em_haplotype_map* haplotypes,
-                           const set<hap_seq_comb>& combinations)
-      : my_count(1), ambiguous(combinations.size() > 1)
+                           const set<hap_seq_comb>& combinations,
+                           const MersenneTwister& random_source)
+      : my_count(1), ambiguous(combinations.size() > 1), my_comb_begin(1, 0), my_distinct_begin(1, 0)
 {
   assert(haplotypes != 0);
 
@@ -157,22 +363,24 @@ em_phenotype::em_phenotype(em_haplotype_map* haplotypes,
   set<hap_seq_comb>::const_iterator  c_end_iter = combinations.end();
   for(; c_iter != c_end_iter; c_iter++)
   {
-    my_combinations.push_back(make_pair(combination(), 0.0));
+    combination  comb;
     hap_seq_comb::const_iterator  hs_iter = c_iter->begin();
     hap_seq_comb::const_iterator  hs_end_iter = c_iter->end();
     for(; hs_iter != hs_end_iter; ++hs_iter)
     {
-      size_t  index = haplotypes->add_haplotype(*hs_iter);
-      my_combinations.back().first.push_back(index);
+      comb.push_back(haplotypes->add_haplotype(*hs_iter));
     }
+    
+    add_combination(comb);
   }
   
-  init_weights();
+  init_weights(random_source);
 }
 
 em_phenotype::em_phenotype(em_haplotype_map* haplotypes,
-                           const vector<vector<hap_seq> >& combinations)
-      : my_count(1), ambiguous(combinations.size() > 1)
+                           const vector<vector<hap_seq> >& combinations,
+                           const MersenneTwister& random_source)
+      : my_count(1), ambiguous(combinations.size() > 1), my_comb_begin(1, 0), my_distinct_begin(1, 0)
 {
   assert(haplotypes != 0);
 
@@ -182,17 +390,47 @@ em_phenotype::em_phenotype(em_haplotype_map* haplotypes,
   vector<vector<hap_seq> >::const_iterator  c_end_iter = combinations.end();
   for(; c_iter != c_end_iter; c_iter++)
   {
-    my_combinations.push_back(make_pair(combination(), 0.0));
+    combination  comb;
     vector<hap_seq>::const_iterator  hs_iter = c_iter->begin();
     vector<hap_seq>::const_iterator  hs_end_iter = c_iter->end();
     for(; hs_iter != hs_end_iter; ++hs_iter)
     {
-      size_t  index = haplotypes->add_haplotype(*hs_iter);
-      my_combinations.back().first.push_back(index);
+      comb.push_back(haplotypes->add_haplotype(*hs_iter));
+    }
+    
+    add_combination(comb);
+  }
+  
+  init_weights(random_source);
+}
+
+// - Append a combination, and its distinct haplotypes with their number
+//   of copies in order of haplotype index.
+//
+void
+em_phenotype::add_combination(const combination& comb)
+{
+  my_comb_haplotypes.insert(my_comb_haplotypes.end(), comb.begin(), comb.end());
+  my_comb_begin.push_back(my_comb_haplotypes.size());
+  my_weights.push_back(0.0);
+  
+  combination  sorted_comb(comb);
+  sort(sorted_comb.begin(), sorted_comb.end());
+  
+  size_t  hap_count = sorted_comb.size();
+  for(size_t h = 0; h < hap_count; ++h)
+  {
+    if(h && sorted_comb[h] == sorted_comb[h - 1])
+    {
+      my_distinct.back().second++;
+    }
+    else
+    {
+      my_distinct.push_back(make_pair(sorted_comb[h], (size_t)(1)));
     }
   }
   
-  init_weights();
+  my_distinct_begin.push_back(my_distinct.size());
 }
 
 // - Revise haplotype combination weights to reflect new haplotype counts. 
@@ -206,35 +444,35 @@ em_phenotype::update_weights(size_t chromosome_count, em_haplotype_map& haplotyp
   {
     double  prior_sum = 0.0;
   
-    size_t  comb_count = my_combinations.size();
+    size_t  comb_count = my_weights.size();
     for(size_t c = 0; c < comb_count; c++)
     {
-      double  prior = calc_prior(my_combinations[c].first, chromosome_count, haplotypes);
-      my_combinations[c].second = prior;
+      double  prior = calc_prior(c, chromosome_count, haplotypes);
+      my_weights[c] = prior;
       prior_sum += prior;  
     }
     
     for(size_t c = 0; c < comb_count; c++)
     {
-      my_combinations[c].second /= prior_sum;
+      my_weights[c] /= prior_sum;
     }
   }
 }
 
 double
-em_phenotype::calc_prior(const combination& comb, size_t chromosome_count,
-                         em_haplotype_map& haplotypes) const
+em_phenotype::calc_prior(size_t c, size_t chromosome_count,
+                         const em_haplotype_map& haplotypes) const
 {
-  double  prior = factorial(comb.size());
+  double  prior = factorial(comb_haplotype_count(c));
   
   // - Iterate over distinct haplotypes in the combination.
   //
-  combination_iterator  iter(comb);
-  for(; ! iter.at_end(); iter++)
+  size_t  d_end = my_distinct_begin[c + 1];
+  for(size_t d = my_distinct_begin[c]; d < d_end; ++d)
   {
-    prior *= pow(haplotypes[(*iter).first].new_freq(chromosome_count),
-                 static_cast<double>((*iter).second)) /
-             factorial((*iter).second);
+    prior *= pow(haplotypes.get_haplotype(my_distinct[d].first).new_freq(chromosome_count),
+                 static_cast<double>(my_distinct[d].second)) /
+             factorial(my_distinct[d].second);
   }
   
   return  prior;
@@ -243,27 +481,27 @@ em_phenotype::calc_prior(const combination& comb, size_t chromosome_count,
 // - Assign weights randomly to haplotype combinations.
 //
 void
-em_phenotype::init_weights()
+em_phenotype::init_weights(const MersenneTwister& random_source)
 {
   if(ambiguous)
   {
     size_t  total_weight = 0;
-    size_t  comb_count = my_combinations.size();
+    size_t  comb_count = my_weights.size();
     for(size_t c = 0; c < comb_count; c++)
     {
-      size_t  weight = rand_src.uniform_integer(100) + 1;  // Don't want weight of 0.
-      my_combinations[c].second = weight;
+      size_t  weight = random_source.uniform_integer(100) + 1;  // Don't want weight of 0.
+      my_weights[c] = weight;
       total_weight += weight;
     }
     
     for(size_t c = 0; c < comb_count; c++)
     {
-      my_combinations[c].second /= total_weight;
+      my_weights[c] /= total_weight;
     }
   }
   else
   {
-    my_combinations[0].second = 1.0;
+    my_weights[0] = 1.0;
   }
 }
 
@@ -271,11 +509,10 @@ const set<comb_prob, greater<comb_prob> >&
 em_phenotype::probabilities(const locus_group& loci, const em_haplotype_map& haplotypes) const
 {
   my_probabilities.clear();
-  vector<pair<combination, double> >::const_iterator  c_iter = my_combinations.begin();
-  vector<pair<combination, double> >::const_iterator  c_end_iter = my_combinations.end();
-  for(; c_iter != c_end_iter; ++c_iter)
+  size_t  comb_count = my_weights.size();
+  for(size_t c = 0; c < comb_count; ++c)
   {
-    my_probabilities.insert(comb_prob(combination_string(c_iter, loci, haplotypes), c_iter->second));
+    my_probabilities.insert(comb_prob(combination_string(c, loci, haplotypes), my_weights[c]));
   } 
 
   return  my_probabilities;
@@ -289,11 +526,10 @@ em_phenotype::comb_strs(const locus_group& loci, const em_haplotype_map& haploty
 {
   if(my_comb_strs.empty())
   {
-    vector<pair<combination, double> >::const_iterator  c_iter = my_combinations.begin();
-    vector<pair<combination, double> >::const_iterator  c_end_iter = my_combinations.end();
-    for(; c_iter != c_end_iter; ++c_iter)
+    size_t  comb_count = my_weights.size();
+    for(size_t c = 0; c < comb_count; ++c)
     {
-      my_comb_strs.push_back(combination_string(c_iter, loci, haplotypes));
+      my_comb_strs.push_back(combination_string(c, loci, haplotypes));
     }  
   }
 
@@ -301,16 +537,14 @@ em_phenotype::comb_strs(const locus_group& loci, const em_haplotype_map& haploty
 }
 
 string
-em_phenotype::combination_string(const vector<pair<combination, double> >::const_iterator& c_iter,
-                                 const locus_group& loci, const em_haplotype_map& haps) const
+em_phenotype::combination_string(size_t c, const locus_group& loci, const em_haplotype_map& haps) const
 {
   multiset<string>  haplotypes;
   
-  vector<size_t>::const_iterator  hs_iter = c_iter->first.begin();
-  vector<size_t>::const_iterator  hs_end_iter = c_iter->first.end();
-  for(; hs_iter != hs_end_iter; ++hs_iter)
+  size_t  hap_count = comb_haplotype_count(c);
+  for(size_t h = 0; h < hap_count; ++h)
   {
-    haplotypes.insert(hap_seq_string(haps.index_to_hap_seq(*hs_iter), loci));
+    haplotypes.insert(hap_seq_string(haps.index_to_hap_seq(comb_haplotype(c, h)), loci));
   }
   
   string  comb_str;
@@ -333,62 +567,18 @@ em_phenotype::dump(ostream& out, const locus_group& loci, const em_haplotype_map
 {
   out << "count  " << my_count << endl;
   out << "haplotype combinations" << endl;
-  vector<pair<combination, double> >::const_iterator  c_iter = my_combinations.begin();
-  vector<pair<combination, double> >::const_iterator  c_end_iter = my_combinations.end();
-  for(; c_iter != c_end_iter; ++c_iter)
+  size_t  comb_count = my_weights.size();
+  for(size_t c = 0; c < comb_count; ++c)
   {
-    vector<size_t>::const_iterator  hs_iter = c_iter->first.begin();
-    vector<size_t>::const_iterator  hs_end_iter = c_iter->first.end();
-    for(; hs_iter != hs_end_iter; ++hs_iter)
+    size_t  hap_count = comb_haplotype_count(c);
+    for(size_t h = 0; h < hap_count; ++h)
     {
-      write_hap_seq(out, haplotypes.index_to_hap_seq(*hs_iter), loci);
+      write_hap_seq(out, haplotypes.index_to_hap_seq(comb_haplotype(c, h)), loci);
       out << endl;
     }
     
-    out << "weight " << c_iter->second << "\n" << endl;
-  }
-}
-
-//============================================================================
-// IMPLEMENTATION:  em_phenotype::combination_iterator
-//============================================================================
-//
-em_phenotype::combination_iterator::combination_iterator(const combination& comb)
-{     
-  vector<size_t>::const_iterator  iter = comb.begin();
-  vector<size_t>::const_iterator  end_iter = comb.end();
-  for(; iter != end_iter; ++iter)
-  {
-    if(previously_found(iter))
-    {
-      my_distinct_haplotypes[*iter]++;
-    }
-    else
-    {
-      my_distinct_haplotypes[*iter] = 1;
-    }
+    out << "weight " << my_weights[c] << "\n" << endl;
   }
-  
-  my_internal_iterator = my_distinct_haplotypes.begin();
-}
-
-bool
-em_phenotype::combination_iterator::previously_found(vector<size_t>::const_iterator iter) const
-{
-  bool  found = false;
-  
-  map<size_t, size_t>::const_iterator  h_iter = my_distinct_haplotypes.begin();
-  map<size_t, size_t>::const_iterator  h_end_iter = my_distinct_haplotypes.end();
-  for(; h_iter != h_end_iter; h_iter++)
-  {
-    if(*iter == h_iter->first)
-    {
-      found = true;
-      break;
-    }
-  }
-  
-  return  found;
 }
 
 //============================================================================
@@ -485,8 +675,7 @@ base_em_phenotype_map::final_frequencies() const
 
   if(my_final_frequencies.empty())
   {
-    const map<size_t, em_haplotype>& haps = my_best_haplotypes.haplotypes();
-    set_frequencies(my_final_frequencies, haps);
+    set_frequencies(my_final_frequencies, my_best_haplotypes);
   }
 
   return  my_final_frequencies;
@@ -496,22 +685,20 @@ const set<hap_freq, greater<hap_freq> >&
 base_em_phenotype_map::current_frequencies() const
 {
   my_current_frequencies.clear();
-  const map<size_t, em_haplotype>& haps = my_haplotypes.haplotypes();
-  set_frequencies(my_current_frequencies, haps);
+  set_frequencies(my_current_frequencies, my_haplotypes);
 
   return  my_current_frequencies;
 }
 
 void
 base_em_phenotype_map::set_frequencies(set<hap_freq, greater<hap_freq> >& frequencies,
-                                       const map<size_t, em_haplotype>& haps          ) const
+                                       const em_haplotype_map& haps                   ) const
 {
-  map<size_t, em_haplotype>::const_iterator  iter = haps.begin();
-  map<size_t, em_haplotype>::const_iterator  end_iter = haps.end();
-  for(; iter != end_iter; ++iter)
+  size_t  hap_count = haps.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    string  haplotype = hap_seq_string(iter->second.sequence(), my_loci);
-    double  frequency = iter->second.new_freq(my_total_hap_count);
+    string  haplotype = hap_seq_string(haps.index_to_hap_seq(index), my_loci);
+    double  frequency = haps.get_haplotype(index).new_freq(my_total_hap_count);
     frequencies.insert(hap_freq(haplotype, frequency));
   } 
 }
@@ -527,11 +714,10 @@ base_em_phenotype_map::ln_likelihood()
   for(; p_iter != p_end_iter; ++p_iter)
   {
     log_double  sum(0);
-    vector<pair<em_phenotype::combination, double> >::const_iterator  c_iter = p_iter->combinations().begin();
-    vector<pair<em_phenotype::combination, double> >::const_iterator  c_end_iter = p_iter->combinations().end();
-    for(; c_iter != c_end_iter; c_iter++)
+    size_t  comb_count = p_iter->comb_count();
+    for(size_t c = 0; c < comb_count; c++)
     {
-      sum += log_double(p_iter->calc_prior(c_iter->first, my_total_hap_count, my_haplotypes));
+      sum += log_double(p_iter->calc_prior(c, my_total_hap_count, my_haplotypes));
     }
     
     like *= sum.pow(static_cast<double>(p_iter->count()));
@@ -92,7 +92,8 @@ operator <<(ostream& out, const instructions& instr)
       << "Minimum permutations:             " << instr.min_permutations              << "\n"      
       << "Maximum permutations:             " << instr.max_permutations              << "\n"
       << "Width:                            " << instr.width                         << "\n"
-      << "Confidence:                       " << instr.confidence                    << endl;
+      << "Confidence:                       " << instr.confidence                    << "\n"
+      << "Threads:                          " << instr.threads                       << endl;
       
   vector<instructions::pool_locus>::const_iterator  pl_iter     = instr.pool_loci.begin();
   vector<instructions::pool_locus>::const_iterator  pl_end_iter = instr.pool_loci.end();
@@ -103,6 +103,10 @@ parser::parse_test_parameter_section(const LSFBase* params)
       {
         parse_seed(*iter);
       }
+      else if(parameter == "THREADS")
+      {
+        parse_threads(*iter);
+      }
       else if(parameter == "FILTERS")
       {
         parse_filters(*iter);
@@ -839,6 +843,25 @@ parser::parse_seed(const LSFBase* param)
   }
 }
 
+// - Number of permutations evaluated at once.  0 uses the program default
+//   (see the --threads command line option).
+//
+void
+parser::parse_threads(const LSFBase* param)
+{
+  int  temp_threads = 0;
+  parse_integer(param, temp_threads, "THREADS");
+  if(temp_threads >= 0)
+  {
+    my_instructions.threads = temp_threads;
+  }
+  else
+  {
+    errors << priority(error) << "Invalid value given for threads.  "
+           << "Using the program default." << endl;
+  }
+}
+
 
 
 void
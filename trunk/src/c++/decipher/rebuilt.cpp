@@ -27,9 +27,12 @@ namespace DECIPHER
 //
 rebuilt_em_phenotype_map::rebuilt_em_phenotype_map(output_state& ostate, APP::Output_Streams& streams, const locus_group& loci,
                                                    const vector<member>& members,  
-                                                   const vector<const member_em_phenotype_map*>& phenotype_maps)
+                                                   const vector<const member_em_phenotype_map*>& phenotype_maps,
+                                                   const MersenneTwister& random_source)
       : base_em_phenotype_map(ostate, streams, loci)
 {
+  my_random_source = &random_source;
+
   // - Members in each subpopulation.
   //
   vector<set<member, member_order<member> > >  map_members;
@@ -51,24 +54,24 @@ rebuilt_em_phenotype_map::rebuilt_em_phenotype_map(output_state& ostate, APP::Ou
     pair<const em_phenotype*, const em_haplotype_map*>  phenotype_and_map = 
                                   get_phenotype(members[m], map_members, phenotype_maps);
     set<hap_seq_comb>  hs_combs;
-    const vector<pair<em_phenotype::combination, double> >&  emp_combs = phenotype_and_map.first->combinations();
-    size_t  comb_count = emp_combs.size();
+    const em_phenotype&  emp = *phenotype_and_map.first;
+    size_t  comb_count = emp.comb_count();
     size_t  hap_count = 0;
     for(size_t c = 0; c < comb_count; ++c)
     {
       hap_seq_comb  hs_comb;
       
-      hap_count = emp_combs[c].first.size();
+      hap_count = emp.comb_haplotype_count(c);
       for(size_t h = 0; h < hap_count; ++h)
       {
-        hs_comb.insert(phenotype_and_map.second->index_to_hap_seq(emp_combs[c].first[h]));
+        hs_comb.insert(phenotype_and_map.second->index_to_hap_seq(emp.comb_haplotype(c, h)));
       }
  
       hs_combs.insert(hs_comb);
     }
     
     my_total_hap_count += hap_count;
-    my_phenotypes.push_back(em_phenotype(&my_haplotypes, hs_combs));
+    my_phenotypes.push_back(em_phenotype(&my_haplotypes, hs_combs, random_source));
   }
   
   my_haplotypes.update_counts(*this);
@@ -79,6 +79,50 @@ sub_pop_shuffler::do_shuffle(int seed)
   return true;
 }
 
+// - Draws from a random source held by reference, so that each replicate
+//   of a permutation test can use its own.
+//
+struct stream_randomizer
+{
+  stream_randomizer(const MersenneTwister& random_source)
+        : mt(random_source)
+  {}
+
+  unsigned int operator()(unsigned int N)
+  {
+    unsigned int  r = static_cast<unsigned int>(mt.uniform_real() * N);
+
+    // uniform_real() may return 1.
+    return  r < N ? r : N - 1;
+  }
+
+  const MersenneTwister&  mt;
+};
+
+bool
+sub_pop_shuffler::shuffle(const MersenneTwister& random_source, sub_pops& new_sub_pops) const
+{
+  if( !my_valid_data )
+    return false;
+
+  vector<member>  whole_pop(my_whole_pop);
+
+  stream_randomizer  randomizer(random_source);
+
+  do_random_shuffle(whole_pop.begin(), whole_pop.end(), randomizer);
+
+  new_sub_pops.resize(my_new_sub_pops.size());
+
+  vector<member>::const_iterator  next = whole_pop.begin();
+  for( size_t i = 0; i < my_new_sub_pops.size(); ++i )
+  {
+    new_sub_pops[i].assign(next, next + my_new_sub_pops[i].size());
+    next += my_new_sub_pops[i].size();
+  }
+
+  return true;
+}
+
 void
 sub_pop_shuffler::dump(ostream& out) const
 {
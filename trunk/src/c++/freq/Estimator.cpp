@@ -1,3 +1,4 @@
+#include <sstream>
 #include "freq/Estimator.h"
 
 namespace SAGE {
@@ -21,72 +22,232 @@ Estimator::runAnalysis(const Configuration & config, const FPED::FilteredMultipe
   results.analyses .  clear();
   results.analyses .  reserve(results.config.getMarkers().size());
 
-  // Loop across markers for analysis:
-  size_t m_count = 1;
-  
-  for(Configuration::MarkerVector::const_iterator marker_id = results.config.getMarkers().begin(); marker_id != results.config.getMarkers().end(); ++marker_id, ++m_count)
+  // Analyze the markers:
+  size_t marker_count = results.config.getMarkers().size();
+  size_t thread_count = results.config.thread_count ? results.config.thread_count : UTIL::ThreadPool::default_thread_count();
+
+  // MAXFUN debugging output is written as it is generated, so can't be held back.
+  if(results.config.maxfun_debug)
+    thread_count = 1;
+
+  thread_count = std::min(thread_count, marker_count);
+
+  std::vector<MarkerRun> runs(marker_count);
+
+  if(thread_count > 1)
+  {
+    analyzeMarkersConcurrently(results.config, mp, thread_count, runs, errors);
+  }
+  else
   {
-    // Set up marker analysis:
-    MarkerAnalysis marker_analysis;
+    for(size_t m = 0; m < marker_count; ++m)
+    {
+      analyzeMarker(results.config, mp, m, runs[m], std::cout);
+
+      reportMarker(runs[m], errors);
+    }
+  }
+
+  // Collect the results in marker order:
+  for(size_t m = 0; m < marker_count; ++m)
+    if(runs[m].analyzed)
+      results.analyses.push_back(runs[m].analysis);
+  
+  // Return results of analysis:
+  return results;
+}
+
+//============================================
+//
+//  analyzeMarker(...)
+//
+//============================================
+void
+Estimator::analyzeMarker(
+  const Configuration                 & config,
+  const FPED::FilteredMultipedigree   & mp,
+        size_t                          marker_num,
+        MarkerRun                     & run,
+        std::ostream                  & out)
+{
+  size_t marker_id = config.getMarkers()[marker_num];
+
+  // Set up marker analysis:
+  MarkerAnalysis & marker_analysis = run.analysis;
     
-    marker_analysis.marker_id = *marker_id;
+  marker_analysis.marker_id = marker_id;
     
-    // Runtime output:
-    std::cout << "  marker " << mp.info().marker_info(*marker_id).name() << " (" << m_count << " of " << results.config.getMarkers().size() << ")..." << std::endl;
+  // Runtime output:
+  out << "  marker " << mp.info().marker_info(marker_id).name() << " (" << marker_num + 1 << " of " << config.getMarkers().size() << ")..." << std::endl;
+
+  // Make sure there's at least 2 alleles in the model:
+  if(mp.info().marker_info(marker_id).gmodel().allele_count() < 2)
+  {
+    out << "    There is insufficient data present at this marker for analysis. Skpping this marker..." << std::endl;
+
+    return;
+  }
+
+  // Construct sample on current marker:
+  Sample sample(mp, marker_id);
+
+  if(!sample.getValidSpedInfos().size() && !sample.getUnconnecteds().size())
+  {
+    // Problem reported by reportMarker():
+    run.invalid_sample = true;
+
+    return;
+  }
 
-    // Make sure there's at least 2 alleles in the model:
-    if(mp.info().marker_info(*marker_id).gmodel().allele_count() < 2)
+  // Calculate allele frequencies:
+  if(sample.getMarkerInfo().codominant())
+  {
+    out << "    Calculating allele frequencies..." << std::endl;
+        
+    marker_analysis.allele_freqs = calculateAlleleFrequencies(config, sample);
+  }
+  else // We've got to set them to something!
+  {
+    size_t allele_count = sample.getMarkerInfo().gmodel().allele_count();
+        
+    marker_analysis.allele_freqs.founder_freqs . resize(allele_count, 0.0);
+    marker_analysis.allele_freqs.all_freqs     . resize(allele_count, 0.0);
+  }
+      
+  if(!config.skip_mle)
+  {
+    out << "    Maximizing likelihood..." << std::endl;
+        
+    estimateLikelihood(config, sample, marker_analysis, out);
+  }
+
+  run.analyzed = true;
+}
+
+//============================================
+//
+//  reportMarker(...)
+//
+//============================================
+void
+Estimator::reportMarker(const MarkerRun & run, cerrorstream & errors)
+{
+  if(run.invalid_sample)
+  {
+    errors << priority(error)
+           << "Unable to construct a valid sample for this analysis."
+           << " This may be due to mendelian inconsistencies and/or uninformative phenotypes for"
+           << " the pedigree data. Skipping this marker..."
+           << std::endl;
+  }
+}
+
+//============================================
+//
+//  MarkerScheduler
+//
+//============================================
+//
+// Analyzes one marker per item.  As each marker completes, the runtime
+// output and errors of every completed marker not preceded by an incomplete
+// one are written, so output appears in marker order while analysis runs.
+class Estimator::MarkerScheduler : public UTIL::ParallelTask
+{
+  public:
+
+    MarkerScheduler(const Configuration               & config,
+                    const FPED::FilteredMultipedigree & mp,
+                    std::vector<MarkerRun>            & runs,
+                    cerrorstream                      & errors)
+      : my_config(config), my_mp(mp), my_runs(runs), my_errors(errors), my_next_report(0)
     {
-      std::cout << "    There is insufficient data present at this marker for analysis. Skpping this marker..." << std::endl;
+      pthread_mutex_init(&my_mutex, NULL);
     }
-    else
+
+    ~MarkerScheduler()
     {
-      // Construct sample on current marker:
-      Sample sample(mp, *marker_id);
+      pthread_mutex_destroy(&my_mutex);
+    }
+
+    virtual void run(size_t item, size_t)
+    {
+      std::ostringstream out;
+
+      analyzeMarker(my_config, my_mp, item, my_runs[item], out);
+
+      pthread_mutex_lock(&my_mutex);
+
+      my_runs[item].log       = out.str();
+      my_runs[item].completed = true;
+
+      report();
 
-      if(!sample.getValidSpedInfos().size() && !sample.getUnconnecteds().size())
+      pthread_mutex_unlock(&my_mutex);
+    }
+
+    /// Writes the output of the completed markers not preceded by an
+    /// incomplete one.  Returns the number of markers written.
+    size_t report()
+    {
+      for( ; my_next_report < my_runs.size() && my_runs[my_next_report].completed; ++my_next_report)
       {
-        // Report problem:
-        errors << priority(error)
-               << "Unable to construct a valid sample for this analysis."
-               << " This may be due to mendelian inconsistencies and/or uninformative phenotypes for"
-               << " the pedigree data. Skipping this marker..."
-               << std::endl;
+        std::cout << my_runs[my_next_report].log << std::flush;
+
+        reportMarker(my_runs[my_next_report], my_errors);
+
+        my_runs[my_next_report].log.erase();
       }
-      else
-      {
-        // Calculate allele frequencies:
-        if(sample.getMarkerInfo().codominant())
-        {
-          std::cout << "    Calculating allele frequencies..." << std::endl;
-        
-          marker_analysis.allele_freqs = calculateAlleleFrequencies(results.config, sample);
-        }
-        else // We've got to set them to something!
-        {
-          size_t allele_count = sample.getMarkerInfo().gmodel().allele_count();
-        
-          marker_analysis.allele_freqs.founder_freqs . resize(allele_count, 0.0);
-          marker_analysis.allele_freqs.all_freqs     . resize(allele_count, 0.0);
-        }
-      
-        if(!results.config.skip_mle)
-        {
-          std::cout << "    Maximizing likelihood..." << std::endl;
-        
-          estimateLikelihood(results.config, sample, marker_analysis);
-        }
 
-        results.analyses.push_back(marker_analysis);
+      return my_next_report;
+    }
 
-      } // End if-sample-is-valid
+  private:
 
-    } // End if-there's-at-least-2-alleles
+    const Configuration               & my_config;
+    const FPED::FilteredMultipedigree & my_mp;
+    std::vector<MarkerRun>            & my_runs;
+    cerrorstream                      & my_errors;
 
-  } // End of marker loop
-  
-  // Return results of analysis:
-  return results;
+    size_t          my_next_report;
+    pthread_mutex_t my_mutex;
+};
+
+//============================================
+//
+//  analyzeMarkersConcurrently(...)
+//
+//============================================
+void
+Estimator::analyzeMarkersConcurrently(
+  const Configuration                 & config,
+  const FPED::FilteredMultipedigree   & mp,
+        size_t                          thread_count,
+        std::vector<MarkerRun>        & runs,
+        cerrorstream                  & errors)
+{
+  MarkerScheduler   scheduler(config, mp, runs, errors);
+  UTIL::ThreadPool  pool(thread_count);
+
+  pool.run(runs.size(), scheduler);
+
+  // A marker whose analysis threw is analyzed again here, serially, so that
+  // the exception propagates as it always has, after the output of the
+  // markers before it.
+  for(size_t m = scheduler.report(); m < runs.size(); ++m)
+  {
+    if(runs[m].completed)
+    {
+      std::cout << runs[m].log << std::flush;
+    }
+    else
+    {
+      runs[m] = MarkerRun();
+
+      analyzeMarker(config, mp, m, runs[m], std::cout);
+    }
+
+    reportMarker(runs[m], errors);
+  }
 }
 
 //========================================================
@@ -203,7 +364,7 @@ Estimator::calculateAlleleFrequencies(const Configuration & config, const Sample
 //
 //========================================================
 void
-Estimator::estimateLikelihood(const Configuration & config, const Sample & sample, MarkerAnalysis & analysis)
+Estimator::estimateLikelihood(const Configuration & config, const Sample & sample, MarkerAnalysis & analysis, std::ostream & out)
 {
   // Create ParameterMgr, MaxFunction, LikelihoodCalculator, SequenceCfg, and DebugCfg:
   MAXFUN::ParameterMgr mgr;
@@ -220,7 +381,7 @@ Estimator::estimateLikelihood(const Configuration & config, const Sample & sampl
   
   // Runtime output:
   if(config.estimate_inbreeding)
-    std::cout << "      Without inbreeding..." << std::endl;
+    out << "      Without inbreeding..." << std::endl;
 
   // Maximize the function and store the results:
   runMaximize(func, seq, dbg, analysis.maxfun_results);
@@ -240,7 +401,7 @@ Estimator::estimateLikelihood(const Configuration & config, const Sample & sampl
     setupComponents(config, sample, analysis.allele_freqs, mgr2, func2, lh_calc2);
   
     // Runtime output:
-    std::cout << "      With inbreeding..." << std::endl;
+    out << "      With inbreeding..." << std::endl;
     
     // Maximize and store results:
     runMaximize(func2, seq, dbg, analysis.maxfun_results_inbreeding);
@@ -106,6 +106,22 @@ Parser::parseFreqBlock(size_t analysis_num, const LSFBase * param_block, const F
     {
       config.maxfun_debug = true;
     }
+    else if(name == "THREADS")
+    {
+      int threads = 0;
+
+      if(APP::ParsingFunctions::parse_integer(*param, threads) == APP::LSFConvert::GOOD)
+      {
+        if(threads >= 0)
+        {
+          config.thread_count = threads;
+        }
+        else
+        {
+          errors << priority(error) << "Invalid value '" << threads << "' for parameter 'threads'.  Using the program default." << endl;
+        }
+      }
+    }
   }
   
   // If no markers were specified, add ALL of them to the list!
@@ -1,4 +1,6 @@
 #include "func/Function.h"
+#include <cstdio>
+#include <cstdlib>
 #include <sstream>
 
 namespace SAGE {
@@ -116,7 +118,85 @@ Function::create(RPED::RefMultiPedigree & mp, const FunctionParser::TraitData &
   for(RPED::PedigreeIterator p_iter = mp.pedigree_begin(); p_iter != mp.pedigree_end(); ++p_iter)
     p_iter->info().resize_traits(p_iter->info().trait_count() + 1);
     
-  // Calculate and set values for the new trait:
+  // Calculate and set values for the new trait.  Expressions which can be
+  // compiled natively are evaluated without Python.
+
+  NativeExpression native;
+
+  if(native.compile(par_data.expr, my_traits_used, python_only_names(par_data)))
+    evaluate_native(mp, par_data, native, trait_num);
+  else
+    evaluate_python(mp, par_data, calculator, trait_num);
+}
+
+//============================================================================
+//
+//  evaluate_native(...)
+//
+//============================================================================
+void
+Function::evaluate_native(
+  RPED::RefMultiPedigree            & mp,
+  const FunctionParser::TraitData   & par_data,
+  const NativeExpression            & native,
+  size_t                              trait_num)
+{
+  const std::vector<size_t> & traits = native.variable_traits();
+
+  std::vector<double> values(traits.size() + 1);
+
+  RPED::RefTraitInfo & trait_info = mp.info().trait_info(trait_num);
+
+  bool runtime_error_written = false;
+
+  // Trait values are stored by pedigree, so the expression is run down the
+  // columns of each pedigree in turn.
+
+  for(RPED::PedigreeIterator p_iter = mp.pedigree_begin(); p_iter != mp.pedigree_end(); ++p_iter)
+  {
+    RPED::RefPedInfo & info = p_iter->info();
+
+    for(size_t i = 0; i < info.member_count(); ++i)
+    {
+      double trait_value = numeric_limits<double>::quiet_NaN();
+      bool   complete    = true;
+
+      for(size_t v = 0; complete && v < traits.size(); ++v)
+      {
+        values[v] = info.trait(i, traits[v]);
+        complete  = !SAGE::isnan(values[v]);
+      }
+
+      if(complete)
+      {
+        trait_value = native.evaluate(&values[0]);
+
+        if(SAGE::isnan(trait_value) && (!runtime_error_written))
+        {
+          write_runtime_error_msg(par_data.expr);
+
+          runtime_error_written = true;
+        }
+      }
+
+      info.set_trait(i, trait_num, stored_value(trait_value), trait_info);
+    }
+  }
+}
+
+//============================================================================
+//
+//  evaluate_python(...)
+//
+//============================================================================
+void
+Function::evaluate_python(
+  RPED::RefMultiPedigree            & mp,
+  const FunctionParser::TraitData   & par_data,
+  PythonInterface                   & calculator,
+  size_t                              trait_num)
+{
+  RPED::RefTraitInfo & trait_info = mp.info().trait_info(trait_num);
 
   bool runtime_error_written = false;
 
@@ -131,23 +211,61 @@ Function::create(RPED::RefMultiPedigree & mp, const FunctionParser::TraitData &
 
       if(SAGE::isnan(trait_value) && (!runtime_error_written))
       {
-        my_errors << priority(error) 
-                  << "Could not evaluate function block expression '" << par_data.expr 
-                  << "' for one or more individuals.  Missing value(s) generated." << endl;
+        write_runtime_error_msg(par_data.expr);
 
         runtime_error_written = true;
       }
     }
     
     // Set the trait value:
-    member.pedigree()->info().set_trait(
-      member.index(), 
-      trait_num, 
-      SAGE::isnan(trait_value) ? mp.info().trait_info(trait_num).string_missing_code() : doub2str(trait_value), 
-      mp.info().trait_info(trait_num));
+    member.pedigree()->info().set_trait(member.index(), trait_num, stored_value(trait_value), trait_info);
   }
 }
 
+//============================================================================
+//
+//  python_only_names(...)
+//
+//============================================================================
+NativeExpression::name_set
+Function::python_only_names(const FunctionParser::TraitData & par_data) const
+{
+  NativeExpression::name_set names;
+
+  for(FunctionParser::TraitData::constant_vector::const_iterator iter = par_data.constants.begin(); iter != par_data.constants.end(); ++iter)
+    names.insert(iter->first);
+
+  for(input_variable_map::const_iterator iter = my_strings_used.begin(); iter != my_strings_used.end(); ++iter)
+    names.insert(iter->first);
+
+  for(input_variable_map::const_iterator iter = my_markers_used.begin(); iter != my_markers_used.end(); ++iter)
+    names.insert(iter->first);
+
+  return names;
+}
+
+//============================================================================
+//
+//  stored_value(...)
+//
+//============================================================================
+double
+Function::stored_value(double value)
+{
+  // Trait values were always stored as formatted by doub2str(), to six
+  // significant digits.  They still are, so that a trait's values do not
+  // depend on how they were computed.
+
+  if(!finite(value))
+    return value;
+
+  char buffer[32];
+
+  sprintf(buffer, "%g", value);
+
+  return strtod(buffer, NULL);
+}
+
 //============================================================================
 //
 //  find_variables_used(...)
@@ -442,6 +560,14 @@ Function::write_error_msg(Function::error_msg msg, const string& name, const str
   }
 }
 
+void
+Function::write_runtime_error_msg(const string& expr)
+{
+  my_errors << priority(error) 
+            << "Could not evaluate function block expression '" << expr 
+            << "' for one or more individuals.  Missing value(s) generated." << endl;
+}
+
 void
 Function::write_error_msg(const string& message)
 {
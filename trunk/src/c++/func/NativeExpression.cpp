@@ -0,0 +1,1149 @@
+#include <cmath>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <limits>
+#include "func/NativeExpression.h"
+
+namespace SAGE {
+namespace FUNC {
+
+namespace {
+
+// Python 1.5 reserved words.  Of these, only 'and', 'or' and 'not' are
+// compiled.
+const char * const keywords[] =
+{
+  "access", "break", "class", "continue", "def", "del", "elif", "else",
+  "except", "exec", "finally", "for", "from", "global", "if", "import", "in",
+  "is", "lambda", "pass", "print", "raise", "return", "try", "while", 0
+};
+
+bool is_keyword(const std::string & name)
+{
+  for(size_t k = 0; keywords[k]; ++k)
+    if(name == keywords[k])
+      return true;
+
+  return false;
+}
+
+}
+
+//============================================================================
+//
+//  NativeExpression::parser
+//
+//============================================================================
+//
+// Recursive descent parser for the compiled subset of the Python 1.5
+// expression grammar, emitting code as the Python compiler does:
+//
+//   test:       and_test ('or' and_test)*
+//   and_test:   not_test ('and' not_test)*
+//   not_test:   'not' not_test | comparison
+//   comparison: arith (comp_op arith)*
+//   arith:      term (('+'|'-') term)*
+//   term:       factor (('*'|'/'|'%') factor)*
+//   factor:     ('+'|'-') factor | power
+//   power:      atom ['**' factor]
+//   atom:       '(' test ')' | NUMBER | NAME | NAME '(' [test (',' test)* [',']] ')'
+//
+// Any other construct fails the parse.
+class NativeExpression::parser
+{
+  public:
+
+    parser(NativeExpression   & target,
+           const std::string  & expr,
+           const variable_map & variables,
+           const name_set     & hidden)
+      : my_target(target), my_expr(expr), my_variables(variables), my_hidden(hidden), my_pos(0)
+    { }
+
+    bool parse()
+    {
+      next();
+
+      return test() && my_token == T_END;
+    }
+
+  private:
+
+    enum token_type { T_END, T_NUMBER, T_NAME, T_OP, T_ERROR };
+
+    void next();
+
+    bool accept(const char * op)
+    {
+      if(my_token != T_OP || my_text != op)
+        return false;
+
+      next();
+
+      return true;
+    }
+
+    bool accept_name(const char * name)
+    {
+      if(my_token != T_NAME || my_text != name)
+        return false;
+
+      next();
+
+      return true;
+    }
+
+    size_t emit(op_code code, size_t arg = 0, size_t count = 0)
+    {
+      instruction i = { code, arg, count };
+
+      my_target.my_program.push_back(i);
+
+      return my_target.my_program.size() - 1;
+    }
+
+    void patch(size_t jump)
+    {
+      my_target.my_program[jump].arg = my_target.my_program.size();
+    }
+
+    size_t add_constant(const value & v)
+    {
+      my_target.my_constants.push_back(v);
+
+      return my_target.my_constants.size() - 1;
+    }
+
+    bool test();
+    bool and_test();
+    bool not_test();
+    bool comparison();
+    bool arith();
+    bool term();
+    bool factor();
+    bool power();
+    bool atom();
+    bool name(const std::string & n);
+    bool call(const std::string & n);
+
+    NativeExpression   & my_target;
+    const std::string  & my_expr;
+    const variable_map & my_variables;
+    const name_set     & my_hidden;
+
+    size_t       my_pos;
+    token_type   my_token;
+    std::string  my_text;
+    value        my_number;
+
+    std::map<std::string, size_t> my_slots;
+};
+
+void
+NativeExpression::parser::next()
+{
+  while(my_pos < my_expr.size() && std::strchr(" \t\n\r\f", my_expr[my_pos]))
+    ++my_pos;
+
+  my_text.erase();
+
+  if(my_pos == my_expr.size())
+  {
+    my_token = T_END;
+    return;
+  }
+
+  size_t start = my_pos;
+  char   c     = my_expr[my_pos];
+
+  if(isdigit(c) || (c == '.' && my_pos + 1 < my_expr.size() && isdigit(my_expr[my_pos + 1])))
+  {
+    bool is_float = false;
+
+    while(my_pos < my_expr.size() && isdigit(my_expr[my_pos]))
+      ++my_pos;
+
+    if(my_pos < my_expr.size() && my_expr[my_pos] == '.')
+    {
+      is_float = true;
+
+      for(++my_pos; my_pos < my_expr.size() && isdigit(my_expr[my_pos]); ++my_pos) ;
+    }
+
+    if(my_pos < my_expr.size() && (my_expr[my_pos] == 'e' || my_expr[my_pos] == 'E'))
+    {
+      is_float = true;
+
+      ++my_pos;
+
+      if(my_pos < my_expr.size() && (my_expr[my_pos] == '+' || my_expr[my_pos] == '-'))
+        ++my_pos;
+
+      if(my_pos == my_expr.size() || !isdigit(my_expr[my_pos]))
+      {
+        my_token = T_ERROR;
+        return;
+      }
+
+      while(my_pos < my_expr.size() && isdigit(my_expr[my_pos]))
+        ++my_pos;
+    }
+
+    my_text = my_expr.substr(start, my_pos - start);
+
+    // Long and complex literals, and hex and octal ints, are left to Python.
+
+    if(   (my_pos < my_expr.size() && (isalnum(my_expr[my_pos]) || my_expr[my_pos] == '_'))
+       || (!is_float && my_text.size() > 1 && my_text[0] == '0'))
+    {
+      my_token = T_ERROR;
+      return;
+    }
+
+    my_token         = T_NUMBER;
+    my_number.is_int = !is_float;
+    my_number.i      = 0;
+    my_number.f      = 0.0;
+
+    if(is_float)
+    {
+      my_number.f = std::strtod(my_text.c_str(), 0);
+    }
+    else
+    {
+      errno       = 0;
+      my_number.i = std::strtol(my_text.c_str(), 0, 10);
+
+      if(errno)
+        my_token = T_ERROR;   // Too large for an int
+    }
+
+    return;
+  }
+
+  if(isalpha(c) || c == '_')
+  {
+    while(my_pos < my_expr.size() && (isalnum(my_expr[my_pos]) || my_expr[my_pos] == '_'))
+      ++my_pos;
+
+    my_text  = my_expr.substr(start, my_pos - start);
+    my_token = T_NAME;
+
+    return;
+  }
+
+  const char * const two_char_ops[] = { "**", "<=", ">=", "==", "!=", "<>", 0 };
+
+  for(size_t k = 0; two_char_ops[k]; ++k)
+  {
+    if(my_expr.compare(my_pos, 2, two_char_ops[k]) == 0)
+    {
+      my_pos   += 2;
+      my_text   = two_char_ops[k];
+      my_token  = T_OP;
+
+      return;
+    }
+  }
+
+  if(std::strchr("+-*/%<>(),", c))
+  {
+    ++my_pos;
+
+    my_text  = std::string(1, c);
+    my_token = T_OP;
+
+    return;
+  }
+
+  my_token = T_ERROR;
+}
+
+bool
+NativeExpression::parser::test()
+{
+  if(!and_test())
+    return false;
+
+  std::vector<size_t> jumps;
+
+  while(accept_name("or"))
+  {
+    jumps.push_back(emit(JUMP_IF_TRUE));
+    emit(POP);
+
+    if(!and_test())
+      return false;
+  }
+
+  for(size_t j = 0; j < jumps.size(); ++j)
+    patch(jumps[j]);
+
+  return true;
+}
+
+bool
+NativeExpression::parser::and_test()
+{
+  if(!not_test())
+    return false;
+
+  std::vector<size_t> jumps;
+
+  while(accept_name("and"))
+  {
+    jumps.push_back(emit(JUMP_IF_FALSE));
+    emit(POP);
+
+    if(!not_test())
+      return false;
+  }
+
+  for(size_t j = 0; j < jumps.size(); ++j)
+    patch(jumps[j]);
+
+  return true;
+}
+
+bool
+NativeExpression::parser::not_test()
+{
+  if(accept_name("not"))
+  {
+    if(!not_test())
+      return false;
+
+    emit(NOT);
+
+    return true;
+  }
+
+  return comparison();
+}
+
+bool
+NativeExpression::parser::comparison()
+{
+  if(!arith())
+    return false;
+
+  // A chained comparison, a < b < c, is a < b and b < c with b evaluated
+  // once; each operand but the last is kept under the result of its
+  // comparison in case the chain continues.
+
+  std::vector<size_t> cleanups;
+
+  while(my_token == T_OP)
+  {
+    compare_op op;
+
+         if(my_text == "<")                     op = LT;
+    else if(my_text == "<=")                    op = LE;
+    else if(my_text == "==")                    op = EQ;
+    else if(my_text == "!=" || my_text == "<>") op = NE;
+    else if(my_text == ">")                     op = GT;
+    else if(my_text == ">=")                    op = GE;
+    else break;
+
+    next();
+
+    if(!arith())
+      return false;
+
+    bool chained = my_token == T_OP && (   my_text == "<"  || my_text == "<=" || my_text == "=="
+                                        || my_text == "!=" || my_text == "<>" || my_text == ">"
+                                        || my_text == ">=");
+
+    if(chained)
+    {
+      emit(DUP);
+      emit(ROT_THREE);
+      emit(COMPARE, op);
+      cleanups.push_back(emit(JUMP_IF_FALSE));
+      emit(POP);
+    }
+    else
+    {
+      emit(COMPARE, op);
+    }
+  }
+
+  if(cleanups.size())
+  {
+    size_t end = emit(JUMP);
+
+    for(size_t j = 0; j < cleanups.size(); ++j)
+      patch(cleanups[j]);
+
+    emit(ROT_TWO);
+    emit(POP);
+
+    patch(end);
+  }
+
+  return true;
+}
+
+bool
+NativeExpression::parser::arith()
+{
+  if(!term())
+    return false;
+
+  while(true)
+  {
+    op_code code;
+
+         if(accept("+")) code = ADD;
+    else if(accept("-")) code = SUBTRACT;
+    else return true;
+
+    if(!term())
+      return false;
+
+    emit(code);
+  }
+}
+
+bool
+NativeExpression::parser::term()
+{
+  if(!factor())
+    return false;
+
+  while(true)
+  {
+    op_code code;
+
+         if(accept("*")) code = MULTIPLY;
+    else if(accept("/")) code = DIVIDE;
+    else if(accept("%")) code = MODULO;
+    else return true;
+
+    if(!factor())
+      return false;
+
+    emit(code);
+  }
+}
+
+bool
+NativeExpression::parser::factor()
+{
+  if(accept("+"))
+    return factor();
+
+  if(accept("-"))
+  {
+    if(!factor())
+      return false;
+
+    emit(NEGATE);
+
+    return true;
+  }
+
+  return power();
+}
+
+bool
+NativeExpression::parser::power()
+{
+  if(!atom())
+    return false;
+
+  if(accept("**"))
+  {
+    if(!factor())
+      return false;
+
+    emit(POWER);
+  }
+
+  return true;
+}
+
+bool
+NativeExpression::parser::atom()
+{
+  bool ok = false;
+
+  if(accept("("))
+  {
+    ok = test() && accept(")");
+  }
+  else if(my_token == T_NUMBER)
+  {
+    emit(PUSH_CONST, add_constant(my_number));
+    next();
+
+    ok = true;
+  }
+  else if(my_token == T_NAME)
+  {
+    std::string n = my_text;
+
+    next();
+
+    ok = (my_token == T_OP && my_text == "(") ? call(n) : name(n);
+  }
+
+  // Subscripts, attributes and calls of anything but a function name fail
+  // in the tokenizer or here.
+
+  return ok && !(my_token == T_OP && my_text == "(");
+}
+
+bool
+NativeExpression::parser::name(const std::string & n)
+{
+  if(is_keyword(n) || n == "and" || n == "or" || n == "not" || my_hidden.count(n))
+    return false;
+
+  variable_map::const_iterator v = my_variables.find(n);
+
+  if(v != my_variables.end())
+  {
+    std::map<std::string, size_t>::const_iterator s = my_slots.find(n);
+
+    if(s == my_slots.end())
+    {
+      s = my_slots.insert(std::make_pair(n, my_target.my_variable_traits.size())).first;
+
+      my_target.my_variable_traits.push_back(v->second);
+    }
+
+    emit(LOAD_VAR, s->second);
+
+    return true;
+  }
+
+  // The math module's constants.
+
+  value c = { false, 0, 0.0 };
+
+       if(n == "pi") c.f = M_PI;
+  else if(n == "e")  c.f = M_E;
+  else return false;
+
+  emit(PUSH_CONST, add_constant(c));
+
+  return true;
+}
+
+bool
+NativeExpression::parser::call(const std::string & n)
+{
+  // Functions are those of the math module, which shadow the builtins of
+  // the same name (pow), and then the builtins the environment allows.
+
+  struct function_name
+  {
+    const char * name;
+    function_id  id;
+    size_t       min_args;
+    size_t       max_args;
+  };
+
+  static const function_name functions[] =
+  {
+    { "acos",  F_ACOS,  1, 1 }, { "asin",  F_ASIN,  1, 1 }, { "atan",  F_ATAN,  1, 1 },
+    { "ceil",  F_CEIL,  1, 1 }, { "cos",   F_COS,   1, 1 }, { "cosh",  F_COSH,  1, 1 },
+    { "exp",   F_EXP,   1, 1 }, { "fabs",  F_FABS,  1, 1 }, { "floor", F_FLOOR, 1, 1 },
+    { "log",   F_LOG,   1, 1 }, { "log10", F_LOG10, 1, 1 }, { "sin",   F_SIN,   1, 1 },
+    { "sinh",  F_SINH,  1, 1 }, { "sqrt",  F_SQRT,  1, 1 }, { "tan",   F_TAN,   1, 1 },
+    { "tanh",  F_TANH,  1, 1 }, { "atan2", F_ATAN2, 2, 2 }, { "fmod",  F_FMOD,  2, 2 },
+    { "hypot", F_HYPOT, 2, 2 }, { "pow",   F_POW,   2, 2 }, { "abs",   F_ABS,   1, 1 },
+    { "float", F_FLOAT, 1, 1 }, { "int",   F_INT,   1, 1 }, { "round", F_ROUND, 1, 2 },
+    { "min",   F_MIN,   2, ~(size_t) 0 }, { "max",   F_MAX,   2, ~(size_t) 0 },
+    { "cmp",   F_CMP,   2, 2 }, { 0, F_ACOS, 0, 0 }
+  };
+
+  if(my_variables.count(n) || my_hidden.count(n))
+    return false;
+
+  const function_name * f = functions;
+
+  while(f->name && n != f->name)
+    ++f;
+
+  if(!f->name)
+    return false;
+
+  accept("(");
+
+  size_t count     = 0;
+  size_t arg_start = 0;
+
+  while(!accept(")"))
+  {
+    arg_start = my_target.my_program.size();
+
+    if(!test())
+      return false;
+
+    ++count;
+
+    if(!accept(",") && !(my_token == T_OP && my_text == ")"))
+      return false;
+  }
+
+  if(count < f->min_args || count > f->max_args)
+    return false;
+
+  // round()'s number of digits must be a C int, which is only known here for
+  // a literal.
+
+  if(f->id == F_ROUND && count == 2)
+  {
+    const std::vector<instruction> & p = my_target.my_program;
+
+    size_t length = p.size() - arg_start;
+
+    if(   !(length == 1 || (length == 2 && p[arg_start + 1].code == NEGATE))
+       || p[arg_start].code != PUSH_CONST
+       || !my_target.my_constants[p[arg_start].arg].is_int
+       ||  my_target.my_constants[p[arg_start].arg].i > INT_MAX)
+      return false;
+  }
+
+  emit(CALL, f->id, count);
+
+  return true;
+}
+
+//============================================================================
+//
+//  Python 1.5 arithmetic
+//
+//============================================================================
+
+namespace {
+
+bool truth(bool is_int, long i, double f)
+{
+  return is_int ? i != 0 : f != 0.0;
+}
+
+// Products and sums of ints which overflow are errors in Python 1.5.
+
+bool int_multiply(long a, long b, long & r)
+{
+  if(a > 0 ? (b > 0 ? a > LONG_MAX / b : b < LONG_MIN / a)
+           : (b > 0 ? a < LONG_MIN / b : (a != 0 && b < LONG_MAX / a)))
+    return false;
+
+  r = a * b;
+
+  return true;
+}
+
+bool int_add(long a, long b, long & r)
+{
+  r = (long) ((unsigned long) a + (unsigned long) b);
+
+  return !((r ^ a) < 0 && (r ^ b) < 0);
+}
+
+bool int_subtract(long a, long b, long & r)
+{
+  r = (long) ((unsigned long) a - (unsigned long) b);
+
+  return !((r ^ a) < 0 && (r ^ ~b) < 0);
+}
+
+// Floor division and modulus.
+bool int_divmod(long a, long b, long & d, long & m)
+{
+  if(b == 0 || (b == -1 && a == LONG_MIN))
+    return false;
+
+  d = a / b;
+  m = a % b;
+
+  if(m && ((b ^ m) < 0))
+  {
+    m += b;
+    d -= 1;
+  }
+
+  return true;
+}
+
+bool int_power(long a, long b, long & r)
+{
+  if(b < 0)
+    return false;
+
+  long temp = a;
+
+  r = 1;
+
+  while(b > 0)
+  {
+    if((b & 1) && !int_multiply(r, temp, r))
+      return false;
+
+    b >>= 1;
+
+    if(b && !int_multiply(temp, temp, temp))
+      return false;
+  }
+
+  return true;
+}
+
+// The math module's functions fail on a domain or range error, or a NaN.
+bool math_result(double r)
+{
+  return errno == 0 && r == r;
+}
+
+bool float_power(double a, double b, double & r)
+{
+  if(b == 0.0)
+  {
+    r = 1.0;
+    return true;
+  }
+
+  if(a == 0.0)
+  {
+    r = 0.0;
+    return b > 0.0;
+  }
+
+  if(a < 0.0 && b != std::floor(b))
+    return false;
+
+  errno = 0;
+  r     = std::pow(a, b);
+
+  return math_result(r);
+}
+
+}
+
+//============================================================================
+//
+//  NativeExpression
+//
+//============================================================================
+
+NativeExpression::NativeExpression()
+{ }
+
+bool
+NativeExpression::compile(const std::string & expr, const variable_map & variables, const name_set & hidden)
+{
+  my_program         . clear();
+  my_constants       . clear();
+  my_variable_traits . clear();
+
+  if(!parser(*this, expr, variables, hidden).parse())
+  {
+    my_program         . clear();
+    my_constants       . clear();
+    my_variable_traits . clear();
+
+    return false;
+  }
+
+  // No instruction pushes more than one value.
+
+  my_stack.resize(my_program.size() + 1);
+
+  return true;
+}
+
+bool
+NativeExpression::compiled() const
+{
+  return my_program.size() != 0;
+}
+
+const std::vector<size_t> &
+NativeExpression::variable_traits() const
+{
+  return my_variable_traits;
+}
+
+double
+NativeExpression::evaluate(const double * values) const
+{
+  const double qnan = std::numeric_limits<double>::quiet_NaN();
+
+  if(my_program.empty())
+    return qnan;
+
+  value * stack = &my_stack[0];
+  size_t  top   = 0;        // Number of values on the stack
+
+  for(size_t pc = 0; pc < my_program.size(); ++pc)
+  {
+    const instruction & in = my_program[pc];
+
+    switch(in.code)
+    {
+      case PUSH_CONST:
+
+        stack[top++] = my_constants[in.arg];
+        break;
+
+      case LOAD_VAR:
+      {
+        value v = { false, 0, values[in.arg] };
+
+        stack[top++] = v;
+        break;
+      }
+
+      case ADD: case SUBTRACT: case MULTIPLY: case DIVIDE: case MODULO: case POWER:
+      {
+        value & a = stack[top - 2];
+        value & b = stack[top - 1];
+
+        --top;
+
+        if(a.is_int && b.is_int)
+        {
+          long r = 0, m = 0;
+          bool ok = false;
+
+          switch(in.code)
+          {
+            case ADD:      ok = int_add     (a.i, b.i, r);    break;
+            case SUBTRACT: ok = int_subtract(a.i, b.i, r);    break;
+            case MULTIPLY: ok = int_multiply(a.i, b.i, r);    break;
+            case DIVIDE:   ok = int_divmod  (a.i, b.i, r, m); break;
+            case MODULO:   ok = int_divmod  (a.i, b.i, m, r); break;
+            default:       ok = int_power   (a.i, b.i, r);    break;
+          }
+
+          if(!ok)
+            return qnan;
+
+          a.i = r;
+        }
+        else
+        {
+          double x = a.is_int ? (double) a.i : a.f;
+          double y = b.is_int ? (double) b.i : b.f;
+
+          switch(in.code)
+          {
+            case ADD:      a.f = x + y; break;
+            case SUBTRACT: a.f = x - y; break;
+            case MULTIPLY: a.f = x * y; break;
+
+            case DIVIDE:
+
+              if(y == 0.0)
+                return qnan;
+
+              a.f = x / y;
+              break;
+
+            case MODULO:
+
+              if(y == 0.0)
+                return qnan;
+
+              a.f = std::fmod(x, y);
+
+              if(a.f && ((y < 0) != (a.f < 0)))
+                a.f += y;
+
+              break;
+
+            default:
+
+              if(!float_power(x, y, a.f))
+                return qnan;
+
+              break;
+          }
+
+          a.is_int = false;
+        }
+
+        break;
+      }
+
+      case NEGATE:
+      {
+        value & a = stack[top - 1];
+
+        if(a.is_int)
+        {
+          if(a.i == LONG_MIN)
+            return qnan;
+
+          a.i = -a.i;
+        }
+        else
+          a.f = -a.f;
+
+        break;
+      }
+
+      case NOT:
+      {
+        value & a = stack[top - 1];
+
+        a.i      = !truth(a.is_int, a.i, a.f);
+        a.is_int = true;
+        break;
+      }
+
+      case COMPARE:
+      {
+        value & a = stack[top - 2];
+        value & b = stack[top - 1];
+
+        --top;
+
+        int c;
+
+        if(a.is_int && b.is_int)
+          c = (a.i < b.i) ? -1 : (a.i > b.i);
+        else
+        {
+          double x = a.is_int ? (double) a.i : a.f;
+          double y = b.is_int ? (double) b.i : b.f;
+
+          c = (x < y) ? -1 : (x > y);
+        }
+
+        bool r = false;
+
+        switch(in.arg)
+        {
+          case LT: r = c <  0; break;
+          case LE: r = c <= 0; break;
+          case EQ: r = c == 0; break;
+          case NE: r = c != 0; break;
+          case GT: r = c >  0; break;
+          case GE: r = c >= 0; break;
+        }
+
+        a.is_int = true;
+        a.i      = r;
+        break;
+      }
+
+      case CALL:
+
+        top -= in.count;
+
+        if(!call((function_id) in.arg, stack + top, in.count, stack[top]))
+          return qnan;
+
+        ++top;
+        break;
+
+      case DUP:
+
+        stack[top] = stack[top - 1];
+        ++top;
+        break;
+
+      case ROT_TWO:
+
+        std::swap(stack[top - 1], stack[top - 2]);
+        break;
+
+      case ROT_THREE:
+      {
+        value v = stack[top - 1];
+
+        stack[top - 1] = stack[top - 2];
+        stack[top - 2] = stack[top - 3];
+        stack[top - 3] = v;
+        break;
+      }
+
+      case POP:
+
+        --top;
+        break;
+
+      case JUMP:
+
+        pc = in.arg - 1;
+        break;
+
+      case JUMP_IF_FALSE:
+
+        if(!truth(stack[top - 1].is_int, stack[top - 1].i, stack[top - 1].f))
+          pc = in.arg - 1;
+
+        break;
+
+      case JUMP_IF_TRUE:
+
+        if(truth(stack[top - 1].is_int, stack[top - 1].i, stack[top - 1].f))
+          pc = in.arg - 1;
+
+        break;
+    }
+  }
+
+  return stack[0].is_int ? (double) stack[0].i : stack[0].f;
+}
+
+bool
+NativeExpression::call(function_id f, const value * args, size_t count, value & result) const
+{
+  // result may be the first argument.
+
+  const value a = args[0];
+  const value b = (count > 1) ? args[1] : args[0];
+
+  double x = a.is_int ? (double) a.i : a.f;
+  double y = b.is_int ? (double) b.i : b.f;
+
+  if(f <= F_POW)
+  {
+    double r = 0.0;
+
+    errno = 0;
+
+    switch(f)
+    {
+      case F_ACOS:  r = std::acos (x);    break;
+      case F_ASIN:  r = std::asin (x);    break;
+      case F_ATAN:  r = std::atan (x);    break;
+      case F_CEIL:  r = std::ceil (x);    break;
+      case F_COS:   r = std::cos  (x);    break;
+      case F_COSH:  r = std::cosh (x);    break;
+      case F_EXP:   r = std::exp  (x);    break;
+      case F_FABS:  r = std::fabs (x);    break;
+      case F_FLOOR: r = std::floor(x);    break;
+      case F_LOG:   r = std::log  (x);    break;
+      case F_LOG10: r = std::log10(x);    break;
+      case F_SIN:   r = std::sin  (x);    break;
+      case F_SINH:  r = std::sinh (x);    break;
+      case F_SQRT:  r = std::sqrt (x);    break;
+      case F_TAN:   r = std::tan  (x);    break;
+      case F_TANH:  r = std::tanh (x);    break;
+      case F_ATAN2: r = std::atan2(x, y); break;
+      case F_FMOD:  r = std::fmod (x, y); break;
+      case F_HYPOT: r = ::hypot   (x, y); break;
+      default:      r = std::pow  (x, y); break;
+    }
+
+    if(!math_result(r))
+      return false;
+
+    result.is_int = false;
+    result.f      = r;
+
+    return true;
+  }
+
+  switch(f)
+  {
+    case F_ABS:
+
+      if(a.is_int)
+      {
+        if(a.i == LONG_MIN)
+          return false;
+
+        result.i = (a.i < 0) ? -a.i : a.i;
+      }
+      else
+        result.f = std::fabs(x);
+
+      result.is_int = a.is_int;
+      return true;
+
+    case F_FLOAT:
+
+      result.is_int = false;
+      result.f      = x;
+      return true;
+
+    case F_INT:
+
+      if(a.is_int)
+        result.i = a.i;
+      else if(x >= (double) LONG_MIN && x < -(double) LONG_MIN)
+        result.i = (long) x;
+      else
+        return false;
+
+      result.is_int = true;
+      return true;
+
+    case F_ROUND:
+    {
+      long   digits = (count > 1) ? b.i : 0;
+      double scale  = 1.0;
+
+      for(long i = (digits < 0) ? -digits : digits; i > 0 && scale != HUGE_VAL; --i)
+        scale *= 10.0;
+
+      x = (digits < 0) ? x / scale : x * scale;
+      x = (x >= 0.0) ? std::floor(x + 0.5) : std::ceil(x - 0.5);
+      x = (digits < 0) ? x * scale : x / scale;
+
+      result.is_int = false;
+      result.f      = x;
+      return true;
+    }
+
+    case F_MIN:
+    case F_MAX:
+    {
+      // The first of the least (or greatest) values, of its own type.
+
+      size_t best = 0;
+
+      for(size_t k = 1; k < count; ++k)
+      {
+        const value & v = args[k];
+        const value & w = args[best];
+
+        int c;
+
+        if(v.is_int && w.is_int)
+          c = (v.i < w.i) ? -1 : (v.i > w.i);
+        else
+        {
+          double vx = v.is_int ? (double) v.i : v.f;
+          double wx = w.is_int ? (double) w.i : w.f;
+
+          c = (vx < wx) ? -1 : (vx > wx);
+        }
+
+        if((f == F_MIN) ? c < 0 : c > 0)
+          best = k;
+      }
+
+      result = args[best];
+      return true;
+    }
+
+    case F_CMP:
+
+      if(a.is_int && b.is_int)
+        result.i = (a.i < b.i) ? -1 : (a.i > b.i);
+      else
+        result.i = (x < y) ? -1 : (x > y);
+
+      result.is_int = true;
+      return true;
+
+    default:
+
+      return false;
+  }
+}
+
+} // End namespace FUNC
+} // End namespace SAGE
@@ -66,6 +66,9 @@ class func_tests (sagetest.SAGE_Test) :
     self.cmd = '../pedinfo/pedinfo par dat > screen 2>&1'
     self.file_names = ['pedinfo.inf', 'screen']
     self.execute()
-    
-    
-    
\ No newline at end of file
+
+  def test_native_expression(self):
+    'Native expression compiler against Python 1.5 values'
+    self.cmd = 'test_native_expression > out 2>&1'
+    self.file_names = ['out']
+    self.execute()
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include "func/NativeExpression.h"
+
+// Checks NativeExpression against the values the Python 1.5 interpreter
+// gives the same expressions, with x = 7.0, y = -2.5 and age = 15.0.
+
+namespace {
+
+struct expected_value
+{
+  const char * expr;
+  bool         compiles;
+  double       value;      // QNAN for an evaluation error
+};
+
+const double error = std::numeric_limits<double>::quiet_NaN();
+
+const expected_value cases[] =
+{
+  // Arithmetic, int and float
+
+  { "1 + 2 * 3",                     true,  7.0             },
+  { "7 / 2",                         true,  3.0             },
+  { "-7 / 2",                        true,  -4.0            },
+  { "7 % -3",                        true,  -2.0            },
+  { "-7 % 3",                        true,  2.0             },
+  { "7.0 / 2",                       true,  3.5             },
+  { "x % 2",                         true,  1.0             },
+  { "y % 2",                         true,  1.5             },
+  { "-x % -2",                       true,  -1.0            },
+  { "2 ** 10",                       true,  1024.0          },
+  { "2 ** 3 ** 2",                   true,  512.0           },
+  { "-2 ** 2",                       true,  -4.0            },
+  { "2 ** -1",                       true,  error           },
+  { "2.0 ** -1",                     true,  0.5             },
+  { "(-8.0) ** (1.0/3)",             true,  error           },
+  { "0.0 ** -1",                     true,  error           },
+  { "x / 0",                         true,  error           },
+  { "1 / 0",                         true,  error           },
+  { "3037000500 * 3037000500",       true,  error           },
+  { "2 ** 62 + 2 ** 62",             true,  error           },
+  { "2 * x",                         true,  14.0            },
+  { ".5 + 1e1 + 2.",                 true,  12.5            },
+
+  // Comparisons, 'and', 'or' and 'not'
+
+  { "(age<=10)",                     true,  0.0             },
+  { "(age>10 and age<=20)",          true,  1.0             },
+  { "10 < age < 20",                 true,  1.0             },
+  { "20 < age < 30",                 true,  0.0             },
+  { "1 < 2 > 0 != 5",                true,  1.0             },
+  { "age <> 15",                     true,  0.0             },
+  { "x > 5 and 100 or 200",          true,  100.0           },
+  { "x < 5 and 100 or 200",          true,  200.0           },
+  { "0 or y",                        true,  -2.5            },
+  { "x and 0",                       true,  0.0             },
+  { "not x",                         true,  0.0             },
+  { "not not y",                     true,  1.0             },
+
+  // Functions and constants
+
+  { "sqrt(x * x)",                   true,  7.0             },
+  { "(floor(x) % 2) + 2",            true,  3.0             },
+  { "sqrt(-1)",                      true,  error           },
+  { "log(0)",                        true,  error           },
+  { "exp(1000)",                     true,  error           },
+  { "pow(2, 0.5) ** 2 > 1.99",       true,  1.0             },
+  { "abs(-3) / 2",                   true,  1.0             },
+  { "abs(y)",                        true,  2.5             },
+  { "int(y) / 2",                    true,  -1.0            },
+  { "float(7) / 2",                  true,  3.5             },
+  { "round(2.5)",                    true,  3.0             },
+  { "round(-2.5)",                   true,  -3.0            },
+  { "round(1234.5678, 2)",           true,  1234.57         },
+  { "round(1234.5678, -2)",          true,  1200.0          },
+  { "min(3, x, 2) / 2",              true,  1.0             },
+  { "max(3, x, 2)",                  true,  7.0             },
+  { "cmp(x, 3)",                     true,  1.0             },
+  { "2 * pi",                        true,  2 * M_PI        },
+  { "log(e)",                        true,  1.0             },
+
+  // Left to Python
+
+  { "dominant(LOC1, 'A')",           false, 0.0             },
+  { "200L * 2",                      false, 0.0             },
+  { "010 + 1",                       false, 0.0             },
+  { "0x10",                          false, 0.0             },
+  { "1j",                            false, 0.0             },
+  { "z + 1",                         false, 0.0             },
+  { "x(1)",                          false, 0.0             },
+  { "sqrt(1, 2)",                    false, 0.0             },
+  { "round(x, y)",                   false, 0.0             },
+  { "x, y",                          false, 0.0             },
+  { "x[0]",                          false, 0.0             },
+  { "x if y else 0",                 false, 0.0             },
+  { "lambda: 0",                     false, 0.0             },
+  { "x in (1, 2)",                   false, 0.0             },
+  { "C * x",                         false, 0.0             },
+  { "e * x",                         false, 0.0             },
+  { 0,                               false, 0.0             }
+};
+
+}
+
+int main()
+{
+  SAGE::FUNC::NativeExpression::variable_map variables;
+
+  variables["x"]   = 0;
+  variables["y"]   = 1;
+  variables["age"] = 2;
+
+  const double trait_values[] = { 7.0, -2.5, 15.0 };
+
+  // C and e are constants defined in the Python environment.
+
+  SAGE::FUNC::NativeExpression::name_set hidden;
+
+  hidden.insert("C");
+
+  size_t failures = 0;
+
+  for(size_t c = 0; cases[c].expr; ++c)
+  {
+    SAGE::FUNC::NativeExpression native;
+
+    SAGE::FUNC::NativeExpression::name_set h = hidden;
+
+    if(std::string(cases[c].expr) == "e * x")
+      h.insert("e");
+
+    bool compiled = native.compile(cases[c].expr, variables, h);
+
+    double value = 0.0;
+
+    if(compiled)
+    {
+      std::vector<double> values;
+
+      for(size_t v = 0; v < native.variable_traits().size(); ++v)
+        values.push_back(trait_values[native.variable_traits()[v]]);
+
+      values.push_back(0.0);
+
+      value = native.evaluate(&values[0]);
+    }
+
+    bool ok = compiled == cases[c].compiles;
+
+    if(ok && compiled)
+    {
+      if(cases[c].value != cases[c].value)
+        ok = value != value;
+      else
+        ok = std::fabs(value - cases[c].value) <= 1e-12 * (1.0 + std::fabs(cases[c].value));
+    }
+
+    if(!ok)
+      ++failures;
+
+    std::cout << (ok ? "ok    " : "FAILED") << "  " << cases[c].expr;
+
+    if(compiled)
+      std::cout << " = " << value;
+    else
+      std::cout << " (Python)";
+
+    std::cout << std::endl;
+  }
+
+  std::cout << std::endl << failures << " failures." << std::endl;
+
+  return failures ? 1 : 0;
+}
@@ -37,6 +37,8 @@ genibd_analysis::genibd_analysis(const RefMultiPedigree&   mp,
   my_exact_ibd_analysis = NULL;
   my_pair_ibd_analysis  = NULL;
   my_sim_ibd_analysis   = NULL;
+
+  my_ibd_binary_file    = NULL;
 }
 
 genibd_analysis::~genibd_analysis()
@@ -372,8 +374,9 @@ genibd_analysis::do_analysis()
 
     // Create an output file
 
-    my_ibd_prob_file  = NULL;
-    my_ibd_state_file = NULL;
+    my_ibd_prob_file   = NULL;
+    my_ibd_state_file  = NULL;
+    my_ibd_binary_file = NULL;
 
     // Create a pedigree iteration
     for( size_t mp = 0; mp < my_multipedigree->pedigree_count(); ++mp )  
@@ -383,6 +386,15 @@ genibd_analysis::do_analysis()
       process_pedigree(title, output_name, fp, r);
     }
 
+    // The binary file is only written out once all the pairs are known.
+    if( my_ibd_binary_file )
+    {
+      my_ibd_binary_file->close();
+
+      delete my_ibd_binary_file;
+      my_ibd_binary_file = NULL;
+    }
+
     cout << endl;
   }
 
@@ -704,13 +716,28 @@ genibd_analysis::process_subpedigree(const string&         title,
 
   ibd->set_ibd_option(opt);
 
-  if( !my_ibd_prob_file )
+  bool valid_ibd_file = false;
+
+  if( my_parameters->binary_ibd() )
   {
-    my_ibd_prob_file = new RefIBDWriteFile(output + ".ibd", std::cerr);
-    my_ibd_prob_file->output_probability_header(ibd);
+    if( !my_ibd_binary_file )
+    {
+      my_ibd_binary_file = new RefIBDWriteBinaryFile(output + ".ibd", std::cerr);
+      my_ibd_binary_file->output_probability_header(ibd);
+    }
+
+    valid_ibd_file = my_ibd_binary_file->output_ibd_probability(ibd);
   }
+  else
+  {
+    if( !my_ibd_prob_file )
+    {
+      my_ibd_prob_file = new RefIBDWriteFile(output + ".ibd", std::cerr);
+      my_ibd_prob_file->output_probability_header(ibd);
+    }
 
-  bool valid_ibd_file = my_ibd_prob_file->output_ibd_probability(ibd);
+    valid_ibd_file = my_ibd_prob_file->output_ibd_probability(ibd);
+  }
 
   if(    valid_ibd_file
       && my_parameters->output_ibd_state()
@@ -27,6 +27,7 @@ genibd_parameters::genibd_parameters()
                    my_interval_distance(2.0),
                    my_loops(false),
                    my_output_ibd_state(false),
+                   my_binary_ibd(false),
                    my_simulation(YES),
                    my_family_split(NO),
                    my_pair_type(RELATIVE),
@@ -43,6 +44,7 @@ genibd_parameters::genibd_parameters(const genibd_parameters& p)
                    my_interval_distance(p.my_interval_distance),
                    my_loops(p.my_loops),
                    my_output_ibd_state(p.my_output_ibd_state),
+                   my_binary_ibd(p.my_binary_ibd),
                    my_simulation(p.my_simulation),
                    my_family_split(p.my_family_split),
                    my_pair_type(p.my_pair_type),
@@ -58,6 +60,7 @@ genibd_parameters::operator=(const genibd_parameters& p)
   my_multipoint        = p.my_multipoint;
   my_loops             = p.my_loops;
   my_output_ibd_state  = p.my_output_ibd_state;
+  my_binary_ibd        = p.my_binary_ibd;
   my_simulation        = p.my_simulation;
   my_family_split      = p.my_family_split;
   my_scan_interval     = p.my_scan_interval;
@@ -106,6 +106,10 @@ genibd_parser::parse_test_parameter(const LSFBase* param)
   {
     parse_output_ibd_state(param);
   }    
+  else if( n == "BINARY_IBD" || n == "OUTPUT_BINARY_IBD" )
+  {
+    parse_binary_ibd(param);
+  }    
   else if( n == "USE_SIMULATION" || n == "SIMULATION" )
   {
     parse_simulation(param);
@@ -228,6 +232,15 @@ void genibd_parser::parse_output_ibd_state(const LSFBase* param)
   my_parameters.set_output_ibd_state(b);
 }
 
+void genibd_parser::parse_binary_ibd(const LSFBase* param)
+{
+  bool b = my_parameters.binary_ibd();
+
+  parse_boolean(param, b);
+
+  my_parameters.set_binary_ibd(b);
+}
+
 void
 genibd_parser::parse_simulation(const LSFBase* param)
 {
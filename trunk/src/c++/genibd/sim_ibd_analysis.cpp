@@ -15,6 +15,11 @@
 //  All Rights Reserved
 //==========================================================================
 
+#include <sstream>
+#include "boost/shared_ptr.hpp"
+#include "error/bufferederrorstream.h"
+#include "util/ThreadPool.h"
+#include "mcmc/convergence.h"
 #include "genibd/sim_ibd_analysis.h"
 
 namespace SAGE
@@ -23,6 +28,72 @@ namespace SAGE
 namespace GENIBD
 {
 
+namespace
+{
+
+// Chains report progress through the analysis' timer, one dot per batch,
+// rather than per step.
+//
+class quiet_dot_formatter : public dot_formatter
+{
+  protected:
+
+    virtual bool prefix()  { return true; }
+    virtual bool postfix() { return true; }
+    virtual bool resync()  { return true; }
+    virtual bool reset()   { return true; }
+};
+
+// Batches every chain must run before the chains may be stopped early.
+//
+const size_t MIN_DIAGNOSTIC_BATCHES = 10;
+
+class chain_init_task : public UTIL::ParallelTask
+{
+  public:
+
+    chain_init_task(vector<ibd_mcmc_simulator*>& chains)
+      : my_chains(chains), my_valid(chains.size(), 0)
+    { }
+
+    // Chain 0 is initialized by the caller, w. messages.
+    virtual void run(size_t item, size_t)
+    {
+      std::ostringstream quiet;
+
+      my_valid[item + 1] = my_chains[item + 1]->initialize(quiet);
+    }
+
+    bool valid(size_t chain) const { return my_valid[chain]; }
+
+  private:
+
+    vector<ibd_mcmc_simulator*>&  my_chains;
+    vector<char>                  my_valid;
+};
+
+class chain_batch_task : public UTIL::ParallelTask
+{
+  public:
+
+    chain_batch_task(vector<ibd_mcmc_simulator*>& chains)
+      : my_chains(chains)
+    { }
+
+    virtual void run(size_t item, size_t)
+    {
+      quiet_dot_formatter timer;
+
+      my_chains[item]->run_batch(timer);
+    }
+
+  private:
+
+    vector<ibd_mcmc_simulator*>&  my_chains;
+};
+
+}
+
 sim_ibd_analysis::sim_ibd_analysis(const mcmc_parameters& p, cerrorstream& e)
                 : my_params(p), errors(e)
 {
@@ -122,6 +193,9 @@ sim_ibd_analysis::compute(ostream& info)
   ped.dump_map(cout);
 #endif
 
+  if( my_params.get_chain_count() > 1 )
+    return my_valid = compute_chains(ped, info);
+
   my_simulator = new ibd_mcmc_simulator(ped, my_ped_region, &my_params, errors);
 
   assert(my_simulator!=NULL);
@@ -133,6 +207,206 @@ sim_ibd_analysis::compute(ostream& info)
 }
 
 
+// Runs the chains a batch at a time, all chains in step.  The statistic
+// diagnosed at each marker is the proportion of alleles shared ibd in a
+// batch, averaged over the pedigree's pairs.
+//
+bool
+sim_ibd_analysis::compute_chains(const MCMC::McmcMeiosisMap& ped, ostream& info)
+{
+  size_t chain_count = my_params.get_chain_count();
+
+  vector<vector<sim_relative_pair> > chain_pairs(chain_count, my_relative_pairs);
+  vector<ibd_mcmc_simulator*>        chains(chain_count);
+
+  // The chains run on the pool's threads, and errors can't be written from
+  // several threads at once.  Each chain's messages are therefore kept, and
+  // written here, in chain order, after each round of the chains.
+
+  typedef boost::shared_ptr<bufferederrorstream<char> > error_ptr;
+
+  vector<error_ptr> chain_errors(chain_count);
+
+  for( size_t c = 0; c < chain_count; ++c )
+  {
+    chain_errors[c].reset(new bufferederrorstream<char>(errors));
+
+    chains[c] = new ibd_mcmc_simulator(ped, my_ped_region, &my_params, *chain_errors[c], c);
+
+    chains[c]->set_pairs(&chain_pairs[c]);
+  }
+
+  UTIL::ThreadPool pool(my_params.get_thread_count());
+
+  bool valid = chains[0]->initialize(info);
+
+  if( valid )
+  {
+    chain_init_task init(chains);
+
+    pool.run(chain_count - 1, init);
+
+    for( size_t c = 0; c < chain_count; ++c )
+      chain_errors[c]->flush_buffer();
+
+    // A chain which can't find a starting state is dropped.
+
+    size_t kept = 1;
+
+    for( size_t c = 1; c < chain_count; ++c )
+    {
+      if( init.valid(c) )
+      {
+        std::swap(chains[kept], chains[c]);
+        std::swap(chain_errors[kept], chain_errors[c]);
+        chain_pairs[kept].swap(chain_pairs[c]);
+        chains[kept]->set_pairs(&chain_pairs[kept]);
+        ++kept;
+      }
+    }
+
+    for( size_t c = kept; c < chain_count; ++c )
+      delete chains[c];
+
+    chains.resize(kept);
+    chain_count = kept;
+  }
+
+  if( !valid )
+  {
+    chain_errors[0]->flush_buffer();
+
+    for( size_t c = 0; c < chains.size(); ++c )
+      delete chains[c];
+
+    return false;
+  }
+
+  cerrorstream out1(cout);
+  cerrorstream out2(info);
+
+  out1.prefix("      ");
+  out2.prefix("      ");
+
+  cerrormultistream out_file;
+
+  out_file.insert(out1);
+  out_file.insert(out2);
+
+  long batch_count, demem_count, sim_count;
+
+  chains[0]->get_step_counts(batch_count, demem_count, sim_count);
+
+  double threshold = my_params.get_convergence_threshold();
+
+  out_file << "Simulation will do " << batch_count << " batches using "
+           << demem_count << " dememorization steps and "
+           << sim_count   << " simulation steps"
+           << (my_params.is_multipoint() ? "" : " for each marker")
+           << " in each of " << chain_count << " chains." << endl;
+
+  if( threshold > 0.0 )
+    out_file << "Chains will stop when R-hat is at most " << threshold
+             << " at every marker." << endl;
+
+  out_file << endl;
+
+  out_file << "Generating starting state..." << endl;
+
+  out_file.set_raw_mode();
+
+  size_t total_batches = batch_count * chain_count;
+
+  time_dot_formatter timer(out_file);
+
+  timer.set_prefix_width(40);
+
+  timer.set_trigger_count(total_batches + 1);
+
+  timer.set_time_check_count(1);
+
+  timer.trigger();  // Initalize everything
+
+  size_t marker_count = my_region.locus_count();
+
+  MCMC::chain_diagnostics diagnostics(chain_count, marker_count);
+
+  vector<vector<size_t> > last_shared(chain_count, vector<size_t>(marker_count, 0));
+  vector<vector<size_t> > last_total (chain_count, vector<size_t>(marker_count, 0));
+
+  chain_batch_task batch(chains);
+
+  size_t batches_run = 0;
+  bool   converged   = false;
+
+  while( batches_run < (size_t) batch_count && !converged )
+  {
+    pool.run(chain_count, batch);
+
+    for( size_t c = 0; c < chain_count; ++c )
+      chain_errors[c]->flush_buffer();
+
+    ++batches_run;
+
+    for( size_t c = 0; c < chain_count; ++c )
+    {
+      for( size_t m = 0; m < marker_count; ++m )
+      {
+        size_t shared = 0;
+        size_t total  = 0;
+
+        for( size_t p = 0; p < chain_pairs[c].size(); ++p )
+        {
+          shared += chain_pairs[c][p].get_shared_count(m);
+          total  += chain_pairs[c][p].get_total(m);
+        }
+
+        double value = total > last_total[c][m]
+                     ? (double) (shared - last_shared[c][m]) / (2.0 * (total - last_total[c][m]))
+                     : QNAN;
+
+        diagnostics.add_draw(c, m, value);
+
+        last_shared[c][m] = shared;
+        last_total [c][m] = total;
+      }
+
+      timer.trigger();
+    }
+
+    if(    threshold > 0.0
+        && batches_run >= MIN_DIAGNOSTIC_BATCHES
+        && diagnostics.max_scale_reduction() <= threshold )
+    {
+      converged = true;
+    }
+  }
+
+  timer.finish();
+
+  out_file.set_cooked_mode();
+
+  // Pool the chains' counts.
+
+  for( size_t c = 0; c < chain_count; ++c )
+  {
+    for( size_t p = 0; p < my_relative_pairs.size(); ++p )
+      my_relative_pairs[p].add_counts(chain_pairs[c][p]);
+
+    delete chains[c];
+  }
+
+  if( converged )
+    out_file << "Chains converged after " << batches_run << " of "
+             << batch_count << " batches." << endl;
+
+  out_file << "Convergence: largest R-hat " << diagnostics.max_scale_reduction()
+           << ", smallest effective sample size " << diagnostics.min_effective_size()
+           << " of " << batches_run * chain_count << " batches." << endl;
+
+  return true;
+}
+
 } // end of namespace GENIBD
 
 } // end of namespace SAGE
@@ -57,6 +57,21 @@ sim_relative_pair::operator=(const sim_relative_pair& r)
   return *this;
 }
 
+void
+sim_relative_pair::add_counts(const sim_relative_pair& r)
+{
+  assert(my_data.size() == r.my_data.size());
+
+  for( size_t m = 0; m < my_data.size(); ++m )
+  {
+    my_data[m].f0    += r.my_data[m].f0;
+    my_data[m].f2    += r.my_data[m].f2;
+    my_data[m].f1m   += r.my_data[m].f1m;
+    my_data[m].f1p   += r.my_data[m].f1p;
+    my_data[m].total += r.my_data[m].total;
+  }
+}
+
 } // end of namespace GENIBD
 
 } // end of namespace SAGE
@@ -23,8 +23,9 @@ namespace GENIBD
 ibd_mcmc_simulator::ibd_mcmc_simulator(const mcmc_meiosis_map& ped,
                                        const pedigree_region&  ped_region,
                                        mcmc_parameters*        param,
-                                       cerrorstream&           err)
-                  : mcmc_simulator(ped, ped_region, param, err)
+                                       cerrorstream&           err,
+                                       size_t                  chain)
+                  : mcmc_simulator(ped, ped_region, param, err, chain)
 {
   my_relative_pairs = NULL;
 
@@ -42,19 +43,8 @@ ibd_mcmc_simulator::~ibd_mcmc_simulator()
 bool
 ibd_mcmc_simulator::start(ostream& info)
 {
-  if( !initialize_analysis(info) )
-    return false;
-
-  //check pair set.
-  if( !my_relative_pairs || my_relative_pairs->empty() ) 
-  {
-    errors << SAGE::priority(SAGE::information)
-           << " No pairs available in IBD_SIM analysis." << endl; 
-
-    info << " No pairs available in IBD_SIM analysis." << endl;
-
+  if( !initialize(info) )
     return false;
-  }
 
   // Initialize output
 
@@ -75,25 +65,67 @@ ibd_mcmc_simulator::start(ostream& info)
   return true;
 }
 
-void
-ibd_mcmc_simulator::do_singlepoint_analysis(cerrorstream& out_file)
+bool
+ibd_mcmc_simulator::initialize(ostream& info)
 {
-  int rej_counter;
+  if( !initialize_analysis(info) )
+    return false;
+
+  //check pair set.
+  if( !my_relative_pairs || my_relative_pairs->empty() ) 
+  {
+    errors << SAGE::priority(SAGE::information)
+           << " No pairs available in IBD_SIM analysis." << endl; 
 
-  long batch_count = my_parameters->get_batch_count();
-  long demem_count = my_parameters->get_dememorization_step();
-  long sim_count   = my_parameters->get_simulation_step();
+    info << " No pairs available in IBD_SIM analysis." << endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+void
+ibd_mcmc_simulator::get_step_counts(long& batch_count, long& demem_count, long& sim_count) const
+{
+  batch_count = my_parameters->get_batch_count();
+  demem_count = my_parameters->get_dememorization_step();
+  sim_count   = my_parameters->get_simulation_step();
 
   if( my_parameters->get_use_factor() )
   {
     size_t base_amount = my_pedigree.get_individual_count();
 
+    if( my_multipoint )
+      base_amount *= my_ped_region.get_region().locus_count();
+
     double log_base = log((double) base_amount);
 
     batch_count = std::max((size_t) 100, (size_t) (my_parameters->get_batch_factor() * log_base));
     demem_count = (size_t)my_parameters->get_dememorization_factor() * base_amount;
     sim_count   = (size_t)my_parameters->get_simulation_factor() * base_amount;
   }
+}
+
+void
+ibd_mcmc_simulator::run_batch(dot_formatter& timer)
+{
+  long batch_count, demem_count, sim_count;
+
+  get_step_counts(batch_count, demem_count, sim_count);
+
+  create_starting_state();
+
+  if(my_multipoint)     multipoint_batch(timer, demem_count, sim_count);
+  else                  singlepoint_batch(timer, demem_count, sim_count);
+}
+
+void
+ibd_mcmc_simulator::do_singlepoint_analysis(cerrorstream& out_file)
+{
+  long batch_count, demem_count, sim_count;
+
+  get_step_counts(batch_count, demem_count, sim_count);
 
   out_file << "Simulation will do "
            << batch_count << " batches using "
@@ -123,53 +155,61 @@ ibd_mcmc_simulator::do_singlepoint_analysis(cerrorstream& out_file)
     if( !i )
       timer.trigger();  // Initalize everything
 
-    //simulate on one marker at a time
-    for( size_t m = 0; m < my_total_useful_loci; ++m ) 
-    {
-      if( !my_data->is_valid_locus(m) )
-        continue;
+    singlepoint_batch(timer, demem_count, sim_count);
+  }
+}
 
-      my_current_marker = m;
+void
+ibd_mcmc_simulator::singlepoint_batch(dot_formatter& timer, long demem_count, long sim_count)
+{
+  int rej_counter;
 
-      dememorize(timer, demem_count);
+  //simulate on one marker at a time
+  for( size_t m = 0; m < my_total_useful_loci; ++m ) 
+  {
+    if( !my_data->is_valid_locus(m) )
+      continue;
 
-      // simulation phase
+    my_current_marker = m;
 
-      set_init_ibd_sc();
+    dememorize(timer, demem_count);
 
-      timer.trigger();
+    // simulation phase
 
-      rej_counter = 0;
+    set_init_ibd_sc();
 
-      for( size_t s = 1; s != (size_t)sim_count; ++s )
-      {
-        start_step();
+    timer.trigger();
 
-        generate_transition();
+    rej_counter = 0;
 
-        double rho = apply_transition();
+    for( size_t s = 1; s != (size_t)sim_count; ++s )
+    {
+      start_step();
 
-        if( get_random_real() > rho )
-        {  
-          ++rej_counter;
-          reject_transition();   
-        }
-        else
-        {
-          singlepoint_ibd_sharing(s);
-          rej_counter = 0;
-        }
+      generate_transition();
 
-        timer.trigger();
+      double rho = apply_transition();
 
-        end_step();
+      if( get_random_real() > rho )
+      {  
+        ++rej_counter;
+        reject_transition();   
       }
-
-      //last update
-      if( rej_counter != 0 )
+      else
       {
-        singlepoint_ibd_sharing(sim_count - 1);
+        singlepoint_ibd_sharing(s);
+        rej_counter = 0;
       }
+
+      timer.trigger();
+
+      end_step();
+    }
+
+    //last update
+    if( rej_counter != 0 )
+    {
+      singlepoint_ibd_sharing(sim_count - 1);
     }
   }
 }
@@ -177,22 +217,9 @@ ibd_mcmc_simulator::do_singlepoint_analysis(cerrorstream& out_file)
 void
 ibd_mcmc_simulator::do_multipoint_analysis(SAGE::cerrorstream& out_file)
 {
-  size_t num_of_rejected, rej_counter = 0;
-
-  long batch_count = my_parameters->get_batch_count();
-  long demem_count = my_parameters->get_dememorization_step();
-  long sim_count   = my_parameters->get_simulation_step();
+  long batch_count, demem_count, sim_count;
 
-  if( my_parameters->get_use_factor() )
-  {
-    size_t base_amount = my_pedigree.get_individual_count() * my_ped_region.get_region().locus_count();
-
-    double log_base = log((double) base_amount);
-
-    batch_count = std::max((size_t) 100, (size_t) (my_parameters->get_batch_factor() * log_base));
-    demem_count = (size_t)my_parameters->get_dememorization_factor() * base_amount;
-    sim_count   = (size_t)my_parameters->get_simulation_factor() * base_amount;
-  }
+  get_step_counts(batch_count, demem_count, sim_count);
 
   out_file << "Simulation will do " << batch_count << " batches using "
            << demem_count << " dememorization steps and "
@@ -219,49 +246,57 @@ ibd_mcmc_simulator::do_multipoint_analysis(SAGE::cerrorstream& out_file)
     if( !i )
       timer.trigger();  // Initalize everything
 
-    //dememorization phase
- 
-    dememorize(timer, demem_count);
+    multipoint_batch(timer, demem_count, sim_count);
+  }
+}
 
-    // simulation phase
+void
+ibd_mcmc_simulator::multipoint_batch(dot_formatter& timer, long demem_count, long sim_count)
+{
+  size_t num_of_rejected, rej_counter = 0;
 
-    num_of_rejected = set_init_ibd_sc();
+  //dememorization phase
 
-    timer.trigger();
+  dememorize(timer, demem_count);
 
-    rej_counter = 0;
+  // simulation phase
 
-    for( size_t s = 1; s < (size_t)sim_count; ++s )
-    {
-      start_step();
+  num_of_rejected = set_init_ibd_sc();
 
-      generate_transition();
+  timer.trigger();
 
-      double rho = apply_transition();
+  rej_counter = 0;
 
-      if( get_random_real() > rho )
-      {
-        ++num_of_rejected; 
-        ++rej_counter;
-        reject_transition();
-      }
-      else  
-      {
-         multipoint_ibd_sharing(s);
-         rej_counter = 0;
-      }
+  for( size_t s = 1; s < (size_t)sim_count; ++s )
+  {
+    start_step();
 
-      timer.trigger();
+    generate_transition();
 
-      end_step();
-    }
+    double rho = apply_transition();
 
-    if( rej_counter!=0 )
+    if( get_random_real() > rho )
     {
-      // Make sure we update all the markers
-      for( size_t m = 0; m != my_total_loci; ++m )
-        ibd_sharing(sim_count - 1, m);
+      ++num_of_rejected; 
+      ++rej_counter;
+      reject_transition();
     }
+    else  
+    {
+       multipoint_ibd_sharing(s);
+       rej_counter = 0;
+    }
+
+    timer.trigger();
+
+    end_step();
+  }
+
+  if( rej_counter!=0 )
+  {
+    // Make sure we update all the markers
+    for( size_t m = 0; m != my_total_loci; ++m )
+      ibd_sharing(sim_count - 1, m);
   }
 }
 
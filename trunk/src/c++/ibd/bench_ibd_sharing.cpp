@@ -0,0 +1,269 @@
+//==========================================================================
+//  File:    bench_ibd_sharing.cpp
+//
+//  Purpose: Benchmark of the IBD sharing accumulation of ibd_analysis.
+//           Compares ibd_sharing_engine against the descent graph walk it
+//           replaced on a three generation pedigree with full sibs, half
+//           sibs and a nuclear family of grandchildren, both autosomal and
+//           x-linked, and checks that the sums and the per class sharing
+//           states are identical.
+//
+//  Usage:   bench_ibd_sharing [sibship_size [repeats]]
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include "lvec/dgraph.h"
+#include "ibd/ibd_sharing_engine.h"
+
+using namespace std;
+using namespace SAGE;
+
+// The accumulation of ibd_analysis::compute(), as it was done before
+// ibd_sharing_engine.h.
+void reference_accumulate(const lvector& mkr, const meiosis_map& mm,
+                          ibd_sharing_engine::sharing_sums& sums,
+                          a_marker_ibd_state* states, double total)
+{
+  size_t member_count = mm.get_subpedigree()->member_count();
+  size_t r_pair_count = (member_count*(member_count-1))/2;
+
+  sums.share0    .assign(r_pair_count, 0.0);
+  sums.share2    .assign(r_pair_count, 0.0);
+  sums.sib_share0.assign(r_pair_count, 0.0);
+  sums.sib_share2.assign(r_pair_count, 0.0);
+
+  descent_graph dg(0, mm);
+
+  // The iterators need the dense form.
+  lvector dense(mkr);
+
+  dense.expand();
+
+  for( lvector::const_iterator i = dense.begin(); i != dense.end(); ++i )
+  {
+    if( *i == 0.0 )
+      continue;
+
+    dg.move_to(i - dense.begin(), mm);
+
+    vector<size_t> a_state(r_pair_count);
+
+    for( size_t j = 0, s = 0; j < member_count-1; ++j )
+    {
+      for( size_t k = j+1; k < member_count; ++k, ++s )
+      {
+        mem_pointer mj = mm.member(j);
+        mem_pointer mk = mm.member(k);
+
+        bool bb = mm.is_x_linked() && is_brother_brother(mj, mk);
+
+        size_t sharing = dg.sharing(j,k);
+
+        if( bb )
+          --sharing;
+
+        switch( sharing )
+        {
+          case 0 : sums.share0[s] += *i; a_state[s] = sharing; break;
+          case 2 : sums.share2[s] += *i; a_state[s] = sharing; break;
+
+          case 1 : if( is_fsib(mj, mk) )
+                   {
+                     if( dg.mother_sharing(j,k) )
+                     {
+                       sums.sib_share0[s] += *i;
+                       a_state[s] = 3;
+                     }
+
+                     if( dg.father_sharing(j,k) && !bb )
+                     {
+                       sums.sib_share2[s] += *i;
+                       a_state[s] = 4;
+                     }
+                   }
+                   else if( is_hsib(mj, mk) )
+                   {
+                     if( is_maternal_hsib(mj, mk) && dg.mother_sharing(j,k) )
+                     {
+                       sums.sib_share0[s] += *i;
+                       a_state[s] = 3;
+                     }
+
+                     if( is_paternal_hsib(mj, mk) && dg.father_sharing(j,k) && !bb )
+                     {
+                       sums.sib_share2[s] += *i;
+                       a_state[s] = 4;
+                     }
+                   }
+                   else
+                     a_state[s] = sharing;
+
+                   break;
+
+          default: break;
+        }
+      }
+    }
+
+    if( states )
+      states->push_back(make_pair((*i)/total, a_state));
+  }
+}
+
+double seconds(clock_t start)
+{
+  return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+bool same(const vector<double>& a, const vector<double>& b)
+{
+  return a.size() == b.size() && (a.empty() || !memcmp(&a[0], &b[0], a.size() * sizeof(double)));
+}
+
+bool same(const a_marker_ibd_state& a, const a_marker_ibd_state& b)
+{
+  if( a.size() != b.size() )
+    return false;
+
+  for( size_t i = 0; i < a.size(); ++i )
+    if( a[i].first != b[i].first || a[i].second != b[i].second )
+      return false;
+
+  return true;
+}
+
+// Founders f1 (male), f2 (female) and f3 (male).  f1 x f2 have a sibship of
+// the given size, alternating in sex; f3 x f2 have two half sibs of it.  The
+// first child (male) and a founder spouse have three children.
+void build_pedigree(RPED::RefMultiPedigree& p, size_t sibship)
+{
+  const string ped = "bench";
+
+  p.add_member(ped, "f1", MPED::SEX_MALE);
+  p.add_member(ped, "f2", MPED::SEX_FEMALE);
+  p.add_member(ped, "f3", MPED::SEX_MALE);
+  p.add_member(ped, "s1", MPED::SEX_FEMALE);
+
+  for( size_t i = 0; i < sibship; ++i )
+  {
+    string name = "c" + long2str(i + 1);
+
+    p.add_member (ped, name, i % 2 ? MPED::SEX_FEMALE : MPED::SEX_MALE);
+    p.add_lineage(ped, name, "f1", "f2");
+  }
+
+  p.add_member (ped, "h1", MPED::SEX_MALE);
+  p.add_member (ped, "h2", MPED::SEX_FEMALE);
+  p.add_lineage(ped, "h1", "f3", "f2");
+  p.add_lineage(ped, "h2", "f3", "f2");
+
+  for( size_t i = 0; i < 3; ++i )
+  {
+    string name = "g" + long2str(i + 1);
+
+    p.add_member (ped, name, i % 2 ? MPED::SEX_FEMALE : MPED::SEX_MALE);
+    p.add_lineage(ped, name, "c1", "s1");
+  }
+
+  p.build();
+}
+
+int main(int argc, char* argv[])
+{
+  size_t sibship = 4, repeats = 5;
+
+  if(argc > 1) sibship = atoi(argv[1]);
+  if(argc > 2) repeats = atoi(argv[2]);
+
+  if(sibship < 1) sibship = 1;
+  if(repeats < 1) repeats = 1;
+
+  RPED::RefMultiPedigree rmp;
+
+  build_pedigree(rmp, sibship);
+
+  FPED::Multipedigree fmp(rmp);
+
+  FPED::MPFilterer::add_multipedigree(fmp, rmp);
+
+  fmp.construct();
+
+  const FPED::Subpedigree& subped = *fmp.pedigree_begin()->subpedigree_begin();
+
+  cout << setw(10) << "chromosome" << setw(9) << "members" << setw(6) << "bits"
+       << setw(8) << "states" << setw(12) << "reference" << setw(12) << "engine"
+       << setw(10) << "speedup" << endl;
+
+  bool ok = true;
+
+  for( int x = 0; x < 2; ++x )
+  {
+    meiosis_map mm(&subped, x == 1);
+
+    lvector lv(mm.bit_count());
+
+    lv.flatten(mm.bit_count());
+
+    double total = lv.total();
+
+    // With and without the per class sharing states of ibd_state_out.
+    for( int st = 0; st < 2; ++st )
+    {
+      ibd_sharing_engine::sharing_sums expected, result;
+      a_marker_ibd_state               expected_states, result_states;
+
+      clock_t start = clock();
+
+      for( size_t r = 0; r < repeats; ++r )
+      {
+        expected_states.resize(0);
+
+        reference_accumulate(lv, mm, expected, st ? &expected_states : NULL, total);
+      }
+
+      double reference_time = seconds(start) / repeats;
+
+      start = clock();
+
+      ibd_sharing_engine engine;
+
+      for( size_t r = 0; r < repeats; ++r )
+      {
+        // As ibd_analysis::compute() does, compile when the map changes.
+        if( !engine.compiled_for(mm) )
+          engine.compile(mm);
+
+        result_states.resize(0);
+
+        engine.accumulate(lv, result, st ? &result_states : NULL, total);
+      }
+
+      double engine_time = seconds(start) / repeats;
+
+      ok = ok && same(expected.share0,     result.share0)
+              && same(expected.share2,     result.share2)
+              && same(expected.sib_share0, result.sib_share0)
+              && same(expected.sib_share2, result.sib_share2)
+              && same(expected_states,     result_states);
+
+      cout << setw(10) << (x ? "X" : "autosomal") << setw(9) << subped.member_count()
+           << setw(6)  << mm.bit_count()          << setw(8) << (st ? "yes" : "no")
+           << setw(12) << fixed << setprecision(6) << reference_time
+           << setw(12) << engine_time
+           << setw(10) << setprecision(2)
+           << (engine_time > 0.0 ? reference_time / engine_time : 0.0) << endl;
+    }
+  }
+
+  cout << endl << (ok ? "Engine and descent graph walk agree exactly."
+                      : "MISMATCH against descent graph walk!") << endl;
+
+  return ok ? 0 : 1;
+}
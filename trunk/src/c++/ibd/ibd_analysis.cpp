@@ -28,11 +28,19 @@ bool ibd_analysis::compute(const lvector& mkr, const meiosis_map& _mm, bool ibd_
   if( !_mm.built() || !mkr.is_valid() )
     return my_valid = false;
 
-  my_meiosis_map = _mm;
+  // The sharing engine depends only on the meiosis map, which is the same
+  // for every marker of a pedigree, so it is compiled only when the map
+  // changes.
+
+  if( !my_sharing_engine.compiled_for(_mm) )
+  {
+    my_meiosis_map = _mm;
+
+    my_sharing_engine.compile(my_meiosis_map);
+  }
 
   size_t member_count = my_meiosis_map.get_subpedigree()->member_count();
   size_t pair_count   = member_count * member_count;
-  size_t r_pair_count = (member_count*(member_count-1))/2;
 
   // Allocate our data structures
   my_ibd_sharing.resize(0);
@@ -43,131 +51,49 @@ bool ibd_analysis::compute(const lvector& mkr, const meiosis_map& _mm, bool ibd_
 
   my_ibd_state.resize(0);
 
-  descent_graph dg(0, my_meiosis_map);
-
   double total = mkr.total();
 
-#if 0
-  cout << "start ibd_analysis::compute()..." << endl
-       << "total = " << total << endl;
-  dg.print_allele_vector();
-#endif
-
   if( total == 0.0 )
     return my_valid = false;
 
-  for( lvector::const_iterator i = mkr.begin(); i != mkr.end(); ++i )
-  {
-    if( *i == 0.0 )
-      continue;
+  // The sharing of each pair in each equivalence class is determined by the
+  // sharing engine rather than by walking a descent graph through the
+  // classes; see ibd_sharing_engine.h.  The sums are the same.
 
-    lvector::equivalence_class e = i - mkr.begin();
-
-    dg.move_to(e, my_meiosis_map);
-
-#if 0
-  cout << "equivalence_class e = " << e << " : " << mkr[e] << endl;
-  dg.print_allele_vector();
-#endif
-
-    vector<size_t>   a_state(r_pair_count);
-
-    for( size_t j = 0, s = 0; j < member_count-1; ++j )
-    {
-      for( size_t k = j+1; k < member_count; ++k, ++s )
-      {
-        size_t sharing = dg.sharing(j,k);
-#if 0
-  cout << "j = " << j << ":" << my_meiosis_map.member(j)->name()
-       << ", k = " << k << ":" << my_meiosis_map.member(k)->name()
-       << ", dg.sharing(j,k) = " << sharing << endl;
-#endif
-        if(    my_meiosis_map.is_x_linked()
-            && is_brother_brother(my_meiosis_map, j, k) )
-          --sharing;
-
-        switch( sharing )
-        {
-          case 0 : my_prob_share(j, k, 0) += *i; a_state[s] = sharing; break;
-          case 2 : my_prob_share(j, k, 2) += *i; a_state[s] = sharing; break;
-
-          // Added for m or paternal bit split. - yjs Jun. 2002
-          case 1 : if( is_sib(my_meiosis_map, j, k) )
-                   {
-                     if( dg.mother_sharing(j,k) )
-                     {
-                       my_sib_prob_share(j, k, 0) += *i;
-                       a_state[s] = 3;
-                     }
-
-                     if( dg.father_sharing(j,k) )
-                       if(    !my_meiosis_map.is_x_linked()
-                           || !is_brother_brother(my_meiosis_map, j, k) )
-                       {
-                         my_sib_prob_share(j, k, 2) += *i;
-                         a_state[s] = 4;
-                       }
-#if 0
-  cout << "  dg.mother_sharing(j,k) = " << dg.mother_sharing(j,k)
-       << ", dg.father_sharing(j,k) = " << dg.father_sharing(j,k) << endl;
-#endif
-                   }
-                   else if( is_hsib(my_meiosis_map, j, k) )
-                   {
-                     if( is_maternal_hsib(my_meiosis_map, j, k) && dg.mother_sharing(j,k) )
-                     {
-                       my_sib_prob_share(j, k, 0) += *i;
-                       a_state[s] = 3;
-                     }
-
-                     if( is_paternal_hsib(my_meiosis_map, j, k) && dg.father_sharing(j,k) )
-                       if(    !my_meiosis_map.is_x_linked()
-                           || !is_brother_brother(my_meiosis_map, j, k) )
-                       {
-                         my_sib_prob_share(j, k, 2) += *i;
-                         a_state[s] = 4;
-                       }
-#if 0
-  cout << "  dg.mother_sharing(j,k) = " << dg.mother_sharing(j,k)
-       << ", dg.father_sharing(j,k) = " << dg.father_sharing(j,k) << endl;
-#endif
-                   }
-                   else
-                     a_state[s] = sharing;
+  // The engine walks the classes in order, so a sparse vector is expanded
+  // first.
 
-                   break;
+  const lvector* classes = &mkr;
 
-          default: break;
-        }
-      }
-    }
+  lvector dense;
 
-    if( ibd_state_out )
-    {
-      my_ibd_state.push_back(make_pair((*i)/total, a_state));
+  if( mkr.is_sparse() )
+  {
+    dense = mkr;
+    dense.expand();
 
-#if 0
-      cout << setw(5) << doub2str((*i), 5) << "   ";
-      for( size_t s = 0; s < a_state.size(); ++s )
-        cout << setw(5) << a_state[s] << " ";
-      cout << endl;
-#endif
-    }
+    classes = &dense;
   }
 
-  for( size_t j = 0; j < member_count-1; ++j )
+  my_sharing_engine.accumulate(*classes, my_sharing_sums,
+                               ibd_state_out ? &my_ibd_state : NULL, total);
+
+  for( size_t j = 0, s = 0; j + 1 < member_count; ++j )
   {
-    for( size_t k = j+1; k < member_count; ++k )
+    for( size_t k = j+1; k < member_count; ++k, ++s )
     {
-      my_prob_share(j, k, 0) /= total;
-      my_prob_share(j, k, 2) /= total;
+      my_prob_share(j, k, 0) = my_sharing_sums.share0[s] / total;
+      my_prob_share(j, k, 2) = my_sharing_sums.share2[s] / total;
 
-      my_sib_prob_share(j, k, 0) /= total;
-      my_sib_prob_share(j, k, 2) /= total;
+      my_sib_prob_share(j, k, 0) = my_sharing_sums.sib_share0[s] / total;
+      my_sib_prob_share(j, k, 2) = my_sharing_sums.sib_share2[s] / total;
     } 
   }
 
 #if 0
+  size_t r_pair_count = (member_count*(member_count-1))/2;
+
+  descent_graph    dg(0, my_meiosis_map);
   CorrelationInfo  mean_share_info;
 
   mean_share_info.resize(r_pair_count);
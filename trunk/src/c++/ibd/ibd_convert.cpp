@@ -0,0 +1,228 @@
+//==========================================================================
+//  File:    ibd_convert.cpp
+//
+//  Purpose: Converts IBD probability files between the text format and the
+//           binary, memory mapped format.  The direction is determined by
+//           the input file:  a binary file is written out as text, and a
+//           text file as binary.
+//
+//  Usage:   ibd_convert input_file output_file
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <iostream>
+#include "ibd/ibdfile.h"
+
+using namespace std;
+using namespace SAGE;
+
+// IBD storage for reading a text file without a pedigree.  Pairs are only
+// known by name, so the names given to get_pair() are remembered and used
+// by the add_pair() which follows it.  Only one pair is held at a time;
+// each is passed on to the binary writer when the next is added.
+class streaming_text_ibd : public IBD
+{
+  public:
+
+    streaming_text_ibd(RefIBDWriteBinaryFile& out)
+      : my_output(out), my_built(false), my_has_pair(false), my_header_written(false), my_ok(true)
+    { }
+
+    bool flush()
+    {
+      if(!my_has_pair) return my_ok;
+
+      if(!my_header_written)
+      {
+        my_ok             = my_output.output_probability_header(this) && my_ok;
+        my_header_written = true;
+      }
+
+      my_ok       = my_output.output_ibd_probability(this) && my_ok;
+      my_has_pair = false;
+
+      return my_ok;
+    }
+
+    virtual void   build()                    { }
+    virtual bool   built()              const { return my_built; }
+    virtual bool   has_pedigree()             { return false; }
+    virtual size_t pair_count()         const { return my_has_pair ? 1 : 0; }
+
+    virtual const id_pair get_pair(size_t i) const { return id_pair(NULL, NULL); }
+    virtual id_pair       get_pair(size_t i)       { return id_pair(NULL, NULL); }
+
+    virtual const id_pair get_pair(const string& ped, const string& i1,
+                                   const string& i2, error_t& e) const
+    {
+      e = (i1.empty() && i2.empty()) ? bad_ind_both : no_error;
+
+      return id_pair(NULL, NULL);
+    }
+
+    virtual id_pair get_pair(const string& ped, const string& i1,
+                             const string& i2, error_t& e)
+    {
+      e = (i1.empty() && i2.empty()) ? bad_ind_both : no_error;
+
+      if(e == no_error)
+      {
+        my_next_ped = ped;
+        my_next_i1  = i1;
+        my_next_i2  = i2;
+      }
+
+      return id_pair(NULL, NULL);
+    }
+
+    virtual bool get_pair(size_t i, string& ped, string& i1, string& i2) const
+    {
+      if(i >= pair_count()) return false;
+
+      ped = my_ped;
+      i1  = my_i1;
+      i2  = my_i2;
+
+      return true;
+    }
+
+    virtual bool   use_pair(size_t i)                               const { return i < pair_count(); }
+    virtual bool   use_pair(const mem_pointer, const mem_pointer)   const { return true; }
+    virtual bool   valid_pair(size_t i)                             const { return i < pair_count(); }
+    virtual bool   invalidate_pair(size_t i)                        const { return false; }
+    virtual size_t pair_index(const mem_pointer, const mem_pointer) const { return pair_count(); }
+
+    virtual size_t add_pair(mem_pointer, mem_pointer, pair_type)
+    {
+      flush();
+
+      my_ped      = my_next_ped;
+      my_i1       = my_next_i1;
+      my_i2       = my_next_i2;
+      my_has_pair = true;
+      my_built    = true;
+
+      my_values.assign(3 * marker_count(), QNAN);
+
+      return 0;
+    }
+
+    virtual bool set_ibd(size_t i, size_t m, double f0, double f2)
+    {
+      return set_ibd(i, m, f0, QNAN, f2);
+    }
+
+    virtual bool set_ibd(size_t i, size_t m, double f0, double f1, double f2)
+    {
+      if(i >= pair_count() || m >= marker_count()) return false;
+
+      my_values[3*m]   = f0;
+      my_values[3*m+1] = f1;
+      my_values[3*m+2] = f2;
+
+      return true;
+    }
+
+    virtual bool set_ibd(size_t, const vector<double>&, const vector<double>&)                        { return false; }
+    virtual bool set_ibd(size_t, const vector<double>&, const vector<double>&, const vector<double>&) { return false; }
+
+    virtual bool get_ibd(size_t i, size_t m, double& f0, double& f2) const
+    {
+      double f1;
+
+      return get_ibd(i, m, f0, f1, f2);
+    }
+
+    virtual bool get_ibd(size_t i, size_t m, double& f0, double& f1, double& f2) const
+    {
+      if(i >= pair_count() || m >= marker_count()) return false;
+
+      f0 = my_values[3*m];
+      f1 = my_values[3*m+1];
+      f2 = my_values[3*m+2];
+
+      return true;
+    }
+
+    virtual bool get_ibd(size_t, vector<double>&, vector<double>&)                  const { return false; }
+    virtual bool get_ibd(size_t, vector<double>&, vector<double>&, vector<double>&) const { return false; }
+
+    virtual sped_pointer       get_subped(size_t) const { return NULL; }
+    virtual sped_pointer       get_subped(size_t)       { return NULL; }
+
+    virtual bool set_ibd_state(size_t, const a_marker_ibd_state&)          { return false; }
+    virtual bool get_ibd_state(size_t,       a_marker_ibd_state&)    const { return false; }
+    virtual bool set_ibd_state(const sped_pointer, const ibd_state_info&)  { return false; }
+    virtual bool get_ibd_state(const sped_pointer,       ibd_state_info&) const { return false; }
+
+  private:
+
+    RefIBDWriteBinaryFile& my_output;
+
+    string         my_next_ped, my_next_i1, my_next_i2;
+    string         my_ped,      my_i1,      my_i2;
+    vector<double> my_values;
+
+    bool           my_built;         // Set by the first pair; no more markers
+    bool           my_has_pair;
+    bool           my_header_written;
+    bool           my_ok;
+};
+
+int main(int argc, char* argv[])
+{
+  if(argc != 3)
+  {
+    cerr << "usage: " << argv[0] << " input_file output_file" << endl << endl
+         << "Converts an IBD probability file from text to binary format, or from" << endl
+         << "binary to text format, according to the format of the input file." << endl;
+
+    return 1;
+  }
+
+  string input  = argv[1];
+  string output = argv[2];
+
+  if(mapped_storage_ibd::is_binary_ibd_file(input))
+  {
+    mapped_storage_ibd source;
+
+    if(!source.open(input))
+    {
+      cerr << "IBD file input [" << input << "] " << source.error() << endl;
+
+      return 1;
+    }
+
+    RefIBDWriteFile out(output, cerr);
+
+    if(!out || !out.output_probability_header(&source) || !out.output_ibd_probability(&source))
+      return 1;
+
+    cout << "Wrote " << source.pair_count() << " pairs at " << source.marker_count()
+         << " markers to text file '" << output << "'." << endl;
+  }
+  else
+  {
+    RefIBDWriteBinaryFile out(output, cerr);
+
+    if(!out) return 1;
+
+    streaming_text_ibd  ibd(out);
+    RefIBDReadFileStdIO reader(cerr);
+
+    reader.set_require_pedigree(false);
+
+    if(!reader.input(input, &ibd) || !ibd.flush() || !out.close())
+      return 1;
+
+    mapped_storage_ibd check(output);
+
+    cout << "Wrote " << check.pair_count() << " pairs at " << check.marker_count()
+         << " markers to binary file '" << output << "'." << endl;
+  }
+
+  return 0;
+}
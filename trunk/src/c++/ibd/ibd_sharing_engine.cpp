@@ -0,0 +1,328 @@
+//==========================================================================
+//  File:      ibd_sharing_engine.cpp
+//
+//  Purpose:   Accumulation of pairwise IBD sharing probabilities over all
+//             the equivalence classes of a likelihood vector.
+//
+//  Copyright (c) 2026 R.C. Elston
+//    All Rights Reserved
+//==========================================================================
+
+#include "ibd/ibd_sharing_engine.h"
+
+namespace SAGE {
+
+namespace {
+
+typedef uint64_t block_mask;
+
+const block_mask all_classes = ~(block_mask) 0;
+
+// For meiosis bits 0 to 5, the classes of a block in which the bit is set.
+const block_mask low_bit_patterns[6] =
+{
+  0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+  0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+// Index of the lowest set bit.  Precondition:  m != 0
+inline size_t lowest_bit(block_mask m)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(m);
+#else
+  size_t c = 0;
+
+  for( ; !(m & 1); m >>= 1 )
+    ++c;
+
+  return c;
+#endif
+}
+
+// Adds the likelihood of each class set in m to sum, in class order.
+inline void add_classes(double& sum, block_mask m, const lvector::const_iterator& w)
+{
+  for( ; m; m &= m - 1 )
+    sum += w[lowest_bit(m)];
+}
+
+}
+
+ibd_sharing_engine::ibd_sharing_engine()
+  : my_member_count(0), my_label_bits(0), my_subpedigree(NULL), my_x_linked(false)
+{ }
+
+ibd_sharing_engine::ibd_sharing_engine(const meiosis_map& mm)
+  : my_member_count(0), my_label_bits(0), my_subpedigree(NULL), my_x_linked(false)
+{
+  compile(mm);
+}
+
+bool
+ibd_sharing_engine::compiled_for(const meiosis_map& mm) const
+{
+  if(    !my_subpedigree
+      || mm.get_subpedigree() != my_subpedigree
+      || mm.is_x_linked()     != my_x_linked )
+    return false;
+
+  for( size_t i = 0; i < my_member_count; ++i )
+    if(    mm.mother_meiosis(i) != my_meioses[2*i]
+        || mm.father_meiosis(i) != my_meioses[2*i+1] )
+      return false;
+
+  return true;
+}
+
+void
+ibd_sharing_engine::compile(const meiosis_map& mm)
+{
+  my_member_count = mm.get_subpedigree()->member_count();
+
+  my_subpedigree = mm.get_subpedigree();
+  my_x_linked    = mm.is_x_linked();
+
+  my_meioses.resize(2 * my_member_count);
+
+  for( size_t i = 0; i < my_member_count; ++i )
+  {
+    my_meioses[2*i]   = mm.mother_meiosis(i);
+    my_meioses[2*i+1] = mm.father_meiosis(i);
+  }
+
+  my_label_bits = 1;
+
+  while( ((size_t) 1 << my_label_bits) < 2 * my_member_count )
+    ++my_label_bits;
+
+  my_descent.resize(0);
+  my_pairs.resize(0);
+
+  // The descent program follows descent_graph::move_to().
+
+  for( size_t i = 0; i < my_member_count; ++i )
+  {
+    meiosis_map::size_type mloc = mm.mother_index(i);
+
+    if( mloc == (meiosis_map::index) -1 )
+      continue;
+
+    meiosis_map::size_type floc = mm.father_index(i);
+
+    meiosis_map::index mmei = mm.mother_meiosis(i);
+    meiosis_map::index fmei = mm.father_meiosis(i);
+
+    descent_step m = { 2*i,   2*mloc, 2*mloc+1, -1 };
+    descent_step f = { 2*i+1, 2*floc, 2*floc+1, -1 };
+
+    if( mmei >= meiosis_map::meiosis_bits )
+      m.bit = mmei - meiosis_map::meiosis_bits;
+
+    if( fmei >= meiosis_map::meiosis_bits )
+      f.bit = fmei - meiosis_map::meiosis_bits;
+
+    my_descent.push_back(m);
+    my_descent.push_back(f);
+  }
+
+  // The pair table follows ibd_analysis::compute() as it was written for the
+  // descent graph walk.
+
+  for( size_t j = 0; j + 1 < my_member_count; ++j )
+  {
+    for( size_t k = j+1; k < my_member_count; ++k )
+    {
+      meiosis_map::member_const_pointer mj = mm.member(j);
+      meiosis_map::member_const_pointer mk = mm.member(k);
+
+      bool bb = mm.is_x_linked() && is_brother_brother(mj, mk);
+
+      pair_entry p;
+
+      p.j            = j;
+      p.k            = k;
+      p.decrement    = bb;
+      p.sib_pair     = false;
+      p.mother_split = false;
+      p.father_split = false;
+
+      if( is_fsib(mj, mk) )
+      {
+        p.sib_pair     = true;
+        p.mother_split = true;
+        p.father_split = !bb;
+      }
+      else if( is_hsib(mj, mk) )
+      {
+        p.sib_pair     = true;
+        p.mother_split = is_maternal_hsib(mj, mk);
+        p.father_split = is_paternal_hsib(mj, mk) && !bb;
+      }
+
+      my_pairs.push_back(p);
+    }
+  }
+}
+
+inline ibd_sharing_engine::block_mask
+ibd_sharing_engine::select_mask(const descent_step& step, size_t first) const
+{
+  if( step.bit < 0 )
+    return 0;
+
+  if( step.bit < 6 )
+    return low_bit_patterns[step.bit];
+
+  return ((first >> step.bit) & 1) ? all_classes : 0;
+}
+
+void
+ibd_sharing_engine::accumulate(const lvector&      mkr,
+                               sharing_sums&       sums,
+                               a_marker_ibd_state* states,
+                               double              total) const
+{
+  const size_t B = block_size;
+  const size_t L = my_label_bits;
+  const size_t P = my_pairs.size();
+
+  sums.share0    .resize(0); sums.share0    .resize(P, 0.0);
+  sums.share2    .resize(0); sums.share2    .resize(P, 0.0);
+  sums.sib_share0.resize(0); sums.sib_share0.resize(P, 0.0);
+  sums.sib_share2.resize(0); sums.sib_share2.resize(P, 0.0);
+
+  if( !P && !states )
+    return;
+
+  // labels[a*L + b] is bit b of the founder allele carried by allele a, in
+  // each class of the block.  Founder alleles never change.
+
+  vector<block_mask> labels(2 * my_member_count * L);
+
+  for( size_t a = 0; a < 2 * my_member_count; ++a )
+    for( size_t b = 0; b < L; ++b )
+      labels[a * L + b] = ((a >> b) & 1) ? all_classes : 0;
+
+  // With states, the classes of the block in which each pair is in states
+  // 1 to 4, by pair.
+
+  vector<block_mask> state_masks(states ? 4 * P : 0);
+
+  const size_t                  class_count = mkr.size();
+  const lvector::const_iterator values      = mkr.begin();
+
+  for( size_t first = 0; first < class_count; first += B )
+  {
+    const size_t count = min(B, class_count - first);
+
+    const lvector::const_iterator w = values + first;
+
+    // The classes with nonzero likelihood.  For many pedigrees and markers,
+    // most blocks have none.
+
+    block_mask nonzero = 0;
+
+    for( size_t c = 0; c < count; ++c )
+      nonzero |= (block_mask) (w[c] != 0.0) << c;
+
+    if( !nonzero )
+      continue;
+
+    for( size_t d = 0; d < my_descent.size(); ++d )
+    {
+      const descent_step& step = my_descent[d];
+
+      block_mask        sel = select_mask(step, first);
+      block_mask*       l   = &labels[step.allele * L];
+      const block_mask* l1  = &labels[step.first  * L];
+      const block_mask* l2  = &labels[step.second * L];
+
+      for( size_t b = 0; b < L; ++b )
+        l[b] = (l2[b] & sel) | (l1[b] & ~sel);
+    }
+
+    for( size_t s = 0; s < P; ++s )
+    {
+      const pair_entry& p = my_pairs[s];
+
+      const block_mask* jm = &labels[(2 * p.j)     * L];
+      const block_mask* jf = &labels[(2 * p.j + 1) * L];
+      const block_mask* km = &labels[(2 * p.k)     * L];
+      const block_mask* kf = &labels[(2 * p.k + 1) * L];
+
+      // The classes in which each of the four allele pairs differ.
+
+      block_mask m_diff = 0, f_diff = 0, x1_diff = 0, x2_diff = 0;
+
+      for( size_t b = 0; b < L; ++b )
+      {
+        m_diff  |= jm[b] ^ km[b];
+        f_diff  |= jf[b] ^ kf[b];
+        x1_diff |= jf[b] ^ km[b];
+        x2_diff |= jm[b] ^ kf[b];
+      }
+
+      block_mask m = ~m_diff, f = ~f_diff, x1 = ~x1_diff, x2 = ~x2_diff;
+
+      // The number of identical allele pairs, 0 to 4, bit sliced.
+
+      block_mask t1 = m  ^ f,  c1 = m  & f;
+      block_mask t2 = x1 ^ x2, c2 = x1 & x2;
+      block_mask c3 = t1 & t2;
+
+      block_mask ones  = t1 ^ t2;
+      block_mask twos  = c1 ^ c2 ^ c3;
+      block_mask fours = (c1 & c2) | (c1 & c3) | (c2 & c3);
+
+      block_mask n0 = ~ones & ~twos & ~fours;
+      block_mask n1 =  ones & ~twos & ~fours;
+      block_mask n2 = ~ones &  twos & ~fours;
+      block_mask n3 =  ones &  twos & ~fours;
+
+      // X-linked brothers count one fewer; with none, they are not counted.
+
+      block_mask share0 = p.decrement ? n1 : n0;
+      block_mask share1 = p.decrement ? n2 : n1;
+      block_mask share2 = p.decrement ? n3 : n2;
+
+      block_mask sib0 = p.mother_split ? share1 & m : 0;
+      block_mask sib2 = p.father_split ? share1 & f : 0;
+
+      add_classes(sums.share0[s],     share0 & nonzero, w);
+      add_classes(sums.share2[s],     share2 & nonzero, w);
+      add_classes(sums.sib_share0[s], sib0   & nonzero, w);
+      add_classes(sums.sib_share2[s], sib2   & nonzero, w);
+
+      if( states )
+      {
+        state_masks[4*s]     = p.sib_pair ? 0 : share1;
+        state_masks[4*s + 1] = share2;
+        state_masks[4*s + 2] = sib0;
+        state_masks[4*s + 3] = sib2;
+      }
+    }
+
+    if( !states )
+      continue;
+
+    for( block_mask c_mask = nonzero; c_mask; c_mask &= c_mask - 1 )
+    {
+      size_t c = lowest_bit(c_mask);
+
+      vector<size_t> a_state(P, 0);
+
+      // A later state overrides an earlier one, as in the descent graph
+      // walk, where a sib pair sharing both parents' alleles is state 4.
+
+      for( size_t s = 0; s < P; ++s )
+        for( size_t t = 0; t < 4; ++t )
+          if( (state_masks[4*s + t] >> c) & 1 )
+            a_state[s] = t + 1;
+
+      states->push_back(make_pair(w[c] / total, a_state));
+    }
+  }
+}
+
+} // end of namespace SAGE
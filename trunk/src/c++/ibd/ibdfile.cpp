@@ -17,6 +17,7 @@
 //   at a set of loci.
 //
 
+#include <cstring>
 #include "ibd/ibdfile.h"
 
 using namespace std;
@@ -56,6 +57,19 @@ RefIBDReadFileStdIO::input(const std::string &fname, IBD *ibd)
 {
   reset(fname);
 
+  if( mapped_storage_ibd::is_binary_ibd_file(fname) )
+  {
+    mapped_storage_ibd source;
+
+    if( !source.open(fname) )
+    {
+      read_error(source.error());
+      return false;
+    }
+
+    return do_input_binary(source, ibd);
+  }
+
   FILE *file = fopen(fname.c_str(), "r");
 
   if(!file || ferror(file) || feof(file) )
@@ -164,90 +178,10 @@ RefIBDReadFileStdIO::do_input(FILE *file, IBD *ibd)
       continue;
     }
 
-    IBD::error_t err;
-    id_pair p;
-
-    if( ibd->has_pedigree(ped_name) )
-    {
-      p = ibd->get_pair(ped_name, ind1_name, ind2_name, err);
-
-      if( err != IBD::no_error )
-      {
-        switch( err )
-        {
-          case IBD::bad_pedigree:
-            read_error("cannot find pedigree '" + ped_name + "'");
-            break;
-          case IBD::bad_ind1:
-            read_error("member id '" + ind1_name + "'"
-                     + " in pedigree '" + ped_name + "' was not found");
-            break;
-          case IBD::bad_ind2:
-            read_error("member id '" + ind2_name + "'"
-                     + " in pedigree '" + ped_name + "' was not found");
-            break;
-          case IBD::bad_ind_both:
-            read_error("member ids ('" + ind1_name + "','" + ind2_name
-                      + "') in pedigree '" + ped_name + "' was not found");
-            break;
-          default:
-            read_error("unknown error finding member ids ('" + ind1_name
-                     + "','" + ind2_name + "') in pedigree '" + ped_name + "'");
-            break;
-        }
-
-        continue;
-      }
-
-      if( require_pedigree() )
-      {
-        if( p.first == NULL && p.second == NULL )
-        {
-          read_error("Internal error.  Members ('" + ind1_name + "','"
-              + ind2_name + "') in pedigree '" + ped_name + "' are invalid");
-          continue;
-        }
-
-        if( p.first == NULL )
-        {
-           read_error("Internal error.  Member '" + ind1_name + "'"
-                    + " in pedigree '" + ped_name + "' is invalid");
-           continue;
-        }
-
-        if( p.second == NULL )
-        {
-           read_error("Internal error.  Member '" + ind2_name + "'"
-                    + " in pedigree '" + ped_name + "' is invalid");
-           continue;
-        }
-      }
-    }
-    else
-    {
-      read_error("Pair skipped: Invalid pedigree name '" + ped_name + "'.");
-      continue;
-    }
-
-    // Skip pairs that will not be used for analysis
-    if( skip_unused_pairs() && !ibd->use_pair(p.first, p.second) )
-    {
-      //read_error("Pair skipped since it won't be used.");
-      continue;
-    }
-
-    size_t pair_num = ibd->add_pair( p.first, p.second );
+    size_t pair_num = add_named_pair(ibd, ped_name, ind1_name, ind2_name);
 
     if( pair_num == (size_t)-1 )
-    {
-      if( warn_invalid_pairs() )
-      {
-        read_error("Warning: Members ('" + ind1_name + "','"
-                 + ind2_name + "') in pedigree '" + ped_name
-                 + "' cannot be used.");
-      }
       continue;
-    }
 
     size_t m;
     for( m = 0; i != end && m < markers.size(); ++m )
@@ -301,6 +235,91 @@ RefIBDReadFileStdIO::do_input(FILE *file, IBD *ibd)
   return true;
 }
 
+bool
+RefIBDReadFileStdIO::do_input_binary(const mapped_storage_ibd &source, IBD *ibd)
+{
+  if(!ibd)
+  {
+    read_error("Invalid IBD storage");
+    return false;
+  }
+
+  ibd_option_type ibd_option = source.get_ibd_option();
+
+  ibd->set_ibd_option(ibd_option);
+
+  // Markers are named as read_header() names them in the text file, so
+  // that a binary file and its text equivalent are interchangeable.
+  map<string, size_t> name_count;
+
+  for( size_t m = 0; m < source.marker_count(); ++m )
+    ++name_count[source.marker_name(m)];
+
+  vector<size_t> markers;
+
+  for( size_t m = 0; m < source.marker_count(); ++m )
+  {
+    const ibd_marker_info& info = source.get_marker_info(m);
+
+    string m_name = info.name;
+
+    if( name_count[m_name] > 1 )
+      m_name = m_name + "_" + doub2str(info.distance, 0, 1, ios::showpoint | ios::fixed);
+
+    size_t mi = ibd->marker_index(m_name);
+
+    if( mi >= ibd->marker_count() )
+    {
+      gmodel_type m_type = info.type;
+      if( ibd_option.x_linked )
+        m_type = MLOCUS::X_LINKED;
+
+      mi = ibd->add_marker(m_name, info.distance, m_type);
+    }
+
+    markers.push_back(mi);
+  }
+
+  // Pairs.  The file's pairs are written a pedigree at a time, so each
+  // pedigree is looked up once, and every pair's number in the storage is
+  // found before any values are copied.  There is no line structure, so
+  // errors are reported by pair number.
+  size_t pair_count = source.pair_count();
+
+  vector<size_t> pairs(pair_count, (size_t)-1);
+
+  for( size_t first = 0, last = 0; first < pair_count; first = last )
+  {
+    const char* ped = source.pedigree_name(first);
+
+    for( last = first + 1; last < pair_count && !strcmp(source.pedigree_name(last), ped); ++last ) { }
+
+    string ped_name     = ped;
+    bool   has_pedigree = ibd->has_pedigree(ped_name);
+
+    for( size_t i = first; i < last; ++i )
+    {
+      my_line = i + 1;
+
+      if( !has_pedigree )
+      {
+        read_error("Pair skipped: Invalid pedigree name '" + ped_name + "'.");
+        continue;
+      }
+
+      pairs[i] = add_pedigree_pair(ibd, ped_name, source.ind1_name(i), source.ind2_name(i));
+    }
+  }
+
+  // The values are then copied straight from the file.
+  my_line = 0;
+
+  if( !ibd->copy_ibd(source, markers, pairs) )
+    read_error("Error setting IBD values.");
+
+  return true;
+}
+
 bool
 RefIBDReadFileStdIO::do_input_ibd_state(FILE *file, IBD *ibd)
 {
@@ -709,6 +728,103 @@ RefIBDReadFileStdIO::read_ibd_option(FILE *file, std::string &line, ibd_option_t
   return true;
 }
 
+size_t
+RefIBDReadFileStdIO::add_named_pair(IBD *ibd, const std::string &ped_name,
+                                    const std::string &ind1_name,
+                                    const std::string &ind2_name)
+{
+  if( !ibd->has_pedigree(ped_name) )
+  {
+    read_error("Pair skipped: Invalid pedigree name '" + ped_name + "'.");
+    return (size_t)-1;
+  }
+
+  return add_pedigree_pair(ibd, ped_name, ind1_name, ind2_name);
+}
+
+size_t
+RefIBDReadFileStdIO::add_pedigree_pair(IBD *ibd, const std::string &ped_name,
+                                       const std::string &ind1_name,
+                                       const std::string &ind2_name)
+{
+  IBD::error_t err;
+
+  id_pair p = ibd->get_pair(ped_name, ind1_name, ind2_name, err);
+
+  if( err != IBD::no_error )
+  {
+    switch( err )
+    {
+      case IBD::bad_pedigree:
+        read_error("cannot find pedigree '" + ped_name + "'");
+        break;
+      case IBD::bad_ind1:
+        read_error("member id '" + ind1_name + "'"
+                 + " in pedigree '" + ped_name + "' was not found");
+        break;
+      case IBD::bad_ind2:
+        read_error("member id '" + ind2_name + "'"
+                 + " in pedigree '" + ped_name + "' was not found");
+        break;
+      case IBD::bad_ind_both:
+        read_error("member ids ('" + ind1_name + "','" + ind2_name
+                  + "') in pedigree '" + ped_name + "' was not found");
+        break;
+      default:
+        read_error("unknown error finding member ids ('" + ind1_name
+                 + "','" + ind2_name + "') in pedigree '" + ped_name + "'");
+        break;
+    }
+
+    return (size_t)-1;
+  }
+
+  if( require_pedigree() )
+  {
+    if( p.first == NULL && p.second == NULL )
+    {
+      read_error("Internal error.  Members ('" + ind1_name + "','"
+          + ind2_name + "') in pedigree '" + ped_name + "' are invalid");
+      return (size_t)-1;
+    }
+
+    if( p.first == NULL )
+    {
+       read_error("Internal error.  Member '" + ind1_name + "'"
+                + " in pedigree '" + ped_name + "' is invalid");
+       return (size_t)-1;
+    }
+
+    if( p.second == NULL )
+    {
+       read_error("Internal error.  Member '" + ind2_name + "'"
+                + " in pedigree '" + ped_name + "' is invalid");
+       return (size_t)-1;
+    }
+  }
+
+  // Skip pairs that will not be used for analysis
+  if( skip_unused_pairs() && !ibd->use_pair(p.first, p.second) )
+  {
+    //read_error("Pair skipped since it won't be used.");
+    return (size_t)-1;
+  }
+
+  size_t pair_num = ibd->add_pair( p.first, p.second );
+
+  if( pair_num == (size_t)-1 )
+  {
+    if( warn_invalid_pairs() )
+    {
+      read_error("Warning: Members ('" + ind1_name + "','"
+               + ind2_name + "') in pedigree '" + ped_name
+               + "' cannot be used.");
+    }
+  }
+
+  return pair_num;
+}
+
 bool
 RefIBDReadFileStdIO::read_pair_ids(string_tokenizer::iterator &tok, 
                                    string_tokenizer::iterator &end,
@@ -1314,4 +1430,291 @@ RefIBDWriteFile::output_header_info(const IBD *ibd)
   return;
 }
 
+//
+// -------------------------------------------------------------------------
+//
+
+RefIBDWriteBinaryFile::RefIBDWriteBinaryFile(const std::string &fname,
+                                             std::ostream &output_messages)
+  : messages(output_messages),
+    filename(fname.size() ? fname : string("unknown file")),
+    scratch_name(filename + ".tmp"),
+    my_scratch(NULL),
+    my_header_written(false)
+{
+  my_scratch = fopen(scratch_name.c_str(), "w+b");
+
+  if( !my_scratch )
+    write_error("Cannot write to filename '" + scratch_name + "'.");
+}
+
+RefIBDWriteBinaryFile::~RefIBDWriteBinaryFile()
+{
+  close();
+}
+
+bool
+RefIBDWriteBinaryFile::output_probability_header(const IBD *ibd)
+{
+  if( !my_scratch )
+  {
+    write_error("Cannot write to filename '" + filename + "'.");
+    return false;
+  }
+
+  if( !is_valid_ibd(ibd) )
+    return false;
+
+  my_ibd_option = ibd->get_ibd_option();
+
+  my_markers.resize(0);
+
+  for( size_t k = 0; k < ibd->marker_count(); ++k )
+  {
+    const ibd_marker_info& info = ibd->get_marker_info(k);
+
+    my_markers.push_back(ibd_marker_info(ibd->marker_name(k), info.distance, info.type));
+  }
+
+  my_header_written = true;
+
+  return true;
+}
+
+bool
+RefIBDWriteBinaryFile::output_ibd_probability(const IBD *ibd)
+{
+  if( !my_scratch )
+  {
+    write_error("Cannot write to filename '" + filename + "'.");
+    return false;
+  }
+
+  if( !is_valid_ibd(ibd) )
+    return false;
+
+  if( !my_header_written || my_markers.size() != ibd->marker_count() )
+  {
+    write_error("Cannot output different set of markers to IBD file");
+    return false;
+  }
+
+  // Each pair is written to the scratch file as a row of (f0, f1mp, f2)
+  // triples, one per marker.
+  vector<double> row(3 * my_markers.size());
+
+  for( size_t i = 0; i < ibd->pair_count(); ++i )
+  {
+    std::string ped_name;
+    std::string ind1_name;
+    std::string ind2_name;
+
+    if( !ibd->get_pair(i, ped_name, ind1_name, ind2_name) )
+    {
+      // Warn pair skipped?
+      continue;
+    }
+
+    // A failed lookup is stored as missing, rather than leaving the
+    // previous pair's values in the row.
+    for( size_t k = 0; k < my_markers.size(); ++k )
+      if( !ibd->get_ibd(i, k, row[3*k], row[3*k+1], row[3*k+2]) )
+        row[3*k] = row[3*k+1] = row[3*k+2] = QNAN;
+
+    if( fwrite(&row[0], sizeof(double), row.size(), my_scratch) != row.size() )
+    {
+      write_error("Error writing to filename '" + scratch_name + "'.");
+      return false;
+    }
+
+    binary_ibd_pair p;
+
+    p.pedigree = add_string(ped_name);
+    p.ind1     = add_string(ind1_name);
+    p.ind2     = add_string(ind2_name);
+
+    my_pairs.push_back(p);
+  }
+
+  return true;
+}
+
+bool
+RefIBDWriteBinaryFile::close()
+{
+  if( !my_scratch )
+    return false;
+
+  bool ok = my_header_written && write_file();
+
+  fclose(my_scratch);
+  my_scratch = NULL;
+
+  remove(scratch_name.c_str());
+
+  return ok;
+}
+
+bool
+RefIBDWriteBinaryFile::is_valid_ibd(const IBD *ibd)
+{
+  if( !ibd )
+  {
+    write_error("NULL IBD data structure");
+    return false;
+  }
+
+  if( !ibd->built() )
+  {
+    write_error("Cannot create IBD file");
+    return false;
+  }
+
+  if( !ibd->marker_count() )
+  {
+    write_error("No markers to output");
+    return false;
+  }
+
+  if( !ibd->pair_count() )
+  {
+    write_error("No pairs to output");
+    return false;
+  }
+
+  return true;
+}
+
+uint64_t
+RefIBDWriteBinaryFile::add_string(const std::string &s)
+{
+  std::map<std::string, uint64_t>::const_iterator i = my_string_index.find(s);
+
+  if( i != my_string_index.end() )
+    return i->second;
+
+  uint64_t offset = my_strings.size();
+
+  my_strings += s;
+  my_strings += '\0';
+
+  my_string_index[s] = offset;
+
+  return offset;
+}
+
+bool
+RefIBDWriteBinaryFile::write_file()
+{
+  const size_t marker_count = my_markers.size();
+  const size_t pair_count   = my_pairs.size();
+
+  binary_ibd_header header;
+
+  memset(&header, 0, sizeof(header));
+
+  memcpy(header.signature, binary_ibd_header::file_signature, sizeof(header.signature));
+
+  header.version      = binary_ibd_header::current_version;
+  header.byte_order   = binary_ibd_header::byte_order_mark;
+  header.marker_count = marker_count;
+  header.pair_count   = pair_count;
+
+  binary_ibd_options& o = header.options;
+
+  o.title           = add_string(my_ibd_option.title);
+  o.region          = add_string(my_ibd_option.region);
+  o.max_pedigree    = add_string(my_ibd_option.max_pedigree);
+  o.scan_type       = add_string(my_ibd_option.scan_type);
+  o.allow_loops     = add_string(my_ibd_option.allow_loops);
+  o.ibd_mode        = add_string(my_ibd_option.ibd_mode);
+  o.split_pedigrees = add_string(my_ibd_option.split_pedigrees);
+  o.use_simulation  = add_string(my_ibd_option.use_simulation);
+
+  if( my_ibd_option.exact )         o.flags |= binary_ibd_options::exact;
+  if( my_ibd_option.x_linked )      o.flags |= binary_ibd_options::x_linked;
+  if( my_ibd_option.ibd_state_out ) o.flags |= binary_ibd_options::ibd_state_out;
+
+  vector<binary_ibd_marker> markers(marker_count);
+
+  for( size_t k = 0; k < marker_count; ++k )
+  {
+    memset(&markers[k], 0, sizeof(binary_ibd_marker));
+
+    markers[k].name     = add_string(my_markers[k].name);
+    markers[k].distance = my_markers[k].distance;
+    markers[k].type     = my_markers[k].type;
+  }
+
+  // Lay out the sections.  The data is aligned for direct use as doubles.
+  header.markers_offset = sizeof(binary_ibd_header);
+  header.pairs_offset   = header.markers_offset + marker_count * sizeof(binary_ibd_marker);
+  header.strings_offset = header.pairs_offset   + pair_count   * sizeof(binary_ibd_pair);
+  header.strings_size   = my_strings.size();
+  header.data_offset    = (header.strings_offset + header.strings_size + 7) / 8 * 8;
+
+  FILE *out = fopen(filename.c_str(), "wb");
+
+  if( !out )
+  {
+    write_error("Cannot write to filename '" + filename + "'.");
+    return false;
+  }
+
+  static const char padding[8] = { 0 };
+
+  bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+
+  if( ok && marker_count )
+    ok = fwrite(&markers[0], sizeof(binary_ibd_marker), marker_count, out) == marker_count;
+
+  if( ok && pair_count )
+    ok = fwrite(&my_pairs[0], sizeof(binary_ibd_pair), pair_count, out) == pair_count;
+
+  if( ok )
+    ok =    fwrite(my_strings.data(), 1, my_strings.size(), out) == my_strings.size()
+         && fwrite(padding, 1, header.data_offset - header.strings_offset - header.strings_size, out)
+              == header.data_offset - header.strings_offset - header.strings_size;
+
+  // Transpose the scratch rows into columns.  Each pass reads the whole
+  // scratch file and fills the columns of as many markers as fit in the
+  // buffer, so memory use is bounded however large the file is.
+  const size_t buffer_size = (64 << 20) / sizeof(double);
+  const size_t row_size    = 3 * marker_count;
+  const size_t chunk       = std::max((size_t) 1, buffer_size / std::max((size_t) 1, 3 * pair_count));
+
+  vector<double> row(row_size);
+  vector<double> columns;
+
+  for( size_t m0 = 0; ok && pair_count && m0 < marker_count; m0 += chunk )
+  {
+    size_t m1 = std::min(marker_count, m0 + chunk);
+
+    columns.resize(3 * (m1 - m0) * pair_count);
+
+    ok = fflush(my_scratch) == 0 && fseek(my_scratch, 0, SEEK_SET) == 0;
+
+    for( size_t i = 0; ok && i < pair_count; ++i )
+    {
+      ok = fread(&row[0], sizeof(double), row_size, my_scratch) == row_size;
+
+      for( size_t c = 3 * m0; c < 3 * m1; ++c )
+        columns[(c - 3 * m0) * pair_count + i] = row[c];
+    }
+
+    if( ok )
+      ok = fwrite(&columns[0], sizeof(double), columns.size(), out) == columns.size();
+  }
+
+  ok = (fclose(out) == 0) && ok;
+
+  if( !ok )
+  {
+    write_error("Error writing to filename '" + filename + "'.");
+    remove(filename.c_str());
+  }
+
+  return ok;
+}
+
 }
@@ -0,0 +1,283 @@
+//==========================================================================
+//  Binary IBD sharing file -- read-only, memory mapped IBD storage
+//
+//  Copyright (c) 2026  R.C. Elston
+//==========================================================================
+
+#include <cstdio>
+#include <cstring>
+#include "ibd/mapped_storage_ibd.h"
+
+#if !defined(WIN32)
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace SAGE {
+
+// The signature is chosen so that text mode translation, 7-bit transfers
+// and truncation are all detected, and so that it can never be mistaken
+// for the start of a text IBD file.
+const char binary_ibd_header::file_signature[8] = { '\211', 'I', 'B', 'D', '\r', '\n', '\032', '\n' };
+
+mapped_storage_ibd::mapped_storage_ibd()
+  : my_base(NULL), my_size(0), my_header(NULL), my_pairs(NULL),
+    my_strings(NULL), my_data(NULL), my_pair_count(0)
+{ }
+
+mapped_storage_ibd::mapped_storage_ibd(const std::string& fname)
+  : my_base(NULL), my_size(0), my_header(NULL), my_pairs(NULL),
+    my_strings(NULL), my_data(NULL), my_pair_count(0)
+{
+  open(fname);
+}
+
+mapped_storage_ibd::~mapped_storage_ibd()
+{
+  close();
+}
+
+bool
+mapped_storage_ibd::is_binary_ibd_file(const std::string& fname)
+{
+  FILE* file = fopen(fname.c_str(), "rb");
+
+  if(!file) return false;
+
+  char sig[sizeof(binary_ibd_header::file_signature)];
+
+  bool ok = fread(sig, 1, sizeof(sig), file) == sizeof(sig)
+         && !memcmp(sig, binary_ibd_header::file_signature, sizeof(sig));
+
+  fclose(file);
+
+  return ok;
+}
+
+bool
+mapped_storage_ibd::open(const std::string& fname)
+{
+  close();
+
+  my_error.clear();
+
+#if defined(WIN32)
+  FILE* file = fopen(fname.c_str(), "rb");
+
+  if(!file)
+    return fail("Cannot open filename '" + fname + "'.");
+
+  fseek(file, 0, SEEK_END);
+
+  long size = ftell(file);
+
+  fseek(file, 0, SEEK_SET);
+
+  if(size > 0)
+  {
+    my_buffer.resize(size);
+
+    if(fread(&my_buffer[0], 1, size, file) != (size_t) size)
+      my_buffer.clear();
+  }
+
+  fclose(file);
+
+  if(my_buffer.empty())
+    return fail("Cannot read filename '" + fname + "'.");
+
+  my_base = &my_buffer[0];
+  my_size = my_buffer.size();
+#else
+  int fd = ::open(fname.c_str(), O_RDONLY);
+
+  if(fd < 0)
+    return fail("Cannot open filename '" + fname + "'.");
+
+  struct stat st;
+
+  if(fstat(fd, &st) || st.st_size <= 0)
+  {
+    ::close(fd);
+    return fail("Cannot read filename '" + fname + "'.");
+  }
+
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  // The mapping holds its own reference to the file.
+  ::close(fd);
+
+  if(base == MAP_FAILED)
+    return fail("Cannot map filename '" + fname + "'.");
+
+  my_base = static_cast<const char*>(base);
+  my_size = st.st_size;
+#endif
+
+  if(!validate())
+    return false;
+
+  // The option and marker tables are small, and are copied so that the
+  // inherited IBD marker interface works unchanged.
+
+  const binary_ibd_options& o = my_header->options;
+
+  my_ibd_option.title           = string_at(o.title);
+  my_ibd_option.region          = string_at(o.region);
+  my_ibd_option.max_pedigree    = string_at(o.max_pedigree);
+  my_ibd_option.scan_type       = string_at(o.scan_type);
+  my_ibd_option.allow_loops     = string_at(o.allow_loops);
+  my_ibd_option.ibd_mode        = string_at(o.ibd_mode);
+  my_ibd_option.split_pedigrees = string_at(o.split_pedigrees);
+  my_ibd_option.use_simulation  = string_at(o.use_simulation);
+
+  my_ibd_option.exact           = o.flags & binary_ibd_options::exact;
+  my_ibd_option.x_linked        = o.flags & binary_ibd_options::x_linked;
+  my_ibd_option.ibd_state_out   = o.flags & binary_ibd_options::ibd_state_out;
+  my_ibd_option.old_ibd_format  = false;
+
+  const binary_ibd_marker* markers =
+      reinterpret_cast<const binary_ibd_marker*>(my_base + my_header->markers_offset);
+
+  my_markers.resize(0);
+
+  for(size_t m = 0; m < my_header->marker_count; ++m)
+    my_markers.push_back(ibd_marker_info(string_at(markers[m].name),
+                                         markers[m].distance,
+                                         (gmodel_type) markers[m].type));
+
+  return true;
+}
+
+void
+mapped_storage_ibd::close()
+{
+#if defined(WIN32)
+  my_buffer.clear();
+#else
+  if(my_base)
+    munmap(const_cast<char*>(my_base), my_size);
+#endif
+
+  my_base       = NULL;
+  my_size       = 0;
+  my_header     = NULL;
+  my_pairs      = NULL;
+  my_strings    = NULL;
+  my_data       = NULL;
+  my_pair_count = 0;
+
+  my_markers.resize(0);
+  my_ibd_option = ibd_option_type();
+}
+
+bool
+mapped_storage_ibd::fail(const std::string& message)
+{
+  close();
+
+  my_error = message;
+
+  return false;
+}
+
+bool
+mapped_storage_ibd::validate()
+{
+  if(my_size < sizeof(binary_ibd_header))
+    return fail("File is too short to be a binary IBD file.");
+
+  const binary_ibd_header* h = reinterpret_cast<const binary_ibd_header*>(my_base);
+
+  if(memcmp(h->signature, binary_ibd_header::file_signature, sizeof(h->signature)))
+    return fail("Invalid binary IBD file signature.");
+
+  if(h->byte_order != binary_ibd_header::byte_order_mark)
+    return fail("Binary IBD file was written on a machine of different byte order.");
+
+  if(h->version != binary_ibd_header::current_version)
+    return fail("Unsupported binary IBD file version.");
+
+  // Check that every section lies within the file.  The sizes are checked
+  // against the space available rather than computed, so that nonsense
+  // counts cannot overflow.
+
+  uint64_t size = my_size;
+
+  if(   h->markers_offset > size || h->pairs_offset > size
+     || h->strings_offset > size || h->data_offset  > size
+     || h->markers_offset % 8    || h->pairs_offset % 8 || h->data_offset % 8
+     || h->marker_count > (size - h->markers_offset) / sizeof(binary_ibd_marker)
+     || h->pair_count   > (size - h->pairs_offset)   / sizeof(binary_ibd_pair)
+     || h->strings_size > size - h->strings_offset
+     || !h->strings_size || my_base[h->strings_offset + h->strings_size - 1] != '\0')
+    return fail("Binary IBD file is corrupt or truncated.");
+
+  uint64_t columns = 3 * h->marker_count;
+
+  if(columns && h->pair_count > (size - h->data_offset) / sizeof(double) / columns)
+    return fail("Binary IBD file is corrupt or truncated.");
+
+  // All string references must be within the string table.
+
+  const binary_ibd_options& o = h->options;
+
+  bool strings_ok =    o.title        < h->strings_size && o.region          < h->strings_size
+                    && o.max_pedigree < h->strings_size && o.scan_type       < h->strings_size
+                    && o.allow_loops  < h->strings_size && o.ibd_mode        < h->strings_size
+                    && o.split_pedigrees < h->strings_size && o.use_simulation < h->strings_size;
+
+  const binary_ibd_marker* markers = reinterpret_cast<const binary_ibd_marker*>(my_base + h->markers_offset);
+  const binary_ibd_pair*   pairs   = reinterpret_cast<const binary_ibd_pair*>  (my_base + h->pairs_offset);
+
+  for(size_t m = 0; strings_ok && m < h->marker_count; ++m)
+    strings_ok = markers[m].name < h->strings_size;
+
+  for(size_t i = 0; strings_ok && i < h->pair_count; ++i)
+    strings_ok =    pairs[i].pedigree < h->strings_size
+                 && pairs[i].ind1     < h->strings_size
+                 && pairs[i].ind2     < h->strings_size;
+
+  if(!strings_ok)
+    return fail("Binary IBD file is corrupt or truncated.");
+
+  my_header     = h;
+  my_pairs      = pairs;
+  my_strings    = my_base + h->strings_offset;
+  my_data       = reinterpret_cast<const double*>(my_base + h->data_offset);
+  my_pair_count = h->pair_count;
+
+  return true;
+}
+
+// The default for storage which is not given the file's values directly.
+
+bool
+IBD::copy_ibd(const mapped_storage_ibd &source, const std::vector<size_t> &markers,
+              const std::vector<size_t> &pairs)
+{
+  for(size_t j = 0; j < pairs.size(); ++j)
+  {
+    if(pairs[j] == (size_t)-1)
+      continue;
+
+    for(size_t k = 0; k < markers.size(); ++k)
+    {
+      double f0 = source.f0_column  (k)[j];
+      double f1 = source.f1mp_column(k)[j];
+      double f2 = source.f2_column  (k)[j];
+
+      if(SAGE::isnan(f0) || SAGE::isnan(f2))
+        f0 = f1 = f2 = QNAN;
+
+      if(!set_ibd(pairs[j], markers[k], f0, f1, f2))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+} // end of namespace SAGE
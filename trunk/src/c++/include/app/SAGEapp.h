@@ -156,10 +156,30 @@ public:
     /// Parse command line.
     /// The commandline should follow the form:
     ///
-    /// [sage_app] [-v | -h | -?] [-@] [input file(s)...]
+    /// [sage_app] [-v | -h | -?] [-@] [--threads=N] [--snapshot=FILE] [input file(s)...]
     ///
+    /// --threads sets UTIL::ThreadPool::default_thread_count() for the
+    /// analyses that can run in parallel.  "--threads=auto" (or 0) uses
+    /// one thread per processor.
+    ///
+    /// --snapshot sets snapshot_file().
     int parse_params(const char *opts = "vh@");
 
+    ///
+    /// Parses the value of the --threads option.
+    void parse_thread_count(const std::string& value);
+
+    ///
+    /// Returns the snapshot file given with --snapshot, or an empty string.
+    /// Programs load their pedigree data from the snapshot file when it
+    /// holds an up to date copy, and add one to it otherwise (see
+    /// SAGE_Data::read_family_data_file()).
+    static const std::string& snapshot_file();
+
+    ///
+    /// Sets the snapshot file.
+    static void set_snapshot_file(const std::string& filename);
+
   //@}
 
   /// @name Flags for basic run mode options
@@ -226,6 +246,7 @@ protected:
 private:
 
   static std::string release_string;
+  static std::string snapshot_filename;
 
   int hlp;
   int dbg;
@@ -134,6 +134,15 @@ public:
     /// \param debug_on Indicates whether or not to include debugging information
     Output_Streams(const std::string& program_name, bool debug_on = false);
 
+    ///
+    /// Constructor for output whose screen isn't std::cout, such as that of
+    /// an analysis run concurrently with others.
+    /// \param program_name The name of the program
+    /// \param screen The stream to which the screen output is written
+    /// \param debug_on Indicates whether or not to include debugging information
+    Output_Streams(const std::string& program_name, std::ostream& screen,
+                   bool debug_on = false);
+
     ///
     /// Destructor
     ~Output_Streams();
@@ -180,8 +189,9 @@ private:
   
   void init_output_streams();
 
-  std::string  my_program_name;
-  bool         my_debug;
+  std::string    my_program_name;
+  bool           my_debug;
+  std::ostream&  my_screen;
 
   cerrormultistream my_screen_stream;
   cerrormultistream my_information_stream;
@@ -14,7 +14,14 @@ namespace APP  {
 
 inline
 Output_Streams::Output_Streams(const std::string& p, bool debug_on)
-  : my_program_name(p), my_debug(debug_on)
+  : my_program_name(p), my_debug(debug_on), my_screen(std::cout)
+{
+  init_output_streams();
+}
+
+inline
+Output_Streams::Output_Streams(const std::string& p, std::ostream& screen, bool debug_on)
+  : my_program_name(p), my_debug(debug_on), my_screen(screen)
 {
   init_output_streams();
 }
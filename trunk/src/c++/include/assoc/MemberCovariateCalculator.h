@@ -81,6 +81,7 @@ class MemberCovariateCalculator
     vector<double>  my_phenotypic_means;
     vector<double>  my_diffs;       
     vector<double>  my_z_scores;
+    vector<bool>    my_valid;            // Individuals which are transformed.
     double  my_divisor;          // Used to adjust residuals during transformation.
 };
 
@@ -109,6 +110,11 @@ class MemberCovariateCalculator
       // Data Members
       vector<double>  my_transformed_phenotypes;
       vector<double>  my_transformed_phenotypic_means;
+
+      // The phenotypes don't change, so their logarithms are kept between
+      // evaluations.
+      MFSUBMODELS::Transformation::TraitColumn  my_phenotype_column;
+      MFSUBMODELS::Transformation::TraitColumn  my_mean_column;
     
     private:
   };
@@ -138,6 +144,8 @@ class MccContinuousDiff : public MemberCovariateCalculator
     // Data Members
 
     vector<double>  my_transformed_diffs;  
+
+    MFSUBMODELS::Transformation::TraitColumn  my_diff_column;
 };
 
 class MccBinaryDiff : public MccContinuousDiff
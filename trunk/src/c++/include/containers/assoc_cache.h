@@ -0,0 +1,326 @@
+#ifndef ASSOC_CACHE_H
+#define ASSOC_CACHE_H
+
+//============================================================================
+//  File:       assoc_cache.h
+//
+//  History:    10/17/26 - created.
+//
+//  Notes:      A fixed size, set associative cache.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//============================================================================
+
+#include <functional>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "containers/hash_fun.h"
+
+namespace SAGE {
+
+/// \brief A bounded cache of key/value pairs.
+///
+/// The cache holds set_count() sets of ways() entries each, in one block of
+/// storage, so entries are never allocated individually.  A key can only be
+/// stored in the set chosen by its hash; when that set is full, the least
+/// recently used entry in the set is evicted.  With one way, this is the
+/// direct mapped behavior of cache_map.
+///
+/// The hash function should use all of the bits of its result.  The low bits
+/// choose the set and the full value is compared before the key, so keys are
+/// only compared when the hashes are equal.
+///
+/// Hits, misses and evictions are counted so that the cache can be sized for
+/// a run.
+template <class Key, class T,
+          class HashFcn  = hash<Key>,
+          class EqualKey = std::equal_to<Key> >
+class assoc_cache
+{
+  public:
+
+    typedef Key       key_type;
+    typedef T         data_type;
+    typedef HashFcn   hash_type;
+    typedef EqualKey  equal_key_type;
+    typedef size_t    size_type;
+
+    /// Creates a cache.  The set count is rounded up to a power of two.
+    /// Storage is not allocated until the first insertion.
+    explicit assoc_cache(size_type set_count = 1024, size_type ways = 4,
+                         const hash_type&      hf  = hash_type(),
+                         const equal_key_type& eql = equal_key_type());
+
+    /// Empties the cache and changes its shape.
+    void resize(size_type set_count, size_type ways);
+
+    /// Empties the cache.  The counters are kept.
+    void clear();
+
+    size_type set_count() const;
+    size_type ways()      const;
+    size_type capacity()  const;
+    size_type size()      const;
+
+    /// Returns the value stored for the key, or NULL if there is none.  A
+    /// returned pointer is valid until the next insertion.
+    const T* find(const key_type& k) const;
+
+    /// Stores a value for the key, replacing any value already stored, and
+    /// returns the stored value.
+    T& insert(const key_type& k, const T& v);
+
+    /// Returns the value stored for the key, inserting T() if there is none.
+    T& operator[](const key_type& k);
+
+    /// @name Counters
+    //@{
+
+      size_type hits()      const;
+      size_type misses()    const;
+      size_type evictions() const;
+
+      void reset_statistics();
+
+    //@}
+
+  private:
+
+    typedef uint64_t hash_value;
+
+    struct entry
+    {
+      entry() : hash(0), stamp(0) { }
+
+      key_type   key;
+      T          value;
+      hash_value hash;
+      size_type  stamp;   // Time of last use.  0 means empty.
+    };
+
+    hash_value hash_key(const key_type& k) const;
+
+    entry*     find_entry(const key_type& k, hash_value h) const;
+    entry&     replace_entry(const key_type& k, hash_value h);
+
+    size_type                  my_set_count;
+    size_type                  my_ways;
+    size_type                  my_size;
+
+    mutable std::vector<entry> my_entries;
+    mutable size_type          my_clock;
+
+    mutable size_type          my_hits;
+    mutable size_type          my_misses;
+    size_type                  my_evictions;
+
+    hash_type                  my_hash;
+    equal_key_type             my_key_eq;
+};
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline
+assoc_cache<Key, T, HashFcn, EqualKey>::assoc_cache
+    (size_type set_count, size_type ways, const hash_type& hf, const equal_key_type& eql)
+  : my_clock(0), my_hits(0), my_misses(0), my_evictions(0), my_hash(hf), my_key_eq(eql)
+{
+  resize(set_count, ways);
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline void
+assoc_cache<Key, T, HashFcn, EqualKey>::resize(size_type set_count, size_type ways)
+{
+  my_set_count = 1;
+
+  while( my_set_count < set_count )
+    my_set_count *= 2;
+
+  my_ways = ways ? ways : 1;
+
+  std::vector<entry>().swap(my_entries);
+
+  my_size  = 0;
+  my_clock = 0;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline void
+assoc_cache<Key, T, HashFcn, EqualKey>::clear()
+{
+  for( size_type i = 0; i < my_entries.size(); ++i )
+    my_entries[i].stamp = 0;
+
+  my_size  = 0;
+  my_clock = 0;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::set_count() const
+{
+  return my_set_count;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::ways() const
+{
+  return my_ways;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::capacity() const
+{
+  return my_set_count * my_ways;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::size() const
+{
+  return my_size;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline const T*
+assoc_cache<Key, T, HashFcn, EqualKey>::find(const key_type& k) const
+{
+  entry* e = find_entry(k, hash_key(k));
+
+  if( !e )
+  {
+    ++my_misses;
+    return NULL;
+  }
+
+  ++my_hits;
+
+  return &e->value;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline T&
+assoc_cache<Key, T, HashFcn, EqualKey>::insert(const key_type& k, const T& v)
+{
+  hash_value h = hash_key(k);
+
+  entry* e = find_entry(k, h);
+
+  if( !e )
+    e = &replace_entry(k, h);
+
+  return e->value = v;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline T&
+assoc_cache<Key, T, HashFcn, EqualKey>::operator[](const key_type& k)
+{
+  hash_value h = hash_key(k);
+
+  entry* e = find_entry(k, h);
+
+  if( !e )
+  {
+    e = &replace_entry(k, h);
+    e->value = T();
+  }
+
+  return e->value;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::hits() const
+{
+  return my_hits;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::misses() const
+{
+  return my_misses;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::size_type
+assoc_cache<Key, T, HashFcn, EqualKey>::evictions() const
+{
+  return my_evictions;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline void
+assoc_cache<Key, T, HashFcn, EqualKey>::reset_statistics()
+{
+  my_hits = my_misses = my_evictions = 0;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::hash_value
+assoc_cache<Key, T, HashFcn, EqualKey>::hash_key(const key_type& k) const
+{
+  return (hash_value) my_hash(k);
+}
+
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::entry*
+assoc_cache<Key, T, HashFcn, EqualKey>::find_entry(const key_type& k, hash_value h) const
+{
+  if( my_entries.empty() )
+    return NULL;
+
+  entry* set = &my_entries[(h & (my_set_count - 1)) * my_ways];
+
+  for( size_type w = 0; w < my_ways; ++w )
+  {
+    if( set[w].stamp && set[w].hash == h && my_key_eq(set[w].key, k) )
+    {
+      set[w].stamp = ++my_clock;
+
+      return set + w;
+    }
+  }
+
+  return NULL;
+}
+
+// - Uses an empty way of the key's set if there is one, and otherwise the
+//   least recently used.
+//
+template <class Key, class T, class HashFcn, class EqualKey>
+inline typename assoc_cache<Key, T, HashFcn, EqualKey>::entry&
+assoc_cache<Key, T, HashFcn, EqualKey>::replace_entry(const key_type& k, hash_value h)
+{
+  if( my_entries.empty() )
+    my_entries.resize(my_set_count * my_ways);
+
+  entry* set    = &my_entries[(h & (my_set_count - 1)) * my_ways];
+  entry* victim = set;
+
+  for( size_type w = 1; w < my_ways && victim->stamp; ++w )
+  {
+    if( set[w].stamp < victim->stamp )
+      victim = set + w;
+  }
+
+  if( victim->stamp )
+    ++my_evictions;
+  else
+    ++my_size;
+
+  victim->key   = k;
+  victim->hash  = h;
+  victim->stamp = ++my_clock;
+
+  return *victim;
+}
+
+} // End namespace SAGE
+
+#endif
@@ -2,6 +2,7 @@
 #define HASH_FUN_H
 
 #include <limits>
+#include <cmath>
 
 namespace SAGE {
 
@@ -4,6 +4,7 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <stdint.h>
 #include "mlocus/imodel.h"
 #include "mlocus/mfile.h"
 #include "rped/rped.h"
@@ -371,10 +372,39 @@ public:
     bool marker_data_exist(size_t m) const;
     bool only_one_allele(size_t m) const;
 
+    /// Reads, sorts and checks the pedigree files named in the parameter
+    /// file, giving the family structure listing, the error count and the
+    /// markers without usable data.
+    void read_pedigree_files(const vector<string>& pedigree_files,
+                             bool dump_trait, bool dump_marker,
+                             bool skip_traits, bool skip_markers, bool dynamic_markers,
+                             string& pedigree_listing, size_t& error_count,
+                             vector<string>& unusable_markers);
+
+    void print_dots(const string& name) const;
+
+    /// @name Pedigree snapshots (see SAGEapp::snapshot_file())
+    //@{
+
+    /// Computes the key and content hash of the entry for the pedigree data.
+    /// Returns false if a file cannot be read.
+    bool snapshot_hashes(const vector<string>& pedigree_files, const string& options,
+                         uint64_t& key, uint64_t& content_hash) const;
+
+    bool load_snapshot (uint64_t key, uint64_t content_hash,
+                        string& pedigree_listing, size_t& error_count,
+                        vector<string>& unusable_markers);
+    void store_snapshot(uint64_t key, uint64_t content_hash,
+                        const string& pedigree_listing, size_t error_count,
+                        const vector<string>& unusable_markers) const;
+
+    //@}
+
     string                              my_program_name;
     ArgumentRuleset                     my_cmdline_rules;
     ArgumentsFound                      my_parsed_arguments;
     LSF_ptr<LSFBase>                    my_params;
+    string                              my_parameter_file;
     RPED::RefMultiPedigree              my_pedigrees;
     mutable Output_Streams              my_output;
     vector<pair<string, string> >       my_first_ten_ind;
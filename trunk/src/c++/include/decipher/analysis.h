@@ -105,6 +105,16 @@ class analysis
                                       const vector<const member_em_phenotype_map*>& phenotype_maps,
                                       const locus_group& loci,
                                       size_t& total_permutations);    
+        double    do_concurrent_permutation_test(double test_statistic,
+                                                 double whole_ln_likelihood,
+                                                 const sub_pop_shuffler& suf,
+                                                 const vector<const member_em_phenotype_map*>& phenotype_maps,
+                                                 const locus_group& loci,
+                                                 double min_permutations,
+                                                 double max_permutations,
+                                                 double precision,
+                                                 size_t thread_count,
+                                                 size_t& total_permutations);
 
     // Data members.
     APP::Output_Streams&  my_streams;
@@ -67,17 +67,12 @@ class em_haplotype
   public:
     
     // Constructor/destructor.
-    // Note: using default copy constructor with hap_seq* data member.  This should not
-    //       pose a problem as haplotypes and haplotype_maps are used only in the context of a single
-    //       em_phenotype_map and haplotype sequences don't change once an em_phenotype map
-    //       is constructed.
+    // Note: the sequence of a haplotype is held by its em_haplotype_map.
     // 
     em_haplotype();
-    em_haplotype(const hap_seq* seq);
     
     double  old_freq(size_t total_hap_count) const;
     double  new_freq(size_t total_hap_count) const;
-    const hap_seq&  sequence() const;
     
     void  incr(double amount);
     void  reset();
@@ -88,8 +83,6 @@ class em_haplotype
   private:
     
     // Data members.
-    const hap_seq*  my_sequence;
-    
     double  my_old_count;
     double  my_new_count;
     double  my_static_count;
@@ -125,21 +118,31 @@ class em_haplotype_map
   public:
     
     // Constructor/destructor.
+    //
+    // - Given the loci, haplotype sequences are packed into 64 bit keys,
+    //   with as many bits per allele as each locus needs (one value is
+    //   reserved for MLOCUS::NPOS).  Sequences which cannot be packed, or
+    //   a map without loci, are keyed by the sequence itself.
+    //
     em_haplotype_map();
+    explicit em_haplotype_map(const locus_group& loci);
     
     bool  contains(const hap_seq& key) const;
     bool  converged(size_t total_hap_count, double epsilon) const;
-    bool  similar(em_haplotype_map& other, size_t total_hap_count, double epsilon) const;    
+    bool  similar(const em_haplotype_map& other, size_t total_hap_count, double epsilon) const;    
     
     double  total_freq(size_t total_hap_count) const;
+
+    // - Haplotypes are indexed 0 to size() - 1 in the order added.
+    //
+    size_t  size() const;
+    bool    empty() const;
     
     em_haplotype&   operator [](size_t index);
     const  em_haplotype&  get_haplotype(size_t index) const;
-    const hap_seq&  index_to_hap_seq(size_t index) const;
+    hap_seq         index_to_hap_seq(size_t index) const;
     size_t          hap_seq_to_index(const hap_seq& key) const;
     
-    const std::map<size_t, em_haplotype>&  haplotypes() const;
-    
     size_t  add_haplotype(const hap_seq& key);    
     void  reset();       // Called at ea. iteration of algorithm.
     void  zero();        // Called at beginning of algorithm.
@@ -148,10 +151,29 @@ class em_haplotype_map
     void  dump(ostream& out, size_t total_hap_count, const locus_group& loci) const;
   
   private:
+
+    typedef unsigned long long  packed_key;
+
+    const size_t*  sequence(size_t index) const;
+    size_t      sequence_size(size_t index) const;
+    bool        pack(const size_t* alleles, size_t allele_count, packed_key& key) const;
+    size_t      find_index(const size_t* alleles, size_t allele_count) const;
+    size_t      hash(const size_t* alleles, size_t allele_count, packed_key key, bool packed) const;
+    bool        same_sequence(size_t index, const size_t* alleles, size_t allele_count) const;
+    void        insert_index(size_t index);
+    void        rebuild_index();
+    void        unpack_keys();
     
     // Data members.
-    mutable std::map<hap_seq, size_t>  my_hap_seqs;    
-    mutable std::map<size_t, em_haplotype>  my_haplotypes;
+    vector<size_t>  my_allele_bits;           // Bits per allele, by locus.
+    bool  my_keys_packed;                     // my_keys in use.
+
+    vector<size_t>  my_alleles;               // Sequences, end to end, by index.
+    vector<size_t>  my_sequence_begin;        // Start of each in my_alleles, and the end.
+    vector<packed_key>  my_keys;              // By index, if my_keys_packed.
+    vector<em_haplotype>  my_haplotypes;      // By index.
+
+    vector<size_t>  my_slots;                 // Open addressing table of index + 1, or 0.
     
     bool  counts_initialized;
 };
@@ -188,55 +210,57 @@ class em_phenotype
     
     // Constructor/destructor.
     em_phenotype();
-    em_phenotype(em_haplotype_map* haplotypes, const set<hap_seq_comb>& combinations);
-    em_phenotype(em_haplotype_map* haplotypes, const vector<vector<hap_seq> >& combinations);
+    em_phenotype(em_haplotype_map* haplotypes, const set<hap_seq_comb>& combinations,
+                 const MersenneTwister& random_source = rand_src);
+    em_phenotype(em_haplotype_map* haplotypes, const vector<vector<hap_seq> >& combinations,
+                 const MersenneTwister& random_source = rand_src);
 
     const em_haplotype_map&  haplotypes() const;    
     size_t  count() const;
     bool  is_ambiguous() const;
-    const vector<pair<combination, double> >&  combinations() const;
+
+    // - Combination c is a group of comb_haplotype_count(c) haplotypes,
+    //   given as indices into the haplotype map, with a weight.
+    //
+    size_t  comb_count() const;
+    size_t  comb_haplotype_count(size_t c) const;
+    size_t  comb_haplotype(size_t c, size_t h) const;
+    double  comb_weight(size_t c) const;
+    combination  comb_haplotypes(size_t c) const;
     size_t  comb_size() const;
+
     const set<comb_prob, greater<comb_prob> >&  probabilities(const locus_group& loci,
                                                                     const em_haplotype_map& haplotypes) const;
     const vector<string>&  comb_strs(const locus_group& loci, const em_haplotype_map& haplotypes) const;
     
     void  incr();
-    void  init_weights();
+    void  init_weights(const MersenneTwister& random_source = rand_src);
     void  update_weights(size_t chromosome_count, em_haplotype_map& haplotypes);
     
-    double  calc_prior(const combination& comb, size_t chromosome_count,
-                       em_haplotype_map& haplotypes) const;
+    double  calc_prior(size_t c, size_t chromosome_count,
+                       const em_haplotype_map& haplotypes) const;
     
     void  dump(ostream& out, const locus_group& loci, const em_haplotype_map& haplotypes) const;
     
   private:
+
+    void  add_combination(const combination& comb);
     
-    string  combination_string(const vector<pair<combination, double> >::const_iterator& c_iter,
-                               const locus_group& loci, const em_haplotype_map& haps) const;
-    
-    // - For iterating through distinct haplotypes in a combination
-    //   and determining the number of copies.
-    //
-    class combination_iterator
-    {
-      public:
-        combination_iterator(const combination& comb);
-        
-        pair<size_t, size_t>  operator *();
-        std::map<size_t, size_t>::iterator  operator ++(int);
-        bool  at_end() const;  
-      
-      private:
-        bool  previously_found(vector<size_t>::const_iterator iter) const;
-      
-        std::map<size_t, size_t>  my_distinct_haplotypes;
-        std::map<size_t, size_t>::iterator  my_internal_iterator;
-    };
+    string  combination_string(size_t c, const locus_group& loci, const em_haplotype_map& haps) const;
     
     // Data members.
+    //
+    // - Combinations are stored end to end.  The distinct haplotypes of
+    //   each, with their number of copies, are found once here rather
+    //   than at each iteration of the algorithm.
+    //
     size_t  my_count;
     bool  ambiguous;      // Has more than one combination.
-    vector<pair<combination, double> >  my_combinations;     // <group of haplotypes, weight>
+    vector<size_t>  my_comb_begin;                   // Start of each combination, and the end.
+    vector<size_t>  my_comb_haplotypes;              // Haplotype indices.
+    vector<double>  my_weights;                      // By combination.
+    vector<size_t>  my_distinct_begin;               // Start of each combination's distinct haplotypes, and the end.
+    vector<pair<size_t, size_t> >  my_distinct;      // <haplotype index, copies>, by ascending index.
     mutable set<comb_prob, greater<comb_prob> >  my_probabilities;
     mutable vector<string>  my_comb_strs;
 };
@@ -299,7 +323,7 @@ class base_em_phenotype_map
     double  ln_likelihood();    
     void  build_sub_pop_name();
     void  set_frequencies(set<hap_freq, greater<hap_freq> >& frequencies,
-                                  const std::map<size_t, em_haplotype>& haps) const;
+                                  const em_haplotype_map& haps) const;
     void  init_dump(ostream& dump_file) const;
     
     // Data members.
@@ -325,6 +349,11 @@ class base_em_phenotype_map
       vector<em_phenotype>  my_best_phenotypes;
       mutable set<hap_freq, greater<hap_freq> >  my_final_frequencies;
       double  my_max_ln_likelihood;
+
+    // - Source of the random starting weights.  rand_src unless the map is
+    //   maximized concurrently with others (see rebuilt_em_phenotype_map).
+    //
+    const MersenneTwister*  my_random_source;
     
     bool  maximized;
 };
@@ -37,12 +37,7 @@ member_order<T>::operator ()(T m1, T m2) const
 //
 inline
 em_haplotype::em_haplotype()
-      : my_sequence(0), my_old_count(0), my_new_count(0), my_static_count(0) 
-{}
-
-inline
-em_haplotype::em_haplotype(const hap_seq* seq)
-      : my_sequence(seq), my_old_count(0), my_new_count(0), my_static_count(0) 
+      : my_old_count(0), my_new_count(0), my_static_count(0) 
 {}
 
 inline double  
@@ -59,12 +54,6 @@ em_haplotype::new_freq(size_t total_hap_count) const
   return  my_new_count / total_hap_count;
 }
     
-inline const hap_seq&
-em_haplotype::sequence() const
-{
-  return  *my_sequence;
-}
-    
 inline void  
 em_haplotype::incr(double amount)
 {
@@ -129,13 +118,13 @@ hap_freq::operator >(const hap_freq& other) const
 //
 inline
 em_haplotype_map::em_haplotype_map()
-      : counts_initialized(false)
+      : my_keys_packed(false), my_sequence_begin(1, 0), counts_initialized(false)
 {}
     
 inline bool  
 em_haplotype_map::contains(const hap_seq& key) const
 {
-  return  my_hap_seqs.find(key) != my_hap_seqs.end();
+  return  hap_seq_to_index(key) != (size_t)(-1);
 }
 
 // - Intra-haplotype frequency comparison.
@@ -145,12 +134,9 @@ em_haplotype_map::converged(size_t total_hap_count, double epsilon) const
 {
   bool  conv = true;
   
-  std::map<hap_seq, size_t>::const_iterator  iter = my_hap_seqs.begin();
-  std::map<hap_seq, size_t>::const_iterator  end_iter = my_hap_seqs.end();
-  for(; iter != end_iter; iter++)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    size_t  index = iter->second;
-    assert(my_haplotypes.find(index) != my_haplotypes.end());
     if(! my_haplotypes[index].converged(total_hap_count, epsilon))
     {
       conv = false;
@@ -164,17 +150,16 @@ em_haplotype_map::converged(size_t total_hap_count, double epsilon) const
 // - Inter-haplotype frequency comparison.
 //
 inline bool  
-em_haplotype_map::similar(em_haplotype_map& other, size_t total_hap_count, double epsilon) const
+em_haplotype_map::similar(const em_haplotype_map& other, size_t total_hap_count, double epsilon) const
 {
   bool  sim = true;
   
-  std::map<size_t, em_haplotype>::const_iterator  iter = my_haplotypes.begin();
-  std::map<size_t, em_haplotype>::const_iterator  end_iter = my_haplotypes.end();
-  for(; iter != end_iter; iter++)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    const hap_seq&  seq = iter->second.sequence();
-    assert(other.contains(seq));
-    if(! iter->second.similar(other[other.hap_seq_to_index(seq)], total_hap_count, epsilon))
+    size_t  other_index = other.find_index(sequence(index), sequence_size(index));
+    assert(other_index != (size_t)(-1));
+    if(! my_haplotypes[index].similar(other.my_haplotypes[other_index], total_hap_count, epsilon))
     {
       sim = false;
       break;
@@ -189,50 +174,31 @@ em_haplotype_map::total_freq(size_t total_hap_count) const
 {
   double  total = 0.0;
   
-  std::map<size_t, em_haplotype>::const_iterator  iter = my_haplotypes.begin();
-  std::map<size_t, em_haplotype>::const_iterator  end_iter = my_haplotypes.end();
-  for(; iter != end_iter; iter++)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    total += iter->second.new_freq(total_hap_count);
+    total += my_haplotypes[index].new_freq(total_hap_count);
   }
   
   return  total;
 }
 
-// - If haplotype doesn't exist, create it.  Return haplotype index.
-//
-inline size_t 
-em_haplotype_map::add_haplotype(const hap_seq& key)
+inline size_t
+em_haplotype_map::size() const
 {
-  typedef std::map<hap_seq, size_t>::iterator  seq_iterator;
-  typedef std::map<size_t, em_haplotype>::iterator  hap_iterator;
-  
-  size_t  index;
-  
-  seq_iterator  s_iter = my_hap_seqs.find(key);
-  seq_iterator  s_end_iter = my_hap_seqs.end();
-  if(s_iter == s_end_iter)
-  {
-    index = my_hap_seqs.size();
-    pair<seq_iterator, bool>  seq_insert_result = my_hap_seqs.insert(make_pair(key, index));
-    assert(seq_insert_result.second);    
-  
-    pair<hap_iterator, bool>  hap_insert_result = 
-              my_haplotypes.insert(make_pair(index, em_haplotype(&(seq_insert_result.first->first))));
-    assert(hap_insert_result.second);
-  }
-  else
-  {
-    index = s_iter->second;
-  }
-  
-  return  index;
+  return  my_haplotypes.size();
+}
+
+inline bool
+em_haplotype_map::empty() const
+{
+  return  my_haplotypes.empty();
 }
 
 inline em_haplotype&
 em_haplotype_map::operator [](size_t index) 
 {
-  assert(my_haplotypes.find(index) != my_haplotypes.end());
+  assert(index < my_haplotypes.size());
   
   return  my_haplotypes[index];
 }
@@ -240,58 +206,67 @@ em_haplotype_map::operator [](size_t index)
 inline const em_haplotype&
 em_haplotype_map::get_haplotype(size_t index) const 
 {
-  assert(my_haplotypes.find(index) != my_haplotypes.end());
+  assert(index < my_haplotypes.size());
   
   return  my_haplotypes[index];
 }
 
-inline const hap_seq&
+inline hap_seq
 em_haplotype_map::index_to_hap_seq(size_t index) const
 {
-  return  my_haplotypes[index].sequence();
+  assert(index < my_haplotypes.size());
+
+  return  hap_seq(my_alleles.begin() + my_sequence_begin[index],
+                  my_alleles.begin() + my_sequence_begin[index + 1]);
 }
 
+// - Return haplotype index, or (size_t)(-1) if not present.
+//
 inline size_t
 em_haplotype_map::hap_seq_to_index(const hap_seq& key) const
 {
-  if(contains(key))
-  {
-    return  my_hap_seqs[key];
-  }
-  else
-  {
-    return  (size_t)(-1);
-  }
-}
-
-inline const std::map<size_t, em_haplotype>&
-em_haplotype_map::haplotypes() const
-{
-  return  my_haplotypes;
+  return  find_index(key.empty() ? 0 : &key[0], key.size());
 }
     
 inline void  
 em_haplotype_map::reset()
 {
-  std::map<size_t, em_haplotype>::iterator  iter = my_haplotypes.begin();
-  std::map<size_t, em_haplotype>::iterator  end_iter = my_haplotypes.end();
-  for(; iter != end_iter; iter++)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    iter->second.reset();
+    my_haplotypes[index].reset();
   }
 }
 
 inline void  
 em_haplotype_map::zero()
 {
-  std::map<size_t, em_haplotype>::iterator  iter = my_haplotypes.begin();
-  std::map<size_t, em_haplotype>::iterator  end_iter = my_haplotypes.end();
-  for(; iter != end_iter; iter++)
+  size_t  hap_count = my_haplotypes.size();
+  for(size_t index = 0; index < hap_count; ++index)
   {
-    iter->second.zero();
+    my_haplotypes[index].zero();
   }
 }
 
+inline const size_t*
+em_haplotype_map::sequence(size_t index) const
+{
+  return  my_alleles.empty() ? 0 : &my_alleles[0] + my_sequence_begin[index];
+}
+
+inline size_t
+em_haplotype_map::sequence_size(size_t index) const
+{
+  return  my_sequence_begin[index + 1] - my_sequence_begin[index];
+}
+
+inline bool
+em_haplotype_map::same_sequence(size_t index, const size_t* alleles, size_t allele_count) const
+{
+  return  sequence_size(index) == allele_count &&
+          equal(alleles, alleles + allele_count, sequence(index));
+}
+
 
 //============================================================================
 // IMPLEMENTATION:  comb_prob
@@ -323,6 +298,7 @@ comb_prob::operator >(const comb_prob& other) const
 //
 inline
 em_phenotype::em_phenotype()
+      : my_comb_begin(1, 0), my_distinct_begin(1, 0)
 {}
 
 inline size_t
@@ -337,47 +313,57 @@ em_phenotype::is_ambiguous() const
   return  ambiguous;
 }
 
-inline const vector<pair<em_phenotype::combination, double> >&
-em_phenotype::combinations() const
+inline size_t
+em_phenotype::comb_count() const
 {
-  return  my_combinations;
+  return  my_weights.size();
 }
 
 inline size_t
-em_phenotype::comb_size() const
+em_phenotype::comb_haplotype_count(size_t c) const
 {
-  assert(! my_combinations.empty());
-  
-  return  my_combinations[0].first.size();
+  assert(c < my_weights.size());
+
+  return  my_comb_begin[c + 1] - my_comb_begin[c];
 }
 
-inline void
-em_phenotype::incr()
+inline size_t
+em_phenotype::comb_haplotype(size_t c, size_t h) const
 {
-  my_count++;
+  assert(h < comb_haplotype_count(c));
+
+  return  my_comb_haplotypes[my_comb_begin[c] + h];
 }
 
+inline double
+em_phenotype::comb_weight(size_t c) const
+{
+  assert(c < my_weights.size());
 
-//============================================================================
-// IMPLEMENTATION:  em_phenotype::combination_iterator
-//============================================================================
-//
-inline pair<size_t, size_t>
-em_phenotype::combination_iterator::operator *()
+  return  my_weights[c];
+}
+
+inline em_phenotype::combination
+em_phenotype::comb_haplotypes(size_t c) const
 {
-  return  *my_internal_iterator;
+  assert(c < my_weights.size());
+
+  return  combination(my_comb_haplotypes.begin() + my_comb_begin[c],
+                      my_comb_haplotypes.begin() + my_comb_begin[c + 1]);
 }
 
-inline std::map<size_t, size_t>::iterator
-em_phenotype::combination_iterator::operator ++(int)
+inline size_t
+em_phenotype::comb_size() const
 {
-  return  my_internal_iterator++;
+  assert(! my_weights.empty());
+  
+  return  comb_haplotype_count(0);
 }
 
-inline bool
-em_phenotype::combination_iterator::at_end() const
+inline void
+em_phenotype::incr()
 {
-  return  my_internal_iterator == my_distinct_haplotypes.end();
+  my_count++;
 }
 
 
@@ -392,7 +378,8 @@ base_em_phenotype_map::base_em_phenotype_map(output_state& ostate,
                                              const string& outer_sub_pop_name)
       : my_output_state(ostate), my_streams(streams), my_errors(streams.errors()), my_messages(streams.messages()), 
         my_loci(loci), my_inner_sub_pop_name(inner_sub_pop_name), my_outer_sub_pop_name(outer_sub_pop_name), 
-        my_total_hap_count(0), my_max_ln_likelihood(QNAN), maximized(false)
+        my_total_hap_count(0), my_haplotypes(loci), my_max_ln_likelihood(QNAN), my_random_source(&rand_src),
+        maximized(false)
 {
   build_sub_pop_name();
 }
@@ -503,7 +490,7 @@ base_em_phenotype_map::max_ln_likelihood() const
 inline size_t
 base_em_phenotype_map::independent_param_count() const
 {
-  return  my_haplotypes.haplotypes().size() - 1;
+  return  my_haplotypes.size() - 1;
 }
 
 inline void
@@ -513,7 +500,7 @@ base_em_phenotype_map::init_weights()
   vector<em_phenotype>::iterator  p_end_iter = my_phenotypes.end();
   for(; p_iter != p_end_iter; ++p_iter)
   {
-    p_iter->init_weights();
+    p_iter->init_weights(*my_random_source);
   }
 }
 
@@ -35,6 +35,7 @@ const double  DUMP_CUTOFF_DEFAULT = .001;
 const double  LIKELY_CUTOFF_DEFAULT = .05;
 const size_t  PERMUTATIONS_DEFAULT = 0;
 const int     SEED_DEFAULT = 0;
+const size_t  THREADS_DEFAULT = 0;          // Program default (--threads).
 const size_t  MIN_PERMUTATIONS_DEFAULT = 50;
 const size_t  MAX_PERMUTATIONS_DEFAULT = 10000;
 const double  WIDTH_DEFAULT = .2;
@@ -187,6 +188,7 @@ struct instructions
     size_t  max_permutations;
     double  width;
     double  confidence;
+    size_t  threads;                // Permutations evaluated at once.  0 is program default.
   
  
   bool  valid;
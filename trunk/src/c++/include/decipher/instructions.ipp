@@ -200,6 +200,7 @@ instructions::reset()
   max_permutations              = MAX_PERMUTATIONS_DEFAULT;
   width                         = WIDTH_DEFAULT;
   confidence                    = CONFIDENCE_DEFAULT;
+  threads                       = THREADS_DEFAULT;
   
   // - Note:  not *really* valid until parser::init_parse() is called and user supplied
   //   regions are set.
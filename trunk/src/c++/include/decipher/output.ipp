@@ -484,14 +484,13 @@ writer<T>::write_all_possible_haplotypes(const base_em_phenotype_map& phenotypes
   my_detail << "Haplotypes\n"
             << "----------" << endl;
   
-  const std::map<size_t, em_haplotype>&  haplotypes = phenotypes.haplotypes().haplotypes();
+  const em_haplotype_map&  haplotypes = phenotypes.haplotypes();
   
   set<string>  hap_strings;
-  std::map<size_t, em_haplotype>::const_iterator  h_iter     = haplotypes.begin();
-  std::map<size_t, em_haplotype>::const_iterator  h_end_iter = haplotypes.end();
-  for(; h_iter != h_end_iter; ++h_iter)
+  size_t  hap_count = haplotypes.size();
+  for(size_t h = 0; h < hap_count; ++h)
   {
-    hap_strings.insert(hap_seq_string(h_iter->second.sequence(), my_instructions.loci));
+    hap_strings.insert(hap_seq_string(haplotypes.index_to_hap_seq(h), my_instructions.loci));
   }
   
   set<string>::const_iterator  hs_iter     = hap_strings.begin();
@@ -1103,19 +1102,18 @@ writer<T>::build_new_combs(const em_phenotype& phenotype,
                         const locus_group& loci,
                         vector<pair<hap_seq, hap_seq> >& new_combs)
 {
-  const vector<pair<em_phenotype::combination, double> >&  combs = phenotype.combinations();
   size_t  i_model_count = loci.size();
 
   // - Get sequences.
   //
-  size_t  combs_count = combs.size();
+  size_t  combs_count = phenotype.comb_count();
   for(size_t c = 0; c < combs_count; ++c)
   {
-    assert(combs[c].first.size() == 2);           // Diplotype.
+    assert(phenotype.comb_haplotype_count(c) == 2);           // Diplotype.
     new_combs.push_back(pair<vector<size_t>, vector<size_t> >());
 
-    new_combs[c].first  = haplotypes.index_to_hap_seq(combs[c].first[0]);
-    new_combs[c].second = haplotypes.index_to_hap_seq(combs[c].first[1]);
+    new_combs[c].first  = haplotypes.index_to_hap_seq(phenotype.comb_haplotype(c, 0));
+    new_combs[c].second = haplotypes.index_to_hap_seq(phenotype.comb_haplotype(c, 1));
   }
   
   
@@ -117,6 +117,7 @@ class parser : public BasicParser
     void  parse_starting_points(const LSFBase* param);
     void  parse_dump(const LSFBase* param);
     void  parse_seed(const LSFBase* param);      // For testing.  Undocumented.
+    void  parse_threads(const LSFBase* param);
     
     class duplication
     {
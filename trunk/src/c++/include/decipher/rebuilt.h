@@ -32,9 +32,14 @@ class rebuilt_em_phenotype_map : public base_em_phenotype_map
   public:
   
     // Constructor/destructor.
+    //
+    // - random_source must outlive the map.  Maps which are built and
+    //   maximized concurrently must each be given their own.
+    //
     rebuilt_em_phenotype_map(output_state& ostate, APP::Output_Streams& streams, const locus_group& loci, 
                              const vector<member>& members, 
-                             const vector<const member_em_phenotype_map*>& phenotype_maps); 
+                             const vector<const member_em_phenotype_map*>& phenotype_maps,
+                             const MersenneTwister& random_source = rand_src); 
 
   private:
     static pair<const em_phenotype*, const em_haplotype_map*>  get_phenotype(const member ind, 
@@ -38,6 +38,13 @@ class sub_pop_shuffler
 
     bool do_shuffle(int seed = 0);
 
+    // - Shuffles a copy of the whole population into new_sub_pops, drawing
+    //   from random_source.  Unlike do_shuffle(), the shuffler itself is not
+    //   changed, so several threads may shuffle at once, each with its own
+    //   random source.
+    //
+    bool shuffle(const MersenneTwister& random_source, sub_pops& new_sub_pops) const;
+
     const vector<member>& get_whole_pop()    const;
     const sub_pops&       get_new_sub_pops() const;
 
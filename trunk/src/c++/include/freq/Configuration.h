@@ -22,6 +22,7 @@ struct Configuration
     skip_mle            = false; 
     estimate_inbreeding = false; 
     maxfun_debug        = false;
+    thread_count        = 0;
   }
 
   /// Copy constructor.
@@ -32,6 +33,7 @@ struct Configuration
     skip_mle            (other.skip_mle),
     estimate_inbreeding (other.estimate_inbreeding),
     maxfun_debug        (other.maxfun_debug),
+    thread_count        (other.thread_count),
     markers             (other.markers)
   { }
 
@@ -46,6 +48,7 @@ struct Configuration
       skip_mle            = other.skip_mle;
       estimate_inbreeding = other.estimate_inbreeding;
       maxfun_debug        = other.maxfun_debug;
+      thread_count        = other.thread_count;
       markers             = other.markers;
     }
 
@@ -83,6 +86,10 @@ struct Configuration
   /// Whether or not to enable maxfun debugging output
   bool maxfun_debug;
 
+  /// Number of markers analyzed at once.  0 means the program default
+  /// (UTIL::ThreadPool::default_thread_count()).
+  size_t thread_count;
+
   ///
   /// Dumps contents to screen (debugging use only)
   void dump() const
@@ -93,6 +100,7 @@ struct Configuration
               << "  founder weight     = " << founder_weight      << std::endl
               << "  skip mle           = " << skip_mle            << std::endl
               << "  estimate inb.      = " << estimate_inbreeding << std::endl
+              << "  threads            = " << thread_count        << std::endl
               << "  markers            = ";    
           
               
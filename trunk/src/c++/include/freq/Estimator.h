@@ -16,6 +16,7 @@
 #include "freq/Results.h"
 #include "freq/Configuration.h"
 #include "freq/LikelihoodCalculator.h"
+#include "util/ThreadPool.h"
 
 namespace SAGE {
 namespace FREQ {
@@ -28,6 +29,11 @@ namespace FREQ {
 /// (1) If the marker is codominant, calculates the initial allele frequencies.
 /// (2) Unless the skip_mle is true, calculates maximium likelihood estimates for the allele frequencies.
 ///
+/// Markers are independent, so with more than one thread (see Configuration::thread_count) they
+/// are analyzed concurrently, each with its own Sample, Peelers and MAXFUN objects.  The runtime
+/// output of each marker is held until those of the markers before it have been written, and the
+/// results are kept in marker order, so neither depends on the number of threads.
+///
 class Estimator
 {
 public:
@@ -42,6 +48,51 @@ public:
 
 private:
 
+    /// The outcome of the analysis of a single marker.
+    struct MarkerRun
+    {
+      MarkerRun() : analyzed(false), invalid_sample(false), completed(false) { }
+
+      /// The analysis, if analyzed.
+      MarkerAnalysis analysis;
+
+      /// Whether or not the analysis belongs in the results.
+      bool analyzed;
+
+      /// Whether or not the sample could not be constructed (an error to report).
+      bool invalid_sample;
+
+      /// Whether or not the analysis has finished (concurrent runs only).
+      bool completed;
+
+      /// Runtime output held until it can be written in marker order (concurrent runs only).
+      std::string log;
+    };
+
+    class MarkerScheduler;
+
+    ///
+    /// Analyzes the marker_num'th marker of the configuration, writing runtime output to out.
+    static void analyzeMarker(
+      const Configuration                 & config,
+      const FPED::FilteredMultipedigree   & mp,
+            size_t                          marker_num,
+            MarkerRun                     & run,
+            std::ostream                  & out);
+
+    ///
+    /// Writes the errors for an analyzed marker.
+    static void reportMarker(const MarkerRun & run, cerrorstream & errors);
+
+    ///
+    /// Analyzes the markers of the configuration concurrently.
+    static void analyzeMarkersConcurrently(
+      const Configuration                 & config,
+      const FPED::FilteredMultipedigree   & mp,
+            size_t                          thread_count,
+            std::vector<MarkerRun>        & runs,
+            cerrorstream                  & errors);
+
     ///
     /// Calculates the allele frequencies in the given sample.
     ///
@@ -51,7 +102,7 @@ private:
     ///
     /// Maximizes the likelihood.
     /// NOTE: Assumes my_marker and my_gmodel have been set, and my_results[my_marker] exists.
-    static void estimateLikelihood(const Configuration & config, const Sample & sample, MarkerAnalysis & analysis);
+    static void estimateLikelihood(const Configuration & config, const Sample & sample, MarkerAnalysis & analysis, std::ostream & out = std::cout);
 
     static void setupComponents(
       const Configuration        & config, 
@@ -22,6 +22,7 @@
 
 #include "func/FunctionParser.h"
 #include "func/PythonInterface.h"
+#include "func/NativeExpression.h"
 
 //#define PY_ERROR_MSG
 #define DISABLE_TIMER 0
@@ -37,7 +38,8 @@ namespace FUNC {
 ///                                                                          
 /// The function expression is represented by a string.
 /// This class embeds the Python language interpreter (via the python
-/// class) to parse and evaluate the expression.
+/// class) to parse and evaluate the expression.  Expressions which
+/// NativeExpression can compile are evaluated without the interpreter.
 ///
 /// CAN'T HANDLE CASES WHERE A VARIABLE NAME IN THE FUNCTION 
 /// EXPRESSION DOES NOT CONFORM TO PYTHON NAME REQUIREMENTS, IE, 
@@ -97,6 +99,41 @@ class Function
     /// \param par_data Object describing the how to calculate the new variable
     void create(RPED::RefMultiPedigree& mp, const FunctionParser::TraitData & par_data); 
   
+    ///
+    /// Evaluates the compiled expression for every individual, setting the
+    /// values of the new trait.
+    /// \param mp Multipedigree whose data will be analyzed
+    /// \param par_data Object describing the how to calculate the new variable
+    /// \param native The compiled expression
+    /// \param trait_num The id of the new trait
+    void evaluate_native(
+      RPED::RefMultiPedigree& mp,
+      const FunctionParser::TraitData & par_data,
+      const NativeExpression & native,
+      size_t trait_num);
+
+    ///
+    /// Evaluates the expression with Python for every individual, setting the
+    /// values of the new trait.
+    /// \param mp Multipedigree whose data will be analyzed
+    /// \param par_data Object describing the how to calculate the new variable
+    /// \param calculator The calculator object, with the expression compiled
+    /// \param trait_num The id of the new trait
+    void evaluate_python(
+      RPED::RefMultiPedigree& mp,
+      const FunctionParser::TraitData & par_data,
+      PythonInterface & calculator,
+      size_t trait_num);
+
+    ///
+    /// Returns the names of the constants, strings and markers the expression
+    /// may use, which only the Python environment defines.
+    NativeExpression::name_set python_only_names(const FunctionParser::TraitData & par_data) const;
+
+    ///
+    /// Returns the value as it is stored in the new trait.
+    static double stored_value(double value);
+
     ///
     /// Extract names from the expression and remember those of existing
     /// traits or markers.
@@ -155,6 +192,8 @@ class Function
                           const std::string& expr );    
                                         
     void  write_error_msg(const std::string& message);
+
+    void  write_runtime_error_msg(const std::string& expr);
       
     /// Data members.
     cerrorstream        my_errors;
@@ -0,0 +1,143 @@
+#ifndef FUNC_NATIVE_EXPRESSION_H
+#define FUNC_NATIVE_EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace SAGE {
+namespace FUNC {
+
+/// \brief Compiles function block expressions to byte code evaluated without Python
+///
+/// Function block expressions are Python expressions, and are evaluated by the
+/// embedded interpreter once per individual.  Most of them, however, use only
+/// numbers, trait values, arithmetic, comparisons, 'and', 'or', 'not' and the
+/// functions of the math module.  NativeExpression compiles that subset to
+/// a small stack machine program, which is then run for each individual
+/// directly on its trait values.
+///
+/// The program follows the semantics of the Python 1.5 interpreter exactly,
+/// so that a trait has the same values whichever way it was computed:
+///
+/// - Numbers are Python ints (C longs) or floats.  Trait values are floats.
+/// - Int '/' and '%' floor; float '%' takes the sign of the divisor.
+/// - Int overflow, division by zero, an int to a negative power and math
+///   domain or range errors are evaluation errors.
+/// - Comparisons and 'not' give the int 1 or 0; 'and' and 'or' give one of
+///   their operands.
+///
+/// Anything else -- strings, markers, constants, tuples, long or complex
+/// literals, other names or functions -- is not compiled, and the caller
+/// should use the Python interpreter instead.
+class NativeExpression
+{
+  public:
+
+    /// Maps the names of trait variables to their trait ids.
+    typedef std::map<std::string, size_t> variable_map;
+
+    /// Names defined in the Python environment which cannot be compiled.
+    typedef std::set<std::string>         name_set;
+
+  /// @name Constructor
+  //@{
+
+    ///
+    /// Constructor.
+    NativeExpression();
+
+  //@}
+
+  /// @name Compiling
+  //@{
+
+    ///
+    /// Compiles the expression.
+    /// \param expr The python expression (eg: "(age > 10 and age <= 20)")
+    /// \param variables The trait variables which may be used in the expression
+    /// \param hidden Names which, if used, prevent compilation (eg: constants),
+    ///        because they hide a math function or constant of the same name
+    /// \returns \c true if the expression was compiled, \c false if it uses
+    ///          something which must be left to Python.
+    bool compile(const std::string  & expr,
+                 const variable_map & variables,
+                 const name_set     & hidden = name_set());
+
+    ///
+    /// Returns \c true if an expression has been compiled.
+    bool compiled() const;
+
+    ///
+    /// Returns the trait ids of the variables the compiled expression reads,
+    /// in the order their values are passed to evaluate().
+    const std::vector<size_t> & variable_traits() const;
+
+  //@}
+
+  /// @name Evaluation
+  //@{
+
+    ///
+    /// Evaluates the compiled expression.
+    /// \param values The values of the variables, in the order of variable_traits()
+    /// \returns The value of the expression, or QNAN if its evaluation fails
+    double evaluate(const double * values) const;
+
+  //@}
+
+  private:
+
+    class parser;
+    friend class parser;
+
+    enum op_code
+    {
+      PUSH_CONST, LOAD_VAR,
+      ADD, SUBTRACT, MULTIPLY, DIVIDE, MODULO, POWER,
+      NEGATE, NOT,
+      COMPARE,
+      CALL,
+      DUP, ROT_TWO, ROT_THREE, POP,
+      JUMP, JUMP_IF_FALSE, JUMP_IF_TRUE
+    };
+
+    enum compare_op  { LT, LE, EQ, NE, GT, GE };
+
+    enum function_id
+    {
+      F_ACOS, F_ASIN, F_ATAN, F_CEIL, F_COS, F_COSH, F_EXP, F_FABS, F_FLOOR,
+      F_LOG, F_LOG10, F_SIN, F_SINH, F_SQRT, F_TAN, F_TANH,
+      F_ATAN2, F_FMOD, F_HYPOT, F_POW,
+      F_ABS, F_FLOAT, F_INT, F_ROUND, F_MIN, F_MAX, F_CMP
+    };
+
+    /// A Python int or float.
+    struct value
+    {
+      bool   is_int;
+      long   i;
+      double f;
+    };
+
+    struct instruction
+    {
+      op_code code;
+      size_t  arg;     ///< Constant, variable, comparison, function or jump target
+      size_t  count;   ///< Number of arguments of a CALL
+    };
+
+    bool call(function_id f, const value * args, size_t count, value & result) const;
+
+    std::vector<instruction> my_program;
+    std::vector<value>       my_constants;
+    std::vector<size_t>      my_variable_traits;
+
+    mutable std::vector<value> my_stack;     ///< Evaluation stack; evaluate() is not reentrant
+};
+
+} // End namespace FUNC
+} // End namespace SAGE
+
+#endif
@@ -111,6 +111,7 @@ class genibd_analysis
     unsigned int                      pair_types;
 
     RefIBDWriteFile*                  my_ibd_prob_file;
+    RefIBDWriteBinaryFile*            my_ibd_binary_file;
     RefIBDWriteFile*                  my_ibd_state_file;
 
     vector<string>                    my_bad_fam;
@@ -47,6 +47,7 @@ class genibd_parameters
     double                     interval_distance()         const;
     bool                       allow_loops()               const;
     bool                       output_ibd_state()          const;
+    bool                       binary_ibd()                const;
     choice_type                allow_simulation()          const;
     choice_type                allow_family_splitting()    const;
     pair_category_type         pair_category()             const;
@@ -70,6 +71,7 @@ class genibd_parameters
     void set_interval_distance(double);
     void set_allow_loops(bool);
     void set_output_ibd_state(bool);
+    void set_binary_ibd(bool);
     void set_allow_simulation(choice_type);
     void set_allow_family_splitting(choice_type);
     void set_pair_category(pair_category_type);
@@ -101,6 +103,7 @@ class genibd_parameters
     double               my_interval_distance;
     bool                 my_loops;
     bool                 my_output_ibd_state;
+    bool                 my_binary_ibd;
     choice_type          my_simulation;
     choice_type          my_family_split;
     pair_category_type   my_pair_type;
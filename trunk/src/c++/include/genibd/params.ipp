@@ -44,6 +44,12 @@ genibd_parameters::output_ibd_state() const
   return my_output_ibd_state;
 }
 
+inline bool
+genibd_parameters::binary_ibd() const
+{
+  return my_binary_ibd;
+}
+
 inline choice_type
 genibd_parameters::allow_simulation() const
 {
@@ -142,6 +148,12 @@ genibd_parameters::set_output_ibd_state(bool b)
   my_output_ibd_state = b;
 }
 
+inline void
+genibd_parameters::set_binary_ibd(bool b) 
+{
+  my_binary_ibd = b;
+}
+
 inline void
 genibd_parameters::set_allow_simulation(choice_type b) 
 {
@@ -50,6 +50,7 @@ class genibd_parser : public APP::BasicParser
     void parse_loops(const LSFBase* param);
     void parse_simulation(const LSFBase* param);
     void parse_output_ibd_state(const LSFBase* param);
+    void parse_binary_ibd(const LSFBase* param);
     void parse_family(const LSFBase* param);
     void parse_pair_types(const LSFBase* param);
 
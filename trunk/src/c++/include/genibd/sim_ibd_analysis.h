@@ -55,10 +55,14 @@ class sim_ibd_analysis
 
     size_t       add_pair(mem_pointer i1, mem_pointer i2, pair_type pt);
 
+    // Simulates the pedigree.  With more than one chain in the parameters,
+    // the chains are run concurrently and their counts pooled.
     bool         compute(ostream& info);
 
    private:
 
+    bool         compute_chains(const MCMC::McmcMeiosisMap& ped, ostream& info);
+
     //members
     //
     mcmc_parameters             my_params;
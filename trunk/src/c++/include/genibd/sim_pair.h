@@ -65,6 +65,14 @@ class sim_relative_pair
 
     void   increment_value(size_t m, size_t increment = 1, bool x_linked = false);
 
+    // Steps counted at marker m, and the alleles shared ibd over them
+    // (2 per f2 step, 1 per f1 step).
+    size_t get_total        (size_t m) const;
+    size_t get_shared_count (size_t m) const;
+
+    // Adds the counts of another chain's copy of the same pair.
+    void   add_counts(const sim_relative_pair& r);
+
   protected:
 
     fmember_const_pointer      my_member_one;
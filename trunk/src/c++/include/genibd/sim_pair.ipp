@@ -147,6 +147,20 @@ sim_relative_pair::get_value(size_t m, size_t i) const
   }
 }
 
+inline
+size_t
+sim_relative_pair::get_total(size_t m) const
+{
+  return my_data[m].total;
+}
+
+inline
+size_t
+sim_relative_pair::get_shared_count(size_t m) const
+{
+  return my_data[m].total + my_data[m].f2 - my_data[m].f0;
+}
+
 inline
 void
 sim_relative_pair::increment_value(size_type m, size_t increment, bool x_linked)
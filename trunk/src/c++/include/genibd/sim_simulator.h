@@ -28,12 +28,22 @@ class ibd_mcmc_simulator : public mcmc_simulator
   public:
 
     ibd_mcmc_simulator(const mcmc_meiosis_map& ped, const pedigree_region& pr,
-                       mcmc_parameters*        par, cerrorstream&          err);
+                       mcmc_parameters*        par, cerrorstream&          err,
+                       size_t                  chain = 0);
 
    ~ibd_mcmc_simulator();
 
     virtual bool start(ostream& info);
 
+    // The batch, dememorization and simulation step counts, after scaling
+    // by the pedigree size if the parameters use factors.
+    void         get_step_counts(long& batch_count, long& demem_count, long& sim_count) const;
+
+    // Used to run a chain one batch at a time (see sim_ibd_analysis).
+    // initialize() must succeed before batches are run.  start() does both.
+    bool         initialize(ostream& info);
+    void         run_batch(dot_formatter& timer);
+
     vector<sim_relative_pair>*  set_pairs(vector<sim_relative_pair>* rp);
     vector<sim_relative_pair>*  get_pairs() const;
     
@@ -56,6 +66,9 @@ class ibd_mcmc_simulator : public mcmc_simulator
     void            do_multipoint_analysis(cerrorstream& o);
     void            do_singlepoint_analysis(cerrorstream& o);
 
+    void            singlepoint_batch(dot_formatter& timer, long demem_count, long sim_count);
+    void            multipoint_batch(dot_formatter& timer, long demem_count, long sim_count);
+
     vector<sim_relative_pair>*   my_relative_pairs;
 
     vector<tree_data>            my_trees;
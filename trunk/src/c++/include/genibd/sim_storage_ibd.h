@@ -90,7 +90,7 @@ class sim_storage_ibd : public IBD
                                    std::vector<double> &f1mp,
                                    std::vector<double> &f2) const;
 
-    virtual const sped_pointer get_subped(size_t i) const;
+    virtual sped_pointer       get_subped(size_t i) const;
     virtual sped_pointer       get_subped(size_t i);
 
     virtual bool set_ibd_state(size_t m, const a_marker_ibd_state& i_state);
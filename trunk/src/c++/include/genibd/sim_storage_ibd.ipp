@@ -379,7 +379,7 @@ sim_storage_ibd::get_ibd(size_t i, std::vector<double> &f0,
   return true;
 }
 
-inline const sped_pointer
+inline sped_pointer
 sim_storage_ibd::get_subped(size_t i) const
 {
   return my_pair_ibds[i].get_first_ind()->subpedigree();
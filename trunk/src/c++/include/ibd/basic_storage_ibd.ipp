@@ -416,7 +416,7 @@ basic_storage_ibd::get_ibd(size_t i, std::vector<double> &f0,
   return true;
 }
 
-inline const sped_pointer
+inline sped_pointer
 basic_storage_ibd::get_subped(size_t i) const
 {
   return my_pairs[i].pair.first->subpedigree();
@@ -46,6 +46,8 @@
 
 namespace SAGE {
 
+class mapped_storage_ibd;
+
 class IBD
 {
   public:
@@ -212,6 +214,16 @@ class IBD
                                    const std::vector<double> &f1,
                                    const std::vector<double> &f2)     = 0;
 
+    // Copies the values of a binary IBD file:  marker k of pair j in the
+    // file is set as marker markers[k] of pair pairs[j].  Pairs numbered
+    // (size_t)-1 are skipped.  As in the text file, a marker is missing
+    // unless both f0 and f2 are present.  The default calls set_ibd() for
+    // each value; storage which keeps the values itself may copy them
+    // straight from the file.
+    virtual bool copy_ibd(const mapped_storage_ibd &source,
+                          const std::vector<size_t> &markers,
+                          const std::vector<size_t> &pairs);
+
     // IBD storage helper functions
 
     bool set_ibd(const mem_pointer i1, const mem_pointer i2,
@@ -301,7 +313,7 @@ class IBD
     // IBD STATE storage functions
     // IBD STATE retrieval functions
 
-    virtual const sped_pointer get_subped(size_t i) const      = 0;
+    virtual sped_pointer       get_subped(size_t i) const      = 0;
     virtual sped_pointer       get_subped(size_t i)            = 0;
 
     virtual bool set_ibd_state(size_t m, const a_marker_ibd_state& i_state) = 0;
@@ -16,6 +16,7 @@
 //==========================================================================
 
 #include "ibd/ibd.h"
+#include "ibd/ibd_sharing_engine.h"
 
 namespace SAGE {
 
@@ -64,6 +65,9 @@ class ibd_analysis
 
     a_marker_ibd_state my_ibd_state;
 
+    ibd_sharing_engine               my_sharing_engine;
+    ibd_sharing_engine::sharing_sums my_sharing_sums;
+
     bool               my_valid;
 };
 
@@ -0,0 +1,148 @@
+#ifndef IBD_SHARING_ENGINE_H
+#define IBD_SHARING_ENGINE_H
+
+//==========================================================================
+//  File:      ibd_sharing_engine.h
+//
+//  Purpose:   Accumulation of pairwise IBD sharing probabilities over all
+//             the equivalence classes of a likelihood vector.
+//
+//  Copyright (c) 2026 R.C. Elston
+//    All Rights Reserved
+//==========================================================================
+//
+// ibd_analysis::compute() needs, for every equivalence class with nonzero
+// likelihood and every pair of members, the number of alleles the pair
+// shares IBD under that class.  Doing so by moving a descent_graph to each
+// class and querying each pair is dominated by overhead:  each member's
+// alleles are re-derived through the meiosis map, and each pair's
+// relationship is re-tested, once per class.
+//
+// The engine instead compiles the meiosis map once into
+//
+//   - a descent program:  for each nonfounder allele, the parental allele
+//     pair it is drawn from and the meiosis bit which chooses between
+//     them, and
+//
+//   - a pair table:  for each pair, the relationship flags (sib, half sib,
+//     x-linked brothers) which decide how a single shared allele is
+//     attributed.
+//
+// Classes are then processed 64 at a time, one class per bit of a 64 bit
+// word.  The founder allele each allele carries is held bit sliced, one
+// word per bit of the founder allele's index, so that the descent program
+// is a masked select per word, and the test of whether two alleles are
+// identical by descent in each of the 64 classes is an xor and or over
+// the words.  A pair's four allele comparisons are summed with a bit
+// sliced adder, giving, for each pair, a mask of the classes in which it
+// shares 0, 1 (by mother or father) or 2 alleles.  Only the likelihoods of
+// the classes set in those masks are added, in class order, so the sums
+// are exactly those of the descent graph walk.
+//
+// The sharing definitions are those of descent_graph::sharing(),
+// mother_sharing() and father_sharing(), and so also assume no loops.
+
+#include <stdint.h>
+#include "ibd/definitions.h"
+
+namespace SAGE {
+
+class ibd_sharing_engine
+{
+  public:
+
+    typedef lvector::equivalence_class equivalence_class;
+
+    /// Sums of likelihood, by pair, in the order (0,1), (0,2), ... (1,2), ...
+    struct sharing_sums
+    {
+      vector<double> share0;      ///< Pair shares 0 alleles
+      vector<double> share2;      ///< Pair shares 2 alleles
+      vector<double> sib_share0;  ///< Sibs share 1 allele, from the mother
+      vector<double> sib_share2;  ///< Sibs share 1 allele, from the father
+    };
+
+    ibd_sharing_engine();
+
+    explicit ibd_sharing_engine(const meiosis_map& mm);
+
+    /// Compiles the descent program and pair table for the meiosis map.
+    void compile(const meiosis_map& mm);
+
+    /// True if the engine was compiled for a map with the same subpedigree,
+    /// x-linkage and meioses as mm, so that compiling it again for mm would
+    /// give the same program.
+    bool compiled_for(const meiosis_map& mm) const;
+
+    size_t member_count() const;
+    size_t pair_count()   const;
+
+    /// Sets sums to the total likelihood, for each pair, of the classes of
+    /// mkr in which the pair shares 0 alleles, 2 alleles, or (for sibs) 1
+    /// allele by the mother or by the father.
+    /// If states is given, the sharing state of every pair in each nonzero
+    /// class is appended to it with the class's likelihood / total, in the
+    /// form of ibd_analysis::get_ibd_state().
+    void accumulate(const lvector&      mkr,
+                    sharing_sums&       sums,
+                    a_marker_ibd_state* states = NULL,
+                    double              total  = 1.0) const;
+
+    /// The number of classes processed at a time.
+    static const size_t block_size = 64;
+
+  private:
+
+    typedef uint64_t block_mask;
+
+    /// Member i's alleles are numbered 2i (maternal) and 2i+1 (paternal).
+    /// Founder alleles carry their own number; each nonfounder allele is
+    /// derived by one step, in member order, so parents come first.
+    struct descent_step
+    {
+      size_t allele;                    ///< Allele being derived
+      size_t first;                     ///< Parental allele if the bit is 0
+      size_t second;                    ///< Parental allele if the bit is 1
+      int    bit;                       ///< The meiosis bit (-1 if fixed)
+    };
+
+    struct pair_entry
+    {
+      size_t j, k;                      ///< Members, j < k
+
+      bool   decrement;                 ///< X-linked brothers
+      bool   sib_pair;                  ///< Full or half sibs
+      bool   mother_split;              ///< May attribute to the mother
+      bool   father_split;              ///< May attribute to the father
+    };
+
+    block_mask select_mask(const descent_step&, size_t first) const;
+
+    typedef meiosis_map::subpedigree_const_pointer subpedigree_const_pointer;
+
+    size_t               my_member_count;
+    size_t               my_label_bits;        ///< Words per allele
+
+    subpedigree_const_pointer    my_subpedigree;  ///< The map compiled for
+    bool                         my_x_linked;
+    vector<meiosis_map::index>   my_meioses;      ///< Mother's, father's
+
+    vector<descent_step> my_descent;
+    vector<pair_entry>   my_pairs;
+};
+
+inline size_t
+ibd_sharing_engine::member_count() const
+{
+  return my_member_count;
+}
+
+inline size_t
+ibd_sharing_engine::pair_count() const
+{
+  return my_pairs.size();
+}
+
+} // end of namespace SAGE
+
+#endif
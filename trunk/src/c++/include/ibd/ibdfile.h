@@ -20,6 +20,7 @@
 //           and much stricter checking will be added.
 
 #include "ibd/ibd.h"
+#include "ibd/mapped_storage_ibd.h"
 
 namespace SAGE {
 
@@ -115,6 +116,7 @@ class RefIBDReadFileStdIO : public RefIBDReadFile
     typedef string_tokenizer::iterator tok_iterator;
 
     bool do_input(FILE *file, IBD *ibd);
+    bool do_input_binary(const mapped_storage_ibd &source, IBD *ibd);
     bool do_input_ibd_state(FILE *file, IBD *ibd);
 
     void input_next_line(FILE *file, std::string &line);
@@ -122,6 +124,13 @@ class RefIBDReadFileStdIO : public RefIBDReadFile
     bool read_header(FILE *file, IBD *ibd, std::string &line, ibd_option_type& ibd_option, vector<size_t>& markers);
     bool read_ibd_option(FILE *file, std::string &line, ibd_option_type& io);
 
+    size_t add_named_pair(IBD *ibd, const std::string &ped_name,
+                          const std::string &ind1_name, const std::string &ind2_name);
+
+    // As add_named_pair(), for a pedigree known to have data.
+    size_t add_pedigree_pair(IBD *ibd, const std::string &ped_name,
+                             const std::string &ind1_name, const std::string &ind2_name);
+
     bool read_pair_ids(tok_iterator &begin, tok_iterator &end, 
                        std::string &ped_name,
                        std::string &ind1_name, std::string &ind2_name);
@@ -182,6 +191,62 @@ class RefIBDWriteFile
     size_t        my_marker_count;
 };
 
+//
+// -------------------------------------------------------------------------
+//
+// Writes the binary form of the IBD probability file (see
+// mapped_storage_ibd.h) through the same interface as RefIBDWriteFile.
+// Pairs are appended pair by pair to a scratch file as they are output,
+// and transposed into per-marker columns by close() (or the destructor).
+// Nothing is visible under the final file name until then.
+//
+
+class RefIBDWriteBinaryFile
+{
+  public:
+
+    RefIBDWriteBinaryFile(const std::string &fname,
+                          std::ostream &output_messages = std::cerr);
+
+    operator void*() const { return  my_scratch; }
+    int  operator!() const { return !my_scratch; }
+
+    virtual ~RefIBDWriteBinaryFile();
+
+    virtual bool output_probability_header(const IBD *ibd);
+    virtual bool output_ibd_probability(const IBD *ibd);
+
+    bool close();
+
+  protected:
+
+    RefIBDWriteBinaryFile(const RefIBDWriteBinaryFile&);
+    RefIBDWriteBinaryFile& operator=(const RefIBDWriteBinaryFile&);
+
+    bool     is_valid_ibd(const IBD *ibd);
+    uint64_t add_string(const std::string &s);
+    bool     write_file();
+
+    void write_error(const std::string &m)
+    {
+      messages << "IBD file output [" << filename << "] " << m << endl;
+    }
+
+    std::ostream&                  messages;
+    std::string                    filename;
+    std::string                    scratch_name;
+    FILE*                          my_scratch;
+
+    bool                           my_header_written;
+
+    ibd_option_type                my_ibd_option;
+    std::vector<ibd_marker_info>   my_markers;
+    std::vector<binary_ibd_pair>   my_pairs;
+
+    std::string                    my_strings;
+    std::map<std::string, uint64_t> my_string_index;
+};
+
 }
 
 #endif
@@ -0,0 +1,229 @@
+#ifndef MAPPED_STORAGE_IBD_H
+#define MAPPED_STORAGE_IBD_H
+
+//==========================================================================
+//  Binary IBD sharing file -- read-only, memory mapped IBD storage
+//
+//  Copyright (c) 2026  R.C. Elston
+// -------------------------------------------------------------------------
+// Introduction:
+//   GENIBD can write its IBD sharing estimates in a binary, columnar form
+//   (see RefIBDWriteBinaryFile in ibdfile.h) as well as the traditional
+//   text form.  The binary file is laid out as:
+//
+//     binary_ibd_header   signature, version, counts, section offsets and
+//                         the analysis options
+//     binary_ibd_marker   one per marker
+//     binary_ibd_pair     one per pair (pedigree and member names)
+//     string table        '\0' terminated names, referred to by offset
+//     data                for each marker, three columns of pair_count()
+//                         doubles:  f0, f1mp and f2.  Missing values are
+//                         stored as quiet NaN.
+//
+//   All values are stored in the byte order of the writing machine; files
+//   from a machine of the other byte order are rejected.
+//
+//   mapped_storage_ibd maps such a file into memory and exposes it through
+//   the IBD interface without copying or parsing it.  It has no pedigree,
+//   so the pairs are only available by name, and it cannot be modified.
+//   Each marker's columns are contiguous, so a single marker can be read
+//   directly (see f0_column() and friends) without touching the rest of
+//   the file.
+//==========================================================================
+
+#include <stdint.h>
+#include "ibd/ibd.h"
+
+namespace SAGE {
+
+// ==================
+// Binary file layout
+// ==================
+
+struct binary_ibd_options
+{
+  uint64_t title;               // String table offsets
+  uint64_t region;
+  uint64_t max_pedigree;
+  uint64_t scan_type;
+  uint64_t allow_loops;
+  uint64_t ibd_mode;
+  uint64_t split_pedigrees;
+  uint64_t use_simulation;
+
+  uint32_t flags;               // option_flag bits
+  uint32_t reserved;
+
+  enum option_flag { exact = 1, x_linked = 2, ibd_state_out = 4 };
+};
+
+struct binary_ibd_header
+{
+  char     signature[8];
+  uint32_t version;
+  uint32_t byte_order;
+
+  uint64_t marker_count;
+  uint64_t pair_count;
+
+  uint64_t markers_offset;      // File offsets of each section
+  uint64_t pairs_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t data_offset;
+
+  binary_ibd_options options;
+
+  static const char     file_signature[8];
+  static const uint32_t current_version = 1;
+  static const uint32_t byte_order_mark = 0x01020304;
+};
+
+struct binary_ibd_marker
+{
+  uint64_t name;
+  double   distance;
+  uint32_t type;                // MLOCUS::GenotypeModelType
+  uint32_t reserved;
+};
+
+struct binary_ibd_pair
+{
+  uint64_t pedigree;
+  uint64_t ind1;
+  uint64_t ind2;
+};
+
+// ==================
+// mapped_storage_ibd
+// ==================
+
+class mapped_storage_ibd : public SAGE::IBD
+{
+  public:
+
+    mapped_storage_ibd();
+    explicit mapped_storage_ibd(const std::string& fname);
+
+    virtual ~mapped_storage_ibd();
+
+    // Map the file.  Returns false (and sets error()) if it cannot be
+    // opened or is not a valid binary IBD file.
+    bool open(const std::string& fname);
+    void close();
+
+    bool                 is_open() const;
+    const std::string&   error()   const;
+
+    // Returns true if the file starts with the binary IBD signature.
+    static bool is_binary_ibd_file(const std::string& fname);
+
+    // Direct access to a marker's columns, indexed by pair.
+    // Precondition: is_open() && m < marker_count()
+    const double* f0_column  (size_t m) const;
+    const double* f1mp_column(size_t m) const;
+    const double* f2_column  (size_t m) const;
+
+    // Names of a pair, without copying.
+    const char* pedigree_name(size_t i) const;
+    const char* ind1_name    (size_t i) const;
+    const char* ind2_name    (size_t i) const;
+
+    // IBD interface.  The storage is read-only:  markers and pairs cannot be
+    // added, and set_ibd() always fails.
+
+    virtual void            build();
+    virtual bool            built() const;
+
+    virtual bool            has_pedigree();
+
+    virtual size_t          add_marker(const std::string &name, double dis, gmodel_type mt);
+
+    virtual size_t          pair_count() const;
+
+    virtual const id_pair   get_pair(size_t i) const;
+    virtual id_pair         get_pair(size_t i);
+
+    virtual const id_pair   get_pair(const std::string &ped,
+                                     const std::string &i1,
+                                     const std::string &i2,
+                                     error_t &e) const;
+
+    virtual id_pair         get_pair(const std::string &ped,
+                                     const std::string &i1,
+                                     const std::string &i2,
+                                     error_t &e);
+
+    virtual bool            get_pair(size_t i, std::string &ped,
+                                     std::string &i1,
+                                     std::string &i2) const;
+
+    virtual bool            use_pair(size_t i) const;
+    virtual bool            use_pair(const mem_pointer i1, const mem_pointer i2) const;
+
+    virtual bool            valid_pair(size_t i) const;
+    virtual bool            invalidate_pair(size_t i) const;
+
+    virtual size_t          add_pair(mem_pointer i1, mem_pointer i2, pair_type pt);
+    virtual size_t          pair_index(const mem_pointer i1, const mem_pointer i2) const;
+
+    virtual bool set_ibd(size_t i, size_t m, double f0, double f2);
+    virtual bool set_ibd(size_t i, const std::vector<double> &f0,
+                                   const std::vector<double> &f2);
+
+    virtual bool set_ibd(size_t i, size_t m, double f0, double f1, double f2);
+    virtual bool set_ibd(size_t i, const std::vector<double> &f0,
+                                   const std::vector<double> &f1mp,
+                                   const std::vector<double> &f2);
+
+    virtual bool get_ibd(size_t i, size_t m, double &f0, double &f2) const;
+    virtual bool get_ibd(size_t i, std::vector<double> &f0,
+                                   std::vector<double> &f2) const;
+
+    virtual bool get_ibd(size_t i, size_t m, double &f0, double &f1mp, double &f2) const;
+    virtual bool get_ibd(size_t i, std::vector<double> &f0,
+                                   std::vector<double> &f1mp,
+                                   std::vector<double> &f2) const;
+
+    virtual sped_pointer       get_subped(size_t i) const;
+    virtual sped_pointer       get_subped(size_t i);
+
+    virtual bool set_ibd_state(size_t m, const a_marker_ibd_state& i_state);
+    virtual bool get_ibd_state(size_t m,       a_marker_ibd_state& i_state) const;
+
+    virtual bool set_ibd_state(const sped_pointer sp, const ibd_state_info& i_info);
+    virtual bool get_ibd_state(const sped_pointer sp,       ibd_state_info& i_info) const;
+
+  protected:
+
+    mapped_storage_ibd(const mapped_storage_ibd&);
+    mapped_storage_ibd& operator=(const mapped_storage_ibd&);
+
+    bool fail(const std::string& message);
+    bool validate();
+
+    const char*   string_at(uint64_t offset) const;
+    const double* column   (size_t m, size_t c) const;
+
+    const char*                my_base;
+    size_t                     my_size;
+
+#if defined(WIN32)
+    std::vector<char>          my_buffer;   // No mmap; the file is read in
+#endif
+
+    const binary_ibd_header*   my_header;
+    const binary_ibd_pair*     my_pairs;
+    const char*                my_strings;
+    const double*              my_data;
+
+    size_t                     my_pair_count;
+
+    std::string                my_error;
+};
+
+#include "ibd/mapped_storage_ibd.ipp"
+
+} // end of namespace SAGE
+
+#endif
@@ -0,0 +1,298 @@
+// ==================
+// mapped_storage_ibd
+// ==================
+
+inline bool
+mapped_storage_ibd::is_open() const
+{
+  return my_header != NULL;
+}
+
+inline const std::string&
+mapped_storage_ibd::error() const
+{
+  return my_error;
+}
+
+inline const char*
+mapped_storage_ibd::string_at(uint64_t offset) const
+{
+  return my_strings + offset;
+}
+
+inline const double*
+mapped_storage_ibd::column(size_t m, size_t c) const
+{
+  return my_data + (3 * m + c) * my_pair_count;
+}
+
+inline const double*
+mapped_storage_ibd::f0_column(size_t m) const
+{
+  return column(m, 0);
+}
+
+inline const double*
+mapped_storage_ibd::f1mp_column(size_t m) const
+{
+  return column(m, 1);
+}
+
+inline const double*
+mapped_storage_ibd::f2_column(size_t m) const
+{
+  return column(m, 2);
+}
+
+inline const char*
+mapped_storage_ibd::pedigree_name(size_t i) const
+{
+  return string_at(my_pairs[i].pedigree);
+}
+
+inline const char*
+mapped_storage_ibd::ind1_name(size_t i) const
+{
+  return string_at(my_pairs[i].ind1);
+}
+
+inline const char*
+mapped_storage_ibd::ind2_name(size_t i) const
+{
+  return string_at(my_pairs[i].ind2);
+}
+
+inline void
+mapped_storage_ibd::build()
+{ }
+
+inline bool
+mapped_storage_ibd::built() const
+{
+  return is_open();
+}
+
+inline bool
+mapped_storage_ibd::has_pedigree()
+{
+  return false;
+}
+
+inline size_t
+mapped_storage_ibd::add_marker(const std::string &name, double dis, gmodel_type mt)
+{
+  return marker_index(name);
+}
+
+inline size_t
+mapped_storage_ibd::pair_count() const
+{
+  return my_pair_count;
+}
+
+inline const id_pair
+mapped_storage_ibd::get_pair(size_t i) const
+{
+  return std::make_pair((mem_pointer) NULL, (mem_pointer) NULL);
+}
+
+inline id_pair
+mapped_storage_ibd::get_pair(size_t i)
+{
+  return std::make_pair((mem_pointer) NULL, (mem_pointer) NULL);
+}
+
+inline const id_pair
+mapped_storage_ibd::get_pair(const std::string &ped,
+                             const std::string &i1,
+                             const std::string &i2,
+                             error_t &e) const
+{
+  e = bad_pedigree;
+
+  return std::make_pair((mem_pointer) NULL, (mem_pointer) NULL);
+}
+
+inline id_pair
+mapped_storage_ibd::get_pair(const std::string &ped,
+                             const std::string &i1,
+                             const std::string &i2,
+                             error_t &e)
+{
+  e = bad_pedigree;
+
+  return std::make_pair((mem_pointer) NULL, (mem_pointer) NULL);
+}
+
+inline bool
+mapped_storage_ibd::get_pair(size_t i, std::string &ped, std::string &i1, std::string &i2) const
+{
+  if(i >= pair_count()) return false;
+
+  ped = pedigree_name(i);
+  i1  = ind1_name(i);
+  i2  = ind2_name(i);
+
+  return true;
+}
+
+inline bool
+mapped_storage_ibd::use_pair(size_t i) const
+{
+  return i < pair_count();
+}
+
+inline bool
+mapped_storage_ibd::use_pair(const mem_pointer i1, const mem_pointer i2) const
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::valid_pair(size_t i) const
+{
+  return i < pair_count();
+}
+
+inline bool
+mapped_storage_ibd::invalidate_pair(size_t i) const
+{
+  return false;
+}
+
+inline size_t
+mapped_storage_ibd::add_pair(mem_pointer i1, mem_pointer i2, pair_type pt)
+{
+  return (size_t) -1;
+}
+
+inline size_t
+mapped_storage_ibd::pair_index(const mem_pointer i1, const mem_pointer i2) const
+{
+  return pair_count();
+}
+
+inline bool
+mapped_storage_ibd::set_ibd(size_t i, size_t m, double f0, double f2)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::set_ibd(size_t i, const std::vector<double> &f0,
+                                      const std::vector<double> &f2)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::set_ibd(size_t i, size_t m, double f0, double f1, double f2)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::set_ibd(size_t i, const std::vector<double> &f0,
+                                      const std::vector<double> &f1mp,
+                                      const std::vector<double> &f2)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd(size_t i, size_t m, double &f0, double &f2) const
+{
+  if(i >= pair_count() || m >= marker_count()) return false;
+
+  f0 = f0_column(m)[i];
+  f2 = f2_column(m)[i];
+
+  return true;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd(size_t i, std::vector<double> &f0,
+                                      std::vector<double> &f2) const
+{
+  if(i >= pair_count()) return false;
+
+  f0.resize(marker_count());
+  f2.resize(marker_count());
+
+  for(size_t m = 0; m < marker_count(); ++m)
+  {
+    f0[m] = f0_column(m)[i];
+    f2[m] = f2_column(m)[i];
+  }
+
+  return true;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd(size_t i, size_t m, double &f0, double &f1mp, double &f2) const
+{
+  if(i >= pair_count() || m >= marker_count()) return false;
+
+  f0   = f0_column(m)[i];
+  f1mp = f1mp_column(m)[i];
+  f2   = f2_column(m)[i];
+
+  return true;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd(size_t i, std::vector<double> &f0,
+                                      std::vector<double> &f1mp,
+                                      std::vector<double> &f2) const
+{
+  if(i >= pair_count()) return false;
+
+  f0.resize(marker_count());
+  f1mp.resize(marker_count());
+  f2.resize(marker_count());
+
+  for(size_t m = 0; m < marker_count(); ++m)
+  {
+    f0[m]   = f0_column(m)[i];
+    f1mp[m] = f1mp_column(m)[i];
+    f2[m]   = f2_column(m)[i];
+  }
+
+  return true;
+}
+
+inline sped_pointer
+mapped_storage_ibd::get_subped(size_t i) const
+{
+  return NULL;
+}
+
+inline sped_pointer
+mapped_storage_ibd::get_subped(size_t i)
+{
+  return NULL;
+}
+
+inline bool
+mapped_storage_ibd::set_ibd_state(size_t m, const a_marker_ibd_state& i_state)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd_state(size_t m, a_marker_ibd_state& i_state) const
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::set_ibd_state(const sped_pointer sp, const ibd_state_info& i_info)
+{
+  return false;
+}
+
+inline bool
+mapped_storage_ibd::get_ibd_state(const sped_pointer sp, ibd_state_info& i_info) const
+{
+  return false;
+}
@@ -56,8 +56,6 @@ class analysis
     void  analyze();
     void  write(ostream& summary, ostream& detail, APP::SAGEapp& app);
     
-    static void  clear();
-    
   private:
     static void  write_results_label(ostream& out);
     void  build_filtered_mped();
@@ -70,9 +68,11 @@ class analysis
     const RPED::RefMultiPedigree&  my_original_mped;
     FPED::FilteredMultipedigree  my_mped;
     const instructions&  my_instructions;
+    ge_models  my_models;           // Genotype elimination models of my_mped's subpedigrees.
     
     typedef boost::shared_ptr<task>  task_ptr;
     vector<task_ptr>  my_tasks;
+    smiths_alt_results  my_smiths_alt;
     
     bool  aborted;
 };
@@ -27,6 +27,7 @@
 #include "mlocus/penmodel.h"
 #include "lodlink/definitions.h"
 #include "lodlink/trans_calculator.h"
+#include "lodlink/theta_polynomial.h"
 
 using std::vector;
 using std::pair;
@@ -38,8 +39,6 @@ namespace SAGE
 namespace peeling
 {
 
-typedef pair<size_t, vector<log_double> >  posterior_vector;
-
 template<class T1, class T2> 
 struct pv_equal : public std::binary_function<T1, T2, bool>
 {
@@ -47,23 +46,51 @@ struct pv_equal : public std::binary_function<T1, T2, bool>
 };
 
 //----------------------------------------------------------------------------
-//  Class:    individual_cache<joint_pen_iter, log_double>
+//  Struct:   result_traits
+//                                                                          
+//  Purpose:  mark a cached anterior or posterior as not yet calculated and
+//            test for the mark.
+//                                                                          
+//----------------------------------------------------------------------------
+//
+template<class R>
+struct result_traits;
+
+template<>
+struct result_traits<log_double>
+{
+  static log_double  uncalculated();
+  static bool  calculated(const log_double& r);
+};
+
+template<>
+struct result_traits<SAGE::LODLINK::theta_polynomial>
+{
+  static SAGE::LODLINK::theta_polynomial  uncalculated();
+  static bool  calculated(const SAGE::LODLINK::theta_polynomial& r);
+};
+
+//----------------------------------------------------------------------------
+//  Class:    individual_cache<joint_pen_iter, R>
 //                                                                          
 //  Purpose:  specialization of a class to store information about an
 //            individual's anterior and posterior values for use when calc-
 //            ulating pedigree likelihoods by the method of Fernando, Stricker
-//            and Elston.  1993.
+//            and Elston.  1993.  R is log_double for likelihoods at given
+//            recombination fractions, theta_polynomial for likelihoods as
+//            functions of them.
 //                                                                          
 //----------------------------------------------------------------------------
 //
-template<>
-class individual_cache<joint_pen_iter, log_double>
+template<class R>
+class individual_cache<joint_pen_iter, R>
 {
   public:
-    typedef log_double  result_type;
+    typedef R  result_type;
     typedef joint_pen_iter  data_type;
       
     typedef FPED::FilteredMultipedigree::member_type  member_type;
+    typedef pair<size_t, vector<R> >  posterior_vector;
     
     individual_cache();
     void build(const member_type& ind, size_t tph_id, size_t mph_id, 
@@ -74,27 +101,27 @@ class individual_cache<joint_pen_iter, log_double>
     bool  posterior_with_mate_cached(const member_type& mate_index, const joint_pen_iter& jpi) const;
     bool  posterior_except_mate_cached(const member_type& mate_index, const joint_pen_iter& jpi) const;
     
-    log_double&  anterior(const joint_pen_iter& jpi);
-    log_double&  posterior(const joint_pen_iter& jpi);
-    log_double&  posterior_with_mate(const member_type& mate_index, const joint_pen_iter& jpi);
-    log_double&  posterior_except_mate(const member_type& mate_index, const joint_pen_iter& jpi);
+    R&  anterior(const joint_pen_iter& jpi);
+    R&  posterior(const joint_pen_iter& jpi);
+    R&  posterior_with_mate(const member_type& mate_index, const joint_pen_iter& jpi);
+    R&  posterior_except_mate(const member_type& mate_index, const joint_pen_iter& jpi);
     
-    const log_double&  anterior(const joint_pen_iter& jpi) const;
-    const log_double&  posterior(const joint_pen_iter& jpi) const;
-    const log_double&  posterior_with_mate(const member_type& mate_index, const joint_pen_iter& jpi) const;
-    const log_double&  posterior_except_mate(const member_type& mate_index, const joint_pen_iter& jpi) const;
+    const R&  anterior(const joint_pen_iter& jpi) const;
+    const R&  posterior(const joint_pen_iter& jpi) const;
+    const R&  posterior_with_mate(const member_type& mate_index, const joint_pen_iter& jpi) const;
+    const R&  posterior_except_mate(const member_type& mate_index, const joint_pen_iter& jpi) const;
 
   private:
     size_t  phenoset_index(const joint_pen_iter& jpi) const;
-    vector<log_double>&  posteriors_with_mate(size_t mate) const;
-    vector<log_double>&  posteriors_except_mate(size_t mate) const;
+    vector<R>&  posteriors_with_mate(size_t mate) const;
+    vector<R>&  posteriors_except_mate(size_t mate) const;
     
     // Data members.
     std::map<size_t, size_t>  t_indices;         // <trait genotype id, matrix row x col count>
     std::map<size_t, size_t>  m_indices;         // <marker genotype id, matrix col>
     
-    mutable vector<log_double>  my_anteriors;
-    mutable vector<log_double>  my_posteriors;
+    mutable vector<R>  my_anteriors;
+    mutable vector<R>  my_posteriors;
     mutable vector<posterior_vector>  my_posteriors_with_mate;
     mutable vector<posterior_vector>  my_posteriors_except_mate;
 };
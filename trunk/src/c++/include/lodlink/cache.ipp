@@ -23,12 +23,40 @@ pv_equal<T1, T2>::operator()(T1 first, T2 second) const
   return first.first == second;
 }
 
+//============================================================================
+// IMPLEMENTATION:  result_traits
+//============================================================================
+//
+inline log_double
+result_traits<log_double>::uncalculated()
+{
+  return log_double(QNAN);
+}
+
+inline bool
+result_traits<log_double>::calculated(const log_double& r)
+{
+  return ! SAGE::isnan(r.get_double());
+}
+
+inline SAGE::LODLINK::theta_polynomial
+result_traits<SAGE::LODLINK::theta_polynomial>::uncalculated()
+{
+  return SAGE::LODLINK::theta_polynomial();
+}
+
+inline bool
+result_traits<SAGE::LODLINK::theta_polynomial>::calculated(const SAGE::LODLINK::theta_polynomial& r)
+{
+  return r.is_set();
+}
+
 //============================================================================
 // IMPLEMENTATION:  individual_cache
 //============================================================================
 //
-inline
-individual_cache<joint_pen_iter, log_double>::individual_cache()
+template<class R> inline
+individual_cache<joint_pen_iter, R>::individual_cache()
 {}
 
 // - Elements of t_indices and m_indices correspond to possible trait and 
@@ -36,8 +64,8 @@ individual_cache<joint_pen_iter, log_double>::individual_cache()
 //   posteriors, etc.  Client code should only use penetrance iterators whose
 //   genotypes are penetrant to access cached values.
 //
-inline void
-individual_cache<joint_pen_iter, log_double>::build
+template<class R> inline void
+individual_cache<joint_pen_iter, R>::build
 (const member_type& ind, size_t tph_id, size_t mph_id, 
  const MLOCUS::penetrance_model& tm, const MLOCUS::penetrance_model& mm)
 {
@@ -61,14 +89,14 @@ individual_cache<joint_pen_iter, log_double>::build
   
   size_t  phenoset_size = pmg_count * ptg_count;
   
-  my_anteriors.resize(phenoset_size, log_double(QNAN));
-  my_posteriors.resize(phenoset_size, log_double(QNAN));
+  my_anteriors.resize(phenoset_size, result_traits<R>::uncalculated());
+  my_posteriors.resize(phenoset_size, result_traits<R>::uncalculated());
   
   size_t  p_size = ind.mate_count();
   my_posteriors_with_mate.resize(p_size, make_pair((size_t)(-1), 
-                                   vector<log_double>(phenoset_size, log_double(QNAN))));
+                                   vector<R>(phenoset_size, result_traits<R>::uncalculated())));
   my_posteriors_except_mate.resize(p_size, make_pair((size_t)(-1), 
-                                   vector<log_double>(phenoset_size, log_double(QNAN))));
+                                   vector<R>(phenoset_size, result_traits<R>::uncalculated())));
   
   FPED::Pedigree::mate_const_iterator  iter;
   size_t  i = 0;
@@ -85,54 +113,54 @@ individual_cache<joint_pen_iter, log_double>::build
 //
 // ------------------------- cached? ------------------------------------
 //
-inline bool
-individual_cache<joint_pen_iter, log_double>::anterior_cached(const joint_pen_iter& jpi) const
+template<class R> inline bool
+individual_cache<joint_pen_iter, R>::anterior_cached(const joint_pen_iter& jpi) const
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_anteriors.size());
-  bool  cached = ! SAGE::isnan(my_anteriors[index].get_double());
+  bool  cached = result_traits<R>::calculated(my_anteriors[index]);
   
   //cout << (cached ? " ANTERIOR CACHED " : "ANTERIOR NOT CACHED ") << endl;
   
   return cached;
 }
 
-inline bool
-individual_cache<joint_pen_iter, log_double>::posterior_cached(const joint_pen_iter& jpi) const
+template<class R> inline bool
+individual_cache<joint_pen_iter, R>::posterior_cached(const joint_pen_iter& jpi) const
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_posteriors.size());
-  bool  cached = ! SAGE::isnan(my_posteriors[index].get_double());
+  bool  cached = result_traits<R>::calculated(my_posteriors[index]);
   
   //cout << (cached ? " POSTERIOR CACHED " : " POSTERIOR NOT CACHED ") << endl;
   
   return cached;
 }
 
-inline bool
-individual_cache<joint_pen_iter, log_double>::posterior_with_mate_cached
+template<class R> inline bool
+individual_cache<joint_pen_iter, R>::posterior_with_mate_cached
 (const member_type& mate_index, const joint_pen_iter& jpi) const
 {
-  vector<log_double>&  posteriors = posteriors_with_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_with_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
-  bool  cached = ! SAGE::isnan(posteriors[index].get_double());
+  bool  cached = result_traits<R>::calculated(posteriors[index]);
   
   //cout << (cached ? " POSTERIOR WITH MATE CACHED " : " POSTERIOR WITH MATE NOT CACHED ") << endl;
   
   return cached;
 }
 
-inline bool
-individual_cache<joint_pen_iter, log_double>::posterior_except_mate_cached
+template<class R> inline bool
+individual_cache<joint_pen_iter, R>::posterior_except_mate_cached
 (const member_type& mate_index, const joint_pen_iter& jpi) const
 {
-  vector<log_double>&  posteriors = posteriors_except_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_except_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
-  bool  cached = ! SAGE::isnan(posteriors[index].get_double());
+  bool  cached = result_traits<R>::calculated(posteriors[index]);
   
   //cout << (cached ? " POSTERIOR EXCEPT MATE CACHED " : " POSTERIOR EXCEPT MATE NOT CACHED ") << endl;
   
@@ -142,8 +170,8 @@ individual_cache<joint_pen_iter, log_double>::posterior_except_mate_cached
 //
 // ----------------------- get non-const reference ------------------------
 //
-inline log_double&
-individual_cache<joint_pen_iter, log_double>::anterior(const joint_pen_iter& jpi) 
+template<class R> inline R&
+individual_cache<joint_pen_iter, R>::anterior(const joint_pen_iter& jpi) 
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_anteriors.size());
@@ -151,8 +179,8 @@ individual_cache<joint_pen_iter, log_double>::anterior(const joint_pen_iter& jpi
   return my_anteriors[index];
 }
 
-inline log_double&
-individual_cache<joint_pen_iter, log_double>::posterior(const joint_pen_iter& jpi) 
+template<class R> inline R&
+individual_cache<joint_pen_iter, R>::posterior(const joint_pen_iter& jpi) 
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_posteriors.size());
@@ -160,11 +188,11 @@ individual_cache<joint_pen_iter, log_double>::posterior(const joint_pen_iter& jp
   return my_posteriors[index];
 }
 
-inline log_double&
-individual_cache<joint_pen_iter, log_double>::posterior_with_mate
+template<class R> inline R&
+individual_cache<joint_pen_iter, R>::posterior_with_mate
 (const member_type& mate_index, const joint_pen_iter& jpi)
 {
-  vector<log_double>&  posteriors = posteriors_with_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_with_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
@@ -172,11 +200,11 @@ individual_cache<joint_pen_iter, log_double>::posterior_with_mate
   return  posteriors[index];
 }
 
-inline log_double&
-individual_cache<joint_pen_iter, log_double>::posterior_except_mate
+template<class R> inline R&
+individual_cache<joint_pen_iter, R>::posterior_except_mate
 (const member_type& mate_index, const joint_pen_iter& jpi)
 {
-  vector<log_double>&  posteriors = posteriors_except_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_except_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
@@ -187,8 +215,8 @@ individual_cache<joint_pen_iter, log_double>::posterior_except_mate
 //
 // ----------------------- get const reference ------------------------
 //
-inline const log_double&
-individual_cache<joint_pen_iter, log_double>::anterior(const joint_pen_iter& jpi) const 
+template<class R> inline const R&
+individual_cache<joint_pen_iter, R>::anterior(const joint_pen_iter& jpi) const 
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_anteriors.size());
@@ -196,8 +224,8 @@ individual_cache<joint_pen_iter, log_double>::anterior(const joint_pen_iter& jpi
   return my_anteriors[index];
 }
 
-inline const log_double&
-individual_cache<joint_pen_iter, log_double>::posterior(const joint_pen_iter& jpi) const
+template<class R> inline const R&
+individual_cache<joint_pen_iter, R>::posterior(const joint_pen_iter& jpi) const
 {
   size_t  index = phenoset_index(jpi);
   assert(index < my_posteriors.size());
@@ -205,11 +233,11 @@ individual_cache<joint_pen_iter, log_double>::posterior(const joint_pen_iter& jp
   return my_posteriors[index];
 }
 
-inline const log_double&
-individual_cache<joint_pen_iter, log_double>::posterior_with_mate
+template<class R> inline const R&
+individual_cache<joint_pen_iter, R>::posterior_with_mate
 (const member_type& mate_index, const joint_pen_iter& jpi) const
 {
-  vector<log_double>&  posteriors = posteriors_with_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_with_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
@@ -217,11 +245,11 @@ individual_cache<joint_pen_iter, log_double>::posterior_with_mate
   return  posteriors[index];
 }
 
-inline const log_double&
-individual_cache<joint_pen_iter, log_double>::posterior_except_mate
+template<class R> inline const R&
+individual_cache<joint_pen_iter, R>::posterior_except_mate
 (const member_type& mate_index, const joint_pen_iter& jpi) const
 {
-  vector<log_double>&  posteriors = posteriors_except_mate(mate_index.index());
+  vector<R>&  posteriors = posteriors_except_mate(mate_index.index());
   
   size_t  index = phenoset_index(jpi);
   assert(index < posteriors.size());
@@ -232,8 +260,8 @@ individual_cache<joint_pen_iter, log_double>::posterior_except_mate
 //
 // ----------------------- ancillary functions ----------------------------
 //
-inline size_t
-individual_cache<joint_pen_iter, log_double>::phenoset_index(const joint_pen_iter& jpi) const
+template<class R> inline size_t
+individual_cache<joint_pen_iter, R>::phenoset_index(const joint_pen_iter& jpi) const
 {
   std::map<size_t, size_t>::const_iterator  row = t_indices.find(jpi.trait_iter.geno_id());
   std::map<size_t, size_t>::const_iterator  col = m_indices.find(jpi.marker_iter.geno_id());
@@ -245,10 +273,10 @@ individual_cache<joint_pen_iter, log_double>::phenoset_index(const joint_pen_ite
 
 // - Find posteriors corresponding to a specific mate.
 //
-inline vector<log_double>&
-individual_cache<joint_pen_iter, log_double>::posteriors_with_mate(size_t mate) const
+template<class R> inline vector<R>&
+individual_cache<joint_pen_iter, R>::posteriors_with_mate(size_t mate) const
 {
-  vector<posterior_vector>::iterator  iter;
+  typename vector<posterior_vector>::iterator  iter;
   iter = find_if(my_posteriors_with_mate.begin(), my_posteriors_with_mate.end(),
                  bind2nd(pv_equal<posterior_vector, size_t>(), mate));
   assert(iter != my_posteriors_with_mate.end());
@@ -258,10 +286,10 @@ individual_cache<joint_pen_iter, log_double>::posteriors_with_mate(size_t mate)
 
 // - Find posteriors corresponding to a specific mate.
 //
-inline vector<log_double>&
-individual_cache<joint_pen_iter, log_double>::posteriors_except_mate(size_t mate) const
+template<class R> inline vector<R>&
+individual_cache<joint_pen_iter, R>::posteriors_except_mate(size_t mate) const
 {
-  vector<posterior_vector>::iterator  iter;
+  typename vector<posterior_vector>::iterator  iter;
   iter = find_if(my_posteriors_except_mate.begin(), my_posteriors_except_mate.end(),
                  bind2nd(pv_equal<posterior_vector, size_t>(), mate));
   assert(iter != my_posteriors_except_mate.end());
@@ -32,7 +32,8 @@ namespace LODLINK
 //----------------------------------------------------------------------------
 //  Class:    ge_models
 //                                                                          
-//  Purpose:  create and cache genotype-eliminated penetrance models.
+//  Purpose:  create and cache genotype-eliminated penetrance models.  Each
+//            analysis owns its models, so that analyses do not share them.
 //                                                                          
 //----------------------------------------------------------------------------
 //
@@ -43,13 +44,13 @@ class ge_models
     typedef FPED::FilteredMultipedigree::subpedigree_const_pointer      subped_ptr;
     typedef std::map<pair<subped_ptr, size_t>, MLOCUS::penetrance_model>  model_map;
 
-    static void clear_models();
+    void clear_models();
     
-    static const MLOCUS::penetrance_model&  get_model(const subpedigree& subped, size_t locus_idx);
+    const MLOCUS::penetrance_model&  get_model(const subpedigree& subped, size_t locus_idx);
 
   private:  
-    static pedigree_imodel_generator  my_generator;
-    static model_map                  my_models;
+    pedigree_imodel_generator  my_generator;
+    model_map                  my_models;
 };
 
 }
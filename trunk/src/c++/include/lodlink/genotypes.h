@@ -40,7 +40,8 @@ class genotype_probs : public task
   protected:
     enum  types { aa, ab, bb };
   
-    genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                   ge_models& models);
     
     void  calculate_genotypes(peeler& plr, const member_type& ind, genotype_result& result);
     
@@ -61,7 +62,8 @@ class non_ss_genotype_probs : public genotype_probs
     friend void do_task_calculations<non_ss_genotype_probs, non_ss_genotype_result>(non_ss_genotype_probs&);
 
   public:
-    non_ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    non_ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                          ge_models& models);
 
     void  calculate();
     void  write_detail(ostream& out) const;
@@ -91,7 +93,8 @@ class ss_genotype_probs : public genotype_probs
     friend void do_task_calculations<ss_genotype_probs, ss_genotype_result>(ss_genotype_probs&);  
 
   public:
-    ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                      ge_models& models);
     
     void  calculate();
     void  write_detail(ostream& out) const;
@@ -17,8 +17,8 @@
 //
 inline
 genotype_probs::genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                     const instructions& instr)
-      : task(errors, mped, instr)
+                                     const instructions& instr, ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline void  
@@ -34,8 +34,8 @@ genotype_probs::announce_start() const
 //
 inline
 non_ss_genotype_probs::non_ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                                   const instructions& instr)
-      : genotype_probs(errors, mped, instr)
+                                                   const instructions& instr, ge_models& models)
+      : genotype_probs(errors, mped, instr, models)
 {}
 
 
@@ -45,6 +45,6 @@ non_ss_genotype_probs::non_ss_genotype_probs(cerrorstream& errors, const FPED::F
 //
 inline
 ss_genotype_probs::ss_genotype_probs(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                           const instructions& instr)
-      : genotype_probs(errors, mped, instr)
+                                           const instructions& instr, ge_models& models)
+      : genotype_probs(errors, mped, instr, models)
 {}
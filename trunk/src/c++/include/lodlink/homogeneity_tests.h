@@ -53,7 +53,8 @@ class non_ss_mortons_test : public task
     friend void do_task_calculations<non_ss_mortons_test, non_ss_mortons_result>(non_ss_mortons_test&);
 
   public:
-    non_ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    non_ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                        ge_models& models);
 
     void  announce_start() const;
     void  calculate();
@@ -80,7 +81,8 @@ class ss_mortons_test : public task
   friend void do_task_calculations<ss_mortons_test, ss_mortons_result>(ss_mortons_test&);
 
   public:
-    ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                    ge_models& models);
 
     void  announce_start() const;
     void  calculate();
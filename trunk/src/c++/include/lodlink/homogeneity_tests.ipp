@@ -17,8 +17,8 @@
 //
 inline
 non_ss_mortons_test::non_ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                              const instructions& instr)
-      : task(errors, mped, instr)
+                                              const instructions& instr, ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline void  
@@ -34,8 +34,8 @@ non_ss_mortons_test::announce_start() const
 //
 inline
 ss_mortons_test::ss_mortons_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                       const instructions& instr)
-      : task(errors, mped, instr)
+                                       const instructions& instr, ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline void  
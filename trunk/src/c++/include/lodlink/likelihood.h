@@ -15,9 +15,11 @@
 //============================================================================
 
 
+#include <map>
 #include "fped/fped.h"
 #include "maxfun/maxfun.h"
 #include "lodlink/peeler.h"
+#include "lodlink/poly_peeler.h"
 #include "lodlink/instructions.h"
 
 namespace SAGE
@@ -60,10 +62,54 @@ class subped_calculator : public MaxFunction
 };
 
 
+//----------------------------------------------------------------------------
+//  Class:    polynomial_calculator
+//                                                                          
+//  Purpose:  calculate subpedigree likelihoods for a trait and marker from
+//            polynomials in the recombination fractions.  Each subpedigree
+//            is peeled once, on first use, by a poly_peeler.  Subpedigrees
+//            too large for a poly_peeler are peeled w. a peeler on each call.
+//                                                                          
+//----------------------------------------------------------------------------
+//
+class polynomial_calculator
+{
+  public:
+    typedef SAGE::FPED::FilteredMultipedigree::subpedigree_type  subped_type;
+  
+    polynomial_calculator(size_t trait, size_t marker, ge_models& models);
+    
+    size_t  trait() const;
+    size_t  marker() const;
+    
+    // - Same values as subped_calculator::likelihood() and unlinked_likelihood()
+    //   for a peeler w. the given mle_sub_model.
+    //
+    log_double  likelihood(const subped_type& subped, const mle_sub_model& mle);
+    log_double  unlinked_likelihood(const subped_type& subped);
+
+  private:
+    const theta_polynomial&  polynomial(const subped_type& subped);
+  
+    polynomial_calculator(const polynomial_calculator& other);
+    polynomial_calculator& operator=(const polynomial_calculator& other);
+    
+    // Data members.
+    size_t  my_trait;
+    size_t  my_marker;
+    ge_models&  my_models;
+    
+    std::map<const subped_type*, theta_polynomial>  my_polynomials;   // Unset if too large.
+    std::map<const subped_type*, log_double>        my_unlinked_likelihoods;
+};
+
+
 //----------------------------------------------------------------------------
 //  Class:    ped_calculator
 //                                                                          
-//  Purpose:  calculate likelihood of a pedigree.
+//  Purpose:  calculate likelihood of a pedigree.  If a polynomial_calculator
+//            for the trait and marker is given, subpedigree likelihoods come
+//            from it; likewise for the group and multi-pedigree calculators.
 //                                                                          
 //----------------------------------------------------------------------------
 //
@@ -73,7 +119,8 @@ class ped_calculator : public MaxFunction
     typedef SAGE::FPED::FilteredMultipedigree::subpedigree_const_iterator  subpedigree_const_iterator;
   
     ped_calculator(const FPED::Pedigree& ped, const mle_sub_model& mle,
-                    size_t trait, size_t marker);
+                    size_t trait, size_t marker, ge_models& models,
+                    polynomial_calculator* polys = 0);
     log_double  likelihood();
     log_double  unlinked_likelihood();
 
@@ -91,6 +138,8 @@ class ped_calculator : public MaxFunction
     const mle_sub_model&   my_mle;
     size_t                 my_trait;
     size_t                 my_marker;
+    ge_models&             my_models;
+    polynomial_calculator* my_polynomials;
     
     log_double  my_unlinked_likelihood;
     bool        unlinked_likelihood_cached;    
@@ -121,7 +170,8 @@ class group_calculator : public MaxFunction
 {
   public:
     group_calculator(const group& g, const FPED::FilteredMultipedigree& mped, const mle_sub_model& mle,
-                    size_t trait, size_t marker);
+                    size_t trait, size_t marker, ge_models& models,
+                    polynomial_calculator* polys = 0);
     log_double  likelihood();
 
   private:
@@ -137,6 +187,8 @@ class group_calculator : public MaxFunction
     const mle_sub_model&   my_mle;
     size_t                 my_trait;
     size_t                 my_marker;
+    ge_models&             my_models;
+    polynomial_calculator* my_polynomials;
 };
 
 
@@ -154,7 +206,8 @@ class mped_calculator : public MaxFunction
     typedef SAGE::FPED::FilteredMultipedigree::subpedigree_const_iterator  subpedigree_const_iterator;
   
     mped_calculator(const FPED::FilteredMultipedigree& mped, const mle_sub_model& mle,
-                    size_t trait, size_t marker);
+                    size_t trait, size_t marker, ge_models& models,
+                    polynomial_calculator* polys = 0);
     log_double  likelihood();
     log_double  unlinked_likelihood();
 
@@ -172,6 +225,8 @@ class mped_calculator : public MaxFunction
     const mle_sub_model&     my_mle;
     size_t                   my_trait;
     size_t                   my_marker;
+    ge_models&               my_models;
+    polynomial_calculator*   my_polynomials;
     
     log_double  my_unlinked_likelihood;
     bool        unlinked_likelihood_cached;    
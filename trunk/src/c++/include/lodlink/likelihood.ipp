@@ -81,14 +81,38 @@ subped_calculator::update_bounds(parameter_vector& theta)
 }
 
 
+//============================================================================
+// IMPLEMENTATION:  polynomial_calculator
+//============================================================================
+//
+inline
+polynomial_calculator::polynomial_calculator(size_t trait, size_t marker, ge_models& models)
+      : my_trait(trait), my_marker(marker), my_models(models)
+{}
+
+inline size_t
+polynomial_calculator::trait() const
+{
+  return my_trait;
+}
+
+inline size_t
+polynomial_calculator::marker() const
+{
+  return my_marker;
+}
+
+
 //============================================================================
 // IMPLEMENTATION:  ped_calculator
 //============================================================================
 //
 inline
 ped_calculator::ped_calculator(const FPED::Pedigree& ped, const mle_sub_model& mle,
-                                 size_t trait, size_t marker)
-      : my_ped(ped), my_mle(mle), my_trait(trait), my_marker(marker),
+                                 size_t trait, size_t marker, ge_models& models,
+                                 polynomial_calculator* polys)
+      : my_ped(ped), my_mle(mle), my_trait(trait), my_marker(marker), my_models(models),
+        my_polynomials(polys),
         my_unlinked_likelihood(QNAN), unlinked_likelihood_cached(false)
 {
   nfe = 0;
@@ -128,8 +152,10 @@ ped_calculator::update_bounds(parameter_vector& theta)
 //
 inline
 group_calculator::group_calculator(const group& g, const FPED::FilteredMultipedigree& mped, 
-                                   const mle_sub_model& mle, size_t trait, size_t marker)
-      : my_mle(mle), my_trait(trait), my_marker(marker)
+                                   const mle_sub_model& mle, size_t trait, size_t marker,
+                                   ge_models& models, polynomial_calculator* polys)
+      : my_mle(mle), my_trait(trait), my_marker(marker), my_models(models),
+        my_polynomials(polys)
 {
   build_group(g, mped);
   nfe = 0;
@@ -169,8 +195,10 @@ group_calculator::update_bounds(parameter_vector& theta)
 //
 inline
 mped_calculator::mped_calculator(const FPED::FilteredMultipedigree& mped, const mle_sub_model& mle,
-                                 size_t trait, size_t marker)
-      : my_mped(mped), my_mle(mle), my_trait(trait), my_marker(marker),
+                                 size_t trait, size_t marker, ge_models& models,
+                                 polynomial_calculator* polys)
+      : my_mped(mped), my_mle(mle), my_trait(trait), my_marker(marker), my_models(models),
+        my_polynomials(polys),
         my_unlinked_likelihood(QNAN), unlinked_likelihood_cached(false)
 {
   nfe = 0;
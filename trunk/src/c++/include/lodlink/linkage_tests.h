@@ -52,7 +52,8 @@ class non_ss_lod_ratio_test : public task
 
     friend void do_task_calculations<non_ss_lod_ratio_test, non_ss_lod_ratio_result>(non_ss_lod_ratio_test&);
 
-    non_ss_lod_ratio_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    non_ss_lod_ratio_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                          ge_models& models);
     ~non_ss_lod_ratio_test();
     
     void  announce_start() const;
@@ -82,7 +83,8 @@ class ss_lod_ratio_test : public task
     friend void do_task_calculations<ss_lod_ratio_test, ss_lod_ratio_result>(ss_lod_ratio_test&);
 
   public:
-    ss_lod_ratio_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    ss_lod_ratio_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                      ge_models& models);
     ~ss_lod_ratio_test();
     
     void  announce_start() const;
@@ -117,7 +119,8 @@ class cleves_elston_test : public task
     friend void do_task_calculations<cleves_elston_test, cleves_elston_result>(cleves_elston_test&);
 
   public:
-    cleves_elston_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    cleves_elston_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                       ge_models& models);
     ~cleves_elston_test();
     
     void  announce_start() const;
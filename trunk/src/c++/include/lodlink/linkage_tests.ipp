@@ -18,8 +18,9 @@
 //
 inline
 non_ss_lod_ratio_test::non_ss_lod_ratio_test(cerrorstream& errors, 
-                                             const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : task(errors, mped, instr)
+                                             const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                                             ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline
@@ -39,8 +40,9 @@ non_ss_lod_ratio_test::announce_start() const
 //
 inline
 ss_lod_ratio_test::ss_lod_ratio_test(cerrorstream& errors, 
-                                     const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : task(errors, mped, instr)
+                                     const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                                     ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline
@@ -60,8 +62,9 @@ ss_lod_ratio_test::announce_start() const
 //
 inline
 cleves_elston_test::cleves_elston_test(cerrorstream& errors, 
-                                       const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : task(errors, mped, instr)
+                                       const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                                       ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline
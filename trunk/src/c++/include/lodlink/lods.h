@@ -48,7 +48,8 @@ class non_ss_lods : public task
     friend void do_task_calculations<non_ss_lods, non_ss_lods_result>(non_ss_lods&);
 
   public:
-    non_ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    non_ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                ge_models& models);
     
     void  announce_start() const;
     void  calculate();
@@ -77,7 +78,8 @@ class ss_lods : public task
     friend void do_task_calculations<ss_lods, ss_lods_result>(ss_lods&);
 
   public:
-    ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+            ge_models& models);
     
     void  announce_start() const;
     void  calculate();
@@ -17,8 +17,9 @@
 //============================================================================
 //
 inline
-non_ss_lods::non_ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : task(errors, mped, instr)
+non_ss_lods::non_ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                         ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline void  
@@ -33,8 +34,9 @@ non_ss_lods::announce_start() const
 //============================================================================
 //
 inline
-ss_lods::ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : task(errors, mped, instr)
+ss_lods::ss_lods(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+                 ge_models& models)
+      : task(errors, mped, instr, models)
 {}
 
 inline void  
@@ -55,13 +55,14 @@ class peeler : public peeling::peeler<joint_pen_iter, log_double>
     typedef phenoset::phenoset_iterator  phenoset_iterator;
   
     peeler(const subped_type& subped, const mle_sub_model& mle,
-           size_t trait, size_t marker);
+           size_t trait, size_t marker, ge_models& models);
     
     // Accessors.
     const subped_type&       subpedigree() const;
     size_t                   trait() const;
     size_t                   marker() const;
     const trans_calculator&  tcalc() const;
+    ge_models&               models() const;
     
   
     const log_double&  
@@ -105,6 +106,7 @@ class peeler : public peeling::peeler<joint_pen_iter, log_double>
     trans_calculator  my_tcalc;
     size_t  my_trait;
     size_t  my_marker;
+    ge_models&  my_models;
 };
 
 #include "lodlink/peeler.ipp"
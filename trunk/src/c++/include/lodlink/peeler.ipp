@@ -40,6 +40,12 @@ peeler::tcalc() const
   return my_tcalc;
 }
 
+inline ge_models&
+peeler::models() const
+{
+  return my_models;
+}
+
 // - Sum likelihood of and individual and his posterior over his phenoset.
 //
 inline log_double
@@ -47,7 +53,7 @@ peeler::sum_ind_and_posterior(const joint_genotype& mjg, const joint_genotype& f
                               const member_type& ind)
 {
   log_double  r(0);
-  phenoset    ph_set(my_subpedigree, my_trait, my_marker, ind);
+  phenoset    ph_set(my_subpedigree, my_trait, my_marker, ind, my_models);
   
   for(phenoset_iterator iter = ph_set.begin(); iter != ph_set.end(); ++iter)
   {
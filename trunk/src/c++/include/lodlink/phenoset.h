@@ -64,7 +64,8 @@ class phenoset
     
     friend class phenoset_iterator;
 
-    phenoset(const subped_type& sp, size_t trait, size_t marker, const member_type& ind);
+    phenoset(const subped_type& sp, size_t trait, size_t marker, const member_type& ind,
+             ge_models& models);
     
     phenoset_iterator  begin() const;
     phenoset_iterator  end() const;
@@ -17,10 +17,10 @@
 //
 inline
 phenoset::phenoset(const subped_type& sp, size_t trait, size_t marker,
-                   const member_type& ind)
+                   const member_type& ind, ge_models& models)
       : my_trait(trait), my_marker(marker), my_ind(ind),
-        my_trait_pm(ge_models::get_model(sp, trait)),
-        my_marker_pm(ge_models::get_model(sp, marker)),
+        my_trait_pm(models.get_model(sp, trait)),
+        my_marker_pm(models.get_model(sp, marker)),
         my_trait_phenotype(ind.subindex() + 1),
         my_marker_phenotype(ind.subindex() + 1)
 {}
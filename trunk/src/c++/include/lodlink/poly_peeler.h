@@ -0,0 +1,111 @@
+#ifndef LODLINK_POLY_PEELER_H
+#define LODLINK_POLY_PEELER_H
+//============================================================================
+// File:      poly_peeler.h
+//
+// History:   10/17/26 - created.
+//
+// Notes:     defines a peeling class for calculating pedigree anterior and
+//            posterior likelihoods as polynomials in the recombination
+//            fractions.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+
+#include "fped/fped.h"
+#include "peeling/peeler3.h"
+#include "lodlink/cache.h"
+#include "lodlink/theta_polynomial.h"
+#include "lodlink/trans_calculator.h"
+#include "lodlink/phenoset.h"
+
+namespace SAGE
+{
+
+namespace LODLINK
+{
+
+//----------------------------------------------------------------------------
+//  Class:    poly_peeler
+//
+//  Purpose:  the peeler of peeler.h w. results kept as polynomials in the
+//            male and female recombination fractions instead of being
+//            evaluated at the fractions of an mle_sub_model.  A subpedigree
+//            is peeled once, after which its likelihood at any recombination
+//            fraction(s) is a polynomial evaluation.
+//
+//            Each nonfounder adds one to the degree in each sex, so the
+//            cost of peeling grows w. the number of nonfounders.  See
+//            use_polynomial().
+//
+//----------------------------------------------------------------------------
+//
+class poly_peeler : public peeling::peeler<joint_pen_iter, theta_polynomial>
+{
+  public:
+    typedef FPED::FilteredMultipedigree::member_type               member_type;
+    typedef FPED::FilteredMultipedigree::subpedigree_type          subped_type;
+    typedef FPED::FilteredMultipedigree::member_const_pointer      member_const_pointer;
+    typedef FPED::FilteredMultipedigree::sibling_const_iterator    sibling_const_iterator;
+    typedef FPED::FilteredMultipedigree::offspring_const_iterator  offspring_const_iterator;
+    typedef FPED::FilteredMultipedigree::mate_const_iterator       mate_const_iterator;
+
+    typedef phenoset::phenoset_iterator  phenoset_iterator;
+
+    poly_peeler(const subped_type& subped, size_t trait, size_t marker, ge_models& models);
+
+    // - Whether a subpedigree is small enough to be peeled w. polynomials.
+    //
+    static bool  use_polynomial(const subped_type& subped);
+
+    // Accessors.
+    const subped_type&  subpedigree() const;
+    size_t              trait() const;
+    size_t              marker() const;
+
+    theta_polynomial  likelihood();
+
+    const theta_polynomial&
+    internal_anterior(const member_type& ind,
+                      const joint_pen_iter& jpi, theta_polynomial& result);
+    const theta_polynomial&
+    internal_posterior(const member_type& ind,
+                       const joint_pen_iter& jpi, theta_polynomial& result);
+    const theta_polynomial&
+    internal_posterior_with_mate(const member_type& ind, const member_type& mate,
+                                 const joint_pen_iter& jpi, theta_polynomial& result);
+    const theta_polynomial&
+    internal_posterior_except_mate(const member_type& ind, const member_type& mate,
+                                   const joint_pen_iter& jpi, theta_polynomial& result);
+    const theta_polynomial&
+    internal_anterior_terminal(const member_type& ind,
+                               const joint_pen_iter& jpi, theta_polynomial& result);
+    const theta_polynomial&
+    internal_posterior_terminal(const member_type& ind,
+                                const joint_pen_iter& jpi, theta_polynomial& result);
+
+  private:
+    theta_polynomial  likelihood_of_offspring(const joint_genotype& ind_jg, const joint_genotype& mate_jg,
+                                              const member_type& ind, const member_type& mate);
+    theta_polynomial  likelihood_of_sibs(const joint_genotype& mjg, const joint_genotype&,
+                                         const member_type& ind);
+    theta_polynomial  sum_ind_and_posterior(const joint_genotype& mjg, const joint_genotype& fjg,
+                                            const member_type& ind);
+
+    poly_peeler(const poly_peeler& other);
+    poly_peeler&  operator=(const poly_peeler& other);
+
+    // Data members.
+    size_t  my_trait;
+    size_t  my_marker;
+    ge_models&  my_models;
+};
+
+#include "lodlink/poly_peeler.ipp"
+
+}
+}
+
+#endif
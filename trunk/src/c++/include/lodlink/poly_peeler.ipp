@@ -0,0 +1,59 @@
+//============================================================================
+// File:      poly_peeler.ipp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     inline implementation of poly_peeler class.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+
+//============================================================================
+// IMPLEMENTATION:  poly_peeler
+//============================================================================
+//
+inline const poly_peeler::subped_type&
+poly_peeler::subpedigree() const
+{
+  return my_subpedigree;
+}
+
+inline size_t
+poly_peeler::trait() const
+{
+  return my_trait;
+}
+
+inline size_t
+poly_peeler::marker() const
+{
+  return my_marker;
+}
+
+// - Sum likelihood of and individual and his posterior over his phenoset.
+//
+inline theta_polynomial
+poly_peeler::sum_ind_and_posterior(const joint_genotype& mjg, const joint_genotype& fjg,
+                                   const member_type& ind)
+{
+  theta_polynomial  r(0.0);
+  phenoset    ph_set(my_subpedigree, my_trait, my_marker, ind, my_models);
+
+  for(phenoset_iterator iter = ph_set.begin(); iter != ph_set.end(); ++iter)
+  {
+    joint_pen_iter  jpi = *iter;
+    theta_polynomial  trans = trans_calculator::transition_polynomial(mjg, fjg, joint_genotype(jpi));
+    if(trans.is_zero())
+    {
+      continue;
+    }
+
+    trans *= jpi.penetrance();
+    trans *= posterior(ind, jpi);
+    r += trans;
+  }
+
+  return r;
+}
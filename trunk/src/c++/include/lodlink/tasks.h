@@ -77,7 +77,8 @@ class task
     typedef SAGE::FPED::FilteredMultipedigree::subpedigree_const_iterator  subpedigree_const_iterator;
     typedef SAGE::FPED::FilteredMultipedigree::member_const_iterator       member_const_iterator;
   
-    task(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr);
+    task(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+         ge_models& models);
     virtual ~task();
   
     virtual void  announce_start() const = 0;
@@ -96,16 +97,46 @@ class task
                                                       size_t marker, const string& test);
     string  marker_name(size_t marker_index);
     
+    polynomial_calculator*  polynomials(size_t trait_index, size_t marker_index) const;
+    
   protected:
     cerrorstream&  my_errors;
     bool  completed;        
     const FPED::FilteredMultipedigree&  my_mped;
     const instructions&  my_instructions;
+    ge_models&  my_models;    // Owned by the analysis.
     vector<result_ptr>  my_results;
+    
+    // - Subpedigree likelihood polynomials for the trait and marker currently
+    //   being analyzed.  Shared by all the likelihood calculations for them.
+    //
+    mutable boost::shared_ptr<polynomial_calculator>  my_polynomials;
 };
 
 enum sf_type { sf_LINKAGE, sf_HOMOGENEITY };    // Smith/Faraway type
 
+//----------------------------------------------------------------------------
+//  Class:    smiths_alt_results
+//                                                                          
+//  Purpose:  alternative hypothesis results of Smith's model, calculated by
+//            the first Smith/Faraway task of an analysis and reused by the
+//            second.  Owned by the analysis, so that analyses do not share
+//            them.
+//                                                                          
+//----------------------------------------------------------------------------
+//
+struct smiths_alt_results
+{
+  smiths_alt_results();
+  
+  void  clear();
+
+  bool  non_ss_calculated;
+  vector<non_ss_alt_result_ptr>  non_ss;
+  bool  ss_calculated;
+  vector<ss_alt_result_ptr>  ss;
+};
+
 //----------------------------------------------------------------------------
 //  Class:    non_ss_smiths_faraways_test
 //                                                                          
@@ -120,11 +151,11 @@ class non_ss_smiths_faraways_test : public task
 {
   public:
     non_ss_smiths_faraways_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                const instructions& instr, sf_type t);
+                                const instructions& instr, ge_models& models, sf_type t,
+                                smiths_alt_results& alt);
                                 
     void  announce_start() const;                                
     void  calculate();
-    static void  clear();
 
   private:
     void  calculate_alt(size_t trait_index, size_t marker_index, non_ss_smiths_faraways_result& result);
@@ -137,10 +168,7 @@ class non_ss_smiths_faraways_test : public task
     void  write_vc_matrix(ostream& out) const;
                                       
     sf_type  my_type;
-    
-    static bool  alt_calculated;             // altenative hypothesis calculations for
-                                             // Smith's model performed for this analysis?
-    static vector<non_ss_alt_result_ptr>  alt_results;
+    smiths_alt_results&  my_alt;
 };
 
 //----------------------------------------------------------------------------
@@ -157,12 +185,11 @@ class ss_smiths_faraways_test : public task
 {
   public:
     ss_smiths_faraways_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                            const instructions& instr, sf_type t);
+                            const instructions& instr, ge_models& models, sf_type t,
+                            smiths_alt_results& alt);
 
     void  announce_start() const;                                
     void  calculate();
-    
-    static void  clear();
 
   private:
     void  calculate_alt(size_t trait_index, size_t marker_index, ss_smiths_faraways_result& result);
@@ -175,10 +202,7 @@ class ss_smiths_faraways_test : public task
     void  write_vc_matrix(ostream& out) const;
                                       
     sf_type  my_type;
-    
-    static bool  alt_calculated;              // altenative hypothesis calculations for
-                                              // Smith's model performed for this analysis?    
-    static vector<ss_alt_result_ptr>  alt_results;
+    smiths_alt_results&  my_alt;
 };
 
 #include "lodlink/tasks.ipp"
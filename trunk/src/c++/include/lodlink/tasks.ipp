@@ -51,14 +51,29 @@ do_task_calculations(T& task)
 //============================================================================
 //
 inline
-task::task(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr)
-      : my_errors(errors), completed(false), my_mped(mped), my_instructions(instr)
+task::task(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, const instructions& instr,
+           ge_models& models)
+      : my_errors(errors), completed(false), my_mped(mped), my_instructions(instr),
+        my_models(models)
 {}
 
 inline
 task::~task()
 {}
 
+inline polynomial_calculator*
+task::polynomials(size_t trait_index, size_t marker_index) const
+{
+  if(! my_polynomials                              ||
+     my_polynomials->trait()  != trait_index       ||
+     my_polynomials->marker() != marker_index        )
+  {
+    my_polynomials.reset(new polynomial_calculator(trait_index, marker_index, my_models));
+  }
+  
+  return  my_polynomials.get();
+}
+
 inline void
 task::write(ostream& summary, ostream& detail) const
 {
@@ -69,15 +84,33 @@ task::write(ostream& summary, ostream& detail) const
 }
 
 
+//============================================================================
+// IMPLEMENTATION:  smiths_alt_results
+//============================================================================
+//
+inline
+smiths_alt_results::smiths_alt_results()
+      : non_ss_calculated(false), ss_calculated(false)
+{}
+
+inline void
+smiths_alt_results::clear()
+{
+  non_ss_calculated = false;
+  non_ss.clear();
+  ss_calculated = false;
+  ss.clear();
+}
+
 //============================================================================
 // IMPLEMENTATION:  non_ss_smiths_faraways_test
 //============================================================================
 //
 inline
 non_ss_smiths_faraways_test::non_ss_smiths_faraways_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                                         const instructions& instr,
-                                                         sf_type t)
-      : task(errors, mped, instr), my_type(t)
+                                                         const instructions& instr, ge_models& models,
+                                                         sf_type t, smiths_alt_results& alt)
+      : task(errors, mped, instr, models), my_type(t), my_alt(alt)
 {}
 
 inline void  
@@ -94,9 +127,9 @@ non_ss_smiths_faraways_test::announce_start() const
 //
 inline
 ss_smiths_faraways_test::ss_smiths_faraways_test(cerrorstream& errors, const FPED::FilteredMultipedigree& mped, 
-                                                 const instructions& instr,
-                                                 sf_type t)
-      : task(errors, mped, instr), my_type(t)
+                                                 const instructions& instr, ge_models& models,
+                                                 sf_type t, smiths_alt_results& alt)
+      : task(errors, mped, instr, models), my_type(t), my_alt(alt)
 {}
 
 inline void  
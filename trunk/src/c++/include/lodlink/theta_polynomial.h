@@ -0,0 +1,96 @@
+#ifndef LODLINK_THETA_POLYNOMIAL_H
+#define LODLINK_THETA_POLYNOMIAL_H
+//============================================================================
+// File:      theta_polynomial.h
+//
+// History:   10/17/26 - created.
+//
+// Notes:     defines a class representing a likelihood as a polynomial in
+//            the male and female recombination fractions.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cassert>
+#include "numerics/log_double.h"
+
+namespace SAGE
+{
+
+namespace LODLINK
+{
+
+//----------------------------------------------------------------------------
+//  Class:    theta_polynomial
+//
+//  Purpose:  two point likelihood as a function of the male and female
+//            recombination fractions, tm and tf.  The likelihood is
+//            stored as
+//
+//              s * sum  c(j, k) * tm^j * (1 - tm)^(M - j) * tf^k * (1 - tf)^(F - k)
+//                  j,k
+//
+//            where M and F are the male and female degrees.  Every
+//            transmission probability has non-negative coefficients in this
+//            basis, so sums and products of them never lose precision to
+//            cancellation.  The coefficients are kept scaled so that the
+//            largest is one, and s is kept on the log scale.
+//
+//            A default constructed polynomial is 'unset'; it marks a
+//            value that has not been calculated.
+//
+//----------------------------------------------------------------------------
+//
+class theta_polynomial
+{
+  public:
+    theta_polynomial();
+    explicit theta_polynomial(double c);
+    explicit theta_polynomial(const log_double& c);
+
+    // - The probability that a parent transmits a haplotype: non_recomb * (1 - t) +
+    //   recomb * t where t is the recombination fraction of the parent's sex.
+    //
+    static theta_polynomial  transmission(double non_recomb, double recomb, bool male);
+
+    // Gets.
+    bool    is_set() const;
+    bool    is_zero() const;
+    size_t  male_degree() const;
+    size_t  female_degree() const;
+
+    log_double  evaluate(double male_theta, double female_theta) const;
+    log_double  evaluate(double theta) const;
+
+    // Arithmetic.
+    theta_polynomial&  operator+=(const theta_polynomial& other);
+    theta_polynomial&  operator*=(const theta_polynomial& other);
+    theta_polynomial&  operator*=(const log_double& c);
+    theta_polynomial&  operator*=(double c);
+
+  private:
+    double&  coefficient(size_t j, size_t k);
+    double   coefficient(size_t j, size_t k) const;
+
+    void  elevate(size_t male_degree, size_t female_degree);
+    void  normalize();
+    void  set_zero();
+
+    // Data members.
+    size_t  my_male_degree;
+    size_t  my_female_degree;
+    std::vector<double>  my_coefficients;     // c(j, k) at j * (F + 1) + k.
+    double  my_log_scale;                     // log(s).  -infinity if zero.
+};
+
+#include "lodlink/theta_polynomial.ipp"
+
+}
+}
+
+#endif
@@ -0,0 +1,107 @@
+//============================================================================
+// File:      theta_polynomial.ipp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     inlines for theta_polynomial class.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+
+//============================================================================
+// IMPLEMENTATION:  theta_polynomial
+//============================================================================
+//
+inline
+theta_polynomial::theta_polynomial()
+      : my_male_degree(0), my_female_degree(0),
+        my_log_scale(-std::numeric_limits<double>::infinity())
+{}
+
+inline
+theta_polynomial::theta_polynomial(double c)
+      : my_male_degree(0), my_female_degree(0), my_coefficients(1, 1.0),
+        my_log_scale(log(c))
+{
+  assert(c >= 0);
+}
+
+inline
+theta_polynomial::theta_polynomial(const log_double& c)
+      : my_male_degree(0), my_female_degree(0), my_coefficients(1, 1.0),
+        my_log_scale(c.get_log())
+{}
+
+inline bool
+theta_polynomial::is_set() const
+{
+  return ! my_coefficients.empty();
+}
+
+inline bool
+theta_polynomial::is_zero() const
+{
+  return my_log_scale == -std::numeric_limits<double>::infinity();
+}
+
+inline size_t
+theta_polynomial::male_degree() const
+{
+  return my_male_degree;
+}
+
+inline size_t
+theta_polynomial::female_degree() const
+{
+  return my_female_degree;
+}
+
+inline log_double
+theta_polynomial::evaluate(double theta) const
+{
+  return evaluate(theta, theta);
+}
+
+inline theta_polynomial&
+theta_polynomial::operator*=(const log_double& c)
+{
+  assert(is_set());
+
+  if(! is_zero())
+  {
+    my_log_scale += c.get_log();
+  }
+
+  if(is_zero())
+  {
+    set_zero();
+  }
+
+  return *this;
+}
+
+inline theta_polynomial&
+theta_polynomial::operator*=(double c)
+{
+  assert(c >= 0);
+
+  return *this *= log_double(c);
+}
+
+inline double&
+theta_polynomial::coefficient(size_t j, size_t k)
+{
+  assert(j <= my_male_degree && k <= my_female_degree);
+
+  return my_coefficients[j * (my_female_degree + 1) + k];
+}
+
+inline double
+theta_polynomial::coefficient(size_t j, size_t k) const
+{
+  assert(j <= my_male_degree && k <= my_female_degree);
+
+  return my_coefficients[j * (my_female_degree + 1) + k];
+}
@@ -17,6 +17,7 @@
 #include <ostream>
 #include "lodlink/mle_sub_model.h"
 #include "lodlink/definitions.h"
+#include "lodlink/theta_polynomial.h"
 
 namespace SAGE
 {
@@ -35,8 +36,17 @@ class trans_calculator
                       const joint_genotype& dad,
                       const joint_genotype& kid ) const;
                       
+    // - Transition probability as a polynomial in the male and female
+    //   recombination fractions.  Independent of the mle_sub_model.
+    //
+    static theta_polynomial  transition_polynomial(const joint_genotype& mom,
+                                                   const joint_genotype& dad,
+                                                   const joint_genotype& kid );
+                      
   private:
     static bool  kd(const MLOCUS::allele& one, const MLOCUS::allele& two);    // Kronecker delta.
+    static void  transmission_weights(const joint_genotype& jg, const haplotype& h,
+                                      double& non_recomb, double& recomb);
     double  transmission(const joint_genotype& jg, LODLINK::sex s, const haplotype& h) const;
     
     trans_calculator(const trans_calculator& other);
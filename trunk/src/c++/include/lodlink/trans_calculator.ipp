@@ -35,12 +35,13 @@ trans_calculator::kd(const MLOCUS::allele& one, const MLOCUS::allele& two)
   return (one == two) ? true : false;
 }
 
-// - Calculate the probability that an individual of the given sex w. the given 
-//   joint genotype transmits the given haplotype.  This equation is given in
-//   the LODLINK 3.1 user documentation.
+// - Coefficients of (1 - theta) and theta, times two, in the probability 
+//   that an individual w. the given joint genotype transmits the given 
+//   haplotype.  This equation is given in the LODLINK 3.1 user documentation.
 //
-inline double
-trans_calculator::transmission(const joint_genotype& jg, LODLINK::sex s, const haplotype& h) const
+inline void
+trans_calculator::transmission_weights(const joint_genotype& jg, const haplotype& h,
+                                       double& non_recomb, double& recomb)
 {
   MLOCUS::allele  t_allele1 = jg.tg.allele1();
   MLOCUS::allele  t_allele2 = jg.tg.allele2();
@@ -50,18 +51,39 @@ trans_calculator::transmission(const joint_genotype& jg, LODLINK::sex s, const h
   if((t_allele1 != h.ta && t_allele2 != h.ta) ||
      (m_allele1 != h.ma && m_allele2 != h.ma)   )
   {
-    return 0;
+    non_recomb = 0;
+    recomb     = 0;
+    return;
   }
   
-  double  theta = my_mle.theta(s);
-  
   double  term1 = kd(t_allele1, h.ta) && kd(m_allele1, h.ma);
   double  term2 = kd(t_allele2, h.ta) && kd(m_allele2, h.ma);
   double  term3 = kd(t_allele1, h.ta) && kd(m_allele2, h.ma);
   double  term4 = kd(t_allele2, h.ta) && kd(m_allele1, h.ma); 
   
-  double  non_recomb = (1 - theta) * (term1 + term2);
-  double  recomb     =      theta  * (term3 + term4);
+  non_recomb = term1 + term2;
+  recomb     = term3 + term4;
+}
+
+// - Calculate the probability that an individual of the given sex w. the given 
+//   joint genotype transmits the given haplotype.
+//
+inline double
+trans_calculator::transmission(const joint_genotype& jg, LODLINK::sex s, const haplotype& h) const
+{
+  double  non_recomb_weight;
+  double  recomb_weight;
+  transmission_weights(jg, h, non_recomb_weight, recomb_weight);
+  
+  if(non_recomb_weight == 0 && recomb_weight == 0)
+  {
+    return 0;
+  }
+  
+  double  theta = my_mle.theta(s);
+  
+  double  non_recomb = (1 - theta) * non_recomb_weight;
+  double  recomb     =      theta  * recomb_weight;
 
   return  (non_recomb + recomb) / 2;
   
@@ -108,3 +130,19 @@ trans_calculator::transition(const joint_genotype& mom,
   */
 }
 
+inline theta_polynomial
+trans_calculator::transition_polynomial(const joint_genotype& mom,
+                                        const joint_genotype& dad,
+                                        const joint_genotype& kid )
+{
+  double  non_recomb;
+  double  recomb;
+  
+  transmission_weights(mom, haplotype(kid.tg.allele1(), kid.mg.allele1()), non_recomb, recomb);
+  theta_polynomial  trans = theta_polynomial::transmission(non_recomb / 2, recomb / 2, false);
+  
+  transmission_weights(dad, haplotype(kid.tg.allele2(), kid.mg.allele2()), non_recomb, recomb);
+  trans *= theta_polynomial::transmission(non_recomb / 2, recomb / 2, true);
+  
+  return trans;
+}
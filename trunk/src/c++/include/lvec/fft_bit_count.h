@@ -27,6 +27,10 @@ public:
   meiosis_map* get_meiosis_map() const;
 
   long operator[](equivalence_class) const;
+
+  /// Contiguous bit counts, indexed by equivalence class.  Returns NULL
+  /// until count() has been called.
+  const int* counts() const;
   
   equivalence_class capacity() const;
   equivalence_class member_count() const;
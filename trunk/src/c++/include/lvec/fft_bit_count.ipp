@@ -21,6 +21,9 @@ inline meiosis_map* fft_bit_count::get_meiosis_map() const
 inline long fft_bit_count::operator[](equivalence_class e) const
 { if(built) return storage[e]; else return -1; }
 
+inline const int* fft_bit_count::counts() const
+{ return storage.empty() ? NULL : &storage[0]; }
+
 inline fft_bit_count::equivalence_class fft_bit_count::capacity() const
 { return storage.capacity(); }
 
@@ -12,6 +12,14 @@
 //           1.1 gcw Upgraded to new libraries             May    2002
 //
 //  Note: Do not assume that vector operations work.
+//
+//  Sparse storage: After genotype elimination, most equivalence classes of
+//  a typed marker have zero likelihood.  A vector with few enough nonzero
+//  classes is kept as a sorted list of those classes and their likelihoods
+//  instead of the full 2^n array (see compact()).  Multiplication,
+//  normalization and the totals work on either form.  The recombination
+//  transforms and += fill the vector, so they return it to the dense form
+//  first.
 //  
 //  Copyright (c) 1998-2002  R.C. Elston
 
@@ -26,7 +34,9 @@
 #include "lvec/fft_bit_count.h"
 #include "lvec/lvec_allocator.h"
 
+#include <cassert>
 #include <iomanip>
+#include <algorithm>
 
 namespace SAGE
 {
@@ -165,8 +175,29 @@ public:
 
   equivalence_class fixed_bits() const { return fixed; }
 
+// Storage form
+
+  bool is_sparse() const;
+
+  // Stores the vector sparsely if it has at least 2^12 classes and no more
+  // than a quarter of them are nonzero.  Generating a vector, and
+  // multiplying by a sparse one, does this.
+  void compact();
+
+  // Returns the vector to the dense form.
+  void expand();
+
+  // Keeps the vector dense: assigning a sparse vector to it, or
+  // multiplying it by one, reuses its storage instead of compacting it.
+  // For work vectors that are transformed after every copy.
+  void set_keep_dense(bool k);
+
 // Iterators and references
 
+  // operator[] works on either form.  The iterators, front() and back()
+  // require the dense form (they assert it); expand() a vector that may be
+  // sparse before iterating it.
+
   const_reference operator[] (size_type n) const;
 
   const_iterator begin() const;
@@ -203,6 +234,8 @@ protected:
   typedef vector<likelihood, lvec_allocator> storage_type;
 #endif
 
+  typedef vector<equivalence_class> class_list;
+
   void increment_value(equivalence_class n, equivalence_class dont_care_bits, likelihood p);
 
   equivalence_class  start() const;
@@ -213,6 +246,11 @@ protected:
   void clear_bits();
   void resize(size_type n);
   void resize_and_clear_bits(size_type n);
+
+  void release_sparse();
+  void release_storage();
+
+  void multiply_sparse(const lvector&, likelihood scaling_factor);
   
 // For multiplication
 
@@ -234,6 +272,15 @@ protected:
   log_double  my_scale;
 
   bool        my_valid;
+
+  // The sparse form.  my_classes is sorted, and my_values holds the
+  // likelihood of each.  storage is empty while my_sparse is set.
+
+  bool         my_sparse;
+  class_list   my_classes;
+  storage_type my_values;
+
+  bool         my_keep_dense;
 };
 
 #include "lvec/lvector.ipp"
@@ -58,17 +58,21 @@ inline bool const_lvector_iterator::operator<(const const_iterator& x) const
 // ==========================
 
 inline Likelihood_Vector::Likelihood_Vector()
-    : storage(), first(0), f(false), bits(0), max_bits(0), my_scale(1.0), my_valid(true)
+    : storage(), first(0), f(false), bits(0), max_bits(0), my_scale(1.0), my_valid(true),
+      my_sparse(false), my_keep_dense(false)
 { fixed = 0; }
 
 inline Likelihood_Vector::Likelihood_Vector(size_type n)
-    : first(0), f(false), bits(n), max_bits(n), my_scale(1.0), my_valid(true)
+    : first(0), f(false), bits(n), max_bits(n), my_scale(1.0), my_valid(true),
+      my_sparse(false), my_keep_dense(false)
 { storage.resize(size(), 0); fixed = (1 << n) - 1; }
 
 inline Likelihood_Vector::Likelihood_Vector(const lvector& l)
-    : first(l.first), fixed(l.fixed), f(l.f), bits(l.bits), max_bits(l.bits), my_scale(l.my_scale)
+    : first(l.first), fixed(l.fixed), f(l.f), bits(l.bits), max_bits(l.bits), my_scale(l.my_scale),
+      my_sparse(l.my_sparse), my_classes(l.my_classes), my_keep_dense(false)
 {
-  storage = l.storage;
+  storage   = l.storage;
+  my_values = l.my_values;
   my_valid = l.is_valid();
 }
 
@@ -88,8 +92,27 @@ inline Likelihood_Vector& Likelihood_Vector::operator= (const lvector& rhs)
 
   if(rhs.size() > capacity()) max_bits = rhs.bits;
 
-  // This will allocate more memory if necessary.  No need to call initialize
-  storage = rhs.storage;
+  if(my_keep_dense && rhs.my_sparse)
+  {
+    // Scatter into the storage we already have.
+    release_sparse();
+
+    storage.resize(size());
+
+    clear_bits();
+
+    for(size_t k = 0; k < rhs.my_classes.size(); ++k)
+      storage[rhs.my_classes[k]] = rhs.my_values[k];
+  }
+  else
+  {
+    // This will allocate more memory if necessary.  No need to call initialize
+    storage = rhs.storage;
+
+    my_sparse  = rhs.my_sparse;
+    my_classes = rhs.my_classes;
+    my_values  = rhs.my_values;
+  }
 
   first    = rhs.first;
   fixed    = rhs.fixed;
@@ -135,14 +158,29 @@ inline void Likelihood_Vector::flatten(long l)
     storage[i] = d;
 }
 
+inline bool Likelihood_Vector::is_sparse() const
+{ return my_sparse; }
+
+inline void Likelihood_Vector::set_keep_dense(bool k)
+{ my_keep_dense = k; }
+
 inline Likelihood_Vector::const_reference Likelihood_Vector::operator[] (size_type n) const
-{ return *(begin() + n); }
+{
+  if(!my_sparse) return *(begin() + n);
+
+  class_list::const_iterator i = std::lower_bound(my_classes.begin(), my_classes.end(),
+                                                  (equivalence_class) n);
+
+  if(i == my_classes.end() || *i != n) return 0.0;
+
+  return my_values[i - my_classes.begin()];
+}
 
 inline Likelihood_Vector::const_iterator Likelihood_Vector::begin() const
-{ return const_iterator(&*storage.begin()); }
+{ assert(!my_sparse); return const_iterator(&*storage.begin()); }
 
 inline Likelihood_Vector::const_iterator Likelihood_Vector::end  () const
-{ return const_iterator(&*storage.begin()) + size(); }
+{ assert(!my_sparse); return const_iterator(&*storage.begin()) + size(); }
 
 inline Likelihood_Vector::const_reference Likelihood_Vector::front() const { return *begin();     }
 inline Likelihood_Vector::const_reference Likelihood_Vector::back () const { return *(end() - 1); }
@@ -176,6 +214,10 @@ inline void Likelihood_Vector::swap(lvector& rhs)
   std::swap(bits,     rhs.bits);
   std::swap(max_bits, rhs.max_bits);
   std::swap(my_scale, rhs.my_scale);
+
+  std::swap(my_sparse, rhs.my_sparse);
+  my_classes.swap(rhs.my_classes);
+  my_values .swap(rhs.my_values);
 }
 
 inline bool Likelihood_Vector::operator== (const lvector& rhs) const
@@ -185,6 +227,17 @@ inline bool Likelihood_Vector::operator== (const lvector& rhs) const
 
   if(my_scale != rhs.my_scale) return false;
 
+  if(my_sparse && rhs.my_sparse)
+    return my_classes == rhs.my_classes && my_values == rhs.my_values;
+
+  if(my_sparse || rhs.my_sparse)
+  {
+    for(size_type i = 0; i < size(); ++i)
+      if((*this)[i] != rhs[i]) return false;
+
+    return true;
+  }
+
   return (::memcmp(&*storage.begin(), &*rhs.storage.begin(), size() * sizeof(likelihood)) == 0);
 }
 
@@ -236,8 +289,25 @@ inline void Likelihood_Vector::clear_bits()
     storage[i] = 0.0;
 }
 
+inline void Likelihood_Vector::release_sparse()
+{
+  if(!my_sparse) return;
+
+  class_list()  .swap(my_classes);
+  storage_type().swap(my_values);
+
+  my_sparse = false;
+}
+
+inline void Likelihood_Vector::release_storage()
+{
+  storage_type().swap(storage);
+}
+
 inline void Likelihood_Vector::resize(size_type n)
 {
+  release_sparse();
+
   if(n > max_bits) max_bits = n;
 
   bits = n;
@@ -247,6 +317,8 @@ inline void Likelihood_Vector::resize(size_type n)
 
 inline void Likelihood_Vector::resize_and_clear_bits(size_type n)
 {
+  release_sparse();
+
   if(n > max_bits)
   {
     clear_bits();
@@ -0,0 +1,71 @@
+#ifndef __WALSH_HADAMARD_H
+#define __WALSH_HADAMARD_H
+
+//==========================================================================
+//  File:    walsh_hadamard.h
+//
+//  Purpose: In-place Walsh-Hadamard transform of a 2^n likelihood vector,
+//           used by Likelihood_Vector to apply the recombination
+//           transition of Kruglyak and Lander (1998).
+//
+//  Notes:   The transform is cache-blocked and branch free.  Strides that
+//           fit in a cache block are applied block by block, larger strides
+//           are applied two at a time (radix 4).  The output of the final
+//           butterfly stage is multiplied by an output scale, so callers do
+//           not need a separate scaling pass.
+//
+//           On x86 processors the kernel is selected at run time: AVX-512,
+//           AVX2 or portable scalar code.  All kernels perform exactly the
+//           same floating point operations per element as the plain
+//           butterfly passes, so results are identical across kernels.
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cstddef>
+
+namespace SAGE
+{
+namespace WHT
+{
+
+/// The multiplier applied to element j of the transform output.  It is
+/// either a single scalar, or table[index[j]] (ie, a lookup through an
+/// fft_bit_count).
+struct output_scale
+{
+  explicit output_scale(double s = 1.0)
+    : scalar(s), index(NULL), table(NULL) { }
+
+  output_scale(const int* i, const double* t)
+    : scalar(1.0), index(i), table(t) { }
+
+  double        scalar;
+  const int*    index;
+  const double* table;
+};
+
+/// Instruction set extensions a kernel can be built for.
+enum kernel_type { scalar_kernel, avx2_kernel, avx512_kernel };
+
+/// Returns the best kernel supported by the running processor.
+kernel_type best_kernel();
+
+/// Returns true if the kernel is compiled in and supported by the processor.
+bool kernel_available(kernel_type k);
+
+const char* kernel_name(kernel_type k);
+
+/// Transforms the 2^bits elements of x in place and scales the output.
+/// Uses the best_kernel().
+void transform(double* x, size_t bits, const output_scale& scale = output_scale());
+
+/// As above, but with an explicit kernel.  If the kernel isn't available,
+/// the scalar kernel is used.
+void transform(double* x, size_t bits, const output_scale& scale, kernel_type k);
+
+}
+}
+
+#endif
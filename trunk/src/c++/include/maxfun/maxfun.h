@@ -10,6 +10,7 @@
 #include <iomanip>
 
 #include "util/get_mem.h"
+#include "util/ThreadPool.h"
 #include "numerics/isnan.h"
 #include "globals/config.h"
 
@@ -46,6 +47,42 @@ class MaxFunction
       return update_bounds(theta);
     }
 
+    /// @name Concurrent evaluation
+    ///
+    /// When more than one thread is available (see Maxfun::set_thread_count()),
+    /// Maxfun evaluates the perturbed parameter vectors of its finite
+    /// difference derivatives concurrently, if the function allows it.  A
+    /// function allows it either by being thread safe, or by being cloneable.
+    /// Functions which do neither are always evaluated serially.
+    ///
+    /// Maxfun keeps no state outside of its instances, so separate Maxfun
+    /// objects may maximize separate functions in different threads.  A
+    /// function, and anything it modifies while being evaluated, must then
+    /// not be shared between the maximizations unless it is thread safe.
+    //@{
+
+      ///
+      /// Returns a new copy of the function, which Maxfun may evaluate
+      /// concurrently with this one, or NULL if copies are not supported
+      /// (the default).  The copy must compute the same value as this
+      /// function for any parameter vector.  Maxfun owns, and deletes, the
+      /// copies it creates.
+      virtual MaxFunction* clone() const;
+
+      ///
+      /// Returns true if evaluate() and update_bounds() may be called
+      /// concurrently on this object (default false).  Because nfe is not
+      /// shared safely, Maxfun counts one evaluation per call for such
+      /// functions.
+      virtual bool is_thread_safe() const;
+
+    //@}
+
+    ///
+    /// Called by Maxfun at the end of each iteration.  The default does
+    /// nothing.
+    virtual void end_iteration();
+
     size_t nfe;
 
   protected:
@@ -298,6 +335,7 @@ class Maxfun
 
     // Copy construction is forbidden
     Maxfun(const Maxfun&);
+    Maxfun& operator=(const Maxfun&);
 
   public:
 
@@ -311,7 +349,14 @@ class Maxfun
     }
 
     // Destructor
-    ~Maxfun() {}
+    ~Maxfun();
+
+    /// Sets the number of threads used to compute derivatives.  0 (the
+    /// default) means UTIL::ThreadPool::default_thread_count().  More than
+    /// one thread is only used if the function is thread safe or cloneable
+    /// (see MaxFunction::clone()).  Results do not depend on the number of
+    /// threads.
+    void set_thread_count(size_t n);
   
     int run()
     {
@@ -320,18 +365,25 @@ class Maxfun
 
     int evaluate(vector<double>& theta, double& f, int& nfe2, int& lex)
     {
-      lex = 0;
+      return evaluate(*fun, false, theta, f, nfe2, lex);
+    }
 
-      depar(theta, lex);
+    /// As above, but with an explicit function.  If shared, the function may
+    /// be being evaluated by other threads, so each call is counted as one
+    /// evaluation rather than reading its nfe.
+    int evaluate(MaxFunction& mfun, bool shared, vector<double>& theta,
+                 double& f, int& nfe2, int& lex)
+    {
+      lex = mfun.depar(theta);
 
       if(lex)
         return lex;
 
-      int n = fun->nfe;
+      int n = shared ? 0 : mfun.nfe;
 
-      f = (*fun)(theta);
+      f = mfun(theta);
 
-      nfe2 += fun->nfe - n;
+      nfe2 += shared ? 1 : mfun.nfe - n;
 
       if(SAGE::isnan(f))
         lex = 1;
@@ -482,8 +534,6 @@ class Maxfun
 
     const Maxfun_Data& get_results()   const;
 
-    static bool iteration_ended;
-
   protected:
 
     // Data members
@@ -561,6 +611,89 @@ class Maxfun
     // static crud from comb_
     vector<int>                      maxlst;
     int                              kv;
+
+    //----------------------------------------------------------------------
+    // Concurrent derivatives
+    //
+    // deriv1_ and deriv2_ are split into independent pieces (a parameter,
+    // or a pair of parameters) which compute into result structures.  In
+    // serial mode each piece is computed just before its result is applied;
+    // in parallel mode the pieces are computed on the thread pool first.
+    // Either way the results are applied in the original order, with the
+    // original early exits, so they do not depend on the mode.
+    //----------------------------------------------------------------------
+
+    /// A thread's function and workspace
+    struct deriv_worker
+    {
+      deriv_worker(MaxFunction* f = NULL, bool s = false) : fun(f), shared(s) { }
+
+      MaxFunction*   fun;
+      bool           shared;
+      vector<double> thy;
+    };
+
+    /// First derivative for one parameter
+    struct deriv1_result
+    {
+      double g;
+      int    stuck;   // parameter stuck, gradient can't be computed
+      int    impbnd;  // implied bound encountered
+      int    nfe;
+    };
+
+    /// Stepsize search for one parameter's second derivatives
+    struct deriv2_step
+    {
+      double si;
+      double dthi;    // QNAN if struck
+      int    struck;  // struck a bound
+      double thy;     // thy[i] afterward.  Not restored if struck.
+      int    impbnd;
+      int    nfe;
+    };
+
+    /// A single second derivative, h(l,ll)
+    struct deriv2_result
+    {
+      double h;
+      int    mirror;   // copy to h(ll,l)
+      int    roundoff; // round-off error in h
+      int    stuck;    // parameter(s) stuck, h can't be computed
+      int    impbnd;
+      int    nfe;
+    };
+
+    bool   setup_deriv_workers_(size_t item_count);
+    void   clear_deriv_workers_();
+
+    void   deriv1_param_ (deriv_worker& w, vector<double>& thy, int i, deriv1_result& r);
+    void   deriv2_step_  (deriv_worker& w, vector<double>& thy, int i, deriv2_step& r);
+    void   deriv2_cross_ (deriv_worker& w, vector<double>& thy, int i, int ii,
+                          const deriv2_step& stepi, const deriv2_step& stepii,
+                          int ih, deriv2_result& r);
+    void   deriv2_diag_  (deriv_worker& w, vector<double>& thy, int i,
+                          const deriv2_step& stepi, int ih, deriv2_result& r);
+
+    void   deriv2_row_base_(size_t row, vector<double>& thy) const;
+
+    void   deriv1_task_      (size_t item, size_t worker);
+    void   deriv2_step_task_ (size_t item, size_t worker);
+    void   deriv2_task_      (size_t item, size_t worker);
+
+    size_t                           my_thread_count;
+    bool                             my_deriv_serial;  // function can't be shared or cloned
+    UTIL::ThreadPool*                my_deriv_pool;
+    vector<deriv_worker>             my_deriv_workers;
+    vector<MaxFunction*>             my_deriv_clones;
+
+    vector<int>                      my_deriv_params;  // independent, varying parameters
+    vector<deriv1_result>            my_deriv1_results;
+    vector<deriv2_step>              my_deriv2_steps;
+    vector<deriv2_result>            my_deriv2_results;
+    vector<double>                   my_deriv2_base;
+    size_t                           my_deriv2_first;
+    int                              my_deriv2_ih;
 };
 
 } // End of namespace SAGE
@@ -2,6 +2,7 @@
 #define APIMAXFUNCTION_H
 
 #include <time.h>
+#include "boost/shared_ptr.hpp"
 #include "maxfun/maxfun.h"
 #include "maxfunapi/Datatypes.h"
 #include "maxfunapi/DebugCfg.h"
@@ -33,6 +34,19 @@ class APIMaxFunction : public SAGE::MaxFunction
     virtual double evaluate      (vector<double> & params);
     virtual int    update_bounds (vector<double> & params);
 
+    ///
+    /// Notes the end of a Maxfun iteration, so that iteration end results
+    /// are reported (if requested) with the next evaluation.
+    virtual void   end_iteration ();
+
+    ///
+    /// Returns a copy which evaluates a clone of the function, or NULL if
+    /// the function is not a cloneable MAXFUN::Function bound to this
+    /// object's ParameterMgr (see Function::clone()).  The copy uses the
+    /// clone's ParameterMgr, counts its own evaluations and writes no
+    /// runtime output.
+    virtual SAGE::MaxFunction* clone() const;
+
     //==================================================================
     // Public accessors:
     //==================================================================
@@ -45,6 +59,8 @@ class APIMaxFunction : public SAGE::MaxFunction
 
     
   private:
+    APIMaxFunction(const APIMaxFunction &, const boost::shared_ptr<SAGE::MaxFunction> &, ParameterMgr &);
+
     APIMaxFunction & operator= (const APIMaxFunction &);
 
     //==================================================================
@@ -56,7 +72,10 @@ class APIMaxFunction : public SAGE::MaxFunction
     const DebugCfg&     my_debug_cfg;
     OUTPUT::Table*      my_table;
     double lastvalue; // due to JA
+    bool   my_iteration_ended;
     void output_iteration_end_results();
+
+    boost::shared_ptr<SAGE::MaxFunction> my_clone;  // the function of a copy made by clone()
 };
 
 }} // End namespace
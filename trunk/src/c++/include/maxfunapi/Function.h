@@ -58,6 +58,14 @@ namespace MAXFUN {
 /// The actual function value is given by a separate functor executed after the sequence is successfully run.
 /// It must be a functor that takes a non-const ParameterMgr& and returns a double (the final function value).
 ///
+/// \par Concurrent evaluation
+///
+/// A Function may be evaluated by only one thread at a time.  If its steps and its evaluator depend on nothing
+/// but the ParameterMgr they are given (and on data which is not modified while maximizing), it can be made
+/// cloneable with setCloneable().  Its clones each have their own copy of the ParameterMgr, so that maxfun may
+/// evaluate them concurrently (see SAGE::MaxFunction::clone()).  Functions whose ParameterMgr has linked submodels
+/// (see ParameterMgr::isInUse()) are not cloned, since the submodels would be shared.
+///
 class Function : public SAGE::MaxFunction
 {
 private:
@@ -111,14 +119,15 @@ public:
     ///
     /// Constructor.
     /// \param mgr The ParameterMgr to which this Function is bound.
-    explicit Function(MAXFUN::ParameterMgr& mgr) : my_mgr(mgr) 
+    explicit Function(MAXFUN::ParameterMgr& mgr) : my_mgr(mgr), my_cloneable(false)
     { 
       addStep(SAGE::FUNCTORS::ReturnConstValue<int, SAGE::MAXFUN::Function::SequenceType::args> (0), "[Default step]");
     }
     
     ///
-    /// Copy constructor.
-    Function(const Function & other) : my_mgr(other.my_mgr), my_seq(other.my_seq), my_eval(other.my_eval) { }
+    /// Copy constructor.  The copy is bound to the same ParameterMgr.
+    Function(const Function & other) : my_mgr(other.my_mgr), my_seq(other.my_seq), my_eval(other.my_eval),
+                                       my_cloneable(other.my_cloneable), my_own_mgr(other.my_own_mgr) { }
   
   //@}
     
@@ -133,6 +142,31 @@ public:
     /// Required for the maxfunapi to work. Ignore this function!
     virtual int update_bounds(vector<double>& params) { getMgr().update(params); return my_seq(my_mgr); }
 
+    ///
+    /// Returns a copy of this Function bound to its own copy of the ParameterMgr, or NULL if the Function is not
+    /// cloneable (see setCloneable()) or its ParameterMgr is in use.
+    virtual SAGE::MaxFunction* clone() const
+    {
+      if(!my_cloneable || my_mgr.isInUse())
+        return NULL;
+
+      return new Function(*this, boost::shared_ptr<ParameterMgr>(new ParameterMgr(my_mgr)));
+    }
+
+  //@}
+
+  /// @name Concurrent evaluation
+  //@{
+
+    ///
+    /// Declares that the steps and the evaluator depend only on the ParameterMgr they are given, so that this
+    /// Function may be cloned (default false).
+    void setCloneable(bool b) { my_cloneable = b; }
+
+    ///
+    /// Returns true if this Function may be cloned.
+    bool isCloneable() const { return my_cloneable; }
+
   //@}
 
   /// @name Adding sequence steps / setting evaluation step:
@@ -192,6 +226,11 @@ public:
   
   private:
 
+    ///
+    /// Constructs a clone of other, bound to mgr.
+    Function(const Function & other, const boost::shared_ptr<ParameterMgr>& mgr) 
+      : my_mgr(*mgr), my_seq(other.my_seq), my_eval(other.my_eval), my_cloneable(true), my_own_mgr(mgr) { }
+
   /// @name Disallowed
   //@{
   
@@ -205,6 +244,10 @@ public:
     ParameterMgr&      my_mgr;
     SequenceType       my_seq;
     EvaluatorFunctor   my_eval;
+    bool               my_cloneable;
+
+    /// The ParameterMgr of a clone, which the clone owns.
+    boost::shared_ptr<ParameterMgr> my_own_mgr;
  
   //@}
 };
@@ -0,0 +1,78 @@
+#ifndef  MCMC_CONVERGENCE_H
+#define  MCMC_CONVERGENCE_H
+
+//==========================================================================
+//  File:       convergence.h
+//
+//  History:    10/17/26 - created.
+//
+//  Notes:      This header defines convergence diagnostics for sets of
+//              independent MCMC chains.  See Gelman et al., Bayesian Data
+//              Analysis, 3rd ed., 2013, section 11.4 and 11.5.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <vector>
+#include <cstddef>
+
+namespace SAGE
+{
+
+namespace MCMC
+{
+
+// Convergence diagnostics of a set of statistics, each sampled once per
+// draw (eg, per batch) by each of several independent chains.  Chains
+// append draws independently; the diagnostics use the draws which every
+// chain has made.
+//
+class chain_diagnostics
+{
+  public:
+
+    chain_diagnostics(size_t chain_count = 0, size_t statistic_count = 0);
+
+    void   resize(size_t chain_count, size_t statistic_count);
+
+    size_t chain_count()     const;
+    size_t statistic_count() const;
+
+    // Number of draws made by every chain.
+    size_t draw_count()      const;
+
+    void   add_draw(size_t chain, size_t statistic, double value);
+
+    // Largest potential scale reduction (R-hat) over the statistics, and
+    // the smallest effective sample size.  Statistics which are not
+    // finite in some draw are skipped.  Without at least two chains of two
+    // draws each, max_scale_reduction() is infinite and min_effective_size()
+    // is 0.
+    double max_scale_reduction() const;
+    double min_effective_size()  const;
+
+  private:
+
+    typedef std::vector<double>        draw_vector;
+    typedef std::vector<draw_vector>   chain_vector;
+
+    bool   get_draws(size_t statistic, chain_vector& draws) const;
+
+    std::vector<chain_vector>          my_draws;   // [statistic][chain][draw]
+};
+
+// Potential scale reduction, R-hat, of chains of equal length.
+double potential_scale_reduction(const std::vector<std::vector<double> >& chains);
+
+// Effective sample size of chains of equal length, using Geyer's initial
+// positive sequence to truncate the autocorrelations.
+double effective_sample_size(const std::vector<std::vector<double> >& chains);
+
+#include "mcmc/convergence.ipp"
+
+} // end of namespace MCMC
+
+} // end of namespace SAGE
+
+#endif
@@ -0,0 +1,34 @@
+// ------------------------------------------------------
+// Inline Implementation of chain_diagnostics
+// ------------------------------------------------------
+
+inline
+chain_diagnostics::chain_diagnostics(size_t chain_count, size_t statistic_count)
+{
+  resize(chain_count, statistic_count);
+}
+
+inline void
+chain_diagnostics::resize(size_t chain_count, size_t statistic_count)
+{
+  my_draws.clear();
+  my_draws.resize(statistic_count, chain_vector(chain_count));
+}
+
+inline size_t
+chain_diagnostics::chain_count() const
+{
+  return my_draws.size() ? my_draws[0].size() : 0;
+}
+
+inline size_t
+chain_diagnostics::statistic_count() const
+{
+  return my_draws.size();
+}
+
+inline void
+chain_diagnostics::add_draw(size_t chain, size_t statistic, double value)
+{
+  my_draws[statistic][chain].push_back(value);
+}
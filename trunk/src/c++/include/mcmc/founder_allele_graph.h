@@ -888,6 +888,20 @@ class FounderAlleleGraph
     /// Mutable to allow the validate() function to update it.
     mutable bool my_pattern_valid;
 
+    /// \name Scratch storage
+    ///
+    /// Working vectors for the likelihood and validation passes.  These were
+    /// once function statics; keeping them in the graph lets graphs in
+    /// different threads (eg, concurrent MCMC chains) work independently.
+    //@{
+
+    mutable std::vector<bool>     my_used_nodes;
+    mutable std::vector<AlleleID> my_node_alleles;
+    mutable std::vector<bool>     my_saved_used_nodes;
+    mutable std::vector<AlleleID> my_saved_node_alleles;
+
+    //@}
+
     /// \name Basic Data
     //@{
 
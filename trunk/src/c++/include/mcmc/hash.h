@@ -1,6 +1,7 @@
 #ifndef HASH_INHERITANCE_H
 #define HASH_INHERITANCE_H
 
+#include <stdint.h>
 #include "containers/bitfield.h"
 
 inline size_t hash_inheritance_xor(const bit_field& b)
@@ -27,6 +28,29 @@ inline size_t hash_inheritance_sum(const bit_field& b)
   return t;
 }
 
+// A 64 bit hash of the 32 bit words of a bit field, finished w. the
+// MurmurHash3 mixer so that every input bit affects every output bit.
+//
+inline uint64_t hash_inheritance_64(const bit_field& b)
+{
+  uint64_t h = b.size() * 0x9e3779b97f4a7c15ULL;
+
+  for(size_t i = 0; i < b.size(); i += 32)
+  {
+    h ^= b.to_u32(i);
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 32;
+  }
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+
+  return h;
+}
+
 struct hash1
 {
   size_t operator()(const bit_field& b) const { return hash_inheritance_xor(b); }
@@ -37,4 +61,9 @@ struct hash2
   size_t operator()(const bit_field& b) const { return hash_inheritance_sum(b); }
 };
 
+struct hash64
+{
+  uint64_t operator()(const bit_field& b) const { return hash_inheritance_64(b); }
+};
+
 #endif
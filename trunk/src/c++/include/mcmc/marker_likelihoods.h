@@ -17,7 +17,7 @@
 
 #include <math.h>
 #include <stdio.h>
-#include "containers/cache_map.h"
+#include "containers/assoc_cache.h"
 #include "mcmc/hash.h"
 #include "mcmc/mcmc_data_accessor.h"
 #include "mcmc/founder_allele_graph.h"
@@ -32,9 +32,14 @@ class marker_likelihood_calculator
 {
   public:
 
+    // Each marker's likelihoods are cached in cache_sets sets of
+    // cache_ways entries.
+    //
     marker_likelihood_calculator(const pedigree_region&  pr,
                                  const McmcMeiosisMap& ped,
-                                 mcmc_data_accessor&     dat);
+                                 mcmc_data_accessor&     dat,
+                                 size_t                  cache_sets = 2048,
+                                 size_t                  cache_ways = 4);
     
     ~marker_likelihood_calculator();
     
@@ -48,25 +53,21 @@ class marker_likelihood_calculator
                                                               // at given marker (or qnan)
     void   dump_graphs(ostream& o) const;
 
+    // Likelihood cache counters, summed over the markers.
+    size_t cache_hits()      const;
+    size_t cache_misses()    const;
+    size_t cache_evictions() const;
+
+    void   dump_cache_statistics(ostream& o) const;
+
   protected:
 
-    typedef vector<FounderAlleleGraph>                    graph_vector;
-    typedef SAGE::cache_map<bit_field, log_double, hash1> cache_type;
-    typedef cache_type::const_iterator                    hash_iterator;
-
-    struct CachingData
-    {
-      public:
-      
-        CachingData();
-        
-        cache_type cache;
-        size_t     hit_count;
-    };
-
-    typedef vector<CachingData> CacheDataVector;
+    typedef vector<FounderAlleleGraph>                      graph_vector;
+    typedef SAGE::assoc_cache<bit_field, log_double, hash64> cache_type;
+
+    typedef vector<cache_type> CacheVector;
     
-    mutable CacheDataVector my_cache_data;
+    mutable CacheVector     my_caches;
     mutable graph_vector    my_graphs;
     
     /// Basic Data
@@ -88,10 +88,6 @@ marker_likelihood_calculator::log_likelihood(size_t m, const bit_field& bits) co
 
   if( !is_valid )
   {
-    // If it's not valid, set the cache to NaN
-
-    my_cache_data[m].cache[bits] = numeric_limits<double>::quiet_NaN();
-
 #if 0
   cout << "** pattern not valid.. return qNAN" << endl;
 #endif
@@ -101,17 +97,15 @@ marker_likelihood_calculator::log_likelihood(size_t m, const bit_field& bits) co
 
   // Check if the cache has it.
 
-  hash_iterator h = my_cache_data[m].cache.find(bits);
+  const log_double* cached = my_caches[m].find(bits);
 
-  if( h != my_cache_data[m].cache.end() )
+  if( cached )
   {
-    ++my_cache_data[m].hit_count;
-
 #if 0
-  cout << ".. has it already .. return (*h)->second.get_log()" << endl;
+  cout << ".. has it already .. return cached->get_log()" << endl;
 #endif
 
-    return (*h)->second.get_log();
+    return cached->get_log();
   }
 
   // We have a valid likelihood.  Let's calculate!
@@ -120,7 +114,7 @@ marker_likelihood_calculator::log_likelihood(size_t m, const bit_field& bits) co
 
   // Cache it and return it.
   
-  my_cache_data[m].cache[bits] = like;
+  my_caches[m].insert(bits, like);
   
 #if 0
   cout << "return " << like.get_log() << endl;
@@ -130,9 +124,37 @@ marker_likelihood_calculator::log_likelihood(size_t m, const bit_field& bits) co
 }
 
 inline
-marker_likelihood_calculator::CachingData::CachingData()
-  : hit_count(0)
+size_t
+marker_likelihood_calculator::cache_hits() const
+{
+  size_t n = 0;
+
+  for( size_t m = 0; m < my_caches.size(); ++m )
+    n += my_caches[m].hits();
+
+  return n;
+}
+
+inline
+size_t
+marker_likelihood_calculator::cache_misses() const
 {
-  cache.resize(12323);
+  size_t n = 0;
+
+  for( size_t m = 0; m < my_caches.size(); ++m )
+    n += my_caches[m].misses();
+
+  return n;
 }
 
+inline
+size_t
+marker_likelihood_calculator::cache_evictions() const
+{
+  size_t n = 0;
+
+  for( size_t m = 0; m < my_caches.size(); ++m )
+    n += my_caches[m].evictions();
+
+  return n;
+}
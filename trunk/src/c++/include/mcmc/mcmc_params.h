@@ -62,6 +62,10 @@ class mcmc_parameters
 
     unsigned long get_random_seed         ()          const;
 
+    size_t    get_chain_count             ()          const;
+    size_t    get_thread_count            ()          const;
+    double    get_convergence_threshold   ()          const;
+
     // Modification functions
 
     bool set_multipoint              (bool m);
@@ -84,6 +88,10 @@ class mcmc_parameters
 
     bool set_random_seed             (unsigned long p);
 
+    bool set_chain_count             (size_t c);
+    bool set_thread_count            (size_t t);
+    bool set_convergence_threshold   (double r);
+
     void normalize_weights           ();
 
   protected:
@@ -107,6 +115,10 @@ class mcmc_parameters
     double    my_batch_factor;
     
     unsigned long my_random_seed;
+
+    size_t    my_chain_count;           // Independent chains per pedigree.
+    size_t    my_thread_count;          // 0 - program default.
+    double    my_convergence_threshold; // R-hat to stop at.  0 - never stop early.
 };
 
 #include "mcmc/mcmc_params.ipp"
@@ -72,6 +72,21 @@ inline unsigned long mcmc_parameters::get_random_seed() const
   return my_random_seed;
 }
 
+inline size_t mcmc_parameters::get_chain_count() const
+{
+  return my_chain_count;
+}
+
+inline size_t mcmc_parameters::get_thread_count() const
+{
+  return my_thread_count;
+}
+
+inline double mcmc_parameters::get_convergence_threshold() const
+{
+  return my_convergence_threshold;
+}
+
 inline bool mcmc_parameters::set_multipoint(bool m) 
 {
   my_multipoint = m;
@@ -196,6 +211,34 @@ bool mcmc_parameters::set_random_seed(unsigned long p)
   return true;
 }
 
+inline
+bool mcmc_parameters::set_chain_count(size_t c)
+{
+  if(c < 1) return false;
+
+  my_chain_count = c;
+
+  return true;
+}
+
+inline
+bool mcmc_parameters::set_thread_count(size_t t)
+{
+  my_thread_count = t;
+
+  return true;
+}
+
+inline
+bool mcmc_parameters::set_convergence_threshold(double r)
+{
+  if(r != 0.0 && r <= 1.0) return false;
+
+  my_convergence_threshold = r;
+
+  return true;
+}
+
 inline void mcmc_parameters::normalize_weights()
 {
   double sum = my_T[0] + my_T[1] + my_T[2];
@@ -63,6 +63,9 @@ class mcmc_parser : public SAGE::APP::BasicParser
     void parse_weights        (int i, const LSFBase* param, const string&);
     void parse_tunnel         (const LSFBase* param);
     void parse_random_seed    (const LSFBase* param);
+    void parse_chains         (const LSFBase* param);
+    void parse_threads        (const LSFBase* param);
+    void parse_convergence    (const LSFBase* param);
 
   private:
     
@@ -58,8 +58,12 @@ class mcmc_simulator
 {
   public:
 
+    // Chains other than the first are seeded from their own, distinct,
+    // random number streams.
+    //
     mcmc_simulator(const McmcMeiosisMap&   ped, const pedigree_region& pr,
-                   mcmc_parameters*        par, cerrorstream&          err);
+                   mcmc_parameters*        par, cerrorstream&          err,
+                   size_t                  chain = 0);
     virtual ~mcmc_simulator();
 
     virtual bool start(ostream& o);
@@ -155,6 +155,55 @@ Transformation::Configuration::get_lambda2_pvalue_mean() const
   return  my_lambda2_pvalue_mean;
 }            
 
+inline
+Transformation::TraitColumn::TraitColumn()
+  : my_cached(false), my_type(NONE), my_lambda2(0.0), my_log_geom_mean(QNAN)
+{ }
+
+inline
+Transformation::TraitColumn::TraitColumn(const vector<double>& traits)
+  : my_cached(false), my_type(NONE), my_lambda2(0.0), my_log_geom_mean(QNAN)
+{
+  set_traits(traits);
+}
+
+inline
+Transformation::TraitColumn::TraitColumn(const vector<double>& traits, const vector<bool>& included)
+  : my_cached(false), my_type(NONE), my_lambda2(0.0), my_log_geom_mean(QNAN)
+{
+  set_traits(traits, included);
+}
+
+inline void
+Transformation::TraitColumn::set_traits(const vector<double>& traits)
+{
+  my_traits = traits;
+  my_included.assign(traits.size(), true);
+  my_cached = false;
+}
+
+inline void
+Transformation::TraitColumn::set_traits(const vector<double>& traits, const vector<bool>& included)
+{
+  assert(traits.size() == included.size());
+
+  my_traits   = traits;
+  my_included = included;
+  my_cached   = false;
+}
+
+inline const vector<double>&
+Transformation::TraitColumn::get_traits() const
+{
+  return my_traits;
+}
+
+inline size_t
+Transformation::TraitColumn::size() const
+{
+  return my_traits.size();
+}
+
 inline
 Transformation::Facade::Facade
     (const Configuration& config, MAXFUN::Function& func)
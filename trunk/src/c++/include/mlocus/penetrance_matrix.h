@@ -91,6 +91,17 @@ class penetrance_matrix
 
     bool set(RowIndex row, ColIndex col) const;
 
+    // Iteration over every value that has been set, in (row, column) order,
+    // for copying the matrix.  Values differing from the default are
+    // separate from those explicitly set to the default.
+
+    typedef typename element_map::const_iterator element_iterator;
+
+    element_iterator elements_begin()     const { return my_elements.begin();    }
+    element_iterator elements_end()       const { return my_elements.end();      }
+    element_iterator set_defaults_begin() const { return my_set_default.begin(); }
+    element_iterator set_defaults_end()   const { return my_set_default.end();   }
+
   private:
     double      my_default;
     col_vector  my_data;
@@ -19,6 +19,7 @@
 #include "mlocus/penetrance_matrix.h"
 #include "output/Output.h"
 #include "error/internal_error.h"
+#include "util/BinaryImage.h"
 
 #ifndef SAGE_ASSERT
     #define SAGE_ASSERT(A,B)
@@ -365,6 +366,14 @@ class penetrance_model
     void        remap();
     void        remap(penetrance_model& m) const;
 
+    // Binary images, for caching built models.  The image holds everything
+    // in the model, so that the model read back has the same allele,
+    // genotype and phenotype ids.  read_image() returns false, and leaves
+    // the model unchanged, if the image is not valid.
+
+    void        write_image(UTIL::BinaryImageWriter& out) const;
+    bool        read_image(UTIL::BinaryImageReader& in);
+
   private:
     boost::shared_ptr<penetrance_model_info>    my_info;
 
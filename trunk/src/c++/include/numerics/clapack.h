@@ -260,6 +260,9 @@
 #define ilaenv ILAENV
 #define slasdt SLASDT
 #define xerbla XERBLA
+#define dgemm DGEMM
+#define dsyrk DSYRK
+#define dtrsm DTRSM
 #endif
 
 
@@ -594,6 +597,12 @@ int F77_CALL(slamc1)(int *beta, int *t, logical *rnd, logical  *ieee1);
 int F77_CALL(slasdt)(int *n, int *lvl, int *nd, int * inode, int *ndiml, int *ndimr, int *msub);
 int F77_CALL(xerbla)(char *srname, int *info);
 
+// BLAS level 3
+
+int F77_CALL(dgemm)(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *a, int *lda, double *b, int *ldb, double *beta, double *c__, int *ldc);
+int F77_CALL(dsyrk)(char *uplo, char *trans, int *n, int *k, double *alpha, double *a, int *lda, double *beta, double *c__, int *ldc);
+int F77_CALL(dtrsm)(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *a, int *lda, double *b, int *ldb);
+
 }
 
 
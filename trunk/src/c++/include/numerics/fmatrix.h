@@ -711,6 +711,57 @@ XXT(const FortranMatrix<T>& v, FortranMatrix<T>& o)
   return o;
 }
 
+// Double precision products.  These overload the templates above, and are
+// computed by the kernels of numerics/matrix_kernels.h (BLAS for all but
+// small matrices).  The output may be one of the inputs.
+
+FortranMatrix<double>& 
+multiply(const FortranMatrix<double>& v1, const FortranMatrix<double>& v2, FortranMatrix<double>& o);
+
+FortranMatrix<double>& 
+XZT(const FortranMatrix<double>& v1, const FortranMatrix<double>& v2, FortranMatrix<double>& o);
+
+FortranMatrix<double>& 
+XTZ(const FortranMatrix<double>& v1, const FortranMatrix<double>& v2, FortranMatrix<double>& o);
+
+FortranMatrix<double>& 
+XTX(const FortranMatrix<double>& v, FortranMatrix<double>& o);
+
+FortranMatrix<double>& 
+XXT(const FortranMatrix<double>& v, FortranMatrix<double>& o);
+
+// Accumulating products:  o += the product.  An empty o is sized for the
+// product and zeroed first; otherwise it must already be the product's size.
+// These save the temporary, and the pass over it, of computing a product and
+// adding it on.
+
+FortranMatrix<double>& 
+multiply_add(const FortranMatrix<double>& v1, const FortranMatrix<double>& v2, FortranMatrix<double>& o,
+             double alpha = 1.0);
+
+FortranMatrix<double>& 
+XTZ_add(const FortranMatrix<double>& v1, const FortranMatrix<double>& v2, FortranMatrix<double>& o);
+
+FortranMatrix<double>& 
+XTX_add(const FortranMatrix<double>& v, FortranMatrix<double>& o);
+
+// o += X' W Z and o += X' W X, with W Z (or W X) computed into work.
+
+FortranMatrix<double>& 
+XTWZ_add(const FortranMatrix<double>& x, const FortranMatrix<double>& w, const FortranMatrix<double>& z,
+         FortranMatrix<double>& o, FortranMatrix<double>& work);
+
+FortranMatrix<double>& 
+XTWX_add(const FortranMatrix<double>& x, const FortranMatrix<double>& w,
+         FortranMatrix<double>& o, FortranMatrix<double>& work);
+
+// Solves T X = B, or T' X = B when transpose is true, for triangular T,
+// overwriting B with X.  B may have any number of columns.
+
+FortranMatrix<double>& 
+triangular_solve(const FortranMatrix<double>& T, FortranMatrix<double>& B,
+                 bool upper = true, bool transpose = false);
+
 template <class T>
 inline FortranMatrix<T> 
 operator*(const FortranMatrix<T>& v1, const FortranMatrix<T>& v2) 
@@ -82,7 +82,9 @@ inline Matrix2D<B>& XXT(const Matrix1D<A>& v, Matrix2D<B>& s)
 
 //
 //  Function XTX - Returns Transpose(X) * X.  Useful for regressions, etc,
-//	and can be done much more quickly due to symmetry.
+//	and can be done much more quickly due to symmetry.  The upper triangle
+//	is summed a row of X at a time, since Matrix2D is stored by rows, and
+//	copied to the lower.
 //
 
 template <class A, class B>
@@ -95,10 +97,18 @@ inline Matrix2D<B>& XTX(const Matrix2D<A>& m, Matrix2D<B>& s)
 
   typename Matrix2D<A>::size_type n = m.cols(), i, j, k;
 
+  for(k = 0; k < m.rows(); k++)
+    for(i = 0; i < n; ++i)
+    {
+      A mki = m(k,i);
+
+      for(j = i; j < n; ++j)
+        s(i,j) += mki * m(k, j);
+    }
+
   for(i = 0; i < n; ++i)
-    for(j = i; j < n; ++j)
-      for(k = 0; k < m.rows(); k++)
-        s(j,i) = s(i,j) += m(k,i) * m(k, j);
+    for(j = i + 1; j < n; ++j)
+      s(j,i) = s(i,j);
 
   return s;
 }
@@ -349,13 +359,14 @@ inline Matrix2D<C>& Multiply(const Matrix2D<A>& n, const Matrix2D<B>& m, Matrix2
 
   typename Matrix2D<A>::size_type i, j, k;
   
+  // Rows of r are summed from rows of m, in the order Matrix2D stores them.
+
   for(i = 0; i < ip; i++)
-    for(j = 0; j < jp; j++)
+    for(k = 0; k < kp; k++)
     {
-      typename Matrix2D<A>::value_type s = 0.0;
-      for(k = 0; k < kp; k++)
-        s += n(i, k) * m(k,j);
-      r(i, j) = s;
+      typename Matrix2D<A>::value_type nik = n(i, k);
+      for(j = 0; j < jp; j++)
+        r(i, j) += nik * m(k,j);
     }
 
   return r;
@@ -374,13 +385,15 @@ inline Matrix2D<C>& XTZ(const Matrix2D<A>& n, const Matrix2D<B>& m, Matrix2D<C>&
 
   typename Matrix2D<A>::size_type i, j, k;
   
-  for(i = 0; i < ip; i++)
-    for(j = 0; j < jp; j++)
+  // Rows of r are summed from rows of n and m, in the order Matrix2D stores
+  // them.
+
+  for(k = 0; k < kp; k++)
+    for(i = 0; i < ip; i++)
     {
-      typename Matrix2D<A>::value_type s = 0.0;
-      for(k = 0; k < kp; k++)
-        s += n(k, i) * m(k,j);
-      r(i, j) = s;
+      typename Matrix2D<A>::value_type nki = n(k, i);
+      for(j = 0; j < jp; j++)
+        r(i, j) += nki * m(k,j);
     }
 
   return r;
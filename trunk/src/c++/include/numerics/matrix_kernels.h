@@ -0,0 +1,63 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+//
+//  Matrix Kernels.  Products and triangular solves on column major
+//    (Fortran order) storage, computed by BLAS or by cache blocked
+//    portable loops.
+//
+//  History:   1.0  Initial implementation                  Oct 17 2026
+//
+//  Copyright (c) 2026  R.C. Elston
+//
+
+#include <cstddef>
+
+namespace SAGE {
+
+//
+//  Dispatch.  BLAS has a fixed call overhead (and converts every dimension
+//    to a Fortran integer), which for the very small matrices of most SAGE
+//    regressions costs more than the product itself.  By default, kernels
+//    use BLAS once a product has at least blas_threshold() multiply-adds,
+//    and the portable loops below that.  The dispatch can be forced either
+//    way, for testing and benchmarking.
+//
+
+enum matrix_kernel_dispatch { MK_AUTO, MK_BLAS, MK_PORTABLE };
+
+void                   set_matrix_kernel_dispatch(matrix_kernel_dispatch d);
+matrix_kernel_dispatch get_matrix_kernel_dispatch();
+
+size_t                 blas_threshold();
+void                   set_blas_threshold(size_t multiply_adds);
+
+//
+//  Kernels.  Arguments follow the BLAS routines of the same name: matrices
+//    are column major with the given leading dimensions, and transposes
+//    are of the stored matrices.
+//
+
+/// C = alpha * op(A) * op(B) + beta * C, where op(A) is m x k and op(B) is
+/// k x n.  C is not read when beta is zero.
+void gemm_kernel(bool transa, bool transb, size_t m, size_t n, size_t k,
+                 double alpha, const double* a, size_t lda,
+                                const double* b, size_t ldb,
+                 double beta,        double* c, size_t ldc);
+
+/// C = alpha * A' * A + beta * C (A k x n) when trans is true, or
+/// C = alpha * A * A' + beta * C (A n x k) when it is false.  C is n x n.
+/// Unlike dsyrk, both triangles of C are set.
+void syrk_kernel(bool trans, size_t n, size_t k,
+                 double alpha, const double* a, size_t lda,
+                 double beta,        double* c, size_t ldc);
+
+/// Solves op(T) * X = B for X, overwriting B (m x n), where T is m x m,
+/// upper or lower triangular, and op(T) is T or T'.
+void trsm_kernel(bool upper, bool trans, size_t m, size_t n,
+                 const double* t, size_t ldt,
+                       double* b, size_t ldb);
+
+} // End namespace SAGE
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef PALBASE_GLS_BATCH_H
+#define PALBASE_GLS_BATCH_H
+
+//****************************************************************************
+//* File:      gls_batch.h                                                   *
+//*                                                                          *
+//* History:   10/17/26 - created.                                           *
+//*                                                                          *
+//* Notes:     This header file defines the gls_batch class, which adds the  *
+//*            weighted normal equations of many small clusters (sibships,   *
+//*            pedigrees) to the sums of a generalized least squares fit.    *
+//*                                                                          *
+//* Copyright (c) 2026 R.C. Elston                                           *
+//*   All Rights Reserved                                                    *
+//****************************************************************************
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "numerics/fmatrix.h"
+#include "numerics/trimatrix.h"
+
+namespace SAGE    {
+namespace PALBASE {
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ~ Class:     gls_batch                                                    ~
+// ~                                                                         ~
+// ~ Purpose:   Accumulates A'WA, A'Wy and y'Wy over the clusters of a GLS   ~
+// ~            fit, a batch of clusters at a time rather than one by one.   ~
+// ~                                                                         ~
+// ~            Clusters are queued with add(), and grouped by size and      ~
+// ~            weight form.  Each group is stored lane by lane: element     ~
+// ~            (i,j) of a block of clusters is held for all of them side by ~
+// ~            side, so each step of the Cholesky factorization, solve and  ~
+// ~            reduction is one loop across the clusters, which the         ~
+// ~            compiler vectorizes.  accumulate() then runs the blocks on   ~
+// ~            a pool of threads, each part summed separately, and adds the ~
+// ~            parts to the totals in a fixed order, so the result does not ~
+// ~            depend on the number of threads.                             ~
+// ~                                                                         ~
+// ~            A cluster is only accumulated if its W is clearly positive   ~
+// ~            definite, with every eigenvalue at least min_eigenvalue().   ~
+// ~            The rest (and clusters too large to batch) are left to the   ~
+// ~            caller, whose per-cluster method decides what singular or    ~
+// ~            indefinite weights mean; see accepted().                     ~
+// ~                                                                         ~
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class gls_batch
+{
+  public:
+
+    typedef FortranMatrix<double>   matrix;
+    typedef TriangleMatrix<double>  trimatrix;
+
+    // How W weights a cluster:  W itself is the weight, or W is the
+    // covariance of y, and the weight its inverse.
+    enum weight_form { WEIGHT = 0, COVARIANCE };
+
+    // A thread count of 0 means UTIL::ThreadPool::default_thread_count().
+    explicit gls_batch(size_t thread_count = 0);
+
+    // Empties the queue, for A with the given number of columns and y with
+    // the given number of variates.
+    void   reset(size_t parameters, size_t variates = 1);
+
+    size_t parameters()   const;
+    size_t variates()     const;
+    size_t thread_count() const;
+    size_t size()         const;
+
+    // Clusters larger than this are never batched.  Blocks are padded to a
+    // whole number of clusters, which for large, mostly unique sizes would
+    // cost more than it saves.
+    static size_t max_cluster_size();
+
+    static double min_eigenvalue();
+
+    // Keeps the inverse of each accepted COVARIANCE weight, for inverse().
+    void   set_keep_inverses(bool keep);
+
+    // Queues a cluster of n observations:  y is n x variates(), A is n x
+    // parameters(), and W is symmetric n x n (only its lower triangle is
+    // read).  Returns the number of the cluster, counting from 0.
+    size_t add(const matrix& y, const matrix&    W, const matrix& A, weight_form f);
+    size_t add(const matrix& y, const trimatrix& W, const matrix& A, weight_form f);
+
+    // Adds the sums of the accepted clusters to AWA (parameters() square),
+    // AWy (parameters() x variates()) and yWy (variates() square).  Returns
+    // the number of clusters accepted.
+    size_t accumulate(matrix& AWA, matrix& AWy, matrix& yWy);
+
+    // After accumulate(), whether the cluster was added to the sums.
+    bool   accepted(size_t cluster) const;
+
+    // After accumulate(), the inverse of the weight of an accepted cluster
+    // with COVARIANCE form, if inverses are kept.
+    void   inverse(size_t cluster, trimatrix& Wi) const;
+
+  private:
+
+    class  block_task;
+
+    // Clusters of one size and weight form, in blocks of LANES clusters.
+    struct group
+    {
+      size_t               n;
+      weight_form          form;
+      size_t               count;
+      size_t               stride;      // doubles per block
+      std::vector<double>  data;        // W, A and y of each block
+      std::vector<double>  inverses;    // W^-1 of each block, if kept
+      std::vector<size_t>  clusters;    // cluster of each lane
+    };
+
+    double* new_lane(size_t n, weight_form f, size_t& lane);
+
+    void    copy_lane(double* d, size_t n, const matrix& y, const matrix& A);
+
+    size_t  my_parameters;
+    size_t  my_variates;
+    size_t  my_thread_count;
+    bool    my_keep_inverses;
+
+    std::vector<group>                my_groups;
+    std::map<std::pair<size_t, int>, size_t> my_group_index;
+
+    // Group and lane (block * LANES + lane in block) of each cluster, with
+    // group npos for clusters not batched.
+    std::vector<std::pair<size_t, size_t> >  my_clusters;
+    std::vector<char>                        my_accepted;
+};
+
+#include "palbase/gls_batch.ipp"
+
+} // end of namespace PALBASE
+} // end of namespace SAGE
+
+#endif
@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////////
+//                Implementation of gls_batch (Inline)                  //
+//////////////////////////////////////////////////////////////////////////
+
+inline size_t
+gls_batch::parameters() const
+{
+  return my_parameters;
+}
+
+inline size_t
+gls_batch::variates() const
+{
+  return my_variates;
+}
+
+inline size_t
+gls_batch::thread_count() const
+{
+  return my_thread_count;
+}
+
+inline size_t
+gls_batch::size() const
+{
+  return my_clusters.size();
+}
+
+inline size_t
+gls_batch::max_cluster_size()
+{
+  return 32;
+}
+
+inline double
+gls_batch::min_eigenvalue()
+{
+  // SVD::compute() flags singular values below this as unstable.
+  return 1.0e-7;
+}
+
+inline void
+gls_batch::set_keep_inverses(bool keep)
+{
+  my_keep_inverses = keep;
+}
+
+inline bool
+gls_batch::accepted(size_t cluster) const
+{
+  return cluster < my_accepted.size() && my_accepted[cluster];
+}
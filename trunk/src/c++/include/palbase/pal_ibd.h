@@ -1,6 +1,7 @@
 #ifndef REL_PAIR_IBD_H
 #define REL_PAIR_IBD_H
 
+#include "ibd/mapped_storage_ibd.h"
 #include "palbase/relative_pairs.h"
 
 namespace SAGE    {
@@ -58,6 +59,10 @@ class pair_analysis_ibd : public IBD
                                    const std::vector<double> &f1mp,
                                    const std::vector<double> &f2);
 
+    virtual bool copy_ibd(const mapped_storage_ibd &source,
+                          const std::vector<size_t> &markers,
+                          const std::vector<size_t> &pairs);
+
     virtual bool get_ibd(size_t i, size_t m, double &f0, double &f2) const;
     virtual bool get_ibd(size_t i, std::vector<double> &f0,
                                    std::vector<double> &f2) const;
@@ -67,7 +72,7 @@ class pair_analysis_ibd : public IBD
                                    std::vector<double> &f1mp,
                                    std::vector<double> &f2) const;
 
-    virtual const sped_pointer get_subped(size_t i) const;
+    virtual sped_pointer       get_subped(size_t i) const;
     virtual sped_pointer       get_subped(size_t i);
 
     virtual bool set_ibd_state(size_t m, const a_marker_ibd_state& i_state);
@@ -287,6 +287,56 @@ pair_analysis_ibd::set_ibd(size_t i, const std::vector<double> &f0,
   return true;
 }
 
+// Copies the values straight into the pairs, without a set_ibd() call,
+// and its checks, for each one.
+//
+inline bool
+pair_analysis_ibd::copy_ibd(const mapped_storage_ibd &source,
+                            const std::vector<size_t> &markers,
+                            const std::vector<size_t> &pairs)
+{
+  size_t pc = pair_count();
+  size_t mc = marker_count();
+
+  for( size_t k = 0; k < markers.size(); ++k )
+    if( markers[k] >= mc )
+      return false;
+
+  // Pair by pair, so that each pair's values are written together.
+
+  for( size_t j = 0; j < pairs.size(); ++j )
+  {
+    size_t i = pairs[j];
+
+    if( i == (size_t)-1 )
+      continue;
+
+    if( i >= pc )
+      return false;
+
+    for( size_t k = 0; k < markers.size(); ++k )
+    {
+      size_t m = markers[k];
+
+      double f0 = source.f0_column(k)[j];
+      double f1 = source.f1mp_column(k)[j];
+      double f2 = source.f2_column(k)[j];
+
+      if( SAGE::isnan(f0) || SAGE::isnan(f2) )
+        f0 = f1 = f2 = QNAN;
+
+      if( !finite(f0) || !finite(f2) || f0 < 0 || f2 < 0 || f0+f2 > 1.01 )
+        f0 = f2 = QNAN;
+
+      my_pairs->set_f0(i,m,f0);
+      my_pairs->set_f1mp(i,m,f1);
+      my_pairs->set_f2(i,m,f2);
+    }
+  }
+
+  return true;
+}
+
 inline bool
 pair_analysis_ibd::get_ibd(size_t i, size_t m, double &f0, double &f2) const
 {
@@ -366,7 +416,7 @@ pair_analysis_ibd::get_ibd(size_t i, std::vector<double> &f0,
   return true;
 }
 
-inline const sped_pointer
+inline sped_pointer
 pair_analysis_ibd::get_subped(size_t i) const
 {
   return my_pairs->get_subped(i);
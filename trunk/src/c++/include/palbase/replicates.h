@@ -0,0 +1,107 @@
+#ifndef PALBASE_REPLICATES_H
+#define PALBASE_REPLICATES_H
+
+//****************************************************************************
+//* File:      replicates.h                                                  *
+//*                                                                          *
+//* History:   10/17/26 - created.                                           *
+//*                                                                          *
+//* Notes:     This header file defines the replicate_engine class, which    *
+//*            runs the replicates of an empirical p-value computation on a  *
+//*            pool of threads.                                              *
+//*                                                                          *
+//* Copyright (c) 2026 R.C. Elston                                           *
+//*   All Rights Reserved                                                    *
+//****************************************************************************
+
+#include <cstddef>
+#include <vector>
+#include "numerics/mt.h"
+
+namespace SAGE    {
+namespace PALBASE {
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ~ Class:     replicate_task                                               ~
+// ~                                                                         ~
+// ~ Purpose:   The work of a replicate_engine.  compute() is called for     ~
+// ~            the replicates of a batch concurrently, and accumulate() for ~
+// ~            each of them afterwards, in replicate order, until it says   ~
+// ~            to stop.                                                     ~
+// ~                                                                         ~
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class replicate_task
+{
+  public:
+
+    virtual ~replicate_task() { }
+
+    // Computes a replicate and keeps its result in the given slot (0 to
+    // batch_size()-1 of the engine).  The generator has been seeded for this
+    // replicate alone.  No two replicates are computed at the same time by
+    // the same worker, so per-worker scratch storage needs no locking.
+    virtual void compute(size_t replicate, size_t slot, size_t worker,
+                         MersenneTwister& rng) = 0;
+
+    // Adds the result in the slot to the totals.  Returns true when enough
+    // replicates have been done.
+    virtual bool accumulate(size_t replicate, size_t slot) = 0;
+};
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ~ Class:     replicate_engine                                             ~
+// ~                                                                         ~
+// ~ Purpose:   Runs replicates a batch at a time.  Each replicate draws its  ~
+// ~            random numbers from a generator seeded from the user's seed  ~
+// ~            and the replicate number, so the results, and the replicate  ~
+// ~            at which the stopping rule is met, are the same whatever the ~
+// ~            number of threads.                                           ~
+// ~                                                                         ~
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class replicate_engine
+{
+  public:
+
+    // A seed of 0 is taken from the clock.  A thread count of 0 means
+    // UTIL::ThreadPool::default_thread_count().
+    explicit replicate_engine(unsigned long seed, size_t thread_count = 0);
+
+    unsigned long seed()         const;
+    size_t        thread_count() const;
+    size_t        batch_size()   const;
+
+    // Replicates computed beyond the one at which the task stops are
+    // discarded, so larger batches waste more work.
+    void          set_batch_size(size_t n);
+
+    unsigned long replicate_seed(size_t replicate) const;
+
+    // A seed taken from the clock.  A program which fits several models
+    // without a seed takes one per run, and gives each model its own seed
+    // from it (see derive_seed()), so that no two models share replicates.
+    static unsigned long clock_seed();
+
+    // Mixes n into seed.  Never 0.
+    static unsigned long derive_seed(unsigned long seed, size_t n);
+
+    // Runs replicates 0 to max_replicates-1, or until the task stops, and
+    // returns the number accumulated.
+    size_t        run(replicate_task& task, size_t max_replicates);
+
+  private:
+
+    class batch;
+
+    unsigned long  my_seed;
+    size_t         my_thread_count;
+    size_t         my_batch_size;
+};
+
+#include "palbase/replicates.ipp"
+
+} // end of namespace PALBASE
+} // end of namespace SAGE
+
+#endif
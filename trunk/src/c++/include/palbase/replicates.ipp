@@ -0,0 +1,27 @@
+//////////////////////////////////////////////////////////////////////////
+//             Implementation of replicate_engine (Inline)              //
+//////////////////////////////////////////////////////////////////////////
+
+inline unsigned long
+replicate_engine::seed() const
+{
+  return my_seed;
+}
+
+inline size_t
+replicate_engine::thread_count() const
+{
+  return my_thread_count;
+}
+
+inline size_t
+replicate_engine::batch_size() const
+{
+  return my_batch_size;
+}
+
+inline void
+replicate_engine::set_batch_size(size_t n)
+{
+  my_batch_size = n ? n : 1;
+}
@@ -17,6 +17,7 @@
 //   All Rights Reserved
 //=============================================================================
 
+#include "palbase/gls_batch.h"
 #include "relpal/parser.h"
 
 namespace SAGE   {
@@ -78,6 +79,11 @@ class relpal_least_square : public calculator_base
     virtual void add_block     (const matrix& y, const trimatrix& W, const matrix& A, trimatrix& Wi);
     virtual void add_block_kron(const matrix& y, const trimatrix& b, const matrix& A);
 
+    // Same as add_block(ys[i], Ws[i], As[i], Wis[i]) for each cluster in
+    // turn, with the well conditioned clusters accumulated as a batch.
+    void add_blocks(const vector<matrix>& ys, const vector<trimatrix>& Ws,
+                    const vector<matrix>& As, vector<trimatrix>& Wis);
+
     virtual bool compute();
 
     void build_residuals(const matrix& y, const matrix& A, matrix& r) const;
@@ -96,6 +102,8 @@ class relpal_least_square : public calculator_base
     matrix   AWA;               // sum(A' W A)
     matrix   AWy;               // sum(A' W y)
     matrix   temp1,temp2,temp3;
+
+    PALBASE::gls_batch  my_batch;
 };
 
 
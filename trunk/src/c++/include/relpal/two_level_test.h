@@ -132,10 +132,14 @@ class two_level_regression : public two_level_base
 
 };
 
+class score_test_replicates;
+
 class two_level_score_test : public two_level_base
 {
   public:
 
+    friend class score_test_replicates;
+
     two_level_score_test(cerrorstream& err = sage_cerr);
 
     void    compute_null_weight(const regression_model& null_model,
@@ -153,6 +157,11 @@ class two_level_score_test : public two_level_base
     bool    has_valid_null()     const;
     bool    has_reliable_score() const;
 
+    // Seed of the empirical p-value replicates.  0 (the default) means the
+    // seed of the model's p-value options.
+    void          set_seed(unsigned long s);
+    unsigned long get_seed() const;
+
   protected:
 
     bool    do_pedigree_level();
@@ -164,7 +173,6 @@ class two_level_score_test : public two_level_base
 
     double  compute_empirical_p_value(size_t& rep, size_t test_df, double T, double correction,
                                       const matrix& sigma_star_i,  const matrix& sigma_star_sqrt);
-    double  get_random_normal();
 
     void    correction_tests();
 
@@ -202,7 +210,7 @@ class two_level_score_test : public two_level_base
     bool               my_valid_null;
     bool               my_reliable_score;
 
-    MersenneTwister    my_random_generator;
+    unsigned long      my_seed;
 };
 
 #include "relpal/two_level_test.ipp"
@@ -144,3 +144,15 @@ two_level_score_test::has_reliable_score() const
 {
   return my_reliable_score;
 }
+
+inline void
+two_level_score_test::set_seed(unsigned long s)
+{
+  my_seed = s;
+}
+
+inline unsigned long
+two_level_score_test::get_seed() const
+{
+  return my_seed;
+}
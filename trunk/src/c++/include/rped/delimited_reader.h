@@ -0,0 +1,303 @@
+#ifndef RPED_DELIMITED_READER_H
+#define RPED_DELIMITED_READER_H
+
+/////////////////////////////////////////////////////////////
+// delimited_reader:  reads character-delimited pedigree   //
+//                    data files in bulk: the file is      //
+//                    mapped into memory, split into line  //
+//                    aligned chunks and tokenized in      //
+//                    place, optionally on several threads.//
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "util/ThreadPool.h"
+#include "rped/rped.h"
+
+namespace SAGE {
+namespace RPED {
+
+/** \brief A field value, as a range of characters that is not copied
+  *
+  * Values point into the mapped file, or, for the rare values with quotes
+  * or escapes, into storage kept by the chunk that holds them.  A span
+  * whose data is NULL is a value that was not read at all (the line had
+  * too few fields), which is not the same as an empty value.
+  */
+struct text_span
+{
+  text_span() : first(NULL), size(0) { }
+  text_span(const char* f, size_t n) : first(f), size(n) { }
+
+  bool        present() const { return first != NULL; }
+  bool        empty()   const { return size == 0;     }
+
+  std::string str()     const { return first ? std::string(first, size) : std::string(); }
+
+  /// Copies the value into s, reusing its storage.
+  void        assign_to(std::string& s) const { s.assign(first ? first : "", size); }
+
+  const char* first;
+  size_t      size;
+};
+
+/** \brief The contents of a text file, in memory
+  *
+  * The file is memory mapped, or, on WIN32 or when mapping fails, read into
+  * a buffer.
+  */
+class mapped_text
+{
+public:
+
+  mapped_text();
+  ~mapped_text();
+
+  /// Returns false if the file cannot be opened.  An empty file is valid.
+  bool open(const std::string& filename);
+  void close();
+
+  const char* begin() const;
+  const char* end()   const;
+  size_t      size()  const;
+
+  /// Returns the start of the line after the first, or end() if there is
+  /// only one line.
+  const char* second_line() const;
+
+private:
+
+  mapped_text(const mapped_text&);
+  mapped_text& operator=(const mapped_text&);
+
+  const char*       my_base;
+  size_t            my_size;
+  bool              my_mapped;
+  std::vector<char> my_buffer;
+};
+
+/** \brief Splits a line into fields, as string_tokenizer does, without copying
+  *
+  * The delimiter, whitespace and delimiter eliding rules are those of
+  * string_tokenizer (see LSF/parse_ops.h), so a file reads the same either
+  * way.  Fields are returned as spans of the line, with surrounding
+  * whitespace removed.  Only fields containing quotes or backslash escapes
+  * are copied, into the storage given to next().
+  */
+class delimited_tokenizer
+{
+public:
+
+  delimited_tokenizer(const std::string& delimiters = ",",
+                      const std::string& whitespace = " \t\n\r");
+
+  void set_skip_consecutive_delimiters(bool skip = true);
+  void set_skip_leading_delimiters    (bool skip = true);
+  void set_skip_trailing_delimiters   (bool skip = true);
+
+  /// Starts splitting a line, which should not include its newline.
+  void set_line(const char* first, const char* last);
+
+  /// Gets the next field of the line.  Returns false when there are no more.
+  bool next(text_span& value, std::deque<std::string>& unescaped);
+
+private:
+
+  void find_start(bool first_field);
+  void find_end(text_span& value, std::deque<std::string>& unescaped);
+
+  void unescape(size_t start, std::string& value);
+
+  text_span strip(const char* first, const char* last) const;
+
+  // Character classes, indexed by unsigned char.  As with strchr(), '\0'
+  // is a delimiter.
+  std::vector<bool> my_delimiter;
+  std::vector<bool> my_whitespace;
+  bool              my_default_whitespace;
+
+  bool my_skip_consecutive;
+  bool my_skip_leading;
+  bool my_skip_trailing;
+
+  // Iteration state, as in string_tokenizer::iterator
+  const char* my_line;
+  size_t      my_size;
+  size_t      my_pos;
+  bool        my_first_call;
+  bool        my_last;
+  bool        my_done;
+};
+
+/** \brief What to do with each column of a delimited file
+  *
+  * Each column of a line stores its value in a slot of the row, is parsed
+  * as a number, or is ignored.  Columns past the last one used are not
+  * tokenized at all.
+  */
+class column_layout
+{
+public:
+
+  enum action_t
+  {
+    ignore,      /*!< The column is not used                                  */
+    store,       /*!< The value replaces the slot's value                     */
+    store_pair   /*!< The value goes in the slot if it is empty, otherwise in
+                      the slot after it (alleles and parents)                */
+  };
+
+  /// Rows have at least width slots.
+  explicit column_layout(size_t width = 0);
+
+  /// Adds the next column.  Stripped values also have any surrounding
+  /// white space (isspace()) removed.
+  void add_column(action_t action, size_t slot = 0, bool stripped = false);
+
+  /// Converts the values in a slot as values of the trait, when they are
+  /// read.  The trait must not be categorical.
+  void set_numeric(size_t slot, const RefTraitInfo& trait);
+
+  /// Returns the number of slots in a row.
+  size_t width()          const;
+  size_t column_count()   const;
+
+  /// Returns the index of the numeric value of a slot, or (size_t)-1 if the
+  /// slot is not numeric.
+  size_t numeric_index(size_t slot) const;
+  size_t numeric_count()            const;
+
+private:
+
+  friend class parsed_chunk;
+
+  struct column
+  {
+    action_t action;
+    size_t   slot;
+    bool     stripped;
+  };
+
+  std::vector<column>              my_columns;
+  size_t                           my_used_columns;
+  size_t                           my_width;
+  std::vector<size_t>              my_numeric_index;
+  std::vector<size_t>              my_numeric_slots;
+  std::vector<const RefTraitInfo*> my_numeric_traits;
+};
+
+/** \brief The rows read from a chunk of a delimited file
+  *
+  * Each row is column_layout::width() values, plus a converted value and
+  * code (see RefTraitInfo::convert_value()) for each numeric slot.  Empty
+  * lines produce no row.
+  */
+class parsed_chunk
+{
+public:
+
+  parsed_chunk();
+
+  /// Reads the lines from first to last, which should end at a line end.
+  void parse(const char* first, const char* last,
+             const column_layout& layout, delimited_tokenizer& tokenizer);
+
+  /// Returns the number of lines in the chunk, including empty ones.
+  size_t line_count() const;
+  size_t row_count()  const;
+
+  /// Returns the line number of the row, counted from 1 at the chunk start.
+  size_t line(size_t row) const;
+
+  const text_span* values (size_t row) const;
+  const double*    numbers(size_t row) const;
+  const int*       codes  (size_t row) const;
+
+private:
+
+  size_t                  my_width;
+  size_t                  my_numeric_count;
+  size_t                  my_line_count;
+
+  std::vector<size_t>     my_lines;
+  std::vector<text_span>  my_values;
+  std::vector<double>     my_numbers;
+  std::vector<int>        my_codes;
+  std::deque<std::string> my_unescaped;
+  std::string             my_scratch;
+};
+
+/** \brief Reads the rows of a delimited file a batch of chunks at a time
+  *
+  * Each batch has a chunk per thread, which are parsed concurrently.  The
+  * caller then stores the rows serially, in file order:
+  *
+  * \code
+  * chunk_reader reader(text, text.second_line(), layout, tokenizer);
+  *
+  * while(reader.next_batch())
+  *   for(size_t c = 0; c < reader.chunk_count(); ++c)
+  *     for(size_t r = 0; r < reader.chunk(c).row_count(); ++r)
+  *       ... reader.first_line(c) + reader.chunk(c).line(r) ...
+  * \endcode
+  */
+class chunk_reader
+{
+public:
+
+  /// Reads the text from start to its end.  A thread count of 0 means
+  /// UTIL::ThreadPool::default_thread_count().
+  chunk_reader(const mapped_text& text, const char* start,
+               const column_layout& layout, const delimited_tokenizer& tokenizer,
+               size_t thread_count = 0);
+
+  ~chunk_reader();
+
+  /// Parses the next batch.  Returns false at the end of the text.
+  bool next_batch();
+
+  size_t              chunk_count()         const;
+  const parsed_chunk& chunk(size_t c)       const;
+
+  /// Returns the number of lines before the chunk, from the start.
+  size_t              first_line(size_t c)  const;
+
+  void   set_chunk_bytes(size_t n);
+  size_t chunk_bytes()  const;
+  size_t thread_count() const;
+
+private:
+
+  chunk_reader(const chunk_reader&);
+  chunk_reader& operator=(const chunk_reader&);
+
+  class batch;
+
+  const column_layout&             my_layout;
+
+  const char*                      my_next;
+  const char*                      my_end;
+
+  UTIL::ThreadPool                 my_pool;
+  size_t                           my_chunk_bytes;
+
+  std::vector<delimited_tokenizer> my_tokenizers;
+  std::vector<parsed_chunk>        my_chunks;
+  std::vector<const char*>         my_bounds;
+  std::vector<size_t>              my_first_lines;
+  size_t                           my_chunk_count;
+  size_t                           my_lines_read;
+};
+
+} // End namespace RPED
+} // End namespace SAGE
+
+#include "rped/delimited_reader.ipp"
+
+#endif
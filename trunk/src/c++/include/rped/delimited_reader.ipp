@@ -0,0 +1,77 @@
+// ============================================================================
+// Inline Functions
+// ============================================================================
+
+namespace SAGE {
+namespace RPED {
+
+// ===========
+// mapped_text
+// ===========
+
+inline const char* mapped_text::begin() const { return my_base;           }
+inline const char* mapped_text::end()   const { return my_base + my_size; }
+inline size_t      mapped_text::size()  const { return my_size;           }
+
+// ===================
+// delimited_tokenizer
+// ===================
+
+inline void delimited_tokenizer::set_skip_consecutive_delimiters(bool skip) { my_skip_consecutive = skip; }
+inline void delimited_tokenizer::set_skip_leading_delimiters    (bool skip) { my_skip_leading     = skip; }
+inline void delimited_tokenizer::set_skip_trailing_delimiters   (bool skip) { my_skip_trailing    = skip; }
+
+// =============
+// column_layout
+// =============
+
+inline size_t column_layout::width()         const { return my_width;                }
+inline size_t column_layout::column_count()  const { return my_columns.size();       }
+inline size_t column_layout::numeric_count() const { return my_numeric_slots.size(); }
+
+inline size_t
+column_layout::numeric_index(size_t slot) const
+{
+  return slot < my_numeric_index.size() ? my_numeric_index[slot] : (size_t)-1;
+}
+
+// ============
+// parsed_chunk
+// ============
+
+inline size_t parsed_chunk::line_count()        const { return my_line_count;   }
+inline size_t parsed_chunk::row_count()         const { return my_lines.size(); }
+inline size_t parsed_chunk::line(size_t row)    const { return my_lines[row];   }
+
+inline const text_span*
+parsed_chunk::values(size_t row) const
+{
+  return my_width ? &my_values[row * my_width] : NULL;
+}
+
+inline const double*
+parsed_chunk::numbers(size_t row) const
+{
+  return my_numeric_count ? &my_numbers[row * my_numeric_count] : NULL;
+}
+
+inline const int*
+parsed_chunk::codes(size_t row) const
+{
+  return my_numeric_count ? &my_codes[row * my_numeric_count] : NULL;
+}
+
+// ============
+// chunk_reader
+// ============
+
+inline size_t              chunk_reader::chunk_count()        const { return my_chunk_count;    }
+inline const parsed_chunk& chunk_reader::chunk(size_t c)      const { return my_chunks[c];      }
+inline size_t              chunk_reader::first_line(size_t c) const { return my_first_lines[c]; }
+
+inline void   chunk_reader::set_chunk_bytes(size_t n) { my_chunk_bytes = n ? n : 1; }
+inline size_t chunk_reader::chunk_bytes()       const { return my_chunk_bytes;      }
+inline size_t chunk_reader::thread_count()      const { return my_pool.thread_count(); }
+
+} // End namespace RPED
+} // End namespace SAGE
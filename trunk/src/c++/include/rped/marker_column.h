@@ -0,0 +1,117 @@
+#ifndef RPED_MARKER_COLUMN_H
+#define RPED_MARKER_COLUMN_H
+
+/////////////////////////////////////////////////////////////
+// marker_column:  packed storage of the phenotypes of one  //
+//                 marker for the members of a pedigree.    //
+//                                                          //
+// History: 10/17/26 - created.                             //
+//                                                          //
+// Copyright (c) 2026 R.C. Elston                           //
+//   All Rights Reserved                                    //
+/////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+namespace SAGE {
+namespace RPED {
+
+/** \brief The phenotype ids of one marker, packed 2, 4, 8 or 32 bits each
+  *
+  * A column is packed as tightly as the largest id stored in it allows: 2
+  * bits a member for ids below 4 (a biallelic SNP, with missing), 4 bits
+  * below 16, a byte below 256, and a full word for anything larger (or
+  * MLOCUS::NPOS).  The width starts from the value the column is filled
+  * with and is widened when a larger id is stored, which happens at most
+  * three times.  It is not taken from the phenotype count of the marker,
+  * which counts phased phenotypes that unphased data never uses, and grows
+  * as the alleles of a dynamic marker are read.
+  *
+  * Columns of pedigrees small enough to fit in 64 bits are held in the
+  * column itself, without allocation.
+  */
+class RefMarkerColumn
+{
+public:
+
+  /// @name Constructors
+  //@{
+
+    RefMarkerColumn();
+    RefMarkerColumn(const RefMarkerColumn& c);
+    ~RefMarkerColumn();
+
+    RefMarkerColumn& operator=(const RefMarkerColumn& c);
+
+    void swap(RefMarkerColumn& c);
+
+  //@}
+
+  /// @name Sizing
+  //@{
+
+    /// Sets the number of members.  New members get the value \c fill.
+    void resize(size_t n, uint32_t fill);
+
+    size_t size()  const;
+
+    /// The number of bits per member: 2, 4, 8 or 32.
+    uint32_t width() const;
+
+    /// The smallest width for ids up to \c max_value.
+    static uint32_t width_for(uint32_t max_value);
+
+  //@}
+
+  /// @name Values
+  //@{
+
+    uint32_t get(size_t i) const;
+    void     set(size_t i, uint32_t v);
+
+    void     swap_values(size_t i, size_t j);
+
+    /// Unpacks the whole column into \c out, which must hold size() values.
+    /// This is the way to read a column for a loop over the members.
+    void     unpack(uint32_t* out) const;
+
+    /// Unpacks the whole column into \c out.
+    void     unpack(std::vector<uint32_t>& out) const;
+
+  //@}
+
+private:
+
+  size_t          word_count() const;
+  const uint32_t* words()      const;
+  uint32_t*       words();
+
+  bool            is_inline()  const;
+
+  uint32_t        mask()       const;
+
+  /// Lays the column out for n members at the given width, which must not
+  /// be smaller, keeping the values of the members kept.
+  void            reshape(size_t n, uint32_t width);
+
+  enum { inline_words = 2 };
+
+  union
+  {
+    uint32_t  my_inline[inline_words];
+    uint32_t* my_heap;
+  };
+
+  uint32_t      my_size;
+  unsigned char my_width;   // Bits per value
+  unsigned char my_shift;   // log2 of the values per word
+};
+
+} // End namespace RPED
+} // End namespace SAGE
+
+#include "rped/marker_column.ipp"
+
+#endif
@@ -0,0 +1,76 @@
+//============================================================================
+//  RefMarkerColumn -- inline functions
+//
+//  Copyright (c) 2026  R.C. Elston
+//    All Rights Reserved
+//============================================================================
+
+namespace SAGE {
+namespace RPED {
+
+inline size_t   RefMarkerColumn::size()  const { return my_size;  }
+inline uint32_t RefMarkerColumn::width() const { return my_width; }
+
+inline uint32_t RefMarkerColumn::mask() const
+{
+  return (uint32_t) ((((uint64_t) 1) << my_width) - 1);
+}
+
+inline size_t RefMarkerColumn::word_count() const
+{
+  return (my_size + (1u << my_shift) - 1) >> my_shift;
+}
+
+inline bool RefMarkerColumn::is_inline() const
+{
+  return word_count() <= inline_words;
+}
+
+inline const uint32_t* RefMarkerColumn::words() const { return is_inline() ? my_inline : my_heap; }
+inline       uint32_t* RefMarkerColumn::words()       { return is_inline() ? my_inline : my_heap; }
+
+inline uint32_t RefMarkerColumn::width_for(uint32_t max_value)
+{
+  if(max_value < 4)   return 2;
+  if(max_value < 16)  return 4;
+  if(max_value < 256) return 8;
+
+  return 32;
+}
+
+inline uint32_t RefMarkerColumn::get(size_t i) const
+{
+  uint32_t offset = (uint32_t) (i & ((1u << my_shift) - 1)) * my_width;
+
+  return (words()[i >> my_shift] >> offset) & mask();
+}
+
+inline void RefMarkerColumn::set(size_t i, uint32_t v)
+{
+  if(v > mask())
+    reshape(my_size, width_for(v));
+
+  uint32_t  offset = (uint32_t) (i & ((1u << my_shift) - 1)) * my_width;
+  uint32_t& word   = words()[i >> my_shift];
+
+  word = (word & ~(mask() << offset)) | (v << offset);
+}
+
+inline void RefMarkerColumn::swap_values(size_t i, size_t j)
+{
+  uint32_t v = get(i);
+
+  set(i, get(j));
+  set(j, v);
+}
+
+inline void RefMarkerColumn::unpack(std::vector<uint32_t>& out) const
+{
+  out.resize(my_size);
+
+  if(my_size)
+    unpack(&out[0]);
+}
+
+} // End namespace RPED
+} // End namespace SAGE
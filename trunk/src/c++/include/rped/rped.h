@@ -32,6 +32,7 @@
 #include "mped/mp.h"
 #include "mped/sp.h"
 #include "mlocus/imodel.h"
+#include "rped/marker_column.h"
 
 namespace SAGE {
 namespace RPED {
@@ -374,6 +375,23 @@ public:
 
   //@}
 
+  /// @name Value conversion
+  //@{
+
+    ///
+    /// Converts a value of a trait which is not categorical from its string
+    /// form, checking it against the missing codes and, for binary traits,
+    /// the affectedness codes and threshold, as RefPedInfo::set_trait() does.
+    /// The trait is not modified, so values may be converted concurrently.
+    /// \param value The trait value (in string form)
+    /// \param d Set to the value to be stored
+    /// \retval 0 Value ok
+    /// \retval 1 Value ok, but missing
+    /// \retval 2 Bad value, assumed missing
+    int convert_value(const std::string & value, double & d) const;
+
+  //@}
+
 private:
   void init();
 
@@ -1114,6 +1132,23 @@ public:
                   const std::string  & value, 
                   RefTraitInfo & trait_info);
 
+    ///
+    /// Sets the trait value for an individual from a computed value.
+    ///
+    /// The value is checked against the numeric missing code and, for binary
+    /// traits, the numeric affected and unaffected codes and threshold, as
+    /// the string form is, without being formatted and parsed.  Values which
+    /// are not finite are bad values.
+    /// \param i The index of the individual
+    /// \param t The number of the trait field
+    /// \param value The trait value (QNAN if missing)
+    /// \param trait_info The RefTraitInfo instance associated with the trait being added
+    /// \returns As set_trait() for string values
+    int set_trait(size_t i,
+                  size_t t,
+                  double value,
+                  RefTraitInfo & trait_info);
+
     ///
     /// Sets the phenotype (marker) value for an individual (according to the source data).
     /// \param i The index of the individual
@@ -1235,6 +1270,12 @@ public:
     /// \param mi The RefMarkerInfo instance associated with this marker
     bool phenotype_missing(size_t i, size_t m, const RefMarkerInfo& mi) const;
 
+    ///
+    /// Returns the phenotypes of all members for a marker, for loops over
+    /// the members (see RefMarkerColumn::unpack()).
+    /// \param m The id number of the marker field
+    const RefMarkerColumn& marker_column(size_t m) const;
+
     ///
     /// Returns an individual's string-type value.
     /// \param i The index of the individual
@@ -1257,11 +1298,10 @@ private:
                       
   typedef vector<double> dvector;
   typedef vector<string> svector;
-  typedef vector<uint>   uvector;
 
   vector<dvector> my_traits;
   vector<svector> my_strings;
-  vector<uvector> my_markers;
+  vector<RefMarkerColumn> my_markers;
   size_t my_member_count;
   size_t my_marker_count;
   size_t my_trait_count;
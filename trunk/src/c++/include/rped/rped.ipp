@@ -288,6 +288,7 @@ void RefTraitInfo::init()
   my_numeric_affected_code = my_numeric_unaffected_code = qNaN;
   my_string_affected_code  = my_string_unaffected_code  = "";
   my_string_missing_code   = "";
+  my_lockout               = false;
 }
 
 //==============================================
@@ -574,15 +575,21 @@ uint RefPedInfo::phenotype(size_t i, size_t m) const
 { 
   if(i >= member_count() || m >= marker_count())
      return MLOCUS::NPOS;
-  return my_markers[m][i]; 
+  return my_markers[m].get(i); 
 }
 
 inline
 bool RefPedInfo::phenotype_missing(size_t i, size_t m, const RefMarkerInfo& mi) const 
 { 
-//    return my_markers[m][i] == mi.get_missing_phenotype_id(); 
-  return    my_markers[m][i] == mi.get_missing_phenotype_id()
-         || my_markers[m][i] == MLOCUS::NPOS;
+  uint p = my_markers[m].get(i);
+
+  return p == mi.get_missing_phenotype_id() || p == MLOCUS::NPOS;
+}
+
+inline
+const RefMarkerColumn& RefPedInfo::marker_column(size_t m) const
+{
+  return my_markers[m];
 }
 
 inline
@@ -590,7 +597,7 @@ bool RefPedInfo::set_phenotype(size_t i, size_t m, uint p)
 { 
   if(i >= member_count() || m >= marker_count())
      return false;
-  my_markers[m][i] = p; 
+  my_markers[m].set(i, p); 
   return true;
 }
 
@@ -644,7 +651,7 @@ void RefPedInfo::swap_members(size_t m1, size_t m2)
     std::swap( my_strings[s][m1], my_strings[s][m2] );
 
   for(size_t m=0; m < marker_count(); ++m)
-    std::swap( my_markers[m][m1], my_markers[m][m2] );
+    my_markers[m].swap_values(m1, m2);
 }
       
 inline void RefPedInfo::build(MPED::pedigree_base &pedbase)
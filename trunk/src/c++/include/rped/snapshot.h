@@ -0,0 +1,111 @@
+#ifndef RPED_SNAPSHOT_H
+#define RPED_SNAPSHOT_H
+
+/////////////////////////////////////////////////////////////
+// snapshot:  binary images of built multipedigrees, and   //
+//            the snapshot files which cache them between  //
+//            runs, so that programs can skip reading and  //
+//            building their pedigree data.                //
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include "util/BinaryImage.h"
+#include "rped/rped.h"
+#include "rped/delimited_reader.h"
+
+namespace SAGE {
+namespace RPED {
+
+/// @name Binary images
+///
+/// The image of a RefMPedInfo holds the field definitions, codes and marker
+/// models.  The image of a RefMultiPedigree holds its RefMPedInfo, the
+/// pedigree structure, with the pedigrees, members and subpedigree members
+/// in index order (as left by PedigreeSort(), say), and the trait, string
+/// and marker values of every member.
+///
+/// read_image() replaces the object with the one written, and returns false
+/// if the image is not valid, in which case the object is unchanged.  A
+/// multipedigree read into should be empty.  Its image is checked in full
+/// before it is changed; should the pedigrees built from a valid image not
+/// match those written (which would mean an image from another version of
+/// the builder), it returns false with the multipedigree partly built.
+//@{
+
+void write_image(UTIL::BinaryImageWriter& out, const RefMPedInfo& info);
+bool read_image (UTIL::BinaryImageReader& in,        RefMPedInfo& info);
+
+void write_image(UTIL::BinaryImageWriter& out, const RefMultiPedigree& mp);
+bool read_image (UTIL::BinaryImageReader& in,        RefMultiPedigree& mp);
+
+//@}
+
+/** \brief A file of cached images
+  *
+  * A snapshot file holds any number of entries, each an image identified by
+  * a key (what was built, eg, from which files with which options) and a
+  * content hash (of the inputs it was built from).  An entry is found only
+  * if both match, so an entry is out of date as soon as any of its inputs
+  * change.
+  *
+  * The file is mapped into memory, and entries are read from the mapping.
+  * Entries are in native byte order; files from machines of the other byte
+  * order, or from other versions of the format, are not read.
+  */
+class snapshot_file
+{
+public:
+
+  snapshot_file();
+
+  /// Returns false if the file cannot be read, or is not a snapshot file of
+  /// this version and byte order.
+  bool open(const std::string& filename);
+  void close();
+
+  bool is_open() const;
+
+  size_t entry_count() const;
+
+  /// Finds the entry for the key.  Returns false if there is none, or it
+  /// was built from other inputs.  The image is valid until the file is
+  /// closed.
+  bool find(uint64_t key, uint64_t content_hash,
+            const char*& first, const char*& last) const;
+
+  /// Writes a snapshot file holding the image as the entry for the key,
+  /// and the other entries the file holds at the time.  This object is left
+  /// closed.  The new file replaces any existing one atomically where the
+  /// system allows, so programs reading it concurrently are unaffected.
+  ///
+  /// Programs storing to the same file concurrently take turns, with a lock
+  /// on the file named filename + ".lock", and each keeps the entries stored
+  /// before it.  Where there are no file locks (WIN32), the last program to
+  /// store wins, and entries stored meanwhile by the others are lost.
+  bool store(const std::string& filename, uint64_t key, uint64_t content_hash,
+             const std::string& image);
+
+private:
+
+  struct entry
+  {
+    uint64_t key;
+    uint64_t content_hash;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  mapped_text        my_text;
+  std::vector<entry> my_entries;
+};
+
+} // End namespace RPED
+} // End namespace SAGE
+
+#endif
@@ -2,6 +2,7 @@
 #define SEGREG_ANALYSIS_CONTROLLER_H
 
 #include "segreg/analysis.h"
+#include "segreg/analysis_out.h"
 #include "segreg/PedigreeDataSet.h"
 #include "segreg/model.h"
 #include "rped/rped.h"
@@ -46,6 +47,10 @@ class AnalysisController
 
     void print_analysis_header   (const std::string&     title) const;
     void print_analysis_footer   ( )                            const;
+
+    /// The tables of this analysis's output, which omit the polygenic
+    /// parameters if fpmm_and_no_poly_loci is set.
+    analysis_output get_output_tables() const;
     
     // for single likelihood evaluation
 
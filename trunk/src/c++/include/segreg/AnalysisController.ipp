@@ -15,10 +15,17 @@ namespace SEGREG
 ///
 inline
 AnalysisController::AnalysisController(APP::Output_Streams& o)
-  : my_out(o),
+  : fpmm_and_no_poly_loci(0),
+    my_out(o),
     my_analysis(my_out)
 { }
 
+inline
+analysis_output AnalysisController::get_output_tables() const
+{
+  return analysis_output(fpmm_and_no_poly_loci > 0);
+}
+
 
 }
 }
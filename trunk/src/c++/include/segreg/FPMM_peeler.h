@@ -80,6 +80,10 @@ class FPMM_peeler : public
     /// Public set function for using the FPMM SL calculator:
     void set_SL(FPMM_SL * SL_calculator) { SL_calc = SL_calculator; } 
 
+    /// Prepares the peeler for a new likelihood evaluation with the SL
+    /// calculator given, discarding all cached values.
+    void reset(FPMM_SL * SL_calculator) { SL_calc = SL_calculator; my_cache.invalidate(); }
+
     log_double partial_parental_likelihood(
 				       const member_type&         indiv,
                                        genotype_index genotype_indiv,
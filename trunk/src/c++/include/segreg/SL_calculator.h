@@ -53,6 +53,7 @@ class FPMM_SL
     {
       i_info();
       i_info(const i_info&);
+      void clear();
       log_double& operator() (int, int);
       log_double data[3][MAX_POLYGENOTYPE];
     };
@@ -70,6 +71,7 @@ class FPMM_SL
     {
       i_m_f_info();
       i_m_f_info(const i_m_f_info&);
+      void clear();
       log_double& operator()(int i, int j, int k, int l, int m, int n);
       log_double data[3][MAX_POLYGENOTYPE][3][MAX_POLYGENOTYPE][3][MAX_POLYGENOTYPE];
     };
@@ -86,14 +88,24 @@ class FPMM_SL
       peeler_pointer = peeler_pointer_param;
       size_t num_of_inds = peeler_pointer->get_subpedigree().member_count();
 
-      my_founder_SL2_4    .clear();
-      my_founder_SL6      .clear();
-      my_nonfounder_SL2_4 .clear();
-      my_nonfounder_SL6   .clear();
-      my_founder_SL2_4    .resize(num_of_inds);
-      my_founder_SL6      .resize(num_of_inds);
-      my_nonfounder_SL2_4 .resize(num_of_inds);
-      my_nonfounder_SL6   .resize(num_of_inds);
+      // The caches are reset in place, and never shrink, so that once they
+      // have grown to the largest subpedigree, nothing is reallocated.
+
+      if(my_founder_SL2_4.size() < num_of_inds)
+      {
+        my_founder_SL2_4    .resize(num_of_inds);
+        my_founder_SL6      .resize(num_of_inds);
+        my_nonfounder_SL2_4 .resize(num_of_inds);
+        my_nonfounder_SL6   .resize(num_of_inds);
+      }
+
+      for(size_t i = 0; i < num_of_inds; ++i)
+      {
+        my_founder_SL2_4    [i] . clear();
+        my_founder_SL6      [i] . clear();
+        my_nonfounder_SL2_4 [i] . clear();
+        my_nonfounder_SL6   [i] . clear();
+      }
     }
     peeler_type* get_peeler() { return peeler_pointer; }
 
@@ -146,6 +146,15 @@ FPMM_SL::nonfounder_SL6(const penetrance_info&          ps_indiv,
 //===================================================================
 inline
 FPMM_SL::i_info::i_info()
+{
+  clear();
+}
+
+//===================================================================
+//  FPMM_SL::i_info::clear()
+//===================================================================
+inline void
+FPMM_SL::i_info::clear()
 {
   for(int i = 0; i < 3; ++i)
     for(int j = 0; j < MAX_POLYGENOTYPE; ++j)
@@ -217,6 +226,15 @@ FPMM_SL::i_s_info::operator() (int i, int j, int k, int l)
 //===================================================================
 inline
 FPMM_SL::i_m_f_info::i_m_f_info()
+{
+  clear();
+}
+
+//===================================================================
+//  FPMM_SL::i_m_f_info::clear()
+//===================================================================
+inline void
+FPMM_SL::i_m_f_info::clear()
 {
   for(int i = 0; i < 3; ++i)
     for(int j = 0; j < MAX_POLYGENOTYPE; ++j)
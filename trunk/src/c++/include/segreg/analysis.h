@@ -6,7 +6,11 @@
 #include "segreg/model.h"
 #include "app/output_streams.h"
 #include "error/errorstream.h"
+#include "error/bufferederrorstream.h"
 #include "boost/smart_ptr.hpp"
+#include <sstream>
+#include <set>
+#include "util/ThreadPool.h"
 
 namespace SAGE
 {
@@ -47,8 +51,8 @@ class primary_analysis_results
 
     const MlmResidCorrelationCalculator&     get_mlm_resid_corr() const;
 
-    double get_one_mean_results(); // due to JA
-    double get_one_susc_results(); // due to JA
+    double get_one_mean_results() const; // due to JA
+    double get_one_susc_results() const; // due to JA
 
   protected:
 
@@ -66,6 +70,31 @@ class primary_analysis_results
     MlmResidCorrelationCalculator	           my_mlm_resid_corr;
 };
 
+/** Output of an analysis run concurrently with others (see
+ *  Iterative_Models::compute_models()).  The output is kept rather than
+ *  written, so that it can be written afterward in order.  Debugging output
+ *  is discarded, so analyses are only run this way when debugging is off.
+ */
+class deferred_output
+{
+  public:
+
+    /// Errors are kept for err, each with its own priority.
+    explicit deferred_output(cerrorstream& err);
+
+    /// Writes the output kept to o (and the errors to err), and clears it.
+    void write(APP::Output_Streams& o);
+
+    std::ostringstream         messages;
+    std::ostringstream         debug;
+    bufferederrorstream<char>  errors;
+
+  private:
+
+    deferred_output(const deferred_output&);
+    deferred_output& operator=(const deferred_output&);
+};
+
 //lint -esym(1712,primary_analysis)
 
 /** The primary SEGREG analysis class
@@ -86,6 +115,10 @@ class primary_analysis
 
     primary_analysis(APP::Output_Streams& o);
 
+    /// Creates an analysis whose output is kept in d rather than written.
+    /// Its results are not added to get_intermediate_results().
+    primary_analysis(APP::Output_Streams& o, deferred_output& d);
+
     ~primary_analysis();
 
     bool is_quality () const;
@@ -98,12 +131,20 @@ class primary_analysis
  
     const primary_analysis_results& get_results() const;
 
+    /// The valid results of the analyses run so far, in order, including
+    /// those of the models an Iterative_Models computes with this analysis.
+    vector<primary_analysis_results>& get_intermediate_results();
+
+    /// The members of the conditioned subset, whose trait values are left
+    /// out of the initial estimates (see mean_split).  Empty unless there
+    /// is ascertainment.
+    set<FPED::MemberConstPointer>&       get_conditioned_members();
+    const set<FPED::MemberConstPointer>& get_conditioned_members() const;
+
     bool check_all_fixed(const PedigreeDataSet& ped_data, const model& some_model);
     vector<std::pair<string,double> > do_single_evaluation(const PedigreeDataSet& ped_data, \
     const model& test_model, double& func_val, vector<string>& par_type);
 
-    static double like_cutoff;
-
     
   protected:
 
@@ -123,6 +164,7 @@ class primary_analysis
       MAXFUN::Results      current_results;
 
       bool                is_bad;
+      bool                is_done;  ///< Set when a concurrent maximization completes.
 
     };
 
@@ -177,8 +219,32 @@ class primary_analysis
 
     segreg_errors::error_code test_model(uint                   m);
 
+    /// Maximizes each of the initial models, concurrently when more than
+    /// one thread is available (see model::get_thread_count()).  Each model
+    /// has its own calculator and parameters, so the results, and the
+    /// output, are the same as when the models are maximized in order.
+    ///
+    /// If the model asks for it (see model::get_prune_distance()), each
+    /// model is first screened with a few iterations, and those too far
+    /// below the best are dropped before the full maximization.
     void                      run_initial_maxfun();
     void                      run_initial_maxfun(uint model_index);
+
+    MAXFUN::SequenceCfg       get_initial_sequence() const;
+    MAXFUN::SequenceCfg       get_screening_sequence() const;
+
+    void                      screen_initial_models(size_t thread_count);
+    void                      screen_initial_model(uint model_index);
+
+    /// Runs f on each model.  If thread_count is more than one, the models
+    /// are run concurrently, with their calculators made serial meanwhile.
+    void                      run_each_model(void (primary_analysis::*f)(uint),
+                                             size_t thread_count);
+    void                      run_model_task(size_t model_index, size_t worker);
+
+    size_t                    get_initial_thread_count() const;
+
+    void                      output_initial_results(uint model_index);
        
     void                      reduce_model_set();
 
@@ -190,9 +256,15 @@ class primary_analysis
 
     void                      finalize_model();
 
+    /// The messages and debug streams, which are out's unless the output
+    /// is deferred.
+    std::ostream&             messages();
+    std::ostream&             debug();
+
     // Output streams
     APP::Output_Streams& out;
     cerrorstream         errors;
+    deferred_output*     my_deferred;
 
     // Data members
     bool my_quality; // 1 = high, 0 = low (faster)
@@ -200,6 +272,12 @@ class primary_analysis
     eval_model_vector        my_models;
 
     primary_analysis_results my_results;
+
+    vector<primary_analysis_results> my_intermediate_results;
+
+    set<FPED::MemberConstPointer>    my_conditioned_members;
+
+    void (primary_analysis::*my_model_function)(uint);
 };
 
 } // End segreg namespace
@@ -14,9 +14,27 @@ primary_analysis::primary_analysis
   (APP::Output_Streams& o)
   : out(o),
     errors(out.errors()),
+    my_deferred(NULL),
     my_quality(true),
     my_models(), 
-    my_results()
+    my_results(),
+    my_intermediate_results(),
+    my_conditioned_members(),
+    my_model_function(NULL)
+{ }
+
+inline 
+primary_analysis::primary_analysis
+  (APP::Output_Streams& o, deferred_output& d)
+  : out(o),
+    errors(d.errors),
+    my_deferred(&d),
+    my_quality(true),
+    my_models(), 
+    my_results(),
+    my_intermediate_results(),
+    my_conditioned_members(),
+    my_model_function(NULL)
 { }
 
 inline
@@ -29,6 +47,24 @@ const primary_analysis_results& primary_analysis::get_results() const
   return my_results;
 }
 
+inline
+vector<primary_analysis_results>& primary_analysis::get_intermediate_results()
+{
+  return my_intermediate_results;
+}
+
+inline
+set<FPED::MemberConstPointer>& primary_analysis::get_conditioned_members()
+{
+  return my_conditioned_members;
+}
+
+inline
+const set<FPED::MemberConstPointer>& primary_analysis::get_conditioned_members() const
+{
+  return my_conditioned_members;
+}
+
 inline
 bool primary_analysis::is_quality() const
 {
@@ -41,6 +77,27 @@ void primary_analysis::set_quality(bool b)
   my_quality = b;
 }
 
+inline
+std::ostream& primary_analysis::messages()
+{
+  return my_deferred ? my_deferred->messages : out.messages();
+}
+
+inline
+std::ostream& primary_analysis::debug()
+{
+  return my_deferred ? my_deferred->debug : out.debug();
+}
+
+//=================================
+// deferred_output inlines
+//=================================
+
+inline
+deferred_output::deferred_output(cerrorstream& err)
+  : errors(err)
+{ }
+
 //=================================
 // primary_analysis_results inlines
 //=================================
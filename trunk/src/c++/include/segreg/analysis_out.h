@@ -22,19 +22,30 @@
 namespace SAGE {
 namespace SEGREG {
 
-/** The analysis_output class collects several static functions for use elsewhere.
+/** The analysis_output class collects several functions for use elsewhere.
  *  These functions output various tables of SEGREG results, and/or multiply
  *  used sections of code.
+ *
+ *  The tables which depend upon the analysis (whether an FPMM model has zero
+ *  polygenic loci) are written by an instance made for that analysis, so
+ *  that analyses in separate threads do not share any state.
  */
 class analysis_output
 {
 public:
 
-  static void output_model            (ostream&, const model&);
+  /// \param skip_poly_locus true if the model is FPMM with zero polygenic
+  ///                        loci, in which case the polygenic parameters are
+  ///                        not shown
+  explicit analysis_output(bool skip_poly_locus = false);
+
+  bool skip_poly_locus() const; // due to JA
+
+  void output_model                  (ostream&, const model&)                    const;
   static void output_initial_estimates(ostream&, const primary_analysis_results&);
-  static void output_final_estimates  (ostream&, const primary_analysis_results&);
-  static void output_likelihoods      (ostream&, const primary_analysis_results&);
-  static void output_final_error      (ostream&, const primary_analysis_results&);
+  void output_final_estimates        (ostream&, const primary_analysis_results&) const;
+  void output_likelihoods            (ostream&, const primary_analysis_results&) const;
+  void output_final_error            (ostream&, const primary_analysis_results&) const;
   static void output_vc_matrix        (ostream&, const primary_analysis_results&);
 
   static void output_likelihood_table_header  (ostream&, model& test_model);
@@ -43,9 +54,6 @@ public:
 
   static void output_mlm_resid_corr_results   (ostream&, const primary_analysis_results&);
 
-  static bool skip_poly_locus; // due to JA
-  static double deriv_sum_sq; // due to JA
-  
   /// Output the asymptotic_p_value table of segregation results
   ///
   /// \param out     The output stream
@@ -59,6 +67,11 @@ protected:
   static void output_model_continuous (ostream&, const model&);
   static void output_model_binary     (ostream&, const model&);
 
+  /// The sum of the squared first derivatives of the independent
+  /// parameters shown in the final estimates.
+  double deriv_sum_sq(const primary_analysis_results&) const; // due to JA
+
+  bool my_skip_poly_locus;
 };
 
 //----------------------------------------------------------------------------
@@ -74,7 +87,9 @@ class analysis_viewer
     // Required to make compiler happy.
     virtual ~analysis_viewer() { }
 
-    analysis_viewer(ostream& output) : my_output(output) { }
+    analysis_viewer(ostream& output, const analysis_output& tables = analysis_output())
+      : my_output(output), my_tables(tables)
+    { }
 
     virtual void print_header(const primary_analysis_results&);
     virtual void print_results(const primary_analysis_results&) = 0;
@@ -84,7 +99,8 @@ class analysis_viewer
 
   protected:
 
-    ostream& my_output;
+    ostream&        my_output;
+    analysis_output my_tables;
 };
 
 //----------------------------------------------------------------------------
@@ -97,8 +113,8 @@ class analysis_result_file : public analysis_viewer
 {
   public:
 
-    analysis_result_file(ostream& output)
-      : analysis_viewer(output)
+    analysis_result_file(ostream& output, const analysis_output& tables = analysis_output())
+      : analysis_viewer(output, tables)
     { }
 
     virtual void print_results(const primary_analysis_results&);
@@ -116,8 +132,9 @@ class analysis_detailed_file : public analysis_viewer
 {
   public:
 
-    analysis_detailed_file(ostream& output, bool debug = false)
-      : analysis_viewer(output), my_debug(debug)
+    analysis_detailed_file(ostream& output, bool debug = false,
+                           const analysis_output& tables = analysis_output())
+      : analysis_viewer(output, tables), my_debug(debug)
     { }
 
     virtual void print_results(const primary_analysis_results&);
@@ -139,8 +156,8 @@ class analysis_intermediate_file : public analysis_viewer
 {
   public:
 
-    analysis_intermediate_file(ostream& output)
-      : analysis_viewer(output)
+    analysis_intermediate_file(ostream& output, const analysis_output& tables = analysis_output())
+      : analysis_viewer(output, tables)
     { }
 
     virtual void print_results(const primary_analysis_results&);
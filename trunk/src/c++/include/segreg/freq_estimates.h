@@ -17,13 +17,14 @@ public:
 
   typedef genotype_frequency_sub_model freq_sub_model;
 
-  genotype_frequency_initial_estimates(const mean_split& splitter, const freq_sub_model& fsm);
+  /// The estimates of a continuous trait differ from those of a binary one.
+  genotype_frequency_initial_estimates(const mean_split& splitter, const freq_sub_model& fsm,
+                                       bool continuous);
 
   size_t get_model_count() const;
 
   const freq_sub_model& get_model(size_t) const;
 
- static bool cont;
 private:
 
   size_t         my_model_count;
@@ -64,17 +64,42 @@ class Iterative_Models
 
     const primary_analysis_results& get_model(mean_option, transm_option,
                                               bool quality = true);
+
+    /// Computes the models of the mean option and transmission options
+    /// given, so that get_model() returns them at once.  The transmission
+    /// options must be in an order where each follows those whose results it
+    /// uses (see uses_results_of()).
+    ///
+    /// The models are computed in stages.  Each stage holds the models which
+    /// use the results of models in earlier stages only.  The starting points
+    /// of a stage's models are created in order, and the models are then
+    /// maximized concurrently, using up to thread_count threads.  Their
+    /// output is written, and their results stored, in order afterward.
+    /// If a starting point needs a model which isn't yet computed, the
+    /// stage's models before it are finished first, so the output comes
+    /// in the same order as when the models are computed one at a time.
+    /// The threads are shared out between the models of a stage, so that
+    /// each model's own threads (see model::get_thread_count()) don't add
+    /// to those.
+    ///
+    /// With one thread, or when debugging, this is the same as calling
+    /// get_model() for each option in order.
+    void compute_models(mean_option m, const vector<transm_option>& t,
+                        size_t thread_count);
+
+    /// Returns true if the model with transmission option t uses results of
+    /// the model with transmission option u (and the same mean option) as
+    /// starting points.  This is the dependency graph of get_starting_models().
+    static bool uses_results_of(transm_option t, transm_option u);
   
     void set_one_mean_res(double ); // (due to JA for new & improved initial estimates)
     void set_one_susc_res(double ); // (due to JA for new & improved initial estimates)
-
-    static vector<primary_analysis_results> intermax;
-    // results of intermediate maximization
   protected:
 
     typedef primary_analysis::model_vector model_vector;
 
     struct model_results;
+    struct model_job;
 
     /// Clear clears the map and makes all the models into a base model.
     void clear();
@@ -168,6 +193,24 @@ class Iterative_Models
 
     void produce_model_failure(mean_option m, transm_option t, model_results& res);
 
+    /// Concurrent computation (see compute_models())
+    //@{
+
+    /// Returns true if a job of the current stage computes res.
+    bool is_pending(const model_results& res) const;
+
+    /// Maximizes the jobs of the current stage, writes their output and
+    /// stores their results, in order, then clears them.
+    void run_jobs();
+
+    /// Maximizes job j.  Used as the ThreadPool task of compute_models().
+    void run_job(size_t j, size_t worker);
+
+    /// Writes the output of job j and stores its results.
+    void finish_job(model_job& job);
+
+    //@}
+
 
     // Data Members
 
@@ -219,6 +262,23 @@ class Iterative_Models
 
     std::map<model_classification, model_results> my_iterative_models;
 
+    /// A model of the current stage of compute_models(), with its starting
+    /// points and results.
+    struct model_job
+    {
+      model_job(mean_option m, transm_option t, model_results* r,
+                const model_vector& v, bool q, cerrorstream& err);
+
+      mean_option                        mean_opt;
+      transm_option                      transm_opt;
+      model_results*                     results;
+      model_vector                       models;
+      bool                               quality;
+      bool                               done;
+      boost::shared_ptr<deferred_output> output;
+      primary_analysis_results           result;
+    };
+
     mean_split my_trait_sample;
 
     // non data storage elements
@@ -236,6 +296,12 @@ class Iterative_Models
     double one_mean_res; // (due to JA for new & improved initial estimates)
     double one_susc_res; // (due to JA for new & improved initial estimates)
 
+    /// When set, the next model requested is added to my_jobs rather than
+    /// being maximized.  Models it depends on are computed as usual.
+    bool                  my_defer;
+    vector<model_job>     my_jobs;
+    size_t                my_job_threads; ///< thread_count of compute_models()
+
     void output_max_line(mean_option m, transm_option t, bool done = false) const;
 };
 
@@ -19,7 +19,9 @@ Iterative_Models::Iterative_Models
     output_mean(true),
     output_transm(true),
     one_mean_res(QNAN),
-    one_susc_res(QNAN) 
+    one_susc_res(QNAN),
+    my_defer(false),
+    my_job_threads(1)
 { }
 
 inline
@@ -47,16 +49,19 @@ void Iterative_Models::set_target_model(const model& target)
 
   if(my_target_model.get_primary_trait_type() != pt_ONSET ||
      my_target_model.ons_sub_model.t_option() == onset_sub_model::t_S)
-    my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.get_primary_trait());
+    my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.get_primary_trait(),
+                    analyzer.get_conditioned_members());
   else
   {
     // We have to do this based on either the age_onset or age_exam (if
     // there aren't any age_onsets)
     
-    my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.ons_sub_model.age_of_onset());
+    my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.ons_sub_model.age_of_onset(),
+                    analyzer.get_conditioned_members());
 
     if(my_trait_sample.get_n() == 0)
-      my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.ons_sub_model.age_at_exam());
+      my_trait_sample(*my_ped_data.get_raw_data(), my_target_model.ons_sub_model.age_at_exam(),
+                      analyzer.get_conditioned_members());
   }
 }
 
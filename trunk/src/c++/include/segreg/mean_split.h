@@ -5,6 +5,7 @@
 #include "fped/fped.h"
 #include <string>
 #include <numeric>
+#include <set>
 
 namespace SAGE
 {
@@ -41,9 +42,13 @@ class mean_split
 public:
   mean_split() { clear(); }
   
-  bool operator()(const FPED::Multipedigree& ped_data, const string & trait_name) 
+  /// Splits the trait values of the members not in excluded (the
+  /// conditioned subset, if there is ascertainment).
+  bool operator()(const FPED::Multipedigree&             ped_data,
+                  const string &                         trait_name,
+                  const set<FPED::MemberConstPointer>&   excluded = set<FPED::MemberConstPointer>()) 
   { 
-    return calculate_trait_statistics(ped_data, trait_name); 
+    return calculate_trait_statistics(ped_data, trait_name, excluded); 
   }
 
   bool get_status() const; // Returns whether the previous mean_spit was valid;
@@ -70,7 +75,8 @@ public:
 private:
   void clear();
 
-  bool calculate_trait_statistics(const FPED::Multipedigree& RMP, const string& trait_name);
+  bool calculate_trait_statistics(const FPED::Multipedigree& RMP, const string& trait_name,
+                                  const set<FPED::MemberConstPointer>& excluded);
 
   bool find_best_stats (vector<double>& values);
 
@@ -133,6 +133,10 @@ class mlm_peeler : public
 
     ~mlm_peeler() { }
 
+    /// Prepares the peeler for a new likelihood evaluation with bmc,
+    /// discarding all cached values.
+    void reset(binary_member_calculator* bmc);
+
     //=================================================================================================
     //
     // peeler algorithm
@@ -134,15 +134,14 @@ mlm_peeler::mlm_peeler
                      _4, _2, _3),
          boost::counting_iterator<int>(index_AA),
          boost::counting_iterator<int>(index_INVALID))
-{
-  // Set each individual cach
+{ }
 
-  subped_type::member_const_iterator mem = subped.member_begin();
+inline void
+mlm_peeler::reset(binary_member_calculator* bmc)
+{
+  mcc = bmc;
 
-  for( ; mem != subped.member_end(); ++mem)
-  {
-    my_cache.get_individual_cache(*mem).set_member(*mem);
-  }
+  my_cache.invalidate();
 }
 
 /// Calculates \f$\rho\f$ (Equ. 78, SEGREG Formula Documentation)
@@ -132,14 +132,25 @@ class model
     bool            get_type_missing()        const;
     bool            get_trans_missing()       const;
 
+    /// Number of threads used to evaluate pedigree likelihoods.  0 means the
+    /// program default (UTIL::ThreadPool::default_thread_count()).
+    size_t          get_thread_count()        const;
+
+    /// Log likelihood distance below the best initial model at which an
+    /// initial model is dropped after a few iterations, rather than being
+    /// fully maximized.  0 (the default) means initial models are never
+    /// pruned.
+    double          get_prune_distance()      const;
+
     void         set_primary_trait(const std::string& trait_name)
                  { primary_trait = trait_name; }
     void         set_primary_trait_type(primary_type p)
                  { primary_trait_type = p; }
+    void         set_thread_count(size_t n)
+                 { thread_count = n; }
     
     bool has_sex_effect() const;
     
-    static set<FPED::MemberConstPointer> cond_mem_set; // for members of conditioned subset due to JA 
   private:
   
     /// Makes certain the covariate sub models of the model point to the
@@ -180,6 +191,8 @@ class model
     bool            each_pedigree;
     bool            pen_func_output;
     bool            type_prob;
+    size_t          thread_count;
+    double          prune_distance;
     
     // - User asks for a commingling analysis by omitting a mean sub-model.
     //   Similarly, user asks for a transmission analysis by specifying a mean
@@ -182,6 +182,8 @@ model::model(const model& other)
   each_pedigree = other.each_pedigree;
   pen_func_output = other.pen_func_output;
   type_prob = other.type_prob;
+  thread_count = other.thread_count;
+  prune_distance = other.prune_distance;
   primary_trait = other.primary_trait;
   primary_trait_type = other.primary_trait_type;
   mean_missing = other.mean_missing;
@@ -249,6 +251,8 @@ model::operator=(const model& other)
     each_pedigree = other.each_pedigree;
     pen_func_output = other.pen_func_output;
     type_prob = other.type_prob;
+    thread_count = other.thread_count;
+    prune_distance = other.prune_distance;
     primary_trait = other.primary_trait;
     mean_missing = other.mean_missing;
     susc_missing = other.susc_missing;
@@ -285,6 +289,18 @@ model::get_each_pedigree() const
   return each_pedigree;
 }
     
+inline size_t
+model::get_thread_count() const
+{
+  return thread_count;
+}
+
+inline double
+model::get_prune_distance() const
+{
+  return prune_distance;
+}
+
 inline bool         
 model::get_pen_func_output() const
 {
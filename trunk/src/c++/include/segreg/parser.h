@@ -79,6 +79,8 @@ class parser : public SAGE::APP::BasicParser
       const LSFBase*  output;
       
       const LSFBase*  maxfun_options;     ///< Stores maxfun details.
+      const LSFBase*  threads;            ///< Number of evaluation threads.
+      const LSFBase*  prune;              ///< Initial model pruning distance.
     };
     
     typedef CovariateSubmodel::CovariateTypeEnum covariate_type;
@@ -179,6 +181,8 @@ class parser : public SAGE::APP::BasicParser
     void  parse_output_attribute(const LSFBase* param);
     void  parse_model_class(const LSFBase* param);
     void  parse_output_options(const LSFBase* param);
+    void  parse_threads(const LSFBase* param);
+    void  parse_prune(const LSFBase* param);
 
     // Some simple helper functions
     
@@ -75,7 +75,9 @@ parser::base_ptrs::base_ptrs()
       prev_estimate(0),
       output_options(0),
       output(0),
-      maxfun_options(0)
+      maxfun_options(0),
+      threads(0),
+      prune(0)
 {}
 
 
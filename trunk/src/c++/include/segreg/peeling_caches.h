@@ -26,6 +26,8 @@ namespace SAGE
 namespace peeling
 {
 
+template <class IndCache> class segreg_peeling_cache;
+
 template<>
 class individual_cache<SEGREG::TypeDescription::State,log_double>
 {
@@ -40,7 +42,8 @@ class individual_cache<SEGREG::TypeDescription::State,log_double>
     ~individual_cache()
     { }
 
-    void set_member(const member_type& m);
+    /// Clears the cached values, keeping the member's mates.
+    void clear();
 
     bool anterior_cached(const data_type&) const;
     bool anterior_with_mate_cached(const member_type& mate, const data_type&, const data_type&) const;
@@ -144,8 +147,15 @@ class individual_cache<SEGREG::TypeDescription::State,log_double>
       mutable log_double posterior_except_mate[3];
     };
 
-    typedef vector<mate_data>::const_iterator   mate_data_const_iterator;
-    typedef vector<mate_data>::iterator         mate_data_iterator;
+    typedef mate_data                           mate_type;
+
+    typedef const mate_data*                    mate_data_const_iterator;
+    typedef mate_data*                          mate_data_iterator;
+
+    friend class segreg_peeling_cache<individual_cache>;
+
+    /// Sets the member's mate data, one for each of its mates, in storage.
+    void set_member(const member_type& m, mate_data* storage);
 
     mate_data_const_iterator find(const member_type& mate) const;
     mate_data_iterator       find(const member_type& mate);
@@ -153,7 +163,8 @@ class individual_cache<SEGREG::TypeDescription::State,log_double>
     log_double                      my_anterior[3];
     log_double                      my_posterior[3];
  
-    vector<mate_data> my_mate_data;
+    mate_data*                      my_mate_begin;   ///< Owned by the peeling_cache
+    mate_data*                      my_mate_end;
 
 };
 
@@ -172,6 +183,9 @@ class individual_cache<genetic_info,log_double>
     individual_cache();
     individual_cache(const individual_cache&);
 
+    /// Clears the cached values, keeping the member's mates.
+    void clear();
+
     bool anterior_cached              (                   const data_type&) const;
     bool posterior_cached             (                   const data_type&) const;
     bool posterior_with_mate_cached   (const member_type& mate, const data_type&) const;
@@ -201,10 +215,90 @@ class individual_cache<genetic_info,log_double>
       log_double except_mate[3][MAX_POLYGENOTYPE];
     };
 
-    vector<polygenotype_mate_info> posterior_on_mate;
+    typedef polygenotype_mate_info         mate_type;
+
+    typedef const polygenotype_mate_info*  gen_const_iterator;
+    typedef polygenotype_mate_info*        gen_iterator;
+
+    friend class segreg_peeling_cache<individual_cache>;
+
+    /// Sets the member's mate info, one for each of its mates, in storage.
+    void set_member(const member_type& m, polygenotype_mate_info* storage);
+
+    polygenotype_mate_info* my_mate_begin;  ///< Owned by the peeling_cache
+    polygenotype_mate_info* my_mate_end;
+};
+
+/// Storage for the individual caches of a SEGREG peeler.
+///
+/// SEGREG keeps one peeler per subpedigree for the whole maximization, and
+/// reuses it for each likelihood evaluation.  The segreg_peeling_cache
+/// allocates everything the peeler caches when it is constructed:  the
+/// individual caches, and, from a single arena, the per mate data of every
+/// member.  Nothing is allocated afterward.
+///
+/// invalidate() discards all cached values in constant time.  Each
+/// individual cache records the generation in which it was last cleared,
+/// and is cleared when it is first used in a later one.
+template <class IndCache>
+class segreg_peeling_cache
+{
+  public:
+
+    typedef IndCache                       individual_cache_type;
+    typedef typename IndCache::data_type   data_type;
+    typedef typename IndCache::result_type result_type;
+
+    typedef FPED::Subpedigree     subped_type;
+    typedef FPED::Member          member_type;
+
+    segreg_peeling_cache(const subped_type&);
+
+    individual_cache_type& get_individual_cache(const member_type& index);
+
+    /// Discards all cached values.
+    void invalidate();
+
+  protected:
+
+    typedef typename IndCache::mate_type   mate_type;
+
+    const subped_type& my_subpedigree;
+
+    vector<individual_cache_type> my_data;
+    vector<mate_type>             my_mate_arena;
+
+    vector<size_t>                my_generations;    ///< Generation of each individual cache
+    size_t                        my_generation;
+
+  private:
+
+    // The individual caches point into the arena, so the cache can't be copied.
+
+    segreg_peeling_cache(const segreg_peeling_cache&);
+    segreg_peeling_cache& operator=(const segreg_peeling_cache&);
+};
+
+template<>
+class peeling_cache<individual_cache<SEGREG::TypeDescription::State,log_double> >
+  : public segreg_peeling_cache<individual_cache<SEGREG::TypeDescription::State,log_double> >
+{
+  public:
+
+    peeling_cache(const subped_type& s)
+      : segreg_peeling_cache<individual_cache<SEGREG::TypeDescription::State,log_double> >(s)
+    { }
+};
+
+template<>
+class peeling_cache<individual_cache<genetic_info,log_double> >
+  : public segreg_peeling_cache<individual_cache<genetic_info,log_double> >
+{
+  public:
 
-    typedef vector<polygenotype_mate_info>::const_iterator gen_const_iterator;
-    typedef vector<polygenotype_mate_info>::iterator       gen_iterator;
+    peeling_cache(const subped_type& s)
+      : segreg_peeling_cache<individual_cache<genetic_info,log_double> >(s)
+    { }
 };
 
 } // End namespace
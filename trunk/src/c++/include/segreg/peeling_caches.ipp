@@ -25,26 +25,44 @@ namespace peeling
 //===================================================================
 inline
 individual_cache<SEGREG::TypeDescription::State,log_double>::individual_cache()
+  : my_mate_begin(NULL),
+    my_mate_end(NULL)
 {
   double QNAN = std::numeric_limits<double>::quiet_NaN();
   my_anterior[0]  = my_anterior[1]  = my_anterior[2]  = QNAN;
   my_posterior[0] = my_posterior[1] = my_posterior[2] = QNAN;
 }
 
+//===================================================================
+//  set_member(...)
+//===================================================================
 inline void
-individual_cache<SEGREG::TypeDescription::State,log_double>::set_member(const member_type& m)
+individual_cache<SEGREG::TypeDescription::State,log_double>::set_member(
+  const member_type& m, mate_data* storage)
 {
-  // Determine the mate count
-
-  size_t mate_count = m.mate_count();
-
-  my_mate_data.reserve(mate_count);
+  my_mate_begin = my_mate_end = storage;
 
   member_type::mate_const_iterator mt = m.mate_begin();
  
-  for( ; mt != m.mate_end(); ++mt)
+  for( ; mt != m.mate_end(); ++mt, ++my_mate_end)
+  {
+    *my_mate_end = mate_data(&mt->mate());
+  }
+}
+
+//===================================================================
+//  clear()
+//===================================================================
+inline void
+individual_cache<SEGREG::TypeDescription::State,log_double>::clear()
+{
+  double QNAN = std::numeric_limits<double>::quiet_NaN();
+  my_anterior[0]  = my_anterior[1]  = my_anterior[2]  = QNAN;
+  my_posterior[0] = my_posterior[1] = my_posterior[2] = QNAN;
+
+  for(mate_data_iterator i = my_mate_begin; i != my_mate_end; ++i)
   {
-    my_mate_data.push_back(mate_data(&mt->mate()));
+    *i = mate_data(i->mate);
   }
 }
 
@@ -70,7 +88,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::anterior_with_mate_
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return !SAGE::isnan(i->anterior_with_mate[g.get_index()][h.get_index()].get_double());
 }
@@ -97,7 +115,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_with_mate
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return !SAGE::isnan(i->posterior_with_mate[gen_info.get_index()].get_double());
 }
@@ -111,7 +129,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_except_ma
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return !SAGE::isnan(i->posterior_except_mate[gen_info.get_index()].get_double());
 }
@@ -124,7 +142,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl_cached(const me
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return !SAGE::isnan(i->partial_parental_likelihood[g.get_index()].get_double());
 }
@@ -138,7 +156,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl_with_mate_cache
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return !SAGE::isnan(i->ppl_with_mate[g.get_index()][h.get_index()].get_double());
 }
@@ -159,7 +177,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::anterior_with_mate(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->anterior_with_mate[g.get_index()][h.get_index()];
 }
@@ -180,7 +198,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_with_mate
 { 
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->posterior_with_mate[p.get_index()];
 }
@@ -194,7 +212,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_except_ma
 { 
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->posterior_except_mate[p.get_index()];
 }
@@ -208,7 +226,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->partial_parental_likelihood[g.get_index()];
 }
@@ -222,7 +240,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl_with_mate(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->ppl_with_mate[g.get_index()][h.get_index()];
 }
@@ -244,7 +262,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::anterior_with_mate(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->anterior_with_mate[g.get_index()][h.get_index()];
 }
@@ -268,7 +286,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_with_mate
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->posterior_with_mate[p.get_index()];
 }
@@ -283,7 +301,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::posterior_except_ma
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->posterior_except_mate[p.get_index()];
 }
@@ -297,7 +315,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->partial_parental_likelihood[g.get_index()];
 }
@@ -311,7 +329,7 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl_with_mate(
 {
   mate_data_const_iterator i = find(mate);
 
-  if(i == my_mate_data.end()) SAGE_internal_error();  // Should never happen
+  if(i == my_mate_end) SAGE_internal_error();  // Should never happen
 
   return i->ppl_with_mate[g.get_index()][h.get_index()];
 }
@@ -319,29 +337,29 @@ individual_cache<SEGREG::TypeDescription::State,log_double>::ppl_with_mate(
 inline individual_cache<SEGREG::TypeDescription::State,log_double>::mate_data_const_iterator
   individual_cache<SEGREG::TypeDescription::State,log_double>::find(const member_type& mate) const
 {
-  for(mate_data_const_iterator i  = my_mate_data.begin();
-                               i != my_mate_data.end();
+  for(mate_data_const_iterator i  = my_mate_begin;
+                               i != my_mate_end;
                              ++i)
   {
     if(i->mate == &mate)
      return i;
   }
 
-  return my_mate_data.end();  
+  return my_mate_end;  
 }
 
 inline individual_cache<SEGREG::TypeDescription::State,log_double>::mate_data_iterator
   individual_cache<SEGREG::TypeDescription::State,log_double>::find(const member_type& mate)
 {
-  for(mate_data_iterator i  = my_mate_data.begin();
-                               i != my_mate_data.end();
+  for(mate_data_iterator i  = my_mate_begin;
+                               i != my_mate_end;
                              ++i)
   {
     if(i->mate == &mate)
      return i;
   }
 
-  return my_mate_data.end();  
+  return my_mate_end;  
 }
 
 //===================================================================
@@ -402,6 +420,8 @@ individual_cache<genetic_info,log_double>::polygenotype_mate_info::operator=
 //===================================================================
 inline
 individual_cache<genetic_info,log_double>::individual_cache()
+  : my_mate_begin(NULL),
+    my_mate_end(NULL)
 {
   log_double QNAN = log_double(numeric_limits<double>::quiet_NaN());
   for(int i = 0; i < 3; ++i)
@@ -422,7 +442,44 @@ individual_cache<genetic_info,log_double>::individual_cache(const individual_cac
       my_posterior[i][j] = x.my_posterior[i][j];
     }
 
-  posterior_on_mate = x.posterior_on_mate;
+  my_mate_begin = x.my_mate_begin;
+  my_mate_end   = x.my_mate_end;
+}
+
+//===================================================================
+//  set_member(...)
+//===================================================================
+inline void
+individual_cache<genetic_info,log_double>::set_member(
+  const member_type& m, polygenotype_mate_info* storage)
+{
+  my_mate_begin = my_mate_end = storage;
+
+  member_type::mate_const_iterator mt = m.mate_begin();
+
+  for( ; mt != m.mate_end(); ++mt, ++my_mate_end)
+  {
+    *my_mate_end = polygenotype_mate_info(&mt->mate());
+  }
+}
+
+//===================================================================
+//  clear()
+//===================================================================
+inline void
+individual_cache<genetic_info,log_double>::clear()
+{
+  log_double QNAN = log_double(numeric_limits<double>::quiet_NaN());
+  for(int i = 0; i < 3; ++i)
+    for(int j = 0; j < MAX_POLYGENOTYPE; ++j)
+      my_anterior[i][j] = my_posterior[i][j] = QNAN;
+
+  for(gen_iterator i = my_mate_begin; i != my_mate_end; ++i)
+  {
+    for(int g = 0; g < 3; ++g)
+      for(int j = 0; j < MAX_POLYGENOTYPE; ++j)
+        i->with_mate[g][j] = i->except_mate[g][j] = QNAN;
+  }
 }
 
 //===================================================================
@@ -462,8 +519,8 @@ individual_cache<genetic_info,log_double>::posterior_with_mate_cached(
   const member_type& mate, const data_type & gen_info) const
 {
   for(gen_const_iterator 
-      i  = posterior_on_mate.begin ();
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin;
+      i != my_mate_end; ++i)
 
     if((i->mate == &mate) && 
        (!SAGE::isnan(i->with_mate[gen_info.genotype][gen_info.polygenotype].get_double())))
@@ -481,8 +538,8 @@ individual_cache<genetic_info,log_double>::posterior_except_mate_cached(
   const member_type& mate, const data_type & gen_info) const
 {
   for(gen_const_iterator 
-      i  = posterior_on_mate.begin ();
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin;
+      i != my_mate_end; ++i)
 
     if((i->mate == &mate) && 
        (!SAGE::isnan(i->except_mate[gen_info.genotype][gen_info.polygenotype].get_double())))
@@ -521,14 +578,15 @@ individual_cache<genetic_info,log_double>::posterior_with_mate(
   const member_type& mate, const data_type & p)
 { 
   for(gen_iterator 
-      i  = posterior_on_mate.begin (); 
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin; 
+      i != my_mate_end; ++i)
 
     if(i->mate == &mate) 
       return i->with_mate[p.genotype][p.polygenotype];
 
-  posterior_on_mate.push_back(polygenotype_mate_info(&mate));
-  return posterior_with_mate(mate,p);
+  SAGE_internal_error();  // Should never happen
+
+  return my_mate_begin->with_mate[p.genotype][p.polygenotype];
 }
 
 //===================================================================
@@ -540,14 +598,15 @@ individual_cache<genetic_info,log_double>::posterior_except_mate(
   const member_type& mate, const data_type & p)
 { 
   for(gen_iterator 
-      i  = posterior_on_mate.begin (); 
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin; 
+      i != my_mate_end; ++i)
 
     if(i->mate == &mate) 
       return i->except_mate[p.genotype][p.polygenotype];
 
-  posterior_on_mate.push_back(polygenotype_mate_info(&mate));
-  return posterior_except_mate(mate,p);
+  SAGE_internal_error();  // Should never happen
+
+  return my_mate_begin->except_mate[p.genotype][p.polygenotype];
 }
 
 //===================================================================
@@ -585,12 +644,12 @@ individual_cache<genetic_info,log_double>::posterior_with_mate(
   size_t         Vi = p.polygenotype;
 
   for(gen_const_iterator 
-      i  = posterior_on_mate.begin (); 
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin; 
+      i != my_mate_end; ++i)
 
     if(i->mate == &mate) return i->with_mate[Ui][Vi];
 
-  return posterior_on_mate.begin()->with_mate[Ui][Vi];
+  return my_mate_begin->with_mate[Ui][Vi];
 }
 
 //===================================================================
@@ -605,14 +664,73 @@ individual_cache<genetic_info,log_double>::posterior_except_mate(
   size_t         Vi = p.polygenotype;
 
   for(gen_const_iterator 
-      i  = posterior_on_mate.begin (); 
-      i != posterior_on_mate.end   (); ++i)
+      i  = my_mate_begin; 
+      i != my_mate_end; ++i)
 
     if(i->mate == &mate) return i->except_mate[Ui][Vi];
 
-  return posterior_on_mate.begin()->except_mate[Ui][Vi];
+  return my_mate_begin->except_mate[Ui][Vi];
+}
+
+
+
+//===================================================================
+//  segreg_peeling_cache(...)  [ Constructor ]
+//===================================================================
+template <class IndCache>
+inline
+segreg_peeling_cache<IndCache>::segreg_peeling_cache(const subped_type& s)
+  : my_subpedigree(s),
+    my_data(s.member_count()),
+    my_generations(s.member_count(), 0),
+    my_generation(0)
+{
+  // Size the arena, then give each member its part of it.
+
+  size_t mate_count = 0;
+
+  for(size_t i = 0; i < s.member_count(); ++i)
+    mate_count += s.member_index(i).mate_count();
+
+  my_mate_arena.resize(mate_count);
+
+  mate_type* storage = mate_count ? &my_mate_arena[0] : NULL;
+
+  for(size_t i = 0; i < s.member_count(); ++i)
+  {
+    my_data[i].set_member(s.member_index(i), storage);
+
+    storage += s.member_index(i).mate_count();
+  }
 }
 
+//===================================================================
+//  get_individual_cache(...)
+//===================================================================
+template <class IndCache>
+inline typename segreg_peeling_cache<IndCache>::individual_cache_type&
+segreg_peeling_cache<IndCache>::get_individual_cache(const member_type& index)
+{
+  size_t i = index.subindex();
+
+  if(my_generations[i] != my_generation)
+  {
+    my_data[i].clear();
+
+    my_generations[i] = my_generation;
+  }
 
+  return my_data[i];
+}
+
+//===================================================================
+//  invalidate()
+//===================================================================
+template <class IndCache>
+inline void
+segreg_peeling_cache<IndCache>::invalidate()
+{
+  ++my_generation;
+}
 
 }}
@@ -94,6 +94,10 @@ class regressive_peeler : public
 
     ~regressive_peeler() { } 
 
+    /// Prepares the peeler for a new likelihood evaluation with lelt,
+    /// discarding all cached values.
+    void reset(const LikelihoodElements& lelt);
+
     //==================================================================
     // Public get functions:
     //==================================================================
@@ -155,7 +159,7 @@ class regressive_peeler : public
     // Private data members:
     //==================================================================
     
-    const LikelihoodElements&                   my_likelihood_elts;
+    const LikelihoodElements*                   my_likelihood_elts;
 };
 
 // end namespace
@@ -23,16 +23,15 @@ regressive_peeler::regressive_peeler
    const LikelihoodElements&      lelt)
   : peeling::peeler<TypeDescription::State,log_double,
     peeling::individual_cache<TypeDescription::State,log_double> > (subped),
-    my_likelihood_elts(lelt)
-{
-  // Set each individual cache
+    my_likelihood_elts(&lelt)
+{ }
 
-  subped_type::member_const_iterator mem = subped.member_begin();
+inline void
+regressive_peeler::reset(const LikelihoodElements& lelt)
+{
+  my_likelihood_elts = &lelt;
 
-  for( ; mem != subped.member_end(); ++mem)
-  {
-    my_cache.get_individual_cache(*mem).set_member(*mem);
-  }
+  my_cache.invalidate();
 }
 
 inline const regressive_peeler::result_type& 
@@ -87,8 +86,8 @@ regressive_peeler::calculate_founder_anterior
      const PenetranceContext&    context)
 {
     // Calculate psi and penetrance values:
-    double penetrance = my_likelihood_elts.get_penetrance(ind, g, context);
-    double psi        = my_likelihood_elts.get_frequency(g);
+    double penetrance = my_likelihood_elts->get_penetrance(ind, g, context);
+    double psi        = my_likelihood_elts->get_frequency(g);
 
     return log_double(psi * penetrance);
 }
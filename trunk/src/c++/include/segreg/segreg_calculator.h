@@ -34,7 +34,9 @@
 #include "numerics/log_double.h"
 #include "numerics/cephes.h"
 #include "numerics/functions.h"
+#include "util/ThreadPool.h"
 #include <cmath>
+#include <algorithm>
 
 namespace SAGE
 {
@@ -85,6 +87,13 @@ class segreg_calculator : public MaxFunction
 
     void set_continuous_penalty_component (double c);
 
+    /// When serial, subpedigrees are computed in order by the calling thread
+    /// even if the calculator has a thread pool.  Used when several
+    /// calculators are already being run concurrently (see
+    /// primary_analysis::run_initial_maxfun()).  The result is the same
+    /// either way.
+    void set_serial(bool serial);
+
     double calculate_continuous_penalty() const;
 
     log_double calculate_prevalence_penalty() const;
@@ -120,7 +129,51 @@ class segreg_calculator : public MaxFunction
     typedef FPED::Family                     family_type;
     typedef FPED::FamilyConstPointer         family_const_pointer;
 
+    /// Evaluation state for one worker thread.
+    ///
+    /// Subpedigree likelihoods may be computed concurrently (see
+    /// model::get_thread_count()).  The member calculators and the FPMM_SL
+    /// keep lookup caches, so each worker other than worker 0 gets its own
+    /// copies of them.  Worker 0 shares the calculator's components.
+    struct worker_state
+    {
+      worker_state();
+
+      LikelihoodElements        * like_elts;
+      LikelihoodElements        * asc_like_elts;
+      FPMM_SL                   * fpmmsl;
+      FPMM_SL                   * asc_fpmmsl;
+      binary_member_calculator  * bmc;
+      binary_member_calculator  * abmc;
+
+      vector<double> ant_vec; // due to JA for likelihood rescaling
+      vector<double> pos_vec; // see above
+    };
+
+    /// The peelers of a subpedigree, indexed by whether they include the
+    /// ascertainment correction.
+    ///
+    /// Peelers are created the first time their subpedigree is peeled, and
+    /// reused by every later likelihood evaluation, so that their caches are
+    /// allocated only once.  A subpedigree is peeled by only one worker at a
+    /// time, so each use just rebinds the peeler to that worker's components
+    /// and invalidates its cache.
+    struct subped_peelers
+    {
+      subped_peelers();
+
+      regressive_peeler * reg  [2];
+      FPMM_peeler       * fpmm [2];
+      mlm_peeler        * mlm  [2];
+    };
+
+    typedef log_double (segreg_calculator::*subped_function)
+                (size_t, bool, worker_state&);
+
     void setup_components             ();
+    void setup_workers                ();
+    void delete_worker_components     (worker_state&);
+    void delete_peelers               ();
 
     void setup_regressive_components  ();
     void setup_mlm_components         ();
@@ -146,9 +199,18 @@ class segreg_calculator : public MaxFunction
     void calc_connected_FPMM         ( );
     void calc_connected_MLM          ( );
 
-    log_double calc_connected_regressive   (const FPED::Subpedigree& ps, bool asc = false);
-    log_double calc_connected_FPMM         (const FPED::Subpedigree& ps, bool asc = false);
-    log_double calc_connected_MLM          (const FPED::Subpedigree& ps, bool asc = false);
+    /// Computes the (ascertainment corrected) likelihood of each subpedigree
+    /// with the function given and accumulates them in subpedigree order.
+    void calc_connected              (subped_function f);
+
+    /// Computes the likelihood of subpedigree i using worker w's state.  Used
+    /// as the ThreadPool task of calc_connected().
+    void calc_connected_task         (size_t i, size_t w);
+
+    /// Compute the likelihood of subpedigree i (in my_subpedigrees)
+    log_double calc_connected_regressive   (size_t i, bool asc, worker_state& w);
+    log_double calc_connected_FPMM         (size_t i, bool asc, worker_state& w);
+    log_double calc_connected_MLM          (size_t i, bool asc, worker_state& w);
 
     void calc_unconnected_regressive ( );
     void calc_unconnected_FPMM       ( );
@@ -184,19 +246,28 @@ class segreg_calculator : public MaxFunction
     void calc_founder_pen_func     (const FPED::Member&, pf::pen_func_map&);
 
     //----------------------------------------------------------------------
-    // Calculates subpedigree likelihood given a member and their genotype
+    // Calculates subpedigree likelihood given a member and their genotype.
+    // If a worker is given, the anterior and posterior terms are stored in
+    // its rescaling vectors.
     
     log_double calc_subped_given_member_regressive(regressive_peeler*  rpl,
                                                    const FPED::Member& indi,
-                                                   const TypeDescription::State& genotype);
+                                                   const TypeDescription::State& genotype,
+                                                   worker_state*       w = NULL);
 
     log_double calc_subped_given_member_MLM       (mlm_peeler*         mpl, 
                                                    const FPED::Member& i,  
-                                                   const TypeDescription::State& genotype);
+                                                   const TypeDescription::State& genotype,
+                                                   worker_state*       w = NULL);
 
     log_double calc_subped_given_member_FPMM      (FPMM_peeler*        fpl,
                                                    const FPED::Member& indi,
-                                                   genetic_info        genoinfo);
+                                                   genetic_info        genoinfo,
+                                                   worker_state*       w = NULL);
+
+    /// Combines the rescaling vectors of a worker into a subpedigree
+    /// likelihood (due to JA for likelihood rescaling)
+    static log_double rescaled_likelihood(worker_state& w);
 		
 
     /// Initializes likelihood1 and likelihood2 to 0.0 at the beginning of a calculation.
@@ -225,6 +296,9 @@ class segreg_calculator : public MaxFunction
     FPMM_SL                        *  asc_fpmmsl;
     mlm_peeler                     *  mpl;
 
+    MlmLikelihoodElements          *  my_mlm_like_elts;
+    MlmLikelihoodElements          *  my_asc_mlm_like_elts;
+
     binary_member_calculator       *  bmc;
     binary_member_calculator       *  abmc;
 
@@ -238,12 +312,16 @@ class segreg_calculator : public MaxFunction
     log_double                        likelihood1;
     log_double                        likelihood2;
 
-    static vector<double> reg_ant_vec; // due to JA for likelihood rescaling
-    static vector<double> reg_pos_vec; // see above
-    static vector<double> mlm_ant_vec; // due to JA for likelihood rescaling
-    static vector<double> mlm_pos_vec; // see above
-    static vector<double> fpmm_ant_vec; // due to JA for likelihood rescaling
-    static vector<double> fpmm_pos_vec; // see above
+    // Parallel evaluation of subpedigrees
+
+    vector<const FPED::Subpedigree*>        my_subpedigrees;
+    vector<subped_peelers>                  my_peelers;
+    vector<worker_state>                    my_workers;
+    std::auto_ptr<UTIL::ThreadPool>         my_thread_pool;
+    bool                                    my_serial;
+
+    subped_function                         my_subped_function;
+    vector<log_double>                      my_subped_likelihoods;
 
 };
 
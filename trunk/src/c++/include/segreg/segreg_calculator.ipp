@@ -40,14 +40,19 @@ segreg_calculator::segreg_calculator
     my_asc_like_elts(NULL),
     fpmmsl         (NULL),
     asc_fpmmsl     (NULL),
+    my_mlm_like_elts    (NULL),
+    my_asc_mlm_like_elts(NULL),
     bmc            (NULL),
     abmc           (NULL),
     my_mlm_corr_verifier (NULL),
-    last_likelihood(QNAN)
+    last_likelihood(QNAN),
+    my_serial      (false),
+    my_subped_function(NULL)
 { 
    nfe = 0;
 
    setup_components(); 
+   setup_workers();
 
    set_continuous_penalty_component (1.0   );
 }
@@ -60,6 +65,13 @@ segreg_calculator::segreg_calculator
 
 inline segreg_calculator::~segreg_calculator()
 {
+  // Worker 0 shares our components, so only the others are deleted here.
+
+  delete_peelers();
+
+  for(size_t w = 1; w < my_workers.size(); ++w)
+    delete_worker_components(my_workers[w]);
+
   if(my_like_elts) { delete my_like_elts; my_like_elts = NULL; }
 
   if(fpmmsl)     { delete fpmmsl;     fpmmsl     = NULL; }
@@ -70,6 +82,9 @@ inline segreg_calculator::~segreg_calculator()
   if(bmc)        { delete bmc;        bmc        = NULL; }
   if(abmc)       { delete abmc;       abmc       = NULL; }
 
+  if(my_mlm_like_elts)     { delete my_mlm_like_elts;     my_mlm_like_elts     = NULL; }
+  if(my_asc_mlm_like_elts) { delete my_asc_mlm_like_elts; my_asc_mlm_like_elts = NULL; }
+
   my_mlm_corr_verifier = std::auto_ptr<MlmCorrelationVerifier>(NULL);
 
   //if(mlm_resid_corr) { delete mlm_resid_corr; mlm_resid_corr = NULL; }
@@ -111,6 +126,8 @@ inline
 void segreg_calculator::setup_mlm_components()
 {
   bmc = new binary_member_calculator(*my_ped_data.get_raw_data(),md,false);
+
+  my_mlm_like_elts = new MlmLikelihoodElements(*my_ped_data.get_raw_data(),md,false);
   
   my_mlm_corr_verifier =
     std::auto_ptr<MlmCorrelationVerifier>
@@ -120,6 +137,8 @@ void segreg_calculator::setup_mlm_components()
   if(using_ascertainment())
   {
     abmc = new binary_member_calculator(*my_ped_data.get_raw_data(),md,true);
+
+    my_asc_mlm_like_elts = new MlmLikelihoodElements(*my_ped_data.get_raw_data(),md,true);
   }
 }
 
@@ -134,6 +153,121 @@ void segreg_calculator::setup_fpmm_components()
   }
 }
 
+//----------------------------------------------------------------------------------
+//
+// Worker state
+//
+//----------------------------------------------------------------------------------
+
+inline
+segreg_calculator::worker_state::worker_state()
+  : like_elts     (NULL),
+    asc_like_elts (NULL),
+    fpmmsl        (NULL),
+    asc_fpmmsl    (NULL),
+    bmc           (NULL),
+    abmc          (NULL)
+{ }
+
+inline
+segreg_calculator::subped_peelers::subped_peelers()
+{
+  for(int asc = 0; asc < 2; ++asc)
+  {
+    reg  [asc] = NULL;
+    fpmm [asc] = NULL;
+    mlm  [asc] = NULL;
+  }
+}
+
+inline
+void segreg_calculator::delete_peelers()
+{
+  for(size_t i = 0; i < my_peelers.size(); ++i)
+  {
+    for(int asc = 0; asc < 2; ++asc)
+    {
+      delete my_peelers[i].reg  [asc];
+      delete my_peelers[i].fpmm [asc];
+      delete my_peelers[i].mlm  [asc];
+    }
+  }
+
+  my_peelers.clear();
+}
+
+inline
+void segreg_calculator::delete_worker_components(worker_state& w)
+{
+  if(w.like_elts)     { delete w.like_elts;     w.like_elts     = NULL; }
+  if(w.asc_like_elts) { delete w.asc_like_elts; w.asc_like_elts = NULL; }
+
+  if(w.fpmmsl)        { delete w.fpmmsl;        w.fpmmsl        = NULL; }
+  if(w.asc_fpmmsl)    { delete w.asc_fpmmsl;    w.asc_fpmmsl    = NULL; }
+
+  if(w.bmc)           { delete w.bmc;           w.bmc           = NULL; }
+  if(w.abmc)          { delete w.abmc;          w.abmc          = NULL; }
+}
+
+/// Creates the thread pool and the per worker components.  The number of
+/// threads is given by the model, or the program default if the model
+/// doesn't specify it, and is never more than the number of subpedigrees.
+
+inline
+void segreg_calculator::setup_workers()
+{
+  for(PedigreeDataSet::SubpedigreeIterator
+          subped = my_ped_data.get_subpedigree_begin();
+          subped != my_ped_data.get_subpedigree_end(); ++subped)
+  {
+    my_subpedigrees.push_back(&*subped);
+  }
+
+  my_peelers.resize(my_subpedigrees.size());
+
+  size_t thread_count = md.get_thread_count();
+
+  if(!thread_count)
+    thread_count = UTIL::ThreadPool::default_thread_count();
+
+  thread_count = std::min(thread_count, my_subpedigrees.size());
+  thread_count = std::max(thread_count, (size_t) 1);
+
+  if(thread_count > 1)
+  {
+    my_thread_pool = std::auto_ptr<UTIL::ThreadPool>(new UTIL::ThreadPool(thread_count));
+
+    thread_count = my_thread_pool->thread_count();
+  }
+
+  my_workers.resize(thread_count);
+
+  // Worker 0 uses our own components
+
+  my_workers[0].like_elts     = my_like_elts;
+  my_workers[0].asc_like_elts = my_asc_like_elts;
+  my_workers[0].fpmmsl        = fpmmsl;
+  my_workers[0].asc_fpmmsl    = asc_fpmmsl;
+  my_workers[0].bmc           = bmc;
+  my_workers[0].abmc          = abmc;
+
+  const FPED::Multipedigree& raw = *my_ped_data.get_raw_data();
+
+  for(size_t w = 1; w < my_workers.size(); ++w)
+  {
+    worker_state& ws = my_workers[w];
+
+    if(my_like_elts)     ws.like_elts     = new LikelihoodElements(raw, md, false);
+    if(my_asc_like_elts) ws.asc_like_elts = new LikelihoodElements(raw, md, true);
+
+    if(fpmmsl)           ws.fpmmsl        = new FPMM_SL(raw, md, false);
+    if(asc_fpmmsl)       ws.asc_fpmmsl    = new FPMM_SL(raw, md, true);
+
+    if(bmc)              ws.bmc           = new binary_member_calculator(raw, md, false);
+    if(abmc)             ws.abmc          = new binary_member_calculator(raw, md, true);
+  }
+}
+
 inline
 bool
   segreg_calculator::using_ascertainment() const
@@ -153,6 +287,12 @@ void segreg_calculator::set_continuous_penalty_component(double c)
    c_penalty_value = max(c, 0.0);
 }
 
+inline
+void segreg_calculator::set_serial(bool serial)
+{
+   my_serial = serial;
+}
+
 inline
 double segreg_calculator::calculate_continuous_penalty() const
 {
@@ -274,7 +414,8 @@ log_double segreg_calculator::calc_likelihood()
 
 inline
 log_double segreg_calculator::calc_subped_given_member_regressive
-(regressive_peeler* rpl, const member_type& indi, const TypeDescription::State&  genotype)
+(regressive_peeler* rpl, const member_type& indi, const TypeDescription::State&  genotype,
+ worker_state* w)
 {
    log_double reg_prob(0.0);
    
@@ -282,8 +423,11 @@ log_double segreg_calculator::calc_subped_given_member_regressive
    
    log_double pos_prob = rpl->posterior(indi, genotype);
 
-   segreg_calculator::reg_ant_vec.push_back(ant_prob.get_double()); // due to JA
-   segreg_calculator::reg_pos_vec.push_back(pos_prob.get_double()); // due to JA
+   if(w)
+   {
+     w->ant_vec.push_back(ant_prob.get_double()); // due to JA
+     w->pos_vec.push_back(pos_prob.get_double()); // due to JA
+   }
 
    reg_prob = ant_prob * pos_prob;
 
@@ -292,7 +436,8 @@ log_double segreg_calculator::calc_subped_given_member_regressive
 
 inline
 log_double segreg_calculator::calc_subped_given_member_MLM
-(mlm_peeler*  mpl, const member_type& i, const TypeDescription::State& g)
+(mlm_peeler*  mpl, const member_type& i, const TypeDescription::State& g,
+ worker_state* w)
 {
 //   cout << "Inside ant-pos part " << endl; // for debugging purposes (due to JA)
    log_double mlm_prob(0.0);
@@ -300,8 +445,11 @@ log_double segreg_calculator::calc_subped_given_member_MLM
    log_double ant_prob = mpl->anterior (i, g);
    log_double pos_prob = mpl->posterior(i, g);
 
-   segreg_calculator::mlm_ant_vec.push_back(ant_prob.get_double()); // due to JA
-   segreg_calculator::mlm_pos_vec.push_back(pos_prob.get_double()); // due to JA
+   if(w)
+   {
+     w->ant_vec.push_back(ant_prob.get_double()); // due to JA
+     w->pos_vec.push_back(pos_prob.get_double()); // due to JA
+   }
 
    mlm_prob = ant_prob * pos_prob;
 
@@ -316,7 +464,7 @@ log_double segreg_calculator::calc_subped_given_member_MLM
 
 inline 
 log_double segreg_calculator::calc_subped_given_member_FPMM
-(FPMM_peeler* fpl, const member_type& indi, genetic_info gi)
+(FPMM_peeler* fpl, const member_type& indi, genetic_info gi, worker_state* w)
 {
    log_double fpmm_prob (0.0);
    
@@ -324,8 +472,11 @@ log_double segreg_calculator::calc_subped_given_member_FPMM
   
    log_double pos_prob = fpl->posterior(indi, gi);
   
-   segreg_calculator::fpmm_ant_vec.push_back(ant_prob.get_double()); // due to JA
-   segreg_calculator::fpmm_pos_vec.push_back(pos_prob.get_double()); // due to JA
+   if(w)
+   {
+     w->ant_vec.push_back(ant_prob.get_double()); // due to JA
+     w->pos_vec.push_back(pos_prob.get_double()); // due to JA
+   }
 
    fpmm_prob = ant_prob * pos_prob;
   
@@ -15,6 +15,7 @@
 //   All Rights Reserved
 //=============================================================================
 
+#include "palbase/gls_batch.h"
 #include "sibpal/sib_matrix.h"
 
 namespace SAGE   {
@@ -45,6 +46,12 @@ class UnivariateGeneralizedLeastSquares3
     void add_block(matrix& y, const matrix& W, const matrix& A, const weight_status_type& status = INVERSEW);
     void add_block_kron(matrix& y, const matrix& W, const matrix& A, const weight_status_type& status = INVERSEW);
 
+    // Same as add_block(ys[i], Ws[i], As[i], statuses[i]) for each cluster
+    // in turn, with the clusters whose W is well conditioned accumulated as
+    // a batch.
+    void add_blocks(vector<matrix>& ys, const vector<matrix>& Ws,
+                    const vector<matrix>& As, const vector<weight_status_type>& statuses);
+
     void compute_covariance(const matrix& X, matrix& C);
     bool compute();
 
@@ -90,6 +97,8 @@ class UnivariateGeneralizedLeastSquares3
     stable_matrix   AWy;           // sum(A' W y)
     stable_matrix   OPG;           // Outer product gradient: sum(A' W E(y) E(y') W A)
     matrix temp1,temp2,temp3;
+
+    PALBASE::gls_batch      my_batch;
 };
 
 typedef UnivariateGeneralizedLeastSquares3 GLS3;
@@ -19,6 +19,7 @@
 //   All Rights Reserved
 //=============================================================================
 
+#include "error/bufferederrorstream.h"
 #include "sibpal/parser.h"
 #include "sibpal/regress_result.h"
 
@@ -77,10 +78,13 @@ class RegressionVariant
     string                my_name;
 };
 
+class SimulationReplicates;
+
 class TraitRegression
 {
   public:
 
+    friend class SimulationReplicates;
     friend class WeightedVariance;
     friend class WeightedCorrelatedVariance;
     friend class WeightedCorrelatedVarianceAndTraits;
@@ -181,6 +185,15 @@ class TraitRegression
     void  simulate();
     void  do_simulate();
 
+    // Threads used for simulation replicates.  0 means the default.
+    void   set_thread_count(size_t n);
+    size_t get_thread_count() const;
+
+    // Seed of the simulation replicates.  0 (the default) means the seed
+    // of the model's p-value options.
+    void          set_seed(unsigned long s);
+    unsigned long get_seed() const;
+
   protected:
 
     //----------------------
@@ -315,13 +328,17 @@ class TraitRegression
 
     void simulate_univariate();
     void do_simulation_univariate();
-    void do_simulation_univariate_replicates(TraitRegression& sim, 
+    void do_simulation_univariate_replicates(TraitRegression& sim,
+                                             bufferederrorstream<char>& sim_errors,
                                              double precision, size_t min_replicates,
                                                                size_t max_replicates);
 
     // Build simulation data structures (not needed for non-simulation analyses)
     void build_simulation();
 
+    // Set up a regression to compute simulation replicates of this one
+    void prepare_simulation(TraitRegression& simulation);
+
     void randomize_marker_data();
     void randomize_marker_data_x();
 
@@ -360,6 +377,9 @@ class TraitRegression
     bool                            my_valid_regression;
     bool                            my_simulating;
 
+    size_t                          my_thread_count;
+    unsigned long                   my_seed;
+
     vector<bool>                    my_use_x_pair;
     vector<bool>                    my_fix_x_pair;
     vector<size_t>                  my_x_pair_count;
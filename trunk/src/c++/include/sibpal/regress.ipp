@@ -72,6 +72,30 @@ TraitRegression::set_model(const regression_model& p)
   my_model = p;
 }
 
+inline void
+TraitRegression::set_thread_count(size_t n)
+{
+  my_thread_count = n;
+}
+
+inline size_t
+TraitRegression::get_thread_count() const
+{
+  return my_thread_count;
+}
+
+inline void
+TraitRegression::set_seed(unsigned long s)
+{
+  my_seed = s;
+}
+
+inline unsigned long
+TraitRegression::get_seed() const
+{
+  return my_seed;
+}
+
 inline void
 TraitRegression::set_sib_clusters(const vector<sib_cluster>& sc)
 {
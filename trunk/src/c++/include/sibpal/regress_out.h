@@ -37,6 +37,10 @@ class regression_outfile
 
     const TraitRegression*  get_analysis() const   { return my_analysis; }
 
+    // Results are printed from the analysis given to print_header(), unless
+    // another analysis of the same trait is set.
+    void set_analysis(const TraitRegression& reg)  { my_analysis = &reg; }
+
     void print_header(const TraitRegression& reg);
     void print_results(size_t test_num);
     void print_footer();
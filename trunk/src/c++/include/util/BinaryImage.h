@@ -0,0 +1,199 @@
+#ifndef UTIL_BINARY_IMAGE_H
+#define UTIL_BINARY_IMAGE_H
+
+//============================================================================
+//  File:       BinaryImage.h
+//
+//  Purpose:    Writing and reading flat binary images of objects (for
+//              caching built data between runs), and a content hash for
+//              detecting when the files they were built from change.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//============================================================================
+
+#include <cstddef>
+#include <string>
+#include <stdint.h>
+
+namespace SAGE {
+namespace UTIL {
+
+/// \brief Appends values to a binary image.
+///
+/// Values are written in native byte order, so an image can only be read on
+/// a machine of the same byte order.  Files containing images should record
+/// the byte order and refuse to read images from other machines.
+class BinaryImageWriter
+{
+  public:
+
+    /// Appends to the given string, which must outlive the writer.
+    explicit BinaryImageWriter(std::string& image);
+
+    void put_uint32(uint32_t v);
+    void put_uint64(uint64_t v);
+    void put_int   (int v);
+    void put_double(double v);
+    void put_bool  (bool v);
+
+    /// Strings are written as their length and characters.
+    void put_string(const std::string& s);
+
+    void put_bytes (const void* p, size_t n);
+
+    /// Pads the image with zeros to a multiple of n bytes.
+    void align(size_t n);
+
+    size_t size() const;
+
+  private:
+
+    std::string& my_image;
+};
+
+/// \brief Reads values back from a binary image, in the order written.
+///
+/// Reading past the end of the image (a truncated or corrupt image) makes
+/// good() false from then on, and every later value is zero or empty, so a
+/// caller need only check good() once it is done.
+class BinaryImageReader
+{
+  public:
+
+    BinaryImageReader(const char* first, const char* last);
+
+    uint32_t    get_uint32();
+    uint64_t    get_uint64();
+    int         get_int();
+    double      get_double();
+    bool        get_bool();
+    std::string get_string();
+    void        get_string(std::string& s);
+
+    /// Copies n bytes to p.
+    bool        get_bytes(void* p, size_t n);
+
+    /// Returns a pointer to the next n bytes, and skips them, or NULL if
+    /// there are fewer than n.
+    const char* skip(size_t n);
+
+    /// Skips to a multiple of n bytes from the start of the image.
+    void        align(size_t n);
+
+    bool        good()      const;
+    size_t      position()  const;
+    size_t      remaining() const;
+
+  private:
+
+    const char* my_first;
+    const char* my_current;
+    const char* my_last;
+    bool        my_good;
+};
+
+/// \brief A 64 bit FNV-1a hash of a sequence of values and file contents.
+///
+/// This detects changes to input files; it is not a cryptographic hash.
+class ContentHash
+{
+  public:
+
+    ContentHash();
+
+    void add(const void* p, size_t n);
+    void add_string(const std::string& s);
+    void add_uint64(uint64_t v);
+
+    /// Adds the name and the contents of a file.  Returns false, and adds
+    /// only the name, if the file cannot be read.
+    bool add_file(const std::string& filename);
+
+    uint64_t value() const;
+
+  private:
+
+    uint64_t my_value;
+};
+
+//============================================================================
+// Inline functions
+//============================================================================
+
+inline BinaryImageWriter::BinaryImageWriter(std::string& image) : my_image(image) { }
+
+inline void BinaryImageWriter::put_bytes(const void* p, size_t n)
+{
+  my_image.append(static_cast<const char*>(p), n);
+}
+
+inline void BinaryImageWriter::put_uint32(uint32_t v) { put_bytes(&v, sizeof(v)); }
+inline void BinaryImageWriter::put_uint64(uint64_t v) { put_bytes(&v, sizeof(v)); }
+inline void BinaryImageWriter::put_int   (int v)      { put_uint32((uint32_t) v);   }
+inline void BinaryImageWriter::put_double(double v)   { put_bytes(&v, sizeof(v)); }
+inline void BinaryImageWriter::put_bool  (bool v)     { put_uint32(v ? 1 : 0);      }
+
+inline void BinaryImageWriter::put_string(const std::string& s)
+{
+  put_uint64(s.size());
+  my_image.append(s);
+}
+
+inline size_t BinaryImageWriter::size() const { return my_image.size(); }
+
+inline BinaryImageReader::BinaryImageReader(const char* first, const char* last)
+  : my_first(first), my_current(first), my_last(last), my_good(first <= last)
+{ }
+
+inline const char* BinaryImageReader::skip(size_t n)
+{
+  if(!my_good || (size_t) (my_last - my_current) < n)
+  {
+    my_good = false;
+
+    return NULL;
+  }
+
+  const char* p = my_current;
+
+  my_current += n;
+
+  return p;
+}
+
+inline uint32_t BinaryImageReader::get_uint32() { uint32_t v = 0; get_bytes(&v, sizeof(v)); return v; }
+inline uint64_t BinaryImageReader::get_uint64() { uint64_t v = 0; get_bytes(&v, sizeof(v)); return v; }
+inline int      BinaryImageReader::get_int()    { return (int) get_uint32();                             }
+inline double   BinaryImageReader::get_double() { double v = 0.0; get_bytes(&v, sizeof(v)); return v;  }
+inline bool     BinaryImageReader::get_bool()   { return get_uint32() != 0;                              }
+
+inline std::string BinaryImageReader::get_string()
+{
+  std::string s;
+
+  get_string(s);
+
+  return s;
+}
+
+inline bool      BinaryImageReader::good()      const { return my_good;                      }
+inline size_t    BinaryImageReader::position()  const { return my_current - my_first;        }
+inline size_t    BinaryImageReader::remaining() const { return my_good ? my_last - my_current : 0; }
+
+inline ContentHash::ContentHash() : my_value(14695981039346656037ULL) { }
+
+inline void ContentHash::add_uint64(uint64_t v) { add(&v, sizeof(v)); }
+
+inline void ContentHash::add_string(const std::string& s)
+{
+  add_uint64(s.size());
+  add(s.data(), s.size());
+}
+
+inline uint64_t ContentHash::value() const { return my_value; }
+
+} // End namespace UTIL
+} // End namespace SAGE
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef UTIL_THREAD_POOL_H
+#define UTIL_THREAD_POOL_H
+
+//============================================================================
+//  File:       ThreadPool.h
+//
+//  Purpose:    A small, persistent pool of worker threads for running
+//              independent work items (pedigrees, markers, replicates, etc.)
+//              concurrently.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//============================================================================
+
+#include <cstddef>
+#include <vector>
+#include <pthread.h>
+
+namespace SAGE {
+namespace UTIL {
+
+/// \brief Work to be run by a ThreadPool.
+///
+/// A task is a set of items, numbered 0 to n-1, which can be computed in any
+/// order.  Each call to run() is given the number of the worker which is
+/// running it (0 to ThreadPool::thread_count()-1).  No two items are run at
+/// the same time by the same worker, so tasks can keep per-worker scratch
+/// storage indexed by worker number without any locking.
+///
+/// Tasks should store their results by item number and combine them after
+/// ThreadPool::run() returns, so that the result does not depend on the
+/// order in which items complete.
+class ParallelTask
+{
+  public:
+
+    virtual ~ParallelTask() { }
+
+    /// Computes a single item.
+    /// \param item   The item number.
+    /// \param worker The worker running the item.
+    virtual void run(size_t item, size_t worker) = 0;
+};
+
+/// \brief A fixed size pool of worker threads.
+///
+/// The thread calling run() always participates as worker 0, so a pool of
+/// one thread creates no threads at all, and simply runs the items in order.
+/// This is the default, so programs behave as they always have unless the
+/// user asks for more threads.
+///
+/// The pool is not reentrant: run() must not be called from within a task
+/// being run by the same pool.
+class ThreadPool
+{
+  public:
+
+    /// Creates a pool.
+    /// \param thread_count The total number of threads, including the
+    ///                     calling thread.  0 means default_thread_count().
+    explicit ThreadPool(size_t thread_count = 0);
+
+    ~ThreadPool();
+
+    /// Returns the number of workers (threads, including the caller).
+    size_t thread_count() const;
+
+    /// Runs items 0 to item_count-1 of the task, and returns when they are
+    /// all complete.  Items are handed to workers dynamically, in order.
+    ///
+    /// \returns true if every item completed, false if any item threw an
+    ///          exception.
+    bool run(size_t item_count, ParallelTask& task);
+
+    /// @name Program-wide default
+    //@{
+
+      ///
+      /// Returns the number of threads used by pools constructed with no
+      /// thread count.  This is 1 unless set (typically by the --threads
+      /// command line option).
+      static size_t default_thread_count();
+
+      ///
+      /// Sets the default thread count.  0 means hardware_thread_count().
+      static void set_default_thread_count(size_t n);
+
+      ///
+      /// Returns the number of processors available, or 1 if unknown.
+      static size_t hardware_thread_count();
+
+    //@}
+
+  private:
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    struct worker_info
+    {
+      ThreadPool* pool;
+      size_t      index;
+    };
+
+    static void* thread_main(void* info);
+
+    void worker_loop(size_t worker);
+    void process_items(size_t worker);
+
+    std::vector<pthread_t>   my_threads;
+    std::vector<worker_info> my_worker_info;
+
+    pthread_mutex_t my_mutex;
+    pthread_cond_t  my_work_available;
+    pthread_cond_t  my_work_complete;
+
+    ParallelTask*   my_task;
+    size_t          my_item_count;
+    size_t          my_next_item;
+    size_t          my_busy_workers;
+    size_t          my_generation;
+    bool            my_shutdown;
+    bool            my_failed;
+
+    static size_t   our_default_thread_count;
+};
+
+/// Convenience for tasks whose items are calls to a member function of an
+/// object, ie, obj.*f(item, worker).
+template <class T>
+class MemberTask : public ParallelTask
+{
+  public:
+
+    typedef void (T::*function_type)(size_t, size_t);
+
+    MemberTask(T& obj, function_type f) : my_obj(obj), my_function(f) { }
+
+    virtual void run(size_t item, size_t worker) { (my_obj.*my_function)(item, worker); }
+
+  private:
+
+    T&            my_obj;
+    function_type my_function;
+};
+
+} // End namespace UTIL
+} // End namespace SAGE
+
+#endif
@@ -75,12 +75,12 @@ analysis::build()
     //
     if(my_instructions.average_thetas.size())
     {
-      my_tasks.push_back(task_ptr(new non_ss_lods(my_errors, my_mped, my_instructions)));
+      my_tasks.push_back(task_ptr(new non_ss_lods(my_errors, my_mped, my_instructions, my_models)));
     }
     
     if(my_instructions.male_female_thetas.size())
     {
-      my_tasks.push_back(task_ptr(new ss_lods(my_errors, my_mped, my_instructions)));
+      my_tasks.push_back(task_ptr(new ss_lods(my_errors, my_mped, my_instructions, my_models)));
     }
     
     // - Linkage tests.
@@ -91,23 +91,23 @@ analysis::build()
       {
         if(my_instructions.linkage_homog)
         {
-          my_tasks.push_back(task_ptr(new ss_lod_ratio_test(my_errors, my_mped, my_instructions)));
-          my_tasks.push_back(task_ptr(new cleves_elston_test(my_errors, my_mped, my_instructions)));
+          my_tasks.push_back(task_ptr(new ss_lod_ratio_test(my_errors, my_mped, my_instructions, my_models)));
+          my_tasks.push_back(task_ptr(new cleves_elston_test(my_errors, my_mped, my_instructions, my_models)));
         }
         else
         {
-          my_tasks.push_back(task_ptr(new ss_smiths_faraways_test(my_errors, my_mped, my_instructions, sf_LINKAGE)));  
+          my_tasks.push_back(task_ptr(new ss_smiths_faraways_test(my_errors, my_mped, my_instructions, my_models, sf_LINKAGE, my_smiths_alt)));  
         }
       }
       else
       {
         if(my_instructions.linkage_homog)
         {
-          my_tasks.push_back(task_ptr(new non_ss_lod_ratio_test(my_errors, my_mped, my_instructions)));
+          my_tasks.push_back(task_ptr(new non_ss_lod_ratio_test(my_errors, my_mped, my_instructions, my_models)));
         }
         else
         {
-          my_tasks.push_back(task_ptr(new non_ss_smiths_faraways_test(my_errors, my_mped, my_instructions, sf_LINKAGE)));
+          my_tasks.push_back(task_ptr(new non_ss_smiths_faraways_test(my_errors, my_mped, my_instructions, my_models, sf_LINKAGE, my_smiths_alt)));
         }
       }
     }
@@ -118,11 +118,11 @@ analysis::build()
     {
       if(my_instructions.smiths_sex_specific)
       {
-        my_tasks.push_back(task_ptr(new ss_smiths_faraways_test(my_errors, my_mped, my_instructions, sf_HOMOGENEITY)));
+        my_tasks.push_back(task_ptr(new ss_smiths_faraways_test(my_errors, my_mped, my_instructions, my_models, sf_HOMOGENEITY, my_smiths_alt)));
       }
       else
       {
-        my_tasks.push_back(task_ptr(new non_ss_smiths_faraways_test(my_errors, my_mped, my_instructions, sf_HOMOGENEITY)));
+        my_tasks.push_back(task_ptr(new non_ss_smiths_faraways_test(my_errors, my_mped, my_instructions, my_models, sf_HOMOGENEITY, my_smiths_alt)));
       }
     }
     
@@ -138,11 +138,11 @@ analysis::build()
       {
         if(my_instructions.mortons_sex_specific)
         {
-          my_tasks.push_back(task_ptr(new ss_mortons_test(my_errors, my_mped, my_instructions)));
+          my_tasks.push_back(task_ptr(new ss_mortons_test(my_errors, my_mped, my_instructions, my_models)));
         }
         else
         {
-          my_tasks.push_back(task_ptr(new non_ss_mortons_test(my_errors, my_mped, my_instructions)));
+          my_tasks.push_back(task_ptr(new non_ss_mortons_test(my_errors, my_mped, my_instructions, my_models)));
         }
       }
     }
@@ -151,11 +151,11 @@ analysis::build()
     {
       if(my_instructions.genotypes_sex_specific == true)
       {
-        my_tasks.push_back(task_ptr(new ss_genotype_probs(my_errors, my_mped, my_instructions)));      
+        my_tasks.push_back(task_ptr(new ss_genotype_probs(my_errors, my_mped, my_instructions, my_models)));      
       }
       else
       {
-        my_tasks.push_back(task_ptr(new non_ss_genotype_probs(my_errors, my_mped, my_instructions)));
+        my_tasks.push_back(task_ptr(new non_ss_genotype_probs(my_errors, my_mped, my_instructions, my_models)));
       }
     }
   }
@@ -244,16 +244,6 @@ analysis::write_file_header(ostream& out, const string& file_type, APP::SAGEapp&
   out.flags(old_flags); 
 }
 
-// - Clear static elements from Smith's and Faraway's task classes.
-//
-void
-analysis::clear()
-{
-  non_ss_smiths_faraways_test::clear();
-  ss_smiths_faraways_test::clear();
-  ge_models::clear_models();
-}
-
 
 }
 }
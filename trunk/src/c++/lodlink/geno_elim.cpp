@@ -26,9 +26,6 @@ namespace LODLINK
 // IMPLEMENTATION:  ge_models
 //============================================================================
 //
-pedigree_imodel_generator  ge_models::my_generator;
-ge_models::model_map       ge_models::my_models;
-
 /// Clears the current set of models from storage, preventing accidentally looking
 /// up the wrong thing between analyses.
 void ge_models::clear_models()
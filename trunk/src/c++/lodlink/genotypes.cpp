@@ -27,8 +27,8 @@ namespace LODLINK
 void
 genotype_probs::calculate_genotypes(peeler& plr, const member_type& ind, genotype_result& result)
 {
-  MLOCUS::penetrance_model  trait_pm(ge_models::get_model(plr.subpedigree(), plr.trait()));
-  MLOCUS::penetrance_model  marker_pm(ge_models::get_model(plr.subpedigree(), plr.marker()));
+  MLOCUS::penetrance_model  trait_pm(plr.models().get_model(plr.subpedigree(), plr.trait()));
+  MLOCUS::penetrance_model  marker_pm(plr.models().get_model(plr.subpedigree(), plr.marker()));
   size_t  trait_phenotype(ind.subindex() + 1);
   size_t  marker_phenotype(ind.subindex() + 1);
   
@@ -135,7 +135,7 @@ non_ss_genotype_probs::calculate_alt(size_t trait_index, size_t marker_index, no
       mle.set_strict_limits();
       mle.set_average_theta(result.theta);
       
-      peeler  plr(*subped_iter, mle, trait_index, marker_index);
+      peeler  plr(*subped_iter, mle, trait_index, marker_index, my_models);
       member_const_iterator  member_iter = subped_iter->member_begin();
       for(; member_iter != subped_iter->member_end(); ++member_iter)
       {
@@ -262,7 +262,7 @@ ss_genotype_probs::calculate_alt(size_t trait_index, size_t marker_index, ss_gen
       mle.set_male_theta(result.thetas.male_theta);
       mle.set_female_theta(result.thetas.female_theta);      
       
-      peeler  plr(*subped_iter, mle, trait_index, marker_index);
+      peeler  plr(*subped_iter, mle, trait_index, marker_index, my_models);
 
       member_const_iterator  member_iter = subped_iter->member_begin();
       for(; member_iter != subped_iter->member_end(); ++member_iter)
@@ -48,7 +48,7 @@ subped_calculator::likelihood()
 
   log_double  like(0);
           
-  phenoset  ph_set(subped, trait, marker, *m_iter);
+  phenoset  ph_set(subped, trait, marker, *m_iter, my_peeler.models());
   phenoset::phenoset_iterator  ph_iter = ph_set.begin();
   for(; ph_iter != ph_set.end(); ++ph_iter)
   {
@@ -98,7 +98,7 @@ subped_calculator::calc_unlinked_likelihood()
   }
   
   peeler  unlinked_peeler(my_peeler.subpedigree(), unlinked_mle,
-                           my_peeler.trait(), my_peeler.marker());
+                           my_peeler.trait(), my_peeler.marker(), my_peeler.models());
   subped_calculator  unlinked_calculator(unlinked_peeler);
   
   my_unlinked_likelihood = unlinked_calculator.likelihood();
@@ -108,6 +108,88 @@ subped_calculator::calc_unlinked_likelihood()
 }
 
 
+//============================================================================
+// IMPLEMENTATION:  polynomial_calculator
+//============================================================================
+//
+log_double
+polynomial_calculator::likelihood(const subped_type& subped, const mle_sub_model& mle)
+{
+  const theta_polynomial&  poly = polynomial(subped);
+  
+  if(! poly.is_set())
+  {
+    peeler  p(subped, mle, my_trait, my_marker, my_models);
+    subped_calculator  sp_calc(p);
+    
+    return  sp_calc.likelihood();
+  }
+  
+  log_double  like = poly.evaluate(mle.theta(male), mle.theta(female));
+  
+  if(mle.uses_alpha())
+  {
+    double  my_alpha = mle.alpha();
+    assert(my_alpha != QNAN);
+    like = my_alpha * like + (1 - my_alpha) * unlinked_likelihood(subped);
+  }
+  
+  return  like;
+}
+
+log_double
+polynomial_calculator::unlinked_likelihood(const subped_type& subped)
+{
+  std::map<const subped_type*, log_double>::const_iterator  u_iter = my_unlinked_likelihoods.find(&subped);
+  if(u_iter != my_unlinked_likelihoods.end())
+  {
+    return  u_iter->second;
+  }
+  
+  log_double  like;
+  
+  const theta_polynomial&  poly = polynomial(subped);
+  if(poly.is_set())
+  {
+    like = poly.evaluate(NULL_THETA);
+  }
+  else
+  {
+    mle_sub_model  mle(false, false);
+    peeler  p(subped, mle, my_trait, my_marker, my_models);
+    subped_calculator  sp_calc(p);
+    
+    like = sp_calc.unlinked_likelihood();
+  }
+  
+  my_unlinked_likelihoods[&subped] = like;
+  
+  return  like;
+}
+
+// - Peel the subpedigree if it has not been.  Returns an unset polynomial for
+//   subpedigrees too large to peel w. polynomials.
+//
+const theta_polynomial&
+polynomial_calculator::polynomial(const subped_type& subped)
+{
+  std::map<const subped_type*, theta_polynomial>::iterator  p_iter = my_polynomials.find(&subped);
+  if(p_iter != my_polynomials.end())
+  {
+    return  p_iter->second;
+  }
+  
+  theta_polynomial&  poly = my_polynomials[&subped];
+  if(poly_peeler::use_polynomial(subped))
+  {
+    poly_peeler  p(subped, my_trait, my_marker, my_models);
+    poly = p.likelihood();
+  }
+  
+  return  poly;
+}
+
+
 //============================================================================
 // IMPLEMENTATION:  ped_calculator
 //============================================================================
@@ -121,7 +203,13 @@ ped_calculator::likelihood()
   {
     for(; subped_iter != my_ped.subpedigree_end(); ++subped_iter)
     {
-      peeler  p(*subped_iter, my_mle, my_trait, my_marker);
+      if(my_polynomials)
+      {
+        like *= my_polynomials->likelihood(*subped_iter, my_mle);
+        continue;
+      }
+      
+      peeler  p(*subped_iter, my_mle, my_trait, my_marker, my_models);
       subped_calculator  sp_calc(p);
       like *= sp_calc.likelihood();
     }
@@ -145,7 +233,13 @@ ped_calculator::calc_unlinked_likelihood()
   {
     for(; subped_iter != my_ped.subpedigree_end(); ++subped_iter)
     {
-      peeler  p(*subped_iter, my_mle, my_trait, my_marker);
+      if(my_polynomials)
+      {
+        like *= my_polynomials->unlinked_likelihood(*subped_iter);
+        continue;
+      }
+      
+      peeler  p(*subped_iter, my_mle, my_trait, my_marker, my_models);
       subped_calculator  sp_calc(p);
       like *= sp_calc.unlinked_likelihood();
     }
@@ -185,7 +279,7 @@ group_calculator::likelihood()
   {
     for(; p_iter != my_group.end(); ++p_iter)
     {
-      ped_calculator  ped_calc(**p_iter, my_mle, my_trait, my_marker);
+      ped_calculator  ped_calc(**p_iter, my_mle, my_trait, my_marker, my_models, my_polynomials);
       like *= ped_calc.likelihood();
     }
   }
@@ -206,7 +300,7 @@ mped_calculator::likelihood()
   pedigree_const_iterator  ped_iter = my_mped.pedigree_begin();
   for(; ped_iter != my_mped.pedigree_end(); ++ped_iter)
   {
-    ped_calculator  p_calc(*ped_iter, my_mle, my_trait, my_marker);
+    ped_calculator  p_calc(*ped_iter, my_mle, my_trait, my_marker, my_models, my_polynomials);
     like *= p_calc.likelihood();
   }
   
@@ -228,7 +322,7 @@ mped_calculator::calc_unlinked_likelihood()
   for(; ped_iter != my_mped.pedigree_end(); ++ped_iter)
   {
     {
-      ped_calculator  p_calc(*ped_iter, my_mle, my_trait, my_marker);
+      ped_calculator  p_calc(*ped_iter, my_mle, my_trait, my_marker, my_models, my_polynomials);
       like *= p_calc.unlinked_likelihood();
     }
   }
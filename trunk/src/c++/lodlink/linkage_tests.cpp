@@ -76,7 +76,8 @@ non_ss_lod_ratio_test::calculate_relaxed_theta(size_t trait_index, size_t marker
   mle_sub_model  relaxed_mle(false, false);
   relaxed_mle.set_relaxed_limits();
   relaxed_mle.set_average_theta(1 - result.restricted_alt_theta);
-  mped_calculator  relaxed_mp_calc(my_mped, relaxed_mle, trait_index, marker_index);
+  mped_calculator  relaxed_mp_calc(my_mped, relaxed_mle, trait_index, marker_index, my_models,
+                                   polynomials(trait_index, marker_index));
   
   double  relaxed_ln_like = relaxed_mp_calc.likelihood().get_log();
   
@@ -118,7 +119,8 @@ non_ss_lod_ratio_test::calculate_null(size_t trait_index, size_t marker_index, n
 {
   mle_sub_model  null_mle(false, false);
   null_mle.set_average_theta(NULL_THETA);
-  mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index);
+  mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index, my_models,
+                                polynomials(trait_index, marker_index));
   
   result.null_ln_like = null_mp_calc.likelihood().get_log();
 }
@@ -273,7 +275,8 @@ ss_lod_ratio_test::calculate_relaxed_theta_compl(size_t trait_index, size_t mark
 {
   mle_sub_model  relaxed_mle(true, false);
   relaxed_mle.set_relaxed_limits();
-  mped_calculator  relaxed_mp_calc(my_mped, relaxed_mle, trait_index, marker_index);
+  mped_calculator  relaxed_mp_calc(my_mped, relaxed_mle, trait_index, marker_index, my_models,
+                                   polynomials(trait_index, marker_index));
 
   double  max_ln_like = result.alt_ln_like;
   double  max_male_theta = result.restricted_alt_thetas.male_theta;
@@ -380,7 +383,8 @@ ss_lod_ratio_test::calculate_null(size_t trait_index, size_t marker_index, ss_lo
   mle_sub_model  null_mle(true, false);
   null_mle.set_male_theta(NULL_THETA);
   null_mle.set_female_theta(NULL_THETA);
-  mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index);
+  mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index, my_models,
+                                polynomials(trait_index, marker_index));
   
   result.null_ln_like = null_mp_calc.likelihood().get_log();
 }
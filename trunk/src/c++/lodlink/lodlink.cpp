@@ -179,9 +179,6 @@ int lodlink::main()
     my_analysis.build();
     my_analysis.analyze();
     my_analysis.write(summary_file, detail_file, *this);
-    analysis::clear();    
-    
-    ge_models::clear_models();
   }
 
   if(! analysis_specified)
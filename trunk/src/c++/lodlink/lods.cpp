@@ -37,6 +37,11 @@ non_ss_lods::calculate()
 void
 non_ss_lods::calculate_alt(size_t trait_index, size_t marker_index, non_ss_lods_result& result)
 {
+  // - Each subpedigree is peeled once; the likelihood at each recombination
+  //   fraction is then a polynomial evaluation.
+  //
+  polynomial_calculator&  polys = *polynomials(trait_index, marker_index);
+  
   mle_sub_model  mle(false, false);
   for(size_t i = 0; i < my_instructions.average_thetas.size(); ++i)
   {
@@ -56,10 +61,8 @@ non_ss_lods::calculate_alt(size_t trait_index, size_t marker_index, non_ss_lods_
       subpedigree_const_iterator  subped_iter = ped_iter->subpedigree_begin();
       for(; subped_iter != ped_iter->subpedigree_end(); ++subped_iter)
       {
-        peeler  p(*subped_iter, mle, trait_index, marker_index);
-        subped_calculator  sp_calc(p);
-        double  alt_ln_like  = sp_calc.likelihood().get_log();  
-        double  null_ln_like = sp_calc.unlinked_likelihood().get_log(); 
+        double  alt_ln_like  = polys.likelihood(*subped_iter, mle).get_log();  
+        double  null_ln_like = polys.unlinked_likelihood(*subped_iter).get_log(); 
         double  subped_ls(lod_score(alt_ln_like, null_ln_like)); 
         
         string  member_name = subped_iter->member_begin()->name();
@@ -212,6 +215,11 @@ ss_lods::calculate()
 void
 ss_lods::calculate_alt(size_t trait_index, size_t marker_index, ss_lods_result& result)
 {
+  // - Each subpedigree is peeled once; the likelihood at each recombination
+  //   fraction is then a polynomial evaluation.
+  //
+  polynomial_calculator&  polys = *polynomials(trait_index, marker_index);
+  
   mle_sub_model  mle(true, false);
   for(size_t i = 0; i < my_instructions.male_female_thetas.size(); ++i)
   {
@@ -234,10 +242,8 @@ ss_lods::calculate_alt(size_t trait_index, size_t marker_index, ss_lods_result&
       subpedigree_const_iterator  subped_iter = ped_iter->subpedigree_begin();
       for(; subped_iter != ped_iter->subpedigree_end(); ++subped_iter)
       {
-        peeler  p(*subped_iter, mle, trait_index, marker_index);
-        subped_calculator  sp_calc(p);
-        double  alt_ln_like  = sp_calc.likelihood().get_log();
-        double  null_ln_like = sp_calc.unlinked_likelihood().get_log();
+        double  alt_ln_like  = polys.likelihood(*subped_iter, mle).get_log();
+        double  null_ln_like = polys.unlinked_likelihood(*subped_iter).get_log();
         double  subped_ls(lod_score(alt_ln_like, null_ln_like));
         
         string  member_name = subped_iter->member_begin()->name();
@@ -24,14 +24,14 @@ namespace LODLINK
 //============================================================================
 //
 peeler::peeler(const subped_type& subped, const mle_sub_model& mle,
-               size_t trait, size_t marker)
+               size_t trait, size_t marker, ge_models& models)
       : peeling::peeler<joint_pen_iter, log_double>(subped), my_tcalc(mle),
-        my_trait(trait), my_marker(marker)
+        my_trait(trait), my_marker(marker), my_models(models)
 {
   typedef FPED::FilteredMultipedigree::member_const_iterator  member_const_iterator;
 
-  const MLOCUS::penetrance_model&  tpm = ge_models::get_model(subped, trait);
-  const MLOCUS::penetrance_model&  mpm = ge_models::get_model(subped, marker);
+  const MLOCUS::penetrance_model&  tpm = my_models.get_model(subped, trait);
+  const MLOCUS::penetrance_model&  mpm = my_models.get_model(subped, marker);
   
   member_const_iterator  ind_iter;
   for(ind_iter = my_subpedigree.member_begin(); 
@@ -66,8 +66,8 @@ peeler::internal_anterior(const member_type& ind,
   
   joint_genotype  ind_genotype(jpi);
  
-  phenoset  mothers_phenoset(my_subpedigree, my_trait, my_marker, *mother);
-  phenoset  fathers_phenoset(my_subpedigree, my_trait, my_marker, *father);
+  phenoset  mothers_phenoset(my_subpedigree, my_trait, my_marker, *mother, my_models);
+  phenoset  fathers_phenoset(my_subpedigree, my_trait, my_marker, *father, my_models);
   
   log_double  mother_sum(0);
   phenoset_iterator  m_iter = mothers_phenoset.begin();
@@ -145,7 +145,7 @@ peeler::internal_posterior_with_mate(const member_type& ind, const member_type&
 #endif
 
   joint_genotype  ind_genotype(jpi);
-  phenoset  mates_phenoset(my_subpedigree, my_trait, my_marker, mate);
+  phenoset  mates_phenoset(my_subpedigree, my_trait, my_marker, mate, my_models);
   
   log_double  mate_sum(0);
   phenoset_iterator  m_iter = mates_phenoset.begin();
@@ -0,0 +1,270 @@
+//============================================================================
+// File:      poly_peeler.cpp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     Lodlink polynomial peeler implementation.  Follows peeler.cpp
+//            equation for equation.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+#include "lodlink/poly_peeler.h"
+
+namespace SAGE
+{
+
+namespace LODLINK
+{
+
+// - Above this many nonfounders in a subpedigree, polynomial products cost
+//   more than peeling once per recombination fraction, and the subpedigree
+//   is peeled by peeler instead.
+//
+static const size_t  MAX_POLYNOMIAL_NONFOUNDERS = 24;
+
+//============================================================================
+// IMPLEMENTATION:  poly_peeler
+//============================================================================
+//
+poly_peeler::poly_peeler(const subped_type& subped, size_t trait, size_t marker,
+                         ge_models& models)
+      : peeling::peeler<joint_pen_iter, theta_polynomial>(subped),
+        my_trait(trait), my_marker(marker), my_models(models)
+{
+  typedef FPED::FilteredMultipedigree::member_const_iterator  member_const_iterator;
+
+  const MLOCUS::penetrance_model&  tpm = my_models.get_model(subped, trait);
+  const MLOCUS::penetrance_model&  mpm = my_models.get_model(subped, marker);
+
+  member_const_iterator  ind_iter;
+  for(ind_iter = my_subpedigree.member_begin();
+      ind_iter != my_subpedigree.member_end(); ++ind_iter)
+  {
+    size_t  ph_id = ind_iter->subindex() + 1;
+    assert(ph_id != MLOCUS::NPOS);
+
+    my_cache.get_individual_cache(*ind_iter).build(*ind_iter, ph_id, ph_id, tpm, mpm);
+  }
+}
+
+bool
+poly_peeler::use_polynomial(const subped_type& subped)
+{
+  size_t  nonfounders = 0;
+
+  FPED::FilteredMultipedigree::member_const_iterator  ind_iter;
+  for(ind_iter = subped.member_begin(); ind_iter != subped.member_end(); ++ind_iter)
+  {
+    if(ind_iter->parent_begin() != ind_iter->parent_end())
+    {
+      ++nonfounders;
+    }
+  }
+
+  return  nonfounders <= MAX_POLYNOMIAL_NONFOUNDERS;
+}
+
+// - Subpedigree likelihood.  See subped_calculator::likelihood().
+//
+theta_polynomial
+poly_peeler::likelihood()
+{
+  FPED::FilteredMultipedigree::member_const_iterator  m_iter = my_subpedigree.member_begin();
+
+  theta_polynomial  like(0.0);
+
+  phenoset  ph_set(my_subpedigree, my_trait, my_marker, *m_iter, my_models);
+  phenoset::phenoset_iterator  ph_iter = ph_set.begin();
+  for(; ph_iter != ph_set.end(); ++ph_iter)
+  {
+    theta_polynomial  like_term = anterior(*m_iter, *ph_iter);
+    like_term *= (*ph_iter).penetrance();
+    like_term *= posterior(*m_iter, *ph_iter);
+
+    like += like_term;
+  }
+
+  return like;
+}
+
+// - Equation (3).  Fernando, Stricker, Elston.  1993.
+//
+const theta_polynomial&
+poly_peeler::internal_anterior(const member_type& ind,
+                               const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  member_const_pointer  mother = ind.get_mother();
+  member_const_pointer  father = ind.get_father();
+
+  assert(mother && father);
+
+  joint_genotype  ind_genotype(jpi);
+
+  phenoset  mothers_phenoset(my_subpedigree, my_trait, my_marker, *mother, my_models);
+  phenoset  fathers_phenoset(my_subpedigree, my_trait, my_marker, *father, my_models);
+
+  theta_polynomial  mother_sum(0.0);
+  phenoset_iterator  m_iter = mothers_phenoset.begin();
+  for(; m_iter != mothers_phenoset.end(); ++m_iter)
+  {
+    theta_polynomial  father_sum(0.0);
+    phenoset_iterator  f_iter = fathers_phenoset.begin();
+    for(; f_iter != fathers_phenoset.end(); ++f_iter)
+    {
+      theta_polynomial  father_term = trans_calculator::transition_polynomial(*m_iter, *f_iter, ind_genotype);
+      if(father_term.is_zero())
+      {
+        continue;
+      }
+
+      father_term *= anterior(*father, *f_iter);
+      father_term *= (*f_iter).penetrance();
+      father_term *= posterior_except_mate(*father, *mother, *f_iter);
+      father_term *= likelihood_of_sibs(*m_iter, *f_iter, ind);
+
+      father_sum += father_term;
+    }
+
+    if(father_sum.is_zero())
+    {
+      continue;
+    }
+
+    theta_polynomial  mother_term = anterior(*mother, *m_iter);
+    mother_term *= (*m_iter).penetrance();
+    mother_term *= posterior_except_mate(*mother, *father, *m_iter);
+    mother_term *= father_sum;
+
+    mother_sum += mother_term;
+  }
+
+  return result = mother_sum;
+}
+
+const theta_polynomial&
+poly_peeler::internal_posterior(const member_type& ind,
+                                const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  theta_polynomial  r(1.0);
+  mate_const_iterator  iter;
+  for(iter = ind.mate_begin(); iter != ind.mate_end(); ++iter)
+  {
+    r *= posterior_with_mate(ind, iter->mate(), jpi);
+  }
+
+  return result = r;
+}
+
+// - Equation (4).  Fernando, Stricker, Elston.  1993.
+//
+const theta_polynomial&
+poly_peeler::internal_posterior_with_mate(const member_type& ind, const member_type& mate,
+                                          const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  joint_genotype  ind_genotype(jpi);
+  phenoset  mates_phenoset(my_subpedigree, my_trait, my_marker, mate, my_models);
+
+  theta_polynomial  mate_sum(0.0);
+  phenoset_iterator  m_iter = mates_phenoset.begin();
+  for(; m_iter != mates_phenoset.end(); ++m_iter)
+  {
+    theta_polynomial  mate_term = anterior(mate, *m_iter);
+    mate_term *= (*m_iter).penetrance();
+    mate_term *= posterior_except_mate(mate, ind, *m_iter);
+    mate_term *= likelihood_of_offspring(ind_genotype, *m_iter, ind, mate);
+
+    mate_sum += mate_term;
+  }
+
+  return result = mate_sum;
+}
+
+const theta_polynomial&
+poly_peeler::internal_posterior_except_mate(const member_type& ind, const member_type& mate,
+                                            const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  theta_polynomial  r(1.0);
+  mate_const_iterator  iter;
+  for(iter = ind.mate_begin(); iter != ind.mate_end(); ++iter)
+  {
+    if(iter->mate().index() != mate.index())
+    {
+      r *= posterior_with_mate(ind, iter->mate(), jpi);
+    }
+  }
+
+  return result = r;
+}
+
+// - Posterior likelihood of a pedigree 'leaf'.
+//
+const theta_polynomial&
+poly_peeler::internal_posterior_terminal(const member_type& ind,
+                                         const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  return result = theta_polynomial(1.0);
+}
+
+// - Anterior likelihood of a founder.
+//
+const theta_polynomial&
+poly_peeler::internal_anterior_terminal(const member_type& ind,
+                                        const joint_pen_iter& jpi, theta_polynomial& result)
+{
+  return result = theta_polynomial(joint_genotype(jpi).frequency());
+}
+
+
+//
+// ----------------------------  ancillary functions  -------------------------
+//
+
+// - Likelihood of offspring of a given individual w. a particular mate.
+//   Line 2 of equation (4) of Fernando, Stricker, Elston.  1993.
+//
+theta_polynomial
+poly_peeler::likelihood_of_offspring(const joint_genotype& ind_jg, const joint_genotype& mate_jg,
+                                     const member_type& ind, const member_type& mate)
+{
+  theta_polynomial  r(1.0);
+
+  offspring_const_iterator  iter;
+  for(iter = ind.offspring_begin(mate); iter != ind.offspring_end(); ++iter)
+  {
+    assert(! ind.is_sex_unknown());
+
+    if(ind.is_male())
+    {
+      r *= sum_ind_and_posterior(mate_jg, ind_jg, *iter);
+    }
+    else
+    {
+      r *= sum_ind_and_posterior(ind_jg, mate_jg, *iter);
+    }
+  }
+
+  return r;
+}
+
+// - Likelihood of sibs of given individual.  Line 4 of equation (3) of Fernando, Stricker,
+//   Elston.  1993.
+//
+theta_polynomial
+poly_peeler::likelihood_of_sibs(const joint_genotype& mjg, const joint_genotype& fjg,
+                                const member_type& ind)
+{
+  theta_polynomial  r(1.0);
+
+  sibling_const_iterator  iter;
+  for(iter = ind.sibling_begin(); iter != ind.sibling_end(); ++iter)
+  {
+    r *= sum_ind_and_posterior(mjg, fjg, *iter);
+  }
+
+  return r;
+}
+
+}
+}
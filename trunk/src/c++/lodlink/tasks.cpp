@@ -30,7 +30,8 @@ namespace LODLINK
 MAXFUN::Results
 task::maximize(mle_sub_model& mle, size_t trait_index, size_t marker_index) const
 {
-  mped_calculator  mp_calc(my_mped, mle, trait_index, marker_index);
+  mped_calculator  mp_calc(my_mped, mle, trait_index, marker_index, my_models,
+                           polynomials(trait_index, marker_index));
   MAXFUN::ParameterMgr  param_mgr;
   MAXFUN::DebugCfg      debug_cfg;
   MAXFUN::SequenceCfg   sequence_cfg;
@@ -49,7 +50,8 @@ task::maximize(mle_sub_model& mle, size_t trait_index, size_t marker_index) cons
 MAXFUN::Results
 task::maximize(const group& g, mle_sub_model& mle, size_t trait_index, size_t marker_index)
 {
-  group_calculator      group_calc(g, my_mped, mle, trait_index, marker_index);
+  group_calculator      group_calc(g, my_mped, mle, trait_index, marker_index, my_models,
+                                   polynomials(trait_index, marker_index));
   MAXFUN::ParameterMgr  param_mgr;
   MAXFUN::DebugCfg      debug_cfg;
   MAXFUN::SequenceCfg   sequence_cfg;
@@ -68,7 +70,8 @@ task::maximize(const group& g, mle_sub_model& mle, size_t trait_index, size_t ma
 bool
 task::likelihood_finite(mle_sub_model& mle, size_t trait, size_t marker, const string& test)
 {
-  mped_calculator  mp_calc(my_mped, mle, trait, marker);
+  mped_calculator  mp_calc(my_mped, mle, trait, marker, my_models,
+                           polynomials(trait, marker));
   
   if(finite(mp_calc.likelihood().get_log()))
   {
@@ -91,7 +94,8 @@ bool
 task::likelihood_finite(const string& group_name, const group& g, mle_sub_model& mle, 
                         size_t trait, size_t marker, const string& test)
 {
-  group_calculator  group_calc(g, my_mped, mle, trait, marker);
+  group_calculator  group_calc(g, my_mped, mle, trait, marker, my_models,
+                               polynomials(trait, marker));
   
   if(finite(group_calc.likelihood().get_log()))
   {
@@ -122,18 +126,6 @@ task::marker_name(size_t marker_index)
 // IMPLEMENTATION:  non_ss_smiths_faraways_test
 //============================================================================
 //
-bool  non_ss_smiths_faraways_test::alt_calculated = false;
-vector<non_ss_alt_result_ptr>  non_ss_smiths_faraways_test::alt_results;
-
-// - Clear static members.
-//
-void
-non_ss_smiths_faraways_test::clear()
-{
-  alt_calculated = false;
-  alt_results.clear();
-}
-
 void
 non_ss_smiths_faraways_test::calculate()
 {
@@ -173,7 +165,7 @@ non_ss_smiths_faraways_test::calculate()
       my_results.push_back(result_ptr(result)); 
     }
 
-    alt_calculated = true;    
+    my_alt.non_ss_calculated = true;    
     completed = true;
   }
 }
@@ -186,7 +178,7 @@ void
 non_ss_smiths_faraways_test::calculate_alt(size_t trait_index, size_t marker_index, 
                                               non_ss_smiths_faraways_result& result)
 {
-  if(! alt_calculated)    // Keep a static copy of results.
+  if(! my_alt.non_ss_calculated)    // Keep a copy of results for the analysis.
   {
     non_ss_alt_result*  alt_result = new non_ss_alt_result;
     alt_result->marker = result.marker;
@@ -217,13 +209,13 @@ non_ss_smiths_faraways_test::calculate_alt(size_t trait_index, size_t marker_ind
     result.alt_theta_ub = alt_mle.average_theta_ub();
     alt_result->alt_theta_ub = result.alt_theta_ub;
     
-    alt_results.push_back(non_ss_alt_result_ptr(alt_result));
+    my_alt.non_ss.push_back(non_ss_alt_result_ptr(alt_result));
   }
-  else   // Get results from static copy.
+  else   // Get results from the analysis' copy.
   {
-    vector<non_ss_alt_result_ptr>::const_iterator  r_iter = find_if(alt_results.begin(), alt_results.end(), 
+    vector<non_ss_alt_result_ptr>::const_iterator  r_iter = find_if(my_alt.non_ss.begin(), my_alt.non_ss.end(), 
                                                             bind2nd(has_marker<non_ss_alt_result_ptr>(), result.marker));
-    assert(r_iter != alt_results.end());
+    assert(r_iter != my_alt.non_ss.end());
     
     result.alt_ln_like = (*r_iter)->alt_ln_like;
     result.alt_theta = (*r_iter)->alt_theta;
@@ -245,7 +237,8 @@ non_ss_smiths_faraways_test::calculate_null(size_t trait_index, size_t marker_in
   if(my_type == sf_LINKAGE)
   {
     null_mle.set_average_theta(NULL_THETA);
-    mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index);
+    mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index, my_models,
+                                  polynomials(trait_index, marker_index));
   
     result.null_ln_like = null_mp_calc.likelihood().get_log();
   }
@@ -284,6 +277,8 @@ non_ss_smiths_faraways_test::calculate_posteriors(size_t trait_index, size_t mar
     return;
   }
   
+  polynomial_calculator&  polys = *polynomials(trait_index, marker_index);
+
   mle_sub_model  mle(false, false);
   mle.set_average_theta(result.alt_theta);
 
@@ -298,10 +293,8 @@ non_ss_smiths_faraways_test::calculate_posteriors(size_t trait_index, size_t mar
     subpedigree_const_iterator  subped_iter = ped_iter->subpedigree_begin();
     for(; subped_iter != ped_iter->subpedigree_end(); ++subped_iter)
     {
-      peeler  p(*subped_iter, mle, trait_index, marker_index);
-      subped_calculator  sp_calc(p);
-      double  alt_ln_like  = sp_calc.likelihood().get_log();
-      double  null_ln_like = sp_calc.unlinked_likelihood().get_log();
+      double  alt_ln_like  = polys.likelihood(*subped_iter, mle).get_log();
+      double  null_ln_like = polys.unlinked_likelihood(*subped_iter).get_log();
       
       double  term1 = result.alpha * exp(alt_ln_like);
       double  term2 = (1 - result.alpha) * exp(null_ln_like);
@@ -426,18 +419,6 @@ non_ss_smiths_faraways_test::write_vc_matrix(ostream& out) const
 // IMPLEMENTATION:  ss_smiths_faraways_test
 //============================================================================
 //
-bool  ss_smiths_faraways_test::alt_calculated = false;
-vector<ss_alt_result_ptr>  ss_smiths_faraways_test::alt_results;
-
-// - Clear static members.
-//
-void
-ss_smiths_faraways_test::clear()
-{
-  alt_calculated = false;
-  alt_results.clear();
-}
-
 void
 ss_smiths_faraways_test::calculate()
 {
@@ -477,7 +458,7 @@ ss_smiths_faraways_test::calculate()
       my_results.push_back(result_ptr(result)); 
     }
     
-    alt_calculated = true;
+    my_alt.ss_calculated = true;
     completed = true;
   }
 }
@@ -490,7 +471,7 @@ void
 ss_smiths_faraways_test::calculate_alt(size_t trait_index, size_t marker_index, 
                                               ss_smiths_faraways_result& result)
 {
-  if(! alt_calculated)    // Keep a static copy of results.
+  if(! my_alt.ss_calculated)    // Keep a copy of results for the analysis.
   {
     ss_alt_result*  alt_result = new ss_alt_result;
     alt_result->marker = result.marker;  
@@ -525,13 +506,13 @@ ss_smiths_faraways_test::calculate_alt(size_t trait_index, size_t marker_index,
     result.alt_theta_ubs.female_theta = alt_mle.female_theta_ub();  
     alt_result->alt_theta_ubs.female_theta = result.alt_theta_ubs.female_theta;
       
-    alt_results.push_back(ss_alt_result_ptr(alt_result));
+    my_alt.ss.push_back(ss_alt_result_ptr(alt_result));
   }
-  else    // Get results from static copy.
+  else    // Get results from the analysis' copy.
   {
-    vector<ss_alt_result_ptr>::const_iterator  r_iter = find_if(alt_results.begin(), alt_results.end(), 
+    vector<ss_alt_result_ptr>::const_iterator  r_iter = find_if(my_alt.ss.begin(), my_alt.ss.end(), 
                                                                bind2nd(has_marker<ss_alt_result_ptr>(), result.marker));
-    assert(r_iter != alt_results.end());
+    assert(r_iter != my_alt.ss.end());
     
     result.alt_ln_like = (*r_iter)->alt_ln_like;
     result.alt_thetas.male_theta = (*r_iter)->alt_thetas.male_theta;
@@ -556,7 +537,8 @@ ss_smiths_faraways_test::calculate_null(size_t trait_index, size_t marker_index,
   {
     null_mle.set_male_theta(NULL_THETA);
     null_mle.set_female_theta(NULL_THETA);
-    mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index);
+    mped_calculator  null_mp_calc(my_mped, null_mle, trait_index, marker_index, my_models,
+                                  polynomials(trait_index, marker_index));
   
     result.null_ln_like = null_mp_calc.likelihood().get_log();
   }
@@ -599,6 +581,8 @@ ss_smiths_faraways_test::calculate_posteriors(size_t trait_index, size_t marker_
     return;
   }
 
+  polynomial_calculator&  polys = *polynomials(trait_index, marker_index);
+
   mle_sub_model  mle(true, false);
   mle.set_male_theta(result.alt_thetas.male_theta);
   mle.set_female_theta(result.alt_thetas.female_theta);  
@@ -614,10 +598,8 @@ ss_smiths_faraways_test::calculate_posteriors(size_t trait_index, size_t marker_
     subpedigree_const_iterator  subped_iter = ped_iter->subpedigree_begin();
     for(; subped_iter != ped_iter->subpedigree_end(); ++subped_iter)
     {
-      peeler  p(*subped_iter, mle, trait_index, marker_index);
-      subped_calculator  sp_calc(p);
-      double  alt_ln_like  = sp_calc.likelihood().get_log();
-      double  null_ln_like = sp_calc.unlinked_likelihood().get_log();
+      double  alt_ln_like  = polys.likelihood(*subped_iter, mle).get_log();
+      double  null_ln_like = polys.unlinked_likelihood(*subped_iter).get_log();
       
       double  term1 = result.alpha * exp(alt_ln_like);
       double  term2 = (1 - result.alpha) * exp(null_ln_like);
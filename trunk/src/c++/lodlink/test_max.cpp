@@ -210,7 +210,9 @@ int main(int argc, char* argv[])
   mle_sub_model  unlinked_mle;
   unlinked_mle.set_average_theta(.5);
   
-  mped_calculator  mp_calc(fp, mle, trait, marker);
+  ge_models  models;
+  
+  mped_calculator  mp_calc(fp, mle, trait, marker, models);
   MAXFUN::ParameterMgr    param_mgr;
   MAXFUN::DebugCfg        debug_cfg;
   MAXFUN::SequenceCfg     sequence_cfg;
@@ -228,7 +230,7 @@ int main(int argc, char* argv[])
   
   double  result = data.getFinalFunctionValue();   // Natural log of likelihood
   
-  mped_calculator  unlinked_mp_calc(fp, unlinked_mle, trait, marker);
+  mped_calculator  unlinked_mp_calc(fp, unlinked_mle, trait, marker, models);
   log_double  unlinked_like = unlinked_mp_calc.likelihood();  // Likelihood.
   
           
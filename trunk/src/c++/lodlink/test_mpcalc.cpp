@@ -238,7 +238,9 @@ int main(int argc, char* argv[])
     mle.set_alpha(alpha);
   }
   
-  mped_calculator  mp_calc(fp, mle, trait, marker);
+  ge_models  models;
+  
+  mped_calculator  mp_calc(fp, mle, trait, marker, models);
           
   log_double  like = mp_calc.likelihood();
   log_double  unlinked_like = mp_calc.unlinked_likelihood();
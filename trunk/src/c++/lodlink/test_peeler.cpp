@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <functional>
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <cassert>
@@ -27,6 +28,7 @@
 #include "mlocus/mfile.h"
 #include "mlocus/imodel.h"
 #include "lodlink/peeler.h"
+#include "lodlink/poly_peeler.h"
 
 
 using namespace std;
@@ -43,7 +45,7 @@ likelihood(peeler& inst,
 {
   log_double  like(0);
           
-  phenoset  ph_set(*subped_iter, trait, marker, *m_iter);
+  phenoset  ph_set(*subped_iter, trait, marker, *m_iter, inst.models());
   
   phenoset::phenoset_iterator  ph_iter = ph_set.begin();
   for(; ph_iter != ph_set.end(); ++ph_iter)
@@ -67,7 +69,7 @@ print_diagnostic_info(ostream& out, peeler& inst,
 {
   out << "\n\n";
 
-  phenoset  ph_set(*subped_iter, trait, marker, *m_iter);
+  phenoset  ph_set(*subped_iter, trait, marker, *m_iter, inst.models());
   
   phenoset::phenoset_iterator  ph_iter = ph_set.begin();
   for(; ph_iter != ph_set.end(); ++ph_iter)
@@ -271,6 +273,8 @@ int main(int argc, char* argv[])
   mle_sub_model  unlinked_mle;
   unlinked_mle.set_average_theta(.5);
   
+  ge_models  models;
+  
   pedigree_const_iterator  ped_iter = fp.pedigree_begin();
   for(; ped_iter != fp.pedigree_end(); ++ped_iter)
   {
@@ -278,8 +282,8 @@ int main(int argc, char* argv[])
     {
       for(; subped_iter != ped_iter->subpedigree_end(); ++subped_iter)
       {
-        peeler  inst(*subped_iter, mle, trait, marker);
-        peeler  unlinked_inst(*subped_iter, unlinked_mle, trait, marker);
+        peeler  inst(*subped_iter, mle, trait, marker, models);
+        peeler  unlinked_inst(*subped_iter, unlinked_mle, trait, marker, models);
         
         // - This is a consistancy check.  The likelihood should be the same
         //   regardless of which is the pivotal member in the calculation.
@@ -305,6 +309,26 @@ int main(int argc, char* argv[])
                    << "lod score  " << log10(like.get_double()) - log10(unlinked_like.get_double()) 
                    << endl;
         }
+        
+        // - The polynomial peeler must agree w. the peeler.  Nothing is written
+        //   unless it does not.
+        //
+        if(poly_peeler::use_polynomial(*subped_iter))
+        {
+          poly_peeler  poly_inst(*subped_iter, trait, marker, models);
+          theta_polynomial  poly_like = poly_inst.likelihood();
+          
+          double  ln_like      = likelihood(inst, subped_iter, trait, marker, subped_iter->member_begin()).get_log();
+          double  poly_ln_like = poly_like.evaluate(male_theta, female_theta).get_log();
+          
+          if(ln_like != poly_ln_like && ! (fabs(ln_like - poly_ln_like) <= 1e-8 * max(1.0, fabs(ln_like))))
+          {
+            out_file << "pedigree " << ped_iter->name() << ", "
+                     << "subpedigree " << subped_iter->name() << ", "
+                     << "polynomial log likelihood " << poly_ln_like / log(10.0)
+                     << " differs from " << ln_like / log(10.0) << endl;
+          }
+        }
       }
     }
   }
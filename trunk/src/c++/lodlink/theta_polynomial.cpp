@@ -0,0 +1,276 @@
+//============================================================================
+// File:      theta_polynomial.cpp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     implementation of theta_polynomial class.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+#include <algorithm>
+#include "lodlink/theta_polynomial.h"
+
+using namespace std;
+
+namespace SAGE
+{
+
+namespace LODLINK
+{
+
+//============================================================================
+// IMPLEMENTATION:  theta_polynomial
+//============================================================================
+//
+theta_polynomial
+theta_polynomial::transmission(double non_recomb, double recomb, bool male)
+{
+  theta_polynomial  t(1.0);
+
+  if(male)
+  {
+    t.my_male_degree = 1;
+  }
+  else
+  {
+    t.my_female_degree = 1;
+  }
+
+  t.my_coefficients.resize(2);
+  t.my_coefficients[0] = non_recomb;
+  t.my_coefficients[1] = recomb;
+  t.normalize();
+
+  return t;
+}
+
+// - Sum over the product basis.  Likelihoods can be far outside the range of
+//   a double, so the scale is applied on the log scale.
+//
+log_double
+theta_polynomial::evaluate(double male_theta, double female_theta) const
+{
+  assert(is_set());
+
+  if(is_zero())
+  {
+    return log_double(0.0);
+  }
+
+  vector<double>  male_basis(my_male_degree + 1);
+  for(size_t j = 0; j <= my_male_degree; ++j)
+  {
+    male_basis[j] = pow(male_theta, (double)j) * pow(1 - male_theta, (double)(my_male_degree - j));
+  }
+
+  vector<double>  female_basis(my_female_degree + 1);
+  for(size_t k = 0; k <= my_female_degree; ++k)
+  {
+    female_basis[k] = pow(female_theta, (double)k) * pow(1 - female_theta, (double)(my_female_degree - k));
+  }
+
+  double  sum = 0;
+  for(size_t j = 0; j <= my_male_degree; ++j)
+  {
+    double  female_sum = 0;
+    for(size_t k = 0; k <= my_female_degree; ++k)
+    {
+      female_sum += coefficient(j, k) * female_basis[k];
+    }
+
+    sum += male_basis[j] * female_sum;
+  }
+
+  // - log_double has no constructor from a logarithm.  Raising 2 to the
+  //   appropriate power stays on the log scale.
+  //
+  log_double  scale(2.0);
+  scale.pow(my_log_scale / M_LN2);
+
+  return log_double(sum) * scale;
+}
+
+theta_polynomial&
+theta_polynomial::operator+=(const theta_polynomial& other)
+{
+  assert(is_set() && other.is_set());
+
+  if(other.is_zero())
+  {
+    return *this;
+  }
+
+  if(is_zero())
+  {
+    return *this = other;
+  }
+
+  size_t  male_deg   = max(my_male_degree, other.my_male_degree);
+  size_t  female_deg = max(my_female_degree, other.my_female_degree);
+
+  elevate(male_deg, female_deg);
+
+  const theta_polynomial*  addend = &other;
+  theta_polynomial  elevated_other;
+  if(other.my_male_degree != male_deg || other.my_female_degree != female_deg)
+  {
+    elevated_other = other;
+    elevated_other.elevate(male_deg, female_deg);
+    addend = &elevated_other;
+  }
+
+  // - Add on the scale of the larger term.
+  //
+  double  diff = addend->my_log_scale - my_log_scale;
+  if(diff <= 0)
+  {
+    double  ratio = exp(diff);
+    for(size_t i = 0; i < my_coefficients.size(); ++i)
+    {
+      my_coefficients[i] += ratio * addend->my_coefficients[i];
+    }
+  }
+  else
+  {
+    double  ratio = exp(-diff);
+    for(size_t i = 0; i < my_coefficients.size(); ++i)
+    {
+      my_coefficients[i] = ratio * my_coefficients[i] + addend->my_coefficients[i];
+    }
+
+    my_log_scale = addend->my_log_scale;
+  }
+
+  normalize();
+
+  return *this;
+}
+
+theta_polynomial&
+theta_polynomial::operator*=(const theta_polynomial& other)
+{
+  assert(is_set() && other.is_set());
+
+  if(is_zero() || other.is_zero())
+  {
+    set_zero();
+    return *this;
+  }
+
+  size_t  male_deg   = my_male_degree + other.my_male_degree;
+  size_t  female_deg = my_female_degree + other.my_female_degree;
+
+  vector<double>  product((male_deg + 1) * (female_deg + 1), 0.0);
+  for(size_t j1 = 0; j1 <= my_male_degree; ++j1)
+  {
+    for(size_t k1 = 0; k1 <= my_female_degree; ++k1)
+    {
+      double  c = coefficient(j1, k1);
+      if(c == 0)
+      {
+        continue;
+      }
+
+      for(size_t j2 = 0; j2 <= other.my_male_degree; ++j2)
+      {
+        double*  row = &product[(j1 + j2) * (female_deg + 1) + k1];
+        for(size_t k2 = 0; k2 <= other.my_female_degree; ++k2)
+        {
+          row[k2] += c * other.coefficient(j2, k2);
+        }
+      }
+    }
+  }
+
+  my_male_degree   = male_deg;
+  my_female_degree = female_deg;
+  my_coefficients.swap(product);
+  my_log_scale += other.my_log_scale;
+
+  normalize();
+
+  return *this;
+}
+
+// - Raise the degrees by multiplying by (t + (1 - t)) as many times as needed
+//   for each sex.  The coefficients stay non-negative.
+//
+void
+theta_polynomial::elevate(size_t male_degree, size_t female_degree)
+{
+  assert(male_degree >= my_male_degree && female_degree >= my_female_degree);
+
+  while(my_male_degree < male_degree)
+  {
+    size_t  cols = my_female_degree + 1;
+    vector<double>  e((my_male_degree + 2) * cols, 0.0);
+    for(size_t j = 0; j <= my_male_degree; ++j)
+    {
+      for(size_t k = 0; k < cols; ++k)
+      {
+        e[j * cols + k]       += my_coefficients[j * cols + k];
+        e[(j + 1) * cols + k] += my_coefficients[j * cols + k];
+      }
+    }
+
+    my_coefficients.swap(e);
+    ++my_male_degree;
+  }
+
+  while(my_female_degree < female_degree)
+  {
+    size_t  cols = my_female_degree + 1;
+    vector<double>  e((my_male_degree + 1) * (cols + 1), 0.0);
+    for(size_t j = 0; j <= my_male_degree; ++j)
+    {
+      for(size_t k = 0; k < cols; ++k)
+      {
+        e[j * (cols + 1) + k]     += my_coefficients[j * cols + k];
+        e[j * (cols + 1) + k + 1] += my_coefficients[j * cols + k];
+      }
+    }
+
+    my_coefficients.swap(e);
+    ++my_female_degree;
+  }
+
+  normalize();
+}
+
+void
+theta_polynomial::normalize()
+{
+  if(is_zero())
+  {
+    set_zero();
+    return;
+  }
+
+  double  largest = *max_element(my_coefficients.begin(), my_coefficients.end());
+  if(largest == 0)
+  {
+    set_zero();
+    return;
+  }
+
+  for(size_t i = 0; i < my_coefficients.size(); ++i)
+  {
+    my_coefficients[i] /= largest;
+  }
+
+  my_log_scale += log(largest);
+}
+
+void
+theta_polynomial::set_zero()
+{
+  my_male_degree   = 0;
+  my_female_degree = 0;
+  my_coefficients.assign(1, 0.0);
+  my_log_scale = -numeric_limits<double>::infinity();
+}
+
+}
+}
@@ -0,0 +1,188 @@
+//==========================================================================
+//  File:    bench_wht.cpp
+//
+//  Purpose: Micro-benchmark of the Walsh-Hadamard recombination transform.
+//           Compares each available kernel against the original two pass
+//           butterfly implementation of Likelihood_Vector::operator()(fft,
+//           theta) for bit counts 8 through 24 (or the range given on the
+//           command line) and checks that the results agree within 1e-12.
+//
+//  Usage:   bench_wht [min_bits [max_bits]]
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "lvec/walsh_hadamard.h"
+
+using namespace std;
+using namespace SAGE;
+
+// The recombination transform, as it was done before walsh_hadamard.h.
+void reference_transform(vector<double>& storage, const vector<int>& f,
+                         const vector<double>& t)
+{
+  size_t s = storage.size();
+
+  double temp;
+
+  for(size_t i = 1; i < s; i *= 2)
+    for(size_t j = 0; j < s; ++j)
+    {
+      size_t jp = j ^ i;
+
+      if(j < jp)
+      {
+        temp        = storage[j];
+        storage[j] += storage[jp];
+        storage[jp] = temp - storage[jp];
+      }
+    }
+
+  for(size_t j = 0; j < s; ++j)
+    storage[j] *= t[f[j]];
+
+  for(size_t i = 1; i < s; i *= 2)
+    for(size_t j = 0; j < s; ++j)
+    {
+      size_t jp = j ^ i;
+
+      if(j < jp)
+      {
+        temp        = storage[j];
+        storage[j] += storage[jp];
+        storage[jp] = temp - storage[jp];
+      }
+    }
+
+  for(size_t j = 0; j < s; ++j)
+    storage[j] /= s;
+}
+
+void kernel_transform(vector<double>& storage, size_t bits, const vector<int>& f,
+                      const vector<double>& t, WHT::kernel_type k)
+{
+  WHT::transform(&storage[0], bits, WHT::output_scale(&f[0], &t[0]), k);
+  WHT::transform(&storage[0], bits, WHT::output_scale(1.0 / storage.size()), k);
+}
+
+double seconds(clock_t start)
+{
+  return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t min_bits = 8, max_bits = 24;
+
+  if(argc > 1) min_bits = atoi(argv[1]);
+  if(argc > 2) max_bits = atoi(argv[2]);
+
+  const double theta     = 0.1;
+  const double tolerance = 1e-12;
+
+  WHT::kernel_type kernels[] = { WHT::scalar_kernel, WHT::avx2_kernel, WHT::avx512_kernel };
+
+  cout << "Best kernel: " << WHT::kernel_name(WHT::best_kernel()) << endl << endl;
+
+  cout << setw(5) << "bits" << setw(12) << "reference";
+
+  for(size_t k = 0; k < 3; ++k)
+    if(WHT::kernel_available(kernels[k]))
+      cout << setw(12) << WHT::kernel_name(kernels[k]) << setw(12) << "max diff";
+
+  cout << endl;
+
+  bool ok = true;
+
+  srand(1);
+
+  for(size_t bits = min_bits; bits <= max_bits; ++bits)
+  {
+    size_t n = size_t(1) << bits;
+
+    // A likelihood vector, normalized to 1, and the per-class bit counts.
+    // The bit counts only need to be in range of t for timing purposes.
+    vector<double> lv(n);
+    vector<int>    f(n);
+
+    double total = 0.0;
+
+    for(size_t j = 0; j < n; ++j)
+    {
+      lv[j]  = double(rand()) / RAND_MAX;
+      total += lv[j];
+
+      size_t c = 0;
+
+      for(size_t e = j; e; e >>= 1)
+        c += e & 1;
+
+      f[j] = c;
+    }
+
+    for(size_t j = 0; j < n; ++j)
+      lv[j] /= total;
+
+    vector<double> t(bits + 1);
+
+    t[0] = 1.0;
+
+    for(size_t i = 1; i <= bits; ++i)
+      t[i] = t[i-1] * (1 - 2 * theta);
+
+    // Repeat small transforms so the timings are measurable.
+    size_t reps = std::max((size_t) 1, ((size_t) 1 << 22) / n);
+
+    vector<double> expected;
+
+    clock_t start = clock();
+
+    for(size_t r = 0; r < reps; ++r)
+    {
+      expected = lv;
+      reference_transform(expected, f, t);
+    }
+
+    cout << setw(5) << bits << setw(12) << fixed << setprecision(6) << seconds(start) / reps;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+      if(!WHT::kernel_available(kernels[k])) continue;
+
+      vector<double> result;
+
+      start = clock();
+
+      for(size_t r = 0; r < reps; ++r)
+      {
+        result = lv;
+        kernel_transform(result, bits, f, t, kernels[k]);
+      }
+
+      double elapsed = seconds(start) / reps;
+
+      double max_diff = 0.0;
+
+      for(size_t j = 0; j < n; ++j)
+        max_diff = std::max(max_diff, fabs(result[j] - expected[j]));
+
+      if(max_diff > tolerance) ok = false;
+
+      cout << setw(12) << setprecision(6) << elapsed
+           << setw(12) << scientific << setprecision(2) << max_diff << fixed;
+    }
+
+    cout << endl;
+  }
+
+  cout << endl << (ok ? "All kernels agree within 1e-12." : "MISMATCH against reference!") << endl;
+
+  return ok ? 0 : 1;
+}
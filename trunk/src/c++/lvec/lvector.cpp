@@ -5,10 +5,18 @@
 #include "lvec/codom_ivgen.h"
 #include "lvec/iv_generator.h"
 #include "lvec/lvector.h"
+#include "lvec/walsh_hadamard.h"
 
 namespace SAGE
 {
 
+// - A vector is stored sparsely when it has at least 2^SPARSE_MIN_BITS
+//   classes and no more than SPARSE_FILL of them are nonzero.  Below that
+//   size the dense form is small enough that it isn't worth the trouble.
+//
+static const size_t  SPARSE_MIN_BITS = 12;
+static const double  SPARSE_FILL     = 0.25;
+
 class lv_acceptor : public iv_acceptor
 {
 public:
@@ -32,7 +40,8 @@ protected:
 };
 
 Likelihood_Vector::Likelihood_Vector(mmap* mm, const SAGE::MLOCUS::inheritance_model& pm)
-    : first(0), f(false), bits(0), max_bits(0), my_scale(1.0)
+    : first(0), f(false), bits(0), max_bits(0), my_scale(1.0), my_sparse(false),
+      my_keep_dense(false)
 {
   if(!mm) 
   {
@@ -66,6 +75,8 @@ Likelihood_Vector::Likelihood_Vector(mmap* mm, const SAGE::MLOCUS::inheritance_m
       set_valid(false);
     }
   }
+
+  compact();
 }
 
 /*
@@ -109,7 +120,8 @@ Likelihood_Vector::Likelihood_Vector
 
 Likelihood_Vector::Likelihood_Vector
     (const Likelihood_Vector& l, const mmap* mm, double theta)
-  : first(l.first), fixed(l.fixed), f(l.f), my_scale(1.0)
+  : first(l.first), fixed(l.fixed), f(l.f), bits(0), max_bits(0), my_scale(1.0),
+    my_sparse(false), my_keep_dense(false)
 {
   if(!l.is_valid() || !mm)
   {
@@ -128,7 +140,14 @@ Likelihood_Vector::Likelihood_Vector
     return;
   }
 
-  if(fixed_bits())
+  if(l.is_sparse())
+  {
+    clear_bits();
+
+    for(size_t k = 0; k < l.my_classes.size(); ++k)
+      storage[l.my_classes[k]] = l.my_values[k];
+  }
+  else if(fixed_bits())
   {
     for(equivalence_class i = start(); i < size(); bump_up(i))
       storage[i] = l.storage[i];
@@ -182,6 +201,8 @@ Likelihood_Vector& Likelihood_Vector::operator()
     }
   }
 
+  compact();
+
   return *this;
 }
 
@@ -273,6 +294,9 @@ Likelihood_Vector& Likelihood_Vector::operator() (const mmap* mm, double theta)
   // If theta is 0, the vector remains the same.
   if(theta == 0.0) return *this;
 
+  // Recombination moves likelihood to every class.
+  expand();
+
   // Preprocess:
 
   vector<double> th_p(mm->meiosis_count()); // Theta primes
@@ -348,25 +372,12 @@ Likelihood_Vector& Likelihood_Vector::operator() (const fft& f, double theta)
 
   if(theta == 0.0) return *this;
 
-  // Do algorithm as given in Kruglyak and Lander, 1998
+  expand();
 
-  double temp;
-  size_t s = size();  // Moved to make Intel Compiler happy
-  
-  for(equivalence_class i = 1; i < size(); i *= 2)
-  {
-    for(equivalence_class j = 0; j < size(); ++j)
-    {
-      equivalence_class jp = j ^ i;
-      
-      if(j < jp)
-      {
-        temp        = storage[j];
-        storage[j] += storage[jp];
-        storage[jp] = temp - storage[jp];
-      }
-    }
-  }
+  // Do algorithm as given in Kruglyak and Lander, 1998.  The vector is
+  // transformed, scaled by (1 - 2 theta)^k, where k is the fft bit count of
+  // each element, and transformed back.  The scalings are applied by the
+  // last butterfly stage of each transform (see walsh_hadamard.h).
 
   vector<double> t(f.get_meiosis_map()->meiosis_count()+1);
   
@@ -374,28 +385,9 @@ Likelihood_Vector& Likelihood_Vector::operator() (const fft& f, double theta)
   
   for(size_t i = 1; i < f.get_meiosis_map()->meiosis_count()+1; ++i)
     t[i] = t[i-1] * (1 - 2 * theta);
-  
-  
-  for(equivalence_class j = 0; j < s; ++j)
-    storage[j] *= t[f[j]];
-  
-  for(equivalence_class i = 1; i < size(); i *= 2)
-  {
-    for(equivalence_class j = 0; j < size(); ++j)
-    {
-      equivalence_class jp = j ^ i;
-      
-      if(j < jp)
-      {
-        temp        = storage[j];
-        storage[j] += storage[jp];
-        storage[jp] = temp - storage[jp];
-      }
-    }
-  }
 
-  for(equivalence_class j = 0; j < size(); ++j)
-    storage[j] /= size();
+  WHT::transform(&storage[0], bit_count(), WHT::output_scale(f.counts(), &t[0]));
+  WHT::transform(&storage[0], bit_count(), WHT::output_scale(1.0 / size()));
 
   first = 0;
   fixed = 0;
@@ -431,6 +423,13 @@ Likelihood_Vector& Likelihood_Vector::operator*= (const lvector& l)
 
   scaling_factor = ((likelihood) 1.0) / scaling_factor;
 
+  if(my_sparse || l.my_sparse)
+  {
+    multiply_sparse(l, scaling_factor);
+
+    return *this;
+  }
+
   equivalence_class i = start(), j = l.start();
 
   equivalence_class new_first = 0;
@@ -483,13 +482,23 @@ Likelihood_Vector& Likelihood_Vector::operator+= (const lvector& l)
 
   double delta = (l.my_scale / my_scale).get_double();
 
-  equivalence_class j = l.start();
+  expand();
 
-  while(j < l.size())
+  if(l.my_sparse)
+  {
+    for(size_t k = 0; k < l.my_classes.size(); ++k)
+      increment_value(l.my_classes[k], 0, l.my_values[k] * delta);
+  }
+  else
   {
-    increment_value(j, 0, l.storage[j] * delta);
+    equivalence_class j = l.start();
+
+    while(j < l.size())
+    {
+      increment_value(j, 0, l.storage[j] * delta);
 
-    l.bump_up(j);
+      l.bump_up(j);
+    }
   }
 
   first = min(start(), l.start());
@@ -505,8 +514,16 @@ void Likelihood_Vector::normalize()
 
   if(l == 0) return;
 
-  for(equivalence_class i = start(); i < size(); bump_up(i))
-    storage[i] /= l;
+  if(my_sparse)
+  {
+    for(size_t k = 0; k < my_values.size(); ++k)
+      my_values[k] /= l;
+  }
+  else
+  {
+    for(equivalence_class i = start(); i < size(); bump_up(i))
+      storage[i] /= l;
+  }
 
   my_scale = 1.0;
 }
@@ -520,6 +537,14 @@ Likelihood_Vector::likelihood Likelihood_Vector::total() const
 
   KahanAdder<likelihood> l = 0.0;
 
+  if(my_sparse)
+  {
+    for(size_t k = 0; k < my_values.size(); ++k)
+      l += my_values[k];
+
+    return l;
+  }
+
   for(equivalence_class i = start(); i < size(); bump_up(i))
   {
     //cout << "eq " << i << " = " << storage[i] << ", ";
@@ -540,13 +565,27 @@ double Likelihood_Vector::information() const
 
   likelihood l = 0.0;
 
-  for(equivalence_class i = start(); i < size(); bump_up(i))
+  if(my_sparse)
+  {
+    for(size_t k = 0; k < my_values.size(); ++k)
+    {
+      double d = my_values[k]/tot;
+
+      if(d == 0.0) continue;
+
+      l += d * log(d) / log((double) 2.0);
+    }
+  }
+  else
   {
-    double d = storage[i]/tot;
+    for(equivalence_class i = start(); i < size(); bump_up(i))
+    {
+      double d = storage[i]/tot;
 
-    if(d == 0.0) continue;
+      if(d == 0.0) continue;
 
-    l += d * log(d) / log((double) 2.0);
+      l += d * log(d) / log((double) 2.0);
+    }
   }
 
   l /= bit_count();
@@ -556,6 +595,162 @@ double Likelihood_Vector::information() const
   return l;
 }
 
+void Likelihood_Vector::compact()
+{
+  if(my_sparse || my_keep_dense || !is_valid() || bits < SPARSE_MIN_BITS) return;
+
+  size_t n = 0;
+
+  if(f)
+  {
+    for(equivalence_class i = start(); i < size(); bump_up(i))
+      if(storage[i] != 0.0) ++n;
+  }
+
+  if(n > size() * SPARSE_FILL) return;
+
+  my_classes.reserve(n);
+  my_values .reserve(n);
+
+  if(f)
+  {
+    for(equivalence_class i = start(); i < size(); bump_up(i))
+    {
+      if(storage[i] != 0.0)
+      {
+        my_classes.push_back(i);
+        my_values .push_back(storage[i]);
+      }
+    }
+  }
+
+  release_storage();
+
+  my_sparse = true;
+}
+
+void Likelihood_Vector::expand()
+{
+  if(!my_sparse) return;
+
+  storage.resize(size());
+
+  clear_bits();
+
+  for(size_t k = 0; k < my_classes.size(); ++k)
+    storage[my_classes[k]] = my_values[k];
+
+  release_sparse();
+}
+
+// - Elementwise product when either vector is sparse.  Only the nonzero
+//   classes of the sparse vector(s) can be nonzero in the product, so the
+//   product is sparse too.  Each product is formed as in operator*=.  A
+//   dense vector that keeps its storage (see set_keep_dense()) is instead
+//   multiplied in place, zeroing the classes where l is zero.
+//
+void Likelihood_Vector::multiply_sparse(const lvector& l, likelihood scaling_factor)
+{
+  if(!my_sparse && my_keep_dense)
+  {
+    equivalence_class i = 0;
+
+    bool new_f = false;
+
+    for(size_t k = 0; k < l.my_classes.size(); ++k)
+    {
+      equivalence_class c = l.my_classes[k];
+
+      for( ; i < c; ++i) storage[i] = 0.0;
+
+      storage[c] *= l.my_values[k] * scaling_factor;
+
+      if(!new_f && storage[c] != 0.0) { first = c; new_f = true; }
+
+      i = c + 1;
+    }
+
+    for( ; i < size(); ++i) storage[i] = 0.0;
+
+    fixed = fixed | l.fixed;
+    f     = new_f;
+
+    if(!f) first = 0;
+
+    return;
+  }
+
+  class_list   classes;
+  storage_type values;
+
+  if(!my_sparse)
+  {
+    classes.reserve(l.my_classes.size());
+    values .reserve(l.my_classes.size());
+
+    for(size_t k = 0; k < l.my_classes.size(); ++k)
+    {
+      equivalence_class c = l.my_classes[k];
+      likelihood        v = storage[c] * (l.my_values[k] * scaling_factor);
+
+      if(v == 0.0) continue;
+
+      classes.push_back(c);
+      values .push_back(v);
+    }
+  }
+  else if(!l.my_sparse)
+  {
+    classes.reserve(my_classes.size());
+    values .reserve(my_classes.size());
+
+    for(size_t k = 0; k < my_classes.size(); ++k)
+    {
+      equivalence_class c = my_classes[k];
+      likelihood        v = my_values[k] * (l.storage[c] * scaling_factor);
+
+      if(v == 0.0) continue;
+
+      classes.push_back(c);
+      values .push_back(v);
+    }
+  }
+  else
+  {
+    size_t i = 0, j = 0;
+
+    while(i < my_classes.size() && j < l.my_classes.size())
+    {
+      if(my_classes[i] < l.my_classes[j])      ++i;
+      else if(my_classes[i] > l.my_classes[j]) ++j;
+      else
+      {
+        likelihood v = my_values[i] * (l.my_values[j] * scaling_factor);
+
+        if(v != 0.0)
+        {
+          classes.push_back(my_classes[i]);
+          values .push_back(v);
+        }
+
+        ++i;
+        ++j;
+      }
+    }
+  }
+
+  my_classes.swap(classes);
+  my_values .swap(values);
+
+  release_storage();
+
+  my_sparse = true;
+
+  fixed = fixed | l.fixed;
+  f     = !my_classes.empty();
+  first = f ? my_classes[0] : 0;
+}
+
 void Likelihood_Vector::Process
     (const mmap* mm, vector<double>::iterator th_p, double th_tp)
 {
@@ -42,6 +42,10 @@ bool mpoint_likelihood_data::build(size_t max_markers, size_t max_size)
     if(!temp.is_valid()) return false;
   }
 
+  // temp is copied to and transformed once per marker interval, so it keeps
+  // its dense storage rather than being compacted and expanded each time.
+  temp.set_keep_dense(true);
+
   for(int i = 0; i < 3; ++i)
   {
     if(ref_count[i])
@@ -74,25 +78,13 @@ bool mpoint_likelihood_data::build(size_t max_markers, size_t max_size)
   return (my_build = true);
 }
 
+// - The vectors are not allocated here, but as they are computed.  Marker
+//   vectors are usually sparse (see lvector.h), and the multipoint vectors
+//   multiplied by them are sparse too, so most need far less than temp.
+//
 bool mpoint_likelihood_data::build_single_point()
 {
   single_point.resize(my_mcount);
-  for(size_t i = 0; i < my_mcount; ++i)
-  {
-    single_point[i] = temp;
-
-#if 0
-  cout << "single_point[" << i << "] lvector storage : " << endl;
-  lvector::const_iterator li;
-  for( li = single_point[i].l.begin(); li != single_point[i].l.end(); ++li )
-    cout << *li << "	";
-  cout << endl;
-  cout << "	log_scale = " << single_point[i].l.log_scale() << endl;
-#endif
-      
-    // Error allocating the memory
-    if(!single_point[i].l.is_valid()) return false;
-  }      
 
   return true;
 }
@@ -104,29 +96,6 @@ bool mpoint_likelihood_data::build_separate()
   right.resize(my_mcount);
   left .resize(my_mcount);
 
-  for(size_t i = 0; i < my_mcount; ++i)
-  {
-    right[i].l = left[i].l = temp;
-
-#if 0
-  cout << "right[" << i << "] lvector storage : " << endl;
-  lvector::const_iterator li;
-  for( li = right[i].l.begin(); li != right[i].l.end(); ++li )
-    cout << *li << "	";
-  cout << endl;
-  cout << "	log_scale = " << right[i].l.log_scale() << endl;
-
-  cout << "left[" << i << "] lvector storage : " << endl;
-  for( li = left[i].l.begin(); li != left[i].l.end(); ++li )
-    cout << *li << "	";
-  cout << endl;
-  cout << "	log_scale = " << left[i].l.log_scale() << endl;
-#endif
-      
-    // Error allocating the memory
-    if(!right[i].l.is_valid() || !left[i].l.is_valid()) return false;
-  }      
-
   return true;
 }
 
@@ -136,23 +105,6 @@ bool mpoint_likelihood_data::build_combined()
 
   multi_point.resize(my_mcount);
 
-  for(size_t i = 0; i < my_mcount; ++i)
-  {
-    multi_point[i].l = temp;
-      
-#if 0
-  cout << "multi_point[" << i << "] lvector storage : " << endl;
-  lvector::const_iterator li;
-  for( li = multi_point[i].l.begin(); li != multi_point[i].l.end(); ++li )
-    cout << *li << "	";
-  cout << endl;
-  cout << "	log_scale = " << multi_point[i].l.log_scale() << endl;
-#endif
-
-    // Error allocating the memory
-    if(!multi_point[i].l.is_valid()) return false;
-  }      
-
   return true;
 }
 
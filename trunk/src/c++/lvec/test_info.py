@@ -44,3 +44,9 @@ class lvec_test (sagetest.SAGE_Test) :
     self.cmd = 'test_ivg params ped loc 2>&1 >out'
     self.file_names = [ 'out' ]
     self.execute()
+
+  def test_lvector_sparse(self):
+    'Tests of the sparse likelihood vectors against the dense ones'
+    self.cmd = 'test_lvector_sparse >out 2>&1'
+    self.file_names = [ 'out' ]
+    self.execute()
@@ -0,0 +1,183 @@
+//==========================================================================
+//  File:    test_lvector_sparse.cpp
+//
+//  Purpose: Checks that the sparse form of Likelihood_Vector gives the
+//           same results as the dense form.  A sibship of seven gives 12
+//           bit vectors, the size at which compact() starts storing them
+//           sparsely.  Products, both recombination transforms,
+//           expand() and a work vector that keeps its dense storage are
+//           compared against the same operations on dense vectors.
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "LSF/parse_ops.h"
+#include "lvec/lvector.h"
+#include "lvec/meiosis_map.h"
+#include "lvec/fft_bit_count.h"
+
+using namespace std;
+using namespace SAGE;
+
+typedef Likelihood_Vector lvector;
+
+int failures = 0;
+
+// Sets individual classes, as the inheritance vector generators do.
+class test_lvector : public lvector
+{
+public:
+
+  explicit test_lvector(size_type n) : lvector(n) { }
+
+  void set(equivalence_class e, likelihood p) { increment_value(e, 0, p); }
+};
+
+// About one class in eight is nonzero, each pattern choosing different
+// classes.
+lvector make_vector(size_t bits, unsigned long pattern)
+{
+  test_lvector l(bits);
+
+  for( unsigned long i = 0; i < l.size(); ++i )
+  {
+    unsigned long h = (i * 2654435761UL + pattern * 40503UL) & 0xFFFFFFFFUL;
+
+    if( (h >> 13) % 8 == 0 )
+      l.set(i, 1.0 + (h % 97) / 16.0);
+  }
+
+  return l;
+}
+
+bool same(const lvector& a, const lvector& b, double tolerance)
+{
+  if( a.size() != b.size() || !a.is_valid() || !b.is_valid() )
+    return false;
+
+  if( fabs(a.log_scale().get_double() - b.log_scale().get_double())
+        > tolerance * fabs(a.log_scale().get_double()) )
+    return false;
+
+  for( size_t i = 0; i < a.size(); ++i )
+    if( fabs(a[i] - b[i]) > tolerance * (fabs(a[i]) + fabs(b[i])) )
+      return false;
+
+  return true;
+}
+
+void check(const string& name, bool ok)
+{
+  if( !ok )
+    ++failures;
+
+  cout << (ok ? "ok    " : "FAILED") << "  " << name << endl;
+}
+
+int main()
+{
+  RPED::RefMultiPedigree rmp;
+
+  const string ped = "sparse";
+
+  rmp.add_member(ped, "f", MPED::SEX_MALE);
+  rmp.add_member(ped, "m", MPED::SEX_FEMALE);
+
+  for( size_t i = 0; i < 7; ++i )
+  {
+    string name = "c" + long2str(i + 1);
+
+    rmp.add_member (ped, name, i % 2 ? MPED::SEX_FEMALE : MPED::SEX_MALE);
+    rmp.add_lineage(ped, name, "f", "m");
+  }
+
+  rmp.build();
+
+  FPED::Multipedigree fmp(rmp);
+
+  FPED::MPFilterer::add_multipedigree(fmp, rmp);
+
+  fmp.construct();
+
+  meiosis_map mm(&*fmp.pedigree_begin()->subpedigree_begin());
+
+  fft_bit_count fbc;
+
+  fbc.count(&mm);
+
+  const size_t bits = mm.nonfounder_meiosis_count();
+
+  cout << "Bits: " << bits << endl << endl;
+
+  const lvector a = make_vector(bits, 1);
+  const lvector b = make_vector(bits, 2);
+
+  lvector sa = a; sa.compact();
+  lvector sb = b; sb.compact();
+
+  check("dense vectors stay dense",        !a.is_sparse() && !b.is_sparse());
+  check("compact() stores sparsely",       sa.is_sparse() && sb.is_sparse());
+  check("sparse equals dense",             same(sa, a, 0.0) && sa == a);
+  check("sparse total",                    sa.total() == a.total());
+  check("sparse information",              fabs(sa.information() - a.information()) < 1e-12);
+
+  lvector ea = sa; ea.expand();
+
+  check("expand() returns the dense form", !ea.is_sparse() && same(ea, a, 0.0));
+
+  // Products of each combination of forms.
+
+  lvector ab = a; ab *= b;
+
+  lvector p1 = sa; p1 *= b;
+  lvector p2 = a;  p2 *= sb;
+  lvector p3 = sa; p3 *= sb;
+
+  check("sparse *= dense",                 p1.is_sparse() && same(p1, ab, 0.0));
+  check("dense *= sparse",                 p2.is_sparse() && same(p2, ab, 0.0));
+  check("sparse *= sparse",                p3.is_sparse() && same(p3, ab, 0.0));
+
+  // The recombination transforms fill the vector, so they expand it.
+
+  lvector ta = a;  ta(&mm, 0.1);
+  lvector t1 = sa; t1(&mm, 0.1);
+
+  check("meiosis map transform",           !t1.is_sparse() && same(t1, ta, 0.0));
+
+  lvector fa = a;  fa(fbc, 0.1);
+  lvector f1 = sa; f1(fbc, 0.1);
+
+  check("fft transform",                   !f1.is_sparse() && same(f1, fa, 0.0));
+  check("fft and meiosis map transforms",  same(fa, ta, 1e-12));
+
+  // A work vector keeps its storage through copies and products.
+
+  lvector work(bits);
+
+  work.set_keep_dense(true);
+
+  work = sa;
+
+  check("assigning a sparse vector",       !work.is_sparse() && same(work, a, 0.0));
+
+  work *= sb;
+
+  check("multiplying by a sparse vector",  !work.is_sparse() && same(work, ab, 0.0));
+
+  work.compact();
+
+  check("compact() keeps it dense",        !work.is_sparse());
+
+  work = sa;
+  work(fbc, 0.1);
+
+  check("transform after assignment",      same(work, fa, 0.0));
+
+  cout << endl << failures << " failures." << endl;
+
+  return failures ? 1 : 0;
+}
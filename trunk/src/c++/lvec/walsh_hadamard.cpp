@@ -0,0 +1,468 @@
+//==========================================================================
+//  File:    walsh_hadamard.cpp
+//
+//  Purpose: Blocked, branch free Walsh-Hadamard butterfly kernels with
+//           run time processor dispatch.
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <algorithm>
+#include "lvec/walsh_hadamard.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#  define SAGE_WHT_X86_KERNELS
+#  include <immintrin.h>
+#endif
+
+namespace SAGE
+{
+namespace WHT
+{
+
+// Number of stages done within a cache block.  2^11 doubles is 16 KB,
+// which stays in L1 on every processor we run on.
+static const size_t block_bits = 11;
+
+//==========================================================================
+// Scalar kernel
+//==========================================================================
+
+struct scalar_ops
+{
+  static const size_t width_bits = 0;
+
+  static void small_strides(double*, size_t) { }
+
+  static void stage2(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 2 * h)
+    {
+      double* lo = x + base;
+      double* hi = lo + h;
+
+      for(size_t j = 0; j < h; ++j)
+      {
+        double a = lo[j], b = hi[j];
+
+        lo[j] = a + b;
+        hi[j] = a - b;
+      }
+    }
+  }
+
+  // Two consecutive stages (strides h and 2h) in one sweep.  The butterflies
+  // are the same as two stage2() passes, only the memory traffic is halved.
+  static void stage4(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 4 * h)
+    {
+      double* x0 = x + base;
+      double* x1 = x0 + h;
+      double* x2 = x1 + h;
+      double* x3 = x2 + h;
+
+      for(size_t j = 0; j < h; ++j)
+      {
+        double b0 = x0[j] + x1[j], b1 = x0[j] - x1[j];
+        double b2 = x2[j] + x3[j], b3 = x2[j] - x3[j];
+
+        x0[j] = b0 + b2;
+        x1[j] = b1 + b3;
+        x2[j] = b0 - b2;
+        x3[j] = b1 - b3;
+      }
+    }
+  }
+
+  static void final_stage(double* x, size_t n, const output_scale& sc)
+  {
+    size_t h  = n / 2;
+    double* hi = x + h;
+
+    if(sc.table)
+    {
+      const int* ilo = sc.index;
+      const int* ihi = sc.index + h;
+
+      for(size_t j = 0; j < h; ++j)
+      {
+        double a = x[j], b = hi[j];
+
+        x[j]  = (a + b) * sc.table[ilo[j]];
+        hi[j] = (a - b) * sc.table[ihi[j]];
+      }
+    }
+    else
+    {
+      for(size_t j = 0; j < h; ++j)
+      {
+        double a = x[j], b = hi[j];
+
+        x[j]  = (a + b) * sc.scalar;
+        hi[j] = (a - b) * sc.scalar;
+      }
+    }
+  }
+};
+
+#if defined(SAGE_WHT_X86_KERNELS)
+
+//==========================================================================
+// AVX2 kernel (4 doubles per register)
+//==========================================================================
+
+#define SAGE_AVX2 __attribute__((target("avx2")))
+
+struct avx2_ops
+{
+  static const size_t width_bits = 2;
+
+  // Strides 1 and 2 are within a register.  For each, the register is
+  // permuted so that every element faces its partner, then the sum is kept
+  // in the low half of each pair and the difference in the high half.
+  static SAGE_AVX2 void small_strides(double* x, size_t bits)
+  {
+    size_t n = size_t(1) << bits;
+
+    for(size_t j = 0; j < n; j += 4)
+    {
+      __m256d a = _mm256_loadu_pd(x + j);
+
+      __m256d p = _mm256_permute_pd(a, 0x5);
+      a = _mm256_blend_pd(_mm256_add_pd(a, p), _mm256_sub_pd(p, a), 0xA);
+
+      p = _mm256_permute2f128_pd(a, a, 0x01);
+      a = _mm256_blend_pd(_mm256_add_pd(a, p), _mm256_sub_pd(p, a), 0xC);
+
+      _mm256_storeu_pd(x + j, a);
+    }
+  }
+
+  static SAGE_AVX2 void stage2(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 2 * h)
+    {
+      double* lo = x + base;
+      double* hi = lo + h;
+
+      for(size_t j = 0; j < h; j += 4)
+      {
+        __m256d a = _mm256_loadu_pd(lo + j);
+        __m256d b = _mm256_loadu_pd(hi + j);
+
+        _mm256_storeu_pd(lo + j, _mm256_add_pd(a, b));
+        _mm256_storeu_pd(hi + j, _mm256_sub_pd(a, b));
+      }
+    }
+  }
+
+  static SAGE_AVX2 void stage4(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 4 * h)
+    {
+      double* x0 = x + base;
+      double* x1 = x0 + h;
+      double* x2 = x1 + h;
+      double* x3 = x2 + h;
+
+      for(size_t j = 0; j < h; j += 4)
+      {
+        __m256d a0 = _mm256_loadu_pd(x0 + j);
+        __m256d a1 = _mm256_loadu_pd(x1 + j);
+        __m256d a2 = _mm256_loadu_pd(x2 + j);
+        __m256d a3 = _mm256_loadu_pd(x3 + j);
+
+        __m256d b0 = _mm256_add_pd(a0, a1), b1 = _mm256_sub_pd(a0, a1);
+        __m256d b2 = _mm256_add_pd(a2, a3), b3 = _mm256_sub_pd(a2, a3);
+
+        _mm256_storeu_pd(x0 + j, _mm256_add_pd(b0, b2));
+        _mm256_storeu_pd(x1 + j, _mm256_add_pd(b1, b3));
+        _mm256_storeu_pd(x2 + j, _mm256_sub_pd(b0, b2));
+        _mm256_storeu_pd(x3 + j, _mm256_sub_pd(b1, b3));
+      }
+    }
+  }
+
+  static SAGE_AVX2 void final_stage(double* x, size_t n, const output_scale& sc)
+  {
+    size_t h  = n / 2;
+    double* hi = x + h;
+
+    if(sc.table)
+    {
+      const int* ilo = sc.index;
+      const int* ihi = sc.index + h;
+
+      // The masked gathers take a defined source, where the plain ones
+      // leave it uninitialized and draw warnings.
+      const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+      for(size_t j = 0; j < h; j += 4)
+      {
+        __m256d a  = _mm256_loadu_pd(x + j);
+        __m256d b  = _mm256_loadu_pd(hi + j);
+        __m256d wl = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), sc.table, _mm_loadu_si128((const __m128i*) (ilo + j)), all, 8);
+        __m256d wh = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), sc.table, _mm_loadu_si128((const __m128i*) (ihi + j)), all, 8);
+
+        _mm256_storeu_pd(x + j,  _mm256_mul_pd(_mm256_add_pd(a, b), wl));
+        _mm256_storeu_pd(hi + j, _mm256_mul_pd(_mm256_sub_pd(a, b), wh));
+      }
+    }
+    else
+    {
+      __m256d w = _mm256_set1_pd(sc.scalar);
+
+      for(size_t j = 0; j < h; j += 4)
+      {
+        __m256d a = _mm256_loadu_pd(x + j);
+        __m256d b = _mm256_loadu_pd(hi + j);
+
+        _mm256_storeu_pd(x + j,  _mm256_mul_pd(_mm256_add_pd(a, b), w));
+        _mm256_storeu_pd(hi + j, _mm256_mul_pd(_mm256_sub_pd(a, b), w));
+      }
+    }
+  }
+};
+
+#undef SAGE_AVX2
+
+//==========================================================================
+// AVX-512 kernel (8 doubles per register)
+//==========================================================================
+
+#define SAGE_AVX512 __attribute__((target("avx512f")))
+
+struct avx512_ops
+{
+  static const size_t width_bits = 3;
+
+  static SAGE_AVX512 void small_strides(double* x, size_t bits)
+  {
+    size_t n = size_t(1) << bits;
+
+    for(size_t j = 0; j < n; j += 8)
+    {
+      __m512d a = _mm512_loadu_pd(x + j);
+
+      __m512d p = _mm512_mask_permute_pd(a, 0xFF, a, 0x55);
+      a = _mm512_mask_blend_pd(0xAA, _mm512_add_pd(a, p), _mm512_sub_pd(p, a));
+
+      p = _mm512_mask_permutex_pd(a, 0xFF, a, 0x4E);
+      a = _mm512_mask_blend_pd(0xCC, _mm512_add_pd(a, p), _mm512_sub_pd(p, a));
+
+      p = _mm512_mask_shuffle_f64x2(a, 0xFF, a, a, 0x4E);
+      a = _mm512_mask_blend_pd(0xF0, _mm512_add_pd(a, p), _mm512_sub_pd(p, a));
+
+      _mm512_storeu_pd(x + j, a);
+    }
+  }
+
+  static SAGE_AVX512 void stage2(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 2 * h)
+    {
+      double* lo = x + base;
+      double* hi = lo + h;
+
+      for(size_t j = 0; j < h; j += 8)
+      {
+        __m512d a = _mm512_loadu_pd(lo + j);
+        __m512d b = _mm512_loadu_pd(hi + j);
+
+        _mm512_storeu_pd(lo + j, _mm512_add_pd(a, b));
+        _mm512_storeu_pd(hi + j, _mm512_sub_pd(a, b));
+      }
+    }
+  }
+
+  static SAGE_AVX512 void stage4(double* x, size_t n, size_t h)
+  {
+    for(size_t base = 0; base < n; base += 4 * h)
+    {
+      double* x0 = x + base;
+      double* x1 = x0 + h;
+      double* x2 = x1 + h;
+      double* x3 = x2 + h;
+
+      for(size_t j = 0; j < h; j += 8)
+      {
+        __m512d a0 = _mm512_loadu_pd(x0 + j);
+        __m512d a1 = _mm512_loadu_pd(x1 + j);
+        __m512d a2 = _mm512_loadu_pd(x2 + j);
+        __m512d a3 = _mm512_loadu_pd(x3 + j);
+
+        __m512d b0 = _mm512_add_pd(a0, a1), b1 = _mm512_sub_pd(a0, a1);
+        __m512d b2 = _mm512_add_pd(a2, a3), b3 = _mm512_sub_pd(a2, a3);
+
+        _mm512_storeu_pd(x0 + j, _mm512_add_pd(b0, b2));
+        _mm512_storeu_pd(x1 + j, _mm512_add_pd(b1, b3));
+        _mm512_storeu_pd(x2 + j, _mm512_sub_pd(b0, b2));
+        _mm512_storeu_pd(x3 + j, _mm512_sub_pd(b1, b3));
+      }
+    }
+  }
+
+  static SAGE_AVX512 void final_stage(double* x, size_t n, const output_scale& sc)
+  {
+    size_t h  = n / 2;
+    double* hi = x + h;
+
+    if(sc.table)
+    {
+      const int* ilo = sc.index;
+      const int* ihi = sc.index + h;
+
+      for(size_t j = 0; j < h; j += 8)
+      {
+        __m512d a  = _mm512_loadu_pd(x + j);
+        __m512d b  = _mm512_loadu_pd(hi + j);
+        __m512d wl = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm256_loadu_si256((const __m256i*) (ilo + j)), sc.table, 8);
+        __m512d wh = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm256_loadu_si256((const __m256i*) (ihi + j)), sc.table, 8);
+
+        _mm512_storeu_pd(x + j,  _mm512_mul_pd(_mm512_add_pd(a, b), wl));
+        _mm512_storeu_pd(hi + j, _mm512_mul_pd(_mm512_sub_pd(a, b), wh));
+      }
+    }
+    else
+    {
+      __m512d w = _mm512_set1_pd(sc.scalar);
+
+      for(size_t j = 0; j < h; j += 8)
+      {
+        __m512d a = _mm512_loadu_pd(x + j);
+        __m512d b = _mm512_loadu_pd(hi + j);
+
+        _mm512_storeu_pd(x + j,  _mm512_mul_pd(_mm512_add_pd(a, b), w));
+        _mm512_storeu_pd(hi + j, _mm512_mul_pd(_mm512_sub_pd(a, b), w));
+      }
+    }
+  }
+};
+
+#undef SAGE_AVX512
+
+#endif
+
+//==========================================================================
+// Driver
+//==========================================================================
+
+// The stages are applied in the order:
+//
+//   1. Within each cache block, the in-register strides, then the remaining
+//      strides up to the block size, in pairs.
+//   2. Strides larger than a block over the whole vector, in pairs.
+//   3. The largest stride, scaled on output.
+//
+// Ops requires bits > Ops::width_bits, so that the final stage and every
+// cache block span at least one full register.
+template <class Ops>
+void run(double* x, size_t bits, const output_scale& sc)
+{
+  const size_t n     = size_t(1) << bits;
+  const size_t last  = bits - 1;
+  const size_t inner = std::min(block_bits, last);
+  const size_t bs    = size_t(1) << inner;
+
+  for(size_t b = 0; b < n; b += bs)
+  {
+    double* blk = x + b;
+
+    Ops::small_strides(blk, inner);
+
+    size_t s = Ops::width_bits;
+
+    for( ; s + 1 < inner; s += 2)
+      Ops::stage4(blk, bs, size_t(1) << s);
+
+    if(s < inner)
+      Ops::stage2(blk, bs, size_t(1) << s);
+  }
+
+  size_t s = inner;
+
+  for( ; s + 1 < last; s += 2)
+    Ops::stage4(x, n, size_t(1) << s);
+
+  if(s < last)
+    Ops::stage2(x, n, size_t(1) << s);
+
+  Ops::final_stage(x, n, sc);
+}
+
+static kernel_type detect_kernel()
+{
+#if defined(SAGE_WHT_X86_KERNELS)
+  __builtin_cpu_init();
+
+  if(__builtin_cpu_supports("avx512f")) return avx512_kernel;
+  if(__builtin_cpu_supports("avx2"))    return avx2_kernel;
+#endif
+
+  return scalar_kernel;
+}
+
+kernel_type best_kernel()
+{
+  static const kernel_type best = detect_kernel();
+
+  return best;
+}
+
+bool kernel_available(kernel_type k)
+{
+  return k <= best_kernel();
+}
+
+const char* kernel_name(kernel_type k)
+{
+  switch(k)
+  {
+    case avx512_kernel : return "avx512";
+    case avx2_kernel   : return "avx2";
+    default            : return "scalar";
+  }
+}
+
+void transform(double* x, size_t bits, const output_scale& sc)
+{
+  transform(x, bits, sc, best_kernel());
+}
+
+void transform(double* x, size_t bits, const output_scale& sc, kernel_type k)
+{
+  if(!x) return;
+
+  // A single element has no butterflies, only the output scale.
+  if(bits == 0)
+  {
+    x[0] *= sc.table ? sc.table[sc.index[0]] : sc.scalar;
+
+    return;
+  }
+
+  if(!kernel_available(k))
+    k = scalar_kernel;
+
+#if defined(SAGE_WHT_X86_KERNELS)
+  if(k == avx512_kernel && bits > avx512_ops::width_bits)
+  {
+    run<avx512_ops>(x, bits, sc);
+    return;
+  }
+
+  if(k >= avx2_kernel && bits > avx2_ops::width_bits)
+  {
+    run<avx2_ops>(x, bits, sc);
+    return;
+  }
+#endif
+
+  run<scalar_ops>(x, bits, sc);
+}
+
+}
+}
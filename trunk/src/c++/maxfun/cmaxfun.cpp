@@ -394,7 +394,6 @@ char Maxfun_Data::maxfst_[][80] =
 
 /* Table of constant values */
 
-bool Maxfun::iteration_ended = false;
 
 // by JA for djb
 
@@ -3567,7 +3566,7 @@ int Maxfun::endit_()
 {
 //    SAGE::MAXFUN::APIMaxFunction::output_iteration_end_results();
 
-    Maxfun::iteration_ended = true;
+    fun->end_iteration();
 
     /* Local variables */
     double er;
@@ -4000,16 +3999,135 @@ L320:
 #undef u_ref
 
 
-int Maxfun::deriv1_()
+//----------------------------------------------------------------------------
+//
+// Concurrent derivatives
+//
+//----------------------------------------------------------------------------
+
+/// Prepares the workers for computing item_count pieces of a derivative.
+/// Returns true if they should be computed concurrently, false if serially.
+
+bool Maxfun::setup_deriv_workers_(size_t item_count)
 {
-    /* Local variables */
-    double dthi, this__, thiy;
-    int l;
-    double fm = 0;
-    double fp = 0;
-    double si = 0;
-    int lex;
+    if (item_count < 2 || my_deriv_serial) {
+        return false;
+    }
+
+    if (my_deriv_pool) {
+        return true;
+    }
+
+    size_t thread_count = my_thread_count ? my_thread_count
+                                          : UTIL::ThreadPool::default_thread_count();
+
+    if (thread_count < 2) {
+        return false;
+    }
+
+    bool shared = fun->is_thread_safe();
+
+    // Functions which aren't thread safe get a copy for each worker but the
+    // first.  If they can't be copied, we never try again.
+
+    if (!shared) {
+        for (size_t w = 1; w < thread_count; ++w) {
+            MaxFunction* copy = fun->clone();
+
+            if (!copy) {
+                clear_deriv_workers_();
+                my_deriv_serial = true;
+                return false;
+            }
+
+            my_deriv_clones.push_back(copy);
+        }
+    }
+
+    my_deriv_pool = new UTIL::ThreadPool(thread_count);
+
+    my_deriv_workers.resize(my_deriv_pool->thread_count());
+
+    my_deriv_workers[0] = deriv_worker(fun, shared);
+
+    for (size_t w = 1; w < my_deriv_workers.size(); ++w) {
+        my_deriv_workers[w] = deriv_worker(shared ? fun : my_deriv_clones[w-1], shared);
+    }
+
+    return true;
+}
+
+void Maxfun::deriv1_task_(size_t item, size_t worker)
+{
+    deriv_worker& w = my_deriv_workers[worker];
+
+    w.thy = theta;
+
+    deriv1_param_(w, w.thy, my_deriv_params[item], my_deriv1_results[item]);
+}
+
+void Maxfun::deriv2_step_task_(size_t item, size_t worker)
+{
+    deriv_worker& w = my_deriv_workers[worker];
+
+    size_t l = my_deriv2_first + item;
+
+    w.thy = my_deriv2_base;
+
+    deriv2_step_(w, w.thy, my_deriv_params[l], my_deriv2_steps[l]);
+}
+
+/// Computes h(l,ll), where item = l*(l+1)/2 + ll and ll <= l.
+
+void Maxfun::deriv2_task_(size_t item, size_t worker)
+{
+    size_t l = 0;
+
+    while ((l + 1) * (l + 2) / 2 <= item) {
+        ++l;
+    }
+
+    size_t ll = item - l * (l + 1) / 2;
 
+    // Rows whose stepsize search struck a bound have no derivatives
+
+    if (my_deriv2_steps[l].struck) {
+        return;
+    }
+
+    deriv_worker& w = my_deriv_workers[worker];
+
+    deriv2_row_base_(l, w.thy);
+
+    int i = my_deriv_params[l];
+
+    if (ll == l) {
+        deriv2_diag_(w, w.thy, i, my_deriv2_steps[l], my_deriv2_ih,
+                     my_deriv2_results[item]);
+    } else {
+        deriv2_cross_(w, w.thy, i, my_deriv_params[ll],
+                      my_deriv2_steps[l], my_deriv2_steps[ll], my_deriv2_ih,
+                      my_deriv2_results[item]);
+    }
+}
+
+/// The parameter vector seen by row l of deriv2_:  theta, except for the
+/// parameters of earlier rows which struck a bound, which are left where
+/// their stepsize search stopped.
+
+void Maxfun::deriv2_row_base_(size_t l, vector<double>& thy) const
+{
+    thy = theta;
+
+    for (size_t k = 0; k < l; ++k) {
+        if (my_deriv2_steps[k].struck) {
+            thy[my_deriv_params[k]] = my_deriv2_steps[k].thy;
+        }
+    }
+}
+
+int Maxfun::deriv1_()
+{
 /* --COMPUTE GRADIENT (VECTOR OF FIRST PARTIAL DERIVATIVES) AND ITS NORM
 */
 
@@ -4027,13 +4145,89 @@ int Maxfun::deriv1_()
     thy = theta;
     my_data.maxf2_.gtg = 0.;
 
-/* --LOOP THROUGH NV INDEPENDENT VARYING PARAMETERS */
+    my_deriv_params.clear();
 
-    l = -1;
     for (int i = 0; i < my_data.maxf1_.nt; ++i) {
-   if (my_data.maxf2_.ist[i] > 2) continue;
+        if (my_data.maxf2_.ist[i] <= 2) {
+            my_deriv_params.push_back(i);
+        }
+    }
+
+    my_deriv1_results.resize(my_deriv_params.size());
+
+    deriv_worker serial(fun);
+
+    bool parallel = setup_deriv_workers_(my_deriv_params.size());
+
+    // If anything goes wrong on the workers, compute serially instead.
+
+    if (parallel) {
+        UTIL::MemberTask<Maxfun> task(*this, &Maxfun::deriv1_task_);
+
+        parallel = my_deriv_pool->run(my_deriv_params.size(), task);
+    }
+
+/* --LOOP THROUGH NV INDEPENDENT VARYING PARAMETERS */
+
+    for (size_t l = 0; l < my_deriv_params.size(); ++l) {
+        deriv1_result& r = my_deriv1_results[l];
+
+        if (!parallel) {
+            deriv1_param_(serial, thy, my_deriv_params[l], r);
+        }
+
+        nfe += r.nfe;
+
+        if (r.impbnd) {
+            my_data.maxf2_.impbnd = 1;
+        }
+
+        if (r.stuck) {
+            goto L90;
+        }
+
+        my_data.maxf2_.g[l] = r.g;
+
+/* Computing 2nd power */
+        my_data.maxf2_.gtg += my_data.maxf2_.g[l] * my_data.maxf2_.g[l];
+    }
+
+/* --FINISH NORM OF GRADIENT */
+
+    my_data.maxf2_.gtg = sqrt(my_data.maxf2_.gtg);
+
+/* --INDICATE HAVE G CORRESPONDING TO CURRENT THETA */
+
+    my_data.maxf2_.igfl = 0;
+    my_data.maxf2_.igage = 0;
+
+    return 0;
+
+/* --ERROR EXIT; PARAMETER I STUCK */
+
+L90:
+    my_data.maxf2_.igfl = 1;
+    return 0;
+
+} /* deriv1_ */
+
+/// Computes the first derivative with respect to parameter i.  thy[i] is
+/// restored afterward.
+
+void Maxfun::deriv1_param_(deriv_worker& w, vector<double>& thy, int i, deriv1_result& r)
+{
+    /* Local variables */
+    double dthi, this__, thiy;
+    double fm = 0;
+    double fp = 0;
+    double si = 0;
+    int lex;
+
+    r.g      = 0.;
+    r.stuck  = 0;
+    r.impbnd = 0;
+    r.nfe    = 0;
 
-   ++l;
    this__ = thy[i];
    si = my_data.maxf1_.yota;
 
@@ -4044,7 +4238,7 @@ L20:
        goto L40;
    }
    thy[i] = thiy;
-        evaluate(thy, fp, nfe, lex);
+        evaluate(*w.fun, w.shared, thy, fp, r.nfe, lex);
    if (lex <= 0) {
        goto L50;
    }
@@ -4052,7 +4246,7 @@ L20:
 /* --RUNNING INTO IMPLIED BOUNDARY */
 
 L30:
-   my_data.maxf2_.impbnd = 1;
+   r.impbnd = 1;
 
 /* --RUNNING INTO TROUBLE; DECREASE INCREMENT */
 
@@ -4073,7 +4267,7 @@ L50:
 
 /* --FORWARD DIFFERENCE */
 
-   my_data.maxf2_.g[l] = (fp - f) / dthi;
+   r.g = (fp - f) / dthi;
    goto L70;
 
 /* --CENTRAL DIFFERENCE */
@@ -4084,67 +4278,27 @@ L60:
        goto L40;
    }
    thy[i] = thiy;
-   evaluate(thy, fm, nfe, lex);
+   evaluate(*w.fun, w.shared, thy, fm, r.nfe, lex);
    if (lex > 0) {
        goto L30;
    }
-   my_data.maxf2_.g[l] = (fp - fm) / (dthi + dthi);
+   r.g = (fp - fm) / (dthi + dthi);
 
 L70:
-/* Computing 2nd power */
-   my_data.maxf2_.gtg += my_data.maxf2_.g[l] * my_data.maxf2_.g[l];
    thy[i] = this__;
-    }
-
-/* --FINISH NORM OF GRADIENT */
-
-    my_data.maxf2_.gtg = sqrt(my_data.maxf2_.gtg);
-
-/* --INDICATE HAVE G CORRESPONDING TO CURRENT THETA */
+   return;
 
-    my_data.maxf2_.igfl = 0;
-    my_data.maxf2_.igage = 0;
-
-    return 0;
-
-/* --ERROR EXIT; PARAMETER I STUCK */
+/* --PARAMETER I STUCK */
 
 L90:
-    my_data.maxf2_.igfl = 1;
-    return 0;
+   r.stuck = 1;
+   thy[i] = this__;
 
-} /* deriv1_ */
+} /* deriv1_param_ */
 
 int Maxfun::deriv2_(int& ih, int& lex)
 {
-    /* Local variables */
-    double athi, dthi, thim;
-    int lexf;
-    double thip, thii;
-    int isti;
-    int l, n;
-    double dthii;
-    int istii;
-    double prmuh;
-    double fm = 0;
-    int ll, nl, nk;
-    double si;
-    int nm;
-    double fp = 0;
-    double e2d8;
-    int nbd[4];
-    double fmm = 0;
-    double fmp = 0;
-    double thi = 0;
-    double sii = 0;
-    double fpp = 0;
-    double fpm = 0;
-
-    double max_si, min_si, max_dthi, old_dthi;
-    double hfunc;
-
 #define h_ref(a_1,a_2)    my_data.maxf2_.h[(a_2)*my_data.param_NPV+a_1]
-#define hn_ref(a_1,a_2,a_3) hn[((a_3)*my_data.param_NPV+(a_2))*my_data.param_NPV+a_1]
 #define lrh_ref(a_1,a_2)    lrh[(a_2)*my_data.param_NPV+a_1]
 
 /* --COMPUTE 2ND PARTIAL DERIVATIVES OF THE FUNCTION */
@@ -4157,32 +4311,203 @@ int Maxfun::deriv2_(int& ih, int& lex)
 
 /* --INDICATE TYPE OF APPROXIMATION USED FOR SECOND DERIVATIVES */
 
-    vector<double> hn(3*my_data.param_NPV*my_data.param_NPV, 0.0);
     vector<int> lrh(my_data.param_NPV*my_data.param_NPV, 0);
     vector<double> thy(my_data.param_NP);
-    vector<double> dthis(my_data.param_NP, numeric_limits<double>::quiet_NaN());
 
     /* Function Body */
 /* --INITIALIZE */
 
     lex = 0;
-    e2d8 = my_data.maxf1_.epsd * my_data.maxf1_.epsd / 8.;
     thy = theta;
 
     for (int ll = 0; ll < my_data.maxf2_.nv; ++ll)
    for (int l = 0; l < my_data.maxf2_.nv; ++l)
        lrh_ref(l, ll) = 0;
 
-/* --LOOP THROUGH INDEPENDENT, VARYING PARAMETERS */
+    my_deriv_params.clear();
 
-    l = -1;
     for (int i = 0; i < my_data.maxf1_.nt; ++i) {
-   isti = my_data.maxf2_.ist[i];
+        if (my_data.maxf2_.ist[i] <= 2) {
+            my_deriv_params.push_back(i);
+        }
+    }
 
-   if (isti > 2)
-            continue;
+    size_t nv = my_deriv_params.size();
+
+    my_deriv2_steps.resize(nv);
+    my_deriv2_results.resize(nv * (nv + 1) / 2);
+
+    deriv_worker serial(fun);
+
+    bool parallel = setup_deriv_workers_(nv);
+
+    if (parallel) {
+        // Do the stepsize searches.  A search which strikes a bound doesn't
+        // restore its parameter, which changes the searches after it, so
+        // those are redone with the new value.
+
+        // If anything goes wrong on the workers, compute serially instead.
+
+        my_deriv2_base = theta;
+
+        for (my_deriv2_first = 0; parallel && my_deriv2_first < nv; ) {
+            UTIL::MemberTask<Maxfun> step_task(*this, &Maxfun::deriv2_step_task_);
+
+            parallel = my_deriv_pool->run(nv - my_deriv2_first, step_task);
+
+            size_t l = my_deriv2_first;
+
+            for ( ; l < nv; ++l) {
+                const deriv2_step& step = my_deriv2_steps[l];
+
+                if (step.struck && step.thy != my_deriv2_base[my_deriv_params[l]]) {
+                    my_deriv2_base[my_deriv_params[l]] = step.thy;
+                    break;
+                }
+            }
+
+            my_deriv2_first = l + 1;
+        }
+    }
+
+    if (parallel) {
+        // Then all the derivatives
+
+        for (size_t k = 0; k < my_deriv2_results.size(); ++k) {
+            size_t l = 0;
+
+            while ((l + 1) * (l + 2) / 2 <= k) {
+                ++l;
+            }
+
+            my_deriv2_results[k].h = h_ref(l, k - l * (l + 1) / 2);
+        }
+
+        my_deriv2_ih = ih;
+
+        UTIL::MemberTask<Maxfun> task(*this, &Maxfun::deriv2_task_);
+
+        parallel = my_deriv_pool->run(my_deriv2_results.size(), task);
+    }
+
+/* --LOOP THROUGH INDEPENDENT, VARYING PARAMETERS */
+
+    for (size_t l = 0; l < nv; ++l) {
+   int i = my_deriv_params[l];
+
+   deriv2_step& step = my_deriv2_steps[l];
+
+   if (!parallel) {
+       deriv2_step_(serial, thy, i, step);
+   }
+
+   nfe += step.nfe;
+
+   if (step.impbnd) {
+       my_data.maxf2_.impbnd = 1;
+   }
+
+        // We have struck a bound.  This means that this value cannot have a
+        // valid second derivative or standard error.  We make sure of this
+        // by setting the delta theta to QNAN and then skipping over the
+        // later calculations.
+
+   if (step.struck) {
+       h_ref(l,l) = numeric_limits<double>::quiet_NaN();
+
+       lex = 3;
+
+       continue;
+   }
+
+        // store stepsize
+
+   my_data.maxf2_.stp[i] = step.si;
+
+/* --COMPUTE 2ND PARTIAL DERIVATIVES FOR (I,II) AND (II,I) PAIRS */
+/* --WHERE II < I, THEN THE (I,I) PAIR */
+
+   for (size_t ll = 0; ll <= l; ++ll) {
+       deriv2_result& r = my_deriv2_results[l * (l + 1) / 2 + ll];
+
+       if (!parallel) {
+           r.h = h_ref(l, ll);
+
+           if (ll < l) {
+               deriv2_cross_(serial, thy, i, my_deriv_params[ll], step,
+                             my_deriv2_steps[ll], ih, r);
+           } else {
+               deriv2_diag_(serial, thy, i, step, ih, r);
+           }
+       }
+
+       nfe += r.nfe;
+
+       if (r.impbnd) {
+           my_data.maxf2_.impbnd = 1;
+       }
+
+       h_ref(l, ll) = r.h;
+
+       if (r.stuck) {
+           goto L490;
+       }
+
+/* --ITERATION FINISHED BUT THERE IS ROUND-OFF ERROR IN COMPUTING */
+/* --2ND DERIVATIVE */
+
+       if (r.roundoff) {
+           lrh_ref(l, ll) = 1;
+           lex = 1;
+       }
+
+/* --COPY 2ND DERIVATIVE TO ELEMENT (LL,L) OF SYMMETRIC MATRIX */
+
+       if (r.mirror) {
+           h_ref(ll, l) = h_ref(l, ll);
+       }
+   }
+    }
+
+/* --PRINT H AND WARNINGS ABOUT ROUND-OFF ERRORS IN DETAIL FILE, IF ANY */
+
+    return 0;
+
+/* --ERROR EXIT; PARAMETER(S) STUCK */
+
+L490:
+    lex = 2;
+    return 0;
+
+#undef lrh_ref
+#undef h_ref
+
+} /* deriv2_ */
+
+/// Searches for the stepsize for the second derivatives with respect to
+/// parameter i.  thy[i] is restored unless a bound is struck.
+
+void Maxfun::deriv2_step_(deriv_worker& w, vector<double>& thy, int i, deriv2_step& r)
+{
+    /* Local variables */
+    double athi, dthi, thim;
+    int lexf;
+    double thip;
+    double fm = 0;
+    double si;
+    double e2d8;
+    double fp = 0;
+    double thi = 0;
+
+    double max_si, min_si, max_dthi, old_dthi;
+    double hfunc;
+
+    r.struck = 0;
+    r.impbnd = 0;
+    r.nfe    = 0;
+
+    e2d8 = my_data.maxf1_.epsd * my_data.maxf1_.epsd / 8.;
 
-   ++l;
    thi = thy[i];
    athi = fabs(thi);
    si = my_data.maxf2_.stp[i];
@@ -4256,12 +4581,12 @@ L60:
         // fail, there must be an implied bound.
 
    thy[i] = thip;
-   evaluate(thy, fp, nfe, lexf);
+   evaluate(*w.fun, w.shared, thy, fp, r.nfe, lexf);
    if (lexf > 0) {
        goto L70;
    }
    thy[i] = thim;
-   evaluate(thy, fm, nfe, lexf);
+   evaluate(*w.fun, w.shared, thy, fm, r.nfe, lexf);
    if (lexf <= 0) {
        goto L80;
    }
@@ -4272,7 +4597,7 @@ L70:
         // the current stepsize, put the stepsize halfway to the lower bound
         // and calculate a new delta theta based on this change.
 
-   my_data.maxf2_.impbnd = 1;
+   r.impbnd = 1;
 
         max_si = si;
 
@@ -4324,53 +4649,82 @@ L80:
    goto L40;
 
 L84:
-        // We have struck a bound.  This means that this value cannot have a
-        // valid second derivative or standard error.  We make sure of this
-        // by setting the delta theta to QNAN and then skipping over the
-        // later calculations.
+        // We have struck a bound.  The delta theta is QNAN, and thy(i) is
+        // left as it is.
 
-        h_ref(l,l) = numeric_limits<double>::quiet_NaN();
-        dthis[i] = numeric_limits<double>::quiet_NaN();
+        r.struck = 1;
+        r.si     = si;
+        r.dthi   = numeric_limits<double>::quiet_NaN();
+        r.thy    = thy[i];
 
-        lex = 3;
-
-        continue;
+        return;
 
 /* --RESTORE THY(I) AND SAVE CURRENT VALUE OF STEPSIZE FACTOR */
 
 L85:
         // restore the thy(i) and store stepsize and delta theta
 
-   my_data.maxf2_.stp[i] = si;
-        dthis[i] = dthi;
+   r.si   = si;
+   r.dthi = dthi;
 
    thy[i] = thi;
 
-/* --COMPUTE 2ND PARTIAL DERIVATIVES FOR (I,II) AND (II,I) PAIRS */
-/* --WHERE II < I */
+   r.thy  = thi;
 
-   if (i == 0) {
-       goto L360;
-   }
+} /* deriv2_step_ */
 
-   ll = -1;
-   for (int ii = 0; ii < i; ++ii) {
-       istii = my_data.maxf2_.ist[ii];
-       if (istii > 2)
-              continue;
+/// Computes the second partial derivative with respect to parameters i and
+/// ii (ii < i).  r.h must hold the current value of h(l,ll) on entry.
+/// thy[i] and thy[ii] are restored unless the parameters are stuck.
 
-       ++ll;
+void Maxfun::deriv2_cross_(deriv_worker& w, vector<double>& thy, int i, int ii,
+                           const deriv2_step& stepi, const deriv2_step& stepii,
+                           int ih, deriv2_result& r)
+{
+    /* Local variables */
+    double dthi;
+    int lexf;
+    double thii;
+    int isti;
+    int n;
+    double dthii;
+    int istii;
+    double prmuh;
+    int nl, nk;
+    double si;
+    int nm;
+    double e2d8;
+    int nbd[4];
+    double fmm = 0;
+    double fmp = 0;
+    double thi = 0;
+    double sii = 0;
+    double fpp = 0;
+    double fpm = 0;
+    double hn[3] = { 0., 0., 0. };
+
+    r.mirror   = 0;
+    r.roundoff = 0;
+    r.stuck    = 0;
+    r.impbnd   = 0;
+    r.nfe      = 0;
+
+    e2d8 = my_data.maxf1_.epsd * my_data.maxf1_.epsd / 8.;
+
+       isti = my_data.maxf2_.ist[i];
+       istii = my_data.maxf2_.ist[ii];
 
+       thi = thy[i];
        thii = thy[ii];
-       sii = my_data.maxf2_.stp[ii];
-       dthii = dthis[ii];
-       si = my_data.maxf2_.stp[i];
-       dthi = dthis[i];
+       sii = stepii.si;
+       dthii = stepii.dthi;
+       si = stepi.si;
+       dthi = stepi.dthi;
 
             // Skip this calculation if either quantity has a NaN as a
             // delta.  This indicates a parameter unable to calculate.
 
-            if(SAGE::isnan(dthi) || SAGE::isnan(dthii)) continue;
+            if(SAGE::isnan(dthi) || SAGE::isnan(dthii)) return;
 
 /* --IF BOTH INDEPENDENT PARAMETERS ARE INVOLVED IN FUNCTIONAL */
 /* --RELATIONSHIPS, CHECK ALL COMBINATIONS OF NEIGHBORING PARAMETE
@@ -4391,11 +4745,11 @@ L100:
        nm = 0;
        nk = 1;
 L120:
-       depar(thy, lexf);
+       lexf = w.fun->depar(thy);
        if (lexf <= 0) {
       goto L130;
        }
-       my_data.maxf2_.impbnd = 1;
+       r.impbnd = 1;
        nbd[nk - 1] = 1;
        ++nm;
 L130:
@@ -4446,7 +4800,7 @@ L190:
 L200:
        sii *= .5;
        if (sii < e2d8) {
-      goto L480;
+      goto L490;
        }
        dthii *= .5;
        si += si;
@@ -4477,7 +4831,7 @@ L230:
 L240:
        sii *= .5;
        if (sii < e2d8) {
-      goto L480;
+      goto L490;
        }
        dthii *= .5;
        goto L90;
@@ -4500,52 +4854,52 @@ L260:
 L270:
        thy[i] = thi + dthi;
        thy[ii] = thii + dthii;
-       evaluate(thy, fpp, nfe, lexf);
+       evaluate(*w.fun, w.shared, thy, fpp, r.nfe, lexf);
        if (lexf > 0) {
       goto L280;
        }
        thy[i] = thi - dthi;
 
-       evaluate(thy, fmp, nfe, lexf);
+       evaluate(*w.fun, w.shared, thy, fmp, r.nfe, lexf);
        if (lexf > 0) {
       goto L280;
        }
        thy[ii] = thii - dthii;
-       evaluate(thy, fmm, nfe, lexf);
+       evaluate(*w.fun, w.shared, thy, fmm, r.nfe, lexf);
        if (lexf > 0) {
       goto L280;
        }
        thy[i] = thi + dthi;
-       evaluate(thy, fpm, nfe, lexf);
+       evaluate(*w.fun, w.shared, thy, fpm, r.nfe, lexf);
        if (lexf <= 0) {
       goto L290;
        }
 L280:
-       my_data.maxf2_.impbnd = 1;
+       r.impbnd = 1;
        if (n > 0) {
-      goto L470;
+      goto L490;
        }
        si *= .5;
        if (si < e2d8) {
-      goto L470;
+      goto L490;
        }
        sii *= .5;
        if (sii < e2d8) {
-      goto L470;
+      goto L490;
        }
        dthi *= .5;
        dthii *= .5;
        goto L270;
 
 L290:
-       hn_ref(l, ll, n) = (fpp - fmp - fpm + fmm) / (dthi * 4. * dthii);
+       hn[n] = (fpp - fmp - fpm + fmm) / (dthi * 4. * dthii);
 
 /* --STORE FIRST APPROXIMATION IF ONLY DOING ONE */
 
        if (ih > 0) {
       goto L300;
        }
-       h_ref(l, ll) = hn_ref(l, ll, 0);
+       r.h = hn[0];
        goto L340;
 
 /* --PREPARE TO DO ANOTHER APPROXIMATION IF APPROPRIATE */
@@ -4558,8 +4912,7 @@ L300:
 
 /* --FIT DERIVATIVES FROM 3 APPROXIMATIONS */
 
-       fitder_(hn_ref(l, ll, 0), hn_ref(l, ll, 1), hn_ref(l, ll, 2),
-                    h_ref(l, ll), prmuh, lexf);
+       fitder_(hn[0], hn[1], hn[2], r.h, prmuh, lexf);
 
 /* --CHECK RESULTS OF 2ND DERIVATIVE ESTIMATION */
 
@@ -4587,27 +4940,58 @@ L320:
 /* --2ND DERIVATIVE */
 
 L330:
-       lrh_ref(l, ll) = 1;
-       lex = 1;
+       r.roundoff = 1;
 
 /* --COPY 2ND DERIVATIVE TO ELEMENT (LL,L) OF SYMMETRIC MATRIX */
 
 L340:
-       h_ref(ll, l) = h_ref(l, ll);
-
-/* --FINISH UP LOOP */
+       r.mirror = 1;
 
 /* --RESTORE ORIGINAL VALUES OF ITH, IITH PARAMETERS */
 
        thy[i] = thi;
        thy[ii] = thii;
-   }
+       return;
+
+/* --ERROR EXIT; PARAMETERS II AND I STUCK */
+
+L490:
+       r.stuck = 1;
+
+} /* deriv2_cross_ */
+
+/// Computes the second partial derivative with respect to parameter i.
+/// r.h must hold the current value of h(l,l) on entry.  thy[i] is restored
+/// unless the parameter is stuck.
+
+void Maxfun::deriv2_diag_(deriv_worker& w, vector<double>& thy, int i,
+                          const deriv2_step& stepi, int ih, deriv2_result& r)
+{
+    /* Local variables */
+    double dthi;
+    int lexf;
+    double prmuh;
+    double fm = 0;
+    double si;
+    int n;
+    double e2d8;
+    double fp = 0;
+    double thi = 0;
+    double hn[3] = { 0., 0., 0. };
+
+    r.mirror   = 0;
+    r.roundoff = 0;
+    r.stuck    = 0;
+    r.impbnd   = 0;
+    r.nfe      = 0;
+
+    e2d8 = my_data.maxf1_.epsd * my_data.maxf1_.epsd / 8.;
 
 /* --TAKE CARE OF (I,I) PAIR */
 
-L360:
-   si = my_data.maxf2_.stp[i];
-   dthi = dthis[i];
+   thi = thy[i];
+   si = stepi.si;
+   dthi = stepi.dthi;
 
         // Skip this calculation if delta theta is a NaN.  This indicates a
         // parameter unable to calculate.
@@ -4617,9 +5001,9 @@ L360:
           // Store a QNAN in the hessian matrix as well, so that we
           // know this is bad.
 
-          h_ref(l,l) = numeric_limits<double>::quiet_NaN();
+          r.h = numeric_limits<double>::quiet_NaN();
 
-          continue;
+          return;
         }
 
    prmuh = 999999.;
@@ -4629,17 +5013,17 @@ L360:
 
 L370:
    thy[i] = thi + dthi;
-   evaluate(thy, fp, nfe, lexf);
+   evaluate(*w.fun, w.shared, thy, fp, r.nfe, lexf);
    if (lexf > 0) {
        goto L380;
    }
    thy[i] = thi - dthi;
-   evaluate(thy, fm, nfe, lexf);
+   evaluate(*w.fun, w.shared, thy, fm, r.nfe, lexf);
    if (lexf <= 0) {
        goto L390;
    }
 L380:
-   my_data.maxf2_.impbnd = 1;
+   r.impbnd = 1;
    if (n > 0) {
        goto L490;
    }
@@ -4651,14 +5035,14 @@ L380:
    goto L370;
 
 L390:
-   hn_ref(l, l, n) = (fp - f - f + fm) / (dthi * dthi);
+   hn[n] = (fp - f - f + fm) / (dthi * dthi);
 
 /* --STORE FIRST APPROXIMATION IF ONLY DOING ONE */
 
    if (ih > 0) {
        goto L400;
    }
-   h_ref(l, l) = hn_ref(l, l, 0);
+   r.h = hn[0];
    goto L440;
 
 /* --PREPARE TO DO ANOTHER APPROXIMATION IF NECESSARY */
@@ -4671,8 +5055,7 @@ L400:
 
 /* --FIT DERIVATIVES FROM 3 APPROXIMATIONS */
 
-   fitder_(hn_ref(l, l, 0), hn_ref(l, l, 1), hn_ref(l, l, 2),
-      h_ref(l, l), prmuh, lexf);
+   fitder_(hn[0], hn[1], hn[2], r.h, prmuh, lexf);
 
 /* --CHECK RESULTS OF 2ND DERIVATIVE ESTIMATION */
 
@@ -4698,39 +5081,20 @@ L420:
 /* --2ND DERIVATIVE */
 
 L430:
-   lrh_ref(l, l) = 1;
-   lex = 1;
+   r.roundoff = 1;
 
 /* --RESTORE ORIGINAL VALUE OF I'TH PARAMETER */
 
 L440:
    thy[i] = thi;
-    }
-
-/* --PRINT H AND WARNINGS ABOUT ROUND-OFF ERRORS IN DETAIL FILE, IF ANY */
-
-    return 0;
-
-/* --ERROR EXIT; PARAMETERS II AND I STUCK */
-
-L470:
-    goto L490;
-
-/* --ERROR EXIT; PARAMETER II STUCK */
-
-L480:
+   return;
 
 /* --ERROR EXIT; PARAMETER I STUCK */
 
 L490:
-    lex = 2;
-    return 0;
-
-} /* deriv2_ */
+   r.stuck = 1;
 
-#undef lrh_ref
-#undef hn_ref
-#undef h_ref
+} /* deriv2_diag_ */
 
 int Maxfun::fitder_(double& d1, double& d2, double& d3,
                     double& dd, double& prmu, int& lex)
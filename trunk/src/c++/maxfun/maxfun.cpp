@@ -7,6 +7,19 @@ using namespace SAGE;
 MaxFunction::~MaxFunction()
 {}
 
+MaxFunction* MaxFunction::clone() const
+{
+  return NULL;
+}
+
+bool MaxFunction::is_thread_safe() const
+{
+  return false;
+}
+
+void MaxFunction::end_iteration()
+{ }
+
 Maxfun_Data::Maxfun_Data()
 {
   param_NP = param_NPV = 100;
@@ -105,6 +118,37 @@ void Maxfun::init()
 
   maxlst.resize      (my_data.param_NPV);
   kv = 0;
+
+  my_thread_count = 0;
+  my_deriv_serial = false;
+  my_deriv_pool   = NULL;
+}
+
+Maxfun::~Maxfun()
+{
+  clear_deriv_workers_();
+}
+
+void Maxfun::set_thread_count(size_t n)
+{
+  clear_deriv_workers_();
+
+  my_thread_count = n;
+}
+
+void Maxfun::clear_deriv_workers_()
+{
+  delete my_deriv_pool;
+
+  my_deriv_pool = NULL;
+
+  for(size_t i = 0; i < my_deriv_clones.size(); ++i)
+    delete my_deriv_clones[i];
+
+  my_deriv_clones.clear();
+  my_deriv_workers.clear();
+
+  my_deriv_serial = false;
 }
 
 const Maxfun_Data& Maxfun::get_results() const
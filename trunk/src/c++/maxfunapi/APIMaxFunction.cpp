@@ -1,4 +1,5 @@
 #include "maxfunapi/APIMaxFunction.h"
+#include "maxfunapi/Function.h"
 
 namespace SAGE   {
 namespace MAXFUN {
@@ -13,6 +14,8 @@ APIMaxFunction::APIMaxFunction(SAGE::MaxFunction & func, ParameterMgr & info, co
 {
   nfe      = 0;
   my_table = NULL;
+
+  my_iteration_ended = false;
 }
 
 //======================================================================
@@ -22,10 +25,47 @@ APIMaxFunction::APIMaxFunction(const APIMaxFunction & other) :
         SAGE::MaxFunction (other),
 	my_max_function   (other.my_max_function),
 	my_parameter_mgr  (other.my_parameter_mgr),
-	my_debug_cfg      (other.my_debug_cfg)
+	my_debug_cfg      (other.my_debug_cfg),
+	my_clone          (other.my_clone)
 {
   nfe      = other.nfe;
   my_table = other.my_table;
+
+  my_iteration_ended = other.my_iteration_ended;
+}
+
+//======================================================================
+// CLONE CONSTRUCTOR
+//======================================================================
+APIMaxFunction::APIMaxFunction(const APIMaxFunction & other, const boost::shared_ptr<SAGE::MaxFunction> & func, ParameterMgr & info) :
+	my_max_function   (*func),
+	my_parameter_mgr  (info),
+	my_debug_cfg      (other.my_debug_cfg),
+	my_clone          (func)
+{
+  nfe      = 0;
+  my_table = NULL;
+
+  my_iteration_ended = false;
+}
+
+//======================================================================
+// clone()
+//======================================================================
+SAGE::MaxFunction *
+APIMaxFunction::clone() const
+{
+  const Function * func = dynamic_cast<const Function *>(&my_max_function);
+
+  if(func == NULL || &func->getMgr() != &my_parameter_mgr)
+    return NULL;
+
+  boost::shared_ptr<SAGE::MaxFunction> copy(func->clone());
+
+  if(!copy)
+    return NULL;
+
+  return new APIMaxFunction(*this, copy, static_cast<Function &>(*copy).getMgr());
 }
 
 //============================================
@@ -46,7 +86,7 @@ APIMaxFunction::evaluate(vector<double> & params)
 { 
      if( (my_debug_cfg.getType() == SAGE::MAXFUN::DebugCfg::COMPLETE) && (my_debug_cfg.iter_end) )
        { 
-         if (Maxfun::iteration_ended) output_iteration_end_results();
+         if (my_iteration_ended) output_iteration_end_results();
        }
 
   // 1. Increment number of function evaluations:
@@ -115,6 +155,15 @@ APIMaxFunction::update_bounds(vector<double> & params)
 	return 0;
 }
 
+//======================================================================
+// end_iteration()
+//======================================================================
+void
+APIMaxFunction::end_iteration()
+{
+  my_iteration_ended = true;
+}
+
 //======================================================================
 // getParameterMgr()
 //======================================================================
@@ -140,7 +189,7 @@ void APIMaxFunction::output_iteration_end_results()
 
         }
 
-       Maxfun::iteration_ended = false;
+       my_iteration_ended = false;
 
        return;
 }
@@ -0,0 +1,244 @@
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <pthread.h>
+#include "boost/bind.hpp"
+#include "maxfunapi/maxfunapi.h"
+#include "util/ThreadPool.h"
+
+// Maximizes two normal likelihoods serially, concurrently, and with cloned
+// functions for the derivatives, and checks that the results agree.  Meant to
+// be run under a thread checker as well as on its own.
+//
+// Each maximization records the ParameterMgrs its function was evaluated
+// with.  A clone has its own ParameterMgr, so more than one shows that the
+// derivatives really were computed by clones on the other threads.
+
+namespace SAGE {
+
+typedef std::vector<double> sample;
+
+class evaluation_log
+{
+  public:
+
+    /// \param slow If true, each evaluation takes a little while, so that
+    ///             every worker gets a share of the derivatives.
+    explicit evaluation_log(bool slow) : my_slow(slow) { pthread_mutex_init(&my_mutex, NULL); }
+
+    ~evaluation_log() { pthread_mutex_destroy(&my_mutex); }
+
+    void record(const MAXFUN::ParameterMgr& mgr)
+    {
+      pthread_mutex_lock(&my_mutex);
+
+      my_mgrs.insert(&mgr);
+
+      pthread_mutex_unlock(&my_mutex);
+
+      if(my_slow)
+      {
+        timespec t = { 0, 200000 };
+
+        nanosleep(&t, NULL);
+      }
+    }
+
+    size_t mgr_count() const { return my_mgrs.size(); }
+
+  private:
+
+    evaluation_log(const evaluation_log&);
+    evaluation_log& operator=(const evaluation_log&);
+
+    bool                                   my_slow;
+    pthread_mutex_t                        my_mutex;
+    std::set<const MAXFUN::ParameterMgr*>  my_mgrs;
+};
+
+double logLikelihood(MAXFUN::ParameterMgr& mgr, const sample& x, evaluation_log& log)
+{
+  log.record(mgr);
+
+  double mean  = mgr.getParameter("global", "mean") .getCurrentEstimate(),
+         stdev = mgr.getParameter("global", "stdev").getCurrentEstimate();
+
+  double ll = 0.0;
+
+  for(size_t i = 0; i < x.size(); ++i)
+  {
+    double z = (x[i] - mean) / stdev;
+
+    ll -= 0.5 * z * z + std::log(stdev);
+  }
+
+  return ll;
+}
+
+struct estimates
+{
+  double value;
+  double mean;
+  double stdev;
+  double mean_se;
+
+  bool   clone_made;  ///< Whether the function gave a clone.
+  size_t mgr_count;   ///< The number of ParameterMgrs it was evaluated with.
+};
+
+estimates maximize(const sample& x, bool cloneable)
+{
+  MAXFUN::ParameterMgr mgr;
+  MAXFUN::Function     f(mgr);
+
+  mgr.addParameter("global", "mean",  MAXFUN::Parameter::INDEPENDENT, 1.0);
+  mgr.addParameter("global", "stdev", MAXFUN::Parameter::INDEPENDENT, 1.0, 0.01);
+
+  evaluation_log log(cloneable);
+
+  f.setEvaluator(boost::bind(logLikelihood, _1, boost::cref(x), boost::ref(log)));
+  f.setCloneable(cloneable);
+
+  estimates e;
+
+  SAGE::MaxFunction* clone = f.clone();
+
+  e.clone_made = clone != NULL;
+
+  delete clone;
+
+  MAXFUN::Results r = MAXFUN::Maximizer::maximize(f);
+
+  e.value   = r.getFinalFunctionValue();
+  e.mean    = r.getParameterMgr().getParameter("global", "mean") .getCurrentEstimate();
+  e.stdev   = r.getParameterMgr().getParameter("global", "stdev").getCurrentEstimate();
+  e.mean_se = r.getParameterMgr().getParameter("global", "mean") .getStdError();
+
+  e.mgr_count = log.mgr_count();
+
+  return e;
+}
+
+class MaximizeTask : public UTIL::ParallelTask
+{
+  public:
+
+    MaximizeTask(const std::vector<sample>& s, bool cloneable)
+      : samples(s), results(s.size()), my_cloneable(cloneable) { }
+
+    virtual void run(size_t item, size_t)
+    {
+      results[item] = maximize(samples[item], my_cloneable);
+    }
+
+    const std::vector<sample>& samples;
+    std::vector<estimates>     results;
+
+  private:
+
+    bool my_cloneable;
+};
+
+bool same(const estimates& a, const estimates& b)
+{
+  return a.value == b.value && a.mean == b.mean && a.stdev == b.stdev && a.mean_se == b.mean_se;
+}
+
+void print(const estimates& e)
+{
+  std::cout << std::fixed << std::setprecision(4)
+            << "  ln L = " << e.value << "  mean = " << e.mean << " (" << e.mean_se << ")"
+            << "  stdev = " << e.stdev << std::endl;
+}
+
+bool check(const char* name, const std::vector<estimates>& expected,
+                             const std::vector<estimates>& actual)
+{
+  bool ok = true;
+
+  for(size_t i = 0; i < expected.size(); ++i)
+    ok = ok && same(expected[i], actual[i]);
+
+  std::cout << name << (ok ? ": same" : ": DIFFERENT") << std::endl;
+
+  return ok;
+}
+
+/// Checks that the functions were cloned, and the clones evaluated, if and
+/// only if they were cloneable.
+bool check_clones(const char* name, const std::vector<estimates>& results, bool cloneable)
+{
+  bool ok = true;
+
+  for(size_t i = 0; i < results.size(); ++i)
+    ok = ok && results[i].clone_made == cloneable
+            && (results[i].mgr_count > 1) == cloneable;
+
+  std::cout << name << (ok ? ": yes" : ": NO") << std::endl;
+
+  return ok;
+}
+
+int go()
+{
+  std::vector<sample> samples(2);
+
+  for(size_t i = 0; i < 50; ++i)
+  {
+    samples[0].push_back(10.0 + 3.0 * std::sin(i * 1.7));
+    samples[1].push_back(-2.0 + 0.5 * std::cos(i * 0.9) + 0.01 * i);
+  }
+
+  bool ok = true;
+
+  // Serial maximizations are the reference.
+
+  UTIL::ThreadPool::set_default_thread_count(1);
+
+  std::vector<estimates> serial(samples.size());
+
+  for(size_t i = 0; i < samples.size(); ++i)
+  {
+    serial[i] = maximize(samples[i], false);
+    print(serial[i]);
+  }
+
+  UTIL::ThreadPool pool(2);
+
+  MaximizeTask concurrent(samples, false);
+
+  ok = pool.run(samples.size(), concurrent) && ok;
+  ok = check("Concurrent maximizations", serial, concurrent.results) && ok;
+  ok = check_clones("Uncloneable functions evaluated serially", concurrent.results, false) && ok;
+
+  // With more threads, each maximization evaluates its derivatives with
+  // clones of its function.
+
+  UTIL::ThreadPool::set_default_thread_count(3);
+
+  std::vector<estimates> cloned(samples.size());
+
+  for(size_t i = 0; i < samples.size(); ++i)
+    cloned[i] = maximize(samples[i], true);
+
+  ok = check("Cloned derivatives", serial, cloned) && ok;
+  ok = check_clones("Derivatives evaluated by clones", cloned, true) && ok;
+
+  MaximizeTask both(samples, true);
+
+  ok = pool.run(samples.size(), both) && ok;
+  ok = check("Concurrent maximizations with cloned derivatives", serial, both.results) && ok;
+  ok = check_clones("Concurrent derivatives evaluated by clones", both.results, true) && ok;
+
+  return ok ? 0 : 1;
+}
+
+} // End namespace SAGE
+
+int main()
+{
+  return SAGE::go();
+}
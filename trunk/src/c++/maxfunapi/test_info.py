@@ -25,3 +25,11 @@ class maxfunapi_tests (sagetest.SAGE_Test) :
     self.epsilon = 0.0001
     self.delta = 0.01
     self.execute()
+
+  def test_concurrent(self):
+    'Test concurrent maximizations'
+    self.cmd = "test_concurrent > out"
+    self.file_names = ['out']
+    self.epsilon = 0.0001
+    self.delta = 0.01
+    self.execute()
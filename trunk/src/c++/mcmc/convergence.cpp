@@ -0,0 +1,221 @@
+//==========================================================================
+//  File:       convergence.cpp
+//
+//  History:    10/17/26 - created.
+//
+//  Notes:      This file implements convergence diagnostics for sets of
+//              independent MCMC chains.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "mcmc/convergence.h"
+
+namespace SAGE
+{
+
+namespace MCMC
+{
+
+namespace
+{
+
+// Within chain variance, W, and the estimate of the marginal posterior
+// variance, var+.  Returns false if the chains are too short.
+//
+bool
+chain_variances(const std::vector<std::vector<double> >& chains, double& W, double& var_plus)
+{
+  size_t m = chains.size();
+  size_t n = m ? chains[0].size() : 0;
+
+  if( m < 2 || n < 2 )
+    return false;
+
+  std::vector<double> means(m, 0.0);
+
+  double grand_mean = 0.0;
+
+  W = 0.0;
+
+  for( size_t j = 0; j < m; ++j )
+  {
+    for( size_t i = 0; i < n; ++i )
+      means[j] += chains[j][i];
+
+    means[j] /= n;
+
+    double s2 = 0.0;
+
+    for( size_t i = 0; i < n; ++i )
+      s2 += (chains[j][i] - means[j]) * (chains[j][i] - means[j]);
+
+    W          += s2 / (n - 1);
+    grand_mean += means[j];
+  }
+
+  W          /= m;
+  grand_mean /= m;
+
+  double B_over_n = 0.0;
+
+  for( size_t j = 0; j < m; ++j )
+    B_over_n += (means[j] - grand_mean) * (means[j] - grand_mean);
+
+  B_over_n /= (m - 1);
+
+  var_plus = (n - 1) * W / n + B_over_n;
+
+  return true;
+}
+
+}
+
+double
+potential_scale_reduction(const std::vector<std::vector<double> >& chains)
+{
+  double W, var_plus;
+
+  if( !chain_variances(chains, W, var_plus) )
+    return std::numeric_limits<double>::infinity();
+
+  // Chains which never move are converged only if they agree.
+
+  if( W <= 0.0 )
+    return var_plus <= 0.0 ? 1.0 : std::numeric_limits<double>::infinity();
+
+  return sqrt(var_plus / W);
+}
+
+double
+effective_sample_size(const std::vector<std::vector<double> >& chains)
+{
+  double W, var_plus;
+
+  if( !chain_variances(chains, W, var_plus) )
+    return 0.0;
+
+  size_t m = chains.size();
+  size_t n = chains[0].size();
+
+  if( var_plus <= 0.0 )
+    return (double) (m * n);
+
+  // rho(t) = 1 - V(t) / (2 var+), where V(t) is the variogram at lag t.
+  // Autocorrelations are summed in pairs while the pair sums are positive.
+
+  std::vector<double> rho(n, 0.0);
+
+  for( size_t t = 1; t < n; ++t )
+  {
+    double V = 0.0;
+
+    for( size_t j = 0; j < m; ++j )
+      for( size_t i = t; i < n; ++i )
+        V += (chains[j][i] - chains[j][i - t]) * (chains[j][i] - chains[j][i - t]);
+
+    V /= m * (n - t);
+
+    rho[t] = 1.0 - V / (2.0 * var_plus);
+  }
+
+  double rho_sum = 0.0;
+
+  for( size_t t = 1; t + 1 < n; t += 2 )
+  {
+    double pair_sum = rho[t] + rho[t + 1];
+
+    if( pair_sum < 0.0 )
+      break;
+
+    rho_sum += pair_sum;
+  }
+
+  return (m * n) / (1.0 + 2.0 * rho_sum);
+}
+
+// ------------------------------------------------------
+// Implementation of chain_diagnostics
+// ------------------------------------------------------
+
+size_t
+chain_diagnostics::draw_count() const
+{
+  if( !statistic_count() || !chain_count() )
+    return 0;
+
+  size_t n = (size_t) -1;
+
+  for( size_t s = 0; s < my_draws.size(); ++s )
+    for( size_t j = 0; j < my_draws[s].size(); ++j )
+      n = std::min(n, my_draws[s][j].size());
+
+  return n;
+}
+
+bool
+chain_diagnostics::get_draws(size_t statistic, chain_vector& draws) const
+{
+  size_t n = draw_count();
+
+  const chain_vector& chains = my_draws[statistic];
+
+  draws.resize(chains.size());
+
+  for( size_t j = 0; j < chains.size(); ++j )
+  {
+    draws[j].assign(chains[j].begin(), chains[j].begin() + n);
+
+    for( size_t i = 0; i < n; ++i )
+      if( !finite(draws[j][i]) )
+        return false;
+  }
+
+  return true;
+}
+
+double
+chain_diagnostics::max_scale_reduction() const
+{
+  double r_max = 0.0;
+  bool   found = false;
+
+  chain_vector draws;
+
+  for( size_t s = 0; s < statistic_count(); ++s )
+  {
+    if( !get_draws(s, draws) )
+      continue;
+
+    r_max = std::max(r_max, potential_scale_reduction(draws));
+    found = true;
+  }
+
+  return found ? r_max : std::numeric_limits<double>::infinity();
+}
+
+double
+chain_diagnostics::min_effective_size() const
+{
+  double n_min = std::numeric_limits<double>::infinity();
+
+  chain_vector draws;
+
+  for( size_t s = 0; s < statistic_count(); ++s )
+  {
+    if( !get_draws(s, draws) )
+      continue;
+
+    n_min = std::min(n_min, effective_sample_size(draws));
+  }
+
+  return finite(n_min) ? n_min : 0.0;
+}
+
+} // end of namespace MCMC
+
+} // end of namespace SAGE
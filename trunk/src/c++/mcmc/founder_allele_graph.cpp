@@ -211,8 +211,8 @@ FounderAlleleGraph::calculate_likelihood() const
   // Initialize a vector to include which nodes have been already incorporated
   // into the likelihood.
 
-  static std::vector<bool>     used_nodes;
-  static std::vector<AlleleID> node_alleles;
+  std::vector<bool>&     used_nodes   = my_used_nodes;
+  std::vector<AlleleID>& node_alleles = my_node_alleles;
 
   used_nodes.clear();
   node_alleles.clear();
@@ -639,12 +639,12 @@ bool FounderAlleleGraph::validate() const
   // Validity checking actually checks each node for internal and external consistency.
   // We do this by keeping track of the nodes that have been validated and the
   // allele state we assigned them while doing validation.  This information is
-  // stored in the static validated_nodes vector.  Since we only call validate
-  // once at a time, we can use a static structure here.  This will avoid a lot
-  // of memory overhead.
+  // stored in the validated_nodes vector.  Since we only call validate
+  // once at a time, we can reuse the graph's scratch storage here.  This will
+  // avoid a lot of memory overhead.
 
-  static std::vector<bool>     validated_nodes;
-  static std::vector<AlleleID> node_alleles;
+  std::vector<bool>&     validated_nodes = my_used_nodes;
+  std::vector<AlleleID>& node_alleles    = my_node_alleles;
 
   validated_nodes.clear();
   node_alleles   .clear();
@@ -716,8 +716,8 @@ FounderAlleleGraph::validate_node
       // We must store the current valid state so that, should the first allele not
       // pass, we can restore it
 
-      static std::vector<bool>     current_validated_nodes;
-      static std::vector<AlleleID> current_node_alleles;
+      std::vector<bool>&     current_validated_nodes = my_saved_used_nodes;
+      std::vector<AlleleID>& current_node_alleles    = my_saved_node_alleles;
 
       current_validated_nodes = validated_nodes;
       current_node_alleles    = node_alleles;
@@ -1173,8 +1173,8 @@ FounderAlleleGraph::calculate_founder_allele_patterns() const
   
   // Initialize vectors to include which nodes have been used and their states
 
-  static std::vector<bool>     used_nodes;
-  static std::vector<AlleleID> node_alleles;
+  std::vector<bool>&     used_nodes   = my_used_nodes;
+  std::vector<AlleleID>& node_alleles = my_node_alleles;
 
   used_nodes  .clear();
   node_alleles.clear();
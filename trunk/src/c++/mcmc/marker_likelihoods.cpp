@@ -28,8 +28,10 @@ namespace MCMC
 
 marker_likelihood_calculator::marker_likelihood_calculator(const pedigree_region&  pr,
                                                            const McmcMeiosisMap& mmap,
-                                                           mcmc_data_accessor&     dat)
-  : my_cache_data(pr.get_region().locus_count()),
+                                                           mcmc_data_accessor&     dat,
+                                                           size_t                  cache_sets,
+                                                           size_t                  cache_ways)
+  : my_caches(pr.get_region().locus_count(), cache_type(cache_sets, cache_ways)),
     my_graphs(pr.get_region().locus_count()),
     my_region(pr),
     my_data(&dat)
@@ -59,6 +61,19 @@ marker_likelihood_calculator::dump_graphs(ostream& o) const
   }
 }
 
+void
+marker_likelihood_calculator::dump_cache_statistics(ostream& o) const
+{
+  for(size_t i = 0; i < my_caches.size(); ++i)
+  {
+    o << "Marker " << i << ": "
+      << my_caches[i].size()      << " of " << my_caches[i].capacity() << " entries used, "
+      << my_caches[i].hits()      << " hits, "
+      << my_caches[i].misses()    << " misses, "
+      << my_caches[i].evictions() << " evictions" << endl;
+  }
+}
+
 } // end of namespace MCMC
 
 } // end of namespace SAGE
@@ -46,6 +46,10 @@ mcmc_parameters::mcmc_parameters()
   my_batch_factor          = 30;
   
   my_random_seed           = 0;
+
+  my_chain_count           = 1;
+  my_thread_count          = 0;
+  my_convergence_threshold = 0.0;
 }
 
 mcmc_parameters::mcmc_parameters(const mcmc_parameters& p)
@@ -71,6 +75,10 @@ mcmc_parameters::mcmc_parameters(const mcmc_parameters& p)
   my_batch_factor          = p.my_batch_factor;
   
   my_random_seed           = p.my_random_seed;
+
+  my_chain_count           = p.my_chain_count;
+  my_thread_count          = p.my_thread_count;
+  my_convergence_threshold = p.my_convergence_threshold;
 }
 
 mcmc_parameters&
@@ -98,6 +106,10 @@ mcmc_parameters::operator=(const mcmc_parameters& p)
   
   my_random_seed           = p.my_random_seed;
 
+  my_chain_count           = p.my_chain_count;
+  my_thread_count          = p.my_thread_count;
+  my_convergence_threshold = p.my_convergence_threshold;
+
   return *this;
 }
 
@@ -143,6 +155,14 @@ mcmc_parameters::dump_parameters(ostream& out) const
   if(my_random_seed)
     o << "random seed:           " << my_random_seed << endl;
 
+  o << "chains:                " << my_chain_count << endl;
+
+  if(my_thread_count)
+    o << "threads:               " << my_thread_count << endl;
+
+  if(my_convergence_threshold)
+    o << "convergence_threshold: " << my_convergence_threshold << endl;
+
   o << endl;
 }
 
@@ -168,6 +168,18 @@ void mcmc_parser::parse_test_parameter(const LSFBase* param)
   {
     parse_random_seed(param);
   }
+  else if(n == "CHAINS" || n == "CHAIN_COUNT")
+  {
+    parse_chains(param);
+  }
+  else if(n == "THREADS")
+  {
+    parse_threads(param);
+  }
+  else if(n == "CONVERGENCE_THRESHOLD" || n == "RHAT_THRESHOLD")
+  {
+    parse_convergence(param);
+  }
 }
 
 void
@@ -321,6 +333,51 @@ void mcmc_parser::parse_random_seed(const LSFBase* param)
   my_parameters.set_random_seed(i);
 }
 
+void mcmc_parser::parse_chains(const LSFBase* param)
+{
+  int i = my_parameters.get_chain_count();
+
+  parse_integer(param, i);
+
+  if( i < 1 || !my_parameters.set_chain_count(i) )
+  {
+    errors << priority(error) << "Invalid value '" << i
+           << "' for parameter 'chains'.  Using "
+           << my_parameters.get_chain_count() << "." << endl;
+  }
+}
+
+void mcmc_parser::parse_threads(const LSFBase* param)
+{
+  int i = my_parameters.get_thread_count();
+
+  parse_integer(param, i);
+
+  if( i < 0 )
+  {
+    errors << priority(error) << "Invalid value '" << i
+           << "' for parameter 'threads'.  Using the program default." << endl;
+
+    i = 0;
+  }
+
+  my_parameters.set_thread_count(i);
+}
+
+void mcmc_parser::parse_convergence(const LSFBase* param)
+{
+  double d = my_parameters.get_convergence_threshold();
+
+  parse_real(param, d);
+
+  if( !my_parameters.set_convergence_threshold(d) )
+  {
+    errors << priority(error) << "Invalid value '" << d
+           << "' for parameter 'convergence_threshold'.  It must be greater"
+           << " than 1, or 0 to run every batch." << endl;
+  }
+}
+
 } // end of namespace MCMC
 
 } // end of namespace SAGE
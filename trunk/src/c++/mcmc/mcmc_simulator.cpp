@@ -25,11 +25,17 @@ namespace SAGE
 namespace MCMC
 {
 
+// Spacing of the seeds of the chains of a pedigree.  Larger than any
+// pedigree index, so chains of different pedigrees don't share seeds.
+//
+static const unsigned long CHAIN_SEED_STRIDE = 1000003;
+
 mcmc_simulator::mcmc_simulator
     (const McmcMeiosisMap&   ped,
      const pedigree_region&  ped_region,
      mcmc_parameters*        param,
-     cerrorstream&           err)
+     cerrorstream&           err,
+     size_t                  chain)
   : my_pedigree(ped),
     my_ped_region(ped_region),
   
@@ -50,7 +56,14 @@ mcmc_simulator::mcmc_simulator
   if(param->get_random_seed())
   {
     my_random_generator.reseed(param->get_random_seed() +
-       ped.get_subpedigree().member_index(0).mpindex());
+       ped.get_subpedigree().member_index(0).mpindex() + chain * CHAIN_SEED_STRIDE);
+  }
+  else if(chain)
+  {
+    // Chains created in the same second would otherwise share the clock's
+    // seed.
+
+    my_random_generator.reseed(time(NULL) + chain * CHAIN_SEED_STRIDE);
   }
   
   my_parameters = param;
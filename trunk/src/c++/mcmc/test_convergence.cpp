@@ -0,0 +1,115 @@
+#include "mcmc/convergence.h"
+
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <iomanip>
+
+// This program tests the convergence diagnostics on small chains whose
+// R-hat is known in closed form.  With n draws per chain, within chain
+// variance W and between chain variance B,
+//
+//   R-hat = sqrt( ((n-1)/n W + B/n) / W ).
+//
+// Identical chains have B = 0, so R-hat = sqrt((n-1)/n).  The chains
+// 1,2,3,4 and 3,4,5,6 have W = 5/3 and B/n = 2, so R-hat = sqrt(1.95).
+
+using namespace SAGE::MCMC;
+
+typedef std::vector<double>       chain;
+typedef std::vector<chain>        chain_set;
+
+int failures = 0;
+
+chain make_chain(double first, size_t n)
+{
+  chain c;
+
+  for( size_t i = 0; i < n; ++i )
+    c.push_back(first + i);
+
+  return c;
+}
+
+void check(const std::string& name, double value, double expected)
+{
+  bool ok;
+
+  if( expected == std::numeric_limits<double>::infinity() )
+    ok = value == expected;
+  else
+    ok = std::fabs(value - expected) <= 1e-12 * (1.0 + std::fabs(expected));
+
+  if( !ok )
+    ++failures;
+
+  std::cout << (ok ? "ok    " : "FAILED") << "  " << std::left << std::setw(34) << name
+            << std::right << std::setw(12) << value << std::endl;
+}
+
+int main()
+{
+  const double inf = std::numeric_limits<double>::infinity();
+
+  std::cout << std::fixed << std::setprecision(6);
+
+  chain_set identical(3, make_chain(1.0, 4));
+
+  chain_set shifted;
+  shifted.push_back(make_chain(1.0, 4));
+  shifted.push_back(make_chain(3.0, 4));
+
+  chain_set constant(2, chain(5, 2.0));
+
+  chain_set constant_apart;
+  constant_apart.push_back(chain(5, 2.0));
+  constant_apart.push_back(chain(5, 3.0));
+
+  chain_set too_short(2, make_chain(1.0, 1));
+  chain_set one_chain(1, make_chain(1.0, 4));
+
+  check("R-hat, identical chains",          potential_scale_reduction(identical),      std::sqrt(0.75));
+  check("R-hat, shifted chains",            potential_scale_reduction(shifted),        std::sqrt(1.95));
+  check("R-hat, constant equal chains",     potential_scale_reduction(constant),       1.0);
+  check("R-hat, constant unequal chains",   potential_scale_reduction(constant_apart), inf);
+  check("R-hat, one draw per chain",        potential_scale_reduction(too_short),      inf);
+  check("R-hat, one chain",                 potential_scale_reduction(one_chain),      inf);
+
+  check("ESS, constant equal chains",       effective_sample_size(constant),           10.0);
+  check("ESS, one draw per chain",          effective_sample_size(too_short),          0.0);
+
+  // chain_diagnostics:  statistic 0 is identical in both chains, statistic
+  // 1 is shifted, and statistic 2 has a missing draw, so it is skipped.
+  // The second chain has an extra draw, which is not used.
+
+  chain_diagnostics diag(2, 3);
+
+  for( size_t i = 0; i < 4; ++i )
+  {
+    diag.add_draw(0, 0, 1.0 + i);
+    diag.add_draw(1, 0, 1.0 + i);
+
+    diag.add_draw(0, 1, 1.0 + i);
+    diag.add_draw(1, 1, 3.0 + i);
+
+    diag.add_draw(0, 2, i == 2 ? std::numeric_limits<double>::quiet_NaN() : 100.0 * i);
+    diag.add_draw(1, 2, 0.0);
+  }
+
+  diag.add_draw(1, 0, 1000.0);
+  diag.add_draw(1, 1, 1000.0);
+  diag.add_draw(1, 2, 1000.0);
+
+  std::cout << std::endl << "Draws: " << diag.draw_count() << std::endl;
+
+  check("Largest R-hat",                    diag.max_scale_reduction(),                std::sqrt(1.95));
+
+  chain_diagnostics empty(2, 1);
+
+  check("Largest R-hat, no draws",          empty.max_scale_reduction(),               inf);
+  check("Smallest ESS, no draws",           empty.min_effective_size(),                0.0);
+
+  std::cout << std::endl << failures << " failures." << std::endl;
+
+  return failures ? 1 : 0;
+}
@@ -27,6 +27,9 @@ TESTS = { 'test0'        : ('test_mcmc par ped mld gen > out',
           'test1'        : ('test_mcmc par ped mld gen > out',
                            ['out'],
                             'marker_likelihhods test'),
+          'test_convergence' : ('test_convergence > out',
+                           ['out'],
+                            'convergence diagnostics test'),
         }
 
 
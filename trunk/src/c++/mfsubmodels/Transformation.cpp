@@ -1,8 +1,74 @@
+#include <cstring>
+#include <stdint.h>
 #include "mfsubmodels/Transformation.h"
 
 namespace SAGE        {
 namespace MFSUBMODELS {
 
+// - Sets y[i] = exp(a * x[i]).  The loop has no branches or calls, so that
+//   the compiler vectorizes it: 2^k is built in the exponent bits and e^r,
+//   |r| <= ln(2)/2, is a degree 12 Taylor polynomial, accurate to a few
+//   units in the last place.  Arguments outside the range of normal results
+//   give garbage in the loop and are redone with exp() afterward.  (Clamping
+//   them in the loop would keep it from vectorizing.)
+//
+static void exp_batch(double* y, const double* x, double a, size_t n)
+{
+  const double lo    = -708.0;
+  const double hi    =  709.0;
+  const double log2e =  1.4426950408889634;
+  const double ln2hi =  6.93147180369123816490e-01;
+  const double ln2lo =  1.90821492927058770002e-10;
+  const double shift =  6755399441055744.0;          // 1.5 * 2^52
+
+  const uint64_t one = UINT64_C(0x3ff0000000000000);
+
+  for(size_t i = 0; i < n; ++i)
+  {
+    double v = a * x[i];
+
+    // k = round(v / ln 2), in the low bits of kd.
+    double   kd = v * log2e + shift;
+    uint64_t kb;
+
+    std::memcpy(&kb, &kd, sizeof(kb));
+
+    kd -= shift;
+
+    double r = (v - kd * ln2hi) - kd * ln2lo;
+
+    double p = 1.0 / 479001600.0;
+
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    uint64_t sb = (kb << 52) + one;
+    double   scale;
+
+    std::memcpy(&scale, &sb, sizeof(scale));
+
+    y[i] = p * scale;
+  }
+
+  for(size_t i = 0; i < n; ++i)
+  {
+    double v = a * x[i];
+
+    if(!(v > lo && v < hi) && !SAGE::isnan(v))
+      y[i] = exp(v);
+  }
+}
+
 /// Parses an LSFBase object and returns the Configuration object
 ///
 /// \param param The LSFBase object to be parsed
@@ -319,6 +385,176 @@ bool Transformation::Facade::transform(double & trait) const
   return (this->*my_transf_fcn)(trait);
 }
 
+///
+/// Calculates the geometric mean of a TraitColumn.  The shifted logarithms
+/// are only recomputed if lambda2 or the values have changed.
+///
+/// \param traits The values.
+/// \param calculate If false, the geometric mean is set to 1.
+/// \retval true The geometric mean was calculated.
+/// \retval false The geometric mean could not be calculated.
+bool Transformation::Facade::calculate_geometric_mean(TraitColumn& traits, bool calculate)
+{
+  if(!calculate)
+  {
+    my_geom_mean = 1.0;
+    return  true;
+  }
+
+  if(my_type == NONE)
+    return true;
+
+  update_logs(traits, get_lambda2());
+
+  my_geom_mean = exp(traits.my_log_geom_mean);
+
+  return !SAGE::isnan(my_geom_mean);
+}
+
+///
+/// Transforms a TraitColumn.  Values which are not included are copied.
+/// NOTE: The geometric mean must have been calculated first.
+///
+/// \param traits The values which will be transformed.
+/// \param transformed The transformed values.
+/// \retval true Transformation was successful.
+/// \retval false Transformation was \b not successful.
+bool Transformation::Facade::transform(TraitColumn& traits, std::vector<double>& transformed) const
+{
+  transformed = traits.my_traits;
+
+  if(my_type == NONE)
+    return true;
+
+  double lambda1 = get_lambda1();
+
+  update_logs(traits, get_lambda2());
+
+  const size_t  n    = traits.size();
+  const double* logs = n ? &traits.my_logs[0] : NULL;
+  double*       t    = n ? &transformed[0]    : NULL;
+
+  // The loops have no branches, so that they vectorize (see exp_batch()).
+  // The values which are not included are restored afterward.
+
+  if(my_type == BOX_COX)
+  {
+    if(lambda1 < 1e-10)
+    {
+      for(size_t i = 0; i < n; ++i)
+        t[i] = my_geom_mean * logs[i];
+    }
+    else
+    {
+      double scale = 1.0 / (lambda1 * pow(my_geom_mean, lambda1 - 1.0));
+
+      exp_batch(t, logs, lambda1, n);
+
+      for(size_t i = 0; i < n; ++i)
+        t[i] = (t[i] - 1.0) * scale;
+    }
+  }
+  else
+  {
+    const double* signs = n ? &traits.my_signs[0] : NULL;
+
+    if(abs(lambda1) < 1e-10)
+    {
+      for(size_t i = 0; i < n; ++i)
+        t[i] = signs[i] * my_geom_mean * logs[i];
+    }
+    else
+    {
+      double scale = 1.0 / (lambda1 * pow(my_geom_mean, lambda1 - 1.0));
+
+      exp_batch(t, logs, lambda1, n);
+
+      for(size_t i = 0; i < n; ++i)
+        t[i] = signs[i] * (t[i] - 1.0) * scale;
+    }
+  }
+
+  // A value which can't be transformed (it is NaN, or negative after
+  // shifting for Box-Cox) has a NaN logarithm, and so a NaN result.
+
+  for(size_t i = 0; i < n; ++i)
+  {
+    if(!traits.my_included[i])
+      t[i] = traits.my_traits[i];
+    else if(SAGE::isnan(t[i]))
+      return false;
+  }
+
+  return true;
+}
+
+// - Computes the shifted logarithms of the values and the logarithm of their
+//   geometric mean, unless they are already computed for this lambda2.
+//
+void Transformation::Facade::update_logs(TraitColumn& traits, double lambda2) const
+{
+  if(traits.my_cached && traits.my_type == my_type && traits.my_lambda2 == lambda2)
+    return;
+
+  const size_t n = traits.size();
+
+  traits.my_logs.resize(n);
+
+  size_t adj_trait_count = 0;
+  double log_sum         = 0.0;
+  bool   valid           = true;
+
+  if(my_type == BOX_COX)
+  {
+    traits.my_signs.clear();
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      double shifted_t = traits.my_traits[i] + lambda2;
+
+      // NaN if the value is NaN or negative after shifting.
+      traits.my_logs[i] = shifted_t < 0.0 ? QNAN : log(shifted_t);
+
+      if(!SAGE::isnan(traits.my_traits[i]))
+      {
+        ++adj_trait_count;
+
+        // If any value is not positive after shifting, the geometric mean
+        // can't be calculated.
+        if(shifted_t <= 0)
+          valid = false;
+        else
+          log_sum += traits.my_logs[i];
+      }
+    }
+  }
+  else
+  {
+    traits.my_signs.resize(n);
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      double shifted_t = traits.my_traits[i] + lambda2;
+
+      traits.my_logs[i]  = log(abs(shifted_t) + 1);
+      traits.my_signs[i] = shifted_t < 0.0 ? -1.0 : (shifted_t == 0 ? 0.0 : 1.0);
+
+      if(!SAGE::isnan(traits.my_traits[i]))
+      {
+        ++adj_trait_count;
+
+        log_sum += traits.my_logs[i];
+      }
+    }
+  }
+
+  traits.my_log_geom_mean = valid && adj_trait_count ? log_sum / adj_trait_count : QNAN;
+
+  traits.my_cached  = true;
+  traits.my_type    = my_type;
+  traits.my_lambda2 = lambda2;
+}
+
 bool Transformation::Facade::calculate_geom_mean_none
       (const std::vector<double>& trait)
 {
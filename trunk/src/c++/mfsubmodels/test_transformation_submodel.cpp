@@ -209,6 +209,77 @@ void testM1()
   MAXFUN::Maximizer::maximize(f);
 }
 
+// Transforms the same values one at a time and as a TraitColumn, for each
+// model and several lambdas, and checks that they agree.
+void testC1()
+{
+  std::vector<double> v;
+
+  for(size_t i = 0; i < 20; ++i)
+    v.push_back(0.5 + 0.37 * i);
+
+  v[3] = QNAN;
+
+  std::vector<bool> included(v.size(), true);
+
+  included[3] = false;
+  included[7] = false;
+
+  MFSUBMODELS::Transformation::TransformationType types[] =
+    { MFSUBMODELS::Transformation::BOX_COX, MFSUBMODELS::Transformation::GEORGE_ELSTON };
+
+  double lambda1s[] = { 1.0, 0.5, 0.0, -0.7 };
+  double lambda2s[] = { 0.0, 0.0, 2.0, -0.25 };
+
+  for(size_t t = 0; t < 2; ++t)
+  {
+    MAXFUN::ParameterMgr m;
+    MAXFUN::Function     f(m);
+
+    MFSUBMODELS::Transformation::Configuration transf_config;
+    transf_config.set_type(types[t]);
+
+    MFSUBMODELS::Transformation::Facade    facade(transf_config, f);
+    MFSUBMODELS::Transformation::TraitColumn column(v, included);
+
+    bool same = true;
+
+    for(size_t l = 0; l < 4; ++l)
+    {
+      m.getParameter("Transformation", "Lambda1").setCurrentEstimate(lambda1s[l]);
+      m.getParameter("Transformation", "Lambda2").setCurrentEstimate(lambda2s[l]);
+
+      std::vector<double> expected = v;
+
+      facade.calculate_geometric_mean(v);
+
+      double geom_mean = facade.geometric_mean();
+
+      for(size_t i = 0; i < v.size(); ++i)
+        if(included[i])
+          facade.transform(expected[i]);
+
+      std::vector<double> actual;
+
+      facade.calculate_geometric_mean(column);
+      facade.transform(column, actual);
+
+      same = same && fabs(facade.geometric_mean() - geom_mean) <= 1e-12 * fabs(geom_mean);
+
+      for(size_t i = 0; i < v.size(); ++i)
+      {
+        if(SAGE::isnan(expected[i]))
+          same = same && SAGE::isnan(actual[i]);
+        else
+          same = same && fabs(actual[i] - expected[i]) <= 1e-12 * (1.0 + fabs(expected[i]));
+      }
+    }
+
+    std::cout << (t ? "George-Elston" : "Box-Cox") << " column transformation: "
+              << (same ? "same" : "DIFFERENT") << std::endl;
+  }
+}
+
 void test2()
 {
   LSFInit();
@@ -218,6 +289,8 @@ void test2()
   testP3();
 
   testM1();
+
+  testC1();
 }
 
 
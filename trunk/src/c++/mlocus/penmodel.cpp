@@ -17,6 +17,8 @@
 #endif
 
 #include <iostream>
+#include <iterator>
+#include <cstring>
 #include "mlocus/penmodel.h"
  
 namespace SAGE   {
@@ -1079,6 +1081,287 @@ penetrance_model::penetrance_informative_phenotype(uint id) const
     return false;
 }
 
+//============================================================================
+//  IMPLEMENTATION: binary images
+//============================================================================
+//
+namespace {
+
+typedef penetrance_matrix<int,int> image_matrix;
+
+void
+write_matrix_image(UTIL::BinaryImageWriter& out, const image_matrix& m)
+{
+    uint64_t count = std::distance(m.elements_begin(), m.elements_end());
+
+    out.put_uint64(count);
+
+    for(image_matrix::element_iterator i = m.elements_begin(); i != m.elements_end(); ++i)
+    {
+        out.put_int(i->first.row);
+        out.put_int(i->first.col);
+        out.put_double(i->second);
+    }
+
+    count = std::distance(m.set_defaults_begin(), m.set_defaults_end());
+
+    out.put_uint64(count);
+
+    for(image_matrix::element_iterator i = m.set_defaults_begin(); i != m.set_defaults_end(); ++i)
+    {
+        out.put_int(i->first.row);
+        out.put_int(i->first.col);
+    }
+}
+
+void
+read_matrix_image(UTIL::BinaryImageReader& in, image_matrix& m)
+{
+    uint64_t count = in.get_uint64();
+
+    for(uint64_t i = 0; i < count && in.good(); ++i)
+    {
+        int    row = in.get_int();
+        int    col = in.get_int();
+        double val = in.get_double();
+
+        //lint -e{534}
+        m.set(row, col, val);
+    }
+
+    count = in.get_uint64();
+
+    for(uint64_t i = 0; i < count && in.good(); ++i)
+    {
+        int row = in.get_int();
+        int col = in.get_int();
+
+        //lint -e{534}
+        m.set(row, col, m.default_value());
+    }
+}
+
+void
+write_bools_image(UTIL::BinaryImageWriter& out, const std::vector<bool>& v)
+{
+    out.put_uint64(v.size());
+
+    for(size_t i = 0; i < v.size(); ++i)
+        out.put_bool(v[i]);
+}
+
+void
+read_bools_image(UTIL::BinaryImageReader& in, std::vector<bool>& v)
+{
+    uint64_t n = in.get_uint64();
+
+    v.clear();
+
+    for(uint64_t i = 0; i < n && in.good(); ++i)
+        v.push_back(in.get_bool());
+}
+
+void
+write_names_image(UTIL::BinaryImageWriter& out, const std::map<string, uint>& names)
+{
+    out.put_uint64(names.size());
+
+    for(std::map<string, uint>::const_iterator i = names.begin(); i != names.end(); ++i)
+    {
+        out.put_string(i->first);
+        out.put_uint32(i->second);
+    }
+}
+
+void
+read_names_image(UTIL::BinaryImageReader& in, std::map<string, uint>& names)
+{
+    uint64_t n = in.get_uint64();
+
+    for(uint64_t i = 0; i < n && in.good(); ++i)
+    {
+        string name = in.get_string();
+
+        names[name] = in.get_uint32();
+    }
+}
+
+}
+
+void
+penetrance_model::write_image(UTIL::BinaryImageWriter& out) const
+{
+    out.put_string(my_info->name);
+
+    // Genotype model
+
+    const PRIVATE::genotype_model_info& g = *my_info->gmodel.my_info;
+
+    out.put_string(g.name);
+    out.put_bytes (g.separators, sizeof(g.separators));
+    out.put_string(g.missing_allele_name);
+    out.put_bool  (g.dynamic_alleles);
+    out.put_int   (g.my_type);
+
+    out.put_uint64(g.alleles.size());
+
+    for(size_t i = 0; i < g.alleles.size(); ++i)
+    {
+        out.put_string(g.alleles[i].name);
+        out.put_double(g.alleles[i].frequency);
+    }
+
+    write_names_image(out, g.allele_names);
+
+    out.put_uint64(g.remap_buffer.size());
+
+    std::list<string>::const_iterator r = g.remap_buffer.begin();
+
+    for( ; r != g.remap_buffer.end(); ++r)
+        out.put_string(*r);
+
+    // Phenotype model
+
+    const phenotype_model_info& p = *my_info->phmodel.my_info;
+
+    out.put_string(p.name);
+    out.put_string(p.missing_ptname);
+    out.put_uint32(p.missing_ptid);
+    out.put_bool  (p.my_has_generated_phenotypes);
+    out.put_bool  (p.my_has_external_phenotypes);
+
+    out.put_uint64(p.phenotypes.size());
+
+    for(size_t i = 0; i < p.phenotypes.size(); ++i)
+    {
+        out.put_string(p.phenotypes[i].name());
+        out.put_uint32(p.phenotypes[i].id());
+    }
+
+    write_names_image(out, p.phenotype_names);
+
+    // Penetrances
+
+    write_bools_image(out, my_info->codominant_phenotypes);
+    write_bools_image(out, my_info->strict_phenotypes);
+
+    out.put_uint32(my_info->codominant);
+    out.put_uint32(my_info->strict_codominant);
+    out.put_uint32(my_info->last_alleles);
+
+    write_matrix_image(out, my_info->unphased_penetrance);
+    write_matrix_image(out, my_info->phased_penetrance);
+}
+
+bool
+penetrance_model::read_image(UTIL::BinaryImageReader& in)
+{
+    string name = in.get_string();
+
+    // Genotype model.  Genotype ids follow from the alleles and the model
+    // type, so the genotypes are rebuilt rather than stored.
+
+    genotype_model gm;
+
+    string            gname = in.get_string();
+    GenotypeModelType gtype = AUTOSOMAL;
+
+    char separators[sizeof(gm.my_info->separators)];
+    
+    in.get_bytes(separators, sizeof(separators));
+
+    string missing_allele = in.get_string();
+    bool   dynamic        = in.get_bool();
+
+    switch(in.get_int())
+    {
+      case X_LINKED : gtype = X_LINKED;  break;
+      case Y_LINKED : gtype = Y_LINKED;  break;
+      default       : gtype = AUTOSOMAL; break;
+    }
+
+    gm.my_info.reset(new PRIVATE::genotype_model_info(gname, gtype));
+
+    PRIVATE::genotype_model_info& g = *gm.my_info;
+
+    std::memcpy(g.separators, separators, sizeof(separators));
+
+    g.missing_allele_name = missing_allele;
+    g.dynamic_alleles     = dynamic;
+
+    uint64_t allele_count = in.get_uint64();
+
+    for(uint64_t i = 0; i < allele_count && in.good(); ++i)
+    {
+        string aname = in.get_string();
+        double freq  = in.get_double();
+
+        g.alleles.push_back(PRIVATE::allele_info(aname, freq, (uint) i));
+    }
+
+    read_names_image(in, g.allele_names);
+
+    uint64_t remap_count = in.get_uint64();
+
+    for(uint64_t i = 0; i < remap_count && in.good(); ++i)
+        g.remap_buffer.push_back(in.get_string());
+
+    if(!in.good()) return false;
+
+    g.rebuild_genotypes();
+
+    // Phenotype model
+
+    phenotype_model pm;
+
+    pm.my_info.reset(new phenotype_model_info(in.get_string()));
+
+    phenotype_model_info& p = *pm.my_info;
+
+    p.missing_ptname              = in.get_string();
+    p.missing_ptid                = in.get_uint32();
+    p.my_has_generated_phenotypes = in.get_bool();
+    p.my_has_external_phenotypes  = in.get_bool();
+
+    uint64_t phenotype_count = in.get_uint64();
+
+    for(uint64_t i = 0; i < phenotype_count && in.good(); ++i)
+    {
+        string pname = in.get_string();
+        uint   id    = in.get_uint32();
+
+        // Phenotypes are looked up by id as an index
+
+        if(id != i) return false;
+
+        p.phenotypes.push_back(phenotype(pname, id));
+    }
+
+    read_names_image(in, p.phenotype_names);
+
+    // Penetrances
+
+    penetrance_model tmp(new penetrance_model_info(gm, pm, name));
+
+    tmp.resize_matrices();
+
+    read_bools_image(in, tmp.my_info->codominant_phenotypes);
+    read_bools_image(in, tmp.my_info->strict_phenotypes);
+
+    tmp.my_info->codominant        = in.get_uint32();
+    tmp.my_info->strict_codominant = in.get_uint32();
+    tmp.my_info->last_alleles      = in.get_uint32();
+
+    read_matrix_image(in, tmp.my_info->unphased_penetrance);
+    read_matrix_image(in, tmp.my_info->phased_penetrance);
+
+    if(!in.good()) return false;
+
+    std::swap(my_info, tmp.my_info);
+
+    return true;
+}
+
 } // End namespace MLOCUS
 } // End namespace SAGE
 
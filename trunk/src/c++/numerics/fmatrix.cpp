@@ -4,6 +4,7 @@
 #include <functional>
 #include "numerics/clapack.h"
 #include "numerics/fmatrix.h"
+#include "numerics/matrix_kernels.h"
 
 using namespace std;
 
@@ -860,6 +861,248 @@ int Eigen(matrix& b, vector<double>& w)
   return info;
 }
 
+//
+// Products
+//
+
+namespace {
+
+// Products of fewer multiply-adds than this are quicker done by the template
+// loops of fmatrix.h, inlined here, than through the call and setup of the
+// kernels.  See numerics/matrix_kernel_bench.
+const size_t small_product = 64;
+
+// Sizes o for an accumulated product:  an empty o is sized and zeroed, and
+// any other must already be the right size.
+bool accumulate_into(matrix& o, size_t m, size_t n)
+{
+  if( !o )
+    return false;
+
+  if( o.empty() )
+  {
+    o.resize_nofill(m, n);
+
+    for(size_t j = 0; j < n; ++j)
+      for(size_t i = 0; i < m; ++i)
+        o(i,j) = 0.0;
+
+    return true;
+  }
+
+  if( o.rows() != m || o.cols() != n )
+  {
+    o.setstate(matrix::failbit);
+    return false;
+  }
+
+  return true;
+}
+
+// o = op(v1) * op(v2), computed into a temporary when o is an input.
+matrix& product(bool t1, bool t2, const matrix& v1, const matrix& v2, matrix& o)
+{
+  size_t m = t1 ? v1.cols() : v1.rows();
+  size_t k = t1 ? v1.rows() : v1.cols();
+  size_t n = t2 ? v2.rows() : v2.cols();
+
+  if( &o == &v1 || &o == &v2 )
+  {
+    matrix temp;
+    product(t1, t2, v1, v2, temp);
+    o.clear();
+    o.swap(temp);
+    return o;
+  }
+
+  o.clear();
+  o.resize_nofill(m, n);
+
+  gemm_kernel(t1, t2, m, n, k, 1.0, v1.raw_storage(), v1.lda(),
+                                    v2.raw_storage(), v2.lda(),
+                              0.0,  o.raw_storage(),  o.lda());
+  return o;
+}
+
+// o = v'v (trans) or vv', computed into a temporary when o is v.
+matrix& gram(bool trans, const matrix& v, matrix& o)
+{
+  size_t n = trans ? v.cols() : v.rows();
+  size_t k = trans ? v.rows() : v.cols();
+
+  if( &o == &v )
+  {
+    matrix temp;
+    gram(trans, v, temp);
+    o.clear();
+    o.swap(temp);
+    return o;
+  }
+
+  o.clear();
+  o.resize_nofill(n, n);
+
+  syrk_kernel(trans, n, k, 1.0, v.raw_storage(), v.lda(), 0.0, o.raw_storage(), o.lda());
+
+  return o;
+}
+
+}
+
+matrix& multiply(const matrix& v1, const matrix& v2, matrix& o)
+{
+  if( !v1 || !v2 || v1.cols() != v2.rows() )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( v1.rows() * v2.cols() * v1.cols() < small_product && &o != &v1 && &o != &v2 )
+    return multiply<double>(v1, v2, o);
+
+  return product(false, false, v1, v2, o);
+}
+
+matrix& XZT(const matrix& v1, const matrix& v2, matrix& o)
+{
+  if( !v1 || !v2 || v1.cols() != v2.cols() )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( v1.rows() * v2.rows() * v1.cols() < small_product && &o != &v1 && &o != &v2 )
+    return XZT<double>(v1, v2, o);
+
+  return product(false, true, v1, v2, o);
+}
+
+matrix& XTZ(const matrix& v1, const matrix& v2, matrix& o)
+{
+  if( !v1 || !v2 || v1.rows() != v2.rows() )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( v1.cols() * v2.cols() * v1.rows() < small_product && &o != &v1 && &o != &v2 )
+    return XTZ<double>(v1, v2, o);
+
+  return product(true, false, v1, v2, o);
+}
+
+matrix& XTX(const matrix& v, matrix& o)
+{
+  if( !v )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( v.cols() * v.cols() * v.rows() < small_product && &o != &v )
+    return XTX<double>(v, o);
+
+  return gram(true, v, o);
+}
+
+matrix& XXT(const matrix& v, matrix& o)
+{
+  if( !v )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( v.rows() * v.rows() * v.cols() < small_product && &o != &v )
+    return XXT<double>(v, o);
+
+  return gram(false, v, o);
+}
+
+matrix& multiply_add(const matrix& v1, const matrix& v2, matrix& o, double alpha)
+{
+  if( !v1 || !v2 || v1.cols() != v2.rows() || &o == &v1 || &o == &v2 )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( accumulate_into(o, v1.rows(), v2.cols()) )
+    gemm_kernel(false, false, v1.rows(), v2.cols(), v1.cols(),
+                alpha, v1.raw_storage(), v1.lda(),
+                       v2.raw_storage(), v2.lda(),
+                1.0,   o.raw_storage(),  o.lda());
+  return o;
+}
+
+matrix& XTZ_add(const matrix& v1, const matrix& v2, matrix& o)
+{
+  if( !v1 || !v2 || v1.rows() != v2.rows() || &o == &v1 || &o == &v2 )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( accumulate_into(o, v1.cols(), v2.cols()) )
+    gemm_kernel(true, false, v1.cols(), v2.cols(), v1.rows(),
+                1.0, v1.raw_storage(), v1.lda(),
+                     v2.raw_storage(), v2.lda(),
+                1.0, o.raw_storage(),  o.lda());
+  return o;
+}
+
+matrix& XTX_add(const matrix& v, matrix& o)
+{
+  if( !v || &o == &v )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  if( accumulate_into(o, v.cols(), v.cols()) )
+    syrk_kernel(true, v.cols(), v.rows(), 1.0, v.raw_storage(), v.lda(),
+                                          1.0, o.raw_storage(), o.lda());
+  return o;
+}
+
+matrix& XTWZ_add(const matrix& x, const matrix& w, const matrix& z, matrix& o, matrix& work)
+{
+  if( !x || !w || !z || w.rows() != w.cols() || x.rows() != w.rows() || z.rows() != w.rows() )
+  {
+    o.setstate(matrix::failbit);
+    return o;
+  }
+
+  multiply(w, z, work);
+
+  return XTZ_add(x, work, o);
+}
+
+matrix& XTWX_add(const matrix& x, const matrix& w, matrix& o, matrix& work)
+{
+  return XTWZ_add(x, w, x, o, work);
+}
+
+matrix& triangular_solve(const matrix& T, matrix& B, bool upper, bool transpose)
+{
+  if( !T || !B || T.rows() != T.cols() || T.rows() != B.rows() || &T == &B )
+  {
+    B.setstate(matrix::failbit);
+    return B;
+  }
+
+  for(size_t i = 0; i < T.rows(); ++i)
+    if( T(i,i) == 0.0 )
+    {
+      B.setstate(matrix::failbit);
+      return B;
+    }
+
+  trsm_kernel(upper, transpose, B.rows(), B.cols(), T.raw_storage(), T.lda(),
+                                                    B.raw_storage(), B.lda());
+  return B;
+}
+
 } // end of namespace SAGE
 
 #ifdef NEEDS_FORTRAN_MAIN
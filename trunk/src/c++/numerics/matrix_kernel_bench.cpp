@@ -0,0 +1,218 @@
+//==========================================================================
+//  File:    matrix_kernel_bench.cpp
+//
+//  Purpose: Micro-benchmark of the matrix product kernels behind the
+//           FortranMatrix<double> products.  Times the original template
+//           loops of fmatrix.h against the portable kernels and BLAS on
+//           the X'WX accumulations of a GLS regression (a cluster of n
+//           members with p covariates) and on square products, and checks
+//           that they agree within 1e-10.  The crossover between the
+//           portable and BLAS columns is what blas_threshold() is set from.
+//
+//  Usage:   matrix_kernel_bench [max_square]
+//
+//  Copyright (c) 2026 R. C. Elston
+//  All Rights Reserved
+//==========================================================================
+
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include "numerics/fmatrix.h"
+#include "numerics/matrix_kernels.h"
+
+using namespace std;
+using namespace SAGE;
+
+typedef FortranMatrix<double> matrix;
+
+double seconds(clock_t start)
+{
+  return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void random_fill(matrix& m, size_t r, size_t c)
+{
+  m.resize_nofill(r, c);
+
+  for(size_t j = 0; j < c; ++j)
+    for(size_t i = 0; i < r; ++i)
+      m(i,j) = double(rand()) / RAND_MAX - 0.5;
+}
+
+double max_diff(const matrix& a, const matrix& b)
+{
+  if(a.rows() != b.rows() || a.cols() != b.cols())
+    return HUGE_VAL;
+
+  double d = 0.0;
+
+  for(size_t j = 0; j < a.cols(); ++j)
+    for(size_t i = 0; i < a.rows(); ++i)
+      d = std::max(d, fabs(a(i,j) - b(i,j)));
+
+  return d;
+}
+
+// X'WX and X'Wy as gls3 accumulated them, with the template loops.
+void reference_xtwx(const matrix& x, const matrix& w, const matrix& y,
+                    matrix& xwx, matrix& xwy, matrix& t1, matrix& t2)
+{
+  multiply<double>(w, x, t1);
+  XTZ<double>(x, t1, t2);
+  xwx += t2;
+
+  multiply<double>(w, y, t1);
+  XTZ<double>(x, t1, t2);
+  xwy += t2;
+}
+
+void kernel_xtwx(const matrix& x, const matrix& w, const matrix& y,
+                 matrix& xwx, matrix& xwy, matrix& work)
+{
+  XTWX_add(x, w, xwx, work);
+  XTWZ_add(x, w, y, xwy, work);
+}
+
+bool ok = true;
+
+void report(double reference, double elapsed, double diff)
+{
+  if(diff > 1e-10) ok = false;
+
+  cout << setw(12) << fixed << setprecision(3) << elapsed / reference
+       << setw(10) << scientific << setprecision(1) << diff << fixed;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t max_square = 256;
+
+  if(argc > 1) max_square = atoi(argv[1]);
+
+  matrix_kernel_dispatch modes[] = { MK_PORTABLE, MK_BLAS, MK_AUTO };
+
+  srand(1);
+
+  cout << "Times relative to the template loops (lower is faster), and the"  << endl
+       << "largest difference from them.  BLAS threshold: " << blas_threshold()
+       << " multiply-adds." << endl << endl;
+
+  cout << "X'WX, X'Wy accumulated over 1000 clusters" << endl << endl
+       << setw(5) << "n" << setw(5) << "p" << setw(12) << "loops (s)"
+       << setw(12) << "portable" << setw(10) << "diff"
+       << setw(12) << "BLAS"     << setw(10) << "diff"
+       << setw(12) << "auto"     << setw(10) << "diff" << endl;
+
+  static const size_t sizes[][2] = { {2, 3}, {4, 3}, {6, 4}, {12, 6}, {20, 8}, {40, 10}, {100, 20}, {250, 40} };
+
+  for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    size_t n = sizes[s][0], p = sizes[s][1];
+
+    const size_t clusters = 1000;
+
+    vector<matrix> x(clusters), w(clusters), y(clusters);
+
+    for(size_t c = 0; c < clusters; ++c)
+    {
+      random_fill(x[c], n, p);
+      random_fill(w[c], n, n);
+      random_fill(y[c], n, 1);
+    }
+
+    size_t reps = std::max((size_t) 1, (size_t) 20000000 / (clusters * n * n * p + 1));
+
+    matrix xwx, xwy, t1, t2;
+
+    clock_t start = clock();
+
+    for(size_t r = 0; r < reps; ++r)
+    {
+      xwx.resize_fill(p, p, 0.0);
+      xwy.resize_fill(p, 1, 0.0);
+
+      for(size_t c = 0; c < clusters; ++c)
+        reference_xtwx(x[c], w[c], y[c], xwx, xwy, t1, t2);
+    }
+
+    double reference = seconds(start) / reps;
+
+    cout << setw(5) << n << setw(5) << p << setw(12) << setprecision(6) << reference;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+      set_matrix_kernel_dispatch(modes[k]);
+
+      matrix kwx, kwy, work;
+
+      start = clock();
+
+      for(size_t r = 0; r < reps; ++r)
+      {
+        kwx.resize_fill(p, p, 0.0);
+        kwy.resize_fill(p, 1, 0.0);
+
+        for(size_t c = 0; c < clusters; ++c)
+          kernel_xtwx(x[c], w[c], y[c], kwx, kwy, work);
+      }
+
+      report(reference, seconds(start) / reps, std::max(max_diff(xwx, kwx), max_diff(xwy, kwy)));
+    }
+
+    cout << endl;
+  }
+
+  cout << endl << "Square products A*B, A'A" << endl << endl
+       << setw(10) << "n" << setw(12) << "loops (s)"
+       << setw(12) << "portable" << setw(10) << "diff"
+       << setw(12) << "BLAS"     << setw(10) << "diff"
+       << setw(12) << "auto"     << setw(10) << "diff" << endl;
+
+  for(size_t n = 4; n <= max_square; n *= 2)
+  {
+    matrix a, b, c, d;
+
+    random_fill(a, n, n);
+    random_fill(b, n, n);
+
+    size_t reps = std::max((size_t) 1, (size_t) 50000000 / (n * n * n));
+
+    clock_t start = clock();
+
+    for(size_t r = 0; r < reps; ++r)
+    {
+      multiply<double>(a, b, c);
+      XTX<double>(a, d);
+    }
+
+    double reference = seconds(start) / reps;
+
+    cout << setw(10) << n << setw(12) << setprecision(6) << reference;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+      set_matrix_kernel_dispatch(modes[k]);
+
+      matrix kc, kd;
+
+      start = clock();
+
+      for(size_t r = 0; r < reps; ++r)
+      {
+        multiply(a, b, kc);
+        XTX(a, kd);
+      }
+
+      report(reference, seconds(start) / reps, std::max(max_diff(c, kc), max_diff(d, kd)));
+    }
+
+    cout << endl;
+  }
+
+  cout << endl << (ok ? "All kernels agree within 1e-10." : "MISMATCH against the template loops!") << endl;
+
+  return ok ? 0 : 1;
+}
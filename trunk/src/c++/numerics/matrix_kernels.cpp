@@ -0,0 +1,388 @@
+//
+//  Matrix Kernels.  BLAS dispatch and portable implementations.
+//
+//  History:   1.0  Initial implementation                  Oct 17 2026
+//
+//  Copyright (c) 2026  R.C. Elston
+//
+
+#include <algorithm>
+#include <climits>
+#include "numerics/clapack.h"
+#include "numerics/matrix_kernels.h"
+
+namespace SAGE {
+
+namespace {
+
+matrix_kernel_dispatch dispatch  = MK_AUTO;
+size_t                 threshold = 256;
+
+// Depth of the blocks of k (the summed dimension) in the portable products,
+// chosen so that a block of a column of A and of B stay in cache while the
+// block is used.
+
+const size_t KB = 256;
+
+bool fits_int(size_t n) { return n <= (size_t) INT_MAX; }
+
+bool use_blas(size_t m, size_t n, size_t k, size_t lda, size_t ldb, size_t ldc)
+{
+  if(dispatch == MK_PORTABLE || (dispatch == MK_AUTO && m * n * k < threshold))
+    return false;
+
+  return    fits_int(m)   && fits_int(n)   && fits_int(k)
+         && fits_int(lda) && fits_int(ldb) && fits_int(ldc);
+}
+
+/// C = beta * C, with C not read when beta is zero (as in BLAS).
+void scale(size_t m, size_t n, double beta, double* c, size_t ldc)
+{
+  if(beta == 1.0)
+    return;
+
+  for(size_t j = 0; j < n; ++j)
+  {
+    double* cj = c + j * ldc;
+
+    if(beta == 0.0)
+      std::fill(cj, cj + m, 0.0);
+    else
+      for(size_t i = 0; i < m; ++i)
+        cj[i] *= beta;
+  }
+}
+
+//
+// Portable products.  Each element of the result is summed in order of k,
+// as the loops they replace did, so results do not depend on the blocking.
+//
+
+// C += alpha * A * op(B):  columns of C are updated by columns of A.
+void gemm_n(bool transb, size_t m, size_t n, size_t k, double alpha,
+            const double* a, size_t lda, const double* b, size_t ldb,
+            double* c, size_t ldc)
+{
+  // Strides of B along l and j
+  const size_t bl = transb ? ldb : 1;
+  const size_t bj = transb ? 1   : ldb;
+
+  for(size_t kk = 0; kk < k; kk += KB)
+  {
+    size_t kend = std::min(k, kk + KB);
+
+    for(size_t j = 0; j < n; ++j)
+    {
+      double* cj = c + j * ldc;
+
+      for(size_t l = kk; l < kend; ++l)
+      {
+        double        blj = alpha * b[l * bl + j * bj];
+        const double* al  = a + l * lda;
+
+        for(size_t i = 0; i < m; ++i)
+          cj[i] += al[i] * blj;
+      }
+    }
+  }
+}
+
+// C = alpha * A' * B + beta * C:  dot products of columns, four at a time so
+// that each column loaded is used twice.
+void gemm_tn(size_t m, size_t n, size_t k, double alpha,
+             const double* a, size_t lda, const double* b, size_t ldb,
+             double beta, double* c, size_t ldc)
+{
+  const size_t m2 = m - m % 2;
+  const size_t n2 = n - n % 2;
+
+  size_t i, j, l;
+
+  for(j = 0; j < n2; j += 2)
+  {
+    const double* b0 = b + j * ldb;
+    const double* b1 = b0 + ldb;
+
+    for(i = 0; i < m2; i += 2)
+    {
+      const double* a0 = a + i * lda;
+      const double* a1 = a0 + lda;
+
+      double s00 = 0.0, s01 = 0.0, s10 = 0.0, s11 = 0.0;
+
+      for(l = 0; l < k; ++l)
+      {
+        s00 += a0[l] * b0[l];
+        s01 += a0[l] * b1[l];
+        s10 += a1[l] * b0[l];
+        s11 += a1[l] * b1[l];
+      }
+
+      double* c0 = c + j * ldc;
+      double* c1 = c0 + ldc;
+
+      c0[i]     = alpha * s00 + (beta == 0.0 ? 0.0 : beta * c0[i]);
+      c1[i]     = alpha * s01 + (beta == 0.0 ? 0.0 : beta * c1[i]);
+      c0[i + 1] = alpha * s10 + (beta == 0.0 ? 0.0 : beta * c0[i + 1]);
+      c1[i + 1] = alpha * s11 + (beta == 0.0 ? 0.0 : beta * c1[i + 1]);
+    }
+  }
+
+  // The odd row and column left over
+
+  for(j = 0; j < n; ++j)
+  {
+    const double* bj = b + j * ldb;
+
+    for(i = (j < n2) ? m2 : 0; i < m; ++i)
+    {
+      const double* ai = a + i * lda;
+
+      double s = 0.0;
+
+      for(l = 0; l < k; ++l)
+        s += ai[l] * bj[l];
+
+      double& cij = c[i + j * ldc];
+
+      cij = alpha * s + (beta == 0.0 ? 0.0 : beta * cij);
+    }
+  }
+}
+
+// C = alpha * A' * B' + beta * C
+void gemm_tt(size_t m, size_t n, size_t k, double alpha,
+             const double* a, size_t lda, const double* b, size_t ldb,
+             double beta, double* c, size_t ldc)
+{
+  for(size_t j = 0; j < n; ++j)
+    for(size_t i = 0; i < m; ++i)
+    {
+      const double* ai = a + i * lda;
+
+      double s = 0.0;
+
+      for(size_t l = 0; l < k; ++l)
+        s += ai[l] * b[j + l * ldb];
+
+      double& cij = c[i + j * ldc];
+
+      cij = alpha * s + (beta == 0.0 ? 0.0 : beta * cij);
+    }
+}
+
+void mirror_upper(size_t n, double* c, size_t ldc)
+{
+  for(size_t j = 0; j < n; ++j)
+    for(size_t i = 0; i < j; ++i)
+      c[j + i * ldc] = c[i + j * ldc];
+}
+
+} // End anonymous namespace
+
+void set_matrix_kernel_dispatch(matrix_kernel_dispatch d) { dispatch = d;    }
+matrix_kernel_dispatch get_matrix_kernel_dispatch()       { return dispatch; }
+
+size_t blas_threshold()                         { return threshold;          }
+void   set_blas_threshold(size_t multiply_adds) { threshold = multiply_adds; }
+
+void gemm_kernel(bool transa, bool transb, size_t m, size_t n, size_t k,
+                 double alpha, const double* a, size_t lda,
+                                const double* b, size_t ldb,
+                 double beta,        double* c, size_t ldc)
+{
+  if(!m || !n)
+    return;
+
+  if(!k || alpha == 0.0)
+  {
+    scale(m, n, beta, c, ldc);
+    return;
+  }
+
+  if(use_blas(m, n, k, lda, ldb, ldc))
+  {
+    char ta = transa ? 'T' : 'N';
+    char tb = transb ? 'T' : 'N';
+    int  im = (int) m,   in  = (int) n,   ik  = (int) k;
+    int  ia = (int) lda, ib  = (int) ldb, ic  = (int) ldc;
+
+    F77_CALL(dgemm)(&ta, &tb, &im, &in, &ik, &alpha, const_cast<double*>(a), &ia,
+                    const_cast<double*>(b), &ib, &beta, c, &ic);
+    return;
+  }
+
+  if(!transa)
+  {
+    scale(m, n, beta, c, ldc);
+    gemm_n(transb, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+  }
+  else if(!transb)
+    gemm_tn(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  else
+    gemm_tt(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+void syrk_kernel(bool trans, size_t n, size_t k,
+                 double alpha, const double* a, size_t lda,
+                 double beta,        double* c, size_t ldc)
+{
+  if(!n)
+    return;
+
+  if(!k || alpha == 0.0)
+  {
+    scale(n, n, beta, c, ldc);
+    return;
+  }
+
+  if(use_blas(n, n, k, lda, lda, ldc))
+  {
+    char uplo = 'U';
+    char t    = trans ? 'T' : 'N';
+    int  in   = (int) n,   ik = (int) k;
+    int  ia   = (int) lda, ic = (int) ldc;
+
+    F77_CALL(dsyrk)(&uplo, &t, &in, &ik, &alpha, const_cast<double*>(a), &ia, &beta, c, &ic);
+  }
+  else if(trans)
+  {
+    // Upper triangle of A' * A:  dot products of columns
+    for(size_t j = 0; j < n; ++j)
+    {
+      const double* aj = a + j * lda;
+
+      for(size_t i = 0; i <= j; ++i)
+      {
+        const double* ai = a + i * lda;
+
+        double s = 0.0;
+
+        for(size_t l = 0; l < k; ++l)
+          s += ai[l] * aj[l];
+
+        double& cij = c[i + j * ldc];
+
+        cij = alpha * s + (beta == 0.0 ? 0.0 : beta * cij);
+      }
+    }
+  }
+  else
+  {
+    // Upper triangle of A * A':  columns of C updated by columns of A
+    for(size_t j = 0; j < n; ++j)
+    {
+      double* cj = c + j * ldc;
+
+      for(size_t i = 0; i <= j; ++i)
+        cj[i] = (beta == 0.0) ? 0.0 : beta * cj[i];
+    }
+
+    for(size_t kk = 0; kk < k; kk += KB)
+    {
+      size_t kend = std::min(k, kk + KB);
+
+      for(size_t j = 0; j < n; ++j)
+      {
+        double* cj = c + j * ldc;
+
+        for(size_t l = kk; l < kend; ++l)
+        {
+          const double* al  = a + l * lda;
+          double        alj = alpha * al[j];
+
+          for(size_t i = 0; i <= j; ++i)
+            cj[i] += al[i] * alj;
+        }
+      }
+    }
+  }
+
+  mirror_upper(n, c, ldc);
+}
+
+void trsm_kernel(bool upper, bool trans, size_t m, size_t n,
+                 const double* t, size_t ldt,
+                       double* b, size_t ldb)
+{
+  if(!m || !n)
+    return;
+
+  if(use_blas(m, m, n, ldt, ldb, ldb))
+  {
+    char   side  = 'L';
+    char   uplo  = upper ? 'U' : 'L';
+    char   ta    = trans ? 'T' : 'N';
+    char   diag  = 'N';
+    int    im    = (int) m,   in = (int) n;
+    int    it    = (int) ldt, ib = (int) ldb;
+    double alpha = 1.0;
+
+    F77_CALL(dtrsm)(&side, &uplo, &ta, &diag, &im, &in, &alpha, const_cast<double*>(t), &it, b, &ib);
+    return;
+  }
+
+  // op(T) is upper triangular when T is upper and not transposed, or lower
+  // and transposed.  Untransposed solves run down the columns of T, and
+  // transposed solves take dot products with them.
+
+  for(size_t c = 0; c < n; ++c)
+  {
+    double* x = b + c * ldb;
+
+    if(upper && !trans)
+    {
+      for(size_t j = m; j-- > 0; )
+      {
+        const double* tj = t + j * ldt;
+
+        x[j] /= tj[j];
+
+        for(size_t i = 0; i < j; ++i)
+          x[i] -= tj[i] * x[j];
+      }
+    }
+    else if(!upper && !trans)
+    {
+      for(size_t j = 0; j < m; ++j)
+      {
+        const double* tj = t + j * ldt;
+
+        x[j] /= tj[j];
+
+        for(size_t i = j + 1; i < m; ++i)
+          x[i] -= tj[i] * x[j];
+      }
+    }
+    else if(upper && trans)
+    {
+      for(size_t i = 0; i < m; ++i)
+      {
+        const double* ti = t + i * ldt;
+
+        double s = x[i];
+
+        for(size_t j = 0; j < i; ++j)
+          s -= ti[j] * x[j];
+
+        x[i] = s / ti[i];
+      }
+    }
+    else
+    {
+      for(size_t i = m; i-- > 0; )
+      {
+        const double* ti = t + i * ldt;
+
+        double s = x[i];
+
+        for(size_t j = i + 1; j < m; ++j)
+          s -= ti[j] * x[j];
+
+        x[i] = s / ti[i];
+      }
+    }
+  }
+}
+
+} // End namespace SAGE
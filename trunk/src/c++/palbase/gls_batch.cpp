@@ -0,0 +1,569 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "util/ThreadPool.h"
+#include "palbase/gls_batch.h"
+
+namespace SAGE    {
+namespace PALBASE {
+
+// - Clusters per block.  Every step of the factorization is a loop over the
+//   lanes of a block, so this is a multiple of the vector width.
+//
+const size_t LANES = 8;
+
+// - Blocks summed together by one work item.  Items, not threads, own the
+//   partial sums, so that the totals are the same for any number of threads.
+//
+const size_t BLOCKS_PER_ITEM = 16;
+
+const size_t npos = (size_t) -1;
+
+// - The lanes of element (i,j) of an n x n (or n x m) matrix in a block.
+//
+inline double*       lanes(double*       m, size_t i, size_t j, size_t n) { return m + (i + j * n) * LANES; }
+inline const double* lanes(const double* m, size_t i, size_t j, size_t n) { return m + (i + j * n) * LANES; }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// ~ Class:     gls_batch::block_task                                        ~
+// ~                                                                         ~
+// ~ Purpose:   Computes the blocks of a batch, BLOCKS_PER_ITEM to an item,  ~
+// ~            summing each item's share of the totals separately.          ~
+// ~                                                                         ~
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+class gls_batch::block_task : public UTIL::ParallelTask
+{
+  public:
+
+    block_task(gls_batch& b, size_t workers);
+
+    size_t item_count() const;
+
+    virtual void run(size_t item, size_t worker);
+
+    // Adds the items' sums to the totals, in item order.
+    void merge(matrix& AWA, matrix& AWy, matrix& yWy) const;
+
+  private:
+
+    struct scratch
+    {
+      std::vector<double> l;          // Cholesky factor of W (lower)
+      std::vector<double> t;          // its inverse (lower)
+      std::vector<double> x;          // A and y, transformed by the weight
+      std::vector<double> acc;        // the sums, lane by lane
+    };
+
+    void compute_block(group& g, size_t block, scratch& s);
+
+    gls_batch&                                my_batch;
+    size_t                                    p, q;
+    std::vector<std::pair<size_t, size_t> >   my_blocks;   // group, block
+    std::vector<scratch>                      my_scratch;  // per worker
+    std::vector< std::vector<double> >        my_sums;     // per item
+};
+
+gls_batch::block_task::block_task(gls_batch& b, size_t workers)
+  : my_batch(b), p(b.my_parameters), q(b.my_variates), my_scratch(workers)
+{
+  for( size_t gi = 0; gi < b.my_groups.size(); ++gi )
+    for( size_t k = 0; k < b.my_groups[gi].data.size() / b.my_groups[gi].stride; ++k )
+      my_blocks.push_back(std::make_pair(gi, k));
+
+  my_sums.resize(item_count());
+}
+
+size_t
+gls_batch::block_task::item_count() const
+{
+  return (my_blocks.size() + BLOCKS_PER_ITEM - 1) / BLOCKS_PER_ITEM;
+}
+
+void
+gls_batch::block_task::run(size_t item, size_t worker)
+{
+  scratch& s = my_scratch[worker];
+
+  const size_t sum_size = p * p + p * q + q * q;
+
+  s.acc.assign(sum_size * LANES, 0.0);
+
+  size_t last = std::min(my_blocks.size(), (item + 1) * BLOCKS_PER_ITEM);
+
+  for( size_t k = item * BLOCKS_PER_ITEM; k < last; ++k )
+    compute_block(my_batch.my_groups[my_blocks[k].first], my_blocks[k].second, s);
+
+  std::vector<double>& sums = my_sums[item];
+
+  sums.assign(sum_size, 0.0);
+
+  for( size_t e = 0; e < sum_size; ++e )
+    for( size_t c = 0; c < LANES; ++c )
+      sums[e] += s.acc[e * LANES + c];
+}
+
+// - Factors W = LL' for each lane, and transforms A and y to X with X'X =
+//   A'(weight)A:  X = L^-1 A for a covariance, X = L'A for a weight.  The
+//   eigenvalues of W are at least 1 / trace(W^-1) = 1 / |L^-1|^2, which
+//   decides whether the lane is accepted.  Rejected lanes (and the padding
+//   of the last block) are zeroed, so that they add nothing.
+//
+void
+gls_batch::block_task::compute_block(group& g, size_t block, scratch& s)
+{
+  const size_t n    = g.n;
+  const size_t used = std::min(LANES, g.count - block * LANES);
+
+  const double* w = &g.data[block * g.stride];
+  const double* a = w + n * n * LANES;         // A, then y (n x (p+q))
+
+  s.l.resize(n * n * LANES);
+  s.t.resize(n * n * LANES);
+  s.x.resize(n * (p + q) * LANES);
+
+  double* l = &s.l[0];
+  double* t = &s.t[0];
+  double* x = &s.x[0];
+
+  double ok[LANES], d[LANES], tr[LANES];
+
+  size_t c, i, j, k;
+
+  for( c = 0; c < LANES; ++c )
+  {
+    ok[c] = c < used ? 1.0 : 0.0;
+    tr[c] = 0.0;
+  }
+
+  // Cholesky factor, by columns.  Lanes which are not positive definite get
+  // a unit pivot, so the arithmetic stays finite.
+
+  for( j = 0; j < n; ++j )
+  {
+    const double* wjj = lanes(w, j, j, n);
+
+    for( c = 0; c < LANES; ++c )
+      d[c] = wjj[c];
+
+    for( k = 0; k < j; ++k )
+    {
+      const double* ljk = lanes(l, j, k, n);
+
+      for( c = 0; c < LANES; ++c )
+        d[c] -= ljk[c] * ljk[c];
+    }
+
+    double* ljj = lanes(l, j, j, n);
+    double* tjj = lanes(t, j, j, n);
+
+    for( c = 0; c < LANES; ++c )
+    {
+      bool pd = d[c] > 0.0;
+
+      ok[c]  = pd ? ok[c] : 0.0;
+      ljj[c] = pd ? std::sqrt(d[c]) : 1.0;
+      tjj[c] = 1.0 / ljj[c];
+    }
+
+    for( i = j + 1; i < n; ++i )
+    {
+      const double* wij = lanes(w, i, j, n);
+
+      for( c = 0; c < LANES; ++c )
+        d[c] = wij[c];
+
+      for( k = 0; k < j; ++k )
+      {
+        const double* lik = lanes(l, i, k, n);
+        const double* ljk = lanes(l, j, k, n);
+
+        for( c = 0; c < LANES; ++c )
+          d[c] -= lik[c] * ljk[c];
+      }
+
+      double* lij = lanes(l, i, j, n);
+
+      for( c = 0; c < LANES; ++c )
+        lij[c] = d[c] * tjj[c];
+    }
+  }
+
+  // L^-1, whose diagonal is already in t, and the trace of W^-1
+
+  for( j = 0; j < n; ++j )
+  {
+    for( i = j + 1; i < n; ++i )
+    {
+      for( c = 0; c < LANES; ++c )
+        d[c] = 0.0;
+
+      for( k = j; k < i; ++k )
+      {
+        const double* lik = lanes(l, i, k, n);
+        const double* tkj = lanes(t, k, j, n);
+
+        for( c = 0; c < LANES; ++c )
+          d[c] -= lik[c] * tkj[c];
+      }
+
+      double*       tij = lanes(t, i, j, n);
+      const double* tii = lanes(t, i, i, n);
+
+      for( c = 0; c < LANES; ++c )
+        tij[c] = d[c] * tii[c];
+    }
+
+    for( i = j; i < n; ++i )
+    {
+      const double* tij = lanes(t, i, j, n);
+
+      for( c = 0; c < LANES; ++c )
+        tr[c] += tij[c] * tij[c];
+    }
+  }
+
+  const double max_trace = 1.0 / gls_batch::min_eigenvalue();
+
+  for( c = 0; c < LANES; ++c )
+    ok[c] = (tr[c] <= max_trace) ? ok[c] : 0.0;
+
+  // X = L^-1 [A y] or L'[A y]
+
+  const bool covariance = g.form == COVARIANCE;
+
+  for( j = 0; j < p + q; ++j )
+    for( i = 0; i < n; ++i )
+    {
+      for( c = 0; c < LANES; ++c )
+        d[c] = 0.0;
+
+      if( covariance )
+        for( k = 0; k <= i; ++k )
+        {
+          const double* tik = lanes(t, i, k, n);
+          const double* akj = lanes(a, k, j, n);
+
+          for( c = 0; c < LANES; ++c )
+            d[c] += tik[c] * akj[c];
+        }
+      else
+        for( k = i; k < n; ++k )
+        {
+          const double* lki = lanes(l, k, i, n);
+          const double* akj = lanes(a, k, j, n);
+
+          for( c = 0; c < LANES; ++c )
+            d[c] += lki[c] * akj[c];
+        }
+
+      double* xij = lanes(x, i, j, n);
+
+      for( c = 0; c < LANES; ++c )
+        xij[c] = ok[c] != 0.0 ? d[c] : 0.0;
+    }
+
+  // The sums:  the upper triangle of A'WA, then A'Wy and y'Wy, which are
+  // the blocks of X'X.
+
+  const size_t m = p + q;
+
+  double* acc = &s.acc[0];
+
+  for( j = 0; j < m; ++j )
+    for( i = 0; i <= j; ++i )
+    {
+      if( i >= p && j < p )
+        continue;
+
+      size_t e;
+
+      if( j < p )
+        e = i + j * p;
+      else if( i < p )
+        e = p * p + i + (j - p) * p;
+      else
+        e = p * p + p * q + (i - p) + (j - p) * q;
+
+      double* ae = acc + e * LANES;
+
+      for( k = 0; k < n; ++k )
+      {
+        const double* xki = lanes(x, k, i, n);
+        const double* xkj = lanes(x, k, j, n);
+
+        for( c = 0; c < LANES; ++c )
+          ae[c] += xki[c] * xkj[c];
+      }
+    }
+
+  // W^-1 = L^-T L^-1, lower triangle
+
+  if( covariance && g.inverses.size() )
+  {
+    double* wi = &g.inverses[block * n * n * LANES];
+
+    for( j = 0; j < n; ++j )
+      for( i = j; i < n; ++i )
+      {
+        for( c = 0; c < LANES; ++c )
+          d[c] = 0.0;
+
+        for( k = i; k < n; ++k )
+        {
+          const double* tki = lanes(t, k, i, n);
+          const double* tkj = lanes(t, k, j, n);
+
+          for( c = 0; c < LANES; ++c )
+            d[c] += tki[c] * tkj[c];
+        }
+
+        double* wij = lanes(wi, i, j, n);
+
+        for( c = 0; c < LANES; ++c )
+          wij[c] = d[c];
+      }
+  }
+
+  for( c = 0; c < used; ++c )
+    my_batch.my_accepted[g.clusters[block * LANES + c]] = ok[c] != 0.0;
+}
+
+void
+gls_batch::block_task::merge(matrix& AWA, matrix& AWy, matrix& yWy) const
+{
+  for( size_t item = 0; item < my_sums.size(); ++item )
+  {
+    const double* sums = &my_sums[item][0];
+
+    for( size_t j = 0; j < p; ++j )
+      for( size_t i = 0; i <= j; ++i )
+      {
+        AWA(i,j) += sums[i + j * p];
+
+        if( i != j )
+          AWA(j,i) += sums[i + j * p];
+      }
+
+    sums += p * p;
+
+    for( size_t j = 0; j < q; ++j )
+      for( size_t i = 0; i < p; ++i )
+        AWy(i,j) += sums[i + j * p];
+
+    sums += p * q;
+
+    for( size_t j = 0; j < q; ++j )
+      for( size_t i = 0; i <= j; ++i )
+      {
+        yWy(i,j) += sums[i + j * q];
+
+        if( i != j )
+          yWy(j,i) += sums[i + j * q];
+      }
+  }
+}
+
+//
+//---------------------------------------------------------------------------
+//
+
+gls_batch::gls_batch(size_t thread_count)
+  : my_parameters(0), my_variates(1), my_keep_inverses(false)
+{
+  my_thread_count = thread_count ? thread_count
+                                 : UTIL::ThreadPool::default_thread_count();
+}
+
+void
+gls_batch::reset(size_t parameters, size_t variates)
+{
+  my_parameters = parameters;
+  my_variates   = variates;
+
+  my_groups.clear();
+  my_group_index.clear();
+  my_clusters.clear();
+  my_accepted.clear();
+}
+
+double*
+gls_batch::new_lane(size_t n, weight_form f, size_t& lane)
+{
+  std::pair<size_t, int> key(n, (int) f);
+
+  std::map<std::pair<size_t, int>, size_t>::const_iterator gi = my_group_index.find(key);
+
+  size_t index;
+
+  if( gi == my_group_index.end() )
+  {
+    index = my_groups.size();
+
+    my_groups.push_back(group());
+    my_group_index[key] = index;
+
+    group& g = my_groups.back();
+
+    g.n      = n;
+    g.form   = f;
+    g.count  = 0;
+    g.stride = n * (n + my_parameters + my_variates) * LANES;
+  }
+  else
+    index = gi->second;
+
+  group& g = my_groups[index];
+
+  if( g.count % LANES == 0 )
+  {
+    g.data.resize(g.data.size() + g.stride, 0.0);
+    g.clusters.resize(g.clusters.size() + LANES, npos);
+  }
+
+  lane = g.count++;
+
+  g.clusters[lane] = my_clusters.size();
+
+  my_clusters.push_back(std::make_pair(index, lane));
+
+  return &g.data[(lane / LANES) * g.stride] + lane % LANES;
+}
+
+void
+gls_batch::copy_lane(double* d, size_t n, const matrix& y, const matrix& A)
+{
+  double* a = d + n * n * LANES;
+
+  for( size_t j = 0; j < my_parameters; ++j )
+    for( size_t i = 0; i < n; ++i )
+      a[(i + j * n) * LANES] = A(i,j);
+
+  a += n * my_parameters * LANES;
+
+  for( size_t j = 0; j < my_variates; ++j )
+    for( size_t i = 0; i < n; ++i )
+      a[(i + j * n) * LANES] = y(i,j);
+}
+
+size_t
+gls_batch::add(const matrix& y, const matrix& W, const matrix& A, weight_form f)
+{
+  size_t n = y.rows();
+
+  assert( W.rows() == n && W.cols() == n && A.rows() == n );
+  assert( A.cols() == my_parameters && y.cols() == my_variates );
+
+  if( !n || n > max_cluster_size() || !y || !W || !A )
+  {
+    my_clusters.push_back(std::make_pair(npos, 0));
+    return my_clusters.size() - 1;
+  }
+
+  size_t  lane;
+  double* d = new_lane(n, f, lane);
+
+  for( size_t j = 0; j < n; ++j )
+    for( size_t i = j; i < n; ++i )
+      d[(i + j * n) * LANES] = W(i,j);
+
+  copy_lane(d, n, y, A);
+
+  return my_clusters.size() - 1;
+}
+
+size_t
+gls_batch::add(const matrix& y, const trimatrix& W, const matrix& A, weight_form f)
+{
+  size_t n = y.rows();
+
+  assert( W.size() == n && A.rows() == n );
+  assert( A.cols() == my_parameters && y.cols() == my_variates );
+
+  if( !n || n > max_cluster_size() || !y || !A )
+  {
+    my_clusters.push_back(std::make_pair(npos, 0));
+    return my_clusters.size() - 1;
+  }
+
+  size_t  lane;
+  double* d = new_lane(n, f, lane);
+
+  for( size_t j = 0; j < n; ++j )
+    for( size_t i = j; i < n; ++i )
+      d[(i + j * n) * LANES] = W(i,j);
+
+  copy_lane(d, n, y, A);
+
+  return my_clusters.size() - 1;
+}
+
+// - If an item throws (it can only run out of memory), every item is computed
+//   again in order, so that the exception reaches our caller.  Items only
+//   write their own sums and lanes, so computing one twice is harmless.
+//
+size_t
+gls_batch::accumulate(matrix& AWA, matrix& AWy, matrix& yWy)
+{
+  assert( AWA.rows() == my_parameters && AWA.cols() == my_parameters );
+  assert( AWy.rows() == my_parameters && AWy.cols() == my_variates   );
+  assert( yWy.rows() == my_variates   && yWy.cols() == my_variates   );
+
+  my_accepted.assign(my_clusters.size(), 0);
+
+  for( size_t gi = 0; gi < my_groups.size(); ++gi )
+  {
+    group& g = my_groups[gi];
+
+    if( my_keep_inverses && g.form == COVARIANCE )
+      g.inverses.resize(g.data.size() / g.stride * g.n * g.n * LANES);
+    else
+      g.inverses.clear();
+  }
+
+  size_t workers = std::max((size_t) 1, my_thread_count);
+
+  block_task task(*this, workers);
+
+  size_t items = task.item_count();
+
+  if( workers > 1 && items > 1 )
+  {
+    UTIL::ThreadPool pool(std::min(workers, items));
+
+    if( !pool.run(items, task) )
+      for( size_t i = 0; i < items; ++i )
+        task.run(i, 0);
+  }
+  else
+    for( size_t i = 0; i < items; ++i )
+      task.run(i, 0);
+
+  task.merge(AWA, AWy, yWy);
+
+  return std::count(my_accepted.begin(), my_accepted.end(), 1);
+}
+
+void
+gls_batch::inverse(size_t cluster, trimatrix& Wi) const
+{
+  assert( accepted(cluster) );
+
+  const group& g = my_groups[my_clusters[cluster].first];
+
+  assert( g.form == COVARIANCE && g.inverses.size() );
+
+  size_t n    = g.n;
+  size_t lane = my_clusters[cluster].second;
+
+  const double* wi = &g.inverses[(lane / LANES) * n * n * LANES] + lane % LANES;
+
+  Wi.resize(n);
+
+  for( size_t j = 0; j < n; ++j )
+    for( size_t i = j; i < n; ++i )
+      Wi(i,j) = wi[(i + j * n) * LANES];
+}
+
+} // end of namespace PALBASE
+} // end of namespace SAGE
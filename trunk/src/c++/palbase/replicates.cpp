@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <ctime>
+#include "util/ThreadPool.h"
+#include "palbase/replicates.h"
+
+namespace SAGE    {
+namespace PALBASE {
+
+// - Replicates per batch, per thread, unless set.
+//
+const size_t REPLICATES_PER_THREAD = 8;
+
+// - Computes the replicates of one batch, one per item, with one generator
+//   per worker.
+//
+class replicate_engine::batch : public UTIL::ParallelTask
+{
+  public:
+
+    batch(const replicate_engine& e, replicate_task& t, size_t first, size_t count)
+      : my_engine(e), my_task(t), my_first(first),
+        my_generators(e.thread_count()), my_done(count, 0)
+    { }
+
+    virtual void run(size_t item, size_t worker)
+    {
+      MersenneTwister& rng = my_generators[worker];
+
+      rng.reseed(my_engine.replicate_seed(my_first + item));
+
+      my_task.compute(my_first + item, item, worker, rng);
+
+      my_done[item] = 1;
+    }
+
+    bool done(size_t item) const { return my_done[item]; }
+
+  private:
+
+    const replicate_engine&       my_engine;
+    replicate_task&               my_task;
+    size_t                        my_first;
+
+    std::vector<MersenneTwister>  my_generators;
+    std::vector<char>             my_done;
+};
+
+replicate_engine::replicate_engine(unsigned long seed, size_t thread_count)
+{
+  my_seed = seed ? seed : clock_seed();
+
+  my_thread_count = thread_count ? thread_count
+                                 : UTIL::ThreadPool::default_thread_count();
+
+  my_batch_size = my_thread_count * REPLICATES_PER_THREAD;
+}
+
+unsigned long
+replicate_engine::replicate_seed(size_t replicate) const
+{
+  return derive_seed(my_seed, replicate);
+}
+
+unsigned long
+replicate_engine::clock_seed()
+{
+  unsigned long seed = (unsigned long) time(NULL);
+
+  return seed ? seed : 1;
+}
+
+// - Mixes n into the seed (the MurmurHash3 finalizer), so that neighboring
+//   replicates, or models, get unrelated generator states.  The generator
+//   can't be seeded with 0.
+//
+unsigned long
+replicate_engine::derive_seed(unsigned long seed, size_t n)
+{
+  unsigned long z = (seed + 0x9e3779b9UL * (unsigned long) (n + 1)) & 0xffffffffUL;
+
+  z = ((z ^ (z >> 16)) * 0x85ebca6bUL) & 0xffffffffUL;
+  z = ((z ^ (z >> 13)) * 0xc2b2ae35UL) & 0xffffffffUL;
+  z =   z ^ (z >> 16);
+
+  return z ? z : 1;
+}
+
+// - A batch is computed concurrently, then accumulated in order, so the
+//   task stops at the same replicate it would if run serially.  If a
+//   replicate throws, the ones which didn't complete are computed again in
+//   order, so that the exception reaches our caller as it would without
+//   threads.
+//
+size_t
+replicate_engine::run(replicate_task& task, size_t max_replicates)
+{
+  UTIL::ThreadPool pool(std::min(my_thread_count, my_batch_size));
+
+  for( size_t first = 0; first < max_replicates; first += my_batch_size )
+  {
+    size_t count = std::min(my_batch_size, max_replicates - first);
+
+    batch b(*this, task, first, count);
+
+    if( !pool.run(count, b) )
+    {
+      for( size_t i = 0; i < count; ++i )
+        if( !b.done(i) )
+          b.run(i, 0);
+    }
+
+    for( size_t i = 0; i < count; ++i )
+      if( task.accumulate(first + i, i) )
+        return first + i + 1;
+  }
+
+  return max_replicates;
+}
+
+} // end of namespace PALBASE
+} // end of namespace SAGE
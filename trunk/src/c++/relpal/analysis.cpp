@@ -1,3 +1,4 @@
+#include "palbase/replicates.h"
 #include "relpal/output.h"
 
 namespace SAGE   {
@@ -53,6 +54,11 @@ relpal_analysis::run_analysis(relative_pairs& r_pairs,
   //
   two_level_score_test current_score(errors);
 
+  // Models without a seed take theirs from one clock seed for the run, so
+  // that no two draw the same empirical p-value replicates.
+  //
+  unsigned long base_seed = PALBASE::replicate_engine::clock_seed();
+
   for( size_t i = 0; i < my_analysis_models.size(); ++i )
   {
     my_current_result     = analysis_result();
@@ -180,6 +186,8 @@ relpal_analysis::run_analysis(relative_pairs& r_pairs,
       if( current_score.has_valid_null() )
       {
         current_score.set_model(my_current_model);
+        current_score.set_seed(my_current_model.get_pvalue_options().seed ? 0
+                               : PALBASE::replicate_engine::derive_seed(base_seed, i));
 
         if( current_score.do_two_level_score_test(my_current_result.score_result) )
         {
@@ -89,6 +89,46 @@ relpal_least_square::add_block(const matrix& y, const trimatrix& W, const matrix
   return;
 }
 
+// Clusters the batch does not accept are added by add_block(), which
+// inverts W by SVD.  As there, clusters after a failure are not added, and
+// keep their Wi.
+//
+void
+relpal_least_square::add_blocks(const vector<matrix>& ys, const vector<trimatrix>& Ws,
+                                const vector<matrix>& As, vector<trimatrix>& Wis)
+{
+  // Callers index Wis by cluster, so it is sized even if nothing is added.
+  Wis.resize(ys.size());
+
+  if(!AWA || !AWy || !yWy)
+    return;
+
+  assert( Ws.size() == ys.size() && As.size() == ys.size() );
+
+  my_batch.reset(parameters);
+  my_batch.set_keep_inverses(true);
+
+  for( size_t i = 0; i < ys.size(); ++i )
+    my_batch.add(ys[i], Ws[i], As[i], PALBASE::gls_batch::COVARIANCE);
+
+  my_batch.accumulate(AWA, AWy, yWy);
+
+  for( size_t i = 0; i < ys.size() && AWA && AWy && yWy; ++i )
+  {
+    if( my_batch.accepted(i) )
+    {
+      my_batch.inverse(i, Wis[i]);
+
+      observation_count += ys[i].rows();
+      cluster_count     += 1;
+    }
+    else
+      add_block(ys[i], Ws[i], As[i], Wis[i]);
+  }
+
+  return;
+}
+
 void 
 relpal_least_square::add_block_kron(const matrix& y, const trimatrix& b, const matrix& A)
 {
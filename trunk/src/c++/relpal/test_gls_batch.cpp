@@ -0,0 +1,401 @@
+//============================================================================
+// File:      test_gls_batch.cpp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     Checks PALBASE::gls_batch against relpal_least_square's
+//            per-cluster add_block().  Clusters of 1 to 6 observations,
+//            with a partial last block of each size, are accumulated with
+//            COVARIANCE and WEIGHT weights on 1 and 4 threads.  Singular,
+//            near singular and indefinite weights and a cluster too large
+//            to batch must be left to add_block(), and add_blocks() must
+//            give the same sums and inverses as add_block() on its own.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+#include <cmath>
+#include <iostream>
+#include "relpal/two_level_calculator.h"
+
+using namespace std;
+using namespace SAGE;
+using namespace RELPAL;
+
+using PALBASE::gls_batch;
+
+int failures = 0;
+
+void check(const string& name, bool ok)
+{
+  if( !ok )
+    ++failures;
+
+  cout << (ok ? "ok    " : "FAILED") << "  " << name << endl;
+}
+
+// A small linear congruential generator, so that the clusters are the same
+// on every platform.
+class value_source
+{
+public:
+
+  value_source() : my_state(7) { }
+
+  double next()
+  {
+    my_state = (my_state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+
+    return ((my_state >> 16) & 0x7FFF) / 32768.0 - 0.5;
+  }
+
+private:
+
+  unsigned long my_state;
+};
+
+// Exposes the sums of the least squares calculator.
+class test_least_square : public relpal_least_square
+{
+public:
+
+  explicit test_least_square(size_t m) : relpal_least_square(m) { }
+
+  const matrix& awa() const { return AWA; }
+  const matrix& awy() const { return AWy; }
+  const matrix& ywy() const { return yWy; }
+
+  bool good() const { return AWA && AWy && yWy; }
+
+  // As add_block() leaves the sums when W cannot be inverted.
+  void fail() { AWA.setstate(matrix::badbit); }
+};
+
+enum cluster_kind { regular = 0, singular, near_singular, indefinite, too_large };
+
+struct cluster
+{
+  matrix        y;
+  matrix        A;
+  trimatrix     W;
+  cluster_kind  kind;
+};
+
+const size_t PARAMETERS = 3;
+
+// W is M M' + s I for a random M, with its first column repeated in the
+// second for singular and near singular weights.
+cluster make_cluster(value_source& source, size_t n, cluster_kind kind)
+{
+  cluster c;
+
+  c.kind = kind;
+
+  matrix M(n, n);
+
+  for( size_t j = 0; j < n; ++j )
+    for( size_t i = 0; i < n; ++i )
+      M(i, j) = source.next();
+
+  if( kind == singular || kind == near_singular )
+    for( size_t i = 0; i < n; ++i )
+      M(i, 1) = M(i, 0);
+
+  double s = kind == singular      ? 0.0
+           : kind == near_singular ? 1.0e-9
+           :                         0.1;
+
+  c.W.resize(n);
+
+  for( size_t i = 0; i < n; ++i )
+    for( size_t j = 0; j <= i; ++j )
+    {
+      double v = 0.0;
+
+      for( size_t k = 0; k < n; ++k )
+        v += M(i, k) * M(j, k);
+
+      c.W(i, j) = v + (i == j ? s : 0.0);
+    }
+
+  if( kind == indefinite )
+    c.W(0, 0) -= 50.0;
+
+  c.A.resize(n, PARAMETERS);
+  c.y.resize(n, 1);
+
+  for( size_t j = 0; j < PARAMETERS; ++j )
+    for( size_t i = 0; i < n; ++i )
+      c.A(i, j) = source.next();
+
+  for( size_t i = 0; i < n; ++i )
+    c.y(i, 0) = source.next();
+
+  return c;
+}
+
+vector<cluster> make_clusters()
+{
+  value_source source;
+
+  vector<cluster> clusters;
+
+  // 203 clusters give 33 or 34 of each size, so every group ends with a
+  // partial block.
+  for( size_t c = 0; c < 203; ++c )
+  {
+    size_t       n    = 1 + c % 6;
+    cluster_kind kind = regular;
+
+    if( n > 2 )
+    {
+      if     ( c % 29 == 5  ) kind = singular;
+      else if( c % 31 == 7  ) kind = near_singular;
+      else if( c % 37 == 11 ) kind = indefinite;
+    }
+
+    clusters.push_back(make_cluster(source, n, kind));
+  }
+
+  clusters.push_back(make_cluster(source, gls_batch::max_cluster_size() + 1, too_large));
+
+  return clusters;
+}
+
+matrix full(const trimatrix& W)
+{
+  matrix m(W.size(), W.size());
+
+  for( size_t i = 0; i < W.size(); ++i )
+    for( size_t j = 0; j < W.size(); ++j )
+      m(i, j) = W(i, j);
+
+  return m;
+}
+
+trimatrix triangle(const matrix& m)
+{
+  trimatrix W(m.rows());
+
+  for( size_t i = 0; i < m.rows(); ++i )
+    for( size_t j = 0; j <= i; ++j )
+      W(i, j) = m(i, j);
+
+  return W;
+}
+
+double difference(const matrix& a, const matrix& b)
+{
+  if( a.rows() != b.rows() || a.cols() != b.cols() )
+    return 1.0;
+
+  double d = 0.0, m = 0.0;
+
+  for( size_t j = 0; j < a.cols(); ++j )
+    for( size_t i = 0; i < a.rows(); ++i )
+    {
+      d = max(d, fabs(a(i, j) - b(i, j)));
+      m = max(m, fabs(b(i, j)));
+    }
+
+  return d / max(m, 1.0);
+}
+
+double difference(const trimatrix& a, const trimatrix& b)
+{
+  if( a.size() != b.size() )
+    return 1.0;
+
+  return difference(full(a), full(b));
+}
+
+bool identical(const matrix& a, const matrix& b)
+{
+  return a.rows() == b.rows() && a.cols() == b.cols() && difference(a, b) == 0.0;
+}
+
+struct sums
+{
+  sums() : AWA(PARAMETERS, PARAMETERS, 0.0), AWy(PARAMETERS, 1, 0.0), yWy(1, 1, 0.0) { }
+
+  matrix AWA, AWy, yWy;
+};
+
+// Accumulates the clusters with gls_batch.  WEIGHT clusters are added
+// through the full matrix overload, W itself being the weight.
+size_t batch_sums(const vector<cluster>& clusters, gls_batch::weight_form form,
+                  size_t threads, sums& s, vector<char>& accepted, vector<trimatrix>& inverses)
+{
+  gls_batch batch(threads);
+
+  batch.reset(PARAMETERS);
+  batch.set_keep_inverses(true);
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+  {
+    if( form == gls_batch::COVARIANCE )
+      batch.add(clusters[c].y, clusters[c].W, clusters[c].A, form);
+    else
+      batch.add(clusters[c].y, full(clusters[c].W), clusters[c].A, form);
+  }
+
+  size_t count = batch.accumulate(s.AWA, s.AWy, s.yWy);
+
+  accepted.assign(clusters.size(), 0);
+  inverses.assign(clusters.size(), trimatrix());
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+  {
+    accepted[c] = batch.accepted(c);
+
+    if( accepted[c] && form == gls_batch::COVARIANCE )
+      batch.inverse(c, inverses[c]);
+  }
+
+  return count;
+}
+
+// The same sums from add_block(), over the clusters accepted by the batch.
+// add_block() takes the covariance, so a WEIGHT cluster is given the
+// inverse of its W.
+void block_sums(const vector<cluster>& clusters, gls_batch::weight_form form,
+                const vector<char>& accepted, test_least_square& ls,
+                vector<trimatrix>& inverses)
+{
+  ls.reset(PARAMETERS);
+
+  inverses.assign(clusters.size(), trimatrix());
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+  {
+    if( !accepted[c] )
+      continue;
+
+    if( form == gls_batch::COVARIANCE )
+      ls.add_block(clusters[c].y, clusters[c].W, clusters[c].A, inverses[c]);
+    else
+    {
+      matrix Wi;
+
+      SVD svd;
+
+      svd.compute(full(clusters[c].W));
+      svd.inverse(Wi);
+
+      trimatrix unused;
+
+      ls.add_block(clusters[c].y, triangle(Wi), clusters[c].A, unused);
+    }
+  }
+}
+
+void test_form(const vector<cluster>& clusters, gls_batch::weight_form form, const string& label)
+{
+  sums               s1, s4;
+  vector<char>       accepted1, accepted4;
+  vector<trimatrix>  inverses1, inverses4;
+
+  size_t count  = batch_sums(clusters, form, 1, s1, accepted1, inverses1);
+  size_t count4 = batch_sums(clusters, form, 4, s4, accepted4, inverses4);
+
+  cout << endl << label << ": " << count << " of " << clusters.size()
+       << " clusters accepted" << endl << endl;
+
+  bool rejected = true;
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+    if( (bool) accepted1[c] != (clusters[c].kind == regular) )
+      rejected = false;
+
+  check(label + ": only well conditioned clusters accepted", rejected);
+
+  test_least_square ls(PARAMETERS);
+  vector<trimatrix> block_inverses;
+
+  block_sums(clusters, form, accepted1, ls, block_inverses);
+
+  check(label + ": same count as add_block()",  ls.cluster_count == count);
+  check(label + ": A'WA as add_block()",        difference(s1.AWA, ls.awa()) < 1.0e-10);
+  check(label + ": A'Wy as add_block()",        difference(s1.AWy, ls.awy()) < 1.0e-10);
+  check(label + ": y'Wy as add_block()",        difference(s1.yWy, ls.ywy()) < 1.0e-10);
+
+  if( form == gls_batch::COVARIANCE )
+  {
+    double d = 0.0;
+
+    for( size_t c = 0; c < clusters.size(); ++c )
+      if( accepted1[c] )
+        d = max(d, difference(inverses1[c], block_inverses[c]));
+
+    check(label + ": inverses as add_block()", d < 1.0e-8);
+  }
+
+  check(label + ": 4 threads same as 1",
+        count4 == count && accepted4 == accepted1 &&
+        identical(s4.AWA, s1.AWA) && identical(s4.AWy, s1.AWy) && identical(s4.yWy, s1.yWy));
+}
+
+void test_add_blocks(const vector<cluster>& clusters)
+{
+  vector<matrix>    ys, As;
+  vector<trimatrix> Ws;
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+  {
+    ys.push_back(clusters[c].y);
+    As.push_back(clusters[c].A);
+    Ws.push_back(clusters[c].W);
+  }
+
+  test_least_square one(PARAMETERS), all(PARAMETERS);
+
+  vector<trimatrix> one_inverses(clusters.size()), all_inverses;
+
+  for( size_t c = 0; c < clusters.size(); ++c )
+    one.add_block(ys[c], Ws[c], As[c], one_inverses[c]);
+
+  all.add_blocks(ys, Ws, As, all_inverses);
+
+  cout << endl << "add_blocks: " << all.cluster_count << " clusters, "
+       << all.observation_count << " observations" << endl << endl;
+
+  double d = 0.0;
+
+  for( size_t c = 0; c < clusters.size() && c < all_inverses.size(); ++c )
+    d = max(d, difference(all_inverses[c], one_inverses[c]));
+
+  check("add_blocks: counts as add_block()",  all.cluster_count     == one.cluster_count &&
+                                              all.observation_count == one.observation_count);
+  check("add_blocks: sums as add_block()",    difference(all.awa(), one.awa()) < 1.0e-10 &&
+                                              difference(all.awy(), one.awy()) < 1.0e-10 &&
+                                              difference(all.ywy(), one.ywy()) < 1.0e-10);
+  check("add_blocks: inverses as add_block()", all_inverses.size() == clusters.size() && d < 1.0e-8);
+
+  // Once the sums have failed nothing more is added, but the inverses are
+  // still one per cluster.
+  test_least_square failed(PARAMETERS);
+
+  failed.fail();
+
+  vector<trimatrix> failed_inverses;
+
+  failed.add_blocks(ys, Ws, As, failed_inverses);
+
+  check("add_blocks after a failure",         !failed.good() && !failed.cluster_count &&
+                                              failed_inverses.size() == clusters.size());
+}
+
+int main()
+{
+  const vector<cluster> clusters = make_clusters();
+
+  test_form(clusters, gls_batch::COVARIANCE, "covariance");
+  test_form(clusters, gls_batch::WEIGHT,     "weight");
+
+  test_add_blocks(clusters);
+
+  cout << endl << failures << " failures." << endl;
+
+  return failures ? 1 : 0;
+}
@@ -67,4 +67,10 @@ class relpal_tests (sagetest.SAGE_Test):
                         'relpal.inf', 'out'  ]
     self.cmd         = 'relpal par ped >out 2>&1'
     self.execute()
-    
+
+  def test_gls_batch(self):
+    'batched gls sums against add_block'
+    self.test_dir = 'test_gls_batch'
+    self.file_names  = ['out']
+    self.cmd         = 'test_gls_batch >out 2>&1'
+    self.execute()
@@ -205,6 +205,9 @@ two_level_regression::do_individual_level(vector<matrix>&    ys,
 
   my_gls_1.reset(p_count);
 
+  vector<matrix>    sp_ys, sp_xs;
+  vector<trimatrix> sp_vs, sp_vis;
+
   for( size_t sp = 0; sp < my_data.size(); ++sp )
   {
     const vector< mem_pointer >&    subped_members = my_data[sp].members;
@@ -265,8 +268,21 @@ two_level_regression::do_individual_level(vector<matrix>&    ys,
       }
     }
 
-    trimatrix vi;
-    my_gls_1.add_block(y, v, x, vi);
+    sp_ys.push_back(y);
+    sp_xs.push_back(x);
+    sp_vs.push_back(v);
+  }
+
+  my_gls_1.add_blocks(sp_ys, sp_vs, sp_xs, sp_vis);
+
+  for( size_t sp = 0; sp < my_data.size(); ++sp )
+  {
+    const vector< mem_pointer >& subped_members = my_data[sp].members;
+
+    const matrix&    y  = sp_ys[sp];
+    const matrix&    x  = sp_xs[sp];
+    const trimatrix& v  = sp_vs[sp];
+    const trimatrix& vi = sp_vis[sp];
 
     ys.push_back(y);
     xs.push_back(x);
@@ -277,7 +293,7 @@ two_level_regression::do_individual_level(vector<matrix>&    ys,
       debug_out() << "subped " << sp << ", name = "
                   << subped_members[0]->pedigree()->name() << " "
                   << subped_members[0]->subpedigree()->name() << endl;
-      debug_out() << "Y size : " << nt << " by 1" << endl; 
+      debug_out() << "Y size : " << y.rows() << " by 1" << endl; 
       print_matrix_first10(y, debug_out(), "Y");
       print_matrix_first10(x, debug_out(), "X");
       print_trimatrix_first10(v, debug_out(), "V");
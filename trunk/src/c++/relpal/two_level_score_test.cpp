@@ -1,11 +1,13 @@
 #include "maxfunapi/maxfunapi.h"
+#include "palbase/replicates.h"
 #include "relpal/two_level_test.h"
 
 namespace SAGE   {
 namespace RELPAL {
 
 two_level_score_test::two_level_score_test(cerrorstream& err)
-                    : two_level_base(err), my_valid_null(false), my_reliable_score(false)
+                    : two_level_base(err), my_valid_null(false), my_reliable_score(false),
+                      my_seed(0)
 {
   my_null_IBD_covariances.resize(0);
   my_IBD_covariances.resize(0);
@@ -501,6 +503,168 @@ two_level_score_test::maximize_correction_2(semi_definite& correction_fn, double
   return 0.0;
 }
 
+// - Draws a standard normal deviate by the polar method.  The second
+//   deviate of each pair is kept for the next call.
+//
+static double
+get_random_normal(const MersenneTwister& rng, bool& have_spare, double& spare)
+{
+  if( have_spare )
+  {
+    have_spare = false;
+    return spare;
+  }
+
+  double u1, u2, s;
+
+  do
+  {
+    u1 = 2.0 * rng.uniform_real() - 1.0;
+    u2 = 2.0 * rng.uniform_real() - 1.0;
+
+    s = u1 * u1 + u2 * u2;
+  }
+  while ( s > 1.0 );
+
+  s = sqrt( (-2.0 * log(s) ) / s );
+
+  spare      = u1 * s;
+  have_spare = true;
+
+  return u2 * s;
+}
+
+// - The replicates of an empirical p-value.  A replicate draws a random
+//   direction for U*, and its result is the chi-square tail probability of
+//   the observed T relative to the corrected T of that direction.
+//
+class score_test_replicates : public PALBASE::replicate_task
+{
+  public:
+
+    score_test_replicates(two_level_score_test& test, const PALBASE::replicate_engine& engine,
+                          size_t test_df, double T_org, double precision, size_t min_replicates,
+                          const matrix& sigma_star_i, const matrix& sigma_star_sqrt)
+      : my_test(test), my_test_df(test_df), my_T_org(T_org),
+        my_precision(precision), my_min_replicates(min_replicates),
+        my_sigma_star_i(sigma_star_i), my_sigma_star_sqrt(sigma_star_sqrt),
+        my_Ti(engine.batch_size(), QNAN)
+    { }
+
+    virtual void compute(size_t replicate, size_t slot, size_t, MersenneTwister& rng);
+    virtual bool accumulate(size_t replicate, size_t slot);
+
+    const SampleInfo& get_info() const { return my_di_info; }
+
+  private:
+
+    two_level_score_test&  my_test;
+
+    size_t                 my_test_df;
+    double                 my_T_org;
+    double                 my_precision;
+    size_t                 my_min_replicates;
+
+    const matrix&          my_sigma_star_i;
+    const matrix&          my_sigma_star_sqrt;
+
+    vector<double>         my_Ti;            // NaN if the replicate is skipped
+
+    SampleInfo             my_di_info;
+};
+
+void
+score_test_replicates::compute(size_t replicate, size_t slot, size_t, MersenneTwister& rng)
+{
+  const matrix& U_star = my_test.my_score_2.U_star;
+
+  int df = U_star.rows();
+
+  matrix C_vec;
+  C_vec.resize_nofill(df, U_star.cols());
+
+  double C_sq_sum   = 0.0;
+  bool   have_spare = false;
+  double spare      = 0.0;
+
+  for( int j = 0; j < df; ++j )
+  {
+    double C = get_random_normal(rng, have_spare, spare);
+
+    C_vec(j, 0) = C;
+    C_sq_sum += (C * C);
+  }
+
+  matrix sim_U_star;
+  multiply(my_sigma_star_sqrt, C_vec/sqrt(C_sq_sum), sim_U_star);
+
+  if( my_test.my_debug_out )
+  {
+    my_test.debug_out() << endl << "replicate" << replicate << " : C_sq_sum = " << C_sq_sum << endl;
+    print_matrix(C_vec, my_test.debug_out(), "C");
+
+    matrix temp, sim_T;
+    XTZ(sim_U_star, my_sigma_star_i, temp);
+    multiply(temp, sim_U_star, sim_T);
+
+    print_matrix(sim_T, my_test.debug_out(), "sim_T");
+  }
+
+  double sim_correction = my_test.compute_correction(sim_U_star, my_sigma_star_i);
+
+  if( my_test.my_debug_out )
+    my_test.debug_out() << "sim_correction = " << sim_correction << endl;
+
+  //double Ti = sim_T(0, 0) + sim_correction;
+  // no need to compute sim_T since always 1.0
+  my_Ti[slot] = 1.0 + sim_correction;
+}
+
+bool
+score_test_replicates::accumulate(size_t replicate, size_t slot)
+{
+  double Ti = my_Ti[slot];
+
+  if( isnan(Ti) )
+    return false;
+
+  if( Ti > 0.0 )
+  {
+    double T_ratio = my_T_org/Ti;
+    double cdfi    = chi_square_cdf(my_test_df, T_ratio);
+
+    if( !isnan(cdfi) )
+      my_di_info += (1.0 - cdfi);
+    else
+      my_di_info += 0.0;
+
+    if( my_test.my_debug_out )
+    {
+      my_test.debug_out() << "Ti       = " << Ti << endl
+                          << "T_org/Ti = " << T_ratio << endl
+                          << "cdfi     = " << cdfi << endl
+                          << "sum_cdfi = " << my_di_info.sum() << endl;
+    }
+  }
+  else
+    my_di_info += 0.0;
+
+  double pi  = my_di_info.mean();
+  double var = my_di_info.variance();
+  double n   = (double)my_di_info.count();
+  double m   = n*pi*pi / var;
+
+  if( my_test.my_debug_out )
+  {
+    my_test.debug_out() << "n        = " << n << endl
+                        << "pi       = " << pi << endl
+                        << "m        = " << m << endl;
+    my_test.debug_out() << "var      = " << var << endl;
+  }
+
+  return replicate > my_min_replicates && finite(m) && m > my_precision;
+}
+
 double
 two_level_score_test::compute_empirical_p_value(size_t& rep_count, size_t test_df,
                                                 double T, double correction,
@@ -519,8 +683,6 @@ two_level_score_test::compute_empirical_p_value(size_t& rep_count, size_t test_d
     return 1.0;
   }
 
-  int df = my_score_2.U_star.rows();
-
   if( my_debug_out )
   {
     double pu        = 1.0 - chi_square_cdf(test_df, T_org);
@@ -530,12 +692,10 @@ two_level_score_test::compute_empirical_p_value(size_t& rep_count, size_t test_d
                 << ", threshold = " << threshold << endl;
   }
 
-  size_t seed = my_model.get_pvalue_options().seed;
+  size_t seed = my_seed ? my_seed : my_model.get_pvalue_options().seed;
 
   if( seed == 0 )
-    my_random_generator.reseed((long) time(NULL) + getpid());
-  else
-    my_random_generator.reseed((long)seed);
+    seed = PALBASE::replicate_engine::clock_seed();
 
   double alpha     = my_model.get_pvalue_options().confidence;
   double width     = my_model.get_pvalue_options().width;
@@ -552,130 +712,24 @@ two_level_score_test::compute_empirical_p_value(size_t& rep_count, size_t test_d
   size_t min_replicates = my_model.get_pvalue_options().min_replicates;
   size_t max_replicates = my_model.get_pvalue_options().max_replicates;
 
-  SampleInfo di_info;
-
-  for( size_t i = 0; i < max_replicates;  ++i )
-  {
-    matrix C_vec;
-    C_vec.resize_nofill(df, my_score_2.U_star.cols());
-
-    double C_sq_sum = 0.0;
-
-    for( int j = 0; j < df; ++j )
-    {
-      double C = get_random_normal();
-
-      C_vec(j, 0) = C;
-      C_sq_sum += (C * C);
-    }
-
-    matrix sim_U_star;
-    multiply(sigma_star_sqrt, C_vec/sqrt(C_sq_sum), sim_U_star);
-
-    if( my_debug_out )
-    {
-      debug_out() << endl << "replicate" << i << " : C_sq_sum = " << C_sq_sum << endl;
-      print_matrix(C_vec, debug_out(), "C");
-
-      //print_matrix(sigma_sqrt, debug_out(), "sigma^0.5");
-      //print_matrix(sim_U_star, debug_out(), "sim_U*");
-
-      matrix temp, sim_T;
-      XTZ(sim_U_star, sigma_star_i, temp);
-      multiply(temp, sim_U_star, sim_T);
-
-      print_matrix(sim_T, debug_out(), "sim_T");
-    }
-
-    double sim_correction = compute_correction(sim_U_star, sigma_star_i);
-
-    if( my_debug_out )
-      debug_out() << "sim_correction = " << sim_correction << endl;
-
-    if( isnan(sim_correction) )
-      continue;
-
-    //double Ti = sim_T(0, 0) + sim_correction;
-    // no need to compute sim_T since always 1.0
-    double Ti = 1.0 + sim_correction;
-
-    if( Ti > 0.0 )
-    {
-      double T_ratio = T_org/Ti;
-      double cdfi    = chi_square_cdf(test_df, T_ratio);
+  // The debug output is written as the replicates are computed, so they are
+  // computed one at a time.
 
-      if( !isnan(cdfi) )
-        di_info += (1.0 - cdfi);
-      else
-        di_info += 0.0;
+  PALBASE::replicate_engine engine((unsigned long) seed, my_debug_out ? 1 : 0);
 
-      if( my_debug_out )
-      {
-        debug_out() << "Ti       = " << Ti << endl
-                    << "T_org/Ti = " << T_ratio << endl
-                    << "cdfi     = " << cdfi << endl
-                    << "sum_cdfi = " << di_info.sum() << endl;
-      }
-    }
-    else
-      di_info += 0.0;
+  if( my_debug_out )
+    engine.set_batch_size(1);
 
-    double pi  = di_info.mean();
-    double var = di_info.variance();
-    double n   = (double)di_info.count();
-    double m   = n*pi*pi / var;
+  score_test_replicates replicates(*this, engine, test_df, T_org, precision, min_replicates,
+                                   sigma_star_i, sigma_star_sqrt);
 
-    if( my_debug_out )
-    {
-      debug_out() << "n        = " << n << endl
-                  << "pi       = " << pi << endl
-                  << "m        = " << m << endl;
-      debug_out() << "var      = " << var << endl;
-    }
-
-    if( i > min_replicates && finite(m) && m > precision )
-      break;
-  }
+  engine.run(replicates, max_replicates);
 
-  rep_count = di_info.count();
+  rep_count = replicates.get_info().count();
 
-  return di_info.mean();
+  return replicates.get_info().mean();
 }
 
-double
-two_level_score_test::get_random_normal()
-{
-  static int iset = 0;
-  static double gset;
-
-  if( iset == 0 )
-  {
-    double u1, u2, s;
-
-    do
-    {
-      u1 = 2.0 * my_random_generator.uniform_real() - 1.0;
-      u2 = 2.0 * my_random_generator.uniform_real() - 1.0;
-
-      s = u1 * u1 + u2 * u2;
-    }
-    while ( s > 1.0 );
-
-    s = sqrt( (-2.0 * log(s) ) / s );
-
-    gset = u1 * s;
-
-    iset = 1;
-
-    return u2 * s;
-  }
-  else
-  {
-    iset = 0;
-    return gset;
-  }
-}   
-
 void
 two_level_score_test::correction_tests()
 {
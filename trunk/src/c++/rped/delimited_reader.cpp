@@ -0,0 +1,584 @@
+/////////////////////////////////////////////////////////////
+// delimited_reader:  bulk reading of character-delimited  //
+//                    pedigree data files                  //
+//     (implementation code )                              //
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <limits>
+#include <algorithm>
+#include "rped/delimited_reader.h"
+
+#if !defined(WIN32)
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace SAGE {
+namespace RPED {
+
+// - Target size of a chunk.  Chunks end at the first line end after this
+//   many bytes.  Parsed, a chunk takes several times its size, so a batch
+//   (one chunk per thread) stays small however large the file.
+//
+const size_t CHUNK_BYTES = 1 << 20;
+
+//============================================================================
+// IMPLEMENTATION:  mapped_text
+//============================================================================
+//
+mapped_text::mapped_text()
+  : my_base(NULL), my_size(0), my_mapped(false)
+{ }
+
+mapped_text::~mapped_text()
+{
+  close();
+}
+
+bool
+mapped_text::open(const std::string& filename)
+{
+  close();
+
+#if !defined(WIN32)
+  int fd = ::open(filename.c_str(), O_RDONLY);
+
+  if(fd < 0)
+    return false;
+
+  struct stat st;
+
+  if(!fstat(fd, &st) && st.st_size > 0)
+  {
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    if(base != MAP_FAILED)
+    {
+      // The mapping holds its own reference to the file.
+      ::close(fd);
+
+      my_base   = static_cast<const char*>(base);
+      my_size   = st.st_size;
+      my_mapped = true;
+
+      return true;
+    }
+  }
+
+  ::close(fd);
+#endif
+
+  // Files which can't be mapped (pipes, empty files, WIN32) are read.
+
+  FILE* file = fopen(filename.c_str(), "rb");
+
+  if(!file)
+    return false;
+
+  char   block[65536];
+  size_t n;
+
+  while((n = fread(block, 1, sizeof(block), file)) > 0)
+    my_buffer.insert(my_buffer.end(), block, block + n);
+
+  fclose(file);
+
+  my_base = my_buffer.empty() ? NULL : &my_buffer[0];
+  my_size = my_buffer.size();
+
+  return true;
+}
+
+void
+mapped_text::close()
+{
+#if !defined(WIN32)
+  if(my_mapped)
+    munmap(const_cast<char*>(my_base), my_size);
+#endif
+
+  std::vector<char>().swap(my_buffer);
+
+  my_base   = NULL;
+  my_size   = 0;
+  my_mapped = false;
+}
+
+const char*
+mapped_text::second_line() const
+{
+  const char* nl = my_size ? static_cast<const char*>(memchr(my_base, '\n', my_size)) : NULL;
+
+  return nl ? nl + 1 : end();
+}
+
+//============================================================================
+// IMPLEMENTATION:  delimited_tokenizer
+//============================================================================
+//
+delimited_tokenizer::delimited_tokenizer(const std::string& delimiters,
+                                         const std::string& whitespace)
+  : my_delimiter(256, false), my_whitespace(256, false),
+    my_default_whitespace(whitespace.empty()),
+    my_skip_consecutive(false), my_skip_leading(false), my_skip_trailing(false),
+    my_line(NULL), my_size(0), my_pos(0),
+    my_first_call(true), my_last(false), my_done(true)
+{
+  my_delimiter[0] = true;
+
+  for(size_t i = 0; i < delimiters.size() && delimiters[i]; ++i)
+    my_delimiter[(unsigned char) delimiters[i]] = true;
+
+  for(size_t i = 0; i < whitespace.size() && whitespace[i]; ++i)
+    my_whitespace[(unsigned char) whitespace[i]] = true;
+}
+
+void
+delimited_tokenizer::set_line(const char* first, const char* last)
+{
+  my_line       = first;
+  my_size       = last - first;
+  my_pos        = 0;
+  my_first_call = true;
+  my_last       = false;
+  my_done       = false;
+}
+
+bool
+delimited_tokenizer::next(text_span& value, std::deque<std::string>& unescaped)
+{
+  if(my_done)
+    return false;
+
+  find_start(my_first_call);
+
+  my_first_call = false;
+
+  if(my_pos >= my_size)
+  {
+    my_done = true;
+    return false;
+  }
+
+  find_end(value, unescaped);
+
+  return true;
+}
+
+// - Elides delimiters.  See string_tokenizer::iterator::find_start() for the
+//   state table.
+//
+void
+delimited_tokenizer::find_start(bool first_field)
+{
+  if(my_pos >= my_size)
+    return;
+
+  bool l = my_skip_leading;
+  bool t = my_skip_trailing;
+  bool c = my_skip_consecutive;
+
+  if( !l && !t && !c )
+    return;
+
+  size_t i = my_pos;
+  for(; i < my_size && my_delimiter[(unsigned char) my_line[i]]; ++i);
+
+  if(i == my_pos)
+    return;
+
+  bool f = first_field;
+  bool e = (i == my_size);
+
+  if( (!t && !c && !f) || (t && !c && !f && !e) || (!l && f) || (f && e && !l && !t))
+    return;
+
+  my_pos = i;
+
+  if( !t && e )
+  {
+    my_last = true;
+    my_pos  = i - 1;
+  }
+}
+
+// - Fields without quotes or escapes, which is almost all of them, are
+//   returned in place.
+//
+void
+delimited_tokenizer::find_end(text_span& value, std::deque<std::string>& unescaped)
+{
+  size_t start = my_pos;
+  size_t j     = start;
+
+  for(; j < my_size; ++j)
+  {
+    char ch = my_line[j];
+
+    if(my_delimiter[(unsigned char) ch] || ch == '"' || ch == '\\')
+      break;
+  }
+
+  if(j < my_size && !my_delimiter[(unsigned char) my_line[j]])
+  {
+    unescaped.push_back(std::string());
+
+    std::string& s = unescaped.back();
+
+    unescape(start, s);
+
+    value = strip(s.data(), s.data() + s.size());
+
+    return;
+  }
+
+  value  = strip(my_line + start, my_line + j);
+  my_pos = j;
+
+  if(j < my_size)
+  {
+    my_pos = j + 1;
+
+    // A delimiter at the very end leaves one more, empty, field.
+    if(!my_last && my_pos == my_size)
+    {
+      --my_pos;
+      my_last = true;
+    }
+  }
+}
+
+// - Quoted and escaped fields, exactly as string_tokenizer::iterator::find_end().
+//
+void
+delimited_tokenizer::unescape(size_t start, std::string& value)
+{
+  bool literal    = false;
+  bool quoted     = false;
+  bool last_quote = false;
+
+  my_pos = start;
+
+  while(my_pos < my_size)
+  {
+    char c = my_line[my_pos++];
+
+    if(    !quoted
+        && !(c == '"' && last_quote)
+        && !literal
+        && my_delimiter[(unsigned char) c] )
+    {
+      if(!my_last && my_pos == my_size)
+      {
+        --my_pos;
+        my_last = true;
+      }
+
+      break;
+    }
+
+    if(literal)
+    {
+      literal = false;
+      switch(c)
+      {
+        case 'n' : value += '\n'; break;
+        case 't' : value += '\t'; break;
+        default  : value += c;    break;
+      }
+      continue;
+    }
+    else if(c == '\\')
+    {
+      last_quote = false;
+      literal    = true;
+    }
+    else if(c == '"')
+    {
+      if(last_quote)
+      {
+        last_quote = false;
+        quoted     = !quoted;
+        value     += c;
+      }
+      else if(quoted)
+      {
+        quoted     = false;
+        last_quote = true;
+      }
+      else
+      {
+        quoted     = true;
+      }
+    }
+    else
+    {
+      last_quote = false;
+      value     += c;
+    }
+  }
+}
+
+text_span
+delimited_tokenizer::strip(const char* first, const char* last) const
+{
+  const char* b = first;
+  const char* e = last;
+
+  if(my_default_whitespace)
+  {
+    for(; b != e && isspace((unsigned char) *b);      ++b);
+    for(; e != b && isspace((unsigned char) *(e - 1)); --e);
+  }
+  else
+  {
+    for(; b != e && my_whitespace[(unsigned char) *b];      ++b);
+    for(; e != b && my_whitespace[(unsigned char) *(e - 1)]; --e);
+  }
+
+  // Empty values still point into the line, so that they are present.
+  return text_span(b == e ? first : b, e - b);
+}
+
+//============================================================================
+// IMPLEMENTATION:  column_layout
+//============================================================================
+//
+column_layout::column_layout(size_t width)
+  : my_used_columns(0), my_width(width)
+{ }
+
+void
+column_layout::add_column(action_t action, size_t slot, bool stripped)
+{
+  column c;
+
+  c.action   = action;
+  c.slot     = slot;
+  c.stripped = stripped;
+
+  my_columns.push_back(c);
+
+  if(action == ignore)
+    return;
+
+  my_used_columns = my_columns.size();
+  my_width        = std::max(my_width, slot + (action == store_pair ? 2 : 1));
+}
+
+void
+column_layout::set_numeric(size_t slot, const RefTraitInfo& trait)
+{
+  if(my_numeric_index.size() <= slot)
+    my_numeric_index.resize(slot + 1, (size_t)-1);
+
+  my_numeric_index[slot] = my_numeric_slots.size();
+
+  my_numeric_slots .push_back(slot);
+  my_numeric_traits.push_back(&trait);
+}
+
+//============================================================================
+// IMPLEMENTATION:  parsed_chunk
+//============================================================================
+//
+parsed_chunk::parsed_chunk()
+  : my_width(0), my_numeric_count(0), my_line_count(0)
+{ }
+
+// - Storage is kept from chunk to chunk, so after the first batch, parsing
+//   allocates nothing except for quoted or escaped values.
+//
+void
+parsed_chunk::parse(const char* first, const char* last,
+                    const column_layout& layout, delimited_tokenizer& tokenizer)
+{
+  my_width         = layout.width();
+  my_numeric_count = layout.numeric_count();
+  my_line_count    = 0;
+
+  my_lines    .resize(0);
+  my_values   .resize(0);
+  my_numbers  .resize(0);
+  my_codes    .resize(0);
+  my_unescaped.clear();
+
+  const std::vector<column_layout::column>& columns = layout.my_columns;
+
+  for(const char* p = first; p < last; )
+  {
+    const char* nl  = static_cast<const char*>(memchr(p, '\n', last - p));
+    const char* eol = nl ? nl : last;
+
+    ++my_line_count;
+
+    if(eol != p)
+    {
+      size_t row = my_lines.size();
+
+      my_lines .push_back(my_line_count);
+      my_values.resize((row + 1) * my_width);
+
+      text_span* values = my_width ? &my_values[row * my_width] : NULL;
+
+      tokenizer.set_line(p, eol);
+
+      text_span field;
+
+      for(size_t c = 0; c < layout.my_used_columns && tokenizer.next(field, my_unescaped); ++c)
+      {
+        const column_layout::column& col = columns[c];
+
+        if(col.action == column_layout::ignore)
+          continue;
+
+        if(col.stripped)
+        {
+          const char* b = field.first;
+          const char* e = field.first + field.size;
+
+          for(; b != e && isspace((unsigned char) *b);      ++b);
+          for(; e != b && isspace((unsigned char) *(e - 1)); --e);
+
+          field = text_span(b == e ? field.first : b, e - b);
+        }
+
+        if(col.action == column_layout::store || values[col.slot].empty())
+          values[col.slot] = field;
+        else
+          values[col.slot + 1] = field;
+      }
+
+      for(size_t k = 0; k < my_numeric_count; ++k)
+      {
+        const text_span& value = values[layout.my_numeric_slots[k]];
+
+        double d    = std::numeric_limits<double>::quiet_NaN();
+        int    code = -1;
+
+        if(value.present())
+        {
+          value.assign_to(my_scratch);
+
+          code = layout.my_numeric_traits[k]->convert_value(my_scratch, d);
+        }
+
+        my_numbers.push_back(d);
+        my_codes  .push_back(code);
+      }
+    }
+
+    p = nl ? nl + 1 : last;
+  }
+}
+
+//============================================================================
+// IMPLEMENTATION:  chunk_reader
+//============================================================================
+//
+// - Parses the chunks of a batch, one per item, with one tokenizer per
+//   worker.
+//
+class chunk_reader::batch : public UTIL::ParallelTask
+{
+  public:
+
+    batch(chunk_reader& r)
+      : my_reader(r), my_done(r.my_chunk_count, 0)
+    { }
+
+    virtual void run(size_t item, size_t worker)
+    {
+      my_reader.my_chunks[item].parse(my_reader.my_bounds[item],
+                                      my_reader.my_bounds[item + 1],
+                                      my_reader.my_layout,
+                                      my_reader.my_tokenizers[worker]);
+
+      my_done[item] = 1;
+    }
+
+    bool done(size_t item) const { return my_done[item]; }
+
+  private:
+
+    chunk_reader&     my_reader;
+    std::vector<char> my_done;
+};
+
+chunk_reader::chunk_reader(const mapped_text& text, const char* start,
+                           const column_layout& layout, const delimited_tokenizer& tokenizer,
+                           size_t thread_count)
+  : my_layout(layout), my_next(start), my_end(text.end()),
+    my_pool(thread_count), my_chunk_bytes(CHUNK_BYTES),
+    my_tokenizers(my_pool.thread_count(), tokenizer),
+    my_chunks(my_pool.thread_count()),
+    my_bounds(my_pool.thread_count() + 1, (const char*) NULL),
+    my_first_lines(my_pool.thread_count(), 0),
+    my_chunk_count(0), my_lines_read(0)
+{ }
+
+chunk_reader::~chunk_reader()
+{ }
+
+// - If a chunk throws, the ones which didn't complete are parsed again in
+//   order, so that the exception reaches our caller as it would without
+//   threads.
+//
+bool
+chunk_reader::next_batch()
+{
+  my_chunk_count = 0;
+
+  if(my_next >= my_end)
+    return false;
+
+  my_bounds[0] = my_next;
+
+  while(my_chunk_count < my_chunks.size() && my_next < my_end)
+  {
+    const char* stop = my_end;
+
+    if((size_t) (my_end - my_next) > my_chunk_bytes)
+    {
+      const char* from = my_next + my_chunk_bytes - 1;
+      const char* nl   = static_cast<const char*>(memchr(from, '\n', my_end - from));
+
+      if(nl)
+        stop = nl + 1;
+    }
+
+    my_next = stop;
+
+    my_bounds[++my_chunk_count] = stop;
+  }
+
+  batch b(*this);
+
+  if( !my_pool.run(my_chunk_count, b) )
+  {
+    for( size_t i = 0; i < my_chunk_count; ++i )
+      if( !b.done(i) )
+        b.run(i, 0);
+  }
+
+  for( size_t c = 0; c < my_chunk_count; ++c )
+  {
+    my_first_lines[c] = my_lines_read;
+    my_lines_read    += my_chunks[c].line_count();
+  }
+
+  return true;
+}
+
+} // End namespace RPED
+} // End namespace SAGE
@@ -0,0 +1,149 @@
+//============================================================================
+//  RefMarkerColumn -- packed storage of the phenotypes of a marker
+//
+//  History:   10/17/26 - created.
+//
+//  Copyright (c) 2026  R.C. Elston
+//    All Rights Reserved
+//============================================================================
+
+#include <algorithm>
+#include <cstring>
+#include "rped/marker_column.h"
+
+namespace SAGE {
+namespace RPED {
+
+namespace {
+
+uint32_t shift_for(uint32_t width)
+{
+  switch(width)
+  {
+    case 2  : return 4;
+    case 4  : return 3;
+    case 8  : return 2;
+    default : return 0;
+  }
+}
+
+}
+
+RefMarkerColumn::RefMarkerColumn()
+  : my_size(0), my_width(2), my_shift(4)
+{
+  my_inline[0] = my_inline[1] = 0;
+}
+
+RefMarkerColumn::RefMarkerColumn(const RefMarkerColumn& c)
+  : my_size(c.my_size), my_width(c.my_width), my_shift(c.my_shift)
+{
+  if(c.is_inline())
+  {
+    my_inline[0] = c.my_inline[0];
+    my_inline[1] = c.my_inline[1];
+  }
+  else
+  {
+    my_heap = new uint32_t[word_count()];
+
+    std::memcpy(my_heap, c.my_heap, word_count() * sizeof(uint32_t));
+  }
+}
+
+RefMarkerColumn::~RefMarkerColumn()
+{
+  if(!is_inline())
+    delete [] my_heap;
+}
+
+RefMarkerColumn&
+RefMarkerColumn::operator=(const RefMarkerColumn& c)
+{
+  if(this != &c)
+  {
+    RefMarkerColumn tmp(c);
+
+    swap(tmp);
+  }
+
+  return *this;
+}
+
+void
+RefMarkerColumn::swap(RefMarkerColumn& c)
+{
+  // The union is swapped as raw words, whichever member is in use.
+
+  uint32_t storage[sizeof(my_inline) / sizeof(uint32_t)];
+
+  std::memcpy(storage,     my_inline,   sizeof(my_inline));
+  std::memcpy(my_inline,   c.my_inline, sizeof(my_inline));
+  std::memcpy(c.my_inline, storage,     sizeof(my_inline));
+
+  std::swap(my_size,  c.my_size);
+  std::swap(my_width, c.my_width);
+  std::swap(my_shift, c.my_shift);
+}
+
+void
+RefMarkerColumn::resize(size_t n, uint32_t fill)
+{
+  size_t   old_size = my_size;
+  uint32_t width    = std::max((uint32_t) my_width, width_for(fill));
+
+  reshape(n, width);
+
+  for(size_t i = old_size; i < n; ++i)
+    set(i, fill);
+}
+
+void
+RefMarkerColumn::unpack(uint32_t* out) const
+{
+  const uint32_t* w         = words();
+  const size_t    per_word  = (size_t) 1 << my_shift;
+  const size_t    full      = my_size >> my_shift;
+  const uint32_t  m         = mask();
+
+  // Whole words at a time, then the rest of the last.
+
+  for(size_t k = 0; k < full; ++k)
+  {
+    uint32_t word = w[k];
+
+    for(size_t j = 0; j < per_word; ++j, word = (uint32_t) ((uint64_t) word >> my_width))
+      *out++ = word & m;
+  }
+
+  for(size_t i = full << my_shift; i < my_size; ++i)
+    *out++ = get(i);
+}
+
+void
+RefMarkerColumn::reshape(size_t n, uint32_t width)
+{
+  RefMarkerColumn tmp;
+
+  tmp.my_size  = (uint32_t) n;
+  tmp.my_width = (unsigned char) width;
+  tmp.my_shift = (unsigned char) shift_for(width);
+
+  if(tmp.is_inline())
+    tmp.my_inline[0] = tmp.my_inline[1] = 0;
+  else
+    tmp.my_heap = new uint32_t[tmp.word_count()]();
+
+  size_t kept = std::min(n, (size_t) my_size);
+
+  if(width == my_width)
+    std::memcpy(tmp.words(), words(), ((kept + (1u << my_shift) - 1) >> my_shift) * sizeof(uint32_t));
+  else
+    for(size_t i = 0; i < kept; ++i)
+      tmp.set(i, get(i));
+
+  swap(tmp);
+}
+
+} // End namespace RPED
+} // End namespace SAGE
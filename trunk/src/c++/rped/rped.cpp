@@ -225,7 +225,7 @@ void
 RefPedInfo::remove_marker(size_t m_id)
 {
   assert(m_id < my_markers.size());
-  my_markers[m_id] = my_markers[my_markers.size()-1];
+  my_markers[m_id].swap(my_markers[my_markers.size()-1]);
 
   my_markers.pop_back();
 
@@ -276,61 +276,65 @@ RefPedInfo::set_trait(size_t i, size_t t, const std::string & value, RefTraitInf
   // Continuous or binary trait
   else
   {
-    double d = str2doub(value);
+    double d;
 
-    if(!finite(d))
-      code = 2;
-
-    std::string smiss  = trait_info.string_missing_code  ();
-    double      nmiss  = trait_info.numeric_missing_code ();
+    code = trait_info.convert_value(value, d);
 
-    if( value == smiss || (finite(nmiss) && d == nmiss))
-    {
-      code = 1;
-      d    = numeric_limits<double>::quiet_NaN();
-    }
-    else if( trait_info.type() == RefTraitInfo::binary_trait )
+    if(!set_trait(i, t, d))
     {
-      double thresh = trait_info.threshold();
-        
-      if(value == trait_info.string_affected_code() )
-      {    
-        code = 0;
-        d    = 1.0;
-      }
-      else if( value == trait_info.string_unaffected_code() )
-      {
-        code = 0;
-        d    = 0.0;
-      }
-      else if( finite(d) && d == trait_info.numeric_affected_code() )
-      {    
-        code = 0;
-        d = 1.0;
-      }
-      else if( finite(d) && d == trait_info.numeric_unaffected_code() )
-      {
-        code = 0;
-        d = 0.0;
-      }
-      else if( finite(d) && finite(thresh) )
-      {
-        code = 0;
-        d    = (d > thresh) ? 1.0 : 0.0;
-      }
-      else
-      {
-        code = 2;
-        d = numeric_limits<double>::quiet_NaN();
-      }
+      code = 3;
     }
+  }
 
-    if(!set_trait(i, t, d))
+
+  return code;
+}
+
+// Returns: as set_trait() above.  Categorical traits, whose categories are
+//          strings, are set through set_trait() above.
+int
+RefPedInfo::set_trait(size_t i, size_t t, double value, RefTraitInfo & trait_info)
+{
+  if(t >= trait_count() || i >= member_count())
+    return 3;
+
+  if(trait_info.type() == RefTraitInfo::invalid_trait)
+    return 4;
+
+  if(trait_info.type() == RefTraitInfo::categorical_trait)
+    return set_trait(i, t, SAGE::isnan(value) ? trait_info.string_missing_code() : doub2str(value), trait_info);
+
+  int    code  = 0;
+  double nmiss = trait_info.numeric_missing_code();
+
+  if(SAGE::isnan(value) || (finite(nmiss) && value == nmiss))
+  {
+    code  = 1;
+    value = numeric_limits<double>::quiet_NaN();
+  }
+  else if(!finite(value))
+  {
+    code  = 2;
+    value = numeric_limits<double>::quiet_NaN();
+  }
+  else if(trait_info.type() == RefTraitInfo::binary_trait)
+  {
+    double thresh = trait_info.threshold();
+
+    if(value == trait_info.numeric_affected_code())
+      value = 1.0;
+    else if(value == trait_info.numeric_unaffected_code())
+      value = 0.0;
+    else if(finite(thresh))
+      value = (value > thresh) ? 1.0 : 0.0;
+    else
     {
-      code = 3;
+      code  = 2;
+      value = numeric_limits<double>::quiet_NaN();
     }
   }
 
+  my_traits[t][i] = value;
 
   return code;
 }
@@ -873,6 +877,66 @@ RefTraitInfo::get_id(const std::string & category) const
       
   return (size_t)-1;
 }
+
+// Returns: 0 - value ok
+//          1 - value ok, but missing
+//          2 - bad value, assumed missing
+int
+RefTraitInfo::convert_value(const std::string & value, double & d) const
+{
+  int code = 0;
+
+  d = str2doub(value);
+
+  if(!finite(d))
+    code = 2;
+
+  const std::string & smiss = string_missing_code  ();
+  double              nmiss = numeric_missing_code ();
+
+  if( value == smiss || (finite(nmiss) && d == nmiss))
+  {
+    code = 1;
+    d    = numeric_limits<double>::quiet_NaN();
+  }
+  else if( type() == RefTraitInfo::binary_trait )
+  {
+    double thresh = threshold();
+      
+    if(value == string_affected_code() )
+    {    
+      code = 0;
+      d    = 1.0;
+    }
+    else if( value == string_unaffected_code() )
+    {
+      code = 0;
+      d    = 0.0;
+    }
+    else if( finite(d) && d == numeric_affected_code() )
+    {    
+      code = 0;
+      d = 1.0;
+    }
+    else if( finite(d) && d == numeric_unaffected_code() )
+    {
+      code = 0;
+      d = 0.0;
+    }
+    else if( finite(d) && finite(thresh) )
+    {
+      code = 0;
+      d    = (d > thresh) ? 1.0 : 0.0;
+    }
+    else
+    {
+      code = 2;
+      d = numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  return code;
+}
     
 
 } // end namespace RPED
@@ -5,6 +5,7 @@
 #include <iomanip>
 #include "mped/sp.h"
 #include "rped/rpfile.h"
+#include "rped/delimited_reader.h"
 #include "error/errorstream.h"
 #include "error/errormanip.h"
 #include "error/internal_error.h"
@@ -344,6 +345,49 @@ RefDelimitedPedigreeFile::validate_format(const std::string &filename)
   return true;
 }
 
+// - Phenotypes already set from each pair of values at a marker.  Setting a
+//   phenotype from its values composes, parses and looks up a genotype name,
+//   and a marker has few distinct values, so the results are remembered.
+//   They are forgotten when alleles or phenotypes are added to the marker,
+//   in case that changes them.
+//
+struct phenotype_cache
+{
+  typedef std::map<string, pair<uint, int> > value_map;
+
+  phenotype_cache() : alleles(0), phenotypes(0) { }
+
+  void check(const RefMarkerInfo& marker_info)
+  {
+    if( alleles != marker_info.allele_count() || phenotypes != marker_info.phenotype_count() )
+    {
+      values.clear();
+
+      alleles    = marker_info.allele_count();
+      phenotypes = marker_info.phenotype_count();
+    }
+  }
+
+  uint      alleles;
+  uint      phenotypes;
+  value_map values;
+};
+
+// - The bulk tokenizer for the file's data lines, with the same settings as
+//   setup_tokenizer() gives a string_tokenizer.
+//
+static delimited_tokenizer
+make_tokenizer(const RefDelimitedPedigreeFile& file)
+{
+  delimited_tokenizer tokenizer( file.delimiters(), file.whitespace() );
+
+  tokenizer.set_skip_consecutive_delimiters( file.skip_consecutive_delimiters() );
+  tokenizer.set_skip_leading_delimiters( file.skip_leading_delimiters() );
+  tokenizer.set_skip_trailing_delimiters( file.skip_trailing_delimiters() );
+
+  return tokenizer;
+}
+
 //====================================================
 //
 //  input_pedigree(...)
@@ -355,20 +399,23 @@ RefDelimitedPedigreeFile::input_pedigree(RefMultiPedigree& p,
                                          ostream&          messages,
                                          bool              quiet)
 {
-  std::ifstream infile(filename.c_str());
+  mapped_text text;
+
+  if( !text.open(filename) )
+  {
+    errors << priority(fatal) << "Unable to open Family Data file '" << filename << "'. Please check your file." << std::endl;
+
+    invalidate();
+    return false;
+  }
 
   string_tokenizer tokenizer( format() );
   
   setup_tokenizer(tokenizer);
 
-  std::string line;   // Current line
-
   // Skip the header if it's in the file.  validate_format() will have already
   // set it.
-  if( format_in_file() )
-  {
-    getline(infile, line);
-  }
+  const char* data_start = format_in_file() ? text.second_line() : text.begin();
 
   const RefMPedInfo &mped_info = p.info();
 
@@ -397,69 +444,72 @@ RefDelimitedPedigreeFile::input_pedigree(RefMultiPedigree& p,
 //      has_pedigree_id_field = true;
 //  }
 
-  for( size_t count = 1; infile.good(); ++count )
-  {
-    getline(infile, line);
+  // Slots of a row: pedigree, individual, the two parents and sex.
+  column_layout layout(5);
 
-    if(!line.size())
-      continue;
-
-    std::string ped_name = "",                           // Pedigree id
-                ind_name = "",                           // Individual id
-                parent1  = "",                           // Parent1
-                parent2  = "",                           // Parent2
-                sex      = mped_info.sex_code_unknown(); // Sex code
+  for(field_list_type::const_iterator f = my_fields.begin(); f != my_fields.end(); ++f)
+  {
+    switch( f->type )
+    {
+      case pedigree_id   : layout.add_column(column_layout::store,      0); break;
+      case individual_id : layout.add_column(column_layout::store,      1); break;
+      case parent_id     : layout.add_column(column_layout::store_pair, 2); break;
+      case sex_code      : layout.add_column(column_layout::store,      4); break;
+      default            : layout.add_column(column_layout::ignore);        break;
+    }
+  }
 
-    tokenizer.set_str(line);
+  chunk_reader reader(text, data_start, layout, make_tokenizer(*this));
 
-    field_list_type::const_iterator  field_info     = my_fields.begin (),
-                                     field_info_end = my_fields.end   ();
-    string_tokenizer::const_iterator field          = tokenizer.begin (),
-                                     field_end      = tokenizer.end   ();
+  std::string ped_name, ind_name, parent1, parent2, sex;
 
-    // Loop across tokens and field_info's at the same time, processing each:
-    for( ; field_info != field_info_end && field != field_end; ++field_info, ++field)
+  while( reader.next_batch() )
+  {
+    for( size_t c = 0; c < reader.chunk_count(); ++c )
     {
-      switch( field_info->type )
+      const parsed_chunk& chunk = reader.chunk(c);
+
+      for( size_t r = 0; r < chunk.row_count(); ++r )
       {
-        case pedigree_id   : ped_name = *field;    break;
-        case individual_id : ind_name = *field;    break;
-        case parent_id     : if(!parent1.size())
-                               parent1 = *field;
-                             else
-                               parent2 = *field;  break;
-        case sex_code      : sex = *field;        break;
-        default:                                  break;
-      }
+        size_t           count  = reader.first_line(c) + chunk.line(r);
+        const text_span* values = chunk.values(r);
+
+        values[0].assign_to(ped_name);
+        values[1].assign_to(ind_name);
+        values[2].assign_to(parent1);
+        values[3].assign_to(parent2);
+
+        if( values[4].present() )
+          values[4].assign_to(sex);
+        else
+          sex = mped_info.sex_code_unknown();
+
+        // Check for treat_ped_id options:
+        if( !pedigree_id_count() )
+          ped_name = "0";
+        else if( get_treat_as_sibs() == true ) // There's a pedigree_id field and treat_as_sibs is enabled:
+        {
+          parent1 = ped_name + "_parent1";
+          parent2 = ped_name + "_parent2";
 
-    } // End loop-across-tokens
-    
-    // Check for treat_ped_id options:
-    if( !pedigree_id_count() )
-      ped_name = "0";
-    else if( get_treat_as_sibs() == true ) // There's a pedigree_id field and treat_as_sibs is enabled:
-    {
-      parent1 = ped_name + "_parent1";
-      parent2 = ped_name + "_parent2";
-      
-      p.add_member(ped_name, parent1, MPED::SEX_MALE);
-      p.add_member(ped_name, parent2, MPED::SEX_FEMALE);
-    }
+          p.add_member(ped_name, parent1, MPED::SEX_MALE);
+          p.add_member(ped_name, parent2, MPED::SEX_FEMALE);
+        }
 
-    // If parents are still empty for some reason, set them to be missing:
-    parent1 = parent1.size() ? parent1 : mped_info.individual_missing_code();
-    parent2 = parent2.size() ? parent2 : mped_info.individual_missing_code();
-    
-    // Skip this person if any essential bits of info are missing:
-    if(!ped_name.size() && !ind_name.size() && !parent1.size() && !parent2.size() && !sex.size())
-      continue;
+        // If parents are still empty for some reason, set them to be missing:
+        if( !parent1.size() ) parent1 = mped_info.individual_missing_code();
+        if( !parent2.size() ) parent2 = mped_info.individual_missing_code();
 
-    DEBUG_RPEDFILE(errors << priority(debug) << "Found (" << pn  << "," << id  << "," << sex << "," << p1 << "," << p2  << ")" << std::endl; )
+        // Skip this person if any essential bits of info are missing:
+        if(!ped_name.size() && !ind_name.size() && !parent1.size() && !parent2.size() && !sex.size())
+          continue;
 
-    add_member(p, ped_name, ind_name, sex, parent1, parent2, count + format_in_file(), count);
-  }
+        DEBUG_RPEDFILE(errors << priority(debug) << "Found (" << ped_name << "," << ind_name << "," << sex << "," << parent1 << "," << parent2 << ")" << std::endl; )
 
-  infile.close();
+        add_member(p, ped_name, ind_name, sex, parent1, parent2, count + format_in_file(), count);
+      }
+    }
+  }
 
   if( !build_pedigree(p) )
   {
@@ -494,20 +544,23 @@ RefDelimitedPedigreeFile::input_data(RefMultiPedigree& p,
     return true;
 
   // We assume validate_file() has been called already
-  std::ifstream infile( filename.c_str());
+  mapped_text text;
+
+  if( !text.open(filename) )
+  {
+    errors << priority(fatal) << "Unable to open Family Data file '" << filename << "'. Please check your file." << std::endl;
+
+    invalidate();
+    return false;
+  }
 
   string_tokenizer tokenizer( format() );
   
   setup_tokenizer(tokenizer);
 
-  string line;   // Current line
-
   // Skip header if it is in the file.  We assume that it's already been 
   // set by validate_format()
-  if( format_in_file() )
-  {
-    getline(infile, line);
-  }
+  const char* data_start = format_in_file() ? text.second_line() : text.begin();
 
   if( !build_fields(tokenizer, mped_info, quiet) )
   {
@@ -546,267 +599,354 @@ RefDelimitedPedigreeFile::input_data(RefMultiPedigree& p,
 
   verbose = verbose_output();
 
-  field_list_type::const_iterator field_info      = my_fields.begin();
-  field_list_type::const_iterator field_info_end  = my_fields.end();
-
-  vector<pair<size_t,string> >  trait_values( trait_count() );
-  vector<pair<size_t,string> > string_values( string_count() );
+  // Find the fields to be read.  Invalid fields are read over, as before.
+  vector<size_t> traits, strings, markers, covariates;
 
-  // FIXME: This approach to reading markers will certainly have serious
-  //        performance problems in the large scale and is here only for the
-  //        simplicity.  A hash_map implementation would be much better.  A
-  //        separate index vector is the optimal solution in the long term.
-  typedef pair<string, string>          string_pair;
-  typedef std::map<size_t, string_pair> marker_value_map;
+  field_list_type::const_iterator field_info;
 
-  for( size_t count=1; infile.good(); ++count )
+  for( field_info = my_fields.begin(); field_info != my_fields.end(); ++field_info )
   {
-    getline(infile, line);
+    size_t index = field_info->index;
 
-    if(!line.size())
-      continue;
+    switch( field_info->type )
+    {
+      case         trait: if( index < mped_info.trait_count()  ) traits    .push_back(index); break;
+      case  string_field: if( index < mped_info.string_count() ) strings   .push_back(index); break;
+      case        allele:
+      case        marker: if( index < mped_info.marker_count() ) markers   .push_back(index); break;
+      case    allele_cov:
+      case    marker_cov: if( index < mped_info.trait_count()  ) covariates.push_back(index); break;
+      default:                                                                                 break;
+    }
+  }
 
-    string pn;     // Pedigree id
-    string id;     // Individual id
-    string p1, p2; // Parents
-    string sex;    // Sex code
+  // Markers and marker covariates are set in index order.
+  std::sort(markers.begin(), markers.end());
+  markers.erase(std::unique(markers.begin(), markers.end()), markers.end());
 
-    tokenizer.set_str(line);
+  std::sort(covariates.begin(), covariates.end());
+  covariates.erase(std::unique(covariates.begin(), covariates.end()), covariates.end());
 
-    string_tokenizer::const_iterator field     = tokenizer.begin();
-    string_tokenizer::const_iterator field_end = tokenizer.end();
+  // Slots of a row: pedigree and individual ids, the traits and string fields
+  // in column order, then a pair of values for each marker and each marker
+  // covariate.
+  const size_t trait_slot     = 2;
+  const size_t string_slot    = trait_slot  + traits.size();
+  const size_t marker_slot    = string_slot + strings.size();
+  const size_t covariate_slot = marker_slot + 2 * markers.size();
 
-    marker_value_map marker_values;
-    marker_value_map marker_covariate_values;
+  column_layout layout(covariate_slot + 2 * covariates.size());
 
-    for( size_t t = 0; t < trait_count(); ++t )
-      trait_values[t].first = (size_t)-1;
+  size_t tfound = 0;
+  size_t sfound = 0;
 
-    for( size_t s = 0; s < string_count(); ++s )
-      string_values[s].first = (size_t)-1;
+  for( field_info = my_fields.begin(); field_info != my_fields.end(); ++field_info )
+  {
+    size_t index = field_info->index;
+
+    switch( field_info->type )
+    {
+      case   pedigree_id: layout.add_column(column_layout::store, 0); break;
+      case individual_id: layout.add_column(column_layout::store, 1); break;
+      case         trait:
+                          if( index >= mped_info.trait_count() )
+                            layout.add_column(column_layout::ignore);
+                          else
+                            layout.add_column(column_layout::store, trait_slot + tfound++);
+                          break;
+
+      case  string_field:
+                          if( index >= mped_info.string_count() )
+                            layout.add_column(column_layout::ignore);
+                          else
+                            layout.add_column(column_layout::store, string_slot + sfound++, true);
+                          break;
+
+      case        allele:
+      case        marker:
+                          if( index >= mped_info.marker_count() )
+                            layout.add_column(column_layout::ignore);
+                          else
+                            layout.add_column(column_layout::store_pair, marker_slot + 2 *
+                                (std::lower_bound(markers.begin(), markers.end(), index) - markers.begin()), true);
+                          break;
+
+      case    allele_cov:
+      case    marker_cov:
+                          if( index >= mped_info.trait_count() )
+                            layout.add_column(column_layout::ignore);
+                          else
+                            layout.add_column(column_layout::store_pair, covariate_slot + 2 *
+                                (std::lower_bound(covariates.begin(), covariates.end(), index) - covariates.begin()), true);
+                          break;
+
+      default:            layout.add_column(column_layout::ignore); break;
+    }
+  }
+
+  // Values of traits which aren't categorical are converted as they are read.
+  for( size_t tt = 0; tt < traits.size(); ++tt )
+  {
+    const RefTraitInfo& trait_info = mped_info.trait_info(traits[tt]);
+
+    if(    trait_info.type() != RefTraitInfo::categorical_trait
+        && trait_info.type() != RefTraitInfo::invalid_trait )
+      layout.set_numeric(trait_slot + tt, trait_info);
+  }
 
-    size_t tfound = 0;
-    size_t sfound = 0;
+  chunk_reader reader(text, data_start, layout, make_tokenizer(*this));
 
-    for( field_info = my_fields.begin() ;
-         field_info != field_info_end && field != field_end ;
-         ++field_info, ++field)
+  vector<phenotype_cache> phenotypes( markers.size() );
+
+  string pn;     // Pedigree id
+  string id;     // Individual id
+  string value;
+  string allele1, allele2, key;
+
+  while( reader.next_batch() )
+  {
+    for( size_t c = 0; c < reader.chunk_count(); ++c )
     {
-      switch( field_info->type )
+      const parsed_chunk& chunk = reader.chunk(c);
+
+      for( size_t r = 0; r < chunk.row_count(); ++r )
       {
-        case   pedigree_id: pn = *field;    break;
-        case individual_id: id = *field;    break;
-        case         trait:
-                            if( field_info->index >= mped_info.trait_count() )
-                              break;
-                            trait_values[tfound].first  = field_info->index;
-                            trait_values[tfound].second = *field;
-                            ++tfound;
-                            break;
+        size_t           count   = reader.first_line(c) + chunk.line(r);
+        const text_span* values  = chunk.values(r);
+        const double*    numbers = chunk.numbers(r);
+        const int*       codes   = chunk.codes(r);
 
-        case  string_field:
-                            if( field_info->index >= mped_info.string_count() )
-                              break;
-                            string_values[sfound].first  = field_info->index;
-                            string_values[sfound].second = strip_ws(*field);
-                            ++sfound;
-                            break;
+        values[0].assign_to(pn);
+        values[1].assign_to(id);
+
+        if( !pedigree_id_count() )
+          pn = "0";
 
-        case        allele:
-        case        marker:
+        if( !pn.size() || !id.size() )
+          continue;
+
+        if( !id.size() || id == mped_info.individual_missing_code() )
         {
-                            size_t index = field_info->index;
-                            if( index >= mped_info.marker_count() )
-                              break;
+          errors << priority(warning) << "[" << count + format_in_file()
+                 << "] Found an individual ID that is missing or"
+                 << " the same as the missing individual/parent code.  Skipping..."
+                 << std::endl;
+          continue;
+        }
+
+        RefMultiPedigree::member_pointer mem = p.member_find(pn,id);
+
+        // This should only happen when an error has already been reported
+        if( !mem ) continue;
+
+        RefMultiPedigree::pedinfo_type &info = mem->pedigree()->info();
+        int ind_num = mem->index();
+
+        // Make the traits
+        for( size_t tt=0; tt < traits.size(); ++tt )
+        {
+          const text_span& field = values[trait_slot + tt];
+
+          if( !field.present() )
+            continue;
+
+          size_t t = traits[tt];
+          size_t n = layout.numeric_index(trait_slot + tt);
+
+          field.assign_to(value);
 
-                            string_pair &values = marker_values[index];
-                            if( !values.first.size())
-                              values.first = strip_ws(*field);
-                            else
-                              values.second = strip_ws(*field);
-                            break;
+          int code;
+
+          if( n != (size_t)-1 )
+            code = info.set_trait(ind_num, t, numbers[n]) ? codes[n] : 3;
+          else
+            code = info.set_trait(ind_num, t, value, mped_info.trait_info(t));
+
+          switch(code)
+          {
+            case 0:                       // trait ok
+            case 1:                       // trait ok, but missing
+            case 4:                       // trait not set legitimately
+                     break;
+            case 3:                       // invalid ind. or trait id
+                     errors << priority(warning) << "["<<count+format_in_file()
+                            << "] Cannot set trait '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'." << std::endl;
+                     break;
+            case 2:                       // bad trait value
+                     errors << priority(warning) << "["<<count+format_in_file()
+                            << "] Unrecognized value for trait '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'.  Found '" << value << "'." << std::endl;
+
+                     break;
+           default:
+                     errors << priority(error) << "[" <<count+format_in_file()
+                            << "] Unexpected error setting trait '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'." << std::endl;
+                     break;
+          }
         }
 
-        case        allele_cov:
-        case        marker_cov:
+        for( size_t ss=0; ss < strings.size(); ++ss )
         {
-                            size_t index = field_info->index;
+          const text_span& field = values[string_slot + ss];
 
-                            if( index >= mped_info.trait_count() )
-                              break;
+          if( !field.present() )
+            continue;
 
-                            string_pair &values = marker_covariate_values[index];
-                            if( !values.first.size())
-                              values.first = strip_ws(*field);
-                            else
-                              values.second = strip_ws(*field);
-                            break;
+          size_t s = strings[ss];
+
+          field.assign_to(value);
+
+          bool code = info.set_string(ind_num, s, value);
+
+          if(!code)
+            errors << priority(warning) << "["<<count+format_in_file() 
+                   << "] Cannot set string field '"
+                   << mped_info.string_info(s).name()
+                   << "' for individual '" << id << "' in pedigree '"
+                   << pn << "'." << std::endl;
         }
 
-        default:                            break;
-      }
-    }
+        for( size_t mm=0; mm < markers.size(); ++mm )
+        {
+          const text_span* fields = values + marker_slot + 2 * mm;
 
-    if( !pedigree_id_count() )
-      pn = "0";
+          if( !fields[0].present() )
+            continue;
 
-    if( !pn.size() || !id.size() )
-      continue;
+          size_t         m           = markers[mm];
+          RefMarkerInfo& marker_info = mped_info.marker_info(m);
+          MPED::SexCode  sex         = mem->get_effective_sex();
 
-    if( !id.size() || id == mped_info.individual_missing_code() )
-    {
-      errors << priority(warning) << "[" << count + format_in_file()
-             << "] Found an individual ID that is missing or"
-             << " the same as the missing individual/parent code.  Skipping..."
-             << std::endl;
-      continue;
-    }
+          fields[0].assign_to(allele1);
+          fields[1].assign_to(allele2);
 
-    RefMultiPedigree::member_pointer mem = p.member_find(pn,id);
+          // Only autosomal phenotypes are remembered, since the others
+          // depend on sex, and aren't always set.
+          bool autosomal = marker_info.get_model_type() == MLOCUS::AUTOSOMAL;
 
-    // This should only happen when an error has already been reported
-    if( !mem ) continue;
+          phenotype_cache& cache = phenotypes[mm];
 
-    RefMultiPedigree::pedinfo_type &info = mem->pedigree()->info();
-    int ind_num = mem->index();
+          if( autosomal )
+          {
+            key  = allele1;
+            key += '\0';
+            key += allele2;
 
-    // Make the traits
-    for( size_t tt=0; tt < tfound; ++tt )
-    {
-      size_t t = trait_values[tt].first;
-      const string &value = trait_values[tt].second;
-      int code = info.set_trait(ind_num, t, value, mped_info.trait_info(t));
+            cache.check(marker_info);
+          }
 
-      switch(code)
-      {
-        case 0:                       // trait ok
-        case 1:                       // trait ok, but missing
-        case 4:                       // trait not set legitimately
-                 break;
-        case 3:                       // invalid ind. or trait id
-                 errors << priority(warning) << "["<<count+format_in_file()
-                        << "] Cannot set trait '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'." << std::endl;
-                 break;
-        case 2:                       // bad trait value
-                 errors << priority(warning) << "["<<count+format_in_file()
-                        << "] Unrecognized value for trait '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'.  Found '" << value << "'." << std::endl;
-
-                 break;
-       default:
-                 errors << priority(error) << "[" <<count+format_in_file()
-                        << "] Unexpected error setting trait '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'." << std::endl;
-                 break;
-      }
-    }
+          phenotype_cache::value_map::const_iterator known =
+              autosomal ? cache.values.find(key) : cache.values.end();
 
-    for( size_t ss=0; ss < sfound; ++ss )
-    {
-      size_t s = string_values[ss].first;
-      const string &value = string_values[ss].second;
-      bool code = info.set_string(ind_num, s, value);
-
-      if(!code)
-        errors << priority(warning) << "["<<count+format_in_file() 
-	       << "] Cannot set string field '"
-               << mped_info.string_info(s).name()
-               << "' for individual '" << id << "' in pedigree '"
-               << pn << "'." << std::endl;
-    }
+          int code;
 
-    marker_value_map::const_iterator mm;
-    for( mm = marker_values.begin(); mm != marker_values.end(); ++mm )
-    {
-      size_t m = mm->first;
-      const string_pair &values = mm->second;
+          if( known != cache.values.end() && info.set_phenotype(ind_num, m, known->second.first) )
+          {
+            code = known->second.second;
+          }
+          else
+          {
+            code = info.set_phenotype(ind_num, sex, m, allele1, allele2, marker_info);
 
-      int code;
-      code = info.set_phenotype(ind_num, mem->get_effective_sex(), m, values.first, values.second,
-                                mped_info.marker_info(m));
+            if( autosomal && (code == 0 || code == 1) )
+            {
+              cache.check(marker_info);
+              cache.values[key] = make_pair(info.phenotype(ind_num, m), code);
+            }
+          }
 
-      switch(code)
-      {
-        case 0:                       // marker ok
-        case 1:                       // marker ok, but missing
-        case 3:                       // invalid ind. or marker id <-- Shouldn't ever happen
-                 break;
-        case 2:                       // bad marker value
-                 errors << priority(warning) << "["<<count+format_in_file()
-                        << "] Unrecognized value for marker '"
-                        << mped_info.marker_info(m).name()
-                        << "' of individual '" << id << "' in pedigree '"
-                        << pn << "': Found '" << values.first << "'";
-                 if(values.second.size())
-                   errors << ", '" << values.second << "'";
-                 errors << ". Marker will be set to missing for this individual." << std::endl;
-                 break;
-         case 4:
-                 errors << priority(warning) << "[" << count+format_in_file()
-                        << "] Marker '" << mped_info.marker_info(m).name()
-                        << "' is sex-dependent, but the individual '" << id 
-                        << "' in pedigree '" << pn 
-                        << "' has unknown sex.  Marker will be set to missing for this individual." << std::endl;
-                 break;
-         case 5:
-                 errors << priority(warning) << "[" << count+format_in_file()
-                        << "] Phenotype '" << values.first << "'";
-                 if(values.second.size())
-                   errors << ", '" << values.second << "'";
-                 errors << " at sex-dependent marker '" << mped_info.marker_info(m).name()
-                        << "' is inconsistent with the sex of individual '" << id
-                        << "' in pedigree '" << pn 
-                        << "'.  Marker will be set to missing for this individual." << std::endl;
-                 break;
-      }
-    }
+          switch(code)
+          {
+            case 0:                       // marker ok
+            case 1:                       // marker ok, but missing
+            case 3:                       // invalid ind. or marker id <-- Shouldn't ever happen
+                     break;
+            case 2:                       // bad marker value
+                     errors << priority(warning) << "["<<count+format_in_file()
+                            << "] Unrecognized value for marker '"
+                            << mped_info.marker_info(m).name()
+                            << "' of individual '" << id << "' in pedigree '"
+                            << pn << "': Found '" << allele1 << "'";
+                     if(allele2.size())
+                       errors << ", '" << allele2 << "'";
+                     errors << ". Marker will be set to missing for this individual." << std::endl;
+                     break;
+             case 4:
+                     errors << priority(warning) << "[" << count+format_in_file()
+                            << "] Marker '" << mped_info.marker_info(m).name()
+                            << "' is sex-dependent, but the individual '" << id 
+                            << "' in pedigree '" << pn 
+                            << "' has unknown sex.  Marker will be set to missing for this individual." << std::endl;
+                     break;
+             case 5:
+                     errors << priority(warning) << "[" << count+format_in_file()
+                            << "] Phenotype '" << allele1 << "'";
+                     if(allele2.size())
+                       errors << ", '" << allele2 << "'";
+                     errors << " at sex-dependent marker '" << mped_info.marker_info(m).name()
+                            << "' is inconsistent with the sex of individual '" << id
+                            << "' in pedigree '" << pn 
+                            << "'.  Marker will be set to missing for this individual." << std::endl;
+                     break;
+          }
+        }
 
-    for( mm = marker_covariate_values.begin(); mm != marker_covariate_values.end(); ++mm )
-    {
-      size_t t = mm->first;
-      const string_pair &values = mm->second;
+        for( size_t cc=0; cc < covariates.size(); ++cc )
+        {
+          const text_span* fields = values + covariate_slot + 2 * cc;
 
-      string mcov_name = mped_info.trait_info(t).name();
+          if( !fields[0].present() )
+            continue;
 
-      const string &value = get_marker_covariate_value(mcov_name, values.first, values.second);
+          size_t t = covariates[cc];
 
-      int code = info.set_trait(ind_num, t, value, mped_info.trait_info(t));
+          fields[0].assign_to(allele1);
+          fields[1].assign_to(allele2);
 
-      switch(code)
-      {
-        case 0:                       // trait ok
-        case 1:                       // trait ok, but missing
-        case 4:                       // trait not set legitimately
-                 break;
-        case 3:                       // invalid ind. or trait id
-                 errors << priority(warning) << "["<<count+format_in_file()
-                        << "] Cannot set marker covariate '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'." << std::endl;
-                 break;
-        case 2:                       // bad trait value
-                 errors << priority(warning) << "["<<count+format_in_file()
-                        << "] Unrecognized value for marker covariate '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'.  Found '" << value << "'." << std::endl;
-
-                 break;
-       default:
-                 errors << priority(error) << "[" <<count+format_in_file()
-                        << "] Unexpected error setting marker covariate '"
-                        << mped_info.trait_info(t).name()
-                        << "' for individual '" << id << "' in pedigree '"
-                        << pn << "'." << std::endl;
-                 break;
+          string mcov_name = mped_info.trait_info(t).name();
+
+          const string &value = get_marker_covariate_value(mcov_name, allele1, allele2);
+
+          int code = info.set_trait(ind_num, t, value, mped_info.trait_info(t));
+
+          switch(code)
+          {
+            case 0:                       // trait ok
+            case 1:                       // trait ok, but missing
+            case 4:                       // trait not set legitimately
+                     break;
+            case 3:                       // invalid ind. or trait id
+                     errors << priority(warning) << "["<<count+format_in_file()
+                            << "] Cannot set marker covariate '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'." << std::endl;
+                     break;
+            case 2:                       // bad trait value
+                     errors << priority(warning) << "["<<count+format_in_file()
+                            << "] Unrecognized value for marker covariate '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'.  Found '" << value << "'." << std::endl;
+
+                     break;
+           default:
+                     errors << priority(error) << "[" <<count+format_in_file()
+                            << "] Unexpected error setting marker covariate '"
+                            << mped_info.trait_info(t).name()
+                            << "' for individual '" << id << "' in pedigree '"
+                            << pn << "'." << std::endl;
+                     break;
+          }
+        }
       }
     }
   }
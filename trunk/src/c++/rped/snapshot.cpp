@@ -0,0 +1,739 @@
+/////////////////////////////////////////////////////////////
+// snapshot:  binary images of built multipedigrees, and   //
+//            snapshot files                               //
+//     (implementation code )                              //
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <map>
+#include <sstream>
+#include "rped/snapshot.h"
+
+#if defined(WIN32)
+#  include <process.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/file.h>
+#endif
+
+namespace SAGE {
+namespace RPED {
+
+namespace {
+
+// - File layout: the header, the entry images, each aligned to 8 bytes, and
+//   the entry directory.  The version changes whenever the layout of the
+//   file or of any image does.
+
+const char     SNAPSHOT_SIGNATURE[8] = { 'S', 'A', 'G', 'E', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_VERSION      = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER   = 0x01020304;
+
+struct snapshot_header
+{
+  char     signature[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t entry_count;
+  uint64_t directory_offset;
+};
+
+// - Serializes the programs storing to a snapshot file, with an exclusive
+//   lock on a lock file beside it.  The snapshot file itself cannot be
+//   locked, since each store replaces it.  There is no lock on WIN32, or if
+//   the lock file cannot be created.
+
+class snapshot_lock
+{
+public:
+
+  explicit snapshot_lock(const std::string& filename)
+    : my_fd(-1)
+  {
+#if !defined(WIN32)
+    std::string lock_name = filename + ".lock";
+
+    my_fd = ::open(lock_name.c_str(), O_RDWR | O_CREAT, 0666);
+
+    if(my_fd >= 0)
+      while(flock(my_fd, LOCK_EX) != 0 && errno == EINTR);
+#endif
+  }
+
+  ~snapshot_lock()
+  {
+#if !defined(WIN32)
+    if(my_fd >= 0)
+      ::close(my_fd);
+#endif
+  }
+
+private:
+
+  snapshot_lock(const snapshot_lock&);
+  snapshot_lock& operator=(const snapshot_lock&);
+
+  int my_fd;
+};
+
+// - The temporary file a store writes, in the same directory as the file so
+//   that it can be renamed over it.  Each process has its own.
+
+std::string
+temporary_name(const std::string& filename)
+{
+  std::ostringstream name;
+
+#if defined(WIN32)
+  name << filename << '.' << _getpid() << ".tmp";
+#else
+  name << filename << '.' << getpid() << ".tmp";
+#endif
+
+  return name.str();
+}
+
+// - Sex codes given to the pedigree builder when rebuilding.  Inferred sexes
+//   are inferred again, as they were when the data was read, and the stored
+//   codes restored after the build.
+
+MPED::SexCode
+builder_sex(MPED::SexCode s)
+{
+  switch(s)
+  {
+    case MPED::SEX_MALE   :
+    case MPED::SEX_FEMALE :
+    case MPED::SEX_ARB    : return s;
+    default               : return MPED::SEX_MISSING;
+  }
+}
+
+struct member_image
+{
+  std::string   name;
+  MPED::SexCode sex;
+  int           parent1;
+  int           parent2;
+  int           subindex;
+};
+
+}
+
+//=====================================================================
+// Binary images
+//=====================================================================
+
+void
+write_image(UTIL::BinaryImageWriter& out, const RefMPedInfo& info)
+{
+  out.put_string(info.individual_missing_code());
+  out.put_string(info.sex_code_male());
+  out.put_string(info.sex_code_female());
+  out.put_string(info.sex_code_unknown());
+
+  const PhenotypeReaderInfo& reader = info.get_pheno_reader_info();
+
+  out.put_int   (reader.get_allele_delimiter());
+  out.put_string(reader.get_allele_missing());
+  out.put_int   (reader.get_allele_adjustment());
+  out.put_double(reader.get_min_allele_freq());
+  out.put_double(reader.get_max_allele_freq());
+  out.put_string(reader.get_covariate_moi());
+  out.put_string(reader.get_covariate_allele());
+  out.put_bool  (reader.get_allow_hemizygote());
+
+  out.put_uint64(info.trait_count());
+
+  for(size_t t = 0; t < info.trait_count(); ++t)
+  {
+    const RefTraitInfo& trait = info.trait_info(t);
+
+    out.put_string(trait.name());
+    out.put_string(trait.alias_name());
+    out.put_int   (trait.type());
+    out.put_int   (trait.usage());
+    out.put_double(trait.threshold());
+    out.put_double(trait.numeric_missing_code());
+    out.put_string(trait.string_missing_code());
+    out.put_double(trait.numeric_affected_code());
+    out.put_double(trait.numeric_unaffected_code());
+    out.put_string(trait.string_affected_code());
+    out.put_string(trait.string_unaffected_code());
+    out.put_bool  (trait.get_lockout());
+
+    const RefTraitInfo::CategoryVector& categories = trait.get_categories();
+
+    out.put_uint64(categories.size());
+
+    for(size_t c = 0; c < categories.size(); ++c)
+      out.put_string(categories[c]);
+  }
+
+  out.put_uint64(info.string_count());
+
+  for(size_t s = 0; s < info.string_count(); ++s)
+  {
+    out.put_string(info.string_info(s).name());
+    out.put_string(info.string_info(s).string_missing_code());
+  }
+
+  // Markers are written with their names in the marker map, which are not
+  // always the model names.
+
+  out.put_uint64(info.marker_count());
+
+  for(size_t m = 0; m < info.marker_count(); ++m)
+  {
+    out.put_string(info.markers().name(m));
+
+    info.marker_info(m).write_image(out);
+  }
+}
+
+bool
+read_image(UTIL::BinaryImageReader& in, RefMPedInfo& info)
+{
+  RefMPedInfo tmp;
+
+  tmp.set_individual_missing_code(in.get_string());
+  tmp.set_sex_code_male          (in.get_string());
+  tmp.set_sex_code_female        (in.get_string());
+  tmp.set_sex_code_unknown       (in.get_string());
+
+  PhenotypeReaderInfo& reader = tmp.get_pheno_reader_info();
+
+  reader.set_allele_delimiter (in.get_int());
+  reader.set_allele_missing   (in.get_string());
+  reader.set_allele_adjustment((PhenotypeReaderInfo::allele_adj) in.get_int());
+  reader.set_min_allele_freq  (in.get_double());
+  reader.set_max_allele_freq  (in.get_double());
+  reader.set_covariate_moi    (in.get_string());
+  reader.set_covariate_allele (in.get_string());
+  reader.set_allow_hemizygote (in.get_bool());
+
+  uint64_t trait_count = in.get_uint64();
+
+  for(uint64_t t = 0; t < trait_count && in.good(); ++t)
+  {
+    std::string name  = in.get_string();
+    std::string alias = in.get_string();
+
+    RefTraitInfo::trait_t   type  = (RefTraitInfo::trait_t)   in.get_int();
+    RefTraitInfo::trait_use usage = (RefTraitInfo::trait_use) in.get_int();
+
+    // add_trait() merges a trait into any earlier one of the same name or
+    // alias.  Readers never create such traits, so a merge is a bad image.
+
+    RefTraitInfo trait(name, type, usage);
+
+    trait.set_alias_name             (alias);
+    trait.set_threshold              (in.get_double());
+    trait.set_numeric_missing_code   (in.get_double());
+    trait.set_string_missing_code    (in.get_string());
+    trait.set_numeric_affected_code  (in.get_double());
+    trait.set_numeric_unaffected_code(in.get_double());
+    trait.set_string_affected_code   (in.get_string());
+    trait.set_string_unaffected_code (in.get_string());
+    trait.set_lockout                (in.get_bool());
+
+    uint64_t category_count = in.get_uint64();
+
+    for(uint64_t c = 0; c < category_count && in.good(); ++c)
+      trait.get_categories().push_back(in.get_string());
+
+    if(tmp.add_trait(name, type, usage) != t)
+      return false;
+
+    tmp.trait_info((size_t) t) = trait;
+  }
+
+  uint64_t string_count = in.get_uint64();
+
+  for(uint64_t s = 0; s < string_count && in.good(); ++s)
+  {
+    std::string name = in.get_string();
+
+    tmp.add_string_field(name);
+
+    if(tmp.string_count() != s + 1)
+      return false;
+
+    tmp.string_info((size_t) s).set_string_missing_code(in.get_string());
+  }
+
+  uint64_t marker_count = in.get_uint64();
+
+  for(uint64_t m = 0; m < marker_count && in.good(); ++m)
+  {
+    std::string              name = in.get_string();
+    MLOCUS::inheritance_model model;
+
+    if(!model.read_image(in) || !tmp.markers().insert(std::make_pair(name, model)).second)
+      return false;
+  }
+
+  if(!in.good())
+    return false;
+
+  info = tmp;
+
+  return true;
+}
+
+void
+write_image(UTIL::BinaryImageWriter& out, const RefMultiPedigree& mp)
+{
+  const RefMPedInfo& info = mp.info();
+
+  write_image(out, info);
+
+  // Structure
+
+  out.put_uint64(mp.pedigree_count());
+
+  for(uint p = 0; p < mp.pedigree_count(); ++p)
+  {
+    const RefPedigree& ped = mp.pedigree_index(p);
+
+    out.put_string(ped.name());
+    out.put_uint64(ped.member_count());
+
+    for(uint i = 0; i < ped.member_count(); ++i)
+    {
+      const RefMember& mem = ped.member_index(i);
+
+      out.put_string(mem.name());
+      out.put_int   (mem.get_detailed_sex());
+      out.put_int   (mem.parent1() ? (int) mem.parent1()->index() : -1);
+      out.put_int   (mem.parent2() ? (int) mem.parent2()->index() : -1);
+      out.put_int   (mem.subpedigree() ? (int) mem.subindex() : -1);
+    }
+  }
+
+  // Data, a column at a time
+
+  for(uint p = 0; p < mp.pedigree_count(); ++p)
+  {
+    const RefPedigree& ped    = mp.pedigree_index(p);
+    const RefPedInfo&  pinfo  = ped.info();
+    size_t             member_count = ped.member_count();
+
+    for(size_t t = 0; t < info.trait_count(); ++t)
+      for(size_t i = 0; i < member_count; ++i)
+        out.put_double(pinfo.trait(i, t));
+
+    for(size_t s = 0; s < info.string_count(); ++s)
+      for(size_t i = 0; i < member_count; ++i)
+        out.put_string(pinfo.get_string(i, s));
+
+    std::vector<uint32_t> phenotypes;
+
+    for(size_t m = 0; m < info.marker_count(); ++m)
+    {
+      if(m < pinfo.marker_count())
+        pinfo.marker_column(m).unpack(phenotypes);
+      else
+        phenotypes.clear();
+
+      phenotypes.resize(member_count, MLOCUS::NPOS);
+
+      if(member_count)
+        out.put_bytes(&phenotypes[0], member_count * sizeof(uint32_t));
+    }
+  }
+}
+
+bool
+read_image(UTIL::BinaryImageReader& in, RefMultiPedigree& mp)
+{
+  // The whole image is checked before the multipedigree is changed, so that
+  // a damaged image leaves it as it was.
+
+  RefMPedInfo info;
+
+  if(!read_image(in, info))
+    return false;
+
+  std::vector<std::string>                 pedigree_names;
+  std::vector<std::vector<member_image> >  members;
+
+  uint64_t pedigree_count = in.get_uint64();
+
+  for(uint64_t p = 0; p < pedigree_count && in.good(); ++p)
+  {
+    pedigree_names.push_back(in.get_string());
+    members.push_back(std::vector<member_image>());
+
+    std::vector<member_image>& pmembers = members.back();
+
+    uint64_t member_count = in.get_uint64();
+
+    for(uint64_t i = 0; i < member_count && in.good(); ++i)
+    {
+      member_image mem;
+
+      mem.name     = in.get_string();
+      mem.sex      = (MPED::SexCode) in.get_int();
+      mem.parent1  = in.get_int();
+      mem.parent2  = in.get_int();
+      mem.subindex = in.get_int();
+
+      if(mem.parent1 >= (int) member_count || mem.parent2 >= (int) member_count)
+        return false;
+
+      pmembers.push_back(mem);
+    }
+  }
+
+  // Walk the data, which is read once the pedigrees are built.
+
+  const char* data_first = in.skip(0);
+
+  for(size_t p = 0; p < members.size() && in.good(); ++p)
+  {
+    size_t member_count = members[p].size();
+
+    in.skip(info.trait_count() * member_count * sizeof(double));
+
+    for(size_t s = 0; s < info.string_count() * member_count && in.good(); ++s)
+      in.skip(in.get_uint64());
+
+    in.skip(info.marker_count() * member_count * sizeof(uint32_t));
+  }
+
+  if(!in.good())
+    return false;
+
+  UTIL::BinaryImageReader data(data_first, in.skip(0));
+
+  // Add the structure to the multipedigree as the pedigree file readers do.
+
+  mp.info() = info;
+
+  for(size_t p = 0; p < members.size(); ++p)
+  {
+    const std::string&               pname    = pedigree_names[p];
+    const std::vector<member_image>& pmembers = members[p];
+
+    for(size_t i = 0; i < pmembers.size(); ++i)
+      mp.add_member(pname, pmembers[i].name, builder_sex(pmembers[i].sex));
+  }
+
+  for(size_t p = 0; p < members.size(); ++p)
+  {
+    const std::string&               pname    = pedigree_names[p];
+    const std::vector<member_image>& pmembers = members[p];
+
+    for(size_t i = 0; i < pmembers.size(); ++i)
+    {
+      const member_image& mem = pmembers[i];
+
+      if(mem.parent1 >= 0 && mem.parent2 >= 0)
+        mp.add_lineage(pname, mem.name, pmembers[mem.parent1].name, pmembers[mem.parent2].name);
+      else if(mem.parent1 >= 0)
+        mp.add_lineage(pname, mem.name, pmembers[mem.parent1].name);
+      else if(mem.parent2 >= 0)
+        mp.add_lineage(pname, mem.name, pmembers[mem.parent2].name);
+    }
+  }
+
+  mp.build();
+
+  if(mp.pedigree_count() != members.size())
+    return false;
+
+  // Restore the stored orders.  The builder's orders depend only on names,
+  // so these are usually already right, but for the members reordered by
+  // PedigreeSort().
+
+  for(uint p = 0; p < mp.pedigree_count(); ++p)
+  {
+    RefMultiPedigree::pedigree_pointer ped = mp.pedigree_find(pedigree_names[p]);
+
+    if(!ped)
+      return false;
+
+    if(ped->index() != p)
+      mp.pedigree_index_swap(p, ped->index());
+  }
+
+  for(uint p = 0; p < mp.pedigree_count(); ++p)
+  {
+    RefPedigree&                     ped      = mp.pedigree_index(p);
+    const std::vector<member_image>& pmembers = members[p];
+
+    if(ped.member_count() != pmembers.size())
+      return false;
+
+    std::map<RefSubpedigree*, std::vector<RefMember*> > subpedigree_members;
+
+    for(uint i = 0; i < ped.member_count(); ++i)
+    {
+      RefMember* mem = ped.member_find(pmembers[i].name);
+
+      if(!mem)
+        return false;
+
+      if(mem->index() != i)
+        ped.member_index_swap(i, mem->index());
+
+      mem->set_sex(pmembers[i].sex);
+
+      if(mem->subpedigree() && pmembers[i].subindex >= 0)
+      {
+        std::vector<RefMember*>& sub = subpedigree_members[mem->subpedigree()];
+
+        if((size_t) pmembers[i].subindex >= sub.size())
+          sub.resize(pmembers[i].subindex + 1, (RefMember*) NULL);
+
+        sub[pmembers[i].subindex] = mem;
+      }
+    }
+
+    std::map<RefSubpedigree*, std::vector<RefMember*> >::iterator s = subpedigree_members.begin();
+
+    for( ; s != subpedigree_members.end(); ++s)
+    {
+      if(s->second.size() != s->first->member_count())
+        return false;
+
+      for(uint i = 0; i < s->second.size(); ++i)
+      {
+        if(!s->second[i])
+          return false;
+
+        if(s->second[i]->subindex() != i)
+          s->first->member_index_swap(i, s->second[i]->subindex());
+      }
+    }
+  }
+
+  // Data
+
+  for(uint p = 0; p < mp.pedigree_count(); ++p)
+  {
+    RefPedigree& ped          = mp.pedigree_index(p);
+    RefPedInfo&  pinfo        = ped.info();
+    size_t       member_count = ped.member_count();
+
+    pinfo.build(ped);
+    pinfo.resize_traits (info.trait_count());
+    pinfo.resize_strings(info.string_count());
+    pinfo.resize_markers(info.marker_count(), info);
+
+    for(size_t t = 0; t < info.trait_count(); ++t)
+      for(size_t i = 0; i < member_count; ++i)
+        pinfo.set_trait(i, t, data.get_double());
+
+    std::string value;
+
+    for(size_t s = 0; s < info.string_count(); ++s)
+      for(size_t i = 0; i < member_count; ++i)
+      {
+        data.get_string(value);
+        pinfo.set_string(i, s, value);
+      }
+
+    for(size_t m = 0; m < info.marker_count(); ++m)
+      for(size_t i = 0; i < member_count; ++i)
+        pinfo.set_phenotype(i, m, data.get_uint32());
+  }
+
+  return data.good();
+}
+
+//=====================================================================
+// snapshot_file
+//=====================================================================
+
+snapshot_file::snapshot_file()
+{ }
+
+bool
+snapshot_file::open(const std::string& filename)
+{
+  close();
+
+  if(!my_text.open(filename))
+    return false;
+
+  UTIL::BinaryImageReader in(my_text.begin(), my_text.end());
+
+  snapshot_header header;
+
+  if(   !in.get_bytes(&header, sizeof(header))
+     || std::memcmp(header.signature, SNAPSHOT_SIGNATURE, sizeof(SNAPSHOT_SIGNATURE))
+     || header.version    != SNAPSHOT_VERSION
+     || header.byte_order != SNAPSHOT_BYTE_ORDER
+     || header.directory_offset > my_text.size()
+     || header.entry_count > (my_text.size() - header.directory_offset) / sizeof(entry))
+  {
+    close();
+
+    return false;
+  }
+
+  my_entries.resize(header.entry_count);
+
+  if(header.entry_count)
+    std::memcpy(&my_entries[0], my_text.begin() + header.directory_offset,
+                header.entry_count * sizeof(entry));
+
+  for(size_t e = 0; e < my_entries.size(); ++e)
+  {
+    if(   my_entries[e].offset > header.directory_offset
+       || my_entries[e].size   > header.directory_offset - my_entries[e].offset)
+    {
+      close();
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void
+snapshot_file::close()
+{
+  my_text.close();
+  my_entries.clear();
+}
+
+bool
+snapshot_file::is_open() const
+{
+  return my_text.begin() != NULL;
+}
+
+size_t
+snapshot_file::entry_count() const
+{
+  return my_entries.size();
+}
+
+bool
+snapshot_file::find(uint64_t key, uint64_t content_hash,
+                    const char*& first, const char*& last) const
+{
+  for(size_t e = 0; e < my_entries.size(); ++e)
+  {
+    if(my_entries[e].key != key)
+      continue;
+
+    if(my_entries[e].content_hash != content_hash)
+      return false;
+
+    first = my_text.begin() + my_entries[e].offset;
+    last  = first + my_entries[e].size;
+
+    return true;
+  }
+
+  return false;
+}
+
+// - The file is read again under the lock, so the entries stored by other
+//   programs since it was opened are kept.
+//
+bool
+snapshot_file::store(const std::string& filename, uint64_t key, uint64_t content_hash,
+                     const std::string& image)
+{
+  snapshot_lock lock(filename);
+
+  open(filename);
+
+  std::string              contents;
+  UTIL::BinaryImageWriter  out(contents);
+  std::vector<entry>       entries;
+
+  snapshot_header header;
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.signature, SNAPSHOT_SIGNATURE, sizeof(SNAPSHOT_SIGNATURE));
+
+  header.version    = SNAPSHOT_VERSION;
+  header.byte_order = SNAPSHOT_BYTE_ORDER;
+
+  out.put_bytes(&header, sizeof(header));
+
+  for(size_t e = 0; e <= my_entries.size(); ++e)
+  {
+    entry new_entry;
+
+    if(e < my_entries.size())
+    {
+      if(my_entries[e].key == key)
+        continue;
+
+      new_entry = my_entries[e];
+    }
+    else
+    {
+      new_entry.key          = key;
+      new_entry.content_hash = content_hash;
+      new_entry.size         = image.size();
+    }
+
+    out.align(8);
+
+    new_entry.offset = out.size();
+
+    if(e < my_entries.size())
+      out.put_bytes(my_text.begin() + my_entries[e].offset, my_entries[e].size);
+    else
+      out.put_bytes(image.data(), image.size());
+
+    entries.push_back(new_entry);
+  }
+
+  out.align(8);
+
+  header.entry_count      = entries.size();
+  header.directory_offset = out.size();
+
+  out.put_bytes(&entries[0], entries.size() * sizeof(entry));
+
+  std::memcpy(&contents[0], &header, sizeof(header));
+
+  close();
+
+  // Write a temporary file and rename it, so that the file is never seen
+  // half written.
+
+  std::string temp_name = temporary_name(filename);
+
+  FILE* file = fopen(temp_name.c_str(), "wb");
+
+  if(!file)
+    return false;
+
+  bool ok = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+
+  ok = (fclose(file) == 0) && ok;
+
+#if defined(WIN32)
+  if(ok)
+    remove(filename.c_str());
+#endif
+
+  ok = ok && rename(temp_name.c_str(), filename.c_str()) == 0;
+
+  if(!ok)
+    remove(temp_name.c_str());
+
+  return ok;
+}
+
+} // End namespace RPED
+} // End namespace SAGE
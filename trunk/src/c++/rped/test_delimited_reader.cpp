@@ -0,0 +1,281 @@
+/////////////////////////////////////////////////////////////
+// test_delimited_reader:  tests of the bulk delimited     //
+//                         file reader                     //
+//                                                         //
+//   test_delimited_reader fuzz                            //
+//     Splits random lines with delimited_tokenizer and    //
+//     with string_tokenizer, under every combination of   //
+//     delimiters, whitespace and eliding, and counts the  //
+//     lines on which they differ.                         //
+//                                                         //
+//   test_delimited_reader chunks                          //
+//     Reads a file with CRLF and blank lines, quoted and  //
+//     escaped fields and a short line in chunks of 1 to   //
+//     64 bytes, on 1 and 3 threads, and compares the rows //
+//     and line numbers with those read in one chunk.      //
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "LSF/parse_ops.h"
+#include "numerics/isnan.h"
+#include "rped/delimited_reader.h"
+
+namespace SAGE {
+namespace RPED {
+
+// A small linear congruential generator, so that the lines are the same
+// on every platform.
+class line_source
+{
+public:
+
+  line_source() : my_state(7) { }
+
+  size_t next(size_t n)
+  {
+    my_state = my_state * 1103515245UL + 12345UL;
+
+    return ((my_state >> 16) & 0x7FFF) % n;
+  }
+
+private:
+
+  unsigned long my_state;
+};
+
+int
+fuzz_tokenizer()
+{
+  const char   alphabet[]   = ",,\t  ab1\"\\\"n;";
+  const char*  delimiters[] = { ",\t", ",", ", ;" };
+  const char*  whitespace[] = { "", " " };
+
+  const size_t trials = 100000;
+
+  line_source source;
+
+  size_t differences = 0;
+
+  for(size_t trial = 0; trial < trials; ++trial)
+  {
+    int         flags = trial % 8;
+    std::string delim = delimiters[(trial / 8) % 3];
+    std::string ws    = whitespace[(trial / 24) % 2];
+
+    std::string line;
+
+    for(size_t n = source.next(12); n; --n)
+      line += alphabet[source.next(sizeof(alphabet) - 1)];
+
+    string_tokenizer st(line, delim, ws);
+
+    st.set_skip_consecutive_delimiters(flags & 1);
+    st.set_skip_leading_delimiters    (flags & 2);
+    st.set_skip_trailing_delimiters   (flags & 4);
+
+    std::vector<std::string> expected, result;
+
+    for(string_tokenizer::iterator i = st.begin(); i != st.end(); ++i)
+      expected.push_back(*i);
+
+    delimited_tokenizer dt(delim, ws);
+
+    dt.set_skip_consecutive_delimiters(flags & 1);
+    dt.set_skip_leading_delimiters    (flags & 2);
+    dt.set_skip_trailing_delimiters   (flags & 4);
+
+    dt.set_line(line.data(), line.data() + line.size());
+
+    std::deque<std::string> unescaped;
+    text_span               value;
+
+    bool absent = false;
+
+    while(dt.next(value, unescaped))
+    {
+      absent = absent || !value.present();
+
+      result.push_back(value.str());
+    }
+
+    if(expected != result || absent)
+    {
+      if(++differences <= 10)
+        std::cout << "Differs: [" << line << "] flags " << flags
+                  << " delimiters [" << delim << "] whitespace [" << ws << "]" << std::endl;
+    }
+  }
+
+  std::cout << trials << " lines, " << differences << " differences." << std::endl;
+
+  return differences ? 1 : 0;
+}
+
+// Writes a row as its line number, values and numeric conversion.
+std::string
+describe_row(const parsed_chunk& chunk, size_t first_line, size_t row, size_t width)
+{
+  std::ostringstream o;
+
+  o << "line " << first_line + chunk.line(row) << ":";
+
+  for(size_t s = 0; s < width; ++s)
+  {
+    const text_span& v = chunk.values(row)[s];
+
+    if(v.present()) o << " [" << v.str() << "]";
+    else            o << " -";
+  }
+
+  o << "  q = ";
+
+  if(SAGE::isnan(chunk.numbers(row)[0])) o << "nan";
+  else                                  o << chunk.numbers(row)[0];
+
+  o << " (" << chunk.codes(row)[0] << ")";
+
+  return o.str();
+}
+
+std::vector<std::string>
+read_rows(const mapped_text& text, const column_layout& layout,
+          const delimited_tokenizer& tokenizer, size_t chunk_bytes, size_t threads,
+          size_t& chunks)
+{
+  std::vector<std::string> rows;
+
+  chunk_reader reader(text, text.second_line(), layout, tokenizer, threads);
+
+  reader.set_chunk_bytes(chunk_bytes);
+
+  chunks = 0;
+
+  while(reader.next_batch())
+  {
+    for(size_t c = 0; c < reader.chunk_count(); ++c, ++chunks)
+      for(size_t r = 0; r < reader.chunk(c).row_count(); ++r)
+        rows.push_back(describe_row(reader.chunk(c), reader.first_line(c), r, layout.width()));
+  }
+
+  return rows;
+}
+
+int
+read_chunks()
+{
+  // Line numbers count from the line after the header.  Line 2 is only a
+  // carriage return, line 3 is empty and the last line has no newline.
+  const char data[] =
+      "id,fa,mo,q,a1,a2\r\n"
+      "1,0,0,1.5,A,B\r\n"
+      "\r\n"
+      "\n"
+      "2,0,0,\"2.5\",A,\"B\\\"C\"\r\n"
+      "3,1,2,x,,C\n"
+      "4,1,2\n"
+      "  5 , 1 , 2 , 7 , \"D E\" , F \r\n"
+      "\n"
+      "\n"
+      "6,1,2,\"8\",\"G,H\",I";
+
+  const char* filename = "chunks.txt";
+
+  {
+    std::ofstream f(filename, std::ios::binary);
+
+    f.write(data, sizeof(data) - 1);
+  }
+
+  mapped_text text;
+
+  if(!text.open(filename))
+  {
+    std::cout << "Unable to open " << filename << std::endl;
+
+    return 1;
+  }
+
+  RefTraitInfo q("q");
+
+  q.set_string_missing_code("x");
+
+  column_layout layout;
+
+  layout.add_column(column_layout::store,      0);
+  layout.add_column(column_layout::store_pair, 1);
+  layout.add_column(column_layout::store_pair, 1);
+  layout.add_column(column_layout::store,      3);
+  layout.add_column(column_layout::store_pair, 4);
+  layout.add_column(column_layout::store_pair, 4);
+
+  layout.set_numeric(3, q);
+
+  delimited_tokenizer tokenizer(",");
+
+  size_t chunks;
+
+  std::vector<std::string> expected = read_rows(text, layout, tokenizer, text.size(), 1, chunks);
+
+  for(size_t r = 0; r < expected.size(); ++r)
+    std::cout << expected[r] << std::endl;
+
+  std::cout << std::endl;
+
+  size_t differences = 0;
+
+  const size_t threads[] = { 1, 3 };
+
+  for(size_t t = 0; t < 2; ++t)
+  {
+    size_t most_chunks = 0;
+
+    for(size_t bytes = 1; bytes <= 64; ++bytes)
+    {
+      std::vector<std::string> rows = read_rows(text, layout, tokenizer, bytes, threads[t], chunks);
+
+      most_chunks = std::max(most_chunks, chunks);
+
+      if(rows != expected)
+      {
+        ++differences;
+
+        std::cout << "Differs: " << bytes << " byte chunks, "
+                  << threads[t] << " threads" << std::endl;
+      }
+    }
+
+    std::cout << threads[t] << " threads, up to " << most_chunks << " chunks: "
+              << (differences ? "differs" : "same rows") << std::endl;
+  }
+
+  text.close();
+
+  remove(filename);
+
+  return differences ? 1 : 0;
+}
+
+} // End namespace RPED
+} // End namespace SAGE
+
+int main(int argc, char* argv[])
+{
+  std::string test = argc > 1 ? argv[1] : "";
+
+  if(test == "fuzz")   return SAGE::RPED::fuzz_tokenizer();
+  if(test == "chunks") return SAGE::RPED::read_chunks();
+
+  std::cerr << "usage: " << argv[0] << " fuzz | chunks" << std::endl;
+
+  return 1;
+}
@@ -24,6 +24,24 @@ class rped_tests (sagetest.SAGE_Test) :
     self.file_names = ['out']
     self.execute()
 
+  def test_delimited_fuzz(self):
+    'Compare the delimited reader tokenizer with string_tokenizer'
+    self.cmd = "test_delimited_reader fuzz >out 2>&1"
+    self.file_names = ['out']
+    self.execute()
+
+  def test_delimited_chunks(self):
+    'Read a delimited file in small chunks'
+    self.cmd = "test_delimited_reader chunks >out 2>&1"
+    self.file_names = ['out']
+    self.execute()
+
+  def test_snapshot(self):
+    'Round trip of a multipedigree through a snapshot file'
+    self.cmd = "test_snapshot >out 2>&1"
+    self.file_names = ['out']
+    self.execute()
+
   def test_mpfile1(self):
     'MPfile Test 1'
     self.cmd = "mpfiletest ped.dat '(2X,A2,1X,A2,T18,A1,T8,2A3)' out > mpfiletest.out 2>&1"
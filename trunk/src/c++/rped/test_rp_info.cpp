@@ -164,12 +164,135 @@ void test_ped_info_set_phenotypes()
 
 }
 
+void test_marker_column()
+{
+    // Small columns are held inline, large ones allocated; both are packed
+    // as tightly as the largest id allows.
+
+    for(size_t n = 2; n < 200; n = n * 3 + 1)
+    {
+      RefMarkerColumn c;
+
+      c.resize(n, 3);
+
+      assert(c.size() == n && c.width() == 2);
+
+      for(size_t i = 0; i < n; ++i)
+        assert(c.get(i) == 3);
+
+      for(size_t i = 0; i < n; ++i)
+        c.set(i, i % 4);
+
+      // Widening keeps the values set
+      c.set(n - 1, 100);
+
+      assert(c.width() == 8);
+
+      for(size_t i = 0; i + 1 < n; ++i)
+        assert(c.get(i) == i % 4);
+
+      assert(c.get(n - 1) == 100);
+
+      c.set(0, MLOCUS::NPOS);
+
+      assert(c.width() == 32 && c.get(0) == MLOCUS::NPOS);
+
+      RefMarkerColumn copy(c);
+
+      c.set(0, 1);
+      c.swap_values(0, n - 1);
+
+      assert(copy.get(0) == MLOCUS::NPOS);
+      assert(c.get(0) == 100 && c.get(n - 1) == 1);
+
+      std::vector<uint32_t> values;
+
+      copy.unpack(values);
+
+      assert(values.size() == n && values[0] == MLOCUS::NPOS);
+
+      for(size_t i = 1; i + 1 < n; ++i)
+        assert(values[i] == i % 4);
+    }
+
+    // Growing keeps the width and values, and fills new members
+    RefMarkerColumn c;
+
+    c.resize(5, 1);
+    c.set(4, 2);
+    c.resize(40, 12);
+
+    assert(c.width() == 4 && c.get(4) == 2 && c.get(3) == 1 && c.get(39) == 12);
+
+    assert(RefMarkerColumn::width_for(3)   == 2);
+    assert(RefMarkerColumn::width_for(4)   == 4);
+    assert(RefMarkerColumn::width_for(255) == 8);
+    assert(RefMarkerColumn::width_for(256) == 32);
+}
+
+void test_ped_info_marker_columns()
+{
+    RefMPedInfo mpinfo;
+
+    mpinfo.add_marker("M1");
+    mpinfo.marker_info(0) = create_marker(MLOCUS::AUTOSOMAL);
+
+    RefPedInfo pedinfo;
+
+    MPED::pedigree_base P("P1");
+
+    for(size_t i = 0; i < 20; ++i)
+    {
+      std::string name = "m00";
+
+      name[1] += i / 10;
+      name[2] += i % 10;
+
+      P.add_member(name);
+    }
+
+    P.build();
+
+    pedinfo.build(P);
+    pedinfo.resize_markers(1, mpinfo);
+
+    RefMarkerInfo& marker = mpinfo.marker_info(0);
+
+    // Unphased calls of a biallelic marker are stored at two bits a member
+    assert(pedinfo.marker_column(0).width() == 2);
+
+    for(size_t i = 0; i < 20; ++i)
+      assert(pedinfo.phenotype_missing(i, 0, marker));
+
+    assert(pedinfo.set_phenotype(3, 0, "A", "B", marker) == 0);
+    assert(pedinfo.set_phenotype(7, 0, "B", "B", marker) == 0);
+
+    uint ab = pedinfo.phenotype(3, 0);
+    uint bb = pedinfo.phenotype(7, 0);
+
+    assert(ab != bb && !pedinfo.phenotype_missing(3, 0, marker));
+    assert(pedinfo.marker_column(0).width() == 2);
+
+    pedinfo.swap_members(3, 7);
+
+    assert(pedinfo.phenotype(3, 0) == bb && pedinfo.phenotype(7, 0) == ab);
+
+    std::vector<uint32_t> values;
+
+    pedinfo.marker_column(0).unpack(values);
+
+    assert(values.size() == 20 && values[3] == bb && values[7] == ab);
+    assert(values[0] == marker.get_missing_phenotype_id());
+}
+
 }
 }
 
 int main()
 {
   SAGE::RPED::test_ped_info_set_phenotypes();
+  SAGE::RPED::test_marker_column();
+  SAGE::RPED::test_ped_info_marker_columns();
   
   
   return 0;
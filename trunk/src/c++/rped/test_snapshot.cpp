@@ -0,0 +1,317 @@
+/////////////////////////////////////////////////////////////
+// test_snapshot:  round trip of a multipedigree through   //
+//                 a snapshot file                         //
+//                                                         //
+//   Reads a small delimited file with markers (given as   //
+//   genotypes and as allele pairs), continuous, binary    //
+//   and categorical traits, and a string field, stores    //
+//   its image in a snapshot file and reads it back.       //
+//   Checks that the rebuilt multipedigree and its image   //
+//   are the same, that other entries are kept, also when  //
+//   stored through an object opened earlier, and that     //
+//   entries with a stale hash, damaged entries and        //
+//   damaged files are not used.                           //
+//                                                         //
+// History: 10/17/26 - created.                            //
+//                                                         //
+// Copyright (c) 2026 R.C. Elston                          //
+//   All Rights Reserved                                   //
+/////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "error/errorstream.h"
+#include "rped/rped.h"
+#include "rped/rpfile.h"
+#include "rped/snapshot.h"
+
+namespace SAGE {
+namespace RPED {
+
+int failures = 0;
+
+void
+check(const std::string& name, bool ok)
+{
+  if(!ok)
+    ++failures;
+
+  std::cout << (ok ? "ok    " : "FAILED") << "  " << name << std::endl;
+}
+
+void
+write_file(const std::string& filename, const std::string& contents)
+{
+  std::ofstream f(filename.c_str(), std::ios::binary);
+
+  f.write(contents.data(), contents.size());
+}
+
+std::string
+read_file(const std::string& filename)
+{
+  std::ifstream f(filename.c_str(), std::ios::binary);
+
+  std::ostringstream s;
+
+  s << f.rdbuf();
+
+  return s.str();
+}
+
+void
+dump(const RefMultiPedigree& mp, std::ostream& o)
+{
+  const RefMPedInfo& mpinfo = mp.info();
+
+  for(size_t p = 0; p < mp.pedigree_count(); ++p)
+  {
+    const RefPedigree& ped  = mp.pedigree_index(p);
+    const RefPedInfo&  info = ped.info();
+
+    o << "Pedigree " << ped.name() << ": " << ped.subpedigree_count() << " subpedigrees, "
+      << ped.family_count() << " families" << std::endl;
+
+    for(size_t i = 0; i < ped.member_count(); ++i)
+    {
+      const RefMember& m = ped.member_index(i);
+
+      o << "  " << m.name() << " sex " << m.get_detailed_sex()
+        << " parents " << (m.parent1() ? m.parent1()->name() : "-")
+        << " "         << (m.parent2() ? m.parent2()->name() : "-");
+
+      for(size_t t = 0; t < info.trait_count(); ++t)
+        o << " " << mpinfo.trait_info(t).name() << "=" << info.trait(i, t);
+
+      for(size_t s = 0; s < info.string_count(); ++s)
+        o << " " << mpinfo.string_info(s).name() << "=<" << info.get_string(i, s) << ">";
+
+      for(size_t k = 0; k < info.marker_count(); ++k)
+        o << " " << mpinfo.marker_info(k).name() << "=" << info.phenotype(i, k);
+
+      o << std::endl;
+    }
+  }
+
+  for(size_t k = 0; k < mpinfo.marker_count(); ++k)
+    o << "Marker " << mpinfo.marker_info(k).name() << ": "
+      << mpinfo.marker_info(k).allele_count()    << " alleles, "
+      << mpinfo.marker_info(k).phenotype_count() << " phenotypes" << std::endl;
+}
+
+bool
+read_pedigrees(RefMultiPedigree& mp, const std::string& filename, cerrorstream& errors)
+{
+  RefMPedInfo& mpinfo = mp.info();
+
+  mpinfo.set_sex_code_male   ("M");
+  mpinfo.set_sex_code_female ("F");
+  mpinfo.set_sex_code_unknown("?");
+  mpinfo.set_individual_missing_code("0");
+
+  size_t q = mpinfo.add_trait("Q1", RefTraitInfo::continuous_trait);
+
+  mpinfo.trait_info(q).set_string_missing_code("x");
+
+  size_t b = mpinfo.add_binary_trait("B1");
+
+  mpinfo.trait_info(b).set_string_affected_code  ("A");
+  mpinfo.trait_info(b).set_string_unaffected_code("U");
+
+  mpinfo.add_trait("C1", RefTraitInfo::categorical_trait);
+
+  mpinfo.add_string_field("S1");
+
+  for(size_t t = 0; t < mpinfo.trait_count(); ++t)
+    mpinfo.trait_info(t).set_lockout(false);
+
+  const char* markers[] = { "M0", "M1", "M2" };
+
+  for(size_t m = 0; m < 3; ++m)
+    mpinfo.marker_info(mpinfo.add_marker(markers[m])).gmodel().set_dynamic_alleles(true);
+
+  RefDelimitedPedigreeFile f(errors);
+
+  f.set_format_in_file(true);
+  f.set_delimiters(",");
+  f.set_whitespace(" ");
+
+  f.add_pedigree_id_field  ("PID");
+  f.add_individual_id_field("ID");
+  f.add_parent_id_field    ("FA");
+  f.add_parent_id_field    ("MO");
+  f.add_sex_field          ("SEX");
+  f.add_trait_field        ("Q1", "Q1");
+  f.add_trait_field        ("B1", "B1");
+  f.add_trait_field        ("C1", "C1");
+  f.add_string_field       ("S1", "S1");
+  f.add_marker_field       ("M0", "M0");
+  f.add_allele_field       ("M1a", "M1");
+  f.add_allele_field       ("M1b", "M1");
+  f.add_marker_field       ("M2", "M2");
+
+  std::ostringstream listing;
+
+  return f.input(mp, filename, listing);
+}
+
+int
+test_snapshot()
+{
+  const std::string data_name     = "snapshot_ped.txt";
+  const std::string snapshot_name = "test.snap";
+
+  write_file(data_name,
+      "PID,ID,FA,MO,SEX,Q1,B1,C1,S1,M0,M1a,M1b,M2\n"
+      "p1,1,0,0,M,1.5,A,red,first,A/B,1,2,\n"
+      "p1,2,0,0,F,x,U,blue,,A/A,2,2,C/D\n"
+      "p1,3,1,2,M,2.25,,red,\"a, b\",B/A,1,1,D/D\n"
+      "p1,4,1,2,F,-3,A,green,last,,2,1,C/C\n"
+      "p2,10,0,0,M,0,U,blue,x,A/C,3,3,\n"
+      "p2,11,0,0,F,7,A,,y,C/C,1,3,E/C\n"
+      "p2,12,10,11,M,8,U,red,z,A/C,3,1,E/E\n"
+      "p2,13,0,0,M,x,,,,,,,\n");
+
+  std::ostringstream messages;
+  cerrorstream       errors(messages);
+
+  RefMultiPedigree mp;
+
+  check("pedigree file read", read_pedigrees(mp, data_name, errors) && messages.str().empty());
+
+  // Pedigrees not in file order, to check that the stored order is kept.
+
+  mp.pedigree_index_swap(0, 1);
+
+  std::ostringstream original;
+
+  dump(mp, original);
+
+  std::cout << std::endl << original.str() << std::endl;
+
+  std::string             image;
+  UTIL::BinaryImageWriter out(image);
+
+  write_image(out, mp);
+
+  remove(snapshot_name.c_str());
+
+  // Stores:  the image to a new file, a second entry through a new object,
+  // and a third through an object opened before the second was stored.
+
+  snapshot_file early;
+
+  early.open(snapshot_name);
+
+  snapshot_file first;
+
+  check("store to a new file",            first.store(snapshot_name, 42, 7, image));
+
+  snapshot_file second;
+
+  second.open(snapshot_name);
+
+  check("store a second entry",           second.store(snapshot_name, 43, 8, "second"));
+  check("store through an older object",  early .store(snapshot_name, 44, 9, "third"));
+
+  snapshot_file sf;
+
+  check("snapshot file opens",            sf.open(snapshot_name));
+  check("all entries kept",               sf.entry_count() == 3);
+
+  const char* first_byte = NULL;
+  const char* last_byte  = NULL;
+
+  check("entry with a stale hash",        !sf.find(42, 8, first_byte, last_byte));
+  check("entry with an unknown key",      !sf.find(45, 7, first_byte, last_byte));
+  check("entry found",                    sf.find(42, 7, first_byte, last_byte));
+  check("entry size",                     (size_t) (last_byte - first_byte) == image.size());
+
+  const char* other_first = NULL;
+  const char* other_last  = NULL;
+
+  check("other entries",                  sf.find(43, 8, other_first, other_last) &&
+                                          std::string(other_first, other_last) == "second" &&
+                                          sf.find(44, 9, other_first, other_last) &&
+                                          std::string(other_first, other_last) == "third");
+
+  RefMultiPedigree        rebuilt;
+  UTIL::BinaryImageReader in(first_byte, last_byte);
+
+  check("image read",                     read_image(in, rebuilt) && !in.remaining());
+
+  std::ostringstream copy;
+
+  dump(rebuilt, copy);
+
+  check("same pedigrees, traits, strings and markers", copy.str() == original.str());
+
+  std::string             image2;
+  UTIL::BinaryImageWriter out2(image2);
+
+  write_image(out2, rebuilt);
+
+  check("same image",                     image2 == image);
+
+  // Replacing an entry keeps the others.
+
+  check("replace an entry",               sf.store(snapshot_name, 43, 10, "replaced"));
+  check("entry replaced",                 sf.open(snapshot_name) && sf.entry_count() == 3 &&
+                                          !sf.find(43, 8, other_first, other_last) &&
+                                          sf.find(43, 10, other_first, other_last) &&
+                                          std::string(other_first, other_last) == "replaced");
+
+  sf.close();
+
+  // Damaged images and files.
+
+  RefMultiPedigree        truncated;
+  UTIL::BinaryImageReader short_in(image.data(), image.data() + image.size() - 3);
+
+  check("truncated image not read",       !read_image(short_in, truncated) &&
+                                          !truncated.pedigree_count());
+
+  std::string damaged = image;
+
+  for(size_t i = 16; i < damaged.size(); i += 7)
+    damaged[i] = (char) 0xFF;
+
+  RefMultiPedigree        garbled;
+  UTIL::BinaryImageReader garbled_in(damaged.data(), damaged.data() + damaged.size());
+
+  check("damaged image not read",         !read_image(garbled_in, garbled) &&
+                                          !garbled.pedigree_count());
+
+  std::string contents = read_file(snapshot_name);
+
+  write_file(snapshot_name, contents.substr(0, contents.size() - 8));
+
+  check("truncated file not opened",      !sf.open(snapshot_name));
+
+  write_file(snapshot_name, "SAGESNAP" + contents.substr(8, 4) + "garbage");
+
+  check("damaged file not opened",        !sf.open(snapshot_name));
+
+  check("store over a damaged file",      sf.store(snapshot_name, 42, 7, image) &&
+                                          sf.open(snapshot_name) && sf.entry_count() == 1);
+
+  sf.close();
+
+  remove(snapshot_name.c_str());
+  remove((snapshot_name + ".lock").c_str());
+  remove(data_name.c_str());
+
+  std::cout << std::endl << failures << " failures." << std::endl;
+
+  return failures ? 1 : 0;
+}
+
+} // End namespace RPED
+} // End namespace SAGE
+
+int main()
+{
+  return SAGE::RPED::test_snapshot();
+}
@@ -14,7 +14,8 @@ namespace SEGREG {
 //===================
 
 
-void produce_output(const primary_analysis_results& a, APP::Output_Streams& o, bool append = false)
+void produce_output(const primary_analysis_results& a, const analysis_output& tables,
+                    APP::Output_Streams& o, bool append = false)
 {
 
   const model& md = a.get_final_model();
@@ -31,7 +32,7 @@ void produce_output(const primary_analysis_results& a, APP::Output_Streams& o, b
 
   s<<left;
 
-  analysis_result_file avs(s);
+  analysis_result_file avs(s, tables);
 
   avs.print_header (a);
   avs.print_results(a);
@@ -43,7 +44,7 @@ void produce_output(const primary_analysis_results& a, APP::Output_Streams& o, b
 
   d << left;
 
-  analysis_detailed_file avd(d, o.get_debug_status());
+  analysis_detailed_file avd(d, o.get_debug_status(), tables);
 
   avd.print_header (a);
   avd.print_results(a);
@@ -106,7 +107,8 @@ void produce_output(const primary_analysis_results& a, APP::Output_Streams& o, b
   }
 }
 
-void produce_binary_nt_no_resid_error(const model& md, APP::Output_Streams& o, bool append = false)
+void produce_binary_nt_no_resid_error(const model& md, const analysis_output& tables,
+                                      APP::Output_Streams& o, bool append = false)
 {
   string file = md.get_file_name_root();
 
@@ -120,7 +122,7 @@ void produce_binary_nt_no_resid_error(const model& md, APP::Output_Streams& o, b
 
   s << left;
 
-  analysis_output::output_model (s, md);
+  tables.output_model (s, md);
 
   s << "  The maximum likelihood for this model is identical to that for a" << endl
     << "  one susceptibility model and there is an infinity of sets of maximum" << endl
@@ -133,7 +135,7 @@ void produce_binary_nt_no_resid_error(const model& md, APP::Output_Streams& o, b
 
   d << left;
 
-  analysis_output::output_model (d, md);
+  tables.output_model (d, md);
 
   d << "  The maximum likelihood for this model is identical to that for a" << endl
     << "  one susceptibility model and there is an infinity of sets of maximum" << endl
@@ -166,15 +168,10 @@ void AnalysisController::process_analysis
       (const PedigreeDataSet& ped_data,
        const model&           target_model) const
 {
-      model::cond_mem_set.clear();
-      if (fpmm_and_no_poly_loci > 0) { // addition by JA , original code resumes below
-      analysis_output::skip_poly_locus = true;
-     } else {
-      analysis_output::skip_poly_locus = false;
-    }
+  set<FPED::MemberConstPointer>& cond_mem_set = my_analysis.get_conditioned_members();
+
+  cond_mem_set.clear();
 
-     primary_analysis::like_cutoff = like_cutoff;
- 
   // Copy the model.  We make all our modifications to the test_model.
 
   model test_model = target_model;
@@ -194,7 +191,7 @@ void AnalysisController::process_analysis
 
 // Defining members of the conditioned subset
 // Iterate over all members and insert members of the 
-// Conditioned Subset in cond_mem_set 
+// Conditioned Subset in cond_mem_set (see mean_split)
 
      if (test_model.ascer_sub_model.s_option() != ascertainment_sub_model::none)
     {
@@ -202,7 +199,7 @@ void AnalysisController::process_analysis
       std::list<FPED::MemberConstPointer> mems = ped_data.getMemberList();
       for (listit = mems.begin(); listit != mems.end(); ++listit) {
        if (test_model.ascer_sub_model.is_ind_in_C(*listit)) \
-        model::cond_mem_set.insert(*listit);
+        cond_mem_set.insert(*listit);
        }
      }
  
@@ -263,7 +260,9 @@ void AnalysisController::process_analysis
 
   gsmsm::sm_option mean = test_model.type_dependent_sub_model().option();
 
-  Iterative_Models::intermax.clear();
+  vector<primary_analysis_results>& intermax = my_analysis.get_intermediate_results();
+
+  intermax.clear();
 
   // Run the iteration
 
@@ -277,13 +276,13 @@ void AnalysisController::process_analysis
 
   if(var.option() == genotype_specific_variance_sub_model::one)
   {
-    if (Iterative_Models::intermax.size() == 0)
-    {produce_output(results, my_out);} 
+    if (intermax.size() == 0)
+    {produce_output(results, get_output_tables(), my_out);} 
     else {
-     for (unsigned i = 0; i != Iterative_Models::intermax.size(); i++){
-       primary_analysis_results these_results = Iterative_Models::intermax[i];
-       if (i == 0) produce_output(these_results,my_out,false);
-       if (i > 0) produce_output(these_results,my_out,true);
+     for (unsigned i = 0; i != intermax.size(); i++){
+       primary_analysis_results these_results = intermax[i];
+       if (i == 0) produce_output(these_results,get_output_tables(),my_out,false);
+       if (i > 0) produce_output(these_results,get_output_tables(),my_out,true);
        }
     }
    return; 
@@ -367,13 +366,13 @@ AnalysisController::do_commingling_analysis
   tmsm::sm_option hnt = tmsm::homog_no_trans;
 
   const primary_analysis_results& one_mean_results   = ma.get_model(gsmsm::one,   hnt);
-  produce_output(one_mean_results, my_out,   false);
+  produce_output(one_mean_results, get_output_tables(), my_out,   false);
   
   const primary_analysis_results& two_mean_results   = ma.get_model(gsmsm::two,   hnt);
-  produce_output(two_mean_results, my_out,   true);
+  produce_output(two_mean_results, get_output_tables(), my_out,   true);
   
   const primary_analysis_results& three_mean_results = ma.get_model(gsmsm::three, hnt);
-  produce_output(three_mean_results, my_out, true);
+  produce_output(three_mean_results, get_output_tables(), my_out, true);
   
   // print commingling analysis likelihood table
               
@@ -416,31 +415,51 @@ AnalysisController::do_segregation_analysis
   bool do_hnt = test_model.get_model_class() != model_MLM ||
                 test_model.resid_sub_model.has_residuals();
 
+  // Compute the models first.  Those which don't use each other's results
+  // are maximized concurrently when there's more than one thread.  The
+  // output below is in the same order either way.
+
+  vector<tmsm::sm_option> transm_options;
+
+  if(do_hnt) transm_options.push_back(tmsm::homog_no_trans);
+
+  transm_options.push_back(tmsm::homog_mendelian);
+  transm_options.push_back(tmsm::homog_general);
+  transm_options.push_back(tmsm::tau_ab_free);
+  transm_options.push_back(tmsm::general);
+
+  size_t thread_count = test_model.get_thread_count();
+
+  if(!thread_count)
+    thread_count = UTIL::ThreadPool::default_thread_count();
+
+  ma.compute_models(mo, transm_options, thread_count);
+
   primary_analysis_results hnt_results;
 
   if(do_hnt)
   {
     hnt_results   = ma.get_model(mo, tmsm::homog_no_trans);
-    produce_output(hnt_results, my_out, false);
+    produce_output(hnt_results, get_output_tables(), my_out, false);
   }
   else
   {
-    produce_binary_nt_no_resid_error(test_model, my_out, false);
+    produce_binary_nt_no_resid_error(test_model, get_output_tables(), my_out, false);
   }
 
   // All the other models we always do.
 
   primary_analysis_results mnd_results   = ma.get_model(mo, tmsm::homog_mendelian);
-  produce_output(mnd_results, my_out, true);
+  produce_output(mnd_results, get_output_tables(), my_out, true);
 
   primary_analysis_results hgn_results   = ma.get_model(mo, tmsm::homog_general);
-  produce_output(hgn_results, my_out, true);
+  produce_output(hgn_results, get_output_tables(), my_out, true);
 
   primary_analysis_results tab_results   = ma.get_model(mo, tmsm::tau_ab_free);
-  produce_output(tab_results, my_out, true);
+  produce_output(tab_results, get_output_tables(), my_out, true);
 
   primary_analysis_results gnl_results   = ma.get_model(mo, tmsm::general);
-  produce_output(gnl_results, my_out, true);
+  produce_output(gnl_results, get_output_tables(), my_out, true);
 
   // print segregation analysis likelihood table
 
@@ -494,12 +513,14 @@ void AnalysisController::do_reg_analysis
   // Deal with output if the results are valid
 
   if(results.is_valid())
-    produce_output(results, my_out);
+    produce_output(results, get_output_tables(), my_out);
+
+    const vector<primary_analysis_results>& intermax = my_analysis.get_intermediate_results();
 
-    if(Iterative_Models::intermax.size() > 0){ // due to JA, from earlier maxfun runs
-      for(unsigned i = 0; i != Iterative_Models::intermax.size(); i++){
-        primary_analysis_results these_results = Iterative_Models::intermax[i];
-        produce_output(these_results,my_out);
+    if(intermax.size() > 0){ // due to JA, from earlier maxfun runs
+      for(unsigned i = 0; i != intermax.size(); i++){
+        primary_analysis_results these_results = intermax[i];
+        produce_output(these_results,get_output_tables(),my_out);
       }
     }
 }
@@ -570,7 +591,7 @@ void AnalysisController::produce_allfixed_output
     string current_string = current_pair.first;
     double current_val = current_pair.second;
     
-   if ( (current_string.substr(0,5) == "polyg") && (analysis_output::skip_poly_locus) )continue; // addition by JA
+   if ( (current_string.substr(0,5) == "polyg") && (fpmm_and_no_poly_loci > 0) )continue; // addition by JA
 
     out << left  << setw(2) << " " << setw(15) << current_string.substr(0,15);
     out << right << setw(5) << " " << setw(11) << setprecision(8) << current_val;
@@ -10,8 +10,6 @@ namespace SAGE
 namespace SEGREG
 {
 
-double primary_analysis::like_cutoff = numeric_limits<double>::quiet_NaN();
-
 inline bool primary_analysis::eval_model_bad(const eval_model_ptr& e)
 {
   return e->is_bad;
@@ -33,6 +31,21 @@ inline bool primary_analysis::model_less_than
 
 #define LIKELIHOOD_DISTANCE 1
 #define FINAL_LIKELIHOOD_DISTANCE 0.001
+#define SCREENING_ITERATIONS 5
+
+//=================================
+// deferred_output
+//=================================
+
+void deferred_output::write(APP::Output_Streams& o)
+{
+  o.messages() << messages.str() << flush;
+
+  errors.flush_buffer();
+
+  messages.str("");
+  debug.str("");
+}
 
 //=================================
 // primary_analysis
@@ -60,8 +73,8 @@ vector<std::pair<string,double> > primary_analysis::do_single_evaluation \
 (const PedigreeDataSet& ped_data, const model& test_model, double& func_value, vector<string>& par_type) 
 { // due to JA
 
-   out.messages() << " No independent parameters to maximize. Likelihood will be evaluated  " << endl;
-   out.messages() << " at user specified values of parameters and results written to the .sum file. " << endl;
+   messages() << " No independent parameters to maximize. Likelihood will be evaluated  " << endl;
+   messages() << " at user specified values of parameters and results written to the .sum file. " << endl;
    vector<model> ms;
    ms.clear();
    ms.push_back(test_model);
@@ -229,8 +242,8 @@ const primary_analysis_results& primary_analysis::run_analysis
     my_models[0]->calculator.calculate_mlm_resid_corr(my_results.my_mlm_resid_corr);
 
 // due to JA, storing these results for future use
-    if (my_results.my_valid) {
-     Iterative_Models::intermax.push_back(my_results);
+    if (my_results.my_valid && !my_deferred) {
+     my_intermediate_results.push_back(my_results);
     }
 
   return my_results;
@@ -332,7 +345,8 @@ void primary_analysis::run_discrete_final_maxfun()
 
 primary_analysis::evaluation_model::evaluation_model
     (const model& mv, const PedigreeDataSet& ped_data)
-  : mdl(mv), params(), calculator(ped_data,mdl), current_results(), is_bad(false)
+  : mdl(mv), params(), calculator(ped_data,mdl), current_results(), is_bad(false),
+    is_done(false)
 {
   //cout<<"===================================="<<endl;
   //cout<<"Now I am doing evaluation_model!"<<endl;
@@ -418,10 +432,10 @@ bool primary_analysis::test_models(const PedigreeDataSet& ped_data,
   for(uint i = 0; i != my_models.size(); ++i)
   {
     if(my_models.size() > 1)
-      out.messages() << "        Testing Initial Value " << setw(2) << (i+1)
+      messages() << "        Testing Initial Value " << setw(2) << (i+1)
                      << ".............................." << flush;
     else
-      out.messages() << "        Testing model........................................." << flush;
+      messages() << "        Testing model........................................." << flush;
 
     segreg_errors::error_code return_value = segreg_errors::EVAL_OK;
 
@@ -436,12 +450,12 @@ bool primary_analysis::test_models(const PedigreeDataSet& ped_data,
     {
       MAXFUN::ParameterMgr& params = my_models[i]->params;
 
-      out.debug() << "Initial Values:" << endl; 
+      debug() << "Initial Values:" << endl; 
 
-      out.debug() << "             Parameter           Init.Est." << endl
+      debug() << "             Parameter           Init.Est." << endl
                   << "             ==============      ==========" << endl;
       for(int x = 0; x < params.getParamCount(); ++x)
-        out.debug() << setw(10) << x << ":  " << setw(20) << params.getParameter(x).getName() 
+        debug() << setw(10) << x << ":  " << setw(20) << params.getParameter(x).getName() 
                     << setw(10) << doub2str(params.getParameter(x).getInitialEstimate(),20)  << endl;
     }
 
@@ -455,11 +469,11 @@ bool primary_analysis::test_models(const PedigreeDataSet& ped_data,
     {
       if(!user_defined)
       {
-        out.messages() << "...Done." << endl;
+        messages() << "...Done." << endl;
       }
       else
       {
-        out.messages() << "...Error." << endl << endl;
+        messages() << "...Error." << endl << endl;
 
         // Produce an error message about the model
         //lint -e{788}
@@ -542,7 +556,7 @@ bool primary_analysis::test_models(const PedigreeDataSet& ped_data,
       my_models[i]->is_bad = true;
     }
     else
-      out.messages() << "...Done." << endl;
+      messages() << "...Done." << endl;
   }
 
   // Remove Null models
@@ -568,7 +582,7 @@ bool primary_analysis::test_models(const PedigreeDataSet& ped_data,
   }
   else if(my_models.size() != orig_model_count)
   {
-    out.messages() << "        Keeping "
+    messages() << "        Keeping "
                    << setw(2) << my_models.size() << " of "
                    << setw(2) << orig_model_count << " initial models"
                    << "..........................Done." << endl;
@@ -621,35 +635,73 @@ primary_analysis::run_initial_maxfun()
 //  cout<<"Now I am doing run_initial_maxfun()!"<<endl;
 //  cout<<"===================================="<<endl;
 
+  size_t thread_count = get_initial_thread_count();
+
+  if(my_models.size() > 1 && my_models[0]->mdl.get_prune_distance() > 0)
+    screen_initial_models(thread_count);
+
+  if(thread_count > 1)
+  {
+    // The models are maximized first, and reported afterward in order.
+
+    run_each_model(&primary_analysis::run_initial_maxfun, thread_count);
+
+    for(uint i = 0; i < my_models.size(); ++i)
+    {
+      if(my_models.size() > 1)
+        messages() << "        Attempting Initial Value " << setw(2) << (i+1) 
+                       << "..........................." << flush;
+      else
+        messages() << "        Performing Maximization..............................." << flush;
+
+      messages() << "...Done." << endl;
+
+      output_initial_results(i);
+    }
+
+    return;
+  }
+
   for(uint i = 0; i < my_models.size(); ++i)
   {
     if(my_models.size() > 1)
-      out.messages() << "        Attempting Initial Value " << setw(2) << (i+1) 
+      messages() << "        Attempting Initial Value " << setw(2) << (i+1) 
                      << "..........................." << flush;
     else
-      out.messages() << "        Performing Maximization..............................." << flush;
+      messages() << "        Performing Maximization..............................." << flush;
 
     run_initial_maxfun(i);
 
-    out.messages() << "...Done." << endl;
+    messages() << "...Done." << endl;
 
-    // Debugging output.
+    output_initial_results(i);
+  }
+}
+//--------------------------------------------------------------------------
+//
+//
+//
+//--------------------------------------------------------------------------
+
+void
+primary_analysis::output_initial_results(uint i)
+{
+  // Debugging output.
     
-    MAXFUN::ParameterMgr& params = my_models[i]->params;
+  MAXFUN::ParameterMgr& params = my_models[i]->params;
 
-    out.debug() << "Final likelihood after first maximization loop: "
-                << my_models[i]->current_results.getFinalFunctionValue(); 
+  debug() << "Final likelihood after first maximization loop: "
+              << my_models[i]->current_results.getFinalFunctionValue(); 
 
-    out.debug() << "             Parameter           Init.Est.   Final Est." << endl
-               << "             ==============      ==========  ==========" << endl;
+  debug() << "             Parameter           Init.Est.   Final Est." << endl
+             << "             ==============      ==========  ==========" << endl;
 
-    for(int j = 0; j < params.getParamCount(); ++j)
-    {
-      const MAXFUN::Parameter& param = params.getParameter(j);
-      out.debug() << setw(10) << j << ":  " << setw(20) << right << param.getName() 
-           << setw(10) << doub2str(param.getInitialEstimate(),20)  << "  " 
-           << setw(10) << doub2str(param.getFinalEstimate(),20) << endl;
-    }
+  for(int j = 0; j < params.getParamCount(); ++j)
+  {
+    const MAXFUN::Parameter& param = params.getParameter(j);
+    debug() << setw(10) << j << ":  " << setw(20) << right << param.getName() 
+         << setw(10) << doub2str(param.getInitialEstimate(),20)  << "  " 
+         << setw(10) << doub2str(param.getFinalEstimate(),20) << endl;
   }
 }
 //--------------------------------------------------------------------------
@@ -658,11 +710,9 @@ primary_analysis::run_initial_maxfun()
 //
 //--------------------------------------------------------------------------
 
-void
-primary_analysis::run_initial_maxfun(uint mdl)
+MAXFUN::SequenceCfg
+primary_analysis::get_initial_sequence() const
 {
-  // Set up the methods to be used
-
   MAXFUN::SequenceCfg sequence(MAXFUN::SequenceCfg::USER_DEFINED);
   
   sequence.addRunCfg(MAXFUN::RunCfg::DIRECT_WITHOUT, 1);
@@ -683,12 +733,157 @@ primary_analysis::run_initial_maxfun(uint mdl)
 //  sequence.getLatestRunCfg().epsilon2       = my_quality ? 1e-10 : 1e-8;
   sequence.getLatestRunCfg().control_option = MAXFUN::RunCfg::PREVIOUS_NONCONVERGENCE;
 
+  return sequence;
+}
+
+/// The screening sequence is a few iterations of the direct search which
+/// begins the initial sequence.
+
+MAXFUN::SequenceCfg
+primary_analysis::get_screening_sequence() const
+{
+  MAXFUN::SequenceCfg sequence(MAXFUN::SequenceCfg::USER_DEFINED);
+
+  sequence.addRunCfg(MAXFUN::RunCfg::DIRECT_WITHOUT, SCREENING_ITERATIONS);
+  sequence.getLatestRunCfg().epsilon1 = my_quality ? 1e-3  : 1e-2;
+  sequence.getLatestRunCfg().epsilon2 = my_quality ? 1e-12 : 1e-8;
+
+  return sequence;
+}
+//--------------------------------------------------------------------------
+//
+//
+//
+//--------------------------------------------------------------------------
+
+void
+primary_analysis::run_initial_maxfun(uint mdl)
+{
   // Run the analysis
 
   my_models[mdl]->current_results = 
-       MAXFUN::Maximizer::Maximize(sequence, my_models[mdl]->params,
-                                             my_models[mdl]->calculator,
-                                             my_models[mdl]->mdl.my_maxfun_debug);
+       MAXFUN::Maximizer::Maximize(get_initial_sequence(), my_models[mdl]->params,
+                                                           my_models[mdl]->calculator,
+                                                           my_models[mdl]->mdl.my_maxfun_debug);
+}
+//--------------------------------------------------------------------------
+//
+//
+//
+//--------------------------------------------------------------------------
+
+/// Models are screened from their initial estimates, and those which are
+/// kept are maximized from their initial estimates again, so a model which
+/// survives screening gets exactly the result it would have without it.
+/// The best model always survives.
+
+void
+primary_analysis::screen_initial_models(size_t thread_count)
+{
+  messages() << "      Screening initial models..." << flush;
+
+  run_each_model(&primary_analysis::screen_initial_model, thread_count);
+
+  eval_model_vector::iterator max_model =
+      max_element(my_models.begin(), my_models.end(), model_less_than);
+
+  double cutoff = (*max_model)->current_results.getFinalFunctionValue()
+                - my_models[0]->mdl.get_prune_distance();
+
+  size_t orig_model_count = my_models.size();
+
+  //lint -e{534}
+  my_models.erase(remove_if(my_models.begin(), my_models.end(),
+      fails_cutoff(cutoff)), my_models.end());
+
+  assert(!my_models.empty());
+
+  messages() << "(keeping " << setw(2) << my_models.size() << " of "
+                 << setw(2) << orig_model_count << ")..........Done." << endl;
+}
+
+void
+primary_analysis::screen_initial_model(uint mdl)
+{
+  my_models[mdl]->current_results = 
+       MAXFUN::Maximizer::Maximize(get_screening_sequence(), my_models[mdl]->params,
+                                                             my_models[mdl]->calculator,
+                                                             my_models[mdl]->mdl.my_maxfun_debug);
+}
+//--------------------------------------------------------------------------
+//
+//
+//
+//--------------------------------------------------------------------------
+
+/// The number of models maximized at once.  This is the model's thread
+/// count, but the models are run in order if there's only one of them, or
+/// if maxfun debugging output is requested, since that output would be
+/// interleaved.
+
+size_t
+primary_analysis::get_initial_thread_count() const
+{
+  if(my_models.size() < 2)
+    return 1;
+
+  for(size_t i = 0; i != my_models.size(); ++i)
+    if(my_models[i]->mdl.my_maxfun_debug.getType() != MAXFUN::DebugCfg::NO_DEBUG_INFO)
+      return 1;
+
+  size_t thread_count = my_models[0]->mdl.get_thread_count();
+
+  if(!thread_count)
+    thread_count = UTIL::ThreadPool::default_thread_count();
+
+  return std::max(std::min(thread_count, my_models.size()), (size_t) 1);
+}
+
+/// If a model throws while being run concurrently, the models which didn't
+/// complete are run again in order, so that the exception reaches our
+/// caller just as it would have without threads.
+
+void
+primary_analysis::run_each_model(void (primary_analysis::*f)(uint), size_t thread_count)
+{
+  if(thread_count < 2)
+  {
+    for(uint i = 0; i < my_models.size(); ++i)
+      (this->*f)(i);
+
+    return;
+  }
+
+  for(size_t i = 0; i != my_models.size(); ++i)
+  {
+    my_models[i]->is_done = false;
+    my_models[i]->calculator.set_serial(true);
+  }
+
+  my_model_function = f;
+
+  UTIL::ThreadPool pool(thread_count);
+
+  UTIL::MemberTask<primary_analysis> task(*this, &primary_analysis::run_model_task);
+
+  bool completed = pool.run(my_models.size(), task);
+
+  for(size_t i = 0; i != my_models.size(); ++i)
+    my_models[i]->calculator.set_serial(false);
+
+  if(completed) return;
+
+  for(uint i = 0; i < my_models.size(); ++i)
+    if(!my_models[i]->is_done)
+      (this->*f)(i);
+}
+
+void
+primary_analysis::run_model_task(size_t i, size_t)
+{
+  (this->*my_model_function)((uint) i);
+
+  my_models[i]->is_done = true;
 }
 //--------------------------------------------------------------------------
 //
@@ -706,7 +901,7 @@ void primary_analysis::reduce_model_set()
 
   if(my_models.size() == 1) return;
 
-  out.messages() << "      Choosing models to finalize..." << flush;
+  messages() << "      Choosing models to finalize..." << flush;
 
   // Find the maximum likelihood of all remaining models
 
@@ -729,7 +924,7 @@ void primary_analysis::reduce_model_set()
 
   assert(!my_models.empty());
 
-  out.messages() << "(keeping " << setw(2) << my_models.size()
+  messages() << "(keeping " << setw(2) << my_models.size()
       << ").................Done." << endl;
 }
 //--------------------------------------------------------------------------
@@ -745,29 +940,29 @@ primary_analysis::run_final_maxfun()
   for(size_t i = 0; i < my_models.size(); ++i)
   {
     if(my_models.size() > 1)
-      out.messages() << "        Finalizing Model " << setw(2) << (i+1) 
+      messages() << "        Finalizing Model " << setw(2) << (i+1) 
            << "..................................." << flush;
     else
-      out.messages() << "        Finalizing Model......................................" << flush;
+      messages() << "        Finalizing Model......................................" << flush;
 
     run_final_maxfun(i);
 
-    out.messages() << "...Done." << endl;
+    messages() << "...Done." << endl;
 
     // Debugging output.
     
     MAXFUN::ParameterMgr& params = my_models[i]->params;
 
-    out.debug() << "Final likelihood: "
+    debug() << "Final likelihood: "
                 << my_models[i]->current_results.getFinalFunctionValue(); 
 
-    out.debug() << "             Parameter           Init.Est.   Final Est." << endl
+    debug() << "             Parameter           Init.Est.   Final Est." << endl
                << "             ==============      ==========  ==========" << endl;
 
     for(int j = 0; j < params.getParamCount(); ++j)
     {
       const MAXFUN::Parameter& param = params.getParameter(j);
-      out.debug() << setw(10) << j << ":  " << setw(20) << right << param.getName() 
+      debug() << setw(10) << j << ":  " << setw(20) << right << param.getName() 
            << setw(10) << doub2str(param.getInitialEstimate(),20)  << "  " 
            << setw(10) << doub2str(param.getFinalEstimate(),20) << endl;
     }
@@ -855,7 +1050,7 @@ primary_analysis::finalize_model()
 
   if(my_models.size() == 1) return;
 
-  out.messages() << "      Choosing Final Estimates................................" << flush;
+  messages() << "      Choosing Final Estimates................................" << flush;
 
   // Find the maximum likelihood of all models
 
@@ -912,10 +1107,10 @@ primary_analysis::finalize_model()
   // If no models left, then we've got a problem.  Should never happen
   assert(!my_models.empty());
 
-  out.messages() << "...Done." << endl;
+  messages() << "...Done." << endl;
 }
 
-double primary_analysis_results::get_one_mean_results()
+double primary_analysis_results::get_one_mean_results() const
 {
 //
 // due to JA, retrieving the value of a single mean 
@@ -936,7 +1131,7 @@ double primary_analysis_results::get_one_mean_results()
       return returnval;
 }
 
-double primary_analysis_results::get_one_susc_results()
+double primary_analysis_results::get_one_susc_results() const
 {
 //
 // due to JA, retrieving the value of a single mean 
@@ -29,8 +29,14 @@ namespace SAGE
 namespace SEGREG
 {
 
-bool analysis_output::skip_poly_locus = false; // due to JA
-double analysis_output::deriv_sum_sq =  0.0; // due to JA
+analysis_output::analysis_output(bool skip_poly_locus)
+  : my_skip_poly_locus(skip_poly_locus)
+{ }
+
+bool analysis_output::skip_poly_locus() const
+{
+  return my_skip_poly_locus;
+}
 
 double calculate_akaike(const MAXFUN::Results& mf)
 {
@@ -97,7 +103,7 @@ void analysis_output::output_likelihood_table_footer
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void analysis_output::output_model            
-    (ostream& out, const model& mod)
+    (ostream& out, const model& mod) const
 {
   out << "=====================================================================================================" << endl;
 
@@ -140,12 +146,12 @@ void analysis_output::output_model
 
   if(mod.get_model_class() == model_FPMM)
   {
-       if ( ! analysis_output::skip_poly_locus) // number of polygenic loci set > 0 by user
+       if ( ! my_skip_poly_locus) // number of polygenic loci set > 0 by user
            {
             out << "    " << setw(28) << mod.fpmm_sub_model.name()
                  << " : "    << mod.fpmm_sub_model.option_description()  << endl;
            } // zero polygenic loci set by user
-          if ( (analysis_output::skip_poly_locus))
+          if ( (my_skip_poly_locus))
            {
              out << "    " << setw(28) << mod.fpmm_sub_model.name()
                  << " : "    <<"0 polygenic loci" <<endl;
@@ -364,12 +370,31 @@ void analysis_output::output_initial_estimates
 }
 
 
+double analysis_output::deriv_sum_sq
+    (const primary_analysis_results& test) const
+{
+  const MAXFUN::ParameterMgr& fin_params = test.get_maxfun_results().getParameterMgr();
+
+  double sum_sq = 0.0;
+
+  for( int i = 0; i < fin_params.getParamCount(); ++i )
+  {
+    const MAXFUN::Parameter& param = fin_params.getParameter(i);
+
+    if( (param.getName().substr(0,5) == "polyg") && my_skip_poly_locus ) continue;
+
+    if(param.getInitialType() < 3)
+      sum_sq += param.getDeriv() * param.getDeriv();
+  }
+
+  return sum_sq;
+}
+
 void analysis_output::output_final_estimates  
-    (ostream& out, const primary_analysis_results& test)
+    (ostream& out, const primary_analysis_results& test) const
 {
   const MAXFUN::ParameterMgr& fin_params = test.get_maxfun_results().getParameterMgr();
 
-  analysis_output::deriv_sum_sq = 0;
   // Determine if std errors are available
   bool stde = false;
 
@@ -388,7 +413,7 @@ void analysis_output::output_final_estimates
   {
     const MAXFUN::Parameter& param = fin_params.getParameter(i);
     
-   if ( (param.getName().substr(0,5) == "polyg") && (analysis_output::skip_poly_locus) )continue; // addition by JA
+   if ( (param.getName().substr(0,5) == "polyg") && (my_skip_poly_locus) )continue; // addition by JA
 
     out << left  << setw(2) << " " << setw(15) << param.getName().substr(0,15);
     out << right << setw(5) << " " << fp(param.getFinalEstimate(), 11, 8);
@@ -420,8 +445,6 @@ void analysis_output::output_final_estimates
     
     if(param.getInitialType() < 3)
     {
-      double this_deriv = param.getDeriv();
-      analysis_output::deriv_sum_sq += this_deriv*this_deriv;
       out << setw(5) << " " << fp(param.getDeriv(), 11, 8);
     }
     else
@@ -465,7 +488,7 @@ void analysis_output::output_final_estimates
 }
 
 void analysis_output::output_likelihoods      
-    (ostream& out, const primary_analysis_results& test)
+    (ostream& out, const primary_analysis_results& test) const
 {
   const MAXFUN::Results& results = test.get_maxfun_results();
 
@@ -481,7 +504,7 @@ void analysis_output::output_likelihoods
 }
 
 void analysis_output::output_final_error
-    (ostream& out, const primary_analysis_results& test)
+    (ostream& out, const primary_analysis_results& test) const
 {
   const MAXFUN::Results& results = test.get_maxfun_results();
 
@@ -510,7 +533,7 @@ void analysis_output::output_final_error
           << "Results may not be totally maximized.  Check results carefully." << endl;
       break;
     case 8 :
-      if (analysis_output::deriv_sum_sq > 1.E-03) { // activate warning only if derivatives are not small (due to JA)
+      if (deriv_sum_sq(test) > 1.E-03) { // activate warning only if derivatives are not small (due to JA)
       err << priority(error) << "Likelihood may not be maximized because of model constraints on parameters. "
           << endl << "Estimating fewer parameters may help." << endl;
       }
@@ -620,7 +643,7 @@ analysis_viewer::print_header(const primary_analysis_results& test)
 {
   ostream& out = output_stream();
 
-  analysis_output::output_model(out, test.get_final_model());
+  my_tables.output_model(out, test.get_final_model());
 
   // Only print this stuff if the model was actually maximized
   if(test.is_valid())
@@ -636,7 +659,7 @@ analysis_result_file::print_results(const primary_analysis_results& test)
 {
   if(test.is_valid())
   {
-    analysis_output::output_final_estimates(output_stream(), test);
+    my_tables.output_final_estimates(output_stream(), test);
     if(test.get_final_model().get_model_class() == model_MLM )
       analysis_output::output_mlm_resid_corr_results(output_stream(), test);
   }
@@ -654,7 +677,7 @@ analysis_result_file::print_footer(const primary_analysis_results& test)
 {
   if(test.is_valid())
   {
-    analysis_output::output_likelihoods(output_stream(), test);
+    my_tables.output_likelihoods(output_stream(), test);
   }
 }
 
@@ -663,7 +686,7 @@ analysis_detailed_file::print_results(const primary_analysis_results& test)
 {
   if(test.is_valid())
   {
-    analysis_output::output_final_estimates   (output_stream(), test);
+    my_tables.output_final_estimates   (output_stream(), test);
     analysis_output::output_vc_matrix         (output_stream(), test);
     if(test.get_final_model().get_model_class() == model_MLM )
       analysis_output::output_mlm_resid_corr_results(output_stream(), test);
@@ -690,7 +713,7 @@ analysis_detailed_file::print_footer(const primary_analysis_results& test)
 {
   if(test.is_valid())
   {
-    analysis_output::output_likelihoods(output_stream(), test);
+    my_tables.output_likelihoods(output_stream(), test);
   }
 }
 
@@ -701,7 +724,7 @@ analysis_detailed_file::print_footer(const primary_analysis_results& test)
 void
 analysis_intermediate_file::print_results(const primary_analysis_results& test)
 {
-  analysis_output::output_final_estimates(output_stream(), test);
+  my_tables.output_final_estimates(output_stream(), test);
   if(test.get_final_model().get_model_class() == model_MLM )
     analysis_output::output_mlm_resid_corr_results(output_stream(), test);  
 }
@@ -717,7 +740,7 @@ analysis_intermediate_file::print_footer(const primary_analysis_results& test)
   out << "  Number of Function Evaluations : " << test.get_maxfun_results().getIterations() << endl;
   out << "  Last Return Code               : " << test.get_maxfun_results().getExitFlag()           << endl;
 
-  analysis_output::output_likelihoods(output_stream(), test);
+  my_tables.output_likelihoods(output_stream(), test);
 }
 
 std::string spellout(string st)
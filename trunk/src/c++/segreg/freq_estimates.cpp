@@ -11,8 +11,6 @@ namespace SEGREG
 // the next three arguments refer to genotype probabilities
 // 
 
-bool genotype_frequency_initial_estimates::cont;
- 
 bool freq_model_valid(const genotype_frequency_sub_model& m)
 {
   return !SAGE::isnan(m.freq_A())       &&
@@ -95,7 +93,7 @@ genotype_frequency_initial_estimates::genotype_frequency_initial_estimates
 //
 
 genotype_frequency_initial_estimates::genotype_frequency_initial_estimates
-    (const mean_split& splitter, const freq_sub_model& mod)
+    (const mean_split& splitter, const freq_sub_model& mod, bool continuous)
 {
   // Get the model option
 
@@ -127,7 +125,7 @@ genotype_frequency_initial_estimates::genotype_frequency_initial_estimates
 
   // Set first estimate
 
-  if (genotype_frequency_initial_estimates::cont){
+  if (continuous){
 
  double qA = 1.0 - sqrt(1.0 - 1.0/trait_count);
 
@@ -32,17 +32,28 @@ namespace SEGREG
 
 #include "im_helpers.cpp"
 
-vector<primary_analysis_results> Iterative_Models::intermax; // due to JA for intermediate maximization
-
 template<int M, transmission_sub_model::sm_option T> 
 const primary_analysis_results&
 Iterative_Models::get_model_results (mean_option m, bool quality)
 {
   model_results& ms = my_iterative_models[model_classification(m,T)];
 
+  // Only the model requested of compute_models() is deferred, not the models
+  // it depends on.
+
+  bool defer = my_defer;
+
+  my_defer = false;
+
+  // A model computed now, while creating the starting points of a stage,
+  // comes after the stage's models before it, so those are finished first.
+
+  if(!defer && !my_jobs.empty() && !ms.is_available() && !is_pending(ms))
+    run_jobs();
+
   // If we have already calculated this result, there's nothing to do.
 
-  if(!ms.is_available())
+  if(!ms.is_available() && !is_pending(ms))
   {
     // Create the model vector.
 
@@ -50,6 +61,16 @@ Iterative_Models::get_model_results (mean_option m, bool quality)
 
     get_starting_models<M,T>(v, m);
 
+    if(defer)
+    {
+      if(v.size())
+        transform_starting_models<M,T>(v, m);
+
+      my_jobs.push_back(model_job(m, T, &ms, v, quality, out.errors()));
+
+      return ms.result;
+    }
+
     // Indicate that we're starting the new model
 
     output_max_line(m, T);
@@ -895,10 +916,10 @@ bool Iterative_Models::create_initial_onset(model& m)
 
     mean_split ms;
     
-    ms(*my_ped_data.get_raw_data(), m.ons_sub_model.age_of_onset());
+    ms(*my_ped_data.get_raw_data(), m.ons_sub_model.age_of_onset(), analyzer.get_conditioned_members());
 
     if(!ms.get_n())
-      ms(*my_ped_data.get_raw_data(), m.ons_sub_model.age_at_exam());
+      ms(*my_ped_data.get_raw_data(), m.ons_sub_model.age_at_exam(), analyzer.get_conditioned_members());
 
     age_mean = ms.get_mean();
     age_var  = ms.get_var ();
@@ -909,7 +930,7 @@ bool Iterative_Models::create_initial_onset(model& m)
 
     mean_split ms;
     
-    ms(*my_ped_data.get_raw_data(), m.get_primary_trait());
+    ms(*my_ped_data.get_raw_data(), m.get_primary_trait(), analyzer.get_conditioned_members());
 
     aff_mean = ms.get_mean();
     aff_var  = ms.get_var ();
@@ -1212,12 +1233,10 @@ void Iterative_Models::create_two_mean_estimates
 // new adddition here to accomodate new starting values 
   if(is_model_continuous(v[0]))
   {
-    genotype_frequency_initial_estimates::cont = true;
     create_continuous_two_mean_estimates(v, two_opt);
   }
   else // Discrete
   {
-    genotype_frequency_initial_estimates::cont = false;
     create_discrete_two_mean_estimates(v, two_opt);
   }
 }
@@ -1231,7 +1250,9 @@ void Iterative_Models::create_continuous_two_mean_estimates
     (model_vector& v, mean_option two_opt)
 {
   
-  if (Iterative_Models::intermax.size() != 0){
+  const vector<primary_analysis_results>& intermax = analyzer.get_intermediate_results();
+
+  if (intermax.size() != 0){
   one_mean_res = intermax[0].get_one_mean_results(); // due to JA for using
   }
  
@@ -1251,7 +1272,7 @@ void Iterative_Models::create_continuous_two_mean_estimates
   // Create our frequency model.  
   
   genotype_frequency_initial_estimates
-      freq_est(my_trait_sample, my_target_model.freq_sub_model);
+      freq_est(my_trait_sample, my_target_model.freq_sub_model, true);
 
 // Needed to decide in advance which estimates to keep
 
@@ -1449,6 +1470,188 @@ void Iterative_Models::run_models
     ret.availability = model_results::bad;
 }
 
+//--------------------------------------------------------------------------
+//
+//      Concurrent computation
+//
+//--------------------------------------------------------------------------
+
+Iterative_Models::model_job::model_job
+    (mean_option m, transm_option t, model_results* r, const model_vector& v, bool q,
+     cerrorstream& err)
+  : mean_opt(m),
+    transm_opt(t),
+    results(r),
+    models(v),
+    quality(q),
+    done(false),
+    output(new deferred_output(err)),
+    result()
+{ }
+
+bool Iterative_Models::uses_results_of(transm_option t, transm_option u)
+{
+  switch(t)
+  {
+    case no_trans        : return u == homog_no_trans;
+
+    case homog_general   :
+    case tau_ab_free     : return u == homog_no_trans || u == homog_mendelian;
+
+    case general         : return u == no_trans       || u == homog_general ||
+                                  u == tau_ab_free;
+
+    default              : return false;
+  }
+}
+
+void Iterative_Models::compute_models
+    (mean_option m, const vector<transm_option>& t, size_t thread_count)
+{
+  if(thread_count < 2 || out.get_debug_status() ||
+     my_target_model.my_maxfun_debug.getType() != MAXFUN::DebugCfg::NO_DEBUG_INFO)
+  {
+    for(size_t i = 0; i < t.size(); ++i)
+      get_model(m, t[i]);
+
+    return;
+  }
+
+  my_job_threads = thread_count;
+
+  // Assign the models to stages
+
+  vector<size_t> stage(t.size(), 0);
+
+  size_t stage_count = 0;
+
+  for(size_t i = 0; i < t.size(); ++i)
+  {
+    for(size_t j = 0; j < i; ++j)
+      if(uses_results_of(t[i], t[j]))
+        stage[i] = std::max(stage[i], stage[j] + 1);
+
+    stage_count = std::max(stage_count, stage[i] + 1);
+  }
+
+  for(size_t s = 0; s < stage_count; ++s)
+  {
+    // Create the starting points of the stage's models, in order.  Any
+    // models they depend on which aren't yet available are computed now,
+    // after the stage's models before them (see get_model_results()).
+
+    my_jobs.clear();
+
+    for(size_t i = 0; i < t.size(); ++i)
+    {
+      if(stage[i] != s) continue;
+
+      my_defer = true;
+
+      get_model(m, t[i]);
+
+      my_defer = false;
+    }
+
+    run_jobs();
+  }
+}
+
+void Iterative_Models::run_jobs()
+{
+  if(my_jobs.empty()) return;
+
+  // Maximize the jobs.  If one throws, the jobs which didn't complete are
+  // run again in order, so the exception reaches our caller just as it
+  // would have without threads.
+
+  if(my_jobs.size() > 1)
+  {
+    size_t job_threads = std::min(my_job_threads, my_jobs.size());
+
+    // Each job gets its share of the threads for its own initial models
+    // and calculators, rather than my_job_threads each.
+
+    size_t share = std::max(my_job_threads / job_threads, (size_t) 1);
+
+    for(size_t j = 0; j < my_jobs.size(); ++j)
+      for(size_t i = 0; i < my_jobs[j].models.size(); ++i)
+        my_jobs[j].models[i].set_thread_count(share);
+
+    UTIL::ThreadPool pool(job_threads);
+
+    UTIL::MemberTask<Iterative_Models> task(*this, &Iterative_Models::run_job);
+
+    if(!pool.run(my_jobs.size(), task))
+    {
+      for(size_t j = 0; j < my_jobs.size(); ++j)
+        if(!my_jobs[j].done)
+          run_job(j, 0);
+    }
+  }
+  else
+    run_job(0, 0);
+
+  for(size_t j = 0; j < my_jobs.size(); ++j)
+    finish_job(my_jobs[j]);
+
+  my_jobs.clear();
+}
+
+bool Iterative_Models::is_pending(const model_results& res) const
+{
+  for(size_t j = 0; j < my_jobs.size(); ++j)
+    if(my_jobs[j].results == &res)
+      return true;
+
+  return false;
+}
+
+void Iterative_Models::run_job(size_t j, size_t)
+{
+  model_job& job = my_jobs[j];
+
+  if(!job.models.empty())
+  {
+    primary_analysis a(out, *job.output);
+
+    a.set_quality(job.quality);
+
+    job.result = a.run_analysis(my_ped_data, job.models, false);
+  }
+
+  job.done = true;
+}
+
+/// This is the output, and storage, get_model_results() would have done.
+
+void Iterative_Models::finish_job(model_job& job)
+{
+  output_max_line(job.mean_opt, job.transm_opt);
+
+  if(job.models.empty())
+  {
+    produce_model_failure(job.mean_opt, job.transm_opt, *job.results);
+  }
+  else
+  {
+    job.output->write(out);
+
+    job.results->result = job.result;
+
+    if(job.result.is_valid())
+    {
+      job.results->availability = model_results::good;
+
+      analyzer.get_intermediate_results().push_back(job.result);
+    }
+    else
+      job.results->availability = model_results::bad;
+  }
+
+  output_max_line(job.mean_opt, job.transm_opt, true);
+}
+
 void Iterative_Models::produce_model_failure
     (mean_option m, transm_option t, model_results& mr)
 {
@@ -1624,7 +1827,7 @@ void Iterative_Models::create_discrete_two_mean_estimates
    
 // use_mean and use_freq are false if all genotype frequencies are known
 
-  one_susc_res = intermax[0].get_one_susc_results(); // due to JA for using
+  one_susc_res = analyzer.get_intermediate_results()[0].get_one_susc_results(); // due to JA for using
 
   double beta_hat = one_susc_res; // Appendix B Eq.2 A.
 
@@ -1634,7 +1837,7 @@ void Iterative_Models::create_discrete_two_mean_estimates
   model_vector initial_models = v;
 
   genotype_frequency_initial_estimates
-      freq_est(my_trait_sample, my_target_model.freq_sub_model);
+      freq_est(my_trait_sample, my_target_model.freq_sub_model, false);
 
   size_t model_count = 18;
 
@@ -10,7 +10,8 @@ namespace SEGREG
 {
 
 bool 
-mean_split::calculate_trait_statistics(const FPED::Multipedigree& ped_data, const string& trait_name)
+mean_split::calculate_trait_statistics(const FPED::Multipedigree& ped_data, const string& trait_name,
+                                       const set<FPED::MemberConstPointer>& excluded)
 {
   clear();
 
@@ -31,13 +32,13 @@ mean_split::calculate_trait_statistics(const FPED::Multipedigree& ped_data, cons
       ++member_idx)
 
 // this loop skips over members on the conditioned subset
-// model::cond_mem_set is empty unless there is ascertainment
+// excluded is empty unless there is ascertainment
     {
       FPED::MemberConstPointer mem = &ped->member_index(member_idx);
-      if (SAGE::SEGREG::model::cond_mem_set.size() > 0) {
-      set<FPED::MemberConstPointer>::iterator memit;
-      memit = SAGE::SEGREG::model::cond_mem_set.find(mem);
-        if (memit == SAGE::SEGREG::model::cond_mem_set.end()) {
+      if (excluded.size() > 0) {
+      set<FPED::MemberConstPointer>::const_iterator memit;
+      memit = excluded.find(mem);
+        if (memit == excluded.end()) {
         double value = ped->info().trait(member_idx,trait_number);
         if(finite(value)) values.push_back(value);
         }
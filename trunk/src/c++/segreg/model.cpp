@@ -26,8 +26,6 @@ namespace SEGREG
 //============================================================================
 //
 
-set<FPED::MemberConstPointer> model::cond_mem_set; // due to JA for member of conditioned subset
-
 // - Set parameters to their default values.
 //
 void
@@ -68,6 +66,8 @@ model::reset(cerrorstream& errors)
   each_pedigree    = false;
   pen_func_output  = false;
   type_prob        = false;
+  thread_count     = 0;
+  prune_distance   = 0.0;
   mean_missing     = true;
   susc_missing     = true;
   trans_missing    = true;
@@ -254,6 +254,14 @@ parser::classify_parameter(const LSFBase* param)
   {
     set_parameter(param_name, &ptrs.maxfun_options, param);
   }
+  else if(param_name == "THREADS")
+  {
+    set_parameter(param_name, &ptrs.threads, param);
+  }
+  else if(param_name == "PRUNE")
+  {
+    set_parameter(param_name, &ptrs.prune, param);
+  }
   else
   {
     errors << priority(error) << "Parameter '" << param_name
@@ -315,6 +323,18 @@ parser::second_pass_parse()
     my_model.my_maxfun_debug.setDebugOutput(fname, true);
   }
 
+  // THREADS -- Independent of the model options.
+  if(process_block(ptrs.threads))
+  {
+    parse_threads(ptrs.threads);
+  }
+
+  // PRUNE -- Independent of the model options.
+  if(process_block(ptrs.prune))
+  {
+    parse_prune(ptrs.prune);
+  }
+
   // TYPE MEAN
   if(process_block(ptrs.type_mean))
   {
@@ -3139,6 +3159,50 @@ parser::parse_primary_trait(const LSFBase* param)
   }
 }
 
+// - Number of threads used to evaluate the likelihood.  0 uses the
+//   program default (see the --threads command line option).
+//
+void
+parser::parse_threads(const LSFBase* param)
+{
+  int  value = 0;
+
+  if(parse_integer(param, value) != APP::LSFConvert::GOOD)
+    return;
+
+  if(value < 0)
+  {
+    errors << priority(warning) << "Invalid value for parameter, threads.  "
+           << "Using the program default." << endl;
+
+    value = 0;
+  }
+
+  my_model.thread_count = (size_t) value;
+}
+
+// - Log likelihood distance at which initial models are pruned.  0 turns
+//   pruning off.
+//
+void
+parser::parse_prune(const LSFBase* param)
+{
+  double  value = 0.0;
+
+  if(parse_real(param, value) != APP::LSFConvert::GOOD)
+    return;
+
+  if(!finite(value) || value < 0)
+  {
+    errors << priority(warning) << "Invalid value for parameter, prune.  "
+           << "Initial models will not be pruned." << endl;
+
+    value = 0.0;
+  }
+
+  my_model.prune_distance = value;
+}
+
 void
 parser::parse_title(const LSFBase* param)
 {
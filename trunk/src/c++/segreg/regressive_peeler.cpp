@@ -95,7 +95,7 @@ regressive_peeler::internal_partial_parental_likelihood(
 const regressive_peeler::result_type & 
 regressive_peeler::internal_anterior(const member_type& ind, const data_type & g, result_type & ia)
 {
-  PenetranceContext context = my_likelihood_elts.get_penetrance_context();
+  PenetranceContext context = my_likelihood_elts->get_penetrance_context();
   
   context.set_nuclear_family(*ind.family());
   
@@ -126,7 +126,7 @@ const regressive_peeler::result_type &
 regressive_peeler::internal_anterior_with_mate(const member_type& ind, const member_type& spouse, 
   const data_type & g, const data_type & h, result_type & iawm)
 {
-  PenetranceContext context = my_likelihood_elts.get_penetrance_context();
+  PenetranceContext context = my_likelihood_elts->get_penetrance_context();
   
   context.set_link_couple(ind, spouse);
   context.set_link_spouse_state(h);
@@ -166,7 +166,7 @@ regressive_peeler::internal_anterior_terminal
      const data_type &  g, 
      result_type &      iatg)
 {
-  PenetranceContext context = my_likelihood_elts.get_penetrance_context();
+  PenetranceContext context = my_likelihood_elts->get_penetrance_context();
   
   iatg = calculate_founder_anterior(ind,g,context);
 
@@ -210,7 +210,7 @@ regressive_peeler::internal_posterior_with_mate(
         const member_type& ind, const member_type& mate, const data_type & g, result_type & ipwm)
 {
   // Create our context
-  PenetranceContext context = my_likelihood_elts.get_penetrance_context();
+  PenetranceContext context = my_likelihood_elts->get_penetrance_context();
 
   FPED::FamilyConstPointer fam =
       ind.pedigree()->family_find(ind, mate);
@@ -224,7 +224,7 @@ regressive_peeler::internal_posterior_with_mate(
   
   log_double    posterior(0.0);
   
-  const TypeDescription& tdesc = my_likelihood_elts.get_type_description();
+  const TypeDescription& tdesc = my_likelihood_elts->get_type_description();
 
   for(TypeDescription::StateIterator mate_geno = tdesc.begin();
       mate_geno != tdesc.end();
@@ -292,7 +292,7 @@ log_double
   
   log_double    mother_total(0.0);
 
-  const TypeDescription& tdesc = my_likelihood_elts.get_type_description();
+  const TypeDescription& tdesc = my_likelihood_elts->get_type_description();
 
   for(TypeDescription::StateIterator mother_geno = tdesc.begin();
       mother_geno != tdesc.end(); 
@@ -341,10 +341,10 @@ double
     const TypeDescription::State& mstate = context.get_mother_state();
     const TypeDescription::State& fstate = context.get_father_state();
 
-    double trans_geno_indiv = my_likelihood_elts.get_transmission
+    double trans_geno_indiv = my_likelihood_elts->get_transmission
                                     (geno,mstate,fstate);
               
-    double penetrance_indiv = my_likelihood_elts.get_penetrance
+    double penetrance_indiv = my_likelihood_elts->get_penetrance
                                     (ind, geno, context);
 
     return trans_geno_indiv * penetrance_indiv;
@@ -366,7 +366,7 @@ log_double
   {
     log_double child_prob(0.0);
 
-    const TypeDescription& tdesc = my_likelihood_elts.get_type_description();
+    const TypeDescription& tdesc = my_likelihood_elts->get_type_description();
 
     for(TypeDescription::StateIterator child_geno = tdesc.begin();
         child_geno != tdesc.end(); 
@@ -401,7 +401,7 @@ regressive_peeler::sibship_likelihood_excluding_sib
   {
     log_double state_loop_total(0);
 
-    const TypeDescription& tdesc = my_likelihood_elts.get_type_description();
+    const TypeDescription& tdesc = my_likelihood_elts->get_type_description();
 
     for(TypeDescription::StateIterator state_loop = tdesc.begin();
         state_loop != tdesc.end(); 
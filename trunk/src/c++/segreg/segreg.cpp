@@ -78,7 +78,6 @@ int segreg::main()
        controller.like_cutoff = data.like_cutoff;
        controller.do_analysis(data.pedigrees(), *i);
        ii++;
-       Iterative_Models::intermax.clear(); // due to JA needed to avoid seg_fault
     }
   }
 
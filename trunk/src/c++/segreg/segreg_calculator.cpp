@@ -38,13 +38,6 @@ namespace SEGREG {
 
 static const double PEN_CUTOFF=1e-5;
 
-vector<double> segreg_calculator::reg_ant_vec; // due to JA for likelihood rescaling
-vector<double> segreg_calculator::reg_pos_vec; // see above
-vector<double> segreg_calculator::mlm_ant_vec; // due to JA for likelihood rescaling
-vector<double> segreg_calculator::mlm_pos_vec; // see above
-vector<double> segreg_calculator::fpmm_ant_vec; // due to JA for likelihood rescaling
-vector<double> segreg_calculator::fpmm_pos_vec; // see above
-
 /// reduce_normal_set takes three double values, (AA, AB and BB), which are
 /// assumed to sum to 1.0, removes all values less than the cutoff, then
 /// re-normalizes, and returns the values.
@@ -214,6 +207,24 @@ int segreg_calculator::update_bounds(parameter_vector& v)
      default         : break;
    }
 
+   // The other workers' copies see the same model, so they will report the
+   // same errors as ours.  We only need them to be current.
+
+   if(!err_code && !asc_err_code)
+   {
+     for(size_t w = 1; w < my_workers.size(); ++w)
+     {
+       worker_state& ws = my_workers[w];
+
+       if(ws.like_elts)     ws.like_elts     ->update();
+       if(ws.asc_like_elts) ws.asc_like_elts ->update();
+       if(ws.fpmmsl)        ws.fpmmsl        ->update();
+       if(ws.asc_fpmmsl)    ws.asc_fpmmsl    ->update();
+       if(ws.bmc)           ws.bmc           ->update();
+       if(ws.abmc)          ws.abmc          ->update();
+     }
+   }
+
    // If there's an error, return it
 
    if(err_code)     return err_code;
@@ -283,136 +294,172 @@ log_double segreg_calculator::calculate()
 
 void segreg_calculator::calc_connected_regressive()
 {
-  for(PedigreeDataSet::SubpedigreeIterator
-          subped = my_ped_data.get_subpedigree_begin();
-          subped != my_ped_data.get_subpedigree_end(); ++subped)
-  {
-    // Get the general pedigree likelihood
-    log_double like = calc_connected_regressive(*subped, false);
+  calc_connected(&segreg_calculator::calc_connected_regressive);
+}
 
-    // If ascertainment is turned on, we must adjust the pedigree likelihood
-    if(using_ascertainment())
-      like /= calc_connected_regressive(*subped, true);
+void segreg_calculator::calc_connected_FPMM()
+{
+  calc_connected(&segreg_calculator::calc_connected_FPMM);
+}
 
-    if(!accumulate_likelihood(like)) return;
-  }
+void segreg_calculator::calc_connected_MLM()
+{
+  calc_connected(&segreg_calculator::calc_connected_MLM);
 }
 
-void segreg_calculator::calc_connected_FPMM()
+//----------------------------------------------------------------------------
+//
+//      calc_connected(...)
+//
+//----------------------------------------------------------------------------
+// Subpedigrees are independent given the model, so when we have a thread
+// pool their likelihoods are computed concurrently, each worker using its
+// own components.  The likelihoods are stored by subpedigree and accumulated
+// in order afterward, so the result is identical to the serial one.
+
+void segreg_calculator::calc_connected(subped_function f)
 {
-  for(PedigreeDataSet::SubpedigreeIterator
-          subped = my_ped_data.get_subpedigree_begin();
-          subped != my_ped_data.get_subpedigree_end(); ++subped)
+  if(!my_thread_pool.get() || my_serial)
   {
-    // Get the general pedigree likelihood
+    for(size_t i = 0; i < my_subpedigrees.size(); ++i)
+    {
+      // Get the general pedigree likelihood
+      log_double like = (this->*f)(i, false, my_workers[0]);
+
+      // If ascertainment is turned on, we must adjust the pedigree likelihood
+      if(using_ascertainment())
+        like /= (this->*f)(i, true, my_workers[0]);
 
-    log_double like = calc_connected_FPMM(*subped, false);
+      if(!accumulate_likelihood(like)) return;
+    }
 
-    // If ascertainment is turned on, we must adjust the pedigree likelihood
-    if(using_ascertainment())
-      like /= calc_connected_FPMM(*subped, true);
+    return;
+  }
 
-    if(!accumulate_likelihood(like)) return;
+  my_subped_function = f;
+
+  my_subped_likelihoods.resize(my_subpedigrees.size());
+
+  UTIL::MemberTask<segreg_calculator> task(*this, &segreg_calculator::calc_connected_task);
+
+  if(!my_thread_pool->run(my_subpedigrees.size(), task))
+  {
+    accumulate_likelihood(log_double(QNAN));
+    return;
   }
+
+  for(size_t i = 0; i < my_subped_likelihoods.size(); ++i)
+    if(!accumulate_likelihood(my_subped_likelihoods[i])) return;
 }
 
-void segreg_calculator::calc_connected_MLM()
+void segreg_calculator::calc_connected_task(size_t i, size_t w)
 {
-  for(PedigreeDataSet::SubpedigreeIterator
-          subped = my_ped_data.get_subpedigree_begin();
-          subped != my_ped_data.get_subpedigree_end(); ++subped)
-  {
-    // Get the general pedigree likelihood
-    log_double like = calc_connected_MLM(*subped, false);
+  // Get the general pedigree likelihood
+  log_double like = (this->*my_subped_function)(i, false, my_workers[w]);
 
-    // If ascertainment is turned on, we must adjust the pedigree likelihood
-    if(using_ascertainment())
-      like /= calc_connected_MLM(*subped, true);
+  // If ascertainment is turned on, we must adjust the pedigree likelihood
+  if(using_ascertainment())
+    like /= (this->*my_subped_function)(i, true, my_workers[w]);
 
-    if(!accumulate_likelihood(like)) return;
+  my_subped_likelihoods[i] = like;
+}
+
+//----------------------------------------------------------------------------
+//
+//      rescaled_likelihood(...)
+//
+//----------------------------------------------------------------------------
+// Combines the anterior and posterior terms stored by the
+// calc_subped_given_member_* functions into the subpedigree likelihood.
+// Both are normalized before being multiplied to avoid underflow, and the
+// normalizing constants are applied afterward. (due to JA)
+
+log_double segreg_calculator::rescaled_likelihood(worker_state& w)
+{
+  double ant_norm = 0; // due to JA for likelihood rescaling
+  double pos_norm = 0; // due to JA for likelihood rescaling
+  double rescale_like = 0;// see above
+
+  for (unsigned i = 0; i != w.ant_vec.size(); i++) { // defining the rescaling constants
+    ant_norm += w.ant_vec[i];
+    pos_norm += w.pos_vec[i];
+  }
+
+  for (unsigned i = 0; i != w.ant_vec.size(); i++) { // now rescale
+    w.ant_vec[i] = w.ant_vec[i]/ant_norm;
+    w.pos_vec[i] = w.pos_vec[i]/pos_norm;
   }
+
+  for (unsigned i = 0; i != w.ant_vec.size(); i++) { // the likelihood after rescaling 
+    rescale_like += w.ant_vec[i]*w.pos_vec[i]; 
+  }
+
+  log_double new_log_like(0.0);
+  new_log_like = ant_norm*pos_norm*rescale_like; // due to JA
+
+  return new_log_like;
 }
 
 log_double segreg_calculator::calc_connected_regressive
-    (const FPED::Subpedigree& ps, bool asc)
+    (size_t i, bool asc, worker_state& w)
 {
-  // Create and set up the regressive_peeler
+  const FPED::Subpedigree& ps = *my_subpedigrees[i];
+
+  // Set up the regressive_peeler, creating it the first time
+
+  const LikelihoodElements& lelt = *((asc) ? w.asc_like_elts : w.like_elts);
 
-  regressive_peeler plr(ps,  *((asc) ? my_asc_like_elts : my_like_elts));
+  regressive_peeler*& plr = my_peelers[i].reg[asc];
+
+  if(!plr) plr = new regressive_peeler(ps, lelt);
+  else     plr->reset(lelt);
 
   // Initially, the likelihood is 0
 
   log_double like(0.0);
 
-  double ant_norm = 0; // due to JA for likelihood rescaling
-  double pos_norm = 0; // due to JA for likelihood rescaling
-  double rescale_like = 0;// see above
-
-  segreg_calculator::reg_ant_vec.clear(); // due to JA for likelihod rescaling
-  segreg_calculator::reg_pos_vec.clear(); // due to JA for likelihood rescaling
+  w.ant_vec.clear(); // due to JA for likelihod rescaling
+  w.pos_vec.clear(); // due to JA for likelihood rescaling
 
   // Doesn't matter which individual, so just use the first one
 
-
   const member_type& indi = ps.member_index(0);
 
-  const TypeDescription& tdesc = my_like_elts->get_type_description();
+  const TypeDescription& tdesc = w.like_elts->get_type_description();
 
   for(TypeDescription::StateIterator state = tdesc.begin();
       state != tdesc.end(); ++state)
   {
-    like += calc_subped_given_member_regressive(&plr, indi, *state);
+    like += calc_subped_given_member_regressive(plr, indi, *state, &w);
   }
-  
- for (unsigned i = 0; i != segreg_calculator::reg_ant_vec.size(); i++) { // defining the rescaling constants
-    ant_norm += segreg_calculator::reg_ant_vec[i];
-     pos_norm += segreg_calculator::reg_pos_vec[i];
- }
-
- for (unsigned i = 0; i != segreg_calculator::reg_ant_vec.size(); i++) { // now rescale
-    segreg_calculator::reg_ant_vec[i] = segreg_calculator::reg_ant_vec[i]/ant_norm;
-     segreg_calculator::reg_pos_vec[i] = segreg_calculator::reg_pos_vec[i]/pos_norm;
- }
-
- for (unsigned i = 0; i != segreg_calculator::reg_ant_vec.size(); i++) { // the likelihood after rescaling 
-    rescale_like += segreg_calculator::reg_ant_vec[i]*segreg_calculator::reg_pos_vec[i]; 
- }
-
- log_double new_log_like(0.0);
- new_log_like = ant_norm*pos_norm*rescale_like; // due to JA
-  return new_log_like;
+
+  return rescaled_likelihood(w);
 
 //  return like;
 }
 
 log_double segreg_calculator::calc_connected_FPMM
-    (const FPED::Subpedigree& ps, bool asc)
+    (size_t i, bool asc, worker_state& w)
 {
-  // Create and set up the FPMM_peeler
+  const FPED::Subpedigree& ps = *my_subpedigrees[i];
 
-  FPMM_peeler* plr = new FPMM_peeler(ps, md);
+  // Set up the FPMM_peeler, creating it the first time
 
-  if(!asc)
-  {
-    plr->set_SL(fpmmsl);
-    fpmmsl->set_peeler(plr);
-  }
-  else
-  {
-    plr->set_SL(asc_fpmmsl);
-    asc_fpmmsl->set_peeler(plr);
-  }
+  FPMM_SL* sl = (asc) ? w.asc_fpmmsl : w.fpmmsl;
+
+  FPMM_peeler*& plr = my_peelers[i].fpmm[asc];
+
+  if(!plr) plr = new FPMM_peeler(ps, md);
+
+  plr->reset(sl);
+  sl->set_peeler(plr);
 
   // Initially, the likelihood is 0
 
   log_double like(0.0);
 
-  double ant_norm = 0; // due to JA for likelihood rescaling
-  double pos_norm = 0; // due to JA for likelihood rescaling
-  double rescale_like = 0;// see above
-
-  segreg_calculator::fpmm_ant_vec.clear(); // due to JA for likelihod rescaling
-  segreg_calculator::fpmm_pos_vec.clear(); // due to JA for likelihood rescaling
+  w.ant_vec.clear(); // due to JA for likelihod rescaling
+  w.pos_vec.clear(); // due to JA for likelihood rescaling
 
   // Doesn't matter which individual, so just use the first one
   const member_type& indi = ps.member_index(0);
@@ -423,61 +470,39 @@ log_double segreg_calculator::calc_connected_FPMM
   {
     for(g.polygenotype = 0; g.polygenotype < md.fpmm_sub_model.max_pgt(); ++g.polygenotype)
     {
-      like += calc_subped_given_member_FPMM(plr, indi, g);
+      like += calc_subped_given_member_FPMM(plr, indi, g, &w);
     }
   }
 
- for (unsigned i = 0; i != segreg_calculator::fpmm_ant_vec.size(); i++) { // defining the rescaling constants
-    ant_norm += segreg_calculator::fpmm_ant_vec[i];
-     pos_norm += segreg_calculator::fpmm_pos_vec[i];
- }
-
- for (unsigned i = 0; i != segreg_calculator::fpmm_ant_vec.size(); i++) { // now rescale
-    segreg_calculator::fpmm_ant_vec[i] = segreg_calculator::fpmm_ant_vec[i]/ant_norm;
-     segreg_calculator::fpmm_pos_vec[i] = segreg_calculator::fpmm_pos_vec[i]/pos_norm;
- }
-
- for (unsigned i = 0; i != fpmm_ant_vec.size(); i++) { // the likelihood after rescaling
-    rescale_like += segreg_calculator::fpmm_ant_vec[i]*segreg_calculator::segreg_calculator::fpmm_pos_vec[i]; 
- }
-
-  delete plr;
-  
-
- log_double new_log_like(0.0);
- new_log_like = ant_norm*pos_norm*rescale_like; // due to JA
- 
-  return new_log_like;
+  return rescaled_likelihood(w);
 
 //  return like;
 }
 
 log_double segreg_calculator::calc_connected_MLM
-    (const FPED::Subpedigree& ps, bool asc)
+    (size_t i, bool asc, worker_state& w)
 {
-  // Create and set up the mlm_peeler
-  
-  MlmLikelihoodElements lelt(*my_ped_data.get_raw_data(),md,asc);
+  const FPED::Subpedigree& ps = *my_subpedigrees[i];
 
-  if(!asc)
-    mpl = new mlm_peeler(ps,bmc,*my_ped_data.get_raw_data(),md,lelt, asc);
-  else
-    mpl = new mlm_peeler(ps,abmc,*my_ped_data.get_raw_data(),md,lelt,asc);
+  // Set up the subpedigree's mlm_peeler, creating it the first time.  This
+  // is used rather than mpl, since workers may be peeling other
+  // subpedigrees at the same time.
 
-  // Initially, the likelihood is 0
+  const MlmLikelihoodElements& lelt = *((asc) ? my_asc_mlm_like_elts : my_mlm_like_elts);
 
-  log_double like(0.0);
+  binary_member_calculator* mc = (asc) ? w.abmc : w.bmc;
 
-  // Initially, the likelihood is 0
+  mlm_peeler*& plr = my_peelers[i].mlm[asc];
 
-  like = 0.0;
+  if(!plr) plr = new mlm_peeler(ps, mc, *my_ped_data.get_raw_data(), md, lelt, asc);
+  else     plr->reset(mc);
 
-  double ant_norm = 0; // due to JA for likelihood rescaling
-  double pos_norm = 0; // due to JA for likelihood rescaling
-  double rescale_like = 0;// see above
+  // Initially, the likelihood is 0
 
-  segreg_calculator::mlm_ant_vec.clear(); // due to JA for likelihod rescaling
-  segreg_calculator::mlm_pos_vec.clear(); // due to JA for likelihood rescaling
+  log_double like(0.0);
+
+  w.ant_vec.clear(); // due to JA for likelihod rescaling
+  w.pos_vec.clear(); // due to JA for likelihood rescaling
 
   // Doesn't matter which individual, so just use the first one
 
@@ -486,35 +511,14 @@ log_double segreg_calculator::calc_connected_MLM
   for(TypeDescription::StateIterator state = lelt.get_type_description().begin();
       state != lelt.get_type_description().end(); ++state)
   {
-    like += calc_subped_given_member_MLM(mpl, indi, *state);
+    like += calc_subped_given_member_MLM(plr, indi, *state, &w);
   }
 
- for (unsigned i = 0; i != segreg_calculator::mlm_ant_vec.size(); i++) { // defining the rescaling constants
-    ant_norm += segreg_calculator::mlm_ant_vec[i];
-     pos_norm += segreg_calculator::mlm_pos_vec[i];
- }
-
- for (unsigned i = 0; i != segreg_calculator::mlm_ant_vec.size(); i++) { // now rescale
-    segreg_calculator::mlm_ant_vec[i] = segreg_calculator::mlm_ant_vec[i]/ant_norm;
-     segreg_calculator::mlm_pos_vec[i] = segreg_calculator::mlm_pos_vec[i]/pos_norm;
- }
-
-for (unsigned i = 0; i != segreg_calculator::mlm_ant_vec.size(); i++) { // the likelihood after rescaling
-    rescale_like += segreg_calculator::mlm_ant_vec[i]*segreg_calculator::mlm_pos_vec[i]; 
- }
-
-
- log_double new_log_like(0.0);
- new_log_like = ant_norm*pos_norm*rescale_like; // due to JA
- 
-  delete mpl;
-
 //  cout << ps->name() << ' ' << like << endl;
 
+  return rescaled_likelihood(w);
 
 //  return like;
- new_log_like = ant_norm*pos_norm*rescale_like; // due to JA
-    return new_log_like;
 }
 
 
@@ -0,0 +1,291 @@
+//============================================================================
+// File:      test_concurrent.cpp
+//
+// History:   10/17/26 - created.
+//
+// Notes:     Runs each SEGREG analysis of the parameter file through an
+//            AnalysisController, one at a time and with one thread each.
+//            Then runs them all again on two threads, each analysis with its
+//            own AnalysisController and output and with two threads of its
+//            own, so that Iterative_Models::compute_models() maximizes the
+//            models of each stage concurrently.  The first two analyses wait
+//            for each other to start, so that two analyses are always
+//            running at once on separate threads.  The output and the
+//            conditioned subsets must be the same as when the analyses are
+//            run one at a time.  Meant to be run under a thread checker as
+//            well as on its own.
+//
+// Copyright (c) 2026 R.C. Elston
+// All Rights Reserved
+//============================================================================
+
+#include <ctime>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include "boost/shared_ptr.hpp"
+#include "LSF/LSFinit.h"
+#include "app/SAGEapp.h"
+#include "util/ThreadPool.h"
+#include "segreg/segreg_input.h"
+#include "segreg/AnalysisController.h"
+
+using namespace std;
+using namespace SAGE;
+using namespace SEGREG;
+
+int failures = 0;
+
+void check(const string& name, bool ok)
+{
+  if( !ok )
+    ++failures;
+
+  cout << (ok ? "ok    " : "FAILED") << "  " << name << endl;
+}
+
+class SEGREGCONCURRENT : public APP::SAGEapp
+{
+public:
+
+  SEGREGCONCURRENT(int argc, char **argv)
+    : APP::SAGEapp(APP::APP_SEGREG, true, argc, argv)
+  {
+    LSFInit();
+  }
+
+  virtual int main();
+};
+
+string file_contents(const string& file_name)
+{
+  ifstream f(file_name.c_str());
+
+  ostringstream s;
+
+  s << f.rdbuf();
+
+  return s.str();
+}
+
+/// An AnalysisController which keeps the names of the conditioned members,
+/// which are lost with the analysis's data set.
+class test_controller : public AnalysisController
+{
+public:
+
+  test_controller(APP::Output_Streams& o) : AnalysisController(o) { }
+
+  /// As do_analysis(), but keeps the conditioned members.
+  void run_analysis(const RPED::MultiPedigree& mp, const model& m)
+  {
+    print_analysis_header(m.get_title());
+
+    PedigreeDataSet ped_data(mp, m, my_out);
+
+    if(ped_data.is_valid())
+      process_analysis(ped_data, m);
+
+    const set<FPED::MemberConstPointer>& members = my_analysis.get_conditioned_members();
+
+    for(set<FPED::MemberConstPointer>::const_iterator i = members.begin(); i != members.end(); ++i)
+      conditioned_members.insert((*i)->pedigree()->name() + ":" + (*i)->name());
+
+    print_analysis_footer();
+  }
+
+  set<string> conditioned_members;
+};
+
+/// A single analysis, with its own controller and output.
+struct analysis_job
+{
+  analysis_job(segreg_data& d, size_t i, size_t thread_count)
+    : data(d), index(i), target_model(d.analyses()[i]), worker(0)
+  {
+    target_model.set_thread_count(thread_count);
+  }
+
+  void run()
+  {
+    string root = target_model.get_file_name_root();
+
+    {
+      APP::Output_Streams output(root, screen);
+
+      test_controller controller(output);
+
+      controller.like_cutoff           = data.like_cutoff;
+      controller.fpmm_and_no_poly_loci = index < data.locus_indic_vec.size() &&
+                                         data.locus_indic_vec[index] == 1;
+
+      controller.run_analysis(data.pedigrees(), target_model);
+
+      conditioned_members = controller.conditioned_members;
+    }
+
+    information = file_contents(root + ".inf");
+    summary     = file_contents(root + ".sum");
+    details     = file_contents(root + ".det");
+  }
+
+  segreg_data&        data;
+  size_t              index;
+  model               target_model;
+  size_t              worker;
+
+  ostringstream       screen;
+  string              information;
+  string              summary;
+  string              details;
+  set<string>         conditioned_members;
+};
+
+typedef boost::shared_ptr<analysis_job> job_ptr;
+
+// Holds the first two analyses until both have started.  If the other
+// never starts (there being only one thread), it gives up after a minute.
+class start_barrier
+{
+public:
+
+  start_barrier() : my_count(0)
+  {
+    pthread_mutex_init(&my_mutex, NULL);
+    pthread_cond_init (&my_started, NULL);
+  }
+
+  ~start_barrier()
+  {
+    pthread_cond_destroy (&my_started);
+    pthread_mutex_destroy(&my_mutex);
+  }
+
+  void arrive()
+  {
+    timespec limit = { time(NULL) + 60, 0 };
+
+    pthread_mutex_lock(&my_mutex);
+
+    ++my_count;
+
+    pthread_cond_broadcast(&my_started);
+
+    while(my_count < 2 && pthread_cond_timedwait(&my_started, &my_mutex, &limit) == 0) { }
+
+    pthread_mutex_unlock(&my_mutex);
+  }
+
+  bool met() const { return my_count >= 2; }
+
+private:
+
+  start_barrier(const start_barrier&);
+  start_barrier& operator=(const start_barrier&);
+
+  size_t          my_count;
+  pthread_mutex_t my_mutex;
+  pthread_cond_t  my_started;
+};
+
+class concurrent_task : public UTIL::ParallelTask
+{
+public:
+
+  explicit concurrent_task(vector<job_ptr>& j) : jobs(j) { }
+
+  virtual void run(size_t item, size_t worker)
+  {
+    jobs[item]->worker = worker;
+
+    if(item < 2)
+      barrier.arrive();
+
+    jobs[item]->run();
+  }
+
+  vector<job_ptr>& jobs;
+  start_barrier    barrier;
+};
+
+int SEGREGCONCURRENT::main()
+{
+  segreg_data data(name, debug());
+
+  data.input(argc, argv);
+
+  size_t analysis_count = data.analyses().size();
+
+  cout << endl << analysis_count << " analyses" << endl << endl;
+
+  if(analysis_count < 2)
+  {
+    check("at least two analyses", false);
+
+    cout << endl << failures << " failures." << endl;
+
+    return 1;
+  }
+
+  vector<job_ptr> serial, concurrent;
+
+  for(size_t i = 0; i < analysis_count; ++i)
+  {
+    serial    .push_back(job_ptr(new analysis_job(data, i, 1)));
+    concurrent.push_back(job_ptr(new analysis_job(data, i, 2)));
+  }
+
+  for(size_t i = 0; i < serial.size(); ++i)
+    serial[i]->run();
+
+  UTIL::ThreadPool pool(2);
+
+  concurrent_task task(concurrent);
+
+  bool completed = pool.run(concurrent.size(), task);
+
+  check("two threads",                           pool.thread_count() == 2);
+  check("every analysis completed",              completed);
+  check("two analyses run at once",              task.barrier.met());
+  check("two analyses run on separate threads",  concurrent[0]->worker != concurrent[1]->worker);
+
+  for(size_t i = 0; i < analysis_count; ++i)
+  {
+    const analysis_job& s = *serial[i];
+    const analysis_job& c = *concurrent[i];
+
+    string name = s.target_model.get_file_name_root() + ": ";
+
+    check(name + "results written",            !s.summary.empty() && !s.details.empty());
+    check(name + "screen output as serial",    c.screen.str()  == s.screen.str());
+    check(name + "information as serial",      c.information   == s.information);
+    check(name + "summary as serial",          c.summary       == s.summary);
+    check(name + "details as serial",          c.details       == s.details);
+
+    if(s.target_model.ascer_sub_model.s_option() != ascertainment_sub_model::none)
+    {
+      ostringstream members;
+
+      members << s.conditioned_members.size() << " conditioned members";
+
+      check(name + members.str(),              !s.conditioned_members.empty());
+    }
+
+    check(name + "conditioned subset as serial",
+          c.conditioned_members == s.conditioned_members);
+  }
+
+  cout << endl << failures << " failures." << endl;
+
+  return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+  free(malloc(1));
+
+  SEGREGCONCURRENT segreg_concurrent(argc, argv);
+
+  return segreg_concurrent.main();
+}
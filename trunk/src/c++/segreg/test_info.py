@@ -189,3 +189,9 @@ class system_tests (sagetest.SAGE_Test) :
     self.file_names  = ["t1.3addmendel.det", "out" ]
     self.execute()
 
+  def test_concurrent(self):
+    'Testing of analyses run concurrently against the same analyses run serially'
+    self.cmd         = 'test_concurrent -p par -d ped >out 2>/dev/null'
+    self.file_names  = ["out"]
+    self.execute()
+
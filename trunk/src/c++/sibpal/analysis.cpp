@@ -1,8 +1,67 @@
+#include "error/bufferederrorstream.h"
+#include "util/ThreadPool.h"
+#include "palbase/replicates.h"
 #include "sibpal/analysis.h"
 
 namespace SAGE   {
 namespace SIBPAL {
 
+// - Models fitted per batch, per thread.  A batch's regressions are kept
+//   until their results are printed, so this bounds the memory used.
+//
+const size_t REGRESSION_BATCH_PER_THREAD = 4;
+
+// - Fits a batch of regression models, one per item.  Each model has its
+//   own TraitRegression and a buffered error stream, so the fits share
+//   nothing but the pairs, which are only read.  When the models are fitted
+//   concurrently, each computes its simulation replicates with one thread.
+//   A model without a seed gets its own, from base_seed and its index.
+//
+class regression_task : public UTIL::ParallelTask
+{
+  public:
+
+    regression_task(relative_pairs&                 pairs,
+                    const vector<regression_model>& models,
+                    size_t first, size_t count, size_t threads,
+                    unsigned long base_seed, cerrorstream& err)
+      : my_errors(count), my_regressions(count), my_done(count, 0)
+    {
+      for( size_t j = 0; j < count; ++j )
+      {
+        my_errors[j].reset(new bufferederrorstream<char>(err));
+        my_regressions[j].reset(new TraitRegression(pairs, *my_errors[j]));
+        my_regressions[j]->set_model(models[first + j]);
+        my_regressions[j]->set_thread_count(threads > 1 ? 1 : 0);
+
+        if( !models[first + j].get_pvalue_options().seed )
+          my_regressions[j]->set_seed(PALBASE::replicate_engine::derive_seed(base_seed, first + j));
+      }
+    }
+
+    virtual void run(size_t item, size_t)
+    {
+      my_regressions[item]->regress();
+
+      my_done[item] = 1;
+    }
+
+    bool done(size_t item) const { return my_done[item]; }
+
+    const TraitRegression& regression(size_t item) const { return *my_regressions[item]; }
+
+    void flush_errors(size_t item) { my_errors[item]->flush_buffer(); }
+
+  private:
+
+    typedef boost::shared_ptr<bufferederrorstream<char> >  error_ptr;
+    typedef boost::shared_ptr<TraitRegression>             regression_ptr;
+
+    vector<error_ptr>       my_errors;
+    vector<regression_ptr>  my_regressions;
+    vector<char>            my_done;
+};
+
 sibpal_analysis::sibpal_analysis(cerrorstream& err)
               : errors(err)
 { }
@@ -166,39 +225,76 @@ sibpal_analysis::run_regression_analysis(relative_pairs&    r_pairs,
 
   // Start regression
   //
-  TraitRegression reg(r_pairs, errors);
+  // The models (one per marker in a genome scan) are independent, so a batch
+  // of them is fitted concurrently, then printed in model order along with
+  // any messages from each fit.
+  //
+  size_t thread_count = std::min(UTIL::ThreadPool::default_thread_count(),
+                                 my_analysis_models.size());
+  size_t batch_size   = thread_count * REGRESSION_BATCH_PER_THREAD;
+
+  UTIL::ThreadPool pool(thread_count);
+
+  // Models without a seed take theirs from one clock seed for the run, so
+  // that each draws its own replicates, as when one generator was carried
+  // from model to model.
+  //
+  unsigned long base_seed = PALBASE::replicate_engine::clock_seed();
+
   string previous_trait = "";
   size_t a_index = 0;
 
-  for( size_t i = 0; i < my_analysis_models.size(); ++i, ++a_index )
+  for( size_t first = 0; first < my_analysis_models.size(); first += batch_size )
   {
-    my_current_model = my_analysis_models[i];
+    size_t count = std::min(batch_size, my_analysis_models.size() - first);
 
-    //my_current_model.dump_model(r_pairs, cout);
-    string current_trait = my_current_model.get_trait().name(r_pairs);
+    regression_task task(r_pairs, my_analysis_models, first, count,
+                         std::min(thread_count, count), base_seed, errors);
 
-    reg.set_model(my_current_model);
+    // If a fit throws, the fits which didn't complete are redone in order,
+    // so that the exception reaches our caller as it would without threads.
 
-    reg.regress();
+    if( !pool.run(count, task) )
+    {
+      for( size_t j = 0; j < count; ++j )
+        if( !task.done(j) )
+          task.run(j, 0);
+    }
 
-    if( current_trait != previous_trait )
+    for( size_t j = 0; j < count; ++j, ++a_index )
     {
-      if( i )
-        reg_output->print_footer();
+      size_t i = first + j;
 
-      reg_output->print_header(reg);
-      a_index = 0;
-    }
+      my_current_model = my_analysis_models[i];
 
-    if( reg.get_svd_return_code() == 2 )
-      reg_output->print_instability_note();
+      //my_current_model.dump_model(r_pairs, cout);
+      string current_trait = my_current_model.get_trait().name(r_pairs);
 
-    reg_output->print_results(a_index+1);
+      const TraitRegression& reg = task.regression(j);
 
-    if( i == my_analysis_models.size()-1 )
-      reg_output->print_footer();
+      task.flush_errors(j);
 
-    previous_trait = current_trait;
+      if( current_trait != previous_trait )
+      {
+        if( i )
+          reg_output->print_footer();
+
+        reg_output->print_header(reg);
+        a_index = 0;
+      }
+
+      reg_output->set_analysis(reg);
+
+      if( reg.get_svd_return_code() == 2 )
+        reg_output->print_instability_note();
+
+      reg_output->print_results(a_index+1);
+
+      if( i == my_analysis_models.size()-1 )
+        reg_output->print_footer();
+
+      previous_trait = current_trait;
+    }
   }
 
   return;
@@ -7,6 +7,7 @@ namespace SIBPAL {
 
 UnivariateGeneralizedLeastSquares3::
 UnivariateGeneralizedLeastSquares3(size_t m)
+  : my_batch(1)   // Fits already run concurrently, one per thread.
 {
   set_inverse_method(SVD);
   set_leverage_adjustment(false);
@@ -201,6 +202,47 @@ UnivariateGeneralizedLeastSquares3::add_block(matrix& y, const matrix& W, const
   return;
 }
 
+// Clusters the batch does not accept (too large, or W near singular) are
+// added by add_block(), so that the SVD decides what to make of them.
+//
+void
+UnivariateGeneralizedLeastSquares3::add_blocks(vector<matrix>& ys, const vector<matrix>& Ws,
+                                               const vector<matrix>& As,
+                                               const vector<weight_status_type>& statuses)
+{
+  if(!AWA || !AWy || !yWy)
+    return;
+
+  assert( Ws.size() == ys.size() && As.size() == ys.size() && statuses.size() == ys.size() );
+
+  my_batch.reset(parameters, variates);
+
+  for( size_t i = 0; i < ys.size(); ++i )
+  {
+    assert( statuses[i] == INVERSEW || statuses[i] == NORMALW );
+
+    my_batch.add(ys[i], Ws[i], As[i], statuses[i] == NORMALW ? PALBASE::gls_batch::COVARIANCE
+                                                             : PALBASE::gls_batch::WEIGHT);
+  }
+
+  my_batch.accumulate(AWA, AWy, yWy);
+
+  for( size_t i = 0; i < ys.size(); ++i )
+  {
+    if( my_batch.accepted(i) )
+    {
+      observation_count += ys[i].rows();
+      cluster_count     += 1;
+    }
+    else
+      add_block(ys[i], Ws[i], As[i], statuses[i]);
+  }
+
+  // Accepted clusters have no singular value of W below 1e-7.
+  if( ys.size() && my_batch.accepted(ys.size() - 1) )
+    svd_return_code = 1;
+}
+
 void 
 UnivariateGeneralizedLeastSquares3::add_block(matrix& y, const matrix& A)
 {
@@ -14,6 +14,9 @@
 //   All Rights Reserved
 //=============================================================================
 
+#include <list>
+#include "error/bufferederrorstream.h"
+#include "palbase/replicates.h"
 #include "sibpal/regress.h"
 
 #undef DEBUG_TRAIT_VECTOR
@@ -49,7 +52,7 @@ RegressionVariant::~RegressionVariant()
 //------------------------------------------------------------
 
 TraitRegression::TraitRegression(relative_pairs& p, cerrorstream& err)
-               : pairs(p), errors(err)
+               : pairs(p), my_thread_count(0), my_seed(0), errors(err)
 {
   invalidate();
   reset();
@@ -2318,9 +2321,12 @@ TraitRegression::regress_markers(GLS3& gls, bool use_empirical_correlations,
   map<const sib_cluster*, matrix> temp_Ws;
   map<const sib_cluster*, matrix> temp_Ys;
 
-  matrix W;                    // weight matrix
-  matrix A;                    // design matrix
-  matrix y;                    // trait vector
+  size_t cluster_count = get_sib_clusters().size();
+
+  vector<matrix>             Wc(cluster_count);        // weight matrices
+  vector<matrix>             Ac(cluster_count);        // design matrices
+  vector<matrix>             yc(cluster_count);        // trait vectors
+  vector<weight_status_type> statuses(cluster_count, BESTW);
 
   const trait_parameter& t = get_model().get_trait();
 
@@ -2328,13 +2334,17 @@ TraitRegression::regress_markers(GLS3& gls, bool use_empirical_correlations,
 
   gls.reset();
 
-  for( size_t c = 0; c < get_sib_clusters().size(); ++c )
+  for( size_t c = 0; c < cluster_count; ++c )
   {
     const sib_cluster& sc = get_sib_clusters()[c];
 
-    // Compute basis matrices
+    matrix& W = Wc[c];
+    matrix& A = Ac[c];
+    matrix& y = yc[c];
 
-    weight_status_type status = BESTW;
+    weight_status_type& status = statuses[c];
+
+    // Compute basis matrices
 
     weight_matrix(sc, W, t, use_empirical_correlations, status, fv, hv);
 
@@ -2353,12 +2363,17 @@ TraitRegression::regress_markers(GLS3& gls, bool use_empirical_correlations,
   cout << "W =" << endl;
   print_matrix(W, cout);
 #endif
+  }
 
-    gls.add_block(y, W, A, status);
+  gls.add_blocks(yc, Wc, Ac, statuses);
 
-    temp_As[&sc] = A;
-    temp_Ws[&sc] = W;
-    temp_Ys[&sc] = y;
+  for( size_t c = 0; c < cluster_count; ++c )
+  {
+    const sib_cluster& sc = get_sib_clusters()[c];
+
+    temp_As[&sc] = Ac[c];
+    temp_Ws[&sc] = Wc[c];
+    temp_Ys[&sc] = yc[c];
   }
 
   As = temp_As;
@@ -3314,15 +3329,16 @@ TraitRegression::do_simulation_univariate()
   for( size_t i = 0; i < observed_results.size(); ++i )
     observed_results[i].estimate.clear_simulation();
 
-  TraitRegression simulation(pairs, errors);
+  // The simulation is the replicates' first worker, so its messages are
+  // kept, as are the other workers', and written in replicate order.
 
-  simulation.invalidate();
-  simulation.set_model(get_model());
-  simulation.get_model().invalidate();
-  simulation.copy_build(this);
-  simulation.build_simulation();
-  simulation.set_reg_results(get_reg_results());
-  simulation.validate();
+  bufferederrorstream<char> simulation_errors(errors);
+
+  TraitRegression simulation(pairs, simulation_errors);
+
+  prepare_simulation(simulation);
+
+  simulation_errors.flush_buffer();
 
   if( !simulation.valid() )
     return;
@@ -3424,7 +3440,7 @@ TraitRegression::do_simulation_univariate()
   cout << "precision        = " << precision        << endl; 
 #endif
 
-  do_simulation_univariate_replicates(simulation, precision,
+  do_simulation_univariate_replicates(simulation, simulation_errors, precision,
                                       (size_t)min_replicates, (size_t)max_replicates);
 
   return;
@@ -3442,9 +3458,6 @@ TraitRegression::build_simulation()
   if( !get_model().valid() || !built() )
     return;
 
-  if( get_model().get_pvalue_options().seed )
-    randomizer.mt.reseed(get_model().get_pvalue_options().seed);
-
   // Clear the simulation vectors
   my_simulation_map.resize(0);
   my_group_permutation_vector.resize(0);
@@ -3526,113 +3539,271 @@ TraitRegression::build_simulation()
 }
 
 void
-TraitRegression::do_simulation_univariate_replicates(TraitRegression& simulation,
-                                                     double precision,
-                                                     size_t min_replicates,
-                                                     size_t max_replicates)
+TraitRegression::prepare_simulation(TraitRegression& simulation)
 {
-#if DEBUG_SIMULATION
-  cout << endl
-       << "*** vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv ***"
-       << endl;
-#endif
+  simulation.invalidate();
+  simulation.set_model(get_model());
+  simulation.get_model().invalidate();
+  simulation.copy_build(this);
+  simulation.build_simulation();
+  simulation.set_reg_results(get_reg_results());
+  simulation.validate();
+}
 
-  result_vector& observed_results  = my_reg_results.get_results();
-  F_result_type& observed_F_result = my_reg_results.get_F_result();
+//
+//------------------------------------------------------------------------
+//
+
+// - The replicates of an empirical p-value simulation.  Each worker fits
+//   its own copy of the simulation regression.  A replicate permutes the
+//   original simulation vectors with the generator it is given, so it
+//   doesn't depend on the replicates before it.  Every worker's copy writes
+//   to a buffered error stream.  A replicate's messages are kept with its
+//   result and written when it is accumulated, so they come in replicate
+//   order, and only for the replicates a serial run would compute.
+//
+class SimulationReplicates : public PALBASE::replicate_task
+{
+  public:
+
+    SimulationReplicates(TraitRegression&                  reg,
+                         TraitRegression&                  simulation,
+                         bufferederrorstream<char>&        simulation_errors,
+                         const PALBASE::replicate_engine&  engine,
+                         double precision, size_t min_replicates);
+
+    virtual void compute(size_t replicate, size_t slot, size_t worker,
+                         MersenneTwister& rng);
+
+    virtual bool accumulate(size_t replicate, size_t slot);
+
+  private:
+
+    typedef bufferederrorstream<char>::error_type  error_type;
 
-  for( size_t i = 0; i < max_replicates; ++i )
+    void compute_replicate(size_t slot, size_t worker, MersenneTwister& rng);
+
+    struct replicate_result
+    {
+      list<error_type> messages;
+
+      bool            valid;
+
+      vector<size_t>  index;
+      vector<double>  beta;
+      vector<double>  ss;
+
+      bool            F_valid;
+      double          F_pvalue;
+    };
+
+    typedef boost::shared_ptr<bufferederrorstream<char> >  error_ptr;
+    typedef boost::shared_ptr<TraitRegression>             regression_ptr;
+
+    TraitRegression&                my_regression;
+
+    vector<error_ptr>               my_errors;
+    vector<regression_ptr>          my_copies;
+    vector<TraitRegression*>        my_simulations;
+    vector<bufferederrorstream<char>*> my_simulation_errors;
+
+    group_permutation_vector_type   my_permutation_vector;
+
+    bool                            my_F_test;
+    double                          my_precision;
+    size_t                          my_min_replicates;
+
+    vector<replicate_result>        my_results;
+};
+
+SimulationReplicates::SimulationReplicates(TraitRegression&                  reg,
+                                           TraitRegression&                  simulation,
+                                           bufferederrorstream<char>&        simulation_errors,
+                                           const PALBASE::replicate_engine&  engine,
+                                           double precision, size_t min_replicates)
+                    : my_regression(reg),
+                      my_simulations(1, &simulation),
+                      my_simulation_errors(1, &simulation_errors),
+                      my_permutation_vector(simulation.my_group_permutation_vector),
+                      my_precision(precision),
+                      my_min_replicates(min_replicates),
+                      my_results(engine.batch_size())
+{
+  my_F_test =    simulation.get_model().is_x_linked()
+              && reg.get_reg_results().get_F_result().is_valid();
+
+  for( size_t w = 1; w < engine.thread_count(); ++w )
   {
-    if( simulation.get_model().is_x_linked() )
-      simulation.randomize_marker_data_x();
-    else
-      simulation.randomize_marker_data();
+    my_errors.push_back( error_ptr(new bufferederrorstream<char>(reg.errors)) );
+    my_copies.push_back( regression_ptr(new TraitRegression(reg.pairs, *my_errors.back())) );
 
-    simulation.simulating_build();
+    reg.prepare_simulation(*my_copies.back());
 
-    if( !simulation.valid() )
-      continue;
+    my_simulations.push_back(my_copies.back().get());
+    my_simulation_errors.push_back(my_errors.back().get());
+  }
+}
 
-    assert( simulation.my_group_permutation_vector.size() );
+void
+SimulationReplicates::compute(size_t replicate, size_t slot, size_t worker,
+                              MersenneTwister& rng)
+{
+  compute_replicate(slot, worker, rng);
+
+  // Move the replicate's messages from the worker's stream to its result.
+
+  bufferederrorstream<char>& errors   = *my_simulation_errors[worker];
+  list<error_type>&          messages = my_results[slot].messages;
+
+  messages.assign(errors.begin(), errors.end());
+
+  errors.clear();
+}
+
+void
+SimulationReplicates::compute_replicate(size_t slot, size_t worker, MersenneTwister& rng)
+{
+  TraitRegression&  simulation = *my_simulations[worker];
+  replicate_result& r          = my_results[slot];
+
+  r.valid = r.F_valid = false;
+
+  r.index.resize(0);
+  r.beta.resize(0);
+  r.ss.resize(0);
+
+  simulation.my_group_permutation_vector = my_permutation_vector;
+  simulation.randomizer.mt               = rng;
+
+  if( simulation.get_model().is_x_linked() )
+    simulation.randomize_marker_data_x();
+  else
+    simulation.randomize_marker_data();
+
+  simulation.simulating_build();
+
+  if( !simulation.valid() )
+    return;
+
+  assert( simulation.my_group_permutation_vector.size() );
+
+  simulation.get_reg_results().clear();
+  simulation.do_regress_univariate();
 
-    simulation.get_reg_results().clear();
-    simulation.do_regress_univariate();
+  if( !simulation.valid() )
+    return;
 
-    if( !simulation.valid() )
+  if( my_F_test )
+    simulation.do_regress_F_test();
+
+  const result_vector& empirical_results  = simulation.get_reg_results().get_results();
+  const F_result_type& empirical_F_result = simulation.get_reg_results().get_F_result();
+
+  for( size_t j = 0; j < empirical_results.size(); ++j )
+  {
+    if(    empirical_results[j].type() != reg_result::param
+       || !empirical_results[j].reg_param().markers.size() )
       continue;
 
-    if( simulation.get_model().is_x_linked() && observed_F_result.is_valid() )
-      simulation.do_regress_F_test();
+    r.index.push_back(j);
+    r.beta.push_back(empirical_results[j].estimate.value());
+    r.ss.push_back(empirical_results[j].estimate.variance());
+  }
 
-    const result_vector& empirical_results = simulation.get_reg_results().get_results();
-    const F_result_type& empirical_F_result = simulation.get_reg_results().get_F_result();
+  r.F_valid  = empirical_F_result.is_valid();
+  r.F_pvalue = r.F_valid ? empirical_F_result.get_F_pvalue() : QNAN;
 
-    double min_p = 1.0;
-    for( size_t j = 0; j < empirical_results.size(); ++j )
-    {
-      if(    empirical_results[j].type() != reg_result::param
-         || !empirical_results[j].reg_param().markers.size() )
-        continue;
+  r.valid = true;
+}
 
-      double beta = empirical_results[j].estimate.value();
-      double ss   = empirical_results[j].estimate.variance();
+bool
+SimulationReplicates::accumulate(size_t replicate, size_t slot)
+{
+  replicate_result& r = my_results[slot];
 
-      observed_results[j].estimate.add_simulation_result(beta, ss);
+  // Write the replicate's messages, as bufferederrorstream::flush_buffer()
+  // does.
 
-      //if(    observed_results[j].type() != reg_result::param
-      //   || !observed_results[j].reg_param().markers.size() )
-      //  continue;
+  cerrorstream::sb_type_ptr out = my_regression.errors.rdbuf();
 
-      const double p = observed_results[j].estimate.empirical_pvalue();
+  for( ; !r.messages.empty(); r.messages.pop_front() )
+  {
+    const error_type& e = r.messages.front();
 
-      if( finite(p) )
-        min_p = min(p, min_p);
+    out->priority(e.priority);
+    out->filename(e.filename);
+    out->linenumber(e.linenumber);
+    out->str(e.str);
 
-#if DEBUG_SIMULATION
-      //cout << empirical_results[j].estimate.pvalue() << endl;
-      cout << "  REP " << i << " : "
-           <<   "o.t = " << doub2str( observed_results[j].estimate.tvalue(), 7,4)
-           << ", o.p = " << doub2str( observed_results[j].estimate.pvalue(), 7,4)
-           << ", s.t = " << doub2str(empirical_results[j].estimate.tvalue(), 7,4)
-           << ", s.p = " << doub2str(empirical_results[j].estimate.pvalue(), 7,4)
-           << ", e.p = " << doub2str( observed_results[j].estimate.empirical_pvalue(), 7,4)
-           << ", e.s = " << observed_results[j].estimate.significant_replicates()
-           << ", e.e = " << observed_results[j].estimate.same_replicates()
-           << ", e.n = " << observed_results[j].estimate.total_replicates()
-           << endl;
-#endif
-    }
+    out->pubsync();
+  }
 
-    if( observed_F_result.is_valid() && empirical_F_result.is_valid() )
-    {
-      observed_F_result.add_simulation_result(empirical_F_result.get_F_pvalue());
+  if( !r.valid )
+    return false;
+
+  result_vector& observed_results  = my_regression.get_reg_results().get_results();
+  F_result_type& observed_F_result = my_regression.get_reg_results().get_F_result();
+
+  double min_p = 1.0;
+
+  for( size_t k = 0; k < r.index.size(); ++k )
+  {
+    size_t j = r.index[k];
+
+    observed_results[j].estimate.add_simulation_result(r.beta[k], r.ss[k]);
 
-      const double p = observed_F_result.get_F_empirical_pvalue();
+    const double p = observed_results[j].estimate.empirical_pvalue();
 
-      if( finite(p) )
-        min_p = min(p, min_p);
+    if( finite(p) )
+      min_p = min(p, min_p);
+  }
+
+  if( observed_F_result.is_valid() && r.F_valid )
+  {
+    observed_F_result.add_simulation_result(r.F_pvalue);
+
+    const double p = observed_F_result.get_F_empirical_pvalue();
+
+    if( finite(p) )
+      min_p = min(p, min_p);
+  }
+
+  double m = replicate*min_p/(1-min_p);
 
 #if DEBUG_SIMULATION
-      cout << "  F :"
-           << "  o.p = " << doub2str( observed_F_result.get_F_pvalue(), 7,4)
-           << ", s.p = " << doub2str(empirical_F_result.get_F_pvalue(), 7,4)
-           << ", e.p = " << doub2str( observed_F_result.get_F_empirical_pvalue(), 7,4)
-           << ", e.s = " << observed_F_result.get_significant_replicates()
-           << ", e.s = " << observed_F_result.get_same_replicates()
-           << ", e.n = " << observed_F_result.get_total_replicates()
-           << endl;
+  cout << "n=" << replicate+1 << ", p=" << min_p << ", m=" << m << ", prec=" << my_precision << endl;
 #endif
-    }
 
-    double m = i*min_p/(1-min_p);
+  // Stop if our results are precise enough
+  return replicate > my_min_replicates && finite(m) && m > my_precision;
+}
+
+//
+//------------------------------------------------------------------------
+//
 
+void
+TraitRegression::do_simulation_univariate_replicates(TraitRegression& simulation,
+                                                     bufferederrorstream<char>& simulation_errors,
+                                                     double precision,
+                                                     size_t min_replicates,
+                                                     size_t max_replicates)
+{
 #if DEBUG_SIMULATION
-    cout << "n=" << i+1 << ", p=" << min_p << ", m=" << m << ", prec=" << precision << endl;
+  cout << endl
+       << "*** vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv ***"
+       << endl;
 #endif
 
-    // Break if our results are precise enough
-    if( i>min_replicates && finite(m) && m > precision )
-      break; 
-  }
+  unsigned long seed = my_seed ? my_seed
+                               : (unsigned long) get_model().get_pvalue_options().seed;
+
+  PALBASE::replicate_engine engine(seed, my_thread_count);
+
+  SimulationReplicates replicates(*this, simulation, simulation_errors, engine,
+                                  precision, min_replicates);
+
+  engine.run(replicates, max_replicates);
 
 #if DEBUG_SIMULATION
   cout << "*** ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ ***"
@@ -0,0 +1,105 @@
+//============================================================================
+//  File:       BinaryImage.cpp
+//
+//  Purpose:    Implementation of the binary image reader and writer, and of
+//              the content hash.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//============================================================================
+
+#include <cstdio>
+#include <cstring>
+#include "util/BinaryImage.h"
+
+namespace SAGE {
+namespace UTIL {
+
+//============================================================================
+// BinaryImageWriter
+//============================================================================
+
+void BinaryImageWriter::align(size_t n)
+{
+  if(n > 1 && my_image.size() % n)
+    my_image.append(n - my_image.size() % n, '\0');
+}
+
+//============================================================================
+// BinaryImageReader
+//============================================================================
+
+bool BinaryImageReader::get_bytes(void* p, size_t n)
+{
+  const char* src = skip(n);
+
+  if(!src)
+    return false;
+
+  std::memcpy(p, src, n);
+
+  return true;
+}
+
+void BinaryImageReader::get_string(std::string& s)
+{
+  uint64_t    n   = get_uint64();
+  const char* src = skip(n);
+
+  if(src)
+    s.assign(src, n);
+  else
+    s.clear();
+}
+
+void BinaryImageReader::align(size_t n)
+{
+  if(n > 1 && position() % n)
+    skip(n - position() % n);
+}
+
+//============================================================================
+// ContentHash
+//============================================================================
+
+void ContentHash::add(const void* p, size_t n)
+{
+  const unsigned char* c = static_cast<const unsigned char*>(p);
+
+  for(size_t i = 0; i < n; ++i)
+  {
+    my_value ^= c[i];
+    my_value *= 1099511628211ULL;
+  }
+}
+
+bool ContentHash::add_file(const std::string& filename)
+{
+  add_string(filename);
+
+  FILE* f = std::fopen(filename.c_str(), "rb");
+
+  if(!f)
+    return false;
+
+  char buffer[65536];
+
+  uint64_t total = 0;
+
+  for(size_t n; (n = std::fread(buffer, 1, sizeof(buffer), f)) != 0; total += n)
+    add(buffer, n);
+
+  bool ok = !std::ferror(f);
+
+  std::fclose(f);
+
+  // The length, so that a file and its name are not confused with another
+  // split differently.
+
+  add_uint64(total);
+
+  return ok;
+}
+
+} // End namespace UTIL
+} // End namespace SAGE
@@ -0,0 +1,233 @@
+//============================================================================
+//  File:       ThreadPool.cpp
+//
+//  Purpose:    Implementation of the persistent worker thread pool.
+//
+//  Copyright (c) 2026 R.C. Elston
+//  All Rights Reserved
+//============================================================================
+
+#include "util/ThreadPool.h"
+
+#if defined(WIN32)
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace SAGE {
+namespace UTIL {
+
+size_t ThreadPool::our_default_thread_count = 1;
+
+//============================================================================
+// Program-wide default
+//============================================================================
+
+size_t ThreadPool::default_thread_count()
+{
+  return our_default_thread_count;
+}
+
+void ThreadPool::set_default_thread_count(size_t n)
+{
+  our_default_thread_count = n ? n : hardware_thread_count();
+}
+
+size_t ThreadPool::hardware_thread_count()
+{
+#if defined(WIN32)
+  SYSTEM_INFO info;
+
+  GetSystemInfo(&info);
+
+  return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return n > 0 ? (size_t) n : 1;
+#else
+  return 1;
+#endif
+}
+
+//============================================================================
+// Construction / destruction
+//============================================================================
+
+ThreadPool::ThreadPool(size_t thread_count)
+  : my_task         (NULL),
+    my_item_count   (0),
+    my_next_item    (0),
+    my_busy_workers (0),
+    my_generation   (0),
+    my_shutdown     (false),
+    my_failed       (false)
+{
+  if(!thread_count)
+    thread_count = default_thread_count();
+
+  pthread_mutex_init(&my_mutex,          NULL);
+  pthread_cond_init (&my_work_available, NULL);
+  pthread_cond_init (&my_work_complete,  NULL);
+
+  // Worker 0 is the thread calling run(), so we only create the others.
+  // The info vector is sized up front so the pointers handed to the
+  // threads remain valid.
+
+  my_worker_info.resize(thread_count);
+
+  for(size_t i = 1; i < thread_count; ++i)
+  {
+    my_worker_info[i].pool  = this;
+    my_worker_info[i].index = i;
+
+    pthread_t t;
+
+    if(pthread_create(&t, NULL, &ThreadPool::thread_main, &my_worker_info[i]))
+      break;
+
+    my_threads.push_back(t);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  pthread_mutex_lock(&my_mutex);
+
+  my_shutdown = true;
+
+  pthread_cond_broadcast(&my_work_available);
+  pthread_mutex_unlock(&my_mutex);
+
+  for(size_t i = 0; i < my_threads.size(); ++i)
+    pthread_join(my_threads[i], NULL);
+
+  pthread_cond_destroy (&my_work_complete);
+  pthread_cond_destroy (&my_work_available);
+  pthread_mutex_destroy(&my_mutex);
+}
+
+size_t ThreadPool::thread_count() const
+{
+  return my_threads.size() + 1;
+}
+
+//============================================================================
+// Running tasks
+//============================================================================
+
+bool ThreadPool::run(size_t item_count, ParallelTask& task)
+{
+  // With no worker threads (or nothing worth sharing), just do the work.
+
+  if(my_threads.empty() || item_count < 2)
+  {
+    bool ok = true;
+
+    for(size_t i = 0; i < item_count; ++i)
+    {
+      try               { task.run(i, 0); }
+      catch(...)        { ok = false;     }
+    }
+
+    return ok;
+  }
+
+  pthread_mutex_lock(&my_mutex);
+
+  my_task         = &task;
+  my_item_count   = item_count;
+  my_next_item    = 0;
+  my_busy_workers = my_threads.size();
+  my_failed       = false;
+
+  ++my_generation;
+
+  pthread_cond_broadcast(&my_work_available);
+  pthread_mutex_unlock(&my_mutex);
+
+  process_items(0);
+
+  pthread_mutex_lock(&my_mutex);
+
+  while(my_busy_workers)
+    pthread_cond_wait(&my_work_complete, &my_mutex);
+
+  my_task = NULL;
+
+  bool ok = !my_failed;
+
+  pthread_mutex_unlock(&my_mutex);
+
+  return ok;
+}
+
+void* ThreadPool::thread_main(void* info)
+{
+  worker_info* w = static_cast<worker_info*>(info);
+
+  w->pool->worker_loop(w->index);
+
+  return NULL;
+}
+
+void ThreadPool::worker_loop(size_t worker)
+{
+  size_t seen_generation = 0;
+
+  pthread_mutex_lock(&my_mutex);
+
+  for( ; ; )
+  {
+    while(!my_shutdown && my_generation == seen_generation)
+      pthread_cond_wait(&my_work_available, &my_mutex);
+
+    if(my_shutdown) break;
+
+    seen_generation = my_generation;
+
+    pthread_mutex_unlock(&my_mutex);
+
+    process_items(worker);
+
+    pthread_mutex_lock(&my_mutex);
+
+    if(--my_busy_workers == 0)
+      pthread_cond_signal(&my_work_complete);
+  }
+
+  pthread_mutex_unlock(&my_mutex);
+}
+
+void ThreadPool::process_items(size_t worker)
+{
+  for( ; ; )
+  {
+    pthread_mutex_lock(&my_mutex);
+
+    bool          done = my_next_item >= my_item_count;
+    size_t        item = my_next_item++;
+    ParallelTask* task = my_task;
+
+    pthread_mutex_unlock(&my_mutex);
+
+    if(done) return;
+
+    try
+    {
+      task->run(item, worker);
+    }
+    catch(...)
+    {
+      pthread_mutex_lock(&my_mutex);
+
+      my_failed = true;
+
+      pthread_mutex_unlock(&my_mutex);
+    }
+  }
+}
+
+} // End namespace UTIL
+} // End namespace SAGE
@@ -11,3 +11,10 @@ class util_test (sagetest.SAGE_Test) :
     self.file_names =  ['out']
     self.execute()
 
+
+  def test_threadpool(self):
+    'Thread pool tests'
+    self.common_path="tests"
+    self.cmd = 'test_threadpool 2>&1 >out'
+    self.file_names =  ['out']
+    self.execute()
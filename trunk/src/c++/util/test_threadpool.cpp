@@ -0,0 +1,88 @@
+#include "util/ThreadPool.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using namespace SAGE::UTIL;
+
+// Each item computes a partial sum into its own slot, and counts how often it
+// was run.  The slots are combined in item order afterwards.
+class SumTask : public ParallelTask
+{
+  public:
+
+    SumTask(size_t n, size_t workers)
+      : results(n, 0.0), runs(n, 0), bad_worker(false), my_workers(workers) { }
+
+    virtual void run(size_t item, size_t worker)
+    {
+      double s = 0.0;
+
+      for(size_t i = 0; i < 1000; ++i)
+        s += std::sqrt((double) (item * 1000 + i));
+
+      results[item] = s;
+
+      ++runs[item];
+
+      if(worker >= my_workers) bad_worker = true;
+    }
+
+    std::vector<double> results;
+    std::vector<int>    runs;
+    bool                bad_worker;
+
+  private:
+
+    size_t my_workers;
+};
+
+int main()
+{
+  const size_t items = 500;
+
+  double serial_total = 0.0;
+
+  size_t thread_counts[] = { 1, 2, 4, 7 };
+
+  for(size_t t = 0; t < 4; ++t)
+  {
+    ThreadPool pool(thread_counts[t]);
+
+    // Run the pool several times to make sure it can be reused.
+
+    for(size_t rep = 0; rep < 3; ++rep)
+    {
+      SumTask task(items, pool.thread_count());
+
+      bool ok = pool.run(items, task);
+
+      double total = 0.0;
+      bool   once  = true;
+
+      for(size_t i = 0; i < items; ++i)
+      {
+        total += task.results[i];
+        once   = once && task.runs[i] == 1;
+      }
+
+      if(t == 0 && rep == 0) serial_total = total;
+
+      if(rep == 0)
+        std::cout << "Threads: "          << pool.thread_count()
+                  << "  completed: "      << ok
+                  << "  each item once: " << once
+                  << "  workers in range: " << !task.bad_worker
+                  << "  same as serial: " << (total == serial_total)
+                  << std::endl;
+    }
+  }
+
+  ThreadPool::set_default_thread_count(3);
+
+  ThreadPool def;
+
+  std::cout << "Default pool threads: " << def.thread_count() << std::endl;
+
+  return 0;
+}